@@ -1019,13 +1019,13 @@ namespace DuiLib {
 		}
 	}
 
-	void CActiveXUI::SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue)
+	void CActiveXUI::SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue)
 	{
-		if( _tcscmp(pstrName, _T("clsid")) == 0 ) CreateControl(pstrValue);
-		else if( _tcscmp(pstrName, _T("modulename")) == 0 ) SetModuleName(pstrValue);
-		else if( _tcscmp(pstrName, _T("delaycreate")) == 0 ) SetDelayCreate(_tcscmp(pstrValue, _T("true")) == 0);
-		//else if( _tcscmp(pstrName, _T("mfc")) == 0 ) SetMFC(_tcscmp(pstrValue, _T("true")) == 0);
-		else CControlUI::SetAttribute(pstrName, pstrValue);
+		if( nAttr == DUIATTR_CLSID ) CreateControl(pstrValue);
+		else if( nAttr == DUIATTR_MODULENAME ) SetModuleName(pstrValue);
+		else if( nAttr == DUIATTR_DELAYCREATE ) SetDelayCreate(_tcscmp(pstrValue, _T("true")) == 0);
+		//else if( nAttr == DUIATTR_MFC ) SetMFC(_tcscmp(pstrValue, _T("true")) == 0);
+		else CControlUI::SetAttributeById(nAttr, pstrName, pstrValue);
 	}
 
 	LRESULT CActiveXUI::MessageHandler(UINT uMsg, WPARAM wParam, LPARAM lParam, bool& bHandled)
@@ -57,7 +57,7 @@ namespace DuiLib {
 		void Move(SIZE szOffset, bool bNeedInvalidate = true);
 		void DoPaint(HDC hDC, const RECT& rcPaint);
 
-		void SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue);
+		void SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue);
 
 		LRESULT MessageHandler(UINT uMsg, WPARAM wParam, LPARAM lParam, bool& bHandled);
 
@@ -306,54 +306,54 @@ namespace DuiLib
 		return m_sBindTabLayoutName;
 	}
 
-	void CButtonUI::SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue)
-	{
-		if( _tcsicmp(pstrName, _T("normalimage")) == 0 ) SetNormalImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("hotimage")) == 0 ) SetHotImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("pushedimage")) == 0 ) SetPushedImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("focusedimage")) == 0 ) SetFocusedImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("disabledimage")) == 0 ) SetDisabledImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("hotforeimage")) == 0 ) SetHotForeImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("stateimage")) == 0 ) SetStateImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("statecount")) == 0 ) SetStateCount(_ttoi(pstrValue));
-		else if( _tcsicmp(pstrName, _T("bindtabindex")) == 0 ) BindTabIndex(_ttoi(pstrValue));
-		else if( _tcsicmp(pstrName, _T("bindtablayoutname")) == 0 ) BindTabLayoutName(pstrValue);
-		else if( _tcsicmp(pstrName, _T("hotbkcolor")) == 0 )
+	void CButtonUI::SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue)
+	{
+		if( nAttr == DUIATTR_NORMALIMAGE ) SetNormalImage(pstrValue);
+		else if( nAttr == DUIATTR_HOTIMAGE ) SetHotImage(pstrValue);
+		else if( nAttr == DUIATTR_PUSHEDIMAGE ) SetPushedImage(pstrValue);
+		else if( nAttr == DUIATTR_FOCUSEDIMAGE ) SetFocusedImage(pstrValue);
+		else if( nAttr == DUIATTR_DISABLEDIMAGE ) SetDisabledImage(pstrValue);
+		else if( nAttr == DUIATTR_HOTFOREIMAGE ) SetHotForeImage(pstrValue);
+		else if( nAttr == DUIATTR_STATEIMAGE ) SetStateImage(pstrValue);
+		else if( nAttr == DUIATTR_STATECOUNT ) SetStateCount(_ttoi(pstrValue));
+		else if( nAttr == DUIATTR_BINDTABINDEX ) BindTabIndex(_ttoi(pstrValue));
+		else if( nAttr == DUIATTR_BINDTABLAYOUTNAME ) BindTabLayoutName(pstrValue);
+		else if( nAttr == DUIATTR_HOTBKCOLOR )
 		{
 			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
 			LPTSTR pstr = NULL;
 			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
 			SetHotBkColor(clrColor);
 		}
-		else if( _tcsicmp(pstrName, _T("pushedbkcolor")) == 0 )
+		else if( nAttr == DUIATTR_PUSHEDBKCOLOR )
 		{
 			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
 			LPTSTR pstr = NULL;
 			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
 			SetPushedBkColor(clrColor);
 		}
-		else if( _tcsicmp(pstrName, _T("hottextcolor")) == 0 )
+		else if( nAttr == DUIATTR_HOTTEXTCOLOR )
 		{
 			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
 			LPTSTR pstr = NULL;
 			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
 			SetHotTextColor(clrColor);
 		}
-		else if( _tcsicmp(pstrName, _T("pushedtextcolor")) == 0 )
+		else if( nAttr == DUIATTR_PUSHEDTEXTCOLOR )
 		{
 			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
 			LPTSTR pstr = NULL;
 			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
 			SetPushedTextColor(clrColor);
 		}
-		else if( _tcsicmp(pstrName, _T("focusedtextcolor")) == 0 )
+		else if( nAttr == DUIATTR_FOCUSEDTEXTCOLOR )
 		{
 			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
 			LPTSTR pstr = NULL;
 			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
 			SetFocusedTextColor(clrColor);
 		}
-		else CLabelUI::SetAttribute(pstrName, pstrValue);
+		else CLabelUI::SetAttributeById(nAttr, pstrName, pstrValue);
 	}
 
 	void CButtonUI::PaintText(HDC hDC)
@@ -54,7 +54,7 @@ namespace DuiLib
 		DWORD GetPushedTextColor() const;
 		void SetFocusedTextColor(DWORD dwColor);
 		DWORD GetFocusedTextColor() const;
-		void SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue);
+		void SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue);
 
 		void PaintText(HDC hDC);
 
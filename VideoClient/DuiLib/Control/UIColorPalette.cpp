@@ -202,12 +202,12 @@ namespace DuiLib {
 		return m_strThumbImage.GetData();
 	}
 
-	void CColorPaletteUI::SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue)
+	void CColorPaletteUI::SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue)
 	{
-		if (_tcscmp(pstrName, _T("palletheight")) == 0) SetPalletHeight(_ttoi(pstrValue));
-		else if (_tcscmp(pstrName, _T("barheight")) == 0) SetBarHeight(_ttoi(pstrValue));
-		else if (_tcscmp(pstrName, _T("thumbimage")) == 0) SetThumbImage(pstrValue);
-		else CControlUI::SetAttribute(pstrName, pstrValue);
+		if (nAttr == DUIATTR_PALLETHEIGHT) SetPalletHeight(_ttoi(pstrValue));
+		else if (nAttr == DUIATTR_BARHEIGHT) SetBarHeight(_ttoi(pstrValue));
+		else if (nAttr == DUIATTR_THUMBIMAGE) SetThumbImage(pstrValue);
+		else CControlUI::SetAttributeById(nAttr, pstrName, pstrValue);
 	}
 
 	void CColorPaletteUI::DoInit()
@@ -18,7 +18,7 @@ namespace DuiLib {
 
 		virtual LPCTSTR GetClass() const;
 		virtual LPVOID GetInterface(LPCTSTR pstrName);
-		virtual void SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue);
+		virtual void SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue);
 
 		///ȡ Palletɫ棩ĸ߶
 		void SetPalletHeight(int nHeight);
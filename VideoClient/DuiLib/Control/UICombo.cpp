@@ -960,9 +960,9 @@ namespace DuiLib {
 	{
 		CControlUI::Move(szOffset, bNeedInvalidate);
 	}
-	void CComboUI::SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue)
+	void CComboUI::SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue)
 	{
-		if( _tcsicmp(pstrName, _T("align")) == 0 ) {
+		if( nAttr == DUIATTR_ALIGN ) {
 			if( _tcsstr(pstrValue, _T("left")) != NULL ) {
 				m_uTextStyle &= ~(DT_CENTER | DT_RIGHT | DT_SINGLELINE);
 				m_uTextStyle |= DT_LEFT;
@@ -976,7 +976,7 @@ namespace DuiLib {
 				m_uTextStyle |= DT_RIGHT;
 			}
 		}
-		else if( _tcsicmp(pstrName, _T("valign")) == 0 ) {
+		else if( nAttr == DUIATTR_VALIGN ) {
 			if( _tcsstr(pstrValue, _T("top")) != NULL ) {
 				m_uTextStyle &= ~(DT_BOTTOM | DT_VCENTER);
 				m_uTextStyle |= (DT_TOP | DT_SINGLELINE);
@@ -990,11 +990,11 @@ namespace DuiLib {
 				m_uTextStyle |= (DT_BOTTOM | DT_SINGLELINE);
 			}
 		}
-		else if( _tcsicmp(pstrName, _T("endellipsis")) == 0 ) {
+		else if( nAttr == DUIATTR_ENDELLIPSIS ) {
 			if( _tcsicmp(pstrValue, _T("true")) == 0 ) m_uTextStyle |= DT_END_ELLIPSIS;
 			else m_uTextStyle &= ~DT_END_ELLIPSIS;
 		}   
-		else if( _tcsicmp(pstrName, _T("wordbreak")) == 0 ) {
+		else if( nAttr == DUIATTR_WORDBREAK ) {
 			if( _tcsicmp(pstrValue, _T("true")) == 0 ) {
 				m_uTextStyle &= ~DT_SINGLELINE;
 				m_uTextStyle |= DT_WORDBREAK | DT_EDITCONTROL;
@@ -1004,20 +1004,20 @@ namespace DuiLib {
 				m_uTextStyle |= DT_SINGLELINE;
 			}
 		}    
-		else if( _tcsicmp(pstrName, _T("font")) == 0 ) SetFont(_ttoi(pstrValue));
-		else if( _tcsicmp(pstrName, _T("textcolor")) == 0 ) {
+		else if( nAttr == DUIATTR_FONT ) SetFont(_ttoi(pstrValue));
+		else if( nAttr == DUIATTR_TEXTCOLOR ) {
 			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
 			LPTSTR pstr = NULL;
 			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
 			SetTextColor(clrColor);
 		}
-		else if( _tcsicmp(pstrName, _T("disabledtextcolor")) == 0 ) {
+		else if( nAttr == DUIATTR_DISABLEDTEXTCOLOR ) {
 			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
 			LPTSTR pstr = NULL;
 			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
 			SetDisabledTextColor(clrColor);
 		}
-		else if( _tcsicmp(pstrName, _T("textpadding")) == 0 ) {
+		else if( nAttr == DUIATTR_TEXTPADDING ) {
 			RECT rcTextPadding = { 0 };
 			LPTSTR pstr = NULL;
 			rcTextPadding.left = _tcstol(pstrValue, &pstr, 10);  ASSERT(pstr);    
@@ -1026,16 +1026,16 @@ namespace DuiLib {
 			rcTextPadding.bottom = _tcstol(pstr + 1, &pstr, 10); ASSERT(pstr);    
 			SetTextPadding(rcTextPadding);
 		}
-		else if( _tcsicmp(pstrName, _T("showhtml")) == 0 ) SetShowHtml(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if( _tcsicmp(pstrName, _T("showshadow")) == 0 ) SetShowShadow(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if( _tcsicmp(pstrName, _T("normalimage")) == 0 ) SetNormalImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("hotimage")) == 0 ) SetHotImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("pushedimage")) == 0 ) SetPushedImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("focusedimage")) == 0 ) SetFocusedImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("disabledimage")) == 0 ) SetDisabledImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("scrollselect")) == 0 ) SetScrollSelect(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if( _tcsicmp(pstrName, _T("dropbox")) == 0 ) SetDropBoxAttributeList(pstrValue);
-		else if( _tcsicmp(pstrName, _T("dropboxsize")) == 0)
+		else if( nAttr == DUIATTR_SHOWHTML ) SetShowHtml(_tcsicmp(pstrValue, _T("true")) == 0);
+		else if( nAttr == DUIATTR_SHOWSHADOW ) SetShowShadow(_tcsicmp(pstrValue, _T("true")) == 0);
+		else if( nAttr == DUIATTR_NORMALIMAGE ) SetNormalImage(pstrValue);
+		else if( nAttr == DUIATTR_HOTIMAGE ) SetHotImage(pstrValue);
+		else if( nAttr == DUIATTR_PUSHEDIMAGE ) SetPushedImage(pstrValue);
+		else if( nAttr == DUIATTR_FOCUSEDIMAGE ) SetFocusedImage(pstrValue);
+		else if( nAttr == DUIATTR_DISABLEDIMAGE ) SetDisabledImage(pstrValue);
+		else if( nAttr == DUIATTR_SCROLLSELECT ) SetScrollSelect(_tcsicmp(pstrValue, _T("true")) == 0);
+		else if( nAttr == DUIATTR_DROPBOX ) SetDropBoxAttributeList(pstrValue);
+		else if( nAttr == DUIATTR_DROPBOXSIZE)
 		{
 			SIZE szDropBoxSize = { 0 };
 			LPTSTR pstr = NULL;
@@ -1043,8 +1043,8 @@ namespace DuiLib {
 			szDropBoxSize.cy = _tcstol(pstr + 1, &pstr, 10);    ASSERT(pstr);    
 			SetDropBoxSize(szDropBoxSize);
 		}
-		else if( _tcsicmp(pstrName, _T("itemfont")) == 0 ) SetItemFont(_ttoi(pstrValue));
-		else if( _tcsicmp(pstrName, _T("itemalign")) == 0 ) {
+		else if( nAttr == DUIATTR_ITEMFONT ) SetItemFont(_ttoi(pstrValue));
+		else if( nAttr == DUIATTR_ITEMALIGN ) {
 			if( _tcsstr(pstrValue, _T("left")) != NULL ) {
 				m_ListInfo.uTextStyle &= ~(DT_CENTER | DT_RIGHT);
 				m_ListInfo.uTextStyle |= DT_LEFT;
@@ -1058,7 +1058,7 @@ namespace DuiLib {
 				m_ListInfo.uTextStyle |= DT_RIGHT;
 			}
 		}
-		else if( _tcsicmp(pstrName, _T("itemvalign")) == 0 ) {
+		else if( nAttr == DUIATTR_ITEMVALIGN ) {
 			if( _tcsstr(pstrValue, _T("top")) != NULL ) {
 				m_ListInfo.uTextStyle &= ~(DT_VCENTER | DT_BOTTOM);
 				m_ListInfo.uTextStyle |= DT_TOP;
@@ -1072,11 +1072,11 @@ namespace DuiLib {
 				m_ListInfo.uTextStyle |= DT_BOTTOM;
 			}
 		}
-		else if( _tcsicmp(pstrName, _T("itemendellipsis")) == 0 ) {
+		else if( nAttr == DUIATTR_ITEMENDELLIPSIS ) {
 			if( _tcsicmp(pstrValue, _T("true")) == 0 ) m_ListInfo.uTextStyle |= DT_END_ELLIPSIS;
 			else m_ListInfo.uTextStyle &= ~DT_END_ELLIPSIS;
 		}   
-		else if( _tcsicmp(pstrName, _T("itemtextpadding")) == 0 ) {
+		else if( nAttr == DUIATTR_ITEMTEXTPADDING ) {
 			RECT rcTextPadding = { 0 };
 			LPTSTR pstr = NULL;
 			rcTextPadding.left = _tcstol(pstrValue, &pstr, 10);  ASSERT(pstr);    
@@ -1085,67 +1085,67 @@ namespace DuiLib {
 			rcTextPadding.bottom = _tcstol(pstr + 1, &pstr, 10); ASSERT(pstr);    
 			SetItemTextPadding(rcTextPadding);
 		}
-		else if( _tcsicmp(pstrName, _T("itemtextcolor")) == 0 ) {
+		else if( nAttr == DUIATTR_ITEMTEXTCOLOR ) {
 			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
 			LPTSTR pstr = NULL;
 			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
 			SetItemTextColor(clrColor);
 		}
-		else if( _tcsicmp(pstrName, _T("itembkcolor")) == 0 ) {
+		else if( nAttr == DUIATTR_ITEMBKCOLOR ) {
 			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
 			LPTSTR pstr = NULL;
 			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
 			SetItemBkColor(clrColor);
 		}
-		else if( _tcsicmp(pstrName, _T("itembkimage")) == 0 ) SetItemBkImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("itemaltbk")) == 0 ) SetAlternateBk(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if( _tcsicmp(pstrName, _T("itemselectedtextcolor")) == 0 ) {
+		else if( nAttr == DUIATTR_ITEMBKIMAGE ) SetItemBkImage(pstrValue);
+		else if( nAttr == DUIATTR_ITEMALTBK ) SetAlternateBk(_tcsicmp(pstrValue, _T("true")) == 0);
+		else if( nAttr == DUIATTR_ITEMSELECTEDTEXTCOLOR ) {
 			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
 			LPTSTR pstr = NULL;
 			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
 			SetSelectedItemTextColor(clrColor);
 		}
-		else if( _tcsicmp(pstrName, _T("itemselectedbkcolor")) == 0 ) {
+		else if( nAttr == DUIATTR_ITEMSELECTEDBKCOLOR ) {
 			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
 			LPTSTR pstr = NULL;
 			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
 			SetSelectedItemBkColor(clrColor);
 		}
-		else if( _tcsicmp(pstrName, _T("itemselectedimage")) == 0 ) SetSelectedItemImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("itemhottextcolor")) == 0 ) {
+		else if( nAttr == DUIATTR_ITEMSELECTEDIMAGE ) SetSelectedItemImage(pstrValue);
+		else if( nAttr == DUIATTR_ITEMHOTTEXTCOLOR ) {
 			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
 			LPTSTR pstr = NULL;
 			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
 			SetHotItemTextColor(clrColor);
 		}
-		else if( _tcsicmp(pstrName, _T("itemhotbkcolor")) == 0 ) {
+		else if( nAttr == DUIATTR_ITEMHOTBKCOLOR ) {
 			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
 			LPTSTR pstr = NULL;
 			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
 			SetHotItemBkColor(clrColor);
 		}
-		else if( _tcsicmp(pstrName, _T("itemhotimage")) == 0 ) SetHotItemImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("itemdisabledtextcolor")) == 0 ) {
+		else if( nAttr == DUIATTR_ITEMHOTIMAGE ) SetHotItemImage(pstrValue);
+		else if( nAttr == DUIATTR_ITEMDISABLEDTEXTCOLOR ) {
 			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
 			LPTSTR pstr = NULL;
 			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
 			SetDisabledItemTextColor(clrColor);
 		}
-		else if( _tcsicmp(pstrName, _T("itemdisabledbkcolor")) == 0 ) {
+		else if( nAttr == DUIATTR_ITEMDISABLEDBKCOLOR ) {
 			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
 			LPTSTR pstr = NULL;
 			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
 			SetDisabledItemBkColor(clrColor);
 		}
-		else if( _tcsicmp(pstrName, _T("itemdisabledimage")) == 0 ) SetDisabledItemImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("itemlinecolor")) == 0 ) {
+		else if( nAttr == DUIATTR_ITEMDISABLEDIMAGE ) SetDisabledItemImage(pstrValue);
+		else if( nAttr == DUIATTR_ITEMLINECOLOR ) {
 			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
 			LPTSTR pstr = NULL;
 			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
 			SetItemLineColor(clrColor);
 		}
-		else if( _tcsicmp(pstrName, _T("itemshowhtml")) == 0 ) SetItemShowHtml(_tcsicmp(pstrValue, _T("true")) == 0);
-		else CContainerUI::SetAttribute(pstrName, pstrValue);
+		else if( nAttr == DUIATTR_ITEMSHOWHTML ) SetItemShowHtml(_tcsicmp(pstrValue, _T("true")) == 0);
+		else CContainerUI::SetAttributeById(nAttr, pstrName, pstrValue);
 	}
 
 	void CComboUI::DoPaint(HDC hDC, const RECT& rcPaint)
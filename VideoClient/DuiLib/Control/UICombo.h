@@ -114,7 +114,7 @@ namespace DuiLib {
 		void SetPos(RECT rc, bool bNeedInvalidate = true);
 		void Move(SIZE szOffset, bool bNeedInvalidate = true);
 		void DoEvent(TEventUI& event);
-		void SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue);
+		void SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue);
 
 		void DoPaint(HDC hDC, const RECT& rcPaint);
 		void PaintText(HDC hDC);
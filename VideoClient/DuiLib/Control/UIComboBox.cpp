@@ -15,12 +15,12 @@ namespace DuiLib
 		return _T("ComboBoxUI");
 	}
 
-	void CComboBoxUI::SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue)
+	void CComboBoxUI::SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue)
 	{
-		if (_tcsicmp(pstrName, _T("arrowimage")) == 0)
+		if (nAttr == DUIATTR_ARROWIMAGE)
 			m_sArrowImage = pstrValue;
 		else
-			CComboUI::SetAttribute(pstrName, pstrValue);
+			CComboUI::SetAttributeById(nAttr, pstrName, pstrValue);
 	}
 
 	void CComboBoxUI::PaintStatusImage(HDC hDC)
@@ -15,7 +15,7 @@ namespace DuiLib
 		CComboBoxUI();
 		LPCTSTR GetClass() const;
 
-		void SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue);
+		void SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue);
 
 		void PaintText(HDC hDC);
 		void PaintStatusImage(HDC hDC);
@@ -603,27 +603,27 @@ namespace DuiLib
 		return CControlUI::EstimateSize(szAvailable);
 	}
 
-	void CEditUI::SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue)
-	{
-		if( _tcsicmp(pstrName, _T("readonly")) == 0 ) SetReadOnly(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if( _tcsicmp(pstrName, _T("numberonly")) == 0 ) SetNumberOnly(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if( _tcsicmp(pstrName, _T("password")) == 0 ) SetPasswordMode(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if( _tcsicmp(pstrName, _T("passwordchar")) == 0 ) SetPasswordChar(*pstrValue);
-		else if( _tcsicmp(pstrName, _T("maxchar")) == 0 ) SetMaxChar(_ttoi(pstrValue));
-		else if( _tcsicmp(pstrName, _T("normalimage")) == 0 ) SetNormalImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("hotimage")) == 0 ) SetHotImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("focusedimage")) == 0 ) SetFocusedImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("disabledimage")) == 0 ) SetDisabledImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("tipvalue")) == 0 ) SetTipValue(pstrValue);
-		else if( _tcsicmp(pstrName, _T("tipvaluecolor")) == 0 ) SetTipValueColor(pstrValue);
-		else if( _tcsicmp(pstrName, _T("nativetextcolor")) == 0 ) SetNativeEditTextColor(pstrValue);
-		else if( _tcsicmp(pstrName, _T("nativebkcolor")) == 0 ) {
+	void CEditUI::SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue)
+	{
+		if( nAttr == DUIATTR_READONLY ) SetReadOnly(_tcsicmp(pstrValue, _T("true")) == 0);
+		else if( nAttr == DUIATTR_NUMBERONLY ) SetNumberOnly(_tcsicmp(pstrValue, _T("true")) == 0);
+		else if( nAttr == DUIATTR_PASSWORD ) SetPasswordMode(_tcsicmp(pstrValue, _T("true")) == 0);
+		else if( nAttr == DUIATTR_PASSWORDCHAR ) SetPasswordChar(*pstrValue);
+		else if( nAttr == DUIATTR_MAXCHAR ) SetMaxChar(_ttoi(pstrValue));
+		else if( nAttr == DUIATTR_NORMALIMAGE ) SetNormalImage(pstrValue);
+		else if( nAttr == DUIATTR_HOTIMAGE ) SetHotImage(pstrValue);
+		else if( nAttr == DUIATTR_FOCUSEDIMAGE ) SetFocusedImage(pstrValue);
+		else if( nAttr == DUIATTR_DISABLEDIMAGE ) SetDisabledImage(pstrValue);
+		else if( nAttr == DUIATTR_TIPVALUE ) SetTipValue(pstrValue);
+		else if( nAttr == DUIATTR_TIPVALUECOLOR ) SetTipValueColor(pstrValue);
+		else if( nAttr == DUIATTR_NATIVETEXTCOLOR ) SetNativeEditTextColor(pstrValue);
+		else if( nAttr == DUIATTR_NATIVEBKCOLOR ) {
 			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
 			LPTSTR pstr = NULL;
 			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
 			SetNativeEditBkColor(clrColor);
 		}
-		else CLabelUI::SetAttribute(pstrName, pstrValue);
+		else CLabelUI::SetAttributeById(nAttr, pstrName, pstrValue);
 	}
 
 	void CEditUI::PaintStatusImage(HDC hDC)
@@ -8,8 +8,6 @@ namespace DuiLib
 
 	CGifAnimUI::CGifAnimUI(void)
 	{
-		m_pGifImage			=	NULL;
-		m_pPropertyItem		=	NULL;
 		m_nFrameCount		=	0;	
 		m_nFramePosition	=	0;	
 		m_bIsAutoPlay		=	true;
@@ -45,7 +43,7 @@ namespace DuiLib
 	void CGifAnimUI::DoPaint( HDC hDC, const RECT& rcPaint )
 	{
 		if( !::IntersectRect( &m_rcPaint, &rcPaint, &m_rcItem ) ) return;
-		if ( NULL == m_pGifImage )
+		if ( 0 == m_nFrameCount )
 		{		
 			InitGifImage();
 		}
@@ -67,17 +65,17 @@ namespace DuiLib
 			StopGif();
 	}
 
-	void CGifAnimUI::SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue)
+	void CGifAnimUI::SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue)
 	{
-		if( _tcsicmp(pstrName, _T("bkimage")) == 0 ) SetBkImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("autoplay")) == 0 ) {
+		if( nAttr == DUIATTR_BKIMAGE ) SetBkImage(pstrValue);
+		else if( nAttr == DUIATTR_AUTOPLAY ) {
 			SetAutoPlay(_tcsicmp(pstrValue, _T("true")) == 0);
 		}
-		else if( _tcsicmp(pstrName, _T("autosize")) == 0 ) {
+		else if( nAttr == DUIATTR_AUTOSIZE ) {
 			SetAutoSize(_tcsicmp(pstrValue, _T("true")) == 0);
 		}
 		else
-			CControlUI::SetAttribute(pstrName, pstrValue);
+			CControlUI::SetAttributeById(nAttr, pstrName, pstrValue);
 	}
 
 	void CGifAnimUI::SetBkImage(LPCTSTR pStrImage)
@@ -120,21 +118,19 @@ namespace DuiLib
 
 	void CGifAnimUI::PlayGif()
 	{
-		if (m_bIsPlaying || m_pGifImage == NULL)
+		if (m_bIsPlaying || m_nFrameCount == 0)
 		{
 			return;
 		}
 
-		long lPause = ((long*) m_pPropertyItem->value)[m_nFramePosition] * 10;
-		if ( lPause == 0 ) lPause = 100;
-		m_pManager->SetTimer( this, EVENT_TIEM_ID, lPause );
+		m_pManager->SetTimer( this, EVENT_TIEM_ID, GetFrameDelay( m_nFramePosition ) );
 
 		m_bIsPlaying = true;
 	}
 
 	void CGifAnimUI::PauseGif()
 	{
-		if (!m_bIsPlaying || m_pGifImage == NULL)
+		if (!m_bIsPlaying || m_nFrameCount == 0)
 		{
 			return;
 		}
@@ -159,23 +155,22 @@ namespace DuiLib
 
 	void CGifAnimUI::InitGifImage()
 	{
-		m_pGifImage = CRenderEngine::GdiplusLoadImage(GetBkImage());
-		if ( NULL == m_pGifImage ) return;
-		UINT nCount	= 0;
-		nCount	=	m_pGifImage->GetFrameDimensionsCount();
-		GUID* pDimensionIDs	=	new GUID[ nCount ];
-		m_pGifImage->GetFrameDimensionsList( pDimensionIDs, nCount );
-		m_nFrameCount	=	m_pGifImage->GetFrameCount( &pDimensionIDs[0] );
-		int nSize		=	m_pGifImage->GetPropertyItemSize( PropertyTagFrameDelay );
-		m_pPropertyItem	=	(Gdiplus::PropertyItem*) malloc( nSize );
-		m_pGifImage->GetPropertyItem( PropertyTagFrameDelay, nSize, m_pPropertyItem );
-		delete  pDimensionIDs;
-		pDimensionIDs = NULL;
+		// the frames are decoded once and shared by every control showing this GIF
+		const TGifAtlasInfo* pAtlas = m_pManager->GetGifAtlas(GetBkImage());
+		if ( NULL == pAtlas ) return;
+		m_nFrameCount	=	pAtlas->nFrames;
+		// held while the control shows it, or the trim after each paint would have it decoded
+		// again for every frame
+		if ( m_sPinned.IsEmpty() )
+		{
+			m_sPinned = m_sBkImage;
+			CPaintManagerUI::PinGifAtlas(m_sPinned);
+		}
 
 		if (m_bIsAutoSize)
 		{
-			SetFixedWidth(m_pGifImage->GetWidth());
-			SetFixedHeight(m_pGifImage->GetHeight());
+			SetFixedWidth(pAtlas->image.nX);
+			SetFixedHeight(pAtlas->nFrameY);
 		}
 		if (m_bIsAutoPlay)
 		{
@@ -185,19 +180,13 @@ namespace DuiLib
 
 	void CGifAnimUI::DeleteGif()
 	{
-		if ( m_pGifImage != NULL )
-		{
-			delete m_pGifImage;
-			m_pGifImage = NULL;
-		}
-
-		if ( m_pPropertyItem != NULL )
-		{
-			free( m_pPropertyItem );
-			m_pPropertyItem = NULL;
-		}
 		m_nFrameCount		=	0;	
 		m_nFramePosition	=	0;	
+		if ( !m_sPinned.IsEmpty() )
+		{
+			CPaintManagerUI::UnpinGifAtlas(m_sPinned);
+			m_sPinned.Empty();
+		}
 	}
 
 	void CGifAnimUI::OnTimer( UINT_PTR idEvent )
@@ -209,17 +198,26 @@ namespace DuiLib
 
 		m_nFramePosition = (++m_nFramePosition) % m_nFrameCount;
 
-		long lPause = ((long*) m_pPropertyItem->value)[m_nFramePosition] * 10;
-		if ( lPause == 0 ) lPause = 100;
-		m_pManager->SetTimer( this, EVENT_TIEM_ID, lPause );
+		m_pManager->SetTimer( this, EVENT_TIEM_ID, GetFrameDelay( m_nFramePosition ) );
+	}
+
+	UINT CGifAnimUI::GetFrameDelay( UINT nFrame )
+	{
+		const TGifAtlasInfo* pAtlas = m_pManager->GetGifAtlas(GetBkImage());
+		UINT nDelay = 0;
+		if ( pAtlas != NULL && nFrame < (UINT)pAtlas->nFrames ) nDelay = pAtlas->pDelays[nFrame];
+		return nDelay > 0 ? nDelay : 100;
 	}
 
 	void CGifAnimUI::DrawFrame( HDC hDC )
 	{
-		if ( NULL == hDC || NULL == m_pGifImage ) return;
-		GUID pageGuid = Gdiplus::FrameDimensionTime;
-		Gdiplus::Graphics graphics( hDC );
-		graphics.DrawImage( m_pGifImage, m_rcItem.left, m_rcItem.top, m_rcItem.right-m_rcItem.left, m_rcItem.bottom-m_rcItem.top );
-		m_pGifImage->SelectActiveFrame( &pageGuid, m_nFramePosition );
+		if ( NULL == hDC || 0 == m_nFrameCount ) return;
+		const TGifAtlasInfo* pAtlas = m_pManager->GetGifAtlas(GetBkImage());
+		if ( NULL == pAtlas ) return;
+		UINT nFrame = m_nFramePosition % (UINT)pAtlas->nFrames;
+		RECT rcBmpPart = { 0, (LONG)nFrame * pAtlas->nFrameY, pAtlas->image.nX, (LONG)(nFrame + 1) * pAtlas->nFrameY };
+		RECT rcCorners = { 0 };
+		CRenderEngine::DrawImage( hDC, pAtlas->image.hBitmap, m_rcItem, m_rcPaint, rcBmpPart, rcCorners, \
+			m_pManager->IsLayered() ? true : pAtlas->image.bAlpha );
 	}
 }
\ No newline at end of file
@@ -22,7 +22,7 @@ namespace DuiLib
 		void	DoPaint(HDC hDC, const RECT& rcPaint) override;
 		void	DoEvent(TEventUI& event) override;
 		void	SetVisible(bool bVisible = true ) override;
-		void	SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue) override;
+		void	SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue) override;
 		void	SetBkImage(LPCTSTR pStrImage);
 		LPCTSTR GetBkImage();
 
@@ -38,15 +38,15 @@ namespace DuiLib
 		void	InitGifImage();
 		void	DeleteGif();
 		void    OnTimer( UINT_PTR idEvent );
+		UINT	GetFrameDelay( UINT nFrame );
 		void	DrawFrame( HDC hDC );		// GIFÿ֡
 
 	private:
-		Gdiplus::Image	*m_pGifImage;
 		UINT			m_nFrameCount;				// gifͼƬ֡
 		UINT			m_nFramePosition;			// ǰŵڼ֡
-		Gdiplus::PropertyItem*	m_pPropertyItem;	// ֮֡֡ʱ
 
 		CDuiString		m_sBkImage;
+		CDuiString		m_sPinned;					// the atlas pinned for this control, if any
 		bool			m_bIsAutoPlay;				// ǷԶgif
 		bool			m_bIsAutoSize;				// ǷԶͼƬôС
 		bool			m_bIsPlaying;
@@ -142,12 +142,12 @@ namespace DuiLib
 				return static_cast<CGifAnimExUI*>(this);
 			return CLabelUI::GetInterface(pstrName);
 	}
-	void CGifAnimExUI::SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue)
+	void CGifAnimExUI::SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue)
 	{
-		if( _tcscmp(pstrName, _T("auto")) == 0 ) 
+		if( nAttr == DUIATTR_AUTO ) 
 			m_pImp->SetAutoStart(_tcscmp(pstrValue, _T("true")) == 0);
 		else
-			__super::SetAttribute(pstrName, pstrValue);
+			__super::SetAttributeById(nAttr, pstrName, pstrValue);
 	}
 	void CGifAnimExUI::Init()
 	{
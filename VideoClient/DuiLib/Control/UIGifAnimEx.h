@@ -22,7 +22,7 @@ namespace DuiLib
 		virtual LPCTSTR	GetClass() const;
 		virtual LPVOID	GetInterface(LPCTSTR pstrName);
 		virtual void Init();
-		virtual void SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue);
+		virtual void SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue);
 		virtual void SetVisible(bool bVisible = true);
 		virtual void SetInternVisible(bool bVisible = true);
 		virtual void DoPaint(HDC hDC, const RECT& rcPaint);
@@ -134,27 +134,27 @@ namespace DuiLib
 		SIZE cXY = {rcText.right - rcText.left, rcText.bottom - rcText.top};
 		return cXY;
 	}
-	void CGroupBoxUI::SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue)
+	void CGroupBoxUI::SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue)
 	{
-		if( _tcsicmp(pstrName, _T("textcolor")) == 0 ) 
+		if( nAttr == DUIATTR_TEXTCOLOR ) 
 		{
 			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
 			LPTSTR pstr = NULL;
 			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
 			SetTextColor(clrColor);
 		}
-		else if( _tcsicmp(pstrName, _T("disabledtextcolor")) == 0 ) 
+		else if( nAttr == DUIATTR_DISABLEDTEXTCOLOR ) 
 		{
 			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
 			LPTSTR pstr = NULL;
 			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
 			SetDisabledTextColor(clrColor);
 		}
-		else if( _tcsicmp(pstrName, _T("font")) == 0 ) 
+		else if( nAttr == DUIATTR_FONT ) 
 		{
 			SetFont(_ttoi(pstrValue));
 		}
 
-		CVerticalLayoutUI::SetAttribute(pstrName, pstrValue);
+		CVerticalLayoutUI::SetAttributeById(nAttr, pstrName, pstrValue);
 	}
 }
@@ -25,7 +25,7 @@ namespace DuiLib
 		//Paint
 		virtual void PaintText(HDC hDC);
 		virtual void PaintBorder(HDC hDC);
-		virtual void SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue);
+		virtual void SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue);
 
 	private:
 		SIZE CalcrectSize(SIZE szAvailable);
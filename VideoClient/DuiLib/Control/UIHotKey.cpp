@@ -439,19 +439,19 @@ namespace DuiLib{
 		return CControlUI::EstimateSize(szAvailable);
 	}
 
-	void CHotKeyUI::SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue)
+	void CHotKeyUI::SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue)
 	{
-		if( _tcscmp(pstrName, _T("normalimage")) == 0 ) SetNormalImage(pstrValue);
-		else if( _tcscmp(pstrName, _T("hotimage")) == 0 ) SetHotImage(pstrValue);
-		else if( _tcscmp(pstrName, _T("focusedimage")) == 0 ) SetFocusedImage(pstrValue);
-		else if( _tcscmp(pstrName, _T("disabledimage")) == 0 ) SetDisabledImage(pstrValue);
-		else if( _tcscmp(pstrName, _T("nativebkcolor")) == 0 ) {
+		if( nAttr == DUIATTR_NORMALIMAGE ) SetNormalImage(pstrValue);
+		else if( nAttr == DUIATTR_HOTIMAGE ) SetHotImage(pstrValue);
+		else if( nAttr == DUIATTR_FOCUSEDIMAGE ) SetFocusedImage(pstrValue);
+		else if( nAttr == DUIATTR_DISABLEDIMAGE ) SetDisabledImage(pstrValue);
+		else if( nAttr == DUIATTR_NATIVEBKCOLOR ) {
 			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
 			LPTSTR pstr = NULL;
 			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
 			SetNativeBkColor(clrColor);
 		}
-		else CLabelUI::SetAttribute(pstrName, pstrValue);
+		else CLabelUI::SetAttributeById(nAttr, pstrName, pstrValue);
 	}
 
 	void CHotKeyUI::PaintStatusImage(HDC hDC)
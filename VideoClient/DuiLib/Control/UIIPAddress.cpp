@@ -301,8 +301,8 @@ namespace DuiLib
 		CLabelUI::DoEvent(event);
 	}
 
-	void CIPAddressUI::SetAttribute( LPCTSTR pstrName, LPCTSTR pstrValue )
+	void CIPAddressUI::SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue)
 	{
-		CLabelUI::SetAttribute(pstrName, pstrValue);
+		CLabelUI::SetAttributeById(nAttr, pstrName, pstrValue);
 	}
 }
@@ -30,7 +30,7 @@ namespace DuiLib
 
 		void DoEvent(TEventUI& event);
 
-		void SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue);
+		void SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue);
 
 	protected:
 		DWORD	m_dwIP;
@@ -133,9 +133,9 @@ namespace DuiLib
 		CControlUI::DoEvent(event);
 	}
 
-	void CLabelUI::SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue)
+	void CLabelUI::SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue)
 	{
-		if( _tcsicmp(pstrName, _T("align")) == 0 ) {
+		if( nAttr == DUIATTR_ALIGN ) {
 			if( _tcsstr(pstrValue, _T("left")) != NULL ) {
 				m_uTextStyle &= ~(DT_CENTER | DT_RIGHT);
 				m_uTextStyle |= DT_LEFT;
@@ -149,7 +149,7 @@ namespace DuiLib
 				m_uTextStyle |= DT_RIGHT;
 			}
 		}
-		else if( _tcsicmp(pstrName, _T("valign")) == 0 ) {
+		else if( nAttr == DUIATTR_VALIGN ) {
 			if( _tcsstr(pstrValue, _T("top")) != NULL ) {
 				m_uTextStyle &= ~(DT_BOTTOM | DT_VCENTER | DT_WORDBREAK);
 				m_uTextStyle |= (DT_TOP | DT_SINGLELINE);
@@ -163,11 +163,11 @@ namespace DuiLib
 				m_uTextStyle |= (DT_BOTTOM | DT_SINGLELINE);
 			}
 		}
-		else if( _tcsicmp(pstrName, _T("endellipsis")) == 0 ) {
+		else if( nAttr == DUIATTR_ENDELLIPSIS ) {
 			if( _tcsicmp(pstrValue, _T("true")) == 0 ) m_uTextStyle |= DT_END_ELLIPSIS;
 			else m_uTextStyle &= ~DT_END_ELLIPSIS;
 		}   
-		else if( _tcsicmp(pstrName, _T("wordbreak")) == 0 ) {
+		else if( nAttr == DUIATTR_WORDBREAK ) {
 			if( _tcsicmp(pstrValue, _T("true")) == 0 ) {
 				m_uTextStyle &= ~DT_SINGLELINE;
 				m_uTextStyle |= DT_WORDBREAK | DT_EDITCONTROL;
@@ -177,7 +177,7 @@ namespace DuiLib
 				m_uTextStyle |= DT_SINGLELINE;
 			}
 		}
-		else if( _tcsicmp(pstrName, _T("noprefix")) == 0 ) {
+		else if( nAttr == DUIATTR_NOPREFIX ) {
 			if( _tcsicmp(pstrValue, _T("true")) == 0)
 			{
 				m_uTextStyle |= DT_NOPREFIX;
@@ -187,20 +187,20 @@ namespace DuiLib
 				m_uTextStyle = m_uTextStyle & ~DT_NOPREFIX;
 			}
 		}
-		else if( _tcsicmp(pstrName, _T("font")) == 0 ) SetFont(_ttoi(pstrValue));
-		else if( _tcsicmp(pstrName, _T("textcolor")) == 0 ) {
+		else if( nAttr == DUIATTR_FONT ) SetFont(_ttoi(pstrValue));
+		else if( nAttr == DUIATTR_TEXTCOLOR ) {
 			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
 			LPTSTR pstr = NULL;
 			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
 			SetTextColor(clrColor);
 		}
-		else if( _tcsicmp(pstrName, _T("disabledtextcolor")) == 0 ) {
+		else if( nAttr == DUIATTR_DISABLEDTEXTCOLOR ) {
 			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
 			LPTSTR pstr = NULL;
 			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
 			SetDisabledTextColor(clrColor);
 		}
-		else if( _tcsicmp(pstrName, _T("textpadding")) == 0 ) {
+		else if( nAttr == DUIATTR_TEXTPADDING ) {
 			RECT rcTextPadding = { 0 };
 			LPTSTR pstr = NULL;
 			rcTextPadding.left = _tcstol(pstrValue, &pstr, 10);  ASSERT(pstr);    
@@ -209,11 +209,11 @@ namespace DuiLib
 			rcTextPadding.bottom = _tcstol(pstr + 1, &pstr, 10); ASSERT(pstr);    
 			SetTextPadding(rcTextPadding);
 		}
-		else if( _tcsicmp(pstrName, _T("showhtml")) == 0 ) SetShowHtml(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if( _tcsicmp(pstrName, _T("autocalcwidth")) == 0 ) {
+		else if( nAttr == DUIATTR_SHOWHTML ) SetShowHtml(_tcsicmp(pstrValue, _T("true")) == 0);
+		else if( nAttr == DUIATTR_AUTOCALCWIDTH ) {
 			SetAutoCalcWidth(_tcsicmp(pstrValue, _T("true")) == 0);
 		}
-		else CControlUI::SetAttribute(pstrName, pstrValue);
+		else CControlUI::SetAttributeById(nAttr, pstrName, pstrValue);
 	}
 
 	void CLabelUI::PaintText(HDC hDC)
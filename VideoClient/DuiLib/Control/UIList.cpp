@@ -7,7 +7,7 @@ namespace DuiLib {
 	//
 	IMPLEMENT_DUICONTROL(CListUI)
 
-	CListUI::CListUI() : m_pCallback(NULL), m_bScrollSelect(false), m_iCurSel(-1), m_iExpandedItem(-1), m_bMultiSel(false)
+	CListUI::CListUI() : m_pCallback(NULL), m_pDataSource(NULL), m_bSyncingItems(false), m_bScrollSelect(false), m_iCurSel(-1), m_iExpandedItem(-1), m_bMultiSel(false)
 	{
 		m_bFixedScrollbar = false;
 		m_pList = new CListBodyUI(this);
@@ -58,6 +58,7 @@ namespace DuiLib {
 
 	CControlUI* CListUI::GetItemAt(int iIndex) const
 	{
+		if( m_pDataSource != NULL ) return m_pList->GetVirtualItem(iIndex);
 		return m_pList->GetItemAt(iIndex);
 	}
 
@@ -67,6 +68,11 @@ namespace DuiLib {
 		// We also need to recognize header sub-items
 		if( _tcsstr(pControl->GetClass(), _T("ListHeaderItemUI")) != NULL ) return m_pHeader->GetItemIndex(pControl);
 
+		if( m_pDataSource != NULL ) {
+			if( m_pList->GetItemIndex(pControl) < 0 ) return -1;
+			IListItemUI* pListItem = static_cast<IListItemUI*>(pControl->GetInterface(_T("ListItem")));
+			return pListItem != NULL ? pListItem->GetIndex() : -1;
+		}
 		return m_pList->GetItemIndex(pControl);
 	}
 
@@ -75,6 +81,7 @@ namespace DuiLib {
 		if( pControl->GetInterface(_T("ListHeader")) != NULL ) return CVerticalLayoutUI::SetItemIndex(pControl, iIndex);
 		// We also need to recognize header sub-items
 		if( _tcsstr(pControl->GetClass(), _T("ListHeaderItemUI")) != NULL ) return m_pHeader->SetItemIndex(pControl, iIndex);
+		if( m_pDataSource != NULL ) return false;
 
 		int iOrginIndex = m_pList->GetItemIndex(pControl);
 		if( iOrginIndex == -1 ) return false;
@@ -99,6 +106,7 @@ namespace DuiLib {
 
 	int CListUI::GetCount() const
 	{
+		if( m_pDataSource != NULL ) return m_pDataSource->GetItemCount(const_cast<CListUI*>(this));
 		return m_pList->GetCount();
 	}
 
@@ -124,6 +132,7 @@ namespace DuiLib {
 		// The list items should know about us
 		IListItemUI* pListItem = static_cast<IListItemUI*>(pControl->GetInterface(_T("ListItem")));
 		if( pListItem != NULL ) {
+			if( m_pDataSource != NULL ) return false;
 			pListItem->SetOwner(this);
 			pListItem->SetIndex(GetCount());
 			return m_pList->Add(pControl);
@@ -150,6 +159,7 @@ namespace DuiLib {
 			m_ListInfo.nColumns = MIN(m_pHeader->GetCount(), UILIST_MAX_COLUMNS);
 			return ret;
 		}
+		if( m_pDataSource != NULL ) return false;
 		if (!m_pList->AddAt(pControl, iIndex)) return false;
 
 		// The list items should know about us
@@ -175,6 +185,7 @@ namespace DuiLib {
 		if( pControl->GetInterface(_T("ListHeader")) != NULL ) return CVerticalLayoutUI::Remove(pControl);
 		// We also need to recognize header sub-items
 		if( _tcsstr(pControl->GetClass(), _T("ListHeaderItemUI")) != NULL ) return m_pHeader->Remove(pControl);
+		if( m_pDataSource != NULL ) return false;
 
 		int iIndex = m_pList->GetItemIndex(pControl);
 		if (iIndex == -1) return false;
@@ -200,6 +211,7 @@ namespace DuiLib {
 
 	bool CListUI::RemoveAt(int iIndex)
 	{
+		if( m_pDataSource != NULL ) return false;
 		if (!m_pList->RemoveAt(iIndex)) return false;
 
 		for(int i = iIndex; i < m_pList->GetCount(); ++i) {
@@ -221,6 +233,8 @@ namespace DuiLib {
 	{
 		m_iCurSel = -1;
 		m_iExpandedItem = -1;
+		// in virtual mode only the rows in view go, and come back from the data source
+		if( m_pDataSource != NULL ) m_aSelItems.Empty();
 		m_pList->RemoveAll();
 	}
 
@@ -264,32 +278,12 @@ namespace DuiLib {
 
 	int CListUI::GetMinSelItemIndex()
 	{
-		if (m_aSelItems.GetSize() <= 0)
-			return -1;
-		int min = (int)m_aSelItems.GetAt(0);
-		int index;
-		for (int i = 0; i < m_aSelItems.GetSize(); ++i)
-		{
-			index = (int)m_aSelItems.GetAt(i);
-			if (min > index)
-				min = index;
-		}
-		return min;
+		return m_aSelItems.GetFirst();
 	}
 
 	int CListUI::GetMaxSelItemIndex()
 	{
-		if (m_aSelItems.GetSize() <= 0)
-			return -1;
-		int max = (int)m_aSelItems.GetAt(0);
-		int index;
-		for (int i = 0; i < m_aSelItems.GetSize(); ++i)
-		{
-			index = (int)m_aSelItems.GetAt(i);
-			if (max < index)
-				max = index;
-		}
-		return max;
+		return m_aSelItems.GetLast();
 	}
 
 	void CListUI::DoEvent(TEventUI& event)
@@ -328,7 +322,7 @@ namespace DuiLib {
 					if (m_aSelItems.GetSize() > 0) {					
 						int index = GetMaxSelItemIndex() + 1;
 						UnSelectAllItems();
-						index + 1 > m_pList->GetCount() ? SelectItem(GetCount() - 1, true) : SelectItem(index, true);					
+						index + 1 > GetCount() ? SelectItem(GetCount() - 1, true) : SelectItem(index, true);					
 					}
 				}
 				return;
@@ -345,7 +339,7 @@ namespace DuiLib {
 				SelectItem(FindSelectable(GetCount() - 1, true), true);
 				return;
 			case VK_RETURN:
-				if( m_iCurSel != -1 ) GetItemAt(m_iCurSel)->Activate();
+				if( m_iCurSel != -1 && GetItemAt(m_iCurSel) != NULL ) GetItemAt(m_iCurSel)->Activate();
 				return;
 			case 0x41:// Ctrl+A
 				{
@@ -422,18 +416,26 @@ namespace DuiLib {
 
 	int CListUI::GetCurSel() const
 	{	
-		if (m_aSelItems.GetSize() <= 0) {
-			return -1;
-		}
-		else {
-			return (int)m_aSelItems.GetAt(0);
-		}
-
-		return -1;
+		// the selected rows are kept in order, so this is the first of them
+		return m_aSelItems.GetFirst();
 	}
 
 	bool CListUI::SelectItem(int iIndex, bool bTakeFocus)
 	{
+		if( m_bSyncingItems ) return false;
+		if( m_pDataSource != NULL ) {
+			UnSelectAllItems();
+			if( iIndex < 0 || iIndex >= GetCount() ) return false;
+			m_iCurSel = iIndex;
+			m_aSelItems.Add(iIndex);
+			SyncItemSelection();
+			EnsureVisible(iIndex);
+			CControlUI* pControl = GetItemAt(iIndex);
+			if( bTakeFocus && pControl != NULL ) pControl->SetFocus();
+			if( m_pManager != NULL ) m_pManager->SendNotify(this, DUI_MSGTYPE_ITEMSELECT, iIndex);
+			return true;
+		}
+
 		// ȡѡ
 		UnSelectAllItems();
 		// жǷϷб
@@ -447,7 +449,7 @@ namespace DuiLib {
 		}
 		int iLastSel = m_iCurSel;
 		m_iCurSel = iIndex;
-		m_aSelItems.Add((LPVOID)iIndex);
+		m_aSelItems.Add(iIndex);
 		EnsureVisible(iIndex);
 		if( bTakeFocus ) pControl->SetFocus();
 		if( m_pManager != NULL && iLastSel != m_iCurSel) {
@@ -459,18 +461,31 @@ namespace DuiLib {
 	
 	bool CListUI::SelectMultiItem(int iIndex, bool bTakeFocus)
 	{
+		if( m_bSyncingItems ) return false;
 		if(!IsMultiSelect()) return SelectItem(iIndex, bTakeFocus);
+		if( m_pDataSource != NULL ) {
+			if( iIndex < 0 || iIndex >= GetCount() ) return false;
+			if( m_aSelItems.Find(iIndex) ) return false;
+			m_iCurSel = iIndex;
+			m_aSelItems.Add(iIndex);
+			SyncItemSelection();
+			EnsureVisible(iIndex);
+			CControlUI* pControl = GetItemAt(iIndex);
+			if( bTakeFocus && pControl != NULL ) pControl->SetFocus();
+			if( m_pManager != NULL ) m_pManager->SendNotify(this, DUI_MSGTYPE_ITEMSELECT, iIndex);
+			return true;
+		}
 
 		if( iIndex < 0 ) return false;
 		CControlUI* pControl = GetItemAt(iIndex);
 		if( pControl == NULL ) return false;
 		IListItemUI* pListItem = static_cast<IListItemUI*>(pControl->GetInterface(_T("ListItem")));
 		if( pListItem == NULL ) return false;
-		if(m_aSelItems.Find((LPVOID)iIndex) >= 0) return false;
+		if(m_aSelItems.Find(iIndex)) return false;
 		if(!pListItem->SelectMulti(true)) return false;
 
 		m_iCurSel = iIndex;
-		m_aSelItems.Add((LPVOID)iIndex);
+		m_aSelItems.Add(iIndex);
 		EnsureVisible(iIndex);
 		if( bTakeFocus ) pControl->SetFocus();
 		if( m_pManager != NULL ) {
@@ -492,10 +507,23 @@ namespace DuiLib {
 
 	bool CListUI::UnSelectItem(int iIndex, bool bOthers)
 	{
+		if( m_bSyncingItems ) return false;
+		if( m_pDataSource != NULL ) {
+			if( bOthers ) {
+				bool bSelected = IsItemSelected(iIndex);
+				m_aSelItems.Empty();
+				if( bSelected ) m_aSelItems.Add(iIndex);
+			}
+			else {
+				if( !m_aSelItems.Remove(iIndex) ) return false;
+				if( m_iCurSel == iIndex ) m_iCurSel = -1;
+			}
+			SyncItemSelection();
+			return true;
+		}
 		if(!IsMultiSelect()) return false;
 		if(bOthers) {
-			for (int i = m_aSelItems.GetSize() - 1; i >= 0; --i) {
-				int iSelIndex = (int)m_aSelItems.GetAt(i);
+			for (int iSelIndex = m_aSelItems.GetFirst(); iSelIndex >= 0; iSelIndex = m_aSelItems.GetNext(iSelIndex)) {
 				if(iSelIndex == iIndex) continue;
 				CControlUI* pControl = GetItemAt(iSelIndex);
 				if(pControl == NULL) continue;
@@ -503,7 +531,7 @@ namespace DuiLib {
 				IListItemUI* pSelListItem = static_cast<IListItemUI*>(pControl->GetInterface(_T("ListItem")));
 				if( pSelListItem == NULL ) continue;
 				if( !pSelListItem->SelectMulti(false) ) continue;
-				m_aSelItems.Remove(i);
+				m_aSelItems.Remove(iSelIndex);
 			}
 		}
 		else {
@@ -513,17 +541,24 @@ namespace DuiLib {
 			if( !pControl->IsEnabled() ) return false;
 			IListItemUI* pListItem = static_cast<IListItemUI*>(pControl->GetInterface(_T("ListItem")));
 			if( pListItem == NULL ) return false;
-			int aIndex = m_aSelItems.Find((LPVOID)iIndex);
-			if (aIndex < 0) return false;
+			if (!m_aSelItems.Find(iIndex)) return false;
 			if( !pListItem->SelectMulti(false) ) return false;
 			if(m_iCurSel == iIndex) m_iCurSel = -1;
-			m_aSelItems.Remove(aIndex);
+			m_aSelItems.Remove(iIndex);
 		}
 		return true;
 	}
 
 	void CListUI::SelectAllItems()
 	{
+		if( m_pDataSource != NULL ) {
+			int nCount = GetCount();
+			m_aSelItems.Empty();
+			if( nCount > 0 ) m_aSelItems.AddRange(0, nCount - 1);
+			m_iCurSel = nCount - 1;
+			SyncItemSelection();
+			return;
+		}
 		for (int i = 0; i < GetCount(); ++i) {
 			CControlUI* pControl = GetItemAt(i);
 			if(pControl == NULL) continue;
@@ -533,15 +568,20 @@ namespace DuiLib {
 			if(pListItem == NULL) continue;
 			if(!pListItem->SelectMulti(true)) continue;
 
-			m_aSelItems.Add((LPVOID)i);
+			m_aSelItems.Add(i);
 			m_iCurSel = i;
 		}
 	}
 
 	void CListUI::UnSelectAllItems()
 	{
-		for (int i = 0; i < m_aSelItems.GetSize(); ++i) {
-			int iSelIndex = (int)m_aSelItems.GetAt(i);
+		if( m_pDataSource != NULL ) {
+			m_aSelItems.Empty();
+			m_iCurSel = -1;
+			SyncItemSelection();
+			return;
+		}
+		for (int iSelIndex = m_aSelItems.GetFirst(); iSelIndex >= 0; iSelIndex = m_aSelItems.GetNext(iSelIndex)) {
 			CControlUI* pControl = GetItemAt(iSelIndex);
 			if(pControl == NULL) continue;
 			if(!pControl->IsEnabled()) continue;
@@ -560,17 +600,11 @@ namespace DuiLib {
 
 	int CListUI::GetNextSelItem(int nItem) const
 	{
-		if (m_aSelItems.GetSize() <= 0)
-			return -1;
-
 		if (nItem < 0) {
-			return (int)m_aSelItems.GetAt(0);
+			return m_aSelItems.GetFirst();
 		}
-		int aIndex = m_aSelItems.Find((LPVOID)nItem);
-		if (aIndex < 0) return -1;
-		if (aIndex + 1 > m_aSelItems.GetSize() - 1)
-			return -1;
-		return (int)m_aSelItems.GetAt(aIndex + 1);
+		if (!m_aSelItems.Find(nItem)) return -1;
+		return m_aSelItems.GetNext(nItem);
 	}
 
 	UINT CListUI::GetListType()
@@ -855,7 +889,7 @@ namespace DuiLib {
 	void CListUI::EnsureVisible(int iIndex)
 	{
 		if( m_iCurSel < 0 ) return;
-		RECT rcItem = m_pList->GetItemAt(iIndex)->GetPos();
+		RECT rcItem = m_pDataSource != NULL ? m_pList->GetVirtualItemPos(iIndex) : m_pList->GetItemAt(iIndex)->GetPos();
 		RECT rcList = m_pList->GetPos();
 		RECT rcListInset = m_pList->GetInset();
 
@@ -882,15 +916,15 @@ namespace DuiLib {
 		m_pList->SetScrollPos(CDuiSize(sz.cx + dx, sz.cy + dy));
 	}
 
-	void CListUI::SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue)
+	void CListUI::SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue)
 	{
-		if( _tcsicmp(pstrName, _T("header")) == 0 ) GetHeader()->SetVisible(_tcsicmp(pstrValue, _T("hidden")) != 0);
-		else if( _tcsicmp(pstrName, _T("headerbkimage")) == 0 ) GetHeader()->SetBkImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("scrollselect")) == 0 ) SetScrollSelect(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if( _tcsicmp(pstrName, _T("fixedscrollbar")) == 0 ) SetFixedScrollbar(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if( _tcsicmp(pstrName, _T("multiexpanding")) == 0 ) SetMultiExpanding(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if( _tcsicmp(pstrName, _T("itemfont")) == 0 ) m_ListInfo.nFont = _ttoi(pstrValue);
-		else if( _tcsicmp(pstrName, _T("itemalign")) == 0 ) {
+		if( nAttr == DUIATTR_HEADER ) GetHeader()->SetVisible(_tcsicmp(pstrValue, _T("hidden")) != 0);
+		else if( nAttr == DUIATTR_HEADERBKIMAGE ) GetHeader()->SetBkImage(pstrValue);
+		else if( nAttr == DUIATTR_SCROLLSELECT ) SetScrollSelect(_tcsicmp(pstrValue, _T("true")) == 0);
+		else if( nAttr == DUIATTR_FIXEDSCROLLBAR ) SetFixedScrollbar(_tcsicmp(pstrValue, _T("true")) == 0);
+		else if( nAttr == DUIATTR_MULTIEXPANDING ) SetMultiExpanding(_tcsicmp(pstrValue, _T("true")) == 0);
+		else if( nAttr == DUIATTR_ITEMFONT ) m_ListInfo.nFont = _ttoi(pstrValue);
+		else if( nAttr == DUIATTR_ITEMALIGN ) {
 			if( _tcsstr(pstrValue, _T("left")) != NULL ) {
 				m_ListInfo.uTextStyle &= ~(DT_CENTER | DT_RIGHT);
 				m_ListInfo.uTextStyle |= DT_LEFT;
@@ -904,7 +938,7 @@ namespace DuiLib {
 				m_ListInfo.uTextStyle |= DT_RIGHT;
 			}
 		}
-		else if( _tcsicmp(pstrName, _T("itemvalign")) == 0 ) {
+		else if( nAttr == DUIATTR_ITEMVALIGN ) {
 			if( _tcsstr(pstrValue, _T("top")) != NULL ) {
 				m_ListInfo.uTextStyle &= ~(DT_VCENTER | DT_BOTTOM);
 				m_ListInfo.uTextStyle |= DT_TOP;
@@ -918,11 +952,11 @@ namespace DuiLib {
 				m_ListInfo.uTextStyle |= DT_BOTTOM;
 			}
 		}
-		else if( _tcsicmp(pstrName, _T("itemendellipsis")) == 0 ) {
+		else if( nAttr == DUIATTR_ITEMENDELLIPSIS ) {
 			if( _tcsicmp(pstrValue, _T("true")) == 0 ) m_ListInfo.uTextStyle |= DT_END_ELLIPSIS;
 			else m_ListInfo.uTextStyle &= ~DT_END_ELLIPSIS;
 		}    
-		else if( _tcsicmp(pstrName, _T("itemtextpadding")) == 0 ) {
+		else if( nAttr == DUIATTR_ITEMTEXTPADDING ) {
 			RECT rcTextPadding = { 0 };
 			LPTSTR pstr = NULL;
 			rcTextPadding.left = _tcstol(pstrValue, &pstr, 10);  ASSERT(pstr);    
@@ -931,71 +965,71 @@ namespace DuiLib {
 			rcTextPadding.bottom = _tcstol(pstr + 1, &pstr, 10); ASSERT(pstr);    
 			SetItemTextPadding(rcTextPadding);
 		}
-		else if( _tcsicmp(pstrName, _T("itemtextcolor")) == 0 ) {
+		else if( nAttr == DUIATTR_ITEMTEXTCOLOR ) {
 			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
 			LPTSTR pstr = NULL;
 			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
 			SetItemTextColor(clrColor);
 		}
-		else if( _tcsicmp(pstrName, _T("itembkcolor")) == 0 ) {
+		else if( nAttr == DUIATTR_ITEMBKCOLOR ) {
 			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
 			LPTSTR pstr = NULL;
 			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
 			SetItemBkColor(clrColor);
 		}
-		else if( _tcsicmp(pstrName, _T("itembkimage")) == 0 ) SetItemBkImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("itemaltbk")) == 0 ) SetAlternateBk(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if( _tcsicmp(pstrName, _T("itemselectedtextcolor")) == 0 ) {
+		else if( nAttr == DUIATTR_ITEMBKIMAGE ) SetItemBkImage(pstrValue);
+		else if( nAttr == DUIATTR_ITEMALTBK ) SetAlternateBk(_tcsicmp(pstrValue, _T("true")) == 0);
+		else if( nAttr == DUIATTR_ITEMSELECTEDTEXTCOLOR ) {
 			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
 			LPTSTR pstr = NULL;
 			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
 			SetSelectedItemTextColor(clrColor);
 		}
-		else if( _tcsicmp(pstrName, _T("itemselectedbkcolor")) == 0 ) {
+		else if( nAttr == DUIATTR_ITEMSELECTEDBKCOLOR ) {
 			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
 			LPTSTR pstr = NULL;
 			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
 			SetSelectedItemBkColor(clrColor);
 		}
-		else if( _tcsicmp(pstrName, _T("itemselectedimage")) == 0 ) SetSelectedItemImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("itemhottextcolor")) == 0 ) {
+		else if( nAttr == DUIATTR_ITEMSELECTEDIMAGE ) SetSelectedItemImage(pstrValue);
+		else if( nAttr == DUIATTR_ITEMHOTTEXTCOLOR ) {
 			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
 			LPTSTR pstr = NULL;
 			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
 			SetHotItemTextColor(clrColor);
 		}
-		else if( _tcsicmp(pstrName, _T("itemhotbkcolor")) == 0 ) {
+		else if( nAttr == DUIATTR_ITEMHOTBKCOLOR ) {
 			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
 			LPTSTR pstr = NULL;
 			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
 			SetHotItemBkColor(clrColor);
 		}
-		else if( _tcsicmp(pstrName, _T("itemhotimage")) == 0 ) SetHotItemImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("itemdisabledtextcolor")) == 0 ) {
+		else if( nAttr == DUIATTR_ITEMHOTIMAGE ) SetHotItemImage(pstrValue);
+		else if( nAttr == DUIATTR_ITEMDISABLEDTEXTCOLOR ) {
 			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
 			LPTSTR pstr = NULL;
 			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
 			SetDisabledItemTextColor(clrColor);
 		}
-		else if( _tcsicmp(pstrName, _T("itemdisabledbkcolor")) == 0 ) {
+		else if( nAttr == DUIATTR_ITEMDISABLEDBKCOLOR ) {
 			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
 			LPTSTR pstr = NULL;
 			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
 			SetDisabledItemBkColor(clrColor);
 		}
-		else if( _tcsicmp(pstrName, _T("itemdisabledimage")) == 0 ) SetDisabledItemImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("itemlinecolor")) == 0 ) {
+		else if( nAttr == DUIATTR_ITEMDISABLEDIMAGE ) SetDisabledItemImage(pstrValue);
+		else if( nAttr == DUIATTR_ITEMLINECOLOR ) {
 			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
 			LPTSTR pstr = NULL;
 			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
 			SetItemLineColor(clrColor);
 		}
-		else if( _tcsicmp(pstrName, _T("itemshowrowline")) == 0 ) SetItemShowRowLine(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if( _tcsicmp(pstrName, _T("itemshowcolumnline")) == 0 ) SetItemShowColumnLine(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if( _tcsicmp(pstrName, _T("itemshowhtml")) == 0 ) SetItemShowHtml(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if ( _tcscmp(pstrName, _T("multiselect")) == 0 ) SetMultiSelect(_tcscmp(pstrValue, _T("true")) == 0);
-		else if ( _tcscmp(pstrName, _T("itemrselected")) == 0 ) SetItemRSelected(_tcscmp(pstrValue, _T("true")) == 0);
-		else CVerticalLayoutUI::SetAttribute(pstrName, pstrValue);
+		else if( nAttr == DUIATTR_ITEMSHOWROWLINE ) SetItemShowRowLine(_tcsicmp(pstrValue, _T("true")) == 0);
+		else if( nAttr == DUIATTR_ITEMSHOWCOLUMNLINE ) SetItemShowColumnLine(_tcsicmp(pstrValue, _T("true")) == 0);
+		else if( nAttr == DUIATTR_ITEMSHOWHTML ) SetItemShowHtml(_tcsicmp(pstrValue, _T("true")) == 0);
+		else if ( nAttr == DUIATTR_MULTISELECT ) SetMultiSelect(_tcscmp(pstrValue, _T("true")) == 0);
+		else if ( nAttr == DUIATTR_ITEMRSELECTED ) SetItemRSelected(_tcscmp(pstrValue, _T("true")) == 0);
+		else CVerticalLayoutUI::SetAttributeById(nAttr, pstrName, pstrValue);
 	}
 
 	IListCallbackUI* CListUI::GetTextCallback() const
@@ -1100,7 +1134,7 @@ namespace DuiLib {
 
 	BOOL CListUI::SortItems(PULVCompareFunc pfnCompare, UINT_PTR dwData)
 	{
-		if (!m_pList)
+		if (!m_pList || m_pDataSource != NULL)
 			return FALSE;
 		return m_pList->SortItems(pfnCompare, dwData);	
 	}
@@ -1180,7 +1214,9 @@ namespace DuiLib {
 		}
 
 		RECT rcPos;
-		for( int it2 = 0; it2 < m_items.GetSize(); it2++ ) {
+		// in virtual mode the rows coming into view are bound, not moved
+		if( m_pOwner != NULL && m_pOwner->GetDataSource() != NULL ) SetPos(m_rcItem, false);
+		else for( int it2 = 0; it2 < m_items.GetSize(); it2++ ) {
 			CControlUI* pControl = static_cast<CControlUI*>(m_items[it2]);
 			if( !pControl->IsVisible() ) continue;
 			if( pControl->IsFloat() ) continue;
@@ -1226,6 +1262,11 @@ namespace DuiLib {
 
 	void CListBodyUI::SetPos(RECT rc, bool bNeedInvalidate)
 	{
+		if( m_pOwner->GetDataSource() != NULL ) {
+			SetVirtualPos(rc, bNeedInvalidate);
+			return;
+		}
+
 		CControlUI::SetPos(rc, bNeedInvalidate);
 		rc = m_rcItem;
 
@@ -1544,10 +1585,10 @@ namespace DuiLib {
 		cxNeeded += (nEstimateNum - 1) * m_iChildPadding;
 	}
 
-	void CListHeaderUI::SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue)
+	void CListHeaderUI::SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue)
 	{
-		if( _tcsicmp(pstrName, _T("scaleheader")) == 0 ) SetScaleHeader(_tcsicmp(pstrValue, _T("true")) == 0);
-		else CHorizontalLayoutUI::SetAttribute(pstrName, pstrValue);
+		if( nAttr == DUIATTR_SCALEHEADER ) SetScaleHeader(_tcsicmp(pstrValue, _T("true")) == 0);
+		else CHorizontalLayoutUI::SetAttributeById(nAttr, pstrName, pstrValue);
 	}
 
 	void CListHeaderUI::SetScaleHeader(bool bIsScale)
@@ -1734,11 +1775,11 @@ namespace DuiLib {
 		return m_nScale;
 	}
 
-	void CListHeaderItemUI::SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue)
+	void CListHeaderItemUI::SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue)
 	{
-		if( _tcsicmp(pstrName, _T("dragable")) == 0 ) SetDragable(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if( _tcsicmp(pstrName, _T("sepwidth")) == 0 ) SetSepWidth(_ttoi(pstrValue));
-		else if( _tcsicmp(pstrName, _T("align")) == 0 ) {
+		if( nAttr == DUIATTR_DRAGABLE ) SetDragable(_tcsicmp(pstrValue, _T("true")) == 0);
+		else if( nAttr == DUIATTR_SEPWIDTH ) SetSepWidth(_ttoi(pstrValue));
+		else if( nAttr == DUIATTR_ALIGN ) {
 			if( _tcsstr(pstrValue, _T("left")) != NULL ) {
 				m_uTextStyle &= ~(DT_CENTER | DT_RIGHT);
 				m_uTextStyle |= DT_LEFT;
@@ -1752,18 +1793,18 @@ namespace DuiLib {
 				m_uTextStyle |= DT_RIGHT;
 			}
 		}
-		else if( _tcsicmp(pstrName, _T("endellipsis")) == 0 ) {
+		else if( nAttr == DUIATTR_ENDELLIPSIS ) {
 			if( _tcsicmp(pstrValue, _T("true")) == 0 ) m_uTextStyle |= DT_END_ELLIPSIS;
 			else m_uTextStyle &= ~DT_END_ELLIPSIS;
 		}    
-		else if( _tcsicmp(pstrName, _T("font")) == 0 ) SetFont(_ttoi(pstrValue));
-		else if( _tcsicmp(pstrName, _T("textcolor")) == 0 ) {
+		else if( nAttr == DUIATTR_FONT ) SetFont(_ttoi(pstrValue));
+		else if( nAttr == DUIATTR_TEXTCOLOR ) {
 			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
 			LPTSTR pstr = NULL;
 			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
 			SetTextColor(clrColor);
 		}
-		else if( _tcsicmp(pstrName, _T("textpadding")) == 0 ) {
+		else if( nAttr == DUIATTR_TEXTPADDING ) {
 			RECT rcTextPadding = { 0 };
 			LPTSTR pstr = NULL;
 			rcTextPadding.left = _tcstol(pstrValue, &pstr, 10);  ASSERT(pstr);    
@@ -1772,18 +1813,18 @@ namespace DuiLib {
 			rcTextPadding.bottom = _tcstol(pstr + 1, &pstr, 10); ASSERT(pstr);    
 			SetTextPadding(rcTextPadding);
 		}
-		else if( _tcsicmp(pstrName, _T("showhtml")) == 0 ) SetShowHtml(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if( _tcsicmp(pstrName, _T("normalimage")) == 0 ) SetNormalImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("hotimage")) == 0 ) SetHotImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("pushedimage")) == 0 ) SetPushedImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("focusedimage")) == 0 ) SetFocusedImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("sepimage")) == 0 ) SetSepImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("scale")) == 0 ) {
+		else if( nAttr == DUIATTR_SHOWHTML ) SetShowHtml(_tcsicmp(pstrValue, _T("true")) == 0);
+		else if( nAttr == DUIATTR_NORMALIMAGE ) SetNormalImage(pstrValue);
+		else if( nAttr == DUIATTR_HOTIMAGE ) SetHotImage(pstrValue);
+		else if( nAttr == DUIATTR_PUSHEDIMAGE ) SetPushedImage(pstrValue);
+		else if( nAttr == DUIATTR_FOCUSEDIMAGE ) SetFocusedImage(pstrValue);
+		else if( nAttr == DUIATTR_SEPIMAGE ) SetSepImage(pstrValue);
+		else if( nAttr == DUIATTR_SCALE ) {
 			LPTSTR pstr = NULL;
 			SetScale(_tcstol(pstrValue, &pstr, 10)); 
 
 		}
-		else CContainerUI::SetAttribute(pstrName, pstrValue);
+		else CContainerUI::SetAttributeById(nAttr, pstrName, pstrValue);
 	}
 
 	void CListHeaderItemUI::DoEvent(TEventUI& event)
@@ -2100,6 +2141,9 @@ namespace DuiLib {
 
 		m_bSelected = bSelect;
 		if( bSelect && m_pOwner != NULL ) m_pOwner->SelectMultiItem(m_iIndex);
+		// a virtual list keeps the selection by row, and a row can be unselected on its own
+		else if( !bSelect && m_pOwner != NULL && m_pOwner->GetListType() == LT_LIST
+			&& static_cast<CListUI*>(m_pOwner)->GetDataSource() != NULL ) m_pOwner->UnSelectItem(m_iIndex);
 		Invalidate();
 		return true;
 	}
@@ -2144,10 +2188,10 @@ namespace DuiLib {
 		if( m_pOwner != NULL ) m_pOwner->DoEvent(event); else CControlUI::DoEvent(event);
 	}
 
-	void CListElementUI::SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue)
+	void CListElementUI::SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue)
 	{
-		if( _tcsicmp(pstrName, _T("selected")) == 0 ) Select();
-		else CControlUI::SetAttribute(pstrName, pstrValue);
+		if( nAttr == DUIATTR_SELECTED ) Select();
+		else CControlUI::SetAttributeById(nAttr, pstrName, pstrValue);
 	}
 
 	void CListElementUI::DrawItemBk(HDC hDC, const RECT& rcItem)
@@ -2703,6 +2747,9 @@ namespace DuiLib {
 
 		m_bSelected = bSelect;
 		if( bSelect && m_pOwner != NULL ) m_pOwner->SelectMultiItem(m_iIndex);
+		// a virtual list keeps the selection by row, and a row can be unselected on its own
+		else if( !bSelect && m_pOwner != NULL && m_pOwner->GetListType() == LT_LIST
+			&& static_cast<CListUI*>(m_pOwner)->GetDataSource() != NULL ) m_pOwner->UnSelectItem(m_iIndex);
 		Invalidate();
 		return true;
 	}
@@ -2812,10 +2859,10 @@ namespace DuiLib {
 		if( m_pOwner != NULL ) m_pOwner->DoEvent(event); else CControlUI::DoEvent(event);
 	}
 
-	void CListContainerElementUI::SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue)
+	void CListContainerElementUI::SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue)
 	{
-		if( _tcsicmp(pstrName, _T("selected")) == 0 ) Select();
-		else CContainerUI::SetAttribute(pstrName, pstrValue);
+		if( nAttr == DUIATTR_SELECTED ) Select();
+		else CContainerUI::SetAttributeById(nAttr, pstrName, pstrValue);
 	}
 
 	void CListContainerElementUI::DoPaint(HDC hDC, const RECT& rcPaint)
@@ -49,6 +49,18 @@ namespace DuiLib {
 		virtual LPCTSTR GetItemText(CControlUI* pList, int iItem, int iSubItem) = 0;
 	};
 
+	// Rows of a list that has no control per row, see CListUI::SetDataSource. Only the rows
+	// in view get a control. CreateItem makes those as the view needs them, and BindItem
+	// fills one in for a row whenever it comes into view or ReloadItems is called.
+	class IListDataSourceUI
+	{
+	public:
+		virtual int GetItemCount(CControlUI* pList) = 0;
+		virtual int GetItemHeight(CControlUI* pList) = 0;
+		virtual CControlUI* CreateItem(CControlUI* pList) = 0;
+		virtual void BindItem(CControlUI* pList, CControlUI* pItem, int iIndex) = 0;
+	};
+
 	class IListOwnerUI
 	{
 	public:
@@ -105,6 +117,7 @@ namespace DuiLib {
 	class UILIB_API CListUI : public CVerticalLayoutUI, public IListUI
 	{
 		DECLARE_DUICONTROL(CListUI)
+		friend class CListBodyUI;
 
 	public:
 		CListUI();
@@ -201,11 +214,19 @@ namespace DuiLib {
 		void SetPos(RECT rc, bool bNeedInvalidate = true);
 		void Move(SIZE szOffset, bool bNeedInvalidate = true);
 		void DoEvent(TEventUI& event);
-		void SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue);
+		void SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue);
 
 		IListCallbackUI* GetTextCallback() const;
 		void SetTextCallback(IListCallbackUI* pCallback);
 
+		// Virtual mode: rows come from pDataSource and only the rows in view have controls.
+		// Items can't be added, removed or sorted then; call ReloadItems when the data changes.
+		IListDataSourceUI* GetDataSource() const;
+		void SetDataSource(IListDataSourceUI* pDataSource);
+		void ReloadItems();
+		bool IsItemSelected(int iIndex) const;
+		int FindSelectable(int iIndex, bool bForward = true) const;
+
 		SIZE GetScrollPos() const;
 		SIZE GetScrollRange() const;
 		void SetScrollPos(SIZE szPos, bool bMsg = true);
@@ -234,16 +255,21 @@ namespace DuiLib {
 	protected:
 		int GetMinSelItemIndex();
 		int GetMaxSelItemIndex();
+		void BindItem(CControlUI* pItem, int iIndex);
+		void UnbindItem(CControlUI* pItem);
+		void SyncItemSelection();
 
 	protected:
 		bool m_bFixedScrollbar;
 		bool m_bScrollSelect;
 		int m_iCurSel;
 		bool m_bMultiSel;
-		CStdPtrArray m_aSelItems;
+		CStdIndexSet m_aSelItems;	// row indices, in order
 		int m_iCurSelActivate;  // ˫
 		int m_iExpandedItem;
 		IListCallbackUI* m_pCallback;
+		IListDataSourceUI* m_pDataSource;
+		bool m_bSyncingItems;
 		CListBodyUI* m_pList;
 		CListHeaderUI* m_pHeader;
 		TListInfoUI m_ListInfo;
@@ -264,7 +290,14 @@ namespace DuiLib {
 		void SetPos(RECT rc, bool bNeedInvalidate = true);
 		void DoEvent(TEventUI& event);
 		BOOL SortItems(PULVCompareFunc pfnCompare, UINT_PTR dwData);
+
+		// virtual mode
+		CControlUI* GetVirtualItem(int iIndex) const;
+		RECT GetVirtualItemPos(int iIndex) const;
+		void ResetVirtualItems();
 	protected:
+		void SetVirtualPos(RECT rc, bool bNeedInvalidate);
+		int GetVirtualItemHeight() const;
 		static int __cdecl ItemComareFunc(void *pvlocale, const void *item1, const void *item2);
 		int __cdecl ItemComareFunc(const void *item1, const void *item2);
 	protected:
@@ -287,7 +320,7 @@ namespace DuiLib {
 
 		SIZE EstimateSize(SIZE szAvailable);
 		void SetPos(RECT rc, bool bNeedInvalidate = true);
-		void SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue);
+		void SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue);
 
 		void SetScaleHeader(bool bIsScale);
 		bool IsScaleHeader() const;
@@ -341,7 +374,7 @@ namespace DuiLib {
 
 		void DoEvent(TEventUI& event);
 		SIZE EstimateSize(SIZE szAvailable);
-		void SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue);
+		void SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue);
 		RECT GetThumbRect() const;
 
 		void PaintText(HDC hDC);
@@ -398,7 +431,7 @@ namespace DuiLib {
 		bool Activate();
 
 		void DoEvent(TEventUI& event);
-		void SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue);
+		void SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue);
 
 		void DrawItemBk(HDC hDC, const RECT& rcItem);
 
@@ -496,7 +529,7 @@ namespace DuiLib {
 		bool Activate();
 
 		void DoEvent(TEventUI& event);
-		void SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue);
+		void SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue);
 		void DoPaint(HDC hDC, const RECT& rcPaint);
 
 		virtual void DrawItemText(HDC hDC, const RECT& rcItem);    
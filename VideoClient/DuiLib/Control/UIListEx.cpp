@@ -512,11 +512,11 @@ namespace DuiLib {
 		Invalidate();
 	}
 
-	void CListContainerHeaderItemUI::SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue)
+	void CListContainerHeaderItemUI::SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue)
 	{
-		if( _tcsicmp(pstrName, _T("dragable")) == 0 ) SetDragable(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if( _tcsicmp(pstrName, _T("sepwidth")) == 0 ) SetSepWidth(_ttoi(pstrValue));
-		else if( _tcsicmp(pstrName, _T("align")) == 0 ) 
+		if( nAttr == DUIATTR_DRAGABLE ) SetDragable(_tcsicmp(pstrValue, _T("true")) == 0);
+		else if( nAttr == DUIATTR_SEPWIDTH ) SetSepWidth(_ttoi(pstrValue));
+		else if( nAttr == DUIATTR_ALIGN ) 
 		{
 			if( _tcsstr(pstrValue, _T("left")) != NULL ) {
 				m_uTextStyle &= ~(DT_CENTER | DT_RIGHT);
@@ -531,20 +531,20 @@ namespace DuiLib {
 				m_uTextStyle |= DT_RIGHT;
 			}
 		}
-		else if( _tcsicmp(pstrName, _T("endellipsis")) == 0 ) 
+		else if( nAttr == DUIATTR_ENDELLIPSIS ) 
 		{
 			if( _tcsicmp(pstrValue, _T("true")) == 0 ) m_uTextStyle |= DT_END_ELLIPSIS;
 			else m_uTextStyle &= ~DT_END_ELLIPSIS;
 		}    
-		else if( _tcsicmp(pstrName, _T("font")) == 0 ) SetFont(_ttoi(pstrValue));
-		else if( _tcsicmp(pstrName, _T("textcolor")) == 0 ) 
+		else if( nAttr == DUIATTR_FONT ) SetFont(_ttoi(pstrValue));
+		else if( nAttr == DUIATTR_TEXTCOLOR ) 
 		{
 			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
 			LPTSTR pstr = NULL;
 			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
 			SetTextColor(clrColor);
 		}
-		else if( _tcsicmp(pstrName, _T("textpadding")) == 0 ) 
+		else if( nAttr == DUIATTR_TEXTPADDING ) 
 		{
 			RECT rcTextPadding = { 0 };
 			LPTSTR pstr = NULL;
@@ -554,27 +554,27 @@ namespace DuiLib {
 			rcTextPadding.bottom = _tcstol(pstr + 1, &pstr, 10);
 			SetTextPadding(rcTextPadding);
 		}
-		else if( _tcsicmp(pstrName, _T("showhtml")) == 0 ) SetShowHtml(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if( _tcsicmp(pstrName, _T("normalimage")) == 0 ) SetNormalImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("hotimage")) == 0 ) SetHotImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("pushedimage")) == 0 ) SetPushedImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("focusedimage")) == 0 ) SetFocusedImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("sepimage")) == 0 ) SetSepImage(pstrValue);
-
-		else if( _tcsicmp(pstrName, _T("editable")) == 0 ) SetColumeEditable(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if( _tcsicmp(pstrName, _T("comboable")) == 0 ) SetColumeComboable(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if( _tcsicmp(pstrName, _T("checkable")) == 0 ) SetColumeCheckable(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if( _tcsicmp(pstrName, _T("checkboxwidth")) == 0 ) SetCheckBoxWidth(_ttoi(pstrValue));
-		else if( _tcsicmp(pstrName, _T("checkboxheight")) == 0 ) SetCheckBoxHeight(_ttoi(pstrValue));
-		else if( _tcsicmp(pstrName, _T("checkboxnormalimage")) == 0 ) SetCheckBoxNormalImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("checkboxhotimage")) == 0 ) SetCheckBoxHotImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("checkboxpushedimage")) == 0 ) SetCheckBoxPushedImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("checkboxfocusedimage")) == 0 ) SetCheckBoxFocusedImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("checkboxdisabledimage")) == 0 ) SetCheckBoxDisabledImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("checkboxselectedimage")) == 0 ) SetCheckBoxSelectedImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("checkboxforeimage")) == 0 ) SetCheckBoxForeImage(pstrValue);
-
-		else CContainerUI::SetAttribute(pstrName, pstrValue);
+		else if( nAttr == DUIATTR_SHOWHTML ) SetShowHtml(_tcsicmp(pstrValue, _T("true")) == 0);
+		else if( nAttr == DUIATTR_NORMALIMAGE ) SetNormalImage(pstrValue);
+		else if( nAttr == DUIATTR_HOTIMAGE ) SetHotImage(pstrValue);
+		else if( nAttr == DUIATTR_PUSHEDIMAGE ) SetPushedImage(pstrValue);
+		else if( nAttr == DUIATTR_FOCUSEDIMAGE ) SetFocusedImage(pstrValue);
+		else if( nAttr == DUIATTR_SEPIMAGE ) SetSepImage(pstrValue);
+
+		else if( nAttr == DUIATTR_EDITABLE ) SetColumeEditable(_tcsicmp(pstrValue, _T("true")) == 0);
+		else if( nAttr == DUIATTR_COMBOABLE ) SetColumeComboable(_tcsicmp(pstrValue, _T("true")) == 0);
+		else if( nAttr == DUIATTR_CHECKABLE ) SetColumeCheckable(_tcsicmp(pstrValue, _T("true")) == 0);
+		else if( nAttr == DUIATTR_CHECKBOXWIDTH ) SetCheckBoxWidth(_ttoi(pstrValue));
+		else if( nAttr == DUIATTR_CHECKBOXHEIGHT ) SetCheckBoxHeight(_ttoi(pstrValue));
+		else if( nAttr == DUIATTR_CHECKBOXNORMALIMAGE ) SetCheckBoxNormalImage(pstrValue);
+		else if( nAttr == DUIATTR_CHECKBOXHOTIMAGE ) SetCheckBoxHotImage(pstrValue);
+		else if( nAttr == DUIATTR_CHECKBOXPUSHEDIMAGE ) SetCheckBoxPushedImage(pstrValue);
+		else if( nAttr == DUIATTR_CHECKBOXFOCUSEDIMAGE ) SetCheckBoxFocusedImage(pstrValue);
+		else if( nAttr == DUIATTR_CHECKBOXDISABLEDIMAGE ) SetCheckBoxDisabledImage(pstrValue);
+		else if( nAttr == DUIATTR_CHECKBOXSELECTEDIMAGE ) SetCheckBoxSelectedImage(pstrValue);
+		else if( nAttr == DUIATTR_CHECKBOXFOREIMAGE ) SetCheckBoxForeImage(pstrValue);
+
+		else CContainerUI::SetAttributeById(nAttr, pstrName, pstrValue);
 	}
 
 	void CListContainerHeaderItemUI::DoEvent(TEventUI& event)
@@ -1374,18 +1374,18 @@ Label_ForeImage:
 	{
 		return CRenderEngine::DrawImageString(hDC, m_pManager, rcCheckBox, m_rcPaint, pStrImage, pStrModify);
 	}
-	void CListTextExtElementUI::SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue)
-	{
-		if( _tcsicmp(pstrName, _T("checkboxwidth")) == 0 ) SetCheckBoxWidth(_ttoi(pstrValue));
-		else if( _tcsicmp(pstrName, _T("checkboxheight")) == 0 ) SetCheckBoxHeight(_ttoi(pstrValue));
-		else if( _tcsicmp(pstrName, _T("checkboxnormalimage")) == 0 ) SetCheckBoxNormalImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("checkboxhotimage")) == 0 ) SetCheckBoxHotImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("checkboxpushedimage")) == 0 ) SetCheckBoxPushedImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("checkboxfocusedimage")) == 0 ) SetCheckBoxFocusedImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("checkboxdisabledimage")) == 0 ) SetCheckBoxDisabledImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("checkboxselectedimage")) == 0 ) SetCheckBoxSelectedImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("checkboxforeimage")) == 0 ) SetCheckBoxForeImage(pstrValue);
-		else CListLabelElementUI::SetAttribute(pstrName, pstrValue);
+	void CListTextExtElementUI::SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue)
+	{
+		if( nAttr == DUIATTR_CHECKBOXWIDTH ) SetCheckBoxWidth(_ttoi(pstrValue));
+		else if( nAttr == DUIATTR_CHECKBOXHEIGHT ) SetCheckBoxHeight(_ttoi(pstrValue));
+		else if( nAttr == DUIATTR_CHECKBOXNORMALIMAGE ) SetCheckBoxNormalImage(pstrValue);
+		else if( nAttr == DUIATTR_CHECKBOXHOTIMAGE ) SetCheckBoxHotImage(pstrValue);
+		else if( nAttr == DUIATTR_CHECKBOXPUSHEDIMAGE ) SetCheckBoxPushedImage(pstrValue);
+		else if( nAttr == DUIATTR_CHECKBOXFOCUSEDIMAGE ) SetCheckBoxFocusedImage(pstrValue);
+		else if( nAttr == DUIATTR_CHECKBOXDISABLEDIMAGE ) SetCheckBoxDisabledImage(pstrValue);
+		else if( nAttr == DUIATTR_CHECKBOXSELECTEDIMAGE ) SetCheckBoxSelectedImage(pstrValue);
+		else if( nAttr == DUIATTR_CHECKBOXFOREIMAGE ) SetCheckBoxForeImage(pstrValue);
+		else CListLabelElementUI::SetAttributeById(nAttr, pstrName, pstrValue);
 	}
 	LPCTSTR CListTextExtElementUI::GetCheckBoxNormalImage()
 	{
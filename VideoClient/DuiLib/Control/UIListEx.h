@@ -111,7 +111,7 @@ namespace DuiLib {
 
 		void DoEvent(TEventUI& event);
 		SIZE EstimateSize(SIZE szAvailable);
-		void SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue);
+		void SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue);
 		RECT GetThumbRect() const;
 
 		void PaintText(HDC hDC);
@@ -259,7 +259,7 @@ namespace DuiLib {
 
 	public:
 		virtual void DoPaint(HDC hDC, const RECT& rcPaint);
-		virtual void SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue);
+		virtual void SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue);
 		virtual void PaintStatusImage(HDC hDC);
 		BOOL DrawCheckBoxImage(HDC hDC, LPCTSTR pStrImage, LPCTSTR pStrModify, RECT& rcCheckBox);
 		LPCTSTR GetCheckBoxNormalImage();
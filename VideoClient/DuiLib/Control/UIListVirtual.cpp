@@ -0,0 +1,205 @@
+#include "StdAfx.h"
+
+namespace DuiLib {
+
+	/////////////////////////////////////////////////////////////////////////////////////
+	// The virtual mode of CListUI (SetDataSource): the rows come from the data source and only
+	// the rows in view have a control. Kept apart from UIList.cpp so DuiLibTests can build it.
+
+	bool CListUI::IsItemSelected(int iIndex) const
+	{
+		return m_aSelItems.Find(iIndex);
+	}
+
+	IListDataSourceUI* CListUI::GetDataSource() const
+	{
+		return m_pDataSource;
+	}
+
+	void CListUI::SetDataSource(IListDataSourceUI* pDataSource)
+	{
+		if( m_pDataSource == pDataSource ) return;
+		m_pList->RemoveAll();
+		m_aSelItems.Empty();
+		m_iCurSel = -1;
+		m_iExpandedItem = -1;
+		m_pDataSource = pDataSource;
+		NeedUpdate();
+	}
+
+	void CListUI::ReloadItems()
+	{
+		if( m_pDataSource == NULL ) return;
+		// rows that are gone can't stay selected
+		int nCount = GetCount();
+		m_aSelItems.RemoveFrom(nCount);
+		if( m_iCurSel >= nCount ) m_iCurSel = -1;
+		if( m_iExpandedItem >= nCount ) m_iExpandedItem = -1;
+		m_pList->ResetVirtualItems();
+	}
+
+	int CListUI::FindSelectable(int iIndex, bool bForward) const
+	{
+		if( m_pDataSource == NULL ) return CVerticalLayoutUI::FindSelectable(iIndex, bForward);
+		// a row needn't have a control to be selected
+		int nCount = GetCount();
+		if( nCount == 0 ) return -1;
+		return CLAMP(iIndex, 0, nCount - 1);
+	}
+
+	void CListUI::BindItem(CControlUI* pItem, int iIndex)
+	{
+		IListItemUI* pListItem = static_cast<IListItemUI*>(pItem->GetInterface(_T("ListItem")));
+		m_bSyncingItems = true;
+		pItem->SetVisible(true);
+		if( pListItem != NULL ) {
+			pListItem->SetIndex(iIndex);
+			pListItem->SelectMulti(IsItemSelected(iIndex));
+		}
+		m_bSyncingItems = false;
+		m_pDataSource->BindItem(this, pItem, iIndex);
+	}
+
+	void CListUI::UnbindItem(CControlUI* pItem)
+	{
+		IListItemUI* pListItem = static_cast<IListItemUI*>(pItem->GetInterface(_T("ListItem")));
+		m_bSyncingItems = true;
+		if( pListItem != NULL ) {
+			pListItem->SelectMulti(false);
+			pListItem->SetIndex(-1);
+		}
+		pItem->SetVisible(false);
+		m_bSyncingItems = false;
+	}
+
+	void CListUI::SyncItemSelection()
+	{
+		// the rows in view show what the selection says, without calling back into it
+		m_bSyncingItems = true;
+		for( int it = 0; it < m_pList->GetCount(); it++ ) {
+			IListItemUI* pListItem = static_cast<IListItemUI*>(m_pList->GetItemAt(it)->GetInterface(_T("ListItem")));
+			if( pListItem == NULL || pListItem->GetIndex() < 0 ) continue;
+			pListItem->SelectMulti(IsItemSelected(pListItem->GetIndex()));
+		}
+		m_bSyncingItems = false;
+	}
+
+	void CListBodyUI::SetVirtualPos(RECT rc, bool bNeedInvalidate)
+	{
+		CControlUI::SetPos(rc, bNeedInvalidate);
+		rc = m_rcItem;
+
+		// Adjust for inset
+		rc.left += m_rcInset.left;
+		rc.top += m_rcInset.top;
+		rc.right -= m_rcInset.right;
+		rc.bottom -= m_rcInset.bottom;
+		if(m_pOwner->IsFixedScrollbar() && m_pVerticalScrollBar) rc.right -= m_pVerticalScrollBar->GetFixedWidth();
+		else if( m_pVerticalScrollBar && m_pVerticalScrollBar->IsVisible() ) rc.right -= m_pVerticalScrollBar->GetFixedWidth();
+		if( m_pHorizontalScrollBar && m_pHorizontalScrollBar->IsVisible() ) rc.bottom -= m_pHorizontalScrollBar->GetFixedHeight();
+
+		SIZE szAvailable = { rc.right - rc.left, rc.bottom - rc.top };
+		if( m_pHorizontalScrollBar && m_pHorizontalScrollBar->IsVisible() ) 
+			szAvailable.cx += m_pHorizontalScrollBar->GetScrollRange();
+
+		int cxNeeded = 0;
+		CListHeaderUI* pHeader = m_pOwner->GetHeader();
+		if( pHeader != NULL && pHeader->GetCount() > 0 ) {
+			cxNeeded = MAX(0, pHeader->EstimateSize(CDuiSize(rc.right - rc.left, rc.bottom - rc.top)).cx);
+			if ( m_pHorizontalScrollBar && m_pHorizontalScrollBar->IsVisible())
+			{
+				int nOffset = m_pHorizontalScrollBar->GetScrollPos();
+				RECT rcHeader = pHeader->GetPos();
+				rcHeader.left = rc.left - nOffset;
+				pHeader->SetPos(rcHeader);
+			}
+		}
+
+		// Only the rows in view have a control. Row iIndex always gets control iIndex % nPool,
+		// so a row that stays in view keeps its control, and its binding, while the list scrolls.
+		IListDataSourceUI* pDataSource = m_pOwner->GetDataSource();
+		int nCount = MAX(0, pDataSource->GetItemCount(m_pOwner));
+		int cyItem = GetVirtualItemHeight();
+		int cyStep = MAX(1, cyItem + m_iChildPadding);
+		int iScrollPos = 0;
+		if( m_pVerticalScrollBar && m_pVerticalScrollBar->IsVisible() ) iScrollPos = m_pVerticalScrollBar->GetScrollPos();
+		int iFirst = MIN(iScrollPos / cyStep, nCount);
+		int nRows = MIN((rc.bottom - rc.top) / cyStep + 2, nCount - iFirst);
+		while( m_items.GetSize() < nRows ) {
+			CControlUI* pItem = pDataSource->CreateItem(m_pOwner);
+			if( pItem == NULL ) break;
+			IListItemUI* pListItem = static_cast<IListItemUI*>(pItem->GetInterface(_T("ListItem")));
+			if( pListItem != NULL ) {
+				pListItem->SetOwner(m_pOwner);
+				pListItem->SetIndex(-1);
+			}
+			Add(pItem);
+		}
+		int nPool = m_items.GetSize();
+		nRows = MIN(nRows, nPool);
+
+		int iPosX = rc.left;
+		if( m_pHorizontalScrollBar && m_pHorizontalScrollBar->IsVisible() ) {
+			iPosX -= m_pHorizontalScrollBar->GetScrollPos();
+		}
+		int cxItem = MAX(cxNeeded, szAvailable.cx);
+		for( int it = 0; it < nPool; it++ ) {
+			CControlUI* pItem = static_cast<CControlUI*>(m_items[it]);
+			int iIndex = iFirst + (it - iFirst % nPool + nPool) % nPool;
+			if( iIndex >= iFirst + nRows ) {
+				m_pOwner->UnbindItem(pItem);
+				continue;
+			}
+			IListItemUI* pListItem = static_cast<IListItemUI*>(pItem->GetInterface(_T("ListItem")));
+			if( pListItem == NULL || pListItem->GetIndex() != iIndex || !pItem->IsVisible() ) m_pOwner->BindItem(pItem, iIndex);
+
+			RECT rcPadding = pItem->GetPadding();
+			int iPosY = rc.top + iIndex * cyStep - iScrollPos;
+			RECT rcCtrl = { iPosX + rcPadding.left, iPosY + rcPadding.top, iPosX + cxItem - rcPadding.right, iPosY + cyItem - rcPadding.bottom };
+			SetItemPos(pItem, rcCtrl, true);
+		}
+
+		// Process the scrollbar
+		int cyNeeded = nCount > 0 ? nCount * cyStep - m_iChildPadding : 0;
+		ProcessScrollBar(rc, cxNeeded, cyNeeded);
+	}
+
+	int CListBodyUI::GetVirtualItemHeight() const
+	{
+		int cyItem = m_pOwner->GetDataSource()->GetItemHeight(m_pOwner);
+		if( m_pManager != NULL ) cyItem = m_pManager->GetDPIObj()->Scale(cyItem);
+		return cyItem;
+	}
+
+	CControlUI* CListBodyUI::GetVirtualItem(int iIndex) const
+	{
+		if( iIndex < 0 ) return NULL;
+		for( int it = 0; it < m_items.GetSize(); it++ ) {
+			CControlUI* pItem = static_cast<CControlUI*>(m_items[it]);
+			IListItemUI* pListItem = static_cast<IListItemUI*>(pItem->GetInterface(_T("ListItem")));
+			if( pListItem != NULL && pListItem->GetIndex() == iIndex ) return pItem;
+		}
+		return NULL;
+	}
+
+	RECT CListBodyUI::GetVirtualItemPos(int iIndex) const
+	{
+		// where SetVirtualPos puts the row, whether it has a control now or not
+		int cyItem = GetVirtualItemHeight();
+		int iPosY = m_rcItem.top + m_rcInset.top + iIndex * MAX(1, cyItem + m_iChildPadding);
+		if( m_pVerticalScrollBar && m_pVerticalScrollBar->IsVisible() ) iPosY -= m_pVerticalScrollBar->GetScrollPos();
+		RECT rcItem = { m_rcItem.left + m_rcInset.left, iPosY, m_rcItem.right - m_rcInset.right, iPosY + cyItem };
+		return rcItem;
+	}
+
+	void CListBodyUI::ResetVirtualItems()
+	{
+		// every row in view is bound again by the next SetPos
+		for( int it = 0; it < m_items.GetSize(); it++ ) {
+			IListItemUI* pListItem = static_cast<IListItemUI*>(static_cast<CControlUI*>(m_items[it])->GetInterface(_T("ListItem")));
+			if( pListItem != NULL ) pListItem->SetIndex(-1);
+		}
+		NeedUpdate();
+	}
+
+} // namespace DuiLib
@@ -123,9 +123,9 @@ namespace DuiLib {
 		return CDuiSize(cxFixed, cyFixed);
 	}
 
-	void CMenuUI::SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue)
+	void CMenuUI::SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue)
 	{
-		CListUI::SetAttribute(pstrName, pstrValue);
+		CListUI::SetAttributeById(nAttr, pstrName, pstrValue);
 	}
 
 	/////////////////////////////////////////////////////////////////////////////////////
@@ -1076,22 +1076,22 @@ namespace DuiLib {
 		m_bShowExplandIcon = bShow;
 	}
 
-	void CMenuElementUI::SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue)
+	void CMenuElementUI::SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue)
 	{
-		if( _tcsicmp(pstrName, _T("icon")) == 0){
+		if( nAttr == DUIATTR_ICON){
 			SetIcon(pstrValue);
 		}
-		else if( _tcsicmp(pstrName, _T("iconsize")) == 0 ) {
+		else if( nAttr == DUIATTR_ICONSIZE ) {
 			LPTSTR pstr = NULL;
 			LONG cx = 0, cy = 0;
 			cx = _tcstol(pstrValue, &pstr, 10);  ASSERT(pstr);    
 			cy = _tcstol(pstr + 1, &pstr, 10);    ASSERT(pstr);   
 			SetIconSize(cx, cy);
 		}
-		else if( _tcsicmp(pstrName, _T("checkitem")) == 0 ) {		
+		else if( nAttr == DUIATTR_CHECKITEM ) {		
 			SetCheckItem(_tcsicmp(pstrValue, _T("true")) == 0 ? true : false);		
 		}
-		else if( _tcsicmp(pstrName, _T("ischeck")) == 0 ) {		
+		else if( nAttr == DUIATTR_ISCHECK ) {		
 			CStdStringPtrMap* mCheckInfos = CMenuWnd::GetGlobalContextMenuObserver().GetMenuCheckInfo();
 			if (mCheckInfos != NULL)
 			{
@@ -1106,19 +1106,19 @@ namespace DuiLib {
 				if(!bFind) SetChecked(_tcsicmp(pstrValue, _T("true")) == 0 ? true : false);
 			}
 		}	
-		else if( _tcsicmp(pstrName, _T("linetype")) == 0){
+		else if( nAttr == DUIATTR_LINETYPE){
 			if (_tcsicmp(pstrValue, _T("true")) == 0)
 				SetLineType();
 		}
-		else if( _tcsicmp(pstrName, _T("expland")) == 0 ) {
+		else if( nAttr == DUIATTR_EXPLAND ) {
 			SetShowExplandIcon(_tcsicmp(pstrValue, _T("true")) == 0 ? true : false);
 		}
-		else if( _tcsicmp(pstrName, _T("linecolor")) == 0){
+		else if( nAttr == DUIATTR_LINECOLOR){
 			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
 			LPTSTR pstr = NULL;
 			SetLineColor(_tcstoul(pstrValue, &pstr, 16));
 		}
-		else if( _tcsicmp(pstrName, _T("linepadding")) == 0 ) {
+		else if( nAttr == DUIATTR_LINEPADDING ) {
 			RECT rcInset = { 0 };
 			LPTSTR pstr = NULL;
 			rcInset.left = _tcstol(pstrValue, &pstr, 10);  ASSERT(pstr);    
@@ -1127,11 +1127,11 @@ namespace DuiLib {
 			rcInset.bottom = _tcstol(pstr + 1, &pstr, 10); ASSERT(pstr);    
 			SetLinePadding(rcInset);
 		}
-		else if	( _tcsicmp(pstrName, _T("height")) == 0){
+		else if	( nAttr == DUIATTR_HEIGHT){
 			SetFixedHeight(_ttoi(pstrValue));
 		}
 		else
-			CListContainerElementUI::SetAttribute(pstrName, pstrValue);
+			CListContainerElementUI::SetAttributeById(nAttr, pstrName, pstrValue);
 	}
 
 
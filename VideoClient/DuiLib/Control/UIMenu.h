@@ -265,7 +265,7 @@ public:
 
 	SIZE EstimateSize(SIZE szAvailable) override;
 
-	void SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue) ;
+	void SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue) ;
 };
 
 /////////////////////////////////////////////////////////////////////////////////////
@@ -371,7 +371,7 @@ public:
 	void SetShowExplandIcon(bool bShow);
 	void DrawItemExpland(HDC hDC, const RECT& rcItem);
 
-	void SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue);
+	void SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue);
 
 	MenuItemInfo* GetItemInfo(LPCTSTR pstrName);
 	MenuItemInfo* SetItemInfo(LPCTSTR pstrName, bool bChecked);
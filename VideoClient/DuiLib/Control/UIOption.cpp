@@ -198,29 +198,29 @@ namespace DuiLib
 		Invalidate();
 	}
 
-	void COptionUI::SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue)
-	{
-		if( _tcsicmp(pstrName, _T("group")) == 0 ) SetGroup(pstrValue);
-		else if( _tcsicmp(pstrName, _T("selected")) == 0 ) Selected(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if( _tcsicmp(pstrName, _T("selectedimage")) == 0 ) SetSelectedImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("selectedhotimage")) == 0 ) SetSelectedHotImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("selectedpushedimage")) == 0 ) SetSelectedPushedImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("selectedforeimage")) == 0 ) SetSelectedForedImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("selectedstateimage")) == 0 ) SetSelectedStateImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("selectedstatecount")) == 0 ) SetSelectedStateCount(_ttoi(pstrValue));
-		else if( _tcsicmp(pstrName, _T("selectedbkcolor")) == 0 ) {
+	void COptionUI::SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue)
+	{
+		if( nAttr == DUIATTR_GROUP ) SetGroup(pstrValue);
+		else if( nAttr == DUIATTR_SELECTED ) Selected(_tcsicmp(pstrValue, _T("true")) == 0);
+		else if( nAttr == DUIATTR_SELECTEDIMAGE ) SetSelectedImage(pstrValue);
+		else if( nAttr == DUIATTR_SELECTEDHOTIMAGE ) SetSelectedHotImage(pstrValue);
+		else if( nAttr == DUIATTR_SELECTEDPUSHEDIMAGE ) SetSelectedPushedImage(pstrValue);
+		else if( nAttr == DUIATTR_SELECTEDFOREIMAGE ) SetSelectedForedImage(pstrValue);
+		else if( nAttr == DUIATTR_SELECTEDSTATEIMAGE ) SetSelectedStateImage(pstrValue);
+		else if( nAttr == DUIATTR_SELECTEDSTATECOUNT ) SetSelectedStateCount(_ttoi(pstrValue));
+		else if( nAttr == DUIATTR_SELECTEDBKCOLOR ) {
 			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
 			LPTSTR pstr = NULL;
 			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
 			SetSelectedBkColor(clrColor);
 		}
-		else if( _tcsicmp(pstrName, _T("selectedtextcolor")) == 0 ) {
+		else if( nAttr == DUIATTR_SELECTEDTEXTCOLOR ) {
 			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
 			LPTSTR pstr = NULL;
 			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
 			SetSelectedTextColor(clrColor);
 		}
-		else CButtonUI::SetAttribute(pstrName, pstrValue);
+		else CButtonUI::SetAttributeById(nAttr, pstrName, pstrValue);
 	}
 
 	void COptionUI::PaintBkColor(HDC hDC)
@@ -369,11 +369,11 @@ namespace DuiLib
 	{
 
 	}
-	void CCheckBoxUI::SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue)
+	void CCheckBoxUI::SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue)
 	{
-		if( _tcsicmp(pstrName, _T("EnableAutoCheck")) == 0 ) SetAutoCheck(_tcsicmp(pstrValue, _T("true")) == 0);
+		if( nAttr == DUIATTR_ENABLEAUTOCHECK ) SetAutoCheck(_tcsicmp(pstrValue, _T("true")) == 0);
 		
-		COptionUI::SetAttribute(pstrName, pstrValue);
+		COptionUI::SetAttributeById(nAttr, pstrName, pstrValue);
 	}
 	void CCheckBoxUI::SetAutoCheck(bool bEnable)
 	{
@@ -48,7 +48,7 @@ namespace DuiLib
 		bool IsSelected() const;
 		virtual void Selected(bool bSelected);
 
-		void SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue);
+		void SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue);
 
 		void PaintBkColor(HDC hDC);
 		void PaintStatusImage(HDC hDC);
@@ -86,7 +86,7 @@ namespace DuiLib
 
 	public:
 		CCheckBoxUI();
-		virtual void SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue);
+		virtual void SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue);
 		void SetAutoCheck(bool bEnable);
 		virtual void DoEvent(TEventUI& event);
 		virtual void Selected(bool bSelected);
@@ -84,14 +84,14 @@ namespace DuiLib
 		UpdateText();
 	}
 
-	void CProgressUI::SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue)
-	{
-		if( _tcsicmp(pstrName, _T("hor")) == 0 ) SetHorizontal(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if( _tcsicmp(pstrName, _T("min")) == 0 ) SetMinValue(_ttoi(pstrValue));
-		else if( _tcsicmp(pstrName, _T("max")) == 0 ) SetMaxValue(_ttoi(pstrValue));
-		else if( _tcsicmp(pstrName, _T("value")) == 0 ) SetValue(_ttoi(pstrValue));
-		else if( _tcsicmp(pstrName, _T("isstretchfore"))==0) SetStretchForeImage(_tcsicmp(pstrValue, _T("true")) == 0? true : false);
-		else CLabelUI::SetAttribute(pstrName, pstrValue);
+	void CProgressUI::SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue)
+	{
+		if( nAttr == DUIATTR_HOR ) SetHorizontal(_tcsicmp(pstrValue, _T("true")) == 0);
+		else if( nAttr == DUIATTR_MIN ) SetMinValue(_ttoi(pstrValue));
+		else if( nAttr == DUIATTR_MAX ) SetMaxValue(_ttoi(pstrValue));
+		else if( nAttr == DUIATTR_VALUE ) SetValue(_ttoi(pstrValue));
+		else if( nAttr == DUIATTR_ISSTRETCHFORE) SetStretchForeImage(_tcsicmp(pstrValue, _T("true")) == 0? true : false);
+		else CLabelUI::SetAttributeById(nAttr, pstrName, pstrValue);
 	}
 
 	void CProgressUI::PaintForeColor(HDC hDC)
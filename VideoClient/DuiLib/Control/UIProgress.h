@@ -26,7 +26,7 @@ namespace DuiLib
 		void SetMaxValue(int nMax);
 		int GetValue() const;
 		void SetValue(int nValue);
-		void SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue);
+		void SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue);
 		void PaintForeColor(HDC hDC);
 		void PaintForeImage(HDC hDC);
 		virtual void UpdateText();
@@ -2397,44 +2397,44 @@ void CRichEditUI::DoPaint(HDC hDC, const RECT& rcPaint)
 	}
 }
 
-void CRichEditUI::SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue)
+void CRichEditUI::SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue)
 {
-    if( _tcsicmp(pstrName, _T("vscrollbar")) == 0 ) {
+    if( nAttr == DUIATTR_VSCROLLBAR ) {
         if( _tcsicmp(pstrValue, _T("true")) == 0 ) m_lTwhStyle |= ES_DISABLENOSCROLL | WS_VSCROLL;
     }
-    else if( _tcsicmp(pstrName, _T("autovscroll")) == 0 ) {
+    else if( nAttr == DUIATTR_AUTOVSCROLL ) {
         if( _tcsicmp(pstrValue, _T("true")) == 0 ) m_lTwhStyle |= ES_AUTOVSCROLL;
     }
-    else if( _tcsicmp(pstrName, _T("hscrollbar")) == 0 ) {
+    else if( nAttr == DUIATTR_HSCROLLBAR ) {
         if( _tcsicmp(pstrValue, _T("true")) == 0 ) m_lTwhStyle |= ES_DISABLENOSCROLL | WS_HSCROLL;
     }
-    else if( _tcsicmp(pstrName, _T("autohscroll")) == 0 ) {
+    else if( nAttr == DUIATTR_AUTOHSCROLL ) {
         if( _tcsicmp(pstrValue, _T("true")) == 0 ) m_lTwhStyle |= ES_AUTOHSCROLL;
     }
-    else if( _tcsicmp(pstrName, _T("wanttab")) == 0 ) {
+    else if( nAttr == DUIATTR_WANTTAB ) {
         SetWantTab(_tcsicmp(pstrValue, _T("true")) == 0);
     }
-    else if( _tcsicmp(pstrName, _T("wantreturn")) == 0 ) {
+    else if( nAttr == DUIATTR_WANTRETURN ) {
         SetWantReturn(_tcsicmp(pstrValue, _T("true")) == 0);
     }
-    else if( _tcsicmp(pstrName, _T("wantctrlreturn")) == 0 ) {
+    else if( nAttr == DUIATTR_WANTCTRLRETURN ) {
         SetWantCtrlReturn(_tcsicmp(pstrValue, _T("true")) == 0);
     }
-    else if( _tcsicmp(pstrName, _T("rich")) == 0 ) {
+    else if( nAttr == DUIATTR_RICH ) {
         SetRich(_tcsicmp(pstrValue, _T("true")) == 0);
     }
-    else if( _tcsicmp(pstrName, _T("multiline")) == 0 ) {
+    else if( nAttr == DUIATTR_MULTILINE ) {
         if( _tcsicmp(pstrValue, _T("false")) == 0 ) m_lTwhStyle &= ~ES_MULTILINE;
     }
-    else if( _tcsicmp(pstrName, _T("readonly")) == 0 ) {
+    else if( nAttr == DUIATTR_READONLY ) {
         if( _tcsicmp(pstrValue, _T("true")) == 0 ) { m_lTwhStyle |= ES_READONLY; m_bReadOnly = true; }
     }
-    else if( _tcsicmp(pstrName, _T("password")) == 0 ) {
+    else if( nAttr == DUIATTR_PASSWORD ) {
         if( _tcsicmp(pstrValue, _T("true")) == 0 ) {
 			m_lTwhStyle |= ES_PASSWORD;
 		}
     }
-    else if( _tcsicmp(pstrName, _T("align")) == 0 ) {
+    else if( nAttr == DUIATTR_ALIGN ) {
         if( _tcsstr(pstrValue, _T("left")) != NULL ) {
             m_lTwhStyle &= ~(ES_CENTER | ES_RIGHT);
             m_lTwhStyle |= ES_LEFT;
@@ -2448,20 +2448,20 @@ void CRichEditUI::SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue)
             m_lTwhStyle |= ES_RIGHT;
         }
     }
-    else if( _tcsicmp(pstrName, _T("font")) == 0 ) SetFont(_ttoi(pstrValue));
-    else if( _tcsicmp(pstrName, _T("textcolor")) == 0 ) {
+    else if( nAttr == DUIATTR_FONT ) SetFont(_ttoi(pstrValue));
+    else if( nAttr == DUIATTR_TEXTCOLOR ) {
         while( *pstrValue > _T('\0') && *pstrValue <= _T(' ') ) pstrValue = ::CharNext(pstrValue);
         if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
         LPTSTR pstr = NULL;
         DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
         SetTextColor(clrColor);
     }
-	else if( _tcsicmp(pstrName, _T("maxchar")) == 0 ) SetLimitText(_ttoi(pstrValue));
-	else if( _tcsicmp(pstrName, _T("normalimage")) == 0 ) SetNormalImage(pstrValue);
-	else if( _tcsicmp(pstrName, _T("hotimage")) == 0 ) SetHotImage(pstrValue);
-	else if( _tcsicmp(pstrName, _T("focusedimage")) == 0 ) SetFocusedImage(pstrValue);
-	else if( _tcsicmp(pstrName, _T("disabledimage")) == 0 ) SetDisabledImage(pstrValue);
-	else if( _tcsicmp(pstrName, _T("textpadding")) == 0 ) {
+	else if( nAttr == DUIATTR_MAXCHAR ) SetLimitText(_ttoi(pstrValue));
+	else if( nAttr == DUIATTR_NORMALIMAGE ) SetNormalImage(pstrValue);
+	else if( nAttr == DUIATTR_HOTIMAGE ) SetHotImage(pstrValue);
+	else if( nAttr == DUIATTR_FOCUSEDIMAGE ) SetFocusedImage(pstrValue);
+	else if( nAttr == DUIATTR_DISABLEDIMAGE ) SetDisabledImage(pstrValue);
+	else if( nAttr == DUIATTR_TEXTPADDING ) {
 		RECT rcTextPadding = { 0 };
 		LPTSTR pstr = NULL;
 		rcTextPadding.left = _tcstol(pstrValue, &pstr, 10);  ASSERT(pstr);    
@@ -2470,9 +2470,9 @@ void CRichEditUI::SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue)
 		rcTextPadding.bottom = _tcstol(pstr + 1, &pstr, 10); ASSERT(pstr);    
 		SetTextPadding(rcTextPadding);
 	}
-	else if( _tcsicmp(pstrName, _T("tipvalue")) == 0 ) SetTipValue(pstrValue);
-	else if( _tcsicmp(pstrName, _T("tipvaluecolor")) == 0 ) SetTipValueColor(pstrValue);
-	else if( _tcsicmp(pstrName, _T("tipvaluealign")) == 0 ) {
+	else if( nAttr == DUIATTR_TIPVALUE ) SetTipValue(pstrValue);
+	else if( nAttr == DUIATTR_TIPVALUECOLOR ) SetTipValueColor(pstrValue);
+	else if( nAttr == DUIATTR_TIPVALUEALIGN ) {
         if( _tcsstr(pstrValue, _T("left")) != NULL ) {
             m_uTipValueAlign = DT_SINGLELINE | DT_LEFT;
         }
@@ -2483,7 +2483,7 @@ void CRichEditUI::SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue)
            m_uTipValueAlign = DT_SINGLELINE | DT_RIGHT;
         }
     }
-    else CContainerUI::SetAttribute(pstrName, pstrValue);
+    else CContainerUI::SetAttributeById(nAttr, pstrName, pstrValue);
 }
 
 LRESULT CRichEditUI::MessageHandler(UINT uMsg, WPARAM wParam, LPARAM lParam, bool& bHandled)
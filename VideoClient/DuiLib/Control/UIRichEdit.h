@@ -150,7 +150,7 @@ namespace DuiLib {
 		void SetTipValueAlign(UINT uAlign);
 		UINT GetTipValueAlign();
 
-		void SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue);
+		void SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue);
 
 		LRESULT MessageHandler(UINT uMsg, WPARAM wParam, LPARAM lParam, bool& bHandled);
 
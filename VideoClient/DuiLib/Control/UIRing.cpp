@@ -27,10 +27,10 @@ namespace DuiLib
 		return CLabelUI::GetInterface(pstrName);
 	}
 
-	void CRingUI::SetAttribute( LPCTSTR pstrName, LPCTSTR pstrValue )
+	void CRingUI::SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue)
 	{
-		if( _tcscmp(pstrName, _T("bkimage")) == 0 ) SetBkImage(pstrValue);
-		else CLabelUI::SetAttribute(pstrName, pstrValue);
+		if( nAttr == DUIATTR_BKIMAGE ) SetBkImage(pstrValue);
+		else CLabelUI::SetAttributeById(nAttr, pstrName, pstrValue);
 	}
 
 	void CRingUI::SetBkImage( LPCTSTR pStrImage )
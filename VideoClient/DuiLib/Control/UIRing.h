@@ -18,7 +18,7 @@ namespace DuiLib
 
 		LPCTSTR GetClass() const;
 		LPVOID GetInterface(LPCTSTR pstrName);
-		void SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue);
+		void SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue);
 		void SetBkImage(LPCTSTR pStrImage);	
 		virtual void DoEvent(TEventUI& event);
 		virtual void PaintBkImage(HDC hDC);	
@@ -44,7 +44,7 @@ namespace DuiLib
 		bool v = IsVisible();
 		m_bVisible = bVisible;
 		if( m_bFocused ) m_bFocused = false;
-
+		if( m_pManager != NULL ) m_pManager->NeedHitTestUpdate();
 	}
 
 	void CScrollBarUI::SetEnabled(bool bEnable)
@@ -747,35 +747,35 @@ namespace DuiLib
 		if( m_pOwner != NULL ) m_pOwner->DoEvent(event); else CControlUI::DoEvent(event);
 	}
 
-	void CScrollBarUI::SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue)
-	{
-		if( _tcsicmp(pstrName, _T("button1normalimage")) == 0 ) SetButton1NormalImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("button1hotimage")) == 0 ) SetButton1HotImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("button1pushedimage")) == 0 ) SetButton1PushedImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("button1disabledimage")) == 0 ) SetButton1DisabledImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("button2normalimage")) == 0 ) SetButton2NormalImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("button2hotimage")) == 0 ) SetButton2HotImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("button2pushedimage")) == 0 ) SetButton2PushedImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("button2disabledimage")) == 0 ) SetButton2DisabledImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("thumbnormalimage")) == 0 ) SetThumbNormalImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("thumbhotimage")) == 0 ) SetThumbHotImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("thumbpushedimage")) == 0 ) SetThumbPushedImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("thumbdisabledimage")) == 0 ) SetThumbDisabledImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("railnormalimage")) == 0 ) SetRailNormalImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("railhotimage")) == 0 ) SetRailHotImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("railpushedimage")) == 0 ) SetRailPushedImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("raildisabledimage")) == 0 ) SetRailDisabledImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("bknormalimage")) == 0 ) SetBkNormalImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("bkhotimage")) == 0 ) SetBkHotImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("bkpushedimage")) == 0 ) SetBkPushedImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("bkdisabledimage")) == 0 ) SetBkDisabledImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("hor")) == 0 ) SetHorizontal(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if( _tcsicmp(pstrName, _T("linesize")) == 0 ) SetLineSize(_ttoi(pstrValue));
-		else if( _tcsicmp(pstrName, _T("range")) == 0 ) SetScrollRange(_ttoi(pstrValue));
-		else if( _tcsicmp(pstrName, _T("value")) == 0 ) SetScrollPos(_ttoi(pstrValue));
-		else if( _tcsicmp(pstrName, _T("showbutton1")) == 0 ) SetShowButton1(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if( _tcsicmp(pstrName, _T("showbutton2")) == 0 ) SetShowButton2(_tcsicmp(pstrValue, _T("true")) == 0);
-		else CControlUI::SetAttribute(pstrName, pstrValue);
+	void CScrollBarUI::SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue)
+	{
+		if( nAttr == DUIATTR_BUTTON1NORMALIMAGE ) SetButton1NormalImage(pstrValue);
+		else if( nAttr == DUIATTR_BUTTON1HOTIMAGE ) SetButton1HotImage(pstrValue);
+		else if( nAttr == DUIATTR_BUTTON1PUSHEDIMAGE ) SetButton1PushedImage(pstrValue);
+		else if( nAttr == DUIATTR_BUTTON1DISABLEDIMAGE ) SetButton1DisabledImage(pstrValue);
+		else if( nAttr == DUIATTR_BUTTON2NORMALIMAGE ) SetButton2NormalImage(pstrValue);
+		else if( nAttr == DUIATTR_BUTTON2HOTIMAGE ) SetButton2HotImage(pstrValue);
+		else if( nAttr == DUIATTR_BUTTON2PUSHEDIMAGE ) SetButton2PushedImage(pstrValue);
+		else if( nAttr == DUIATTR_BUTTON2DISABLEDIMAGE ) SetButton2DisabledImage(pstrValue);
+		else if( nAttr == DUIATTR_THUMBNORMALIMAGE ) SetThumbNormalImage(pstrValue);
+		else if( nAttr == DUIATTR_THUMBHOTIMAGE ) SetThumbHotImage(pstrValue);
+		else if( nAttr == DUIATTR_THUMBPUSHEDIMAGE ) SetThumbPushedImage(pstrValue);
+		else if( nAttr == DUIATTR_THUMBDISABLEDIMAGE ) SetThumbDisabledImage(pstrValue);
+		else if( nAttr == DUIATTR_RAILNORMALIMAGE ) SetRailNormalImage(pstrValue);
+		else if( nAttr == DUIATTR_RAILHOTIMAGE ) SetRailHotImage(pstrValue);
+		else if( nAttr == DUIATTR_RAILPUSHEDIMAGE ) SetRailPushedImage(pstrValue);
+		else if( nAttr == DUIATTR_RAILDISABLEDIMAGE ) SetRailDisabledImage(pstrValue);
+		else if( nAttr == DUIATTR_BKNORMALIMAGE ) SetBkNormalImage(pstrValue);
+		else if( nAttr == DUIATTR_BKHOTIMAGE ) SetBkHotImage(pstrValue);
+		else if( nAttr == DUIATTR_BKPUSHEDIMAGE ) SetBkPushedImage(pstrValue);
+		else if( nAttr == DUIATTR_BKDISABLEDIMAGE ) SetBkDisabledImage(pstrValue);
+		else if( nAttr == DUIATTR_HOR ) SetHorizontal(_tcsicmp(pstrValue, _T("true")) == 0);
+		else if( nAttr == DUIATTR_LINESIZE ) SetLineSize(_ttoi(pstrValue));
+		else if( nAttr == DUIATTR_RANGE ) SetScrollRange(_ttoi(pstrValue));
+		else if( nAttr == DUIATTR_VALUE ) SetScrollPos(_ttoi(pstrValue));
+		else if( nAttr == DUIATTR_SHOWBUTTON1 ) SetShowButton1(_tcsicmp(pstrValue, _T("true")) == 0);
+		else if( nAttr == DUIATTR_SHOWBUTTON2 ) SetShowButton2(_tcsicmp(pstrValue, _T("true")) == 0);
+		else CControlUI::SetAttributeById(nAttr, pstrName, pstrValue);
 	}
 
 	void CScrollBarUI::DoPaint(HDC hDC, const RECT& rcPaint)
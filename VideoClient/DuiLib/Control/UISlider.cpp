@@ -247,25 +247,25 @@ namespace DuiLib
 		return m_bSendMove;
 	}
 
-	void CSliderUI::SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue)
+	void CSliderUI::SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue)
 	{
-		if( _tcsicmp(pstrName, _T("thumbimage")) == 0 ) SetThumbImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("thumbhotimage")) == 0 ) SetThumbHotImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("thumbpushedimage")) == 0 ) SetThumbPushedImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("thumbsize")) == 0 ) {
+		if( nAttr == DUIATTR_THUMBIMAGE ) SetThumbImage(pstrValue);
+		else if( nAttr == DUIATTR_THUMBHOTIMAGE ) SetThumbHotImage(pstrValue);
+		else if( nAttr == DUIATTR_THUMBPUSHEDIMAGE ) SetThumbPushedImage(pstrValue);
+		else if( nAttr == DUIATTR_THUMBSIZE ) {
 			SIZE szXY = {0};
 			LPTSTR pstr = NULL;
 			szXY.cx = _tcstol(pstrValue, &pstr, 10);  ASSERT(pstr);    
 			szXY.cy = _tcstol(pstr + 1, &pstr, 10);    ASSERT(pstr); 
 			SetThumbSize(szXY);
 		}
-		else if( _tcsicmp(pstrName, _T("step")) == 0 ) {
+		else if( nAttr == DUIATTR_STEP ) {
 			SetChangeStep(_ttoi(pstrValue));
 		}
-		else if( _tcsicmp(pstrName, _T("sendmove")) == 0 ) {
+		else if( nAttr == DUIATTR_SENDMOVE ) {
 			SetCanSendMove(_tcsicmp(pstrValue, _T("true")) == 0);
 		}
-		else CProgressUI::SetAttribute(pstrName, pstrValue);
+		else CProgressUI::SetAttributeById(nAttr, pstrName, pstrValue);
 	}
 
 	void CSliderUI::PaintForeImage(HDC hDC)
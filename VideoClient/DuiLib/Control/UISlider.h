@@ -29,7 +29,7 @@ namespace DuiLib
 		void SetThumbPushedImage(LPCTSTR pStrImage);
 
 		void DoEvent(TEventUI& event);
-		void SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue);
+		void SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue);
 		void PaintForeImage(HDC hDC);
 
 		void SetValue(int nValue);
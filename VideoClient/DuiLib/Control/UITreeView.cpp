@@ -452,51 +452,52 @@ namespace DuiLib
 	}
 
 	//************************************
-	// : SetAttribute
+	// : SetAttributeById
 	// : void
+	// Ϣ: int nAttr
 	// Ϣ: LPCTSTR pstrName
 	// Ϣ: LPCTSTR pstrValue
 	// ˵: 
 	//************************************
-	void CTreeNodeUI::SetAttribute( LPCTSTR pstrName, LPCTSTR pstrValue )
+	void CTreeNodeUI::SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue)
 	{
-		if(_tcsicmp(pstrName, _T("text")) == 0 )
+		if( nAttr == DUIATTR_TEXT )
 			pItemButton->SetText(pstrValue);
-		else if(_tcsicmp(pstrName, _T("horizattr")) == 0 )
+		else if( nAttr == DUIATTR_HORIZATTR )
 			pHoriz->ApplyAttributeList(pstrValue);
-		else if(_tcsicmp(pstrName, _T("dotlineattr")) == 0 )
+		else if( nAttr == DUIATTR_DOTLINEATTR )
 			pDottedLine->ApplyAttributeList(pstrValue);
-		else if(_tcsicmp(pstrName, _T("folderattr")) == 0 )
+		else if( nAttr == DUIATTR_FOLDERATTR )
 			pFolderButton->ApplyAttributeList(pstrValue);
-		else if(_tcsicmp(pstrName, _T("checkboxattr")) == 0 )
+		else if( nAttr == DUIATTR_CHECKBOXATTR )
 			pCheckBox->ApplyAttributeList(pstrValue);
-		else if(_tcsicmp(pstrName, _T("itemattr")) == 0 )
+		else if( nAttr == DUIATTR_ITEMATTR )
 			pItemButton->ApplyAttributeList(pstrValue);
-		else if(_tcsicmp(pstrName, _T("itemtextcolor")) == 0 ){
+		else if( nAttr == DUIATTR_ITEMTEXTCOLOR ){
 			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
 			LPTSTR pstr = NULL;
 			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
 			SetItemTextColor(clrColor);
 		}
-		else if(_tcsicmp(pstrName, _T("itemhottextcolor")) == 0 ){
+		else if( nAttr == DUIATTR_ITEMHOTTEXTCOLOR ){
 			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
 			LPTSTR pstr = NULL;
 			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
 			SetItemHotTextColor(clrColor);
 		}
-		else if(_tcsicmp(pstrName, _T("selitemtextcolor")) == 0 ){
+		else if( nAttr == DUIATTR_SELITEMTEXTCOLOR ){
 			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
 			LPTSTR pstr = NULL;
 			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
 			SetSelItemTextColor(clrColor);
 		}
-		else if(_tcsicmp(pstrName, _T("selitemhottextcolor")) == 0 ){
+		else if( nAttr == DUIATTR_SELITEMHOTTEXTCOLOR ){
 			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
 			LPTSTR pstr = NULL;
 			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
 			SetSelItemHotTextColor(clrColor);
 		}
-		else CListContainerElementUI::SetAttribute(pstrName,pstrValue);
+		else CListContainerElementUI::SetAttributeById(nAttr, pstrName, pstrValue);
 	}
 
 	//************************************
@@ -1201,45 +1202,46 @@ namespace DuiLib
 	}
 
 	//************************************
-	// : SetAttribute
+	// : SetAttributeById
 	// : void
+	// Ϣ: int nAttr
 	// Ϣ: LPCTSTR pstrName
 	// Ϣ: LPCTSTR pstrValue
 	// ˵: 
 	//************************************
-	void CTreeViewUI::SetAttribute( LPCTSTR pstrName, LPCTSTR pstrValue )
+	void CTreeViewUI::SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue)
 	{
-		if(_tcsicmp(pstrName,_T("visiblefolderbtn")) == 0)
+		if( nAttr == DUIATTR_VISIBLEFOLDERBTN )
 			SetVisibleFolderBtn(_tcsicmp(pstrValue,_T("TRUE")) == 0);
-		else if(_tcsicmp(pstrName,_T("visiblecheckbtn")) == 0)
+		else if( nAttr == DUIATTR_VISIBLECHECKBTN )
 			SetVisibleCheckBtn(_tcsicmp(pstrValue,_T("TRUE")) == 0);
-		else if(_tcsicmp(pstrName,_T("itemminwidth")) == 0)
+		else if( nAttr == DUIATTR_ITEMMINWIDTH )
 			SetItemMinWidth(_ttoi(pstrValue));
-		else if(_tcsicmp(pstrName, _T("itemtextcolor")) == 0 ){
+		else if( nAttr == DUIATTR_ITEMTEXTCOLOR ){
 			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
 			LPTSTR pstr = NULL;
 			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
 			SetItemTextColor(clrColor);
 		}
-		else if(_tcsicmp(pstrName, _T("itemhottextcolor")) == 0 ){
+		else if( nAttr == DUIATTR_ITEMHOTTEXTCOLOR ){
 			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
 			LPTSTR pstr = NULL;
 			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
 			SetItemHotTextColor(clrColor);
 		}
-		else if(_tcsicmp(pstrName, _T("selitemtextcolor")) == 0 ){
+		else if( nAttr == DUIATTR_SELITEMTEXTCOLOR ){
 			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
 			LPTSTR pstr = NULL;
 			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
 			SetSelItemTextColor(clrColor);
 		}
-		else if(_tcsicmp(pstrName, _T("selitemhottextcolor")) == 0 ){
+		else if( nAttr == DUIATTR_SELITEMHOTTEXTCOLOR ){
 			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
 			LPTSTR pstr = NULL;
 			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
 			SetSelItemHotTextColor(clrColor);
 		}
-		else CListUI::SetAttribute(pstrName,pstrValue);
+		else CListUI::SetAttributeById(nAttr, pstrName, pstrValue);
 	}
 
 }
\ No newline at end of file
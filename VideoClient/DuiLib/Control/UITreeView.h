@@ -60,7 +60,7 @@ namespace DuiLib
 		DWORD GetSelItemTextColor() const;
 		void SetSelItemHotTextColor(DWORD _dwSelHotItemTextColor);
 		DWORD GetSelItemHotTextColor() const;
-		void SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue);
+		void SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue);
 
 		CStdPtrArray GetTreeNodes();
 		int			 GetTreeIndex();
@@ -131,7 +131,7 @@ namespace DuiLib
 		virtual void SetSelItemTextColor(DWORD _dwSelItemTextColor);
 		virtual void SetSelItemHotTextColor(DWORD _dwSelHotItemTextColor);
 		
-		virtual void SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue);
+		virtual void SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue);
 	private:
 		UINT m_uItemMinWidth;
 		bool m_bVisibleFolderBtn;
@@ -475,18 +475,18 @@ namespace DuiLib
 		m_pWebBrowser2->Refresh2(&vLevel);
 	}
 
-	void CWebBrowserUI::SetAttribute( LPCTSTR pstrName, LPCTSTR pstrValue )
+	void CWebBrowserUI::SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue)
 	{
-		if (_tcsicmp(pstrName, _T("homepage")) == 0)
+		if (nAttr == DUIATTR_HOMEPAGE)
 		{
 			m_sHomePage = pstrValue;
 		}
-		else if (_tcsicmp(pstrName, _T("autonavi"))==0)
+		else if (nAttr == DUIATTR_AUTONAVI)
 		{
 			m_bAutoNavi = (_tcsicmp(pstrValue, _T("true")) == 0);
 		}
 		else
-			CActiveXUI::SetAttribute(pstrName, pstrValue);
+			CActiveXUI::SetAttributeById(nAttr, pstrName, pstrValue);
 	}
 
 	void CWebBrowserUI::NavigateHomePage()
@@ -52,7 +52,7 @@ namespace DuiLib
 		DWORD m_dwCookie;
 		virtual void ReleaseControl();
 		HRESULT RegisterEventHandler(BOOL inAdvise);
-		virtual void SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue);
+		virtual void SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue);
 		CDuiString m_sHomePage;	// Ĭҳ
 		bool m_bAutoNavi;	// ǷʱĬҳ
 		CWebBrowserEventHandler* m_pWebBrowserEventHandler;	//¼
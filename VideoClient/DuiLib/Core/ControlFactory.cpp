@@ -72,6 +72,13 @@ namespace DuiLib
 		}
 	}
 
+	CreateClass CControlFactory::GetCreateClass(CDuiString strClassName)
+	{
+		strClassName.MakeLower();
+		MAP_DUI_CTRATECLASS::iterator iter = m_mapControl.find(strClassName);
+		return iter == m_mapControl.end() ? NULL : iter->second;
+	}
+
 	void CControlFactory::RegistControl(CDuiString strClassName, CreateClass pFunc)
 	{
 		strClassName.MakeLower();
@@ -9,6 +9,8 @@ namespace DuiLib
 	{
 	public:
 		CControlUI* CreateControl(CDuiString strClassName);
+		// The create function registered for the class, NULL when there is none
+		CreateClass GetCreateClass(CDuiString strClassName);
 		void RegistControl(CDuiString strClassName, CreateClass pFunc);
 
 		static CControlFactory* GetInstance();
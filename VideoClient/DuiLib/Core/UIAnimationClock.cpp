@@ -0,0 +1,129 @@
+#include "StdAfx.h"
+#include <algorithm>
+
+namespace DuiLib {
+
+	/////////////////////////////////////////////////////////////////////////////////////
+	//
+	//
+
+	size_t CAnimationClock::TKeyHash::operator()(const TKey& key) const
+	{
+		return std::hash<void*>()(key.first) ^ (key.second * 0x9E3779B9u);
+	}
+
+	CAnimationClock::CAnimationClock() :
+		m_uSerial(0)
+	{
+	}
+
+	CAnimationClock::~CAnimationClock()
+	{
+		RemoveAll();
+	}
+
+	bool CAnimationClock::SetTimer(CControlUI* pControl, UINT nTimerID, UINT uElapse, DWORD dwNow)
+	{
+		TKey key(pControl, nTimerID);
+		if( m_mTimers.find(key) != m_mTimers.end() ) return false;
+		if( uElapse == 0 ) uElapse = 1;
+
+		TTimer* pTimer = new TTimer;
+		pTimer->pControl = pControl;
+		pTimer->nTimerID = nTimerID;
+		pTimer->uElapse = uElapse;
+		pTimer->dwDue = dwNow + uElapse;
+		pTimer->uSerial = ++m_uSerial;
+		m_mTimers[key] = pTimer;
+		m_mControls[pControl].push_back(pTimer);
+		return true;
+	}
+
+	bool CAnimationClock::KillTimer(CControlUI* pControl, UINT nTimerID)
+	{
+		TimerMap::iterator it = m_mTimers.find(TKey(pControl, nTimerID));
+		if( it == m_mTimers.end() ) return false;
+		TTimer* pTimer = it->second;
+		m_mTimers.erase(it);
+		Unlink(pTimer);
+		delete pTimer;
+		return true;
+	}
+
+	void CAnimationClock::KillTimer(CControlUI* pControl)
+	{
+		ControlMap::iterator it = m_mControls.find(pControl);
+		if( it == m_mControls.end() ) return;
+		std::vector<TTimer*> aTimers;
+		aTimers.swap(it->second);
+		m_mControls.erase(it);
+		for( size_t i = 0; i < aTimers.size(); i++ ) {
+			m_mTimers.erase(TKey(pControl, aTimers[i]->nTimerID));
+			delete aTimers[i];
+		}
+	}
+
+	void CAnimationClock::RemoveAll()
+	{
+		for( TimerMap::iterator it = m_mTimers.begin(); it != m_mTimers.end(); ++it ) delete it->second;
+		m_mTimers.clear();
+		m_mControls.clear();
+	}
+
+	static bool CompareDue(const std::pair<int, CAnimationClock::TDue>& a, const std::pair<int, CAnimationClock::TDue>& b)
+	{
+		if( a.first != b.first ) return a.first < b.first;
+		return a.second.uSerial < b.second.uSerial;
+	}
+
+	void CAnimationClock::Tick(DWORD dwNow, std::vector<TDue>& aDue)
+	{
+		aDue.clear();
+		std::vector<std::pair<int, TDue> > aFired;
+		for( TimerMap::iterator it = m_mTimers.begin(); it != m_mTimers.end(); ++it ) {
+			TTimer* pTimer = it->second;
+			int iLeft = (int)(pTimer->dwDue - dwNow);
+			if( iLeft >= FRAME_TIME ) continue;
+			TDue due = { pTimer->pControl, pTimer->nTimerID, pTimer->uSerial };
+			// ordered by time left rather than due time, which the tick count can wrap under
+			aFired.push_back(std::make_pair(iLeft, due));
+			// a timer that fell behind starts again from now rather than firing to catch up
+			pTimer->dwDue += pTimer->uElapse;
+			if( (int)(pTimer->dwDue - dwNow) <= 0 ) pTimer->dwDue = dwNow + pTimer->uElapse;
+		}
+		std::sort(aFired.begin(), aFired.end(), CompareDue);
+		for( size_t i = 0; i < aFired.size(); i++ ) aDue.push_back(aFired[i].second);
+	}
+
+	bool CAnimationClock::IsCurrent(const TDue& due) const
+	{
+		TimerMap::const_iterator it = m_mTimers.find(TKey(due.pControl, due.nTimerID));
+		return it != m_mTimers.end() && it->second->uSerial == due.uSerial;
+	}
+
+	int CAnimationClock::GetNextDue(DWORD dwNow) const
+	{
+		int iNext = -1;
+		for( TimerMap::const_iterator it = m_mTimers.begin(); it != m_mTimers.end(); ++it ) {
+			int iLeft = (int)(it->second->dwDue - dwNow);
+			if( iLeft < 0 ) iLeft = 0;
+			if( iNext < 0 || iLeft < iNext ) iNext = iLeft;
+		}
+		return iNext;
+	}
+
+	int CAnimationClock::GetCount() const
+	{
+		return (int)m_mTimers.size();
+	}
+
+	void CAnimationClock::Unlink(TTimer* pTimer)
+	{
+		ControlMap::iterator it = m_mControls.find(pTimer->pControl);
+		if( it == m_mControls.end() ) return;
+		std::vector<TTimer*>& aTimers = it->second;
+		aTimers.erase(std::remove(aTimers.begin(), aTimers.end(), pTimer), aTimers.end());
+		if( aTimers.empty() ) m_mControls.erase(it);
+	}
+
+} // namespace DuiLib
@@ -0,0 +1,79 @@
+#ifndef __UIANIMATIONCLOCK_H__
+#define __UIANIMATIONCLOCK_H__
+
+#pragma once
+#include <vector>
+#include <unordered_map>
+
+namespace DuiLib {
+	/////////////////////////////////////////////////////////////////////////////////////
+	//
+	// The control timers of one paint manager, run off a single window timer.
+	//
+	// Timers are found by control and id in a hash, so setting and killing one doesn't scan
+	// the others. Tick hands back every timer that falls due before the next frame, all at
+	// once, so animations running at the same rate step together and what they invalidate
+	// is painted once. GetNextDue says when the window timer has to fire next.
+	//
+	// Nothing here knows about windows or messages: the owner passes the time in and sends
+	// the events out.
+
+	class CControlUI;
+
+	class CAnimationClock
+	{
+	public:
+		enum { FRAME_TIME = 16 };
+
+		typedef struct tagTDue
+		{
+			CControlUI* pControl;
+			UINT nTimerID;
+			UINT uSerial;
+		} TDue;
+
+		CAnimationClock();
+		~CAnimationClock();
+
+		// false if the control already has a timer with that id; it keeps its elapse then
+		bool SetTimer(CControlUI* pControl, UINT nTimerID, UINT uElapse, DWORD dwNow);
+		bool KillTimer(CControlUI* pControl, UINT nTimerID);
+		void KillTimer(CControlUI* pControl);
+		void RemoveAll();
+
+		// every timer due before dwNow + FRAME_TIME, in the order they fell due; each one is
+		// moved on by its elapse
+		void Tick(DWORD dwNow, std::vector<TDue>& aDue);
+		// false once the timer has been killed, or killed and set again, since Tick gave it out
+		bool IsCurrent(const TDue& due) const;
+		// ms until the first timer is due, 0 if it is late, -1 if there are none
+		int GetNextDue(DWORD dwNow) const;
+		int GetCount() const;
+
+	private:
+		struct TTimer
+		{
+			CControlUI* pControl;
+			UINT nTimerID;
+			UINT uElapse;
+			DWORD dwDue;
+			UINT uSerial;
+		};
+		typedef std::pair<CControlUI*, UINT> TKey;
+		struct TKeyHash
+		{
+			size_t operator()(const TKey& key) const;
+		};
+		typedef std::unordered_map<TKey, TTimer*, TKeyHash> TimerMap;
+		typedef std::unordered_map<CControlUI*, std::vector<TTimer*> > ControlMap;
+
+		void Unlink(TTimer* pTimer);
+
+		TimerMap m_mTimers;
+		ControlMap m_mControls;
+		UINT m_uSerial;
+	};
+
+} // namespace DuiLib
+
+#endif // __UIANIMATIONCLOCK_H__
@@ -221,6 +221,7 @@ namespace DuiLib
 	void CContainerUI::SetMouseChildEnabled(bool bEnable)
 	{
 		m_bMouseChildEnabled = bEnable;
+		if( m_pManager != NULL ) m_pManager->NeedHitTestUpdate();
 	}
 
 	void CContainerUI::SetVisible(bool bVisible)
@@ -686,14 +687,14 @@ namespace DuiLib
 				if( sz.cy < pControl->GetMinHeight() ) sz.cy = pControl->GetMinHeight();
 				if( sz.cy > pControl->GetMaxHeight() ) sz.cy = pControl->GetMaxHeight();
 				RECT rcCtrl = { rc.left, rc.top, rc.left + sz.cx, rc.top + sz.cy };
-				pControl->SetPos(rcCtrl, false);
+				SetItemPos(pControl, rcCtrl);
 			}
 		}
 	}
 
-	void CContainerUI::SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue)
+	void CContainerUI::SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue)
 	{
-		if( _tcsicmp(pstrName, _T("inset")) == 0 ) {
+		if( nAttr == DUIATTR_INSET ) {
 			RECT rcInset = { 0 };
 			LPTSTR pstr = NULL;
 			rcInset.left = _tcstol(pstrValue, &pstr, 10);  ASSERT(pstr);    
@@ -702,11 +703,11 @@ namespace DuiLib
 			rcInset.bottom = _tcstol(pstr + 1, &pstr, 10); ASSERT(pstr);    
 			SetInset(rcInset);
 		}
-		else if( _tcsicmp(pstrName, _T("mousechild")) == 0 ) SetMouseChildEnabled(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if( _tcsicmp(pstrName, _T("vscrollbar")) == 0 ) {
+		else if( nAttr == DUIATTR_MOUSECHILD ) SetMouseChildEnabled(_tcsicmp(pstrValue, _T("true")) == 0);
+		else if( nAttr == DUIATTR_VSCROLLBAR ) {
 			EnableScrollBar(_tcsicmp(pstrValue, _T("true")) == 0, GetHorizontalScrollBar() != NULL);
 		}
-		else if( _tcsicmp(pstrName, _T("vscrollbarstyle")) == 0 ) {
+		else if( nAttr == DUIATTR_VSCROLLBARSTYLE ) {
 			m_sVerticalScrollBarStyle = pstrValue;
 			EnableScrollBar(TRUE, GetHorizontalScrollBar() != NULL);
 			if( GetVerticalScrollBar() ) {
@@ -719,10 +720,10 @@ namespace DuiLib
 				}
 			}
 		}
-		else if( _tcsicmp(pstrName, _T("hscrollbar")) == 0 ) {
+		else if( nAttr == DUIATTR_HSCROLLBAR ) {
 			EnableScrollBar(GetVerticalScrollBar() != NULL, _tcsicmp(pstrValue, _T("true")) == 0);
 		}
-		else if( _tcsicmp(pstrName, _T("hscrollbarstyle")) == 0 ) {
+		else if( nAttr == DUIATTR_HSCROLLBARSTYLE ) {
 			m_sHorizontalScrollBarStyle = pstrValue;
 			EnableScrollBar(TRUE, GetHorizontalScrollBar() != NULL);
 			if( GetHorizontalScrollBar() ) {
@@ -735,19 +736,19 @@ namespace DuiLib
 				}
 			}
 		}
-		else if( _tcsicmp(pstrName, _T("childpadding")) == 0 ) SetChildPadding(_ttoi(pstrValue));
-		else if( _tcscmp(pstrName, _T("childalign")) == 0 ) {
+		else if( nAttr == DUIATTR_CHILDPADDING ) SetChildPadding(_ttoi(pstrValue));
+		else if( nAttr == DUIATTR_CHILDALIGN ) {
 			if( _tcscmp(pstrValue, _T("left")) == 0 ) m_iChildAlign = DT_LEFT;
 			else if( _tcscmp(pstrValue, _T("center")) == 0 ) m_iChildAlign = DT_CENTER;
 			else if( _tcscmp(pstrValue, _T("right")) == 0 ) m_iChildAlign = DT_RIGHT;
 		}
-		else if( _tcscmp(pstrName, _T("childvalign")) == 0 ) {
+		else if( nAttr == DUIATTR_CHILDVALIGN ) {
 			if( _tcscmp(pstrValue, _T("top")) == 0 ) m_iChildVAlign = DT_TOP;
 			else if( _tcscmp(pstrValue, _T("vcenter")) == 0 ) m_iChildVAlign = DT_VCENTER;
 			else if( _tcscmp(pstrValue, _T("bottom")) == 0 ) m_iChildVAlign = DT_BOTTOM;
 		}
-		else if( _tcsicmp(pstrName, _T("scrollstepsize")) == 0 ) SetScrollStepSize(_ttoi(pstrValue));
-		else CControlUI::SetAttribute(pstrName, pstrValue);
+		else if( nAttr == DUIATTR_SCROLLSTEPSIZE ) SetScrollStepSize(_ttoi(pstrValue));
+		else CControlUI::SetAttributeById(nAttr, pstrName, pstrValue);
 	}
 
 	void CContainerUI::SetManager(CPaintManagerUI* pManager, CControlUI* pParent, bool bInit)
@@ -923,7 +924,7 @@ namespace DuiLib
 			}
 
 			::OffsetRect(&rcCtrl, m_rcItem.left, m_rcItem.top);
-			pControl->SetPos(rcCtrl, false);
+			SetItemPos(pControl, rcCtrl);
 		}
 		else {
 			TPercentInfo rcPercent = pControl->GetFloatPercent();
@@ -934,10 +935,24 @@ namespace DuiLib
 			rcCtrl.top = (LONG)(height*rcPercent.top) + szXY.cy+ m_rcItem.top;
 			rcCtrl.right = (LONG)(width*rcPercent.right) + szXY.cx + sz.cx+ m_rcItem.left;
 			rcCtrl.bottom = (LONG)(height*rcPercent.bottom) + szXY.cy + sz.cy+ m_rcItem.top;
-			pControl->SetPos(rcCtrl, false);
+			SetItemPos(pControl, rcCtrl);
 		}
 	}
 
+	void CContainerUI::SetItemPos(CControlUI* pControl, RECT rc, bool bNeedInvalidate)
+	{
+		// SetPos keeps rc like this
+		if( rc.right < rc.left ) rc.right = rc.left;
+		if( rc.bottom < rc.top ) rc.bottom = rc.top;
+
+		// Below an unchanged rect only controls that asked for an update need a layout, and
+		// the paint manager finds and lays out those after the layout from the root.
+		if( !pControl->IsUpdateNeeded() && ::EqualRect(&rc, &pControl->GetPos()) ) {
+			if( m_pManager == NULL || !m_pManager->IsFullLayoutNeeded() ) return;
+		}
+		pControl->SetPos(rc, bNeedInvalidate);
+	}
+
 	void CContainerUI::ProcessScrollBar(RECT rc, int cxRequired, int cyRequired)
 	{
 		while (m_pHorizontalScrollBar)
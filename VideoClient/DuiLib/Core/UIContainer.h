@@ -29,6 +29,7 @@ namespace DuiLib {
 	class UILIB_API CContainerUI : public CControlUI, public IContainerUI
 	{
 		DECLARE_DUICONTROL(CContainerUI)
+		friend class CHitTestIndex;
 
 	public:
 		CContainerUI();
@@ -76,7 +77,7 @@ namespace DuiLib {
 		void Move(SIZE szOffset, bool bNeedInvalidate = true);
 		void DoPaint(HDC hDC, const RECT& rcPaint);
 
-		void SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue);
+		void SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue);
 
 		void SetManager(CPaintManagerUI* pManager, CControlUI* pParent, bool bInit = true);
 		CControlUI* FindControl(FINDCONTROLPROC Proc, LPVOID pData, UINT uFlags);
@@ -116,6 +117,16 @@ namespace DuiLib {
 	protected:
 		virtual void SetFloatPos(int iIndex);
 		virtual void ProcessScrollBar(RECT rc, int cxRequired, int cyRequired);
+		// SetPos for a child, skipped when it is already at rc and hasn't asked for an update
+		void SetItemPos(CControlUI* pControl, RECT rc, bool bNeedInvalidate = false);
+
+		// what EstimateSize gave a child for szAvailable, kept for the rest of one SetPos
+		struct TItemSize
+		{
+			SIZE szAvailable;
+			SIZE sz;
+			bool bValid;
+		};
 
 	protected:
 		CStdPtrArray m_items;
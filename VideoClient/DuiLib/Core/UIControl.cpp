@@ -366,6 +366,7 @@ namespace DuiLib {
 
 		m_rcItem = rc;
 		if( m_pManager == NULL ) return;
+		m_pManager->NeedHitTestUpdate();
 
 		if( !m_bSetPos ) {
 			m_bSetPos = true;
@@ -658,13 +659,17 @@ namespace DuiLib {
 			m_pManager->SetFocus(NULL) ;
 		}
 		if( IsVisible() != v ) {
+			// NeedUpdate isn't recorded while hidden, so lay out again whatever changed meanwhile
+			if( !v ) m_bUpdateNeeded = true;
 			NeedParentUpdate();
 		}
 	}
 
 	void CControlUI::SetInternVisible(bool bVisible)
 	{
+		if( bVisible && !m_bInternVisible && m_bVisible ) m_bUpdateNeeded = true;
 		m_bInternVisible = bVisible;
+		if( m_pManager != NULL ) m_pManager->NeedHitTestUpdate();
 		if (!bVisible && m_pManager && m_pManager->GetFocus() == this) {
 			m_pManager->SetFocus(NULL) ;
 		}
@@ -691,6 +696,7 @@ namespace DuiLib {
 	void CControlUI::SetMouseEnabled(bool bEnabled)
 	{
 		m_bMouseEnabled = bEnabled;
+		if( m_pManager != NULL ) m_pManager->NeedHitTestUpdate();
 	}
 
 	bool CControlUI::IsKeyboardEnabled() const
@@ -913,7 +919,126 @@ namespace DuiLib {
 		m_mCustomAttrHash.Resize();
 	}
 
+	// SetAttributeϣ(hash and displace)һʹʱDUI_ATTRIBUTE_LIST
+	// Ȱ׸ϣֵͰÿͰһλʹͰڵ䵽ͻĿղ
+	// ֻһιϣһۣٱȽһ
+	class CAttributeTable
+	{
+	public:
+		enum { BUCKETS = 64, SLOTS = 512 };
+
+		CAttributeTable() : m_bLinear(false)
+		{
+			::ZeroMemory(m_aDisplace, sizeof(m_aDisplace));
+			::ZeroMemory(m_aSlots, sizeof(m_aSlots));
+
+			UINT aHashA[DUIATTR_COUNT], aHashB[DUIATTR_COUNT];
+			int aBucketSize[BUCKETS] = { 0 };
+			for( int i = 1; i < DUIATTR_COUNT; i++ ) {
+				Hash(Name(i), aHashA[i], aHashB[i]);
+				aBucketSize[Bucket(aHashA[i])]++;
+			}
+			// Ͱȷţղ۶ʱҵλ
+			int aOrder[BUCKETS];
+			for( int i = 0; i < BUCKETS; i++ ) {
+				int j = i;
+				for( ; j > 0 && aBucketSize[aOrder[j - 1]] < aBucketSize[i]; j-- ) aOrder[j] = aOrder[j - 1];
+				aOrder[j] = i;
+			}
+			for( int i = 0; i < BUCKETS && aBucketSize[aOrder[i]] > 0; i++ ) {
+				int nBucket = aOrder[i];
+				UINT d = 0;
+				for( ; d <= 0xFFFF; d++ ) {
+					if( Place(nBucket, d, aHashA, aHashB) ) break;
+				}
+				if( d > 0xFFFF ) {
+					// Ǽǵ޷ųϣ˻Ƚ
+					ASSERT(!"DUI_ATTRIBUTE_LIST has no perfect hash");
+					m_bLinear = true;
+					return;
+				}
+				m_aDisplace[nBucket] = (WORD)d;
+			}
+		}
+
+		int Find(LPCTSTR pstrName) const
+		{
+			if( pstrName == NULL ) return DUIATTR_UNKNOWN;
+			if( m_bLinear ) {
+				for( int i = 1; i < DUIATTR_COUNT; i++ ) {
+					if( _tcsicmp(Name(i), pstrName) == 0 ) return i;
+				}
+				return DUIATTR_UNKNOWN;
+			}
+			UINT hA, hB;
+			Hash(pstrName, hA, hB);
+			int nAttr = m_aSlots[Slot(hA, hB, m_aDisplace[Bucket(hA)])];
+			if( nAttr != DUIATTR_UNKNOWN && _tcsicmp(Name(nAttr), pstrName) == 0 ) return nAttr;
+			return DUIATTR_UNKNOWN;
+		}
+
+	private:
+		static LPCTSTR Name(int nAttr)
+		{
+			static const LPCTSTR s_aNames[] = {
+				NULL,
+#define DUI_ATTRIBUTE_NAME(id, name) _T(name),
+				DUI_ATTRIBUTE_LIST(DUI_ATTRIBUTE_NAME)
+#undef DUI_ATTRIBUTE_NAME
+			};
+			return s_aNames[nAttr];
+		}
+
+		// ϣһ| 0x20ʹСдõͬһֵ
+		static void Hash(LPCTSTR pstrName, UINT& hA, UINT& hB)
+		{
+			hA = 2166136261u;
+			hB = 0;
+			for( ; *pstrName != _T('\0'); pstrName++ ) {
+				UINT ch = (UINT)(*pstrName | 0x20);
+				hA = (hA ^ ch) * 16777619u;
+				hB = hB * 31 + ch;
+			}
+			hB = (hB ^ (hB >> 9)) | 1;
+		}
+
+		static int Bucket(UINT hA) { return (hA >> 16) & (BUCKETS - 1); }
+		static int Slot(UINT hA, UINT hB, UINT d) { return (hA + d * hB) & (SLOTS - 1); }
+
+		bool Place(int nBucket, UINT d, const UINT* aHashA, const UINT* aHashB)
+		{
+			int aPlaced[DUIATTR_COUNT];
+			int nPlaced = 0;
+			for( int i = 1; i < DUIATTR_COUNT; i++ ) {
+				if( Bucket(aHashA[i]) != nBucket ) continue;
+				int nSlot = Slot(aHashA[i], aHashB[i], d);
+				if( m_aSlots[nSlot] != DUIATTR_UNKNOWN ) {
+					while( nPlaced > 0 ) m_aSlots[aPlaced[--nPlaced]] = DUIATTR_UNKNOWN;
+					return false;
+				}
+				m_aSlots[nSlot] = (WORD)i;
+				aPlaced[nPlaced++] = nSlot;
+			}
+			return true;
+		}
+
+		WORD m_aDisplace[BUCKETS];
+		WORD m_aSlots[SLOTS];
+		bool m_bLinear;
+	};
+
+	int CControlUI::GetAttributeId(LPCTSTR pstrName)
+	{
+		static const CAttributeTable s_table;
+		return s_table.Find(pstrName);
+	}
+
 	void CControlUI::SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue)
+	{
+		SetAttributeById(GetAttributeId(pstrName), pstrName, pstrValue);
+	}
+
+	void CControlUI::SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue)
 	{
 		// Ƿʽ
 		if(m_pManager != NULL) {
@@ -923,7 +1048,7 @@ namespace DuiLib {
 				return;
 			}
 		}
-		if( _tcsicmp(pstrName, _T("pos")) == 0 ) {
+		if( nAttr == DUIATTR_POS ) {
 			RECT rcPos = { 0 };
 			LPTSTR pstr = NULL;
 			rcPos.left = _tcstol(pstrValue, &pstr, 10);  ASSERT(pstr);    
@@ -935,7 +1060,7 @@ namespace DuiLib {
 			SetFixedWidth(rcPos.right - rcPos.left);
 			SetFixedHeight(rcPos.bottom - rcPos.top);
 		}
-		else if( _tcsicmp(pstrName, _T("float")) == 0 ) {
+		else if( nAttr == DUIATTR_FLOAT ) {
 			CDuiString nValue = pstrValue;
 			// ̬Ա
 			if(nValue.Find(',') < 0) {
@@ -952,7 +1077,7 @@ namespace DuiLib {
 				SetFloat(true);
 			}
 		}
-		else if( _tcsicmp(pstrName, _T("floatalign")) == 0) {
+		else if( nAttr == DUIATTR_FLOATALIGN) {
 			UINT uAlign = GetFloatAlign();
 			// 
 			while( *pstrValue != _T('\0') ) {
@@ -995,7 +1120,7 @@ namespace DuiLib {
 			}
 			SetFloatAlign(uAlign);
 		}
-		else if( _tcsicmp(pstrName, _T("padding")) == 0 ) {
+		else if( nAttr == DUIATTR_PADDING ) {
 			RECT rcPadding = { 0 };
 			LPTSTR pstr = NULL;
 			rcPadding.left = _tcstol(pstrValue, &pstr, 10);  ASSERT(pstr);    
@@ -1004,49 +1129,49 @@ namespace DuiLib {
 			rcPadding.bottom = _tcstol(pstr + 1, &pstr, 10); ASSERT(pstr);    
 			SetPadding(rcPadding);
 		}
-		else if( _tcsicmp(pstrName, _T("gradient")) == 0 ) SetGradient(pstrValue);
-		else if( _tcsicmp(pstrName, _T("bkcolor")) == 0 || _tcsicmp(pstrName, _T("bkcolor1")) == 0 ) {
+		else if( nAttr == DUIATTR_GRADIENT ) SetGradient(pstrValue);
+		else if( nAttr == DUIATTR_BKCOLOR || nAttr == DUIATTR_BKCOLOR1 ) {
 			while( *pstrValue > _T('\0') && *pstrValue <= _T(' ') ) pstrValue = ::CharNext(pstrValue);
 			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
 			LPTSTR pstr = NULL;
 			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
 			SetBkColor(clrColor);
 		}
-		else if( _tcsicmp(pstrName, _T("bkcolor2")) == 0 ) {
+		else if( nAttr == DUIATTR_BKCOLOR2 ) {
 			while( *pstrValue > _T('\0') && *pstrValue <= _T(' ') ) pstrValue = ::CharNext(pstrValue);
 			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
 			LPTSTR pstr = NULL;
 			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
 			SetBkColor2(clrColor);
 		}
-		else if( _tcsicmp(pstrName, _T("bkcolor3")) == 0 ) {
+		else if( nAttr == DUIATTR_BKCOLOR3 ) {
 			while( *pstrValue > _T('\0') && *pstrValue <= _T(' ') ) pstrValue = ::CharNext(pstrValue);
 			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
 			LPTSTR pstr = NULL;
 			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
 			SetBkColor3(clrColor);
 		}
-		else if( _tcsicmp(pstrName, _T("forecolor")) == 0 ) {
+		else if( nAttr == DUIATTR_FORECOLOR ) {
 			while( *pstrValue > _T('\0') && *pstrValue <= _T(' ') ) pstrValue = ::CharNext(pstrValue);
 			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
 			LPTSTR pstr = NULL;
 			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
 			SetForeColor(clrColor);
 		}
-		else if( _tcsicmp(pstrName, _T("bordercolor")) == 0 ) {
+		else if( nAttr == DUIATTR_BORDERCOLOR ) {
 			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
 			LPTSTR pstr = NULL;
 			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
 			SetBorderColor(clrColor);
 		}
-		else if( _tcsicmp(pstrName, _T("focusbordercolor")) == 0 ) {
+		else if( nAttr == DUIATTR_FOCUSBORDERCOLOR ) {
 			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
 			LPTSTR pstr = NULL;
 			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
 			SetFocusBorderColor(clrColor);
 		}
-		else if( _tcsicmp(pstrName, _T("colorhsl")) == 0 ) SetColorHSL(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if( _tcsicmp(pstrName, _T("bordersize")) == 0 ) {
+		else if( nAttr == DUIATTR_COLORHSL ) SetColorHSL(_tcsicmp(pstrValue, _T("true")) == 0);
+		else if( nAttr == DUIATTR_BORDERSIZE ) {
 			CDuiString nValue = pstrValue;
 			if(nValue.Find(',') < 0) {
 				SetBorderSize(_ttoi(pstrValue));
@@ -1063,41 +1188,41 @@ namespace DuiLib {
 				SetBorderSize(rcPadding);
 			}
 		}
-		else if( _tcsicmp(pstrName, _T("leftbordersize")) == 0 ) SetLeftBorderSize(_ttoi(pstrValue));
-		else if( _tcsicmp(pstrName, _T("topbordersize")) == 0 ) SetTopBorderSize(_ttoi(pstrValue));
-		else if( _tcsicmp(pstrName, _T("rightbordersize")) == 0 ) SetRightBorderSize(_ttoi(pstrValue));
-		else if( _tcsicmp(pstrName, _T("bottombordersize")) == 0 ) SetBottomBorderSize(_ttoi(pstrValue));
-		else if( _tcsicmp(pstrName, _T("borderstyle")) == 0 ) SetBorderStyle(_ttoi(pstrValue));
-		else if( _tcsicmp(pstrName, _T("borderround")) == 0 ) {
+		else if( nAttr == DUIATTR_LEFTBORDERSIZE ) SetLeftBorderSize(_ttoi(pstrValue));
+		else if( nAttr == DUIATTR_TOPBORDERSIZE ) SetTopBorderSize(_ttoi(pstrValue));
+		else if( nAttr == DUIATTR_RIGHTBORDERSIZE ) SetRightBorderSize(_ttoi(pstrValue));
+		else if( nAttr == DUIATTR_BOTTOMBORDERSIZE ) SetBottomBorderSize(_ttoi(pstrValue));
+		else if( nAttr == DUIATTR_BORDERSTYLE ) SetBorderStyle(_ttoi(pstrValue));
+		else if( nAttr == DUIATTR_BORDERROUND ) {
 			SIZE cxyRound = { 0 };
 			LPTSTR pstr = NULL;
 			cxyRound.cx = _tcstol(pstrValue, &pstr, 10);  ASSERT(pstr);    
 			cxyRound.cy = _tcstol(pstr + 1, &pstr, 10);    ASSERT(pstr);
 			SetBorderRound(cxyRound);
 		}
-		else if( _tcsicmp(pstrName, _T("bkimage")) == 0 ) SetBkImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("foreimage")) == 0 ) SetForeImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("width")) == 0 ) SetFixedWidth(_ttoi(pstrValue));
-		else if( _tcsicmp(pstrName, _T("height")) == 0 ) SetFixedHeight(_ttoi(pstrValue));
-		else if( _tcsicmp(pstrName, _T("minwidth")) == 0 ) SetMinWidth(_ttoi(pstrValue));
-		else if( _tcsicmp(pstrName, _T("minheight")) == 0 ) SetMinHeight(_ttoi(pstrValue));
-		else if( _tcsicmp(pstrName, _T("maxwidth")) == 0 ) SetMaxWidth(_ttoi(pstrValue));
-		else if( _tcsicmp(pstrName, _T("maxheight")) == 0 ) SetMaxHeight(_ttoi(pstrValue));
-		else if( _tcsicmp(pstrName, _T("name")) == 0 ) SetName(pstrValue);
-		else if( _tcsicmp(pstrName, _T("drag")) == 0 ) SetDragEnable(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if( _tcsicmp(pstrName, _T("drop")) == 0 ) SetDropEnable(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if( _tcsicmp(pstrName, _T("resourcetext")) == 0 ) SetResourceText(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if( _tcsicmp(pstrName, _T("text")) == 0 ) SetText(pstrValue);
-		else if( _tcsicmp(pstrName, _T("tooltip")) == 0 ) SetToolTip(pstrValue);
-		else if( _tcsicmp(pstrName, _T("userdata")) == 0 ) SetUserData(pstrValue);
-		else if( _tcsicmp(pstrName, _T("enabled")) == 0 ) SetEnabled(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if( _tcsicmp(pstrName, _T("mouse")) == 0 ) SetMouseEnabled(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if( _tcsicmp(pstrName, _T("keyboard")) == 0 ) SetKeyboardEnabled(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if( _tcsicmp(pstrName, _T("visible")) == 0 ) SetVisible(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if( _tcsicmp(pstrName, _T("float")) == 0 ) SetFloat(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if( _tcsicmp(pstrName, _T("shortcut")) == 0 ) SetShortcut(pstrValue[0]);
-		else if( _tcsicmp(pstrName, _T("menu")) == 0 ) SetContextMenuUsed(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if( _tcsicmp(pstrName, _T("cursor")) == 0 && pstrValue) {
+		else if( nAttr == DUIATTR_BKIMAGE ) SetBkImage(pstrValue);
+		else if( nAttr == DUIATTR_FOREIMAGE ) SetForeImage(pstrValue);
+		else if( nAttr == DUIATTR_WIDTH ) SetFixedWidth(_ttoi(pstrValue));
+		else if( nAttr == DUIATTR_HEIGHT ) SetFixedHeight(_ttoi(pstrValue));
+		else if( nAttr == DUIATTR_MINWIDTH ) SetMinWidth(_ttoi(pstrValue));
+		else if( nAttr == DUIATTR_MINHEIGHT ) SetMinHeight(_ttoi(pstrValue));
+		else if( nAttr == DUIATTR_MAXWIDTH ) SetMaxWidth(_ttoi(pstrValue));
+		else if( nAttr == DUIATTR_MAXHEIGHT ) SetMaxHeight(_ttoi(pstrValue));
+		else if( nAttr == DUIATTR_NAME ) SetName(pstrValue);
+		else if( nAttr == DUIATTR_DRAG ) SetDragEnable(_tcsicmp(pstrValue, _T("true")) == 0);
+		else if( nAttr == DUIATTR_DROP ) SetDropEnable(_tcsicmp(pstrValue, _T("true")) == 0);
+		else if( nAttr == DUIATTR_RESOURCETEXT ) SetResourceText(_tcsicmp(pstrValue, _T("true")) == 0);
+		else if( nAttr == DUIATTR_TEXT ) SetText(pstrValue);
+		else if( nAttr == DUIATTR_TOOLTIP ) SetToolTip(pstrValue);
+		else if( nAttr == DUIATTR_USERDATA ) SetUserData(pstrValue);
+		else if( nAttr == DUIATTR_ENABLED ) SetEnabled(_tcsicmp(pstrValue, _T("true")) == 0);
+		else if( nAttr == DUIATTR_MOUSE ) SetMouseEnabled(_tcsicmp(pstrValue, _T("true")) == 0);
+		else if( nAttr == DUIATTR_KEYBOARD ) SetKeyboardEnabled(_tcsicmp(pstrValue, _T("true")) == 0);
+		else if( nAttr == DUIATTR_VISIBLE ) SetVisible(_tcsicmp(pstrValue, _T("true")) == 0);
+		else if( nAttr == DUIATTR_FLOAT ) SetFloat(_tcsicmp(pstrValue, _T("true")) == 0);
+		else if( nAttr == DUIATTR_SHORTCUT ) SetShortcut(pstrValue[0]);
+		else if( nAttr == DUIATTR_MENU ) SetContextMenuUsed(_tcsicmp(pstrValue, _T("true")) == 0);
+		else if( nAttr == DUIATTR_CURSOR && pstrValue) {
 			if( _tcsicmp(pstrValue, _T("arrow")) == 0 )			SetCursor(DUI_ARROW);
 			else if( _tcsicmp(pstrValue, _T("ibeam")) == 0 )	SetCursor(DUI_IBEAM);
 			else if( _tcsicmp(pstrValue, _T("wait")) == 0 )		SetCursor(DUI_WAIT);
@@ -1113,8 +1238,8 @@ namespace DuiLib {
 			else if( _tcsicmp(pstrValue, _T("no")) == 0 )		SetCursor(DUI_NO);
 			else if( _tcsicmp(pstrValue, _T("hand")) == 0 )		SetCursor(DUI_HAND);
 		}
-		else if( _tcsicmp(pstrName, _T("virtualwnd")) == 0 ) SetVirtualWnd(pstrValue);
-		else if( _tcsicmp(pstrName, _T("innerstyle")) == 0 ) {
+		else if( nAttr == DUIATTR_VIRTUALWND ) SetVirtualWnd(pstrValue);
+		else if( nAttr == DUIATTR_INNERSTYLE ) {
 			CDuiString sXmlData = pstrValue;
 			sXmlData.Replace(_T("&quot;"), _T("\""));
 			LPCTSTR pstrList = sXmlData.GetData();
@@ -177,7 +177,11 @@ namespace DuiLib {
 		bool RemoveCustomAttribute(LPCTSTR pstrName);
 		void RemoveAllCustomAttribute();
 
+		// DUI_ATTRIBUTE_LISTеıʶδǼǵDUIATTR_UNKNOWN
+		static int GetAttributeId(LPCTSTR pstrName);
 		virtual void SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue);
+		// SetAttributeֻһαʶnAttrԭ
+		virtual void SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue);
 		CControlUI* ApplyAttributeList(LPCTSTR pstrList);
 
 		virtual SIZE EstimateSize(SIZE szAvailable);
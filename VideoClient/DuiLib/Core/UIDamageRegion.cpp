@@ -0,0 +1,123 @@
+#include "StdAfx.h"
+
+namespace DuiLib {
+
+	/////////////////////////////////////////////////////////////////////////////////////
+	//
+	//
+
+	static int RectArea(const RECT& rc)
+	{
+		return (rc.right - rc.left) * (rc.bottom - rc.top);
+	}
+
+	// what painting the union paints that painting both wouldn't
+	static int MergeWaste(const RECT& a, const RECT& b)
+	{
+		RECT rcUnion = { 0 };
+		RECT rcOverlap = { 0 };
+		::UnionRect(&rcUnion, &a, &b);
+		::IntersectRect(&rcOverlap, &a, &b);
+		return RectArea(rcUnion) - RectArea(a) - RectArea(b) + RectArea(rcOverlap);
+	}
+
+	CDamageRegion::CDamageRegion()
+	{
+	}
+
+	void CDamageRegion::Add(const RECT& rc)
+	{
+		if( ::IsRectEmpty(&rc) ) return;
+		RECT rcNew = rc;
+		// whatever rcNew takes in grows it, which can make an earlier rect worth taking too
+		for( size_t i = 0; i < m_aRects.size(); ) {
+			if( MergeWaste(m_aRects[i], rcNew) <= RECT_COST ) {
+				::UnionRect(&rcNew, &rcNew, &m_aRects[i]);
+				m_aRects.erase(m_aRects.begin() + i);
+				i = 0;
+			}
+			else i++;
+		}
+		m_aRects.push_back(rcNew);
+		while( (int)m_aRects.size() > MAX_RECTS ) MergeCheapest();
+		// rects that overlap without being worth folding pairwise can add up to more than one
+		// rect around them all
+		if( m_aRects.size() > 1 ) {
+			RECT rcBounds = GetBounds();
+			if( RectArea(rcBounds) + RECT_COST <= (int)GetArea() + (int)m_aRects.size() * RECT_COST ) {
+				m_aRects.clear();
+				m_aRects.push_back(rcBounds);
+			}
+		}
+	}
+
+	void CDamageRegion::Clip(const RECT& rcClip)
+	{
+		for( size_t i = 0; i < m_aRects.size(); ) {
+			if( !::IntersectRect(&m_aRects[i], &m_aRects[i], &rcClip) ) m_aRects.erase(m_aRects.begin() + i);
+			else i++;
+		}
+	}
+
+	void CDamageRegion::RemoveAll()
+	{
+		m_aRects.clear();
+	}
+
+	bool CDamageRegion::IsEmpty() const
+	{
+		return m_aRects.empty();
+	}
+
+	int CDamageRegion::GetCount() const
+	{
+		return (int)m_aRects.size();
+	}
+
+	const RECT& CDamageRegion::GetAt(int iIndex) const
+	{
+		return m_aRects[iIndex];
+	}
+
+	RECT CDamageRegion::GetBounds() const
+	{
+		RECT rcBounds = { 0 };
+		for( size_t i = 0; i < m_aRects.size(); i++ ) ::UnionRect(&rcBounds, &rcBounds, &m_aRects[i]);
+		return rcBounds;
+	}
+
+	bool CDamageRegion::Intersects(const RECT& rc) const
+	{
+		RECT rcTemp = { 0 };
+		for( size_t i = 0; i < m_aRects.size(); i++ ) {
+			if( ::IntersectRect(&rcTemp, &rc, &m_aRects[i]) ) return true;
+		}
+		return false;
+	}
+
+	DWORD CDamageRegion::GetArea() const
+	{
+		DWORD dwArea = 0;
+		for( size_t i = 0; i < m_aRects.size(); i++ ) dwArea += (DWORD)RectArea(m_aRects[i]);
+		return dwArea;
+	}
+
+	void CDamageRegion::MergeCheapest()
+	{
+		size_t iBest = 0, jBest = 1;
+		int iBestWaste = MergeWaste(m_aRects[0], m_aRects[1]);
+		for( size_t i = 0; i < m_aRects.size(); i++ ) {
+			for( size_t j = i + 1; j < m_aRects.size(); j++ ) {
+				int iWaste = MergeWaste(m_aRects[i], m_aRects[j]);
+				if( iWaste < iBestWaste ) {
+					iBestWaste = iWaste;
+					iBest = i;
+					jBest = j;
+				}
+			}
+		}
+		::UnionRect(&m_aRects[iBest], &m_aRects[iBest], &m_aRects[jBest]);
+		m_aRects.erase(m_aRects.begin() + jBest);
+	}
+
+} // namespace DuiLib
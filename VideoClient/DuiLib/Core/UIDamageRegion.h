@@ -0,0 +1,55 @@
+#ifndef __UIDAMAGEREGION_H__
+#define __UIDAMAGEREGION_H__
+
+#pragma once
+#include <vector>
+
+namespace DuiLib {
+	/////////////////////////////////////////////////////////////////////////////////////
+	//
+	// What has to be painted in the next WM_PAINT, as a few rects rather than one box around
+	// all of them, so two small changes in opposite corners don't repaint the window.
+	//
+	// Every rect painted costs a walk of the tree and a blit on top of its pixels. Add folds
+	// a rect into another when painting their union costs less than painting both and paying
+	// that once more, and past MAX_RECTS folds whichever two waste the least. Rects may still
+	// overlap; the overlap is just painted twice, but never so much that one rect around them
+	// all would cost less.
+
+	typedef struct tagTPaintStats
+	{
+		DWORD dwFrames;
+		int nRects;             // of the last frame
+		DWORD dwPixels;         // painted in the last frame
+		DWORD dwBoundsPixels;   // what one rect around them all would have painted
+	} TPaintStats;
+
+	class CDamageRegion
+	{
+	public:
+		enum { MAX_RECTS = 8 };
+		// one more rect, counted in pixels
+		enum { RECT_COST = 64 * 64 };
+
+		CDamageRegion();
+
+		void Add(const RECT& rc);
+		void Clip(const RECT& rcClip);
+		void RemoveAll();
+		bool IsEmpty() const;
+		int GetCount() const;
+		const RECT& GetAt(int iIndex) const;
+		RECT GetBounds() const;
+		bool Intersects(const RECT& rc) const;
+		// counting overlaps twice, as they are painted
+		DWORD GetArea() const;
+
+	private:
+		void MergeCheapest();
+
+		std::vector<RECT> m_aRects;
+	};
+
+} // namespace DuiLib
+
+#endif // __UIDAMAGEREGION_H__
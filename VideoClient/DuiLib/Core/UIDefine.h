@@ -4,6 +4,7 @@ namespace DuiLib
 {
 #define MAX_FONT_ID		30000
 #define CARET_TIMERID	0x1999
+#define CLOCK_TIMERID	0x199A
 
 	// б
 	enum ListType
@@ -315,5 +316,248 @@ protected:                                                                \
 	///
 	//////////////ENDؼƺ궨//////////////////////////////////////////////////
 
+	///
+	//////////////SetAttribute///////////////////////////////////////
+	// ÿΪ X(ʶ, )СдCControlUI::SetAttributeʶؼSetAttributeById֧
+	// ǼǣδǼǵõDUIATTR_UNKNOWN
+#define DUI_ATTRIBUTE_LIST(X) \
+	X(ALIGN, "align") \
+	X(ANIMATION_DIRECTION, "animation_direction") \
+	X(ARROWIMAGE, "arrowimage") \
+	X(AUTO, "auto") \
+	X(AUTOCALCWIDTH, "autocalcwidth") \
+	X(AUTOHSCROLL, "autohscroll") \
+	X(AUTONAVI, "autonavi") \
+	X(AUTOPLAY, "autoplay") \
+	X(AUTOSIZE, "autosize") \
+	X(AUTOVSCROLL, "autovscroll") \
+	X(BARHEIGHT, "barheight") \
+	X(BINDTABINDEX, "bindtabindex") \
+	X(BINDTABLAYOUTNAME, "bindtablayoutname") \
+	X(BKCOLOR, "bkcolor") \
+	X(BKCOLOR1, "bkcolor1") \
+	X(BKCOLOR2, "bkcolor2") \
+	X(BKCOLOR3, "bkcolor3") \
+	X(BKDISABLEDIMAGE, "bkdisabledimage") \
+	X(BKHOTIMAGE, "bkhotimage") \
+	X(BKIMAGE, "bkimage") \
+	X(BKNORMALIMAGE, "bknormalimage") \
+	X(BKPUSHEDIMAGE, "bkpushedimage") \
+	X(BORDERCOLOR, "bordercolor") \
+	X(BORDERROUND, "borderround") \
+	X(BORDERSIZE, "bordersize") \
+	X(BORDERSTYLE, "borderstyle") \
+	X(BOTTOMBORDERSIZE, "bottombordersize") \
+	X(BUTTON1DISABLEDIMAGE, "button1disabledimage") \
+	X(BUTTON1HOTIMAGE, "button1hotimage") \
+	X(BUTTON1NORMALIMAGE, "button1normalimage") \
+	X(BUTTON1PUSHEDIMAGE, "button1pushedimage") \
+	X(BUTTON2DISABLEDIMAGE, "button2disabledimage") \
+	X(BUTTON2HOTIMAGE, "button2hotimage") \
+	X(BUTTON2NORMALIMAGE, "button2normalimage") \
+	X(BUTTON2PUSHEDIMAGE, "button2pushedimage") \
+	X(CHECKABLE, "checkable") \
+	X(CHECKBOXATTR, "checkboxattr") \
+	X(CHECKBOXDISABLEDIMAGE, "checkboxdisabledimage") \
+	X(CHECKBOXFOCUSEDIMAGE, "checkboxfocusedimage") \
+	X(CHECKBOXFOREIMAGE, "checkboxforeimage") \
+	X(CHECKBOXHEIGHT, "checkboxheight") \
+	X(CHECKBOXHOTIMAGE, "checkboxhotimage") \
+	X(CHECKBOXNORMALIMAGE, "checkboxnormalimage") \
+	X(CHECKBOXPUSHEDIMAGE, "checkboxpushedimage") \
+	X(CHECKBOXSELECTEDIMAGE, "checkboxselectedimage") \
+	X(CHECKBOXWIDTH, "checkboxwidth") \
+	X(CHECKITEM, "checkitem") \
+	X(CHILDALIGN, "childalign") \
+	X(CHILDPADDING, "childpadding") \
+	X(CHILDVALIGN, "childvalign") \
+	X(CLSID, "clsid") \
+	X(COLORHSL, "colorhsl") \
+	X(COLUMNS, "columns") \
+	X(COMBOABLE, "comboable") \
+	X(CURSOR, "cursor") \
+	X(DELAYCREATE, "delaycreate") \
+	X(DISABLEDIMAGE, "disabledimage") \
+	X(DISABLEDTEXTCOLOR, "disabledtextcolor") \
+	X(DOTLINEATTR, "dotlineattr") \
+	X(DRAG, "drag") \
+	X(DRAGABLE, "dragable") \
+	X(DROP, "drop") \
+	X(DROPBOX, "dropbox") \
+	X(DROPBOXSIZE, "dropboxsize") \
+	X(EDITABLE, "editable") \
+	X(ENABLEAUTOCHECK, "enableautocheck") \
+	X(ENABLED, "enabled") \
+	X(ENDELLIPSIS, "endellipsis") \
+	X(EXPLAND, "expland") \
+	X(FIXEDSCROLLBAR, "fixedscrollbar") \
+	X(FLOAT, "float") \
+	X(FLOATALIGN, "floatalign") \
+	X(FOCUSBORDERCOLOR, "focusbordercolor") \
+	X(FOCUSEDIMAGE, "focusedimage") \
+	X(FOCUSEDTEXTCOLOR, "focusedtextcolor") \
+	X(FOLDERATTR, "folderattr") \
+	X(FONT, "font") \
+	X(FORECOLOR, "forecolor") \
+	X(FOREIMAGE, "foreimage") \
+	X(GRADIENT, "gradient") \
+	X(GROUP, "group") \
+	X(HEADER, "header") \
+	X(HEADERBKIMAGE, "headerbkimage") \
+	X(HEIGHT, "height") \
+	X(HOMEPAGE, "homepage") \
+	X(HOR, "hor") \
+	X(HORIZATTR, "horizattr") \
+	X(HOTBKCOLOR, "hotbkcolor") \
+	X(HOTFOREIMAGE, "hotforeimage") \
+	X(HOTIMAGE, "hotimage") \
+	X(HOTTEXTCOLOR, "hottextcolor") \
+	X(HSCROLLBAR, "hscrollbar") \
+	X(HSCROLLBARSTYLE, "hscrollbarstyle") \
+	X(ICON, "icon") \
+	X(ICONSIZE, "iconsize") \
+	X(INNERSTYLE, "innerstyle") \
+	X(INSET, "inset") \
+	X(ISCHECK, "ischeck") \
+	X(ISSTRETCHFORE, "isstretchfore") \
+	X(ITEMALIGN, "itemalign") \
+	X(ITEMALTBK, "itemaltbk") \
+	X(ITEMATTR, "itemattr") \
+	X(ITEMBKCOLOR, "itembkcolor") \
+	X(ITEMBKIMAGE, "itembkimage") \
+	X(ITEMDISABLEDBKCOLOR, "itemdisabledbkcolor") \
+	X(ITEMDISABLEDIMAGE, "itemdisabledimage") \
+	X(ITEMDISABLEDTEXTCOLOR, "itemdisabledtextcolor") \
+	X(ITEMENDELLIPSIS, "itemendellipsis") \
+	X(ITEMFONT, "itemfont") \
+	X(ITEMHOTBKCOLOR, "itemhotbkcolor") \
+	X(ITEMHOTIMAGE, "itemhotimage") \
+	X(ITEMHOTTEXTCOLOR, "itemhottextcolor") \
+	X(ITEMLINECOLOR, "itemlinecolor") \
+	X(ITEMMINWIDTH, "itemminwidth") \
+	X(ITEMRSELECTED, "itemrselected") \
+	X(ITEMSELECTEDBKCOLOR, "itemselectedbkcolor") \
+	X(ITEMSELECTEDIMAGE, "itemselectedimage") \
+	X(ITEMSELECTEDTEXTCOLOR, "itemselectedtextcolor") \
+	X(ITEMSHOWCOLUMNLINE, "itemshowcolumnline") \
+	X(ITEMSHOWHTML, "itemshowhtml") \
+	X(ITEMSHOWROWLINE, "itemshowrowline") \
+	X(ITEMSIZE, "itemsize") \
+	X(ITEMTEXTCOLOR, "itemtextcolor") \
+	X(ITEMTEXTPADDING, "itemtextpadding") \
+	X(ITEMVALIGN, "itemvalign") \
+	X(KEYBOARD, "keyboard") \
+	X(LEFTBORDERSIZE, "leftbordersize") \
+	X(LINECOLOR, "linecolor") \
+	X(LINEPADDING, "linepadding") \
+	X(LINESIZE, "linesize") \
+	X(LINETYPE, "linetype") \
+	X(MAX, "max") \
+	X(MAXCHAR, "maxchar") \
+	X(MAXHEIGHT, "maxheight") \
+	X(MAXWIDTH, "maxwidth") \
+	X(MENU, "menu") \
+	X(MFC, "mfc") \
+	X(MIN, "min") \
+	X(MINHEIGHT, "minheight") \
+	X(MINWIDTH, "minwidth") \
+	X(MODULENAME, "modulename") \
+	X(MOUSE, "mouse") \
+	X(MOUSECHILD, "mousechild") \
+	X(MULTIEXPANDING, "multiexpanding") \
+	X(MULTILINE, "multiline") \
+	X(MULTISELECT, "multiselect") \
+	X(NAME, "name") \
+	X(NATIVEBKCOLOR, "nativebkcolor") \
+	X(NATIVETEXTCOLOR, "nativetextcolor") \
+	X(NOPREFIX, "noprefix") \
+	X(NORMALIMAGE, "normalimage") \
+	X(NUMBERONLY, "numberonly") \
+	X(PADDING, "padding") \
+	X(PALLETHEIGHT, "palletheight") \
+	X(PASSWORD, "password") \
+	X(PASSWORDCHAR, "passwordchar") \
+	X(POS, "pos") \
+	X(PUSHEDBKCOLOR, "pushedbkcolor") \
+	X(PUSHEDIMAGE, "pushedimage") \
+	X(PUSHEDTEXTCOLOR, "pushedtextcolor") \
+	X(RAILDISABLEDIMAGE, "raildisabledimage") \
+	X(RAILHOTIMAGE, "railhotimage") \
+	X(RAILNORMALIMAGE, "railnormalimage") \
+	X(RAILPUSHEDIMAGE, "railpushedimage") \
+	X(RANGE, "range") \
+	X(READONLY, "readonly") \
+	X(RESOURCETEXT, "resourcetext") \
+	X(RICH, "rich") \
+	X(RIGHTBORDERSIZE, "rightbordersize") \
+	X(SCALE, "scale") \
+	X(SCALEHEADER, "scaleheader") \
+	X(SCROLLSELECT, "scrollselect") \
+	X(SCROLLSTEPSIZE, "scrollstepsize") \
+	X(SELECTED, "selected") \
+	X(SELECTEDBKCOLOR, "selectedbkcolor") \
+	X(SELECTEDFOREIMAGE, "selectedforeimage") \
+	X(SELECTEDHOTIMAGE, "selectedhotimage") \
+	X(SELECTEDID, "selectedid") \
+	X(SELECTEDIMAGE, "selectedimage") \
+	X(SELECTEDPUSHEDIMAGE, "selectedpushedimage") \
+	X(SELECTEDSTATECOUNT, "selectedstatecount") \
+	X(SELECTEDSTATEIMAGE, "selectedstateimage") \
+	X(SELECTEDTEXTCOLOR, "selectedtextcolor") \
+	X(SELITEMHOTTEXTCOLOR, "selitemhottextcolor") \
+	X(SELITEMTEXTCOLOR, "selitemtextcolor") \
+	X(SENDMOVE, "sendmove") \
+	X(SEPHEIGHT, "sepheight") \
+	X(SEPIMAGE, "sepimage") \
+	X(SEPIMM, "sepimm") \
+	X(SEPWIDTH, "sepwidth") \
+	X(SHORTCUT, "shortcut") \
+	X(SHOWBUTTON1, "showbutton1") \
+	X(SHOWBUTTON2, "showbutton2") \
+	X(SHOWHTML, "showhtml") \
+	X(SHOWSHADOW, "showshadow") \
+	X(STATECOUNT, "statecount") \
+	X(STATEIMAGE, "stateimage") \
+	X(STATUSIMAGE, "statusimage") \
+	X(STEP, "step") \
+	X(TEXT, "text") \
+	X(TEXTCOLOR, "textcolor") \
+	X(TEXTPADDING, "textpadding") \
+	X(THUMBDISABLEDIMAGE, "thumbdisabledimage") \
+	X(THUMBHOTIMAGE, "thumbhotimage") \
+	X(THUMBIMAGE, "thumbimage") \
+	X(THUMBNORMALIMAGE, "thumbnormalimage") \
+	X(THUMBPUSHEDIMAGE, "thumbpushedimage") \
+	X(THUMBSIZE, "thumbsize") \
+	X(TIPVALUE, "tipvalue") \
+	X(TIPVALUEALIGN, "tipvaluealign") \
+	X(TIPVALUECOLOR, "tipvaluecolor") \
+	X(TOOLTIP, "tooltip") \
+	X(TOPBORDERSIZE, "topbordersize") \
+	X(USERDATA, "userdata") \
+	X(VALIGN, "valign") \
+	X(VALUE, "value") \
+	X(VIRTUALWND, "virtualwnd") \
+	X(VISIBLE, "visible") \
+	X(VISIBLECHECKBTN, "visiblecheckbtn") \
+	X(VISIBLEFOLDERBTN, "visiblefolderbtn") \
+	X(VSCROLLBAR, "vscrollbar") \
+	X(VSCROLLBARSTYLE, "vscrollbarstyle") \
+	X(WANTCTRLRETURN, "wantctrlreturn") \
+	X(WANTRETURN, "wantreturn") \
+	X(WANTTAB, "wanttab") \
+	X(WIDTH, "width") \
+	X(WORDBREAK, "wordbreak") \
+	X(XMLFILE, "xmlfile")
+
+	enum DuiAttribute
+	{
+		DUIATTR_UNKNOWN = 0,
+#define DUI_ATTRIBUTE_ENUM(id, name) DUIATTR_##id,
+		DUI_ATTRIBUTE_LIST(DUI_ATTRIBUTE_ENUM)
+#undef DUI_ATTRIBUTE_ENUM
+		DUIATTR_COUNT
+	};
+
 	}// namespace DuiLib
 
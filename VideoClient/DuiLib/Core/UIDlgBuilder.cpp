@@ -2,11 +2,64 @@
 
 namespace DuiLib {
 
-	CDialogBuilder::CDialogBuilder() : m_pCallback(NULL), m_pstrtype(NULL)
+	CStdStringPtrMap CDialogBuilder::m_mTemplates;
+
+	enum
+	{
+		BUILDER_CONTROL = 0,
+		BUILDER_SKIP,		// Image, Font, Default, Style and Import, Create handled them
+		BUILDER_INCLUDE,
+	};
+
+	static int _GetClassKind(LPCTSTR pstrClass)
+	{
+		if( _tcsicmp(pstrClass, _T("Image")) == 0 || _tcsicmp(pstrClass, _T("Font")) == 0 \
+			|| _tcsicmp(pstrClass, _T("Default")) == 0 || _tcsicmp(pstrClass, _T("Style")) == 0 \
+			|| _tcsicmp(pstrClass, _T("Import")) == 0 ) return BUILDER_SKIP;
+		if( _tcsicmp(pstrClass, _T("Include")) == 0 ) return BUILDER_INCLUDE;
+		return BUILDER_CONTROL;
+	}
+
+	// The numbers of a Window attribute, as a compiled skin parsed them or parsed from the text
+	static void _GetNumbers(CMarkupNode& node, int iIndex, LONG* pNumbers, int nCount)
+	{
+		if( node.GetAttributeType(iIndex) == XMLVALUE_INT && node.GetAttributeNumbers(iIndex, pNumbers, nCount) == nCount ) return;
+		LPCTSTR pstrValue = node.GetAttributeValue(iIndex);
+		LPTSTR pstr = NULL;
+		for( int i = 0; i < nCount; i++ ) {
+			pNumbers[i] = _tcstol(pstrValue, &pstr, 10); ASSERT(pstr);
+			pstrValue = *pstr != _T('\0') ? pstr + 1 : pstr;
+		}
+	}
+
+	static DWORD _GetColor(CMarkupNode& node, int iIndex)
+	{
+		LONG nColor = 0;
+		if( node.GetAttributeType(iIndex) == XMLVALUE_COLOR && node.GetAttributeNumbers(iIndex, &nColor, 1) == 1 ) return (DWORD)nColor;
+		LPCTSTR pstrValue = node.GetAttributeValue(iIndex);
+		if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
+		LPTSTR pstr = NULL;
+		return _tcstoul(pstrValue, &pstr, 16);
+	}
+
+	CDialogBuilder::CDialogBuilder() : m_pCallback(NULL), m_pstrtype(NULL), m_pMarkup(&m_xml), m_pClasses(NULL), m_nClasses(0)
 	{
 		m_instance = NULL;
 	}
 
+	CDialogBuilder::~CDialogBuilder()
+	{
+		if( m_pClasses != NULL ) free(m_pClasses);
+	}
+
+	void CDialogBuilder::ClearTemplateCache()
+	{
+		for( int i = 0; i < m_mTemplates.GetSize(); i++ ) {
+			if( LPCTSTR key = m_mTemplates.GetAt(i) ) delete static_cast<CMarkup*>(m_mTemplates.Find(key));
+		}
+		m_mTemplates.RemoveAll();
+	}
+
 	CControlUI* CDialogBuilder::Create(STRINGorID xml, LPCTSTR type, IDialogBuilderCallback* pCallback, 
 		CPaintManagerUI* pManager, CControlUI* pParent)
 	{
@@ -19,6 +72,29 @@ namespace DuiLib {
 			}
 		}
 
+		HINSTANCE dll_instence = m_instance != NULL ? m_instance : CPaintManagerUI::GetResourceDll();
+		CDuiString sKey;
+		if( HIWORD(xml.m_lpstr) == NULL ) {
+			if( HIWORD(type) != NULL ) sKey.Format(_T("#%p|%u|%s"), dll_instence, LOWORD(xml.m_lpstr), type);
+			else sKey.Format(_T("#%p|%u|#%u"), dll_instence, LOWORD(xml.m_lpstr), LOWORD(type));
+		}
+		else if( *(xml.m_lpstr) != _T('<') ) {
+			sKey = CPaintManagerUI::GetResourcePath();
+			sKey += _T('|');
+			sKey += CPaintManagerUI::GetResourceZip();
+			sKey += _T('|');
+			sKey += xml.m_lpstr;
+		}
+		if( !sKey.IsEmpty() ) {
+			CMarkup* pTemplate = static_cast<CMarkup*>(m_mTemplates.Find(sKey));
+			if( pTemplate != NULL ) {
+				m_pMarkup = pTemplate;
+				if( HIWORD(xml.m_lpstr) == NULL ) m_pstrtype = type;
+				return Create(pCallback, pManager, pParent);
+			}
+		}
+		m_pMarkup = &m_xml;
+
 		if( HIWORD(xml.m_lpstr) != NULL ) {
 			if( *(xml.m_lpstr) == _T('<') ) {
 				if( !m_xml.Load(xml.m_lpstr) ) return NULL;
@@ -28,15 +104,6 @@ namespace DuiLib {
 			}
 		}
 		else {
-			HINSTANCE dll_instence = NULL;
-			if (m_instance)
-			{
-				dll_instence = m_instance;
-			}
-			else
-			{
-				dll_instence = CPaintManagerUI::GetResourceDll();
-			}
 			HRSRC hResource = ::FindResource(dll_instence, xml.m_lpstr, type);
 			if( hResource == NULL ) return NULL;
 			HGLOBAL hGlobal = ::LoadResource(dll_instence, hResource);
@@ -51,13 +118,20 @@ namespace DuiLib {
 			m_pstrtype = type;
 		}
 
+		if( !sKey.IsEmpty() ) {
+			CMarkup* pTemplate = new CMarkup;
+			pTemplate->Swap(m_xml);
+			pTemplate->IndexAttributes();
+			m_mTemplates.Insert(sKey, pTemplate);
+			m_pMarkup = pTemplate;
+		}
 		return Create(pCallback, pManager, pParent);
 	}
 
 	CControlUI* CDialogBuilder::Create(IDialogBuilderCallback* pCallback, CPaintManagerUI* pManager, CControlUI* pParent)
 	{
 		m_pCallback = pCallback;
-		CMarkupNode root = m_xml.GetRoot();
+		CMarkupNode root = m_pMarkup->GetRoot();
 		if( !root.IsValid() ) return NULL;
 
 		if( pManager ) {
@@ -204,46 +278,36 @@ namespace DuiLib {
 						pstrName = root.GetAttributeName(i);
 						pstrValue = root.GetAttributeValue(i);
 						if( _tcsicmp(pstrName, _T("size")) == 0 ) {
-							LPTSTR pstr = NULL;
-							int cx = _tcstol(pstrValue, &pstr, 10);  ASSERT(pstr);    
-							int cy = _tcstol(pstr + 1, &pstr, 10);    ASSERT(pstr); 
-							pManager->SetInitSize(pManager->GetDPIObj()->Scale(cx), pManager->GetDPIObj()->Scale(cy));
+							LONG aSize[2];
+							_GetNumbers(root, i, aSize, 2);
+							pManager->SetInitSize(pManager->GetDPIObj()->Scale(aSize[0]), pManager->GetDPIObj()->Scale(aSize[1]));
 						} 
 						else if( _tcsicmp(pstrName, _T("sizebox")) == 0 ) {
-							RECT rcSizeBox = { 0 };
-							LPTSTR pstr = NULL;
-							rcSizeBox.left = _tcstol(pstrValue, &pstr, 10);  ASSERT(pstr);    
-							rcSizeBox.top = _tcstol(pstr + 1, &pstr, 10);    ASSERT(pstr);    
-							rcSizeBox.right = _tcstol(pstr + 1, &pstr, 10);  ASSERT(pstr);    
-							rcSizeBox.bottom = _tcstol(pstr + 1, &pstr, 10); ASSERT(pstr);    
+							LONG aRect[4];
+							_GetNumbers(root, i, aRect, 4);
+							RECT rcSizeBox = { aRect[0], aRect[1], aRect[2], aRect[3] };
 							pManager->SetSizeBox(rcSizeBox);
 						}
 						else if( _tcsicmp(pstrName, _T("caption")) == 0 ) {
-							RECT rcCaption = { 0 };
-							LPTSTR pstr = NULL;
-							rcCaption.left = _tcstol(pstrValue, &pstr, 10);  ASSERT(pstr);    
-							rcCaption.top = _tcstol(pstr + 1, &pstr, 10);    ASSERT(pstr);    
-							rcCaption.right = _tcstol(pstr + 1, &pstr, 10);  ASSERT(pstr);    
-							rcCaption.bottom = _tcstol(pstr + 1, &pstr, 10); ASSERT(pstr);    
+							LONG aRect[4];
+							_GetNumbers(root, i, aRect, 4);
+							RECT rcCaption = { aRect[0], aRect[1], aRect[2], aRect[3] };
 							pManager->SetCaptionRect(rcCaption);
 						}
 						else if( _tcsicmp(pstrName, _T("roundcorner")) == 0 ) {
-							LPTSTR pstr = NULL;
-							int cx = _tcstol(pstrValue, &pstr, 10);  ASSERT(pstr);    
-							int cy = _tcstol(pstr + 1, &pstr, 10);    ASSERT(pstr); 
-							pManager->SetRoundCorner(cx, cy);
+							LONG aSize[2];
+							_GetNumbers(root, i, aSize, 2);
+							pManager->SetRoundCorner(aSize[0], aSize[1]);
 						} 
 						else if( _tcsicmp(pstrName, _T("mininfo")) == 0 ) {
-							LPTSTR pstr = NULL;
-							int cx = _tcstol(pstrValue, &pstr, 10);  ASSERT(pstr);    
-							int cy = _tcstol(pstr + 1, &pstr, 10);    ASSERT(pstr); 
-							pManager->SetMinInfo(cx, cy);
+							LONG aSize[2];
+							_GetNumbers(root, i, aSize, 2);
+							pManager->SetMinInfo(aSize[0], aSize[1]);
 						}
 						else if( _tcsicmp(pstrName, _T("maxinfo")) == 0 ) {
-							LPTSTR pstr = NULL;
-							int cx = _tcstol(pstrValue, &pstr, 10);  ASSERT(pstr);    
-							int cy = _tcstol(pstr + 1, &pstr, 10);    ASSERT(pstr); 
-							pManager->SetMaxInfo(cx, cy);
+							LONG aSize[2];
+							_GetNumbers(root, i, aSize, 2);
+							pManager->SetMaxInfo(aSize[0], aSize[1]);
 						}
 						else if( _tcsicmp(pstrName, _T("showdirty")) == 0 ) {
 							pManager->SetShowUpdateRect(_tcsicmp(pstrValue, _T("true")) == 0);
@@ -258,34 +322,19 @@ namespace DuiLib {
 							pManager->SetLayered(_tcsicmp(pstrValue, _T("true")) == 0);
 						}
 						else if( _tcsicmp(pstrName, _T("disabledfontcolor")) == 0 ) {
-							if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
-							LPTSTR pstr = NULL;
-							DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
-							pManager->SetDefaultDisabledColor(clrColor);
+							pManager->SetDefaultDisabledColor(_GetColor(root, i));
 						} 
 						else if( _tcsicmp(pstrName, _T("defaultfontcolor")) == 0 ) {
-							if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
-							LPTSTR pstr = NULL;
-							DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
-							pManager->SetDefaultFontColor(clrColor);
+							pManager->SetDefaultFontColor(_GetColor(root, i));
 						}
 						else if( _tcsicmp(pstrName, _T("linkfontcolor")) == 0 ) {
-							if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
-							LPTSTR pstr = NULL;
-							DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
-							pManager->SetDefaultLinkFontColor(clrColor);
+							pManager->SetDefaultLinkFontColor(_GetColor(root, i));
 						} 
 						else if( _tcsicmp(pstrName, _T("linkhoverfontcolor")) == 0 ) {
-							if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
-							LPTSTR pstr = NULL;
-							DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
-							pManager->SetDefaultLinkHoverFontColor(clrColor);
+							pManager->SetDefaultLinkHoverFontColor(_GetColor(root, i));
 						} 
 						else if( _tcsicmp(pstrName, _T("selectedcolor")) == 0 ) {
-							if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
-							LPTSTR pstr = NULL;
-							DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
-							pManager->SetDefaultSelectedBkColor(clrColor);
+							pManager->SetDefaultSelectedBkColor(_GetColor(root, i));
 						} 
 						else if( _tcsicmp(pstrName, _T("shadowsize")) == 0 ) {
 							pManager->GetShadow()->SetSize(_ttoi(pstrValue));
@@ -297,24 +346,17 @@ namespace DuiLib {
 							pManager->GetShadow()->SetDarkness(_ttoi(pstrValue));
 						}
 						else if( _tcsicmp(pstrName, _T("shadowposition")) == 0 ) {
-							LPTSTR pstr = NULL;
-							int cx = _tcstol(pstrValue, &pstr, 10);  ASSERT(pstr);    
-							int cy = _tcstol(pstr + 1, &pstr, 10);    ASSERT(pstr); 
-							pManager->GetShadow()->SetPosition(cx, cy);
+							LONG aSize[2];
+							_GetNumbers(root, i, aSize, 2);
+							pManager->GetShadow()->SetPosition(aSize[0], aSize[1]);
 						}
 						else if( _tcsicmp(pstrName, _T("shadowcolor")) == 0 ) {
-							if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
-							LPTSTR pstr = NULL;
-							DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
-							pManager->GetShadow()->SetColor(clrColor);
+							pManager->GetShadow()->SetColor(_GetColor(root, i));
 						}
 						else if( _tcsicmp(pstrName, _T("shadowcorner")) == 0 ) {
-							RECT rcCorner = { 0 };
-							LPTSTR pstr = NULL;
-							rcCorner.left = _tcstol(pstrValue, &pstr, 10);  ASSERT(pstr);    
-							rcCorner.top = _tcstol(pstr + 1, &pstr, 10);    ASSERT(pstr);    
-							rcCorner.right = _tcstol(pstr + 1, &pstr, 10);  ASSERT(pstr);    
-							rcCorner.bottom = _tcstol(pstr + 1, &pstr, 10); ASSERT(pstr);    
+							LONG aRect[4];
+							_GetNumbers(root, i, aRect, 4);
+							RECT rcCorner = { aRect[0], aRect[1], aRect[2], aRect[3] };
 							pManager->GetShadow()->SetShadowCorner(rcCorner);
 						}
 						else if( _tcsicmp(pstrName, _T("shadowimage")) == 0 ) {
@@ -336,12 +378,30 @@ namespace DuiLib {
 				}
 			}
 		}
+		_ResolveClasses();
 		return _Parse(&root, pParent, pManager);
 	}
 
+	void CDialogBuilder::_ResolveClasses()
+	{
+		m_nClasses = m_pMarkup->GetClassCount();
+		if( m_nClasses == 0 ) return;
+		m_pClasses = static_cast<TBuilderClass*>(realloc(m_pClasses, m_nClasses * sizeof(TBuilderClass)));
+		CDuiString strClass;
+		for( int i = 0; i < m_nClasses; i++ ) {
+			LPCTSTR pstrClass = m_pMarkup->GetClass(i);
+			m_pClasses[i].nKind = _GetClassKind(pstrClass);
+			m_pClasses[i].pfnCreate = NULL;
+			if( m_pClasses[i].nKind == BUILDER_CONTROL ) {
+				strClass.Format(_T("C%sUI"), pstrClass);
+				m_pClasses[i].pfnCreate = CControlFactory::GetInstance()->GetCreateClass(strClass);
+			}
+		}
+	}
+
 	CMarkup* CDialogBuilder::GetMarkup()
 	{
-		return &m_xml;
+		return m_pMarkup;
 	}
 
 	void CDialogBuilder::GetLastErrorMessage(LPTSTR pstrMessage, SIZE_T cchMax) const
@@ -360,12 +420,14 @@ namespace DuiLib {
 		CControlUI* pReturn = NULL;
 		for( CMarkupNode node = pRoot->GetChild() ; node.IsValid(); node = node.GetSibling() ) {
 			LPCTSTR pstrClass = node.GetName();
-			if( _tcsicmp(pstrClass, _T("Image")) == 0 || _tcsicmp(pstrClass, _T("Font")) == 0 \
-				|| _tcsicmp(pstrClass, _T("Default")) == 0 || _tcsicmp(pstrClass, _T("Style")) == 0 ) continue;
+			// The elements of a compiled skin come with their class, resolved in _ResolveClasses
+			int iClass = node.GetClassIndex();
+			const TBuilderClass* pClass = iClass >= 0 && iClass < m_nClasses ? &m_pClasses[iClass] : NULL;
+			int nKind = pClass != NULL ? pClass->nKind : _GetClassKind(pstrClass);
+			if( nKind == BUILDER_SKIP ) continue;
 
 			CControlUI* pControl = NULL;
-			if (_tcsicmp(pstrClass, _T("Import")) == 0) continue;
-			if( _tcsicmp(pstrClass, _T("Include")) == 0 ) {
+			if( nKind == BUILDER_INCLUDE ) {
 				if( !node.HasAttributes() ) continue;
 				int count = 1;
 				LPTSTR pstr = NULL;
@@ -388,9 +450,14 @@ namespace DuiLib {
 				continue;
 			}
 			else {
-				CDuiString strClass;
-				strClass.Format(_T("C%sUI"), pstrClass);
-				pControl = dynamic_cast<CControlUI*>(CControlFactory::GetInstance()->CreateControl(strClass));
+				if( pClass != NULL ) {
+					if( pClass->pfnCreate != NULL ) pControl = pClass->pfnCreate();
+				}
+				else {
+					CDuiString strClass;
+					strClass.Format(_T("C%sUI"), pstrClass);
+					pControl = dynamic_cast<CControlUI*>(CControlFactory::GetInstance()->CreateControl(strClass));
+				}
 
 				// 
 				if( pControl == NULL ) {
@@ -486,7 +553,10 @@ namespace DuiLib {
 				// Set ordinary attributes
 				int nAttributes = node.GetAttributeCount();
 				for( int i = 0; i < nAttributes; i++ ) {
-					pControl->SetAttribute(node.GetAttributeName(i), node.GetAttributeValue(i));
+					// A compiled skin carries the DUIATTR_* id, a text one has it looked up by name
+					int nAttr = node.GetAttributeId(i);
+					if( nAttr >= 0 ) pControl->SetAttributeById(nAttr, node.GetAttributeName(i), node.GetAttributeValue(i));
+					else pControl->SetAttribute(node.GetAttributeName(i), node.GetAttributeValue(i));
 				}
 			}
 			if( pManager ) {
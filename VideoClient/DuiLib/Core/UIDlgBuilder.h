@@ -16,6 +16,7 @@ namespace DuiLib {
 	{
 	public:
 		CDialogBuilder();
+		~CDialogBuilder();
 		CControlUI* Create(STRINGorID xml, LPCTSTR type = NULL, IDialogBuilderCallback* pCallback = NULL,
 			CPaintManagerUI* pManager = NULL, CControlUI* pParent = NULL);
 		CControlUI* Create(IDialogBuilderCallback* pCallback = NULL, CPaintManagerUI* pManager = NULL,
@@ -26,11 +27,30 @@ namespace DuiLib {
 		void GetLastErrorMessage(LPTSTR pstrMessage, SIZE_T cchMax) const;
 		void GetLastErrorLocation(LPTSTR pstrSource, SIZE_T cchMax) const;
 	    void SetInstance(HINSTANCE instance){ m_instance = instance;};
+
+		// Skins loaded from a file or a resource are parsed once and shared by every builder
+		// (UI thread only), so creating the same item again only builds the controls.
+		// Clear it when no builder is in use, e.g. after the skin files were replaced.
+		static void ClearTemplateCache();
+
 	private:
 		CControlUI* _Parse(CMarkupNode* parent, CControlUI* pParent = NULL, CPaintManagerUI* pManager = NULL);
+		void _ResolveClasses();
+
+		// What _Parse does with the elements of a class of a compiled skin (CMarkup::GetClass),
+		// looked up once per Create instead of once per element
+		typedef struct tagTBuilderClass
+		{
+			int nKind;
+			CreateClass pfnCreate;
+		} TBuilderClass;
 
+		static CStdStringPtrMap m_mTemplates;
 		CMarkup m_xml;
+		CMarkup* m_pMarkup; // m_xml, or the cached template
 		IDialogBuilderCallback* m_pCallback;
+		TBuilderClass* m_pClasses;
+		int m_nClasses;
 		LPCTSTR m_pstrtype;
     	HINSTANCE m_instance;
 	};
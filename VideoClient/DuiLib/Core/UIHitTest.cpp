@@ -0,0 +1,170 @@
+#include "StdAfx.h"
+
+namespace DuiLib {
+
+	// cells start at 64x64 and grow until a window needs no more than 4096 of them
+	#define HITTEST_CELL_SIZE	64
+	#define HITTEST_MAX_CELLS	4096
+
+	/////////////////////////////////////////////////////////////////////////////////////
+	//
+	//
+
+	CHitTestIndex::CHitTestIndex() :
+		m_pRoot(NULL),
+		m_uFlags(0),
+		m_nCellSize(HITTEST_CELL_SIZE),
+		m_nCols(0),
+		m_nRows(0),
+		m_nOrder(0),
+		m_bValid(false)
+	{
+		::ZeroMemory(&m_rcGrid, sizeof(m_rcGrid));
+	}
+
+	void CHitTestIndex::Invalidate()
+	{
+		m_bValid = false;
+	}
+
+	bool CHitTestIndex::IsValid() const
+	{
+		return m_bValid;
+	}
+
+	int CHitTestIndex::GetCount() const
+	{
+		return (int)m_aNodes.size();
+	}
+
+	CControlUI* CHitTestIndex::Find(CControlUI* pRoot, POINT pt, UINT uFlags)
+	{
+		ASSERT((uFlags & UIFIND_HITTEST) != 0);
+		ASSERT((uFlags & ~(UIFIND_VISIBLE | UIFIND_HITTEST | UIFIND_TOP_FIRST | UIFIND_ME_FIRST)) == 0);
+		if( !m_bValid || pRoot != m_pRoot || uFlags != m_uFlags ) Build(pRoot, uFlags);
+		if( m_nCols == 0 || !::PtInRect(&m_rcGrid, pt) ) return NULL;
+
+		int iCell = (pt.y - m_rcGrid.top) / m_nCellSize * m_nCols + (pt.x - m_rcGrid.left) / m_nCellSize;
+		int nSkip = 0;
+		for( int i = m_aCellStart[iCell]; i < m_aCellStart[iCell + 1]; i++ ) {
+			const TNode& node = m_aNodes[m_aCellNodes[i]];
+			if( node.nOrder < nSkip || !::PtInRect(&node.rcHit, pt) ) continue;
+			// Each container hands the control on to its parent, unless it isn't a float control
+			// and pt is outside the container's client area. Then the walk carries on after the
+			// subtree that offered it, as CContainerUI::FindControl does.
+			const TNode* pChild = &node;
+			while( pChild->iParent >= 0 ) {
+				const TNode& parent = m_aNodes[pChild->iParent];
+				if( !pChild->bScrollBar && !node.bFloat && !::PtInRect(&parent.rcChildren, pt) ) break;
+				pChild = &parent;
+			}
+			if( pChild->iParent < 0 ) return node.pControl;
+			nSkip = pChild->nEnd;
+		}
+		return NULL;
+	}
+
+	void CHitTestIndex::Build(CControlUI* pRoot, UINT uFlags)
+	{
+		m_aNodes.clear();
+		m_aCellStart.clear();
+		m_aCellNodes.clear();
+		m_pRoot = pRoot;
+		m_uFlags = uFlags;
+		m_nOrder = 0;
+		m_nCols = m_nRows = 0;
+		m_bValid = true;
+		if( pRoot == NULL ) return;
+
+		RECT rcRoot = pRoot->GetPos();
+		AddControl(pRoot, -1, rcRoot, false);
+		if( m_aNodes.empty() ) return;
+
+		m_rcGrid = m_aNodes[0].rcHit;
+		int cx = m_rcGrid.right - m_rcGrid.left;
+		int cy = m_rcGrid.bottom - m_rcGrid.top;
+		m_nCellSize = HITTEST_CELL_SIZE;
+		while( ((cx + m_nCellSize - 1) / m_nCellSize) * ((cy + m_nCellSize - 1) / m_nCellSize) > HITTEST_MAX_CELLS ) m_nCellSize *= 2;
+		m_nCols = (cx + m_nCellSize - 1) / m_nCellSize;
+		m_nRows = (cy + m_nCellSize - 1) / m_nCellSize;
+
+		// every cell lists its candidates in the order the walk would offer them
+		std::vector<int> aOrder(m_nOrder, -1);
+		for( int i = 0; i < (int)m_aNodes.size(); i++ ) {
+			if( m_aNodes[i].bCandidate ) aOrder[m_aNodes[i].nOrder] = i;
+		}
+		m_aCellStart.assign(m_nCols * m_nRows + 1, 0);
+		for( int pass = 0; pass < 2; pass++ ) {
+			std::vector<int> aFill;
+			if( pass == 1 ) {
+				for( int i = 0; i < m_nCols * m_nRows; i++ ) m_aCellStart[i + 1] += m_aCellStart[i];
+				m_aCellNodes.resize(m_aCellStart[m_nCols * m_nRows]);
+				aFill.assign(m_aCellStart.begin(), m_aCellStart.end() - 1);
+			}
+			for( int n = 0; n < m_nOrder; n++ ) {
+				if( aOrder[n] < 0 ) continue;
+				const RECT& rc = m_aNodes[aOrder[n]].rcHit;
+				int x0 = (rc.left - m_rcGrid.left) / m_nCellSize;
+				int x1 = (rc.right - 1 - m_rcGrid.left) / m_nCellSize;
+				int y0 = (rc.top - m_rcGrid.top) / m_nCellSize;
+				int y1 = (rc.bottom - 1 - m_rcGrid.top) / m_nCellSize;
+				for( int y = y0; y <= y1; y++ ) {
+					for( int x = x0; x <= x1; x++ ) {
+						if( pass == 0 ) m_aCellStart[y * m_nCols + x + 1]++;
+						else m_aCellNodes[aFill[y * m_nCols + x]++] = aOrder[n];
+					}
+				}
+			}
+		}
+	}
+
+	void CHitTestIndex::AddControl(CControlUI* pControl, int iParent, const RECT& rcClip, bool bScrollBar)
+	{
+		// a control pt can't be in, or under an ancestor pt can't be in, is never reached
+		if( (m_uFlags & UIFIND_VISIBLE) != 0 && !pControl->IsVisible() ) return;
+		RECT rcHit = { 0 };
+		if( !::IntersectRect(&rcHit, &pControl->GetPos(), &rcClip) ) return;
+
+		int iNode = (int)m_aNodes.size();
+		TNode node = { 0 };
+		node.pControl = pControl;
+		node.rcHit = rcHit;
+		node.iParent = iParent;
+		node.bCandidate = pControl->IsMouseEnabled();
+		node.bFloat = pControl->IsFloat();
+		node.bScrollBar = bScrollBar;
+		m_aNodes.push_back(node);
+
+		CContainerUI* pContainer = dynamic_cast<CContainerUI*>(pControl);
+		if( pContainer == NULL ) {
+			m_aNodes[iNode].nOrder = m_nOrder++;
+			m_aNodes[iNode].nEnd = m_nOrder;
+			return;
+		}
+
+		if( (m_uFlags & UIFIND_ME_FIRST) != 0 ) m_aNodes[iNode].nOrder = m_nOrder++;
+		if( pContainer->IsMouseEnabled() ) {
+			if( pContainer->m_pVerticalScrollBar != NULL ) AddControl(pContainer->m_pVerticalScrollBar, iNode, rcHit, true);
+			if( pContainer->m_pHorizontalScrollBar != NULL ) AddControl(pContainer->m_pHorizontalScrollBar, iNode, rcHit, true);
+		}
+		if( pContainer->IsMouseChildEnabled() ) {
+			RECT rc = pContainer->m_rcItem;
+			rc.left += pContainer->m_rcInset.left;
+			rc.top += pContainer->m_rcInset.top;
+			rc.right -= pContainer->m_rcInset.right;
+			rc.bottom -= pContainer->m_rcInset.bottom;
+			if( pContainer->m_pVerticalScrollBar && pContainer->m_pVerticalScrollBar->IsVisible() ) rc.right -= pContainer->m_pVerticalScrollBar->GetFixedWidth();
+			if( pContainer->m_pHorizontalScrollBar && pContainer->m_pHorizontalScrollBar->IsVisible() ) rc.bottom -= pContainer->m_pHorizontalScrollBar->GetFixedHeight();
+			m_aNodes[iNode].rcChildren = rc;
+
+			int nCount = pContainer->m_items.GetSize();
+			for( int it = 0; it < nCount; it++ ) {
+				int iItem = (m_uFlags & UIFIND_TOP_FIRST) != 0 ? nCount - 1 - it : it;
+				AddControl(static_cast<CControlUI*>(pContainer->m_items[iItem]), iNode, rcHit, false);
+			}
+		}
+		if( (m_uFlags & UIFIND_ME_FIRST) == 0 ) m_aNodes[iNode].nOrder = m_nOrder++;
+		m_aNodes[iNode].nEnd = m_nOrder;
+	}
+
+} // namespace DuiLib
@@ -0,0 +1,67 @@
+#ifndef __UIHITTEST_H__
+#define __UIHITTEST_H__
+
+#pragma once
+#include <vector>
+
+namespace DuiLib {
+	/////////////////////////////////////////////////////////////////////////////////////
+	//
+	// Answers FindControl(pt) from a grid over the window instead of walking the tree.
+	//
+	// Build flattens the tree in the order CContainerUI::FindControl visits it, clipping every
+	// control to its ancestors, and files each one under the grid cells it covers. A query
+	// only looks at the controls of one cell, in visiting order, and applies the same rules
+	// as the walk (inset, scroll bars, float controls, mouse flags), so it gives the same
+	// answer for any point. Only the UIFIND_VISIBLE, UIFIND_HITTEST, UIFIND_TOP_FIRST and
+	// UIFIND_ME_FIRST flags are supported.
+	//
+	// Nothing here notices when the tree changes: the owner calls Invalidate, and the next
+	// Find builds again.
+
+	class CControlUI;
+	class CContainerUI;
+
+	class CHitTestIndex
+	{
+	public:
+		CHitTestIndex();
+
+		void Invalidate();
+		bool IsValid() const;
+		CControlUI* Find(CControlUI* pRoot, POINT pt, UINT uFlags);
+		int GetCount() const;
+
+	private:
+		struct TNode
+		{
+			CControlUI* pControl;
+			RECT rcHit;         // the control clipped to all its ancestors
+			RECT rcChildren;    // containers: where non-float children can be hit
+			int iParent;
+			int nOrder;         // when the walk would offer this control itself
+			int nEnd;           // first order after this control's subtree
+			bool bCandidate;
+			bool bFloat;
+			bool bScrollBar;
+		};
+
+		void Build(CControlUI* pRoot, UINT uFlags);
+		void AddControl(CControlUI* pControl, int iParent, const RECT& rcClip, bool bScrollBar);
+
+		std::vector<TNode> m_aNodes;
+		std::vector<int> m_aCellStart;
+		std::vector<int> m_aCellNodes;
+		CControlUI* m_pRoot;
+		UINT m_uFlags;
+		RECT m_rcGrid;
+		int m_nCellSize;
+		int m_nCols;
+		int m_nRows;
+		int m_nOrder;
+		bool m_bValid;
+	};
+
+} // namespace DuiLib
+
+#endif // __UIHITTEST_H__
@@ -0,0 +1,802 @@
+#include "StdAfx.h"
+#include <climits>
+
+namespace DuiLib {
+
+	/////////////////////////////////////////////////////////////////////////////////////
+	//
+	//
+
+	template<typename T> static T TopOf(const std::vector<T>& a, T def)
+	{
+		return a.empty() ? def : a.back();
+	}
+
+	template<typename T> static void PopOf(std::vector<T>& a)
+	{
+		if( !a.empty() ) a.pop_back();
+	}
+
+	CHtmlLayout::CHtmlLayout() :
+		m_nLinks(0),
+		m_nLinkRects(0),
+		m_nLinkTexts(0),
+		m_cxMaxWidth(INT_MIN),
+		m_cyMinHeight(INT_MIN),
+		m_cyEnd(0),
+		m_bComplete(true)
+	{
+	}
+
+	void CHtmlLayout::Build(IHtmlLayoutHost* pHost, LPCTSTR pstrText, int cx, int cy, UINT uStyle, DWORD dwTextColor,
+		DWORD dwLinkHoverColor, LPCTSTR pstrHoverLink, int nLinkRects)
+	{
+		m_aRuns.clear();
+		m_sChars.clear();
+		m_aLinkRects.assign(nLinkRects > 0 ? nLinkRects : 0, RECT());
+		m_aLinks.assign(nLinkRects > 0 ? nLinkRects : 0, String());
+		m_nLinks = m_nLinkRects = m_nLinkTexts = 0;
+		m_cxMaxWidth = m_cyMinHeight = INT_MIN;
+		m_cyEnd = 0;
+		m_bComplete = true;
+		if( pHost == NULL || pstrText == NULL ) return;
+
+		RECT rc = { 0, 0, cx, cy };
+		bool bDraw = (uStyle & DT_CALCRECT) == 0;
+
+		std::vector<LPVOID> aFontArray;
+		std::vector<DWORD> aColorArray;
+		std::vector<int> aPIndentArray;
+
+		// what the DC would have selected
+		LPVOID hDefaultFont = pHost->GetDefaultFont();
+		LPVOID hFont = hDefaultFont;
+		THtmlFontInfo tm;
+		pHost->GetFontInfo(hFont, tm);
+		DWORD dwColor = dwTextColor;
+		bool bOpaque = false;
+
+		bool bHoverLink = pstrHoverLink != NULL;
+		String sHoverLink = bHoverLink ? pstrHoverLink : _T("");
+
+		POINT pt = { rc.left, rc.top };
+		int iLinkIndex = 0;
+		int cyLine = tm.cyHeight + tm.cyExternalLeading + TopOf(aPIndentArray, 0);
+		int cyMinHeight = INT_MIN;
+		int cxMaxWidth = INT_MIN;
+		POINT ptLinkStart = { 0 };
+		bool bLineEnd = false;
+		bool bInRaw = false;
+		bool bInLink = false;
+		bool bInSelected = false;
+		int iLineLinkIndex = 0;
+
+		// each line is measured first so everything on it can sit on the same bottom, then drawn
+		std::vector<LPVOID> aLineFontArray;
+		std::vector<DWORD> aLineColorArray;
+		std::vector<int> aLinePIndentArray;
+		LPCTSTR pstrLineBegin = pstrText;
+		bool bLineInRaw = false;
+		bool bLineInLink = false;
+		bool bLineInSelected = false;
+		int cyLineHeight = 0;
+		bool bLineDraw = false;
+		while( *pstrText != _T('\0') ) {
+			if( pt.x >= rc.right || *pstrText == _T('\n') || bLineEnd ) {
+				if( *pstrText == _T('\n') ) pstrText++;
+				if( bLineEnd ) bLineEnd = false;
+				if( !bLineDraw ) {
+					if( bInLink && iLinkIndex < nLinkRects ) {
+						RECT rcLink = { ptLinkStart.x, ptLinkStart.y, MIN(pt.x, rc.right), pt.y + cyLine };
+						m_aLinkRects[iLinkIndex++] = rcLink;
+						m_nLinkRects = MAX(m_nLinkRects, iLinkIndex);
+						// the link goes on on the next line, under the same text
+						if( iLinkIndex < nLinkRects ) {
+							m_aLinks[iLinkIndex] = m_aLinks[iLinkIndex - 1];
+							m_nLinkTexts = MAX(m_nLinkTexts, iLinkIndex + 1);
+						}
+					}
+					for( int i = iLineLinkIndex; i < iLinkIndex; i++ ) {
+						m_aLinkRects[i].bottom = pt.y + cyLine;
+					}
+					if( bDraw ) {
+						bInLink = bLineInLink;
+						iLinkIndex = iLineLinkIndex;
+					}
+				}
+				else {
+					if( bInLink && iLinkIndex < nLinkRects ) iLinkIndex++;
+					bLineInLink = bInLink;
+					iLineLinkIndex = iLinkIndex;
+				}
+				if( (uStyle & DT_SINGLELINE) != 0 && (!bDraw || bLineDraw) ) break;
+				if( bDraw ) bLineDraw = !bLineDraw;
+				pt.x = rc.left;
+				if( !bLineDraw ) pt.y += cyLine;
+				if( pt.y > rc.bottom && bDraw ) break;
+				ptLinkStart = pt;
+				cyLine = tm.cyHeight + tm.cyExternalLeading + TopOf(aPIndentArray, 0);
+				if( pt.x >= rc.right ) break;
+			}
+			else if( !bInRaw && ( *pstrText == _T('<') || *pstrText == _T('{') )
+				&& ( pstrText[1] >= _T('a') && pstrText[1] <= _T('z') )
+				&& ( pstrText[2] == _T(' ') || pstrText[2] == _T('>') || pstrText[2] == _T('}') ) ) {
+					pstrText++;
+					LPCTSTR pstrNextStart = NULL;
+					switch( *pstrText ) {
+					case _T('a'):  // Link
+						{
+							pstrText++;
+							while( *pstrText > _T('\0') && *pstrText <= _T(' ') ) pstrText = ::CharNext(pstrText);
+							if( iLinkIndex < nLinkRects && !bLineDraw ) {
+								String& sLink = m_aLinks[iLinkIndex];
+								sLink.clear();
+								while( *pstrText != _T('\0') && *pstrText != _T('>') && *pstrText != _T('}') ) {
+									LPCTSTR pstrTemp = ::CharNext(pstrText);
+									while( pstrText < pstrTemp) {
+										sLink += *pstrText++;
+									}
+								}
+								m_nLinkTexts = MAX(m_nLinkTexts, iLinkIndex + 1);
+							}
+
+							DWORD clrColor = dwTextColor;
+							if( bHoverLink && iLinkIndex < nLinkRects ) {
+								if( sHoverLink == m_aLinks[iLinkIndex] ) clrColor = dwLinkHoverColor;
+							}
+							aColorArray.push_back(clrColor);
+							dwColor = clrColor;
+							LPVOID hTopFont = TopOf(aFontArray, hDefaultFont);
+							THtmlFontInfo info;
+							pHost->GetFontInfo(hTopFont, info);
+							if( info.bUnderline == false ) {
+								hFont = pHost->GetFont(hTopFont, info.bBold, true, info.bItalic);
+								aFontArray.push_back(hFont);
+								pHost->GetFontInfo(hFont, tm);
+								cyLine = MAX(cyLine, tm.cyHeight + tm.cyExternalLeading + TopOf(aPIndentArray, 0));
+							}
+							ptLinkStart = pt;
+							bInLink = true;
+						}
+						break;
+					case _T('b'):  // Bold
+						{
+							pstrText++;
+							LPVOID hTopFont = TopOf(aFontArray, hDefaultFont);
+							THtmlFontInfo info;
+							pHost->GetFontInfo(hTopFont, info);
+							if( info.bBold == false ) {
+								hFont = pHost->GetFont(hTopFont, true, info.bUnderline, info.bItalic);
+								aFontArray.push_back(hFont);
+								pHost->GetFontInfo(hFont, tm);
+								cyLine = MAX(cyLine, tm.cyHeight + tm.cyExternalLeading + TopOf(aPIndentArray, 0));
+							}
+						}
+						break;
+					case _T('c'):  // Color
+						{
+							pstrText++;
+							while( *pstrText > _T('\0') && *pstrText <= _T(' ') ) pstrText = ::CharNext(pstrText);
+							if( *pstrText == _T('#')) pstrText++;
+							DWORD clrColor = _tcstol(pstrText, const_cast<LPTSTR*>(&pstrText), 16);
+							aColorArray.push_back(clrColor);
+							dwColor = clrColor;
+						}
+						break;
+					case _T('f'):  // Font
+						{
+							pstrText++;
+							while( *pstrText > _T('\0') && *pstrText <= _T(' ') ) pstrText = ::CharNext(pstrText);
+							LPCTSTR pstrTemp = pstrText;
+							int iFont = (int) _tcstol(pstrText, const_cast<LPTSTR*>(&pstrText), 10);
+							if( pstrTemp != pstrText ) {
+								hFont = pHost->GetFont(iFont);
+								aFontArray.push_back(hFont);
+								pHost->GetFontInfo(hFont, tm);
+							}
+							else {
+								String sFontName;
+								int iFontSize = 10;
+								String sFontAttr;
+								bool bBold = false;
+								bool bUnderline = false;
+								bool bItalic = false;
+								while( *pstrText != _T('\0') && *pstrText != _T('>') && *pstrText != _T('}') && *pstrText != _T(' ') ) {
+									pstrTemp = ::CharNext(pstrText);
+									while( pstrText < pstrTemp) {
+										sFontName += *pstrText++;
+									}
+								}
+								while( *pstrText > _T('\0') && *pstrText <= _T(' ') ) pstrText = ::CharNext(pstrText);
+								if( isdigit(*pstrText) ) {
+									iFontSize = (int) _tcstol(pstrText, const_cast<LPTSTR*>(&pstrText), 10);
+								}
+								while( *pstrText > _T('\0') && *pstrText <= _T(' ') ) pstrText = ::CharNext(pstrText);
+								while( *pstrText != _T('\0') && *pstrText != _T('>') && *pstrText != _T('}') ) {
+									pstrTemp = ::CharNext(pstrText);
+									while( pstrText < pstrTemp) {
+										TCHAR ch = *pstrText++;
+										if( ch >= _T('A') && ch <= _T('Z') ) ch += _T('a') - _T('A');
+										sFontAttr += ch;
+									}
+								}
+								if( sFontAttr.find(_T("bold")) != String::npos ) bBold = true;
+								if( sFontAttr.find(_T("underline")) != String::npos ) bUnderline = true;
+								if( sFontAttr.find(_T("italic")) != String::npos ) bItalic = true;
+								hFont = pHost->GetFont(sFontName.c_str(), iFontSize, bBold, bUnderline, bItalic);
+								aFontArray.push_back(hFont);
+								pHost->GetFontInfo(hFont, tm);
+							}
+							cyLine = MAX(cyLine, tm.cyHeight + tm.cyExternalLeading + TopOf(aPIndentArray, 0));
+						}
+						break;
+					case _T('i'):  // Italic or Image
+						{
+							pstrNextStart = pstrText - 1;
+							pstrText++;
+							LPCTSTR pstrImageString = pstrText;
+							int iWidth = 0;
+							int iHeight = 0;
+							while( *pstrText > _T('\0') && *pstrText <= _T(' ') ) pstrText = ::CharNext(pstrText);
+							String sName;
+							while( *pstrText != _T('\0') && *pstrText != _T('>') && *pstrText != _T('}') && *pstrText != _T(' ') ) {
+								LPCTSTR pstrTemp = ::CharNext(pstrText);
+								while( pstrText < pstrTemp) {
+									sName += *pstrText++;
+								}
+							}
+							if( sName.empty() ) { // Italic
+								pstrNextStart = NULL;
+								LPVOID hTopFont = TopOf(aFontArray, hDefaultFont);
+								THtmlFontInfo info;
+								pHost->GetFontInfo(hTopFont, info);
+								if( info.bItalic == false ) {
+									hFont = pHost->GetFont(hTopFont, info.bBold, info.bUnderline, true);
+									aFontArray.push_back(hFont);
+									pHost->GetFontInfo(hFont, tm);
+									cyLine = MAX(cyLine, tm.cyHeight + tm.cyExternalLeading + TopOf(aPIndentArray, 0));
+								}
+							}
+							else {
+								while( *pstrText > _T('\0') && *pstrText <= _T(' ') ) pstrText = ::CharNext(pstrText);
+								int iImageListNum = (int) _tcstol(pstrText, const_cast<LPTSTR*>(&pstrText), 10);
+								if( iImageListNum <= 0 ) iImageListNum = 1;
+								while( *pstrText > _T('\0') && *pstrText <= _T(' ') ) pstrText = ::CharNext(pstrText);
+								int iImageListIndex = (int) _tcstol(pstrText, const_cast<LPTSTR*>(&pstrText), 10);
+								if( iImageListIndex < 0 || iImageListIndex >= iImageListNum ) iImageListIndex = 0;
+
+								String sImageName = sName;
+								String sImageResType;
+								bool bResType = false;
+								if( _tcsstr(pstrImageString, _T("file=\'")) != NULL || _tcsstr(pstrImageString, _T("res=\'")) != NULL ) {
+									sImageName.clear();
+									bResType = true;
+									LPCTSTR pStrImage = pstrImageString;
+									String sItem;
+									String sValue;
+									while( *pStrImage != _T('\0') ) {
+										sItem.clear();
+										sValue.clear();
+										while( *pStrImage > _T('\0') && *pStrImage <= _T(' ') ) pStrImage = ::CharNext(pStrImage);
+										while( *pStrImage != _T('\0') && *pStrImage != _T('=') && *pStrImage > _T(' ') ) {
+											LPCTSTR pstrTemp = ::CharNext(pStrImage);
+											while( pStrImage < pstrTemp) {
+												sItem += *pStrImage++;
+											}
+										}
+										while( *pStrImage > _T('\0') && *pStrImage <= _T(' ') ) pStrImage = ::CharNext(pStrImage);
+										if( *pStrImage++ != _T('=') ) break;
+										while( *pStrImage > _T('\0') && *pStrImage <= _T(' ') ) pStrImage = ::CharNext(pStrImage);
+										if( *pStrImage++ != _T('\'') ) break;
+										while( *pStrImage != _T('\0') && *pStrImage != _T('\'') ) {
+											LPCTSTR pstrTemp = ::CharNext(pStrImage);
+											while( pStrImage < pstrTemp) {
+												sValue += *pStrImage++;
+											}
+										}
+										if( *pStrImage++ != _T('\'') ) break;
+										if( !sValue.empty() ) {
+											if( sItem == _T("file") || sItem == _T("res") ) {
+												sImageName = sValue;
+											}
+											else if( sItem == _T("restype") ) {
+												sImageResType = sValue;
+											}
+										}
+										if( *pStrImage++ != _T(' ') ) break;
+									}
+								}
+
+								LPCTSTR pstrResType = bResType ? sImageResType.c_str() : NULL;
+								if( pHost->GetImageSize(sImageName.c_str(), pstrResType, iWidth, iHeight) ) {
+									if( iImageListNum > 1 ) iWidth /= iImageListNum;
+
+									if( pt.x + iWidth > rc.right && pt.x > rc.left && (uStyle & DT_SINGLELINE) == 0 ) {
+										bLineEnd = true;
+									}
+									else {
+										pstrNextStart = NULL;
+										if( bDraw && bLineDraw ) {
+											RECT rcImage = { pt.x, pt.y + cyLineHeight - iHeight, pt.x + iWidth, pt.y + cyLineHeight };
+											if( iHeight < cyLineHeight ) {
+												rcImage.bottom -= (cyLineHeight - iHeight) / 2;
+												rcImage.top = rcImage.bottom -  iHeight;
+											}
+											RECT rcBmpPart = { iWidth * iImageListIndex, 0, iWidth * (iImageListIndex + 1), iHeight };
+											AddImage(rcImage, rcBmpPart, sImageName.c_str(), pstrResType);
+										}
+
+										cyLine = MAX(iHeight, cyLine);
+										pt.x += iWidth;
+										cyMinHeight = pt.y + iHeight;
+										cxMaxWidth = MAX(cxMaxWidth, pt.x);
+									}
+								}
+								else {
+									// most likely still decoding; the layout has to be made again once it is in
+									m_bComplete = false;
+									pstrNextStart = NULL;
+								}
+							}
+						}
+						break;
+					case _T('n'):  // Newline
+						{
+							pstrText++;
+							if( (uStyle & DT_SINGLELINE) != 0 ) break;
+							bLineEnd = true;
+						}
+						break;
+					case _T('p'):  // Paragraph
+						{
+							pstrText++;
+							if( pt.x > rc.left ) bLineEnd = true;
+							while( *pstrText > _T('\0') && *pstrText <= _T(' ') ) pstrText = ::CharNext(pstrText);
+							int cyLineExtra = (int)_tcstol(pstrText, const_cast<LPTSTR*>(&pstrText), 10);
+							aPIndentArray.push_back(cyLineExtra);
+							cyLine = MAX(cyLine, tm.cyHeight + tm.cyExternalLeading + cyLineExtra);
+						}
+						break;
+					case _T('r'):  // Raw Text
+						{
+							pstrText++;
+							bInRaw = true;
+						}
+						break;
+					case _T('s'):  // Selected text background color
+						{
+							pstrText++;
+							bInSelected = !bInSelected;
+							if( bDraw && bLineDraw ) bOpaque = bInSelected;
+						}
+						break;
+					case _T('u'):  // Underline text
+						{
+							pstrText++;
+							LPVOID hTopFont = TopOf(aFontArray, hDefaultFont);
+							THtmlFontInfo info;
+							pHost->GetFontInfo(hTopFont, info);
+							if( info.bUnderline == false ) {
+								hFont = pHost->GetFont(hTopFont, info.bBold, true, info.bItalic);
+								aFontArray.push_back(hFont);
+								pHost->GetFontInfo(hFont, tm);
+								cyLine = MAX(cyLine, tm.cyHeight + tm.cyExternalLeading + TopOf(aPIndentArray, 0));
+							}
+						}
+						break;
+					case _T('x'):  // X Indent
+						{
+							pstrText++;
+							while( *pstrText > _T('\0') && *pstrText <= _T(' ') ) pstrText = ::CharNext(pstrText);
+							int iWidth = (int) _tcstol(pstrText, const_cast<LPTSTR*>(&pstrText), 10);
+							pt.x += iWidth;
+							cxMaxWidth = MAX(cxMaxWidth, pt.x);
+						}
+						break;
+					case _T('y'):  // Y Indent
+						{
+							pstrText++;
+							while( *pstrText > _T('\0') && *pstrText <= _T(' ') ) pstrText = ::CharNext(pstrText);
+							cyLine = (int) _tcstol(pstrText, const_cast<LPTSTR*>(&pstrText), 10);
+						}
+						break;
+					}
+					if( pstrNextStart != NULL ) pstrText = pstrNextStart;
+					else {
+						while( *pstrText != _T('\0') && *pstrText != _T('>') && *pstrText != _T('}') ) pstrText = ::CharNext(pstrText);
+						pstrText = ::CharNext(pstrText);
+					}
+			}
+			else if( !bInRaw && ( *pstrText == _T('<') || *pstrText == _T('{') ) && pstrText[1] == _T('/') )
+			{
+				pstrText++;
+				pstrText++;
+				switch( *pstrText )
+				{
+				case _T('c'):
+					{
+						pstrText++;
+						PopOf(aColorArray);
+						dwColor = TopOf(aColorArray, dwTextColor);
+					}
+					break;
+				case _T('p'):
+					pstrText++;
+					if( pt.x > rc.left ) bLineEnd = true;
+					PopOf(aPIndentArray);
+					cyLine = MAX(cyLine, tm.cyHeight + tm.cyExternalLeading + TopOf(aPIndentArray, 0));
+					break;
+				case _T('s'):
+					{
+						pstrText++;
+						bInSelected = !bInSelected;
+						if( bDraw && bLineDraw ) bOpaque = bInSelected;
+					}
+					break;
+				case _T('a'):
+					{
+						if( iLinkIndex < nLinkRects ) {
+							if( !bLineDraw ) {
+								RECT rcLink = { ptLinkStart.x, ptLinkStart.y, MIN(pt.x, rc.right), pt.y + tm.cyHeight + tm.cyExternalLeading };
+								m_aLinkRects[iLinkIndex] = rcLink;
+								m_nLinkRects = MAX(m_nLinkRects, iLinkIndex + 1);
+							}
+							iLinkIndex++;
+						}
+						PopOf(aColorArray);
+						dwColor = TopOf(aColorArray, dwTextColor);
+						bInLink = false;
+					}
+				case _T('b'):
+				case _T('f'):
+				case _T('i'):
+				case _T('u'):
+					{
+						pstrText++;
+						PopOf(aFontArray);
+						LPVOID hTopFont = TopOf(aFontArray, (LPVOID)NULL);
+						if( hTopFont == NULL ) hTopFont = hDefaultFont;
+						THtmlFontInfo info;
+						pHost->GetFontInfo(hTopFont, info);
+						if( tm.bSlanted && info.bItalic == false ) {
+							pt.x += pHost->GetSpaceOverhang(hFont) / 2; // the last italic letter leans over, see http://support.microsoft.com/kb/244798/en-us
+						}
+						hFont = hTopFont;
+						tm = info;
+						cyLine = MAX(cyLine, tm.cyHeight + tm.cyExternalLeading + TopOf(aPIndentArray, 0));
+					}
+					break;
+				}
+				while( *pstrText != _T('\0') && *pstrText != _T('>') && *pstrText != _T('}') ) pstrText = ::CharNext(pstrText);
+				pstrText = ::CharNext(pstrText);
+			}
+			else if( !bInRaw &&  *pstrText == _T('<') && pstrText[2] == _T('>') && (pstrText[1] == _T('{')  || pstrText[1] == _T('}')) )
+			{
+				int cxChar = pHost->GetTextWidth(hFont, &pstrText[1], 1);
+				if( bDraw && bLineDraw ) AddText(pt.x, pt.y + cyLineHeight - tm.cyHeight - tm.cyExternalLeading, &pstrText[1], 1, hFont, dwColor, bOpaque);
+				pt.x += cxChar;
+				cxMaxWidth = MAX(cxMaxWidth, pt.x);
+				pstrText++;pstrText++;pstrText++;
+			}
+			else if( !bInRaw &&  *pstrText == _T('{') && pstrText[2] == _T('}') && (pstrText[1] == _T('<')  || pstrText[1] == _T('>')) )
+			{
+				int cxChar = pHost->GetTextWidth(hFont, &pstrText[1], 1);
+				if( bDraw && bLineDraw ) AddText(pt.x,  pt.y + cyLineHeight - tm.cyHeight - tm.cyExternalLeading, &pstrText[1], 1, hFont, dwColor, bOpaque);
+				pt.x += cxChar;
+				cxMaxWidth = MAX(cxMaxWidth, pt.x);
+				pstrText++;pstrText++;pstrText++;
+			}
+			else if( !bInRaw &&  *pstrText == _T(' ') )
+			{
+				int cxSpace = pHost->GetTextWidth(hFont, _T(" "), 1);
+				// Still need to paint the space because the font might have
+				// underline formatting.
+				if( bDraw && bLineDraw ) AddText(pt.x,  pt.y + cyLineHeight - tm.cyHeight - tm.cyExternalLeading, _T(" "), 1, hFont, dwColor, bOpaque);
+				pt.x += cxSpace;
+				cxMaxWidth = MAX(cxMaxWidth, pt.x);
+				pstrText++;
+			}
+			else
+			{
+				POINT ptPos = pt;
+				int cchChars = 0;
+				int cchSize = 0;
+				int cchLastGoodWord = 0;
+				int cchLastGoodSize = 0;
+				LPCTSTR p = pstrText;
+				LPCTSTR pstrNext;
+				int cxText = 0;
+				if( ( !bInRaw && *p == _T('<') ) || *p == _T('{') ) p++, cchChars++, cchSize++;
+				while( *p != _T('\0') && *p != _T('\n') ) {
+					// This part makes sure that we're word-wrapping if needed or providing support
+					// for DT_END_ELLIPSIS. Unfortunately the GetTextExtentPoint32() call is pretty
+					// slow when repeated so often, which is why the layout is cached.
+					if( bInRaw ) {
+						if( ( *p == _T('<') || *p == _T('{') ) && p[1] == _T('/')
+							&& p[2] == _T('r') && ( p[3] == _T('>') || p[3] == _T('}') ) ) {
+								p += 4;
+								bInRaw = false;
+								break;
+						}
+					}
+					else {
+						if( *p == _T('<') || *p == _T('{') ) break;
+					}
+					pstrNext = ::CharNext(p);
+					cchChars++;
+					cchSize += (int)(pstrNext - p);
+					cxText = cchChars * tm.cxMaxChar;
+					if( pt.x + cxText >= rc.right ) {
+						cxText = pHost->GetTextWidth(hFont, pstrText, cchSize);
+					}
+					if( pt.x + cxText > rc.right ) {
+						if( pt.x + cxText > rc.right && pt.x != rc.left) {
+							cchChars--;
+							cchSize -= (int)(pstrNext - p);
+						}
+						if( (uStyle & DT_WORDBREAK) != 0 && cchLastGoodWord > 0 ) {
+							cchChars = cchLastGoodWord;
+							cchSize = cchLastGoodSize;
+						}
+						if( (uStyle & DT_END_ELLIPSIS) != 0 && cchChars > 0 ) {
+							cchChars -= 1;
+							LPCTSTR pstrPrev = ::CharPrev(pstrText, p);
+							if( cchChars > 0 ) {
+								cchChars -= 1;
+								pstrPrev = ::CharPrev(pstrText, pstrPrev);
+								cchSize -= (int)(p - pstrPrev);
+							}
+							else
+								cchSize -= (int)(p - pstrPrev);
+							pt.x = rc.right;
+						}
+						bLineEnd = true;
+						cxMaxWidth = MAX(cxMaxWidth, pt.x);
+						break;
+					}
+					if (!( ( p[0] >= _T('a') && p[0] <= _T('z') ) || ( p[0] >= _T('A') && p[0] <= _T('Z') ) )) {
+						cchLastGoodWord = cchChars;
+						cchLastGoodSize = cchSize;
+					}
+					if( *p == _T(' ') ) {
+						cchLastGoodWord = cchChars;
+						cchLastGoodSize = cchSize;
+					}
+					p = ::CharNext(p);
+				}
+
+				cxText = pHost->GetTextWidth(hFont, pstrText, cchSize);
+				if( bDraw && bLineDraw ) {
+					if( (uStyle & DT_SINGLELINE) == 0 && (uStyle & DT_CENTER) != 0 ) {
+						ptPos.x += (rc.right - rc.left - cxText)/2;
+					}
+					else if( (uStyle & DT_SINGLELINE) == 0 && (uStyle & DT_RIGHT) != 0) {
+						ptPos.x += (rc.right - rc.left - cxText);
+					}
+					AddText(ptPos.x, ptPos.y + cyLineHeight - tm.cyHeight - tm.cyExternalLeading, pstrText, cchSize, hFont, dwColor, bOpaque);
+					if( pt.x >= rc.right && (uStyle & DT_END_ELLIPSIS) != 0 )
+						AddText(ptPos.x + cxText, ptPos.y, _T("..."), 3, hFont, dwColor, bOpaque);
+				}
+				pt.x += cxText;
+				cxMaxWidth = MAX(cxMaxWidth, pt.x);
+				pstrText += cchSize;
+			}
+
+			if( pt.x >= rc.right || *pstrText == _T('\n') || *pstrText == _T('\0') ) bLineEnd = true;
+			if( bDraw && bLineEnd ) {
+				if( !bLineDraw ) {
+					aFontArray = aLineFontArray;
+					aColorArray = aLineColorArray;
+					aPIndentArray = aLinePIndentArray;
+
+					cyLineHeight = cyLine;
+					pstrText = pstrLineBegin;
+					bInRaw = bLineInRaw;
+					bInSelected = bLineInSelected;
+
+					dwColor = TopOf(aColorArray, dwTextColor);
+					hFont = TopOf(aFontArray, (LPVOID)NULL);
+					if( hFont == NULL ) hFont = hDefaultFont;
+					pHost->GetFontInfo(hFont, tm);
+					if( bInSelected ) bOpaque = true;
+				}
+				else {
+					aLineFontArray = aFontArray;
+					aLineColorArray = aColorArray;
+					aLinePIndentArray = aPIndentArray;
+					pstrLineBegin = pstrText;
+					bLineInSelected = bInSelected;
+					bLineInRaw = bInRaw;
+				}
+			}
+
+			ASSERT(iLinkIndex<=nLinkRects);
+		}
+
+		m_nLinks = iLinkIndex;
+		m_cxMaxWidth = cxMaxWidth;
+		m_cyMinHeight = cyMinHeight;
+		m_cyEnd = pt.y + cyLine;
+	}
+
+	bool CHtmlLayout::IsComplete() const
+	{
+		return m_bComplete;
+	}
+
+	int CHtmlLayout::GetRunCount() const
+	{
+		return (int)m_aRuns.size();
+	}
+
+	const CHtmlLayout::TRun& CHtmlLayout::GetRun(int iIndex) const
+	{
+		return m_aRuns[iIndex];
+	}
+
+	LPCTSTR CHtmlLayout::GetChars(int iChar) const
+	{
+		if( iChar < 0 ) return NULL;
+		return m_sChars.c_str() + iChar;
+	}
+
+	int CHtmlLayout::GetLinkCount() const
+	{
+		return m_nLinks;
+	}
+
+	int CHtmlLayout::GetLinkRectCount() const
+	{
+		return m_nLinkRects;
+	}
+
+	int CHtmlLayout::GetLinkTextCount() const
+	{
+		return m_nLinkTexts;
+	}
+
+	const RECT& CHtmlLayout::GetLinkRect(int iIndex) const
+	{
+		return m_aLinkRects[iIndex];
+	}
+
+	LPCTSTR CHtmlLayout::GetLinkText(int iIndex) const
+	{
+		return m_aLinks[iIndex].c_str();
+	}
+
+	void CHtmlLayout::GetCalcRect(RECT& rc) const
+	{
+		// DrawHtmlText started both of these at 0 in window coordinates
+		int cxMaxWidth = 0;
+		if( m_cxMaxWidth != INT_MIN ) cxMaxWidth = MAX(0, (int)rc.left + m_cxMaxWidth);
+		int cyMinHeight = 0;
+		if( m_cyMinHeight != INT_MIN ) cyMinHeight = rc.top + m_cyMinHeight;
+		rc.bottom = MAX(cyMinHeight, (int)rc.top + m_cyEnd);
+		rc.right = MIN((int)rc.right, cxMaxWidth);
+	}
+
+	void CHtmlLayout::AddText(int x, int y, LPCTSTR pstrText, int cchText, LPVOID hFont, DWORD dwColor, bool bOpaque)
+	{
+		if( cchText <= 0 ) return;
+		TRun run = { 0 };
+		run.iKind = RUN_TEXT;
+		run.rc.left = x;
+		run.rc.top = y;
+		run.rc.right = x;
+		run.rc.bottom = y;
+		run.hFont = hFont;
+		run.dwColor = dwColor;
+		run.bOpaque = bOpaque;
+		run.iText = AddChars(pstrText, cchText);
+		run.cchText = cchText;
+		run.iType = -1;
+		m_aRuns.push_back(run);
+	}
+
+	void CHtmlLayout::AddImage(const RECT& rc, const RECT& rcSource, LPCTSTR pstrName, LPCTSTR pstrType)
+	{
+		TRun run = { 0 };
+		run.iKind = RUN_IMAGE;
+		run.rc = rc;
+		run.rcSource = rcSource;
+		run.iText = AddChars(pstrName, (int)_tcslen(pstrName));
+		run.cchText = (int)_tcslen(pstrName);
+		run.iType = pstrType == NULL ? -1 : AddChars(pstrType, (int)_tcslen(pstrType));
+		m_aRuns.push_back(run);
+	}
+
+	int CHtmlLayout::AddChars(LPCTSTR pstrText, int cchText)
+	{
+		int iChar = (int)m_sChars.size();
+		m_sChars.append(pstrText, cchText);
+		m_sChars += _T('\0');
+		return iChar;
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////
+	//
+	//
+
+	bool CHtmlLayoutCache::tagTKey::operator==(const tagTKey& key) const
+	{
+		return cx == key.cx && cy == key.cy && uStyle == key.uStyle && dwTextColor == key.dwTextColor
+			&& dwLinkHoverColor == key.dwLinkHoverColor && nLinkRects == key.nLinkRects && nScale == key.nScale
+			&& uSerial == key.uSerial && bHoverLink == key.bHoverLink && sText == key.sText && sHoverLink == key.sHoverLink;
+	}
+
+	size_t CHtmlLayoutCache::TKeyHash::operator()(const TKey& key) const
+	{
+		size_t h = std::hash<std::basic_string<TCHAR> >()(key.sText);
+		size_t aParts[] = { (size_t)key.cx, (size_t)key.cy, key.uStyle, key.dwTextColor, (size_t)key.nLinkRects,
+			std::hash<std::basic_string<TCHAR> >()(key.sHoverLink) };
+		for( size_t i = 0; i < sizeof(aParts) / sizeof(aParts[0]); i++ ) {
+			h ^= aParts[i] + 0x9E3779B9u + (h << 6) + (h >> 2);
+		}
+		return h;
+	}
+
+	CHtmlLayoutCache::CHtmlLayoutCache(int nCapacity) :
+		m_nCapacity(nCapacity > 0 ? nCapacity : 1),
+		m_uSerial(0)
+	{
+	}
+
+	CHtmlLayoutCache::~CHtmlLayoutCache()
+	{
+		RemoveAll();
+	}
+
+	const CHtmlLayout* CHtmlLayoutCache::Find(const TKey& key)
+	{
+		CheckSerial(key.uSerial);
+		EntryMap::iterator it = m_mEntries.find(key);
+		if( it == m_mEntries.end() ) return NULL;
+		m_lOrder.splice(m_lOrder.begin(), m_lOrder, it->second.itOrder);
+		return it->second.pLayout;
+	}
+
+	const CHtmlLayout* CHtmlLayoutCache::Add(const TKey& key, CHtmlLayout* pLayout)
+	{
+		CheckSerial(key.uSerial);
+		EntryMap::iterator it = m_mEntries.find(key);
+		if( it != m_mEntries.end() ) {
+			delete it->second.pLayout;
+			it->second.pLayout = pLayout;
+			m_lOrder.splice(m_lOrder.begin(), m_lOrder, it->second.itOrder);
+			return pLayout;
+		}
+		while( (int)m_mEntries.size() >= m_nCapacity ) {
+			EntryMap::iterator itOld = m_mEntries.find(*m_lOrder.back());
+			delete itOld->second.pLayout;
+			m_lOrder.pop_back();
+			m_mEntries.erase(itOld);
+		}
+		TEntry entry = { pLayout, m_lOrder.end() };
+		it = m_mEntries.insert(std::make_pair(key, entry)).first;
+		m_lOrder.push_front(&it->first);
+		it->second.itOrder = m_lOrder.begin();
+		return pLayout;
+	}
+
+	void CHtmlLayoutCache::RemoveAll()
+	{
+		for( EntryMap::iterator it = m_mEntries.begin(); it != m_mEntries.end(); ++it ) delete it->second.pLayout;
+		m_mEntries.clear();
+		m_lOrder.clear();
+	}
+
+	int CHtmlLayoutCache::GetCount() const
+	{
+		return (int)m_mEntries.size();
+	}
+
+	void CHtmlLayoutCache::CheckSerial(UINT uSerial)
+	{
+		// the fonts the layouts point at may be gone
+		if( uSerial == m_uSerial ) return;
+		RemoveAll();
+		m_uSerial = uSerial;
+	}
+
+} // namespace DuiLib
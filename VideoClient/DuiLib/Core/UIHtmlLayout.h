@@ -0,0 +1,169 @@
+#ifndef __UIHTMLLAYOUT_H__
+#define __UIHTMLLAYOUT_H__
+
+#pragma once
+#include <vector>
+#include <list>
+#include <string>
+#include <unordered_map>
+
+namespace DuiLib {
+	/////////////////////////////////////////////////////////////////////////////////////
+	//
+	// The mini-html of CRenderEngine::DrawHtmlText, parsed, measured and broken into lines
+	// once and kept as a list of runs: a piece of text with the font, colour and background
+	// it is drawn with and where it starts, or a cell of an imagelist and where it goes.
+	// Drawing a layout is a TextOut per run, with no parsing or measuring.
+	//
+	// Build is the old DrawHtmlText loop with every GDI call turned into a call on the host
+	// or a run, so it breaks lines, places links and answers DT_CALCRECT exactly as before.
+	// It lays out in a rect at the origin; the owner moves the runs to the real one.
+
+	typedef struct tagTHtmlFontInfo
+	{
+		int cyHeight;           // tmHeight
+		int cyExternalLeading;  // tmExternalLeading
+		int cxMaxChar;          // tmMaxCharWidth
+		bool bSlanted;          // tmItalic, what the font turned out to be
+		bool bBold;             // and what it was asked for
+		bool bUnderline;
+		bool bItalic;
+	} THtmlFontInfo;
+
+	// Fonts go through the layout as handles it only hands back to the host. A layout keeps
+	// them, so the host must keep every font it gave out alive until its cache is dropped.
+	class IHtmlLayoutHost
+	{
+	public:
+		virtual ~IHtmlLayoutHost() {}
+		virtual LPVOID GetDefaultFont() = 0;
+		virtual LPVOID GetFont(int iFont) = 0;
+		virtual LPVOID GetFont(LPCTSTR pstrFace, int nSize, bool bBold, bool bUnderline, bool bItalic) = 0;
+		// the face and size of hFont with these styles
+		virtual LPVOID GetFont(LPVOID hFont, bool bBold, bool bUnderline, bool bItalic) = 0;
+		virtual void GetFontInfo(LPVOID hFont, THtmlFontInfo& info) = 0;
+		virtual int GetTextWidth(LPVOID hFont, LPCTSTR pstrText, int cchText) = 0;
+		// the C width of a space, how far an italic run leans out of its last cell
+		virtual int GetSpaceOverhang(LPVOID hFont) = 0;
+		// false if there is no such image, or not yet
+		virtual bool GetImageSize(LPCTSTR pstrName, LPCTSTR pstrType, int& cx, int& cy) = 0;
+	};
+
+	class CHtmlLayout
+	{
+	public:
+		enum { RUN_TEXT, RUN_IMAGE };
+
+		typedef struct tagTRun
+		{
+			int iKind;
+			RECT rc;            // text starts at rc.left, rc.top; an image fills rc
+			RECT rcSource;      // the imagelist cell
+			LPVOID hFont;
+			DWORD dwColor;
+			bool bOpaque;       // <s> text, drawn on the selected background
+			int iText;          // the text, or the image name
+			int cchText;
+			int iType;          // the image restype, -1 for none
+		} TRun;
+
+		CHtmlLayout();
+
+		void Build(IHtmlLayoutHost* pHost, LPCTSTR pstrText, int cx, int cy, UINT uStyle, DWORD dwTextColor,
+			DWORD dwLinkHoverColor, LPCTSTR pstrHoverLink, int nLinkRects);
+
+		// false if an image wasn't there to measure, so the layout is only good for this paint
+		bool IsComplete() const;
+		int GetRunCount() const;
+		const TRun& GetRun(int iIndex) const;
+		LPCTSTR GetChars(int iChar) const;
+
+		// the links found, as the nLinkRects that DrawHtmlText hands back
+		int GetLinkCount() const;
+		// how many rects and texts were written, which can be one more than the links
+		int GetLinkRectCount() const;
+		int GetLinkTextCount() const;
+		const RECT& GetLinkRect(int iIndex) const;
+		LPCTSTR GetLinkText(int iIndex) const;
+
+		// what DT_CALCRECT makes of rc when the text is laid out at its top left
+		void GetCalcRect(RECT& rc) const;
+
+	private:
+		typedef std::basic_string<TCHAR> String;
+
+		void AddText(int x, int y, LPCTSTR pstrText, int cchText, LPVOID hFont, DWORD dwColor, bool bOpaque);
+		void AddImage(const RECT& rc, const RECT& rcSource, LPCTSTR pstrName, LPCTSTR pstrType);
+		int AddChars(LPCTSTR pstrText, int cchText);
+
+		std::vector<TRun> m_aRuns;
+		String m_sChars;
+		std::vector<RECT> m_aLinkRects;
+		std::vector<String> m_aLinks;
+		int m_nLinks;
+		int m_nLinkRects;
+		int m_nLinkTexts;
+		int m_cxMaxWidth;       // INT_MIN while nothing has been placed
+		int m_cyMinHeight;      // INT_MIN without an image
+		int m_cyEnd;
+		bool m_bComplete;
+	};
+
+	/////////////////////////////////////////////////////////////////////////////////////
+	//
+	// The layouts of one paint manager, most recently drawn first, keyed by everything
+	// Build reads. A layout holds font handles, so when the fonts change (uSerial moves on)
+	// every layout goes at once.
+
+	class CHtmlLayoutCache
+	{
+	public:
+		typedef struct tagTKey
+		{
+			std::basic_string<TCHAR> sText;
+			std::basic_string<TCHAR> sHoverLink;
+			bool bHoverLink;
+			int cx;
+			int cy;
+			UINT uStyle;
+			DWORD dwTextColor;
+			DWORD dwLinkHoverColor;
+			int nLinkRects;
+			int nScale;
+			UINT uSerial;
+
+			bool operator==(const tagTKey& key) const;
+		} TKey;
+
+		explicit CHtmlLayoutCache(int nCapacity = 256);
+		~CHtmlLayoutCache();
+
+		const CHtmlLayout* Find(const TKey& key);
+		// takes pLayout, and drops the least recently drawn layout when full
+		const CHtmlLayout* Add(const TKey& key, CHtmlLayout* pLayout);
+		void RemoveAll();
+		int GetCount() const;
+
+	private:
+		struct TKeyHash
+		{
+			size_t operator()(const TKey& key) const;
+		};
+		struct TEntry
+		{
+			CHtmlLayout* pLayout;
+			std::list<const TKey*>::iterator itOrder;
+		};
+		typedef std::unordered_map<TKey, TEntry, TKeyHash> EntryMap;
+
+		void CheckSerial(UINT uSerial);
+
+		EntryMap m_mEntries;
+		std::list<const TKey*> m_lOrder;
+		int m_nCapacity;
+		UINT m_uSerial;
+	};
+
+} // namespace DuiLib
+
+#endif // __UIHTMLLAYOUT_H__
@@ -1,5 +1,6 @@
 #include "StdAfx.h"
 #include <zmouse.h>
+#include <mutex>
 
 namespace DuiLib {
 
@@ -7,6 +8,22 @@ namespace DuiLib {
 	//
 	//
 
+	// what Windows has to have painted, in the rects it keeps the update region as
+	static void AddUpdateRegion(HWND hWnd, CDamageRegion& damage)
+	{
+		HRGN hRgn = ::CreateRectRgn(0, 0, 0, 0);
+		if( ::GetUpdateRgn(hWnd, hRgn, FALSE) > NULLREGION ) {
+			DWORD cbData = ::GetRegionData(hRgn, 0, NULL);
+			LPRGNDATA pData = (LPRGNDATA) new BYTE[cbData];
+			if( ::GetRegionData(hRgn, cbData, pData) != 0 ) {
+				const RECT* pRects = (const RECT*)pData->Buffer;
+				for( DWORD i = 0; i < pData->rdh.nCount; i++ ) damage.Add(pRects[i]);
+			}
+			delete[] (BYTE*)pData;
+		}
+		::DeleteObject(hRgn);
+	}
+
 	static void GetChildWndRect(HWND hWnd, HWND hChildWnd, RECT& rcChildWnd)
 	{
 		::GetWindowRect(hChildWnd, &rcChildWnd);
@@ -50,15 +67,44 @@ namespace DuiLib {
 		bool bPickNext;
 	} FINDSHORTCUT;
 
-	typedef struct tagTIMERINFO
+
+	// a.png drawn at 150% is a@150.png
+	static CDuiString MakeScaledImageName(LPCTSTR pstrName, UINT uScale)
 	{
-		CControlUI* pSender;
-		UINT nLocalID;
-		HWND hWnd;
-		UINT uWinTimer;
-		bool bKilled;
-	} TIMERINFO;
+		CDuiString sName = pstrName;
+		CDuiString sScale;
+		sScale.Format(_T("@%u"), uScale);
+		int iDot = sName.ReverseFind(_T('.'));
+		if( iDot < 0 || iDot < sName.ReverseFind(_T('/')) || iDot < sName.ReverseFind(_T('\\')) ) return sName + sScale;
+		return sName.Left(iDot) + sScale + sName.Mid(iDot);
+	}
 
+	// What the image cache keeps an image made for a scale under. No file name starts with
+	// '|', so these never meet the names of the images themselves.
+	static CDuiString MakeScaledImageKey(LPCTSTR pstrName, UINT uScale)
+	{
+		CDuiString sKey;
+		sKey.Format(_T("|%u|"), uScale);
+		return sKey + pstrName;
+	}
+
+	static LPCTSTR ParseScaledImageKey(LPCTSTR pstrKey, UINT* puScale)
+	{
+		*puScale = 100;
+		if( pstrKey[0] != _T('|') ) return pstrKey;
+		LPTSTR pstr = NULL;
+		UINT uScale = _tcstoul(pstrKey + 1, &pstr, 10);
+		if( pstr == NULL || *pstr != _T('|') || uScale == 0 ) return pstrKey;
+		*puScale = uScale;
+		return pstr + 1;
+	}
+
+	// the image itself or what it was made into for any scale
+	static bool IsImageKeyOf(const CImageCache::Key& sKey, const CImageCache::Key& sName)
+	{
+		UINT uScale = 100;
+		return sName == ParseScaledImageKey(sKey.c_str(), &uScale);
+	}
 
 	tagTDrawInfo::tagTDrawInfo()
 	{
@@ -154,10 +200,10 @@ namespace DuiLib {
 		}
 
 		// DPIԴ
-		if (paintManager->GetDPIObj()->GetScale() != 100) {
-			CDuiString sScale;
-			sScale.Format(_T("@%d."), paintManager->GetDPIObj()->GetScale());
-			sImageName.Replace(_T("."), sScale);
+		sBaseName = sImageName;
+		uScale = paintManager->GetDPIObj()->GetScale();
+		if (uScale != 100) {
+			sImageName = MakeScaledImageName(sBaseName, uScale);
 		}
 	}
 	void tagTDrawInfo::Clear()
@@ -165,6 +211,8 @@ namespace DuiLib {
 		sDrawString.Empty();
 		sDrawModify.Empty();
 		sImageName.Empty();
+		sBaseName.Empty();
+		uScale = 100;
 
 		memset(&rcDest, 0, sizeof(RECT));
 		memset(&rcSource, 0, sizeof(RECT));
@@ -183,6 +231,9 @@ namespace DuiLib {
 
 	HPEN m_hUpdateRectPen = NULL;
 
+	// The cached resource zip is read by the image decode threads as well as the UI thread
+	static std::mutex g_ResourceZipLock;
+
 	HINSTANCE CPaintManagerUI::m_hResourceInstance = NULL;
 	CDuiString CPaintManagerUI::m_pStrResourcePath;
 	CDuiString CPaintManagerUI::m_pStrResourceZip;
@@ -197,6 +248,9 @@ namespace DuiLib {
 	short CPaintManagerUI::m_S = 100;
 	short CPaintManagerUI::m_L = 100;
 	CStdPtrArray CPaintManagerUI::m_aPreMessages;
+	CImageCache* CPaintManagerUI::m_pImageCache = NULL;
+	CImageCache* CPaintManagerUI::m_pGifCache = NULL;
+	UINT CPaintManagerUI::m_uResourceSerial = 0;
 	CStdPtrArray CPaintManagerUI::m_aPlugins;
 
 	CPaintManagerUI::CPaintManagerUI() :
@@ -210,15 +264,22 @@ namespace DuiLib {
 		m_hbmpBackground(NULL),
 		m_pBackgroundBits(NULL),
 		m_hwndTooltip(NULL),
-		m_uTimerID(0x1000),
 		m_pRoot(NULL),
 		m_pFocus(NULL),
 		m_pEventHover(NULL),
 		m_pEventClick(NULL),
 		m_pEventKey(NULL),
+		m_pHitTest(new CHitTestIndex),
+		m_pClock(new CAnimationClock),
+		m_dwClockFire(0),
+		m_bClockSet(false),
+		m_bClockTicking(false),
+		m_pHtmlLayouts(new CHtmlLayoutCache),
+		m_pDamage(new CDamageRegion),
 		m_bFirstLayout(true),
 		m_bFocusNeeded(false),
 		m_bUpdateNeeded(false),
+		m_bFullLayout(false),
 		m_bMouseTracking(false),
 		m_bMouseCapture(false),
 		m_bUsedVirtualWnd(false),
@@ -281,7 +342,7 @@ namespace DuiLib {
 		::ZeroMemory(&m_rcSizeBox, sizeof(m_rcSizeBox));
 		::ZeroMemory(&m_rcCaption, sizeof(m_rcCaption));
 		::ZeroMemory(&m_rcLayeredInset, sizeof(m_rcLayeredInset));
-		::ZeroMemory(&m_rcLayeredUpdate, sizeof(m_rcLayeredUpdate));
+		::ZeroMemory(&m_PaintStats, sizeof(m_PaintStats));
 		m_ptLastMousePos.x = m_ptLastMousePos.y = -1;
 
 		m_pGdiplusStartupInput = new Gdiplus::GdiplusStartupInput;
@@ -335,6 +396,10 @@ namespace DuiLib {
 			delete m_pDPI;
 			m_pDPI = NULL;
 		}
+		delete m_pHitTest;
+		delete m_pClock;
+		delete m_pHtmlLayouts;
+		delete m_pDamage;
 	}
 
 	void CPaintManagerUI::Init(HWND hWnd, LPCTSTR pstrName)
@@ -449,6 +514,7 @@ namespace DuiLib {
 	void CPaintManagerUI::SetResourceZip(LPVOID pVoid, unsigned int len, LPCTSTR password)
 	{
 		if( m_pStrResourceZip == _T("membuffer") ) return;
+		std::unique_lock<std::mutex> lock(g_ResourceZipLock);
 		if( m_bCachedResourceZip && m_hResourceZip != NULL ) {
 			CloseZip((HZIP)m_hResourceZip);
 			m_hResourceZip = NULL;
@@ -471,6 +537,7 @@ namespace DuiLib {
 	void CPaintManagerUI::SetResourceZip(LPCTSTR pStrPath, bool bCachedResourceZip, LPCTSTR password)
 	{
 		if( m_pStrResourceZip == pStrPath && m_bCachedResourceZip == bCachedResourceZip ) return;
+		std::unique_lock<std::mutex> lock(g_ResourceZipLock);
 		if( m_bCachedResourceZip && m_hResourceZip != NULL ) {
 			CloseZip((HZIP)m_hResourceZip);
 			m_hResourceZip = NULL;
@@ -490,6 +557,113 @@ namespace DuiLib {
 #endif
 		}
 	}
+
+	LPBYTE CPaintManagerUI::LoadResourceZipItem(LPCTSTR pstrName, DWORD* pdwSize, int* piView)
+	{
+		// Items of the cached zip that are stored, or were inflated by PrefetchResourceZip, are
+		// handed out in place and *piView is their index; the rest are unzipped into a new BYTE[]
+		// and *piView is -1. Either way FreeResourceZipItem gives the data back.
+		*pdwSize = 0;
+		*piView = -1;
+		std::unique_lock<std::mutex> lock(g_ResourceZipLock);
+		HZIP hz = NULL;
+		if( m_bCachedResourceZip ) hz = (HZIP)m_hResourceZip;
+		else {
+			CDuiString sFile = CPaintManagerUI::GetResourcePath();
+			sFile += CPaintManagerUI::GetResourceZip();
+#ifdef UNICODE
+			char* pwd = w2a((wchar_t*)m_pStrResourceZipPwd.GetData());
+			hz = OpenZip(sFile.GetData(), pwd);
+			if(pwd) delete[] pwd;
+#else
+			hz = OpenZip(sFile.GetData(), m_pStrResourceZipPwd.GetData());
+#endif
+		}
+		if( hz == NULL ) return NULL;
+
+		LPBYTE pData = NULL;
+		ZIPENTRY ze;
+		int i = 0;
+		CDuiString key = pstrName;
+		key.Replace(_T("\\"), _T("/"));
+		if( FindZipItem(hz, key, true, &i, &ze) == 0 && ze.unc_size > 0 ) {
+			const void* pView = NULL;
+			unsigned int nLen = 0;
+			if( m_bCachedResourceZip && GetZipItemData(hz, i, &pView, &nLen) == 0 ) {
+				pData = (LPBYTE)pView;
+				*pdwSize = nLen;
+				*piView = i;
+			}
+			else {
+				pData = new BYTE[ ze.unc_size ];
+				int res = UnzipItem(hz, i, pData, ze.unc_size);
+				if( res != 0x00000000 && res != 0x00000600) {
+					delete[] pData;
+					pData = NULL;
+				}
+				else *pdwSize = ze.unc_size;
+			}
+		}
+		if( !m_bCachedResourceZip ) CloseZip(hz);
+		return pData;
+	}
+
+	void CPaintManagerUI::FreeResourceZipItem(LPBYTE pData, int iView)
+	{
+		if( pData == NULL ) return;
+		if( iView < 0 ) delete[] pData;
+		else {
+			std::unique_lock<std::mutex> lock(g_ResourceZipLock);
+			if( m_hResourceZip != NULL ) ReleaseZipItemData((HZIP)m_hResourceZip, iView);
+		}
+	}
+
+	static void CollectResourceZipNames(CMarkupNode& node, CStdStringPtrMap& names, int nDepth)
+	{
+		int nAttributes = node.GetAttributeCount();
+		for( int i = 0; i < nAttributes; i++ ) {
+			CDuiString sValue = node.GetAttributeValue(i);
+			sValue.Replace(_T("\\"), _T("/"));
+			names.Insert(sValue, NULL);
+			// the file='...' parts of image strings
+			for( int iFile = sValue.Find(_T("file='")); iFile >= 0; iFile = sValue.Find(_T("file='"), iFile + 6) ) {
+				int iEnd = sValue.Find(_T('\''), iFile + 6);
+				if( iEnd < 0 ) break;
+				names.Insert(sValue.Mid(iFile + 6, iEnd - iFile - 6), NULL);
+			}
+		}
+		LPCTSTR pstrSource = node.GetAttributeValue(_T("source"));
+		if( _tcsicmp(node.GetName(), _T("Include")) == 0 && *pstrSource != _T('\0') && nDepth < 8 ) {
+			CMarkup xml;
+			if( xml.LoadFromFile(pstrSource) ) {
+				CMarkupNode root = xml.GetRoot();
+				CollectResourceZipNames(root, names, nDepth + 1);
+			}
+		}
+		for( CMarkupNode child = node.GetChild(); child.IsValid(); child = child.GetSibling() ) {
+			CollectResourceZipNames(child, names, nDepth);
+		}
+	}
+
+	void CPaintManagerUI::PrefetchResourceZip(LPCTSTR pstrSkinFile)
+	{
+		// Every attribute value of the skin, its includes and the file='...' parts of image strings
+		// are offered to the zip, which skips whatever is not one of its items. The workers inflate
+		// the rest while the first window is being built.
+		if( !m_bCachedResourceZip || m_hResourceZip == NULL ) return;
+		CMarkup xml;
+		if( !xml.LoadFromFile(pstrSkinFile) ) return;
+		CStdStringPtrMap names;
+		CMarkupNode root = xml.GetRoot();
+		CollectResourceZipNames(root, names, 0);
+		int nNames = names.GetSize();
+		if( nNames == 0 ) return;
+		LPCTSTR* ppstrNames = new LPCTSTR[nNames];
+		for( int i = 0; i < nNames; i++ ) ppstrNames[i] = names.GetAt(i);
+		std::unique_lock<std::mutex> lock(g_ResourceZipLock);
+		if( m_hResourceZip != NULL ) PrefetchZipItems((HZIP)m_hResourceZip, ppstrNames, nNames);
+		delete[] ppstrNames;
+	}
 	
 	void CPaintManagerUI::SetResourceType(int nType)
 	{
@@ -517,10 +691,17 @@ namespace DuiLib {
 			m_H = CLAMP(H, 0, 360);
 			m_S = CLAMP(S, 0, 200);
 			m_L = CLAMP(L, 0, 200);
-			AdjustSharedImagesHSL();
+			// every window's images go to AdjustImages together so they are shared out between the cores
+			CStdPtrArray aImages;
+			GetImagesHSL(m_SharedResInfo, aImages);
+			for( int i = 0; i < m_aPreMessages.GetSize(); i++ ) {
+				CPaintManagerUI* pManager = static_cast<CPaintManagerUI*>(m_aPreMessages[i]);
+				if( pManager != NULL ) GetImagesHSL(pManager->m_ResInfo, aImages);
+			}
+			CRenderEngine::AdjustImages(m_bUseHSL, reinterpret_cast<TImageInfo**>(aImages.GetData()), aImages.GetSize(), m_H, m_S, m_L);
 			for( int i = 0; i < m_aPreMessages.GetSize(); i++ ) {
 				CPaintManagerUI* pManager = static_cast<CPaintManagerUI*>(m_aPreMessages[i]);
-				if( pManager != NULL ) pManager->AdjustImagesHSL();
+				if( pManager != NULL ) pManager->Invalidate();
 			}
 		}
 	}
@@ -692,6 +873,11 @@ namespace DuiLib {
 		m_bShowUpdateRect = show;
 	}
 
+	const TPaintStats& CPaintManagerUI::GetPaintStats() const
+	{
+		return m_PaintStats;
+	}
+
 	BYTE CPaintManagerUI::GetOpacity() const
 	{
 		return m_nOpacity;
@@ -961,6 +1147,12 @@ namespace DuiLib {
 		}
 		// Custom handling of events
 		switch( uMsg ) {
+		case WM_USER_IMAGE_READY:
+			{
+				// an image this window was painted without has been decoded
+				NeedFullLayout();
+			}
+			return true;
 		case WM_APP + 1:
 			{
 				for( int i = 0; i < m_aDelayedCleanup.GetSize(); i++ ) 
@@ -1039,23 +1231,26 @@ namespace DuiLib {
 				if( m_bUpdateNeeded ) {
 					m_bUpdateNeeded = false;
 					if( !::IsRectEmpty(&rcClient) && !::IsIconic(m_hWndPaint) ) {
-						if( m_pRoot->IsUpdateNeeded() ) {
+						if( m_pRoot->IsUpdateNeeded() || m_bFullLayout ) {
 							if( m_hDcOffscreen != NULL ) ::DeleteDC(m_hDcOffscreen);
 							if( m_hbmpOffscreen != NULL ) ::DeleteObject(m_hbmpOffscreen);
 							m_hDcOffscreen = NULL;
 							m_hbmpOffscreen = NULL;
 							m_pRoot->SetPos(rcClient, true);
+							m_bFullLayout = false;
 							bNeedSizeMsg = true;
 						}
-						else {
-							CControlUI* pControl = NULL;
-							m_aFoundControls.Empty();
-							m_pRoot->FindControl(__FindControlsFromUpdate, NULL, UIFIND_VISIBLE | UIFIND_ME_FIRST | UIFIND_UPDATETEST);
-							for( int it = 0; it < m_aFoundControls.GetSize(); it++ ) {
-								pControl = static_cast<CControlUI*>(m_aFoundControls[it]);
-								if( !pControl->IsFloat() ) pControl->SetPos(pControl->GetPos(), true);
-								else pControl->SetPos(pControl->GetRelativePos(), true);
-							}
+						// Containers don't lay out children that kept their place and didn't ask
+						// for it, so whatever asked below them is laid out here. Parents come
+						// first, and whatever a parent already laid out is skipped.
+						CControlUI* pControl = NULL;
+						m_aFoundControls.Empty();
+						m_pRoot->FindControl(__FindControlsFromUpdate, NULL, UIFIND_VISIBLE | UIFIND_ME_FIRST);
+						for( int it = 0; it < m_aFoundControls.GetSize(); it++ ) {
+							pControl = static_cast<CControlUI*>(m_aFoundControls[it]);
+							if( !pControl->IsUpdateNeeded() ) continue;
+							// floats too: SetFloatPos placed them at an absolute rect, SetPos takes one
+							pControl->SetPos(pControl->GetPos(), true);
 						}
 						// We'll want to notify the window when it is first initialized
 						// with the correct layout. The window form would take the time
@@ -1079,12 +1274,21 @@ namespace DuiLib {
 					DWORD dwNewExStyle = dwExStyle | WS_EX_LAYERED;
 					if(dwExStyle != dwNewExStyle) ::SetWindowLong(m_hWndPaint, GWL_EXSTYLE, dwNewExStyle);
 					m_bOffscreenPaint = true;
-					UnionRect(&rcPaint, &rcPaint, &m_rcLayeredUpdate);
-					if( rcPaint.right > rcClient.right ) rcPaint.right = rcClient.right;
-					if( rcPaint.bottom > rcClient.bottom ) rcPaint.bottom = rcClient.bottom;
-					::ZeroMemory(&m_rcLayeredUpdate, sizeof(m_rcLayeredUpdate));
 				}
 
+				// What the controls invalidated and what Windows wants painted on its own, taken
+				// after the layout so what the layout invalidated goes out in this frame. Whatever
+				// is invalidated while painting goes into the next one.
+				AddUpdateRegion(m_hWndPaint, *m_pDamage);
+				m_pDamage->Clip(rcClient);
+				CDamageRegion damage(*m_pDamage);
+				m_pDamage->RemoveAll();
+				RECT rcBounds = damage.GetBounds();
+				m_PaintStats.dwFrames++;
+				m_PaintStats.nRects = damage.GetCount();
+				m_PaintStats.dwPixels = damage.GetArea();
+				m_PaintStats.dwBoundsPixels = (rcBounds.right - rcBounds.left) * (rcBounds.bottom - rcBounds.top);
+
 				if( m_bOffscreenPaint && m_hbmpOffscreen == NULL ) {
 					m_hDcOffscreen = ::CreateCompatibleDC(m_hDcPaint);
 					m_hbmpOffscreen = CRenderEngine::CreateARGB32Bitmap(m_hDcPaint, dwWidth, dwHeight, (LPBYTE*)&m_pOffscreenBits); 
@@ -1096,30 +1300,29 @@ namespace DuiLib {
 				::BeginPaint(m_hWndPaint, &ps);
 				if( m_bOffscreenPaint ) {
 					HBITMAP hOldBitmap = (HBITMAP) ::SelectObject(m_hDcOffscreen, m_hbmpOffscreen);
-					int iSaveDC = ::SaveDC(m_hDcOffscreen);
-					if (m_bLayered) {
-						for( LONG y = rcClient.bottom - rcPaint.bottom; y < rcClient.bottom - rcPaint.top; ++y ) {
-							for( LONG x = rcPaint.left; x < rcPaint.right; ++x ) {
-								int i = (y * dwWidth + x) * 4;
-								*(DWORD*)(&m_pOffscreenBits[i]) = 0;
-							}
+					for( int it = 0; it < damage.GetCount(); it++ ) {
+						const RECT& rcDirty = damage.GetAt(it);
+						int iSaveDC = ::SaveDC(m_hDcOffscreen);
+						// a control drawing past the rect it was given mustn't land on pixels
+						// another rect has already cleared and painted
+						::IntersectClipRect(m_hDcOffscreen, rcDirty.left, rcDirty.top, rcDirty.right, rcDirty.bottom);
+						// the offscreen bitmap is bottom-up, so rcDirty's rows are counted from the bottom
+						RECT rcLayeredBits = { rcDirty.left, rcClient.bottom - rcDirty.bottom, rcDirty.right, rcClient.bottom - rcDirty.top };
+						if (m_bLayered) {
+							CPixelKernel::FillRect((DWORD*)m_pOffscreenBits, dwWidth, rcLayeredBits, 0);
 						}
-					}
-					m_pRoot->DoPaint(m_hDcOffscreen, rcPaint);
-					DrawCaret(m_hDcOffscreen, rcPaint);
-					for( int i = 0; i < m_aPostPaintControls.GetSize(); i++ ) {
-						CControlUI* pPostPaintControl = static_cast<CControlUI*>(m_aPostPaintControls[i]);
-						pPostPaintControl->DoPostPaint(m_hDcOffscreen, rcPaint);
+						m_pRoot->DoPaint(m_hDcOffscreen, rcDirty);
+						DrawCaret(m_hDcOffscreen, rcDirty);
+						for( int i = 0; i < m_aPostPaintControls.GetSize(); i++ ) {
+							CControlUI* pPostPaintControl = static_cast<CControlUI*>(m_aPostPaintControls[i]);
+							pPostPaintControl->DoPostPaint(m_hDcOffscreen, rcDirty);
+						}
+						if( m_bLayered ) {
+							CPixelKernel::RestoreAlpha((DWORD*)m_pOffscreenBits, dwWidth, rcLayeredBits);
+						}
+						::RestoreDC(m_hDcOffscreen, iSaveDC);
 					}
 					if( m_bLayered ) {
-						for( LONG y = rcClient.bottom - rcPaint.bottom; y < rcClient.bottom - rcPaint.top; ++y ) {
-							for( LONG x = rcPaint.left; x < rcPaint.right; ++x ) {
-								int i = (y * dwWidth + x) * 4;
-								if((m_pOffscreenBits[i + 3] == 0)&& (m_pOffscreenBits[i + 0] != 0 || m_pOffscreenBits[i + 1] != 0|| m_pOffscreenBits[i + 2] != 0))
-									m_pOffscreenBits[i + 3] = 255;
-							}
-						}
-
 						for( int i = 0; i < m_aChildWnds.GetSize(); ) {
 							HWND hChildWnd = static_cast<HWND>(m_aChildWnds[i]);
 							if (!::IsWindow(hChildWnd)) {
@@ -1131,8 +1334,7 @@ namespace DuiLib {
 							RECT rcChildWnd;
 							GetChildWndRect(m_hWndPaint, hChildWnd, rcChildWnd);
 
-							RECT rcTemp = { 0 };
-							if( !::IntersectRect(&rcTemp, &rcPaint, &rcChildWnd) ) continue;
+							if( !damage.Intersects(rcChildWnd) ) continue;
 
 							COLORREF* pChildBitmapBits = NULL;
 							HDC hChildMemDC = ::CreateCompatibleDC(m_hDcOffscreen);
@@ -1140,20 +1342,13 @@ namespace DuiLib {
 							::ZeroMemory(pChildBitmapBits, (rcChildWnd.right - rcChildWnd.left)*(rcChildWnd.bottom - rcChildWnd.top)*4);
 							HBITMAP hOldChildBitmap = (HBITMAP) ::SelectObject(hChildMemDC, hChildBitmap);
 							::SendMessage(hChildWnd, WM_PRINT, (WPARAM)hChildMemDC,(LPARAM)(PRF_CHECKVISIBLE|PRF_CHILDREN|PRF_CLIENT|PRF_OWNED));
-							COLORREF* pChildBitmapBit;
-							for( LONG y = 0; y < rcChildWnd.bottom-rcChildWnd.top; y++ ) {
-								for( LONG x = 0; x < rcChildWnd.right-rcChildWnd.left; x++ ) {
-									pChildBitmapBit = pChildBitmapBits+y*(rcChildWnd.right-rcChildWnd.left) + x;
-									if (*pChildBitmapBit != 0x00000000) *pChildBitmapBit |= 0xff000000;
-								}
-							}
+							CPixelKernel::MakeOpaque((DWORD*)pChildBitmapBits, (rcChildWnd.right - rcChildWnd.left)*(rcChildWnd.bottom - rcChildWnd.top));
 							::BitBlt(m_hDcOffscreen, rcChildWnd.left, rcChildWnd.top, rcChildWnd.right - rcChildWnd.left, rcChildWnd.bottom - rcChildWnd.top, hChildMemDC, 0, 0, SRCCOPY);
 							::SelectObject(hChildMemDC, hOldChildBitmap);
 							::DeleteObject(hChildBitmap);
 							::DeleteDC(hChildMemDC);
 						}
 					}
-					::RestoreDC(m_hDcOffscreen, iSaveDC);
 
 					if( m_bLayered ) {
 						RECT rcWnd = { 0 };
@@ -1165,23 +1360,34 @@ namespace DuiLib {
 						g_fUpdateLayeredWindow(m_hWndPaint, m_hDcPaint, &ptPos, &sizeWnd, m_hDcOffscreen, &ptSrc, 0, &bf, ULW_ALPHA);
 					}
 					else {
-						::BitBlt(m_hDcPaint, rcPaint.left, rcPaint.top, rcPaint.right - rcPaint.left, rcPaint.bottom - rcPaint.top, m_hDcOffscreen, rcPaint.left, rcPaint.top, SRCCOPY);
+						for( int it = 0; it < damage.GetCount(); it++ ) {
+							const RECT& rcDirty = damage.GetAt(it);
+							::BitBlt(m_hDcPaint, rcDirty.left, rcDirty.top, rcDirty.right - rcDirty.left, rcDirty.bottom - rcDirty.top, m_hDcOffscreen, rcDirty.left, rcDirty.top, SRCCOPY);
+						}
 					}
 					::SelectObject(m_hDcOffscreen, hOldBitmap);
 
 					if( m_bShowUpdateRect ) {
-						CRenderEngine::DrawRect(m_hDcPaint, rcPaint, 1, 0xFFFF0000);
+						for( int it = 0; it < damage.GetCount(); it++ ) {
+							CRenderEngine::DrawRect(m_hDcPaint, damage.GetAt(it), 1, 0xFFFF0000);
+						}
+						DUITRACE(_T("paint %u: %d rects, %u pixels, %u in their bounds"), m_PaintStats.dwFrames,
+							m_PaintStats.nRects, m_PaintStats.dwPixels, m_PaintStats.dwBoundsPixels);
 					}
 				}
 				else {
 					// A standard paint job
-					int iSaveDC = ::SaveDC(m_hDcPaint);
-					m_pRoot->DoPaint(m_hDcPaint, rcPaint);
-					for( int i = 0; i < m_aPostPaintControls.GetSize(); i++ ) {
-						CControlUI* pPostPaintControl = static_cast<CControlUI*>(m_aPostPaintControls[i]);
-						pPostPaintControl->DoPostPaint(m_hDcPaint, rcPaint);
+					for( int it = 0; it < damage.GetCount(); it++ ) {
+						const RECT& rcDirty = damage.GetAt(it);
+						int iSaveDC = ::SaveDC(m_hDcPaint);
+						::IntersectClipRect(m_hDcPaint, rcDirty.left, rcDirty.top, rcDirty.right, rcDirty.bottom);
+						m_pRoot->DoPaint(m_hDcPaint, rcDirty);
+						for( int i = 0; i < m_aPostPaintControls.GetSize(); i++ ) {
+							CControlUI* pPostPaintControl = static_cast<CControlUI*>(m_aPostPaintControls[i]);
+							pPostPaintControl->DoPostPaint(m_hDcPaint, rcDirty);
+						}
+						::RestoreDC(m_hDcPaint, iSaveDC);
 					}
-					::RestoreDC(m_hDcPaint, iSaveDC);
 				}
 				// All Done!
 				::EndPaint(m_hWndPaint, &ps);
@@ -1244,25 +1450,29 @@ namespace DuiLib {
 					Invalidate(m_rtCaret);
 					m_bCaretActive = !m_bCaretActive;
 				}
-				else{
-					for( int i = 0; i < m_aTimers.GetSize(); i++ ) {
-						const TIMERINFO* pTimer = static_cast<TIMERINFO*>(m_aTimers[i]);
-						if(pTimer->hWnd == m_hWndPaint && 
-							pTimer->uWinTimer == LOWORD(wParam) && 
-							pTimer->bKilled == false)
-						{
-							TEventUI event = { 0 };
-							event.Type = UIEVENT_TIMER;
-							event.pSender = pTimer->pSender;
-							event.dwTimestamp = ::GetTickCount();
-							event.ptMouse = m_ptLastMousePos;
-							event.wKeyState = MapKeyState();
-							event.wParam = pTimer->nLocalID;
-							event.lParam = lParam;
-							pTimer->pSender->Event(event);
-							break;
-						}
+				else if(CLOCK_TIMERID == LOWORD(wParam)){
+					// Every control timer due this frame runs now, so animations step together and
+					// what they invalidate goes out in one paint. A timer killed by an earlier one
+					// in the same tick, or whose control is gone, is skipped.
+					DWORD dwNow = ::GetTickCount();
+					std::vector<CAnimationClock::TDue> aDue;
+					m_pClock->Tick(dwNow, aDue);
+					m_bClockSet = false;
+					m_bClockTicking = true;
+					for( size_t i = 0; i < aDue.size(); i++ ) {
+						if( !m_pClock->IsCurrent(aDue[i]) ) continue;
+						TEventUI event = { 0 };
+						event.Type = UIEVENT_TIMER;
+						event.pSender = aDue[i].pControl;
+						event.dwTimestamp = dwNow;
+						event.ptMouse = m_ptLastMousePos;
+						event.wKeyState = MapKeyState();
+						event.wParam = aDue[i].nTimerID;
+						event.lParam = lParam;
+						aDue[i].pControl->Event(event);
 					}
+					m_bClockTicking = false;
+					ScheduleClock();
 				}
 
 			}
@@ -1765,13 +1975,31 @@ namespace DuiLib {
 	void CPaintManagerUI::NeedUpdate()
 	{
 		m_bUpdateNeeded = true;
+		m_pHitTest->Invalidate();
+	}
+
+	void CPaintManagerUI::NeedHitTestUpdate()
+	{
+		m_pHitTest->Invalidate();
+	}
+
+	void CPaintManagerUI::NeedFullLayout()
+	{
+		m_bFullLayout = true;
+		if( m_pRoot != NULL ) m_pRoot->NeedUpdate();
+		NeedUpdate();
+	}
+
+	bool CPaintManagerUI::IsFullLayoutNeeded() const
+	{
+		return m_bFullLayout;
 	}
 
 	void CPaintManagerUI::Invalidate()
 	{
 		RECT rcClient = { 0 };
 		::GetClientRect(m_hWndPaint, &rcClient);
-		::UnionRect(&m_rcLayeredUpdate, &m_rcLayeredUpdate, &rcClient);
+		m_pDamage->Add(rcClient);
 		::InvalidateRect(m_hWndPaint, NULL, FALSE);
 	}
 
@@ -1781,7 +2009,7 @@ namespace DuiLib {
 		if( rcItem .top < 0 ) rcItem.top = 0;
 		if( rcItem.right < rcItem.left ) rcItem.right = rcItem.left;
 		if( rcItem.bottom < rcItem.top ) rcItem.bottom = rcItem.top;
-		::UnionRect(&m_rcLayeredUpdate, &m_rcLayeredUpdate, &rcItem);
+		m_pDamage->Add(rcItem);
 		::InvalidateRect(m_hWndPaint, &rcItem, FALSE);
 	}
 
@@ -1805,8 +2033,10 @@ namespace DuiLib {
 		}
 		// Set the dialog root element
 		m_pRoot = pControl;
+		m_pHitTest->Invalidate();
 		// Go ahead...
 		m_bUpdateNeeded = true;
+		m_bFullLayout = true;
 		m_bFirstLayout = true;
 		m_bFocusNeeded = true;
 		// Initiate all control
@@ -1828,6 +2058,7 @@ namespace DuiLib {
 		if( pControl == m_pEventHover ) m_pEventHover = NULL;
 		if( pControl == m_pEventClick ) m_pEventClick = NULL;
 		if( pControl == m_pFocus ) m_pFocus = NULL;
+		m_pHitTest->Invalidate();
 		KillTimer(pControl);
 		const CDuiString& sName = pControl->GetName();
 		if( !sName.IsEmpty() ) {
@@ -1917,6 +2148,12 @@ namespace DuiLib {
 
 	void CPaintManagerUI::Term()
 	{
+		CDialogBuilder::ClearTemplateCache();
+		// the decode threads read the zip, so they go first
+		delete m_pImageCache;
+		m_pImageCache = NULL;
+		delete m_pGifCache;
+		m_pGifCache = NULL;
 		if( m_bCachedResourceZip && m_hResourceZip != NULL ) {
 			CloseZip((HZIP)m_hResourceZip);
 			m_hResourceZip = NULL;
@@ -1947,7 +2184,7 @@ namespace DuiLib {
 			prcNewWindow = &rc;
 		}
 		SetWindowPos(GetPaintWindow(), NULL, prcNewWindow->left, prcNewWindow->top, prcNewWindow->right - prcNewWindow->left, prcNewWindow->bottom - prcNewWindow->top, SWP_NOZORDER | SWP_NOACTIVATE);
-		if (GetRoot() != NULL) GetRoot()->NeedUpdate();
+		NeedFullLayout();
 		::PostMessage(GetPaintWindow(), WM_USER_SET_DPI, 0, 0);
 	}
 
@@ -1987,6 +2224,7 @@ namespace DuiLib {
 
 	void DuiLib::CPaintManagerUI::RebuildFont(TFontInfo * pFontInfo)
 	{
+		m_uResourceSerial++;
 		::DeleteObject(pFontInfo->hFont);
 		LOGFONT lf = { 0 };
 		::GetObject(::GetStockObject(DEFAULT_GUI_FONT), sizeof(LOGFONT), &lf);
@@ -2072,81 +2310,48 @@ namespace DuiLib {
 	{
 		ASSERT(pControl!=NULL);
 		ASSERT(uElapse>0);
-		for( int i = 0; i< m_aTimers.GetSize(); i++ ) {
-			TIMERINFO* pTimer = static_cast<TIMERINFO*>(m_aTimers[i]);
-			if( pTimer->pSender == pControl
-				&& pTimer->hWnd == m_hWndPaint
-				&& pTimer->nLocalID == nTimerID ) {
-					if( pTimer->bKilled == true ) {
-						if( ::SetTimer(m_hWndPaint, pTimer->uWinTimer, uElapse, NULL) ) {
-							pTimer->bKilled = false;
-							return true;
-						}
-						return false;
-					}
-					return false;
-			}
-		}
-
-		m_uTimerID = (++m_uTimerID) % 0xF0; //0xf1-0xfe;
-		if( !::SetTimer(m_hWndPaint, m_uTimerID, uElapse, NULL) ) return FALSE;
-		TIMERINFO* pTimer = new TIMERINFO;
-		if( pTimer == NULL ) return FALSE;
-		pTimer->hWnd = m_hWndPaint;
-		pTimer->pSender = pControl;
-		pTimer->nLocalID = nTimerID;
-		pTimer->uWinTimer = m_uTimerID;
-		pTimer->bKilled = false;
-		return m_aTimers.Add(pTimer);
+		if( !m_pClock->SetTimer(pControl, nTimerID, uElapse, ::GetTickCount()) ) return false;
+		ScheduleClock();
+		return true;
 	}
 
 	bool CPaintManagerUI::KillTimer(CControlUI* pControl, UINT nTimerID)
 	{
 		ASSERT(pControl!=NULL);
-		for( int i = 0; i< m_aTimers.GetSize(); i++ ) {
-			TIMERINFO* pTimer = static_cast<TIMERINFO*>(m_aTimers[i]);
-			if( pTimer->pSender == pControl
-				&& pTimer->hWnd == m_hWndPaint
-				&& pTimer->nLocalID == nTimerID )
-			{
-				if( pTimer->bKilled == false ) {
-					if( ::IsWindow(m_hWndPaint) ) ::KillTimer(pTimer->hWnd, pTimer->uWinTimer);
-					pTimer->bKilled = true;
-					return true;
-				}
-			}
-		}
-		return false;
+		// the window timer is left as it is; if nothing is due when it fires it is stopped then
+		return m_pClock->KillTimer(pControl, nTimerID);
 	}
 
 	void CPaintManagerUI::KillTimer(CControlUI* pControl)
 	{
 		ASSERT(pControl!=NULL);
-		int count = m_aTimers.GetSize();
-		for( int i = 0, j = 0; i < count; i++ ) {
-			TIMERINFO* pTimer = static_cast<TIMERINFO*>(m_aTimers[i - j]);
-			if( pTimer->pSender == pControl && pTimer->hWnd == m_hWndPaint ) {
-				if( pTimer->bKilled == false ) ::KillTimer(pTimer->hWnd, pTimer->uWinTimer);
-				delete pTimer;
-				m_aTimers.Remove(i - j);
-				j++;
-			}
-		}
+		m_pClock->KillTimer(pControl);
 	}
 
 	void CPaintManagerUI::RemoveAllTimers()
 	{
-		for( int i = 0; i < m_aTimers.GetSize(); i++ ) {
-			TIMERINFO* pTimer = static_cast<TIMERINFO*>(m_aTimers[i]);
-			if( pTimer->hWnd == m_hWndPaint ) {
-				if( pTimer->bKilled == false ) {
-					if( ::IsWindow(m_hWndPaint) ) ::KillTimer(m_hWndPaint, pTimer->uWinTimer);
-				}
-				delete pTimer;
-			}
-		}
+		m_pClock->RemoveAll();
+		if( m_bClockSet && ::IsWindow(m_hWndPaint) ) ::KillTimer(m_hWndPaint, CLOCK_TIMERID);
+		m_bClockSet = false;
+	}
 
-		m_aTimers.Empty();
+	void CPaintManagerUI::ScheduleClock()
+	{
+		// a tick sets the window timer once all its timers have run
+		if( m_bClockTicking || m_hWndPaint == NULL ) return;
+		DWORD dwNow = ::GetTickCount();
+		int iDelay = m_pClock->GetNextDue(dwNow);
+		if( iDelay < 0 ) {
+			::KillTimer(m_hWndPaint, CLOCK_TIMERID);
+			m_bClockSet = false;
+			return;
+		}
+		UINT uElapse = MAX((UINT)iDelay, (UINT)USER_TIMER_MINIMUM);
+		// already set to fire in time
+		if( m_bClockSet && (int)(m_dwClockFire - (dwNow + uElapse)) <= 0 ) return;
+		if( !::SetTimer(m_hWndPaint, CLOCK_TIMERID, uElapse, NULL) ) return;
+		m_dwClockFire = dwNow + uElapse;
+		m_bClockSet = true;
 	}
 
 	void CPaintManagerUI::SetCapture()
@@ -2174,6 +2379,15 @@ namespace DuiLib {
 
 	void CPaintManagerUI::SetPainting(bool bIsPainting)
 	{
+		// cached images are only evicted once no window is in the middle of a paint
+		if( bIsPainting && !m_bIsPainting ) {
+			GetImageCache()->BeginUse();
+			GetGifCache()->BeginUse();
+		}
+		else if( !bIsPainting && m_bIsPainting ) {
+			if( m_pImageCache != NULL ) m_pImageCache->EndUse();
+			if( m_pGifCache != NULL ) m_pGifCache->EndUse();
+		}
 		m_bIsPainting = bIsPainting;
 	}
 
@@ -2508,6 +2722,7 @@ namespace DuiLib {
 		HFONT hFont = ::CreateFontIndirect(&lf);
 		if( hFont == NULL ) return;
 
+		m_uResourceSerial++;
 		if (bShared)
 		{
 			::DeleteObject(m_SharedResInfo.m_DefaultFontInfo.hFont);
@@ -2581,6 +2796,7 @@ namespace DuiLib {
 			::GetTextMetrics(m_hDcPaint, &pFontInfo->tm);
 			::SelectObject(m_hDcPaint, hOldFont);
 		}
+		m_uResourceSerial++;
 		TCHAR idBuffer[16];
 		::ZeroMemory(idBuffer, sizeof(idBuffer));
 		_itot(id, idBuffer, 10);
@@ -2624,6 +2840,7 @@ namespace DuiLib {
 	void CPaintManagerUI::AddFontArray(LPCTSTR pstrPath) {
 		LPBYTE pData = NULL;
 		DWORD dwSize = 0;
+		int iZipView = -1;
 		do
 		{
 			CDuiString sFile = CPaintManagerUI::GetResourcePath();
@@ -2647,36 +2864,7 @@ namespace DuiLib {
 				}
 			}
 			else {
-				sFile += CPaintManagerUI::GetResourceZip();
-				HZIP hz = NULL;
-				if (CPaintManagerUI::IsCachedResourceZip()) hz = (HZIP)CPaintManagerUI::GetResourceZipHandle();
-				else {
-					CDuiString sFilePwd = CPaintManagerUI::GetResourceZipPwd();
-#ifdef UNICODE
-					char* pwd = w2a((wchar_t*)sFilePwd.GetData());
-					hz = OpenZip(sFile.GetData(), pwd);
-					if (pwd) delete[] pwd;
-#else
-					hz = OpenZip(sFile.GetData(), sFilePwd.GetData());
-#endif
-				}
-				if (hz == NULL) break;
-				ZIPENTRY ze;
-				int i = 0;
-				CDuiString key = pstrPath;
-				key.Replace(_T("\\"), _T("/"));
-				if (FindZipItem(hz, key, true, &i, &ze) != 0) break;
-				dwSize = ze.unc_size;
-				if (dwSize == 0) break;
-				pData = new BYTE[dwSize];
-				int res = UnzipItem(hz, i, pData, dwSize);
-				if (res != 0x00000000 && res != 0x00000600) {
-					delete[] pData;
-					pData = NULL;
-					if (!CPaintManagerUI::IsCachedResourceZip()) CloseZip(hz);
-					break;
-				}
-				if (!CPaintManagerUI::IsCachedResourceZip()) CloseZip(hz);
+				pData = CPaintManagerUI::LoadResourceZipItem(pstrPath, &dwSize, &iZipView);
 			}
 
 		} while (0);
@@ -2700,8 +2888,12 @@ namespace DuiLib {
 			}
 			break;
 		}
+		if (pData == NULL) return;
 		DWORD nFonts;
 		HANDLE hFont = ::AddFontMemResourceEx(pData, dwSize, NULL, &nFonts);
+		// the font keeps its own copy
+		if (iZipView >= 0) CPaintManagerUI::FreeResourceZipItem(pData, iZipView);
+		else delete[] pData;
 		m_aFonts.Add(hFont);
 	}
 	HFONT CPaintManagerUI::GetFont(int id)
@@ -2796,6 +2988,7 @@ namespace DuiLib {
 
 	void CPaintManagerUI::RemoveFont(HFONT hFont, bool bShared)
 	{
+		m_uResourceSerial++;
 		TFontInfo* pFontInfo = NULL;
 		if (bShared)
 		{
@@ -2835,6 +3028,7 @@ namespace DuiLib {
 
 	void CPaintManagerUI::RemoveFont(int id, bool bShared)
 	{
+		m_uResourceSerial++;
 		TCHAR idBuffer[16];
 		::ZeroMemory(idBuffer, sizeof(idBuffer));
 		_itot(id, idBuffer, 10);
@@ -2864,6 +3058,7 @@ namespace DuiLib {
 
 	void CPaintManagerUI::RemoveAllFonts(bool bShared)
 	{
+		m_uResourceSerial++;
 		TFontInfo* pFontInfo;
 		if (bShared)
 		{
@@ -2912,6 +3107,16 @@ namespace DuiLib {
 		return pFontInfo;
 	}
 
+	UINT CPaintManagerUI::GetResourceSerial()
+	{
+		return m_uResourceSerial;
+	}
+
+	CHtmlLayoutCache* CPaintManagerUI::GetHtmlLayoutCache()
+	{
+		return m_pHtmlLayouts;
+	}
+
 	TFontInfo* CPaintManagerUI::GetFontInfo(HFONT hFont)
 	{
 		TFontInfo* pFontInfo = NULL;
@@ -2947,12 +3152,19 @@ namespace DuiLib {
 	{
 		TImageInfo* data = static_cast<TImageInfo*>(m_ResInfo.m_ImageHash.Find(bitmap));
 		if( !data ) data = static_cast<TImageInfo*>(m_SharedResInfo.m_ImageHash.Find(bitmap));
+		if( !data && m_pImageCache != NULL && bitmap != NULL ) data = static_cast<TImageInfo*>(m_pImageCache->Find(bitmap, 0));
 		return data;
 	}
 
 	const TImageInfo* CPaintManagerUI::GetImageEx(LPCTSTR bitmap, LPCTSTR type, DWORD mask, bool bUseHSL, HINSTANCE instance)
 	{
 		const TImageInfo* data = GetImage(bitmap);
+		if( !data && (type == NULL || *type == _T('\0')) && !bUseHSL && bitmap != NULL && bitmap[0] != _T('\0') ) {
+			// Image files come from the cache shared by all windows. While painting the decode is
+			// left to the worker threads and the window is laid out again once it is ready.
+			HWND hWaiter = (m_bIsPainting && m_hWndPaint != NULL) ? m_hWndPaint : NULL;
+			return static_cast<const TImageInfo*>(GetImageCache()->Get(bitmap, mask, hWaiter));
+		}
 		if( !data ) {
 			if( AddImage(bitmap, type, mask, bUseHSL, false, instance) ) {
 				if (m_bForceUseSharedRes) data = static_cast<TImageInfo*>(m_SharedResInfo.m_ImageHash.Find(bitmap));
@@ -2963,6 +3175,22 @@ namespace DuiLib {
 		return data;
 	}
 
+	const TImageInfo* CPaintManagerUI::GetScaledImage(LPCTSTR bitmap, UINT uScale, DWORD mask)
+	{
+		if( bitmap == NULL || bitmap[0] == _T('\0') ) return NULL;
+		if( uScale == 100 ) return GetImageEx(bitmap, NULL, mask);
+		// an image added by hand under the scaled name wins, as it always has
+		CDuiString sScaled = MakeScaledImageName(bitmap, uScale);
+		const TImageInfo* data = static_cast<TImageInfo*>(m_ResInfo.m_ImageHash.Find(sScaled));
+		if( !data ) data = static_cast<TImageInfo*>(m_SharedResInfo.m_ImageHash.Find(sScaled));
+		if( data ) return data;
+		// Made on the decode threads like any other file and counted against the same budget,
+		// so a window moved to another monitor draws what it has while the rest are made.
+		// RemoveImage drops the image made for every scale, not just the current one.
+		HWND hWaiter = (m_bIsPainting && m_hWndPaint != NULL) ? m_hWndPaint : NULL;
+		return static_cast<const TImageInfo*>(GetImageCache()->Get((LPCTSTR)MakeScaledImageKey(bitmap, uScale), mask, hWaiter));
+	}
+
 	const TImageInfo* CPaintManagerUI::AddImage(LPCTSTR bitmap, LPCTSTR type, DWORD mask, bool bUseHSL, bool bShared, HINSTANCE instance)
 	{
 		if( bitmap == NULL || bitmap[0] == _T('\0') ) return NULL;
@@ -3064,7 +3292,12 @@ namespace DuiLib {
 
 	void CPaintManagerUI::RemoveImage(LPCTSTR bitmap, bool bShared)
 	{
+		m_uResourceSerial++;
 		TImageInfo* data = NULL;
+		if( m_pImageCache != NULL && bitmap != NULL ) {
+			m_pImageCache->RemoveIf(std::bind(IsImageKeyOf, std::placeholders::_1, CImageCache::Key(bitmap)));
+		}
+		if( m_pGifCache != NULL && bitmap != NULL ) m_pGifCache->Remove(bitmap);
 		if (bShared) 
 		{
 			data = static_cast<TImageInfo*>(m_SharedResInfo.m_ImageHash.Find(bitmap));
@@ -3087,6 +3320,7 @@ namespace DuiLib {
 
 	void CPaintManagerUI::RemoveAllImages(bool bShared)
 	{
+		m_uResourceSerial++;
 		if (bShared)
 		{
 			TImageInfo* data;
@@ -3115,35 +3349,23 @@ namespace DuiLib {
 		}
 	}
 
-	void CPaintManagerUI::AdjustSharedImagesHSL()
+	void CPaintManagerUI::GetImagesHSL(TResInfo& resInfo, CStdPtrArray& aImages)
 	{
 		TImageInfo* data;
-		for( int i = 0; i< m_SharedResInfo.m_ImageHash.GetSize(); i++ ) {
-			if(LPCTSTR key = m_SharedResInfo.m_ImageHash.GetAt(i)) {
-				data = static_cast<TImageInfo*>(m_SharedResInfo.m_ImageHash.Find(key));
-				if( data && data->bUseHSL ) {
-					CRenderEngine::AdjustImage(m_bUseHSL, data, m_H, m_S, m_L);
-				}
+		for( int i = 0; i< resInfo.m_ImageHash.GetSize(); i++ ) {
+			if(LPCTSTR key = resInfo.m_ImageHash.GetAt(i)) {
+				data = static_cast<TImageInfo*>(resInfo.m_ImageHash.Find(key));
+				if( data && data->bUseHSL ) aImages.Add(data);
 			}
 		}
 	}
 
-	void CPaintManagerUI::AdjustImagesHSL()
-	{
-		TImageInfo* data;
-		for( int i = 0; i< m_ResInfo.m_ImageHash.GetSize(); i++ ) {
-			if(LPCTSTR key = m_ResInfo.m_ImageHash.GetAt(i)) {
-				data = static_cast<TImageInfo*>(m_ResInfo.m_ImageHash.Find(key));
-				if( data && data->bUseHSL ) {
-					CRenderEngine::AdjustImage(m_bUseHSL, data, m_H, m_S, m_L);
-				}
-			}
-		}
-		Invalidate();
-	}
-
 	void CPaintManagerUI::ReloadSharedImages()
 	{
+		m_uResourceSerial++;
+		if( m_pImageCache != NULL ) m_pImageCache->Purge();
+		if( m_pGifCache != NULL ) m_pGifCache->Purge();
+
 		TImageInfo* data;
 		TImageInfo* pNewData;
 		for( int i = 0; i< m_SharedResInfo.m_ImageHash.GetSize(); i++ ) {
@@ -3229,6 +3451,124 @@ namespace DuiLib {
 		if( m_pRoot ) m_pRoot->Invalidate();
 	}
 
+	// The skin's own image for the scale if it has one. Otherwise one resampled from the @200
+	// image, which above 100% only has to shrink or grow a little, or from the plain one when
+	// the skin has no @200 image or the scale is under 100%.
+	static TImageInfo* LoadScaledImage(LPCTSTR pstrName, UINT uScale, DWORD dwMask)
+	{
+		TImageInfo* data = CRenderEngine::LoadImage((LPCTSTR)MakeScaledImageName(pstrName, uScale), NULL, dwMask);
+		if( data != NULL ) return data;
+		UINT uSourceScale = 200;
+		if( uScale > 100 && uScale != uSourceScale ) data = CRenderEngine::LoadImage((LPCTSTR)MakeScaledImageName(pstrName, uSourceScale), NULL, dwMask);
+		if( data == NULL ) {
+			uSourceScale = 100;
+			data = CRenderEngine::LoadImage(pstrName, NULL, dwMask);
+		}
+		if( data == NULL ) return NULL;
+		// as CDPI::Scale rounds the source and corner rects drawn out of it
+		int cx = MAX(::MulDiv(data->nX, uScale, uSourceScale), 1);
+		int cy = MAX(::MulDiv(data->nY, uScale, uSourceScale), 1);
+		if( cx == data->nX && cy == data->nY ) return data;
+		TImageInfo* pScaled = CRenderEngine::ResampleImage(data, cx, cy);
+		CRenderEngine::FreeImage(data);
+		return pScaled;
+	}
+
+	static void* DecodeCachedImage(const CImageCache::Key& sName, unsigned int uParam, size_t* pcbSize)
+	{
+		UINT uScale = 100;
+		LPCTSTR pstrName = ParseScaledImageKey(sName.c_str(), &uScale);
+		TImageInfo* data = uScale == 100 ? CRenderEngine::LoadImage(pstrName, NULL, uParam) : LoadScaledImage(pstrName, uScale, uParam);
+		if( data == NULL ) return NULL;
+		data->bUseHSL = false;
+		data->dwMask = uParam;
+		*pcbSize = sizeof(TImageInfo) + data->nX * data->nY * 4;
+		return data;
+	}
+
+	static void FreeCachedImage(void* pImage)
+	{
+		CRenderEngine::FreeImage(static_cast<TImageInfo*>(pImage));
+	}
+
+	static void NotifyCachedImage(void* pWaiter)
+	{
+		::PostMessage((HWND)pWaiter, WM_USER_IMAGE_READY, 0, 0L);
+	}
+
+	CImageCache* CPaintManagerUI::GetImageCache()
+	{
+		if( m_pImageCache == NULL ) {
+			m_pImageCache = new CImageCache(DecodeCachedImage, FreeCachedImage, NotifyCachedImage);
+			int nThreads = (int)std::thread::hardware_concurrency() - 1;
+			m_pImageCache->SetThreads(CLAMP(nThreads, 1, 2));
+		}
+		return m_pImageCache;
+	}
+
+	void CPaintManagerUI::SetImageCacheBudget(size_t cbBudget)
+	{
+		GetImageCache()->SetBudget(cbBudget);
+		GetGifCache()->SetBudget(cbBudget);
+	}
+
+	void CPaintManagerUI::SetImageDecodeThreads(int nThreads)
+	{
+		// 0 decodes every image on the thread that first asks for it
+		GetImageCache()->SetThreads(nThreads);
+	}
+
+	void CPaintManagerUI::GetImageCacheStats(TImageCacheStats* pStats)
+	{
+		GetImageCache()->GetStats(pStats);
+	}
+
+	static void* DecodeCachedGif(const CImageCache::Key& sName, unsigned int uParam, size_t cbMax, size_t* pcbSize)
+	{
+		// an atlas bigger than the whole budget would push everything else out and then itself
+		TGifAtlasInfo* data = CRenderEngine::LoadGifAtlas(sName.c_str(), uParam, cbMax);
+		if( data == NULL ) return NULL;
+		*pcbSize = sizeof(TGifAtlasInfo) + data->image.nX * data->image.nY * 4 + data->nFrames * sizeof(int);
+		return data;
+	}
+
+	static void FreeCachedGif(void* pImage)
+	{
+		CRenderEngine::FreeGifAtlas(static_cast<TGifAtlasInfo*>(pImage));
+	}
+
+	CImageCache* CPaintManagerUI::GetGifCache()
+	{
+		// GIFs are decoded where they are first asked for, so there are no threads to start
+		if( m_pGifCache == NULL ) {
+			m_pGifCache = new CImageCache([](const CImageCache::Key& sName, unsigned int uParam, size_t* pcbSize) -> void* {
+				// the decode runs outside the cache's lock, so the budget can be asked for
+				return DecodeCachedGif(sName, uParam, m_pGifCache->GetBudget(), pcbSize);
+			}, FreeCachedGif);
+		}
+		return m_pGifCache;
+	}
+
+	void CPaintManagerUI::PinGifAtlas(LPCTSTR bitmap, DWORD mask)
+	{
+		if( bitmap == NULL || bitmap[0] == _T('\0') ) return;
+		GetGifCache()->Pin(bitmap, mask);
+	}
+
+	void CPaintManagerUI::UnpinGifAtlas(LPCTSTR bitmap, DWORD mask)
+	{
+		if( m_pGifCache == NULL || bitmap == NULL || bitmap[0] == _T('\0') ) return;
+		m_pGifCache->Unpin(bitmap, mask);
+	}
+
+	const TGifAtlasInfo* CPaintManagerUI::GetGifAtlas(LPCTSTR bitmap, DWORD mask)
+	{
+		// Every control showing the same GIF draws from the one atlas. Like any cached image it
+		// is only good until the next paint ends, so controls ask for it again each time.
+		if( bitmap == NULL || bitmap[0] == _T('\0') ) return NULL;
+		return static_cast<const TGifAtlasInfo*>(GetGifCache()->Get(bitmap, mask));
+	}
+
 	const TDrawInfo* CPaintManagerUI::GetDrawInfo(LPCTSTR pStrImage, LPCTSTR pStrModify)
 	{
 		CDuiString sStrImage = pStrImage;
@@ -3399,7 +3739,10 @@ namespace DuiLib {
 	CControlUI* CPaintManagerUI::FindControl(POINT pt) const
 	{
 		ASSERT(m_pRoot);
-		return m_pRoot->FindControl(__FindControlFromPoint, &pt, UIFIND_VISIBLE | UIFIND_HITTEST | UIFIND_TOP_FIRST);
+		CControlUI* pControl = m_pHitTest->Find(m_pRoot, pt, UIFIND_VISIBLE | UIFIND_HITTEST | UIFIND_TOP_FIRST);
+		// if this fires, something changed the tree without NeedUpdate or NeedHitTestUpdate
+		ASSERT(pControl == m_pRoot->FindControl(__FindControlFromPoint, &pt, UIFIND_VISIBLE | UIFIND_HITTEST | UIFIND_TOP_FIRST));
+		return pControl;
 	}
 
 	CControlUI* CPaintManagerUI::FindControl(LPCTSTR pstrName) const
@@ -3523,10 +3866,8 @@ namespace DuiLib {
 
 	CControlUI* CALLBACK CPaintManagerUI::__FindControlsFromUpdate(CControlUI* pThis, LPVOID pData)
 	{
-		if( pThis->IsUpdateNeeded() ) {
-			pThis->GetManager()->GetFoundControls()->Add((LPVOID)pThis);
-			return pThis;
-		}
+		// keeps going below a control that needs an update, its children may not be laid out by it
+		if( pThis->IsUpdateNeeded() ) pThis->GetManager()->GetFoundControls()->Add((LPVOID)pThis);
 		return NULL;
 	}
 
@@ -3,6 +3,7 @@
 
 #pragma once
 #define WM_USER_SET_DPI WM_USER + 200
+#define WM_USER_IMAGE_READY WM_USER + 201
 namespace DuiLib {
 	/////////////////////////////////////////////////////////////////////////////////////
 	//
@@ -117,6 +118,15 @@ namespace DuiLib {
 		DWORD dwMask;
 	} TImageInfo;
 
+	// every frame of a GIF in one bitmap, frame i at rows [i * nFrameY, (i + 1) * nFrameY)
+	typedef struct UILIB_API tagTGifAtlasInfo
+	{
+		TImageInfo image;
+		int nFrameY;
+		int nFrames;
+		int* pDelays;		// ms, 0 where the GIF doesn't say
+	} TGifAtlasInfo;
+
 	typedef struct UILIB_API tagTDrawInfo
 	{
 		tagTDrawInfo();
@@ -126,6 +136,10 @@ namespace DuiLib {
 		CDuiString sDrawString;
 		CDuiString sDrawModify;
 		CDuiString sImageName;
+		// the name as written and the scale sImageName was made for, so a file the skin has
+		// no image for at that scale can be drawn from one made from another
+		CDuiString sBaseName;
+		UINT uScale;
 		CDuiString sResType;
 		RECT rcDest;
 		RECT rcSource;
@@ -218,6 +232,11 @@ namespace DuiLib {
 		void Init(HWND hWnd, LPCTSTR pstrName = NULL);
 		bool IsUpdateNeeded() const;
 		void NeedUpdate();
+		// a control moved, showed, hid or changed its mouse flags outside of a layout
+		void NeedHitTestUpdate();
+		// the next layout goes through every control, not only the ones that asked for it
+		void NeedFullLayout();
+		bool IsFullLayoutNeeded() const;
 		void Invalidate();
 		void Invalidate(RECT& rcItem);
 
@@ -244,6 +263,8 @@ namespace DuiLib {
 		void SetMaxInfo(int cx, int cy);
 		bool IsShowUpdateRect() const;
 		void SetShowUpdateRect(bool show);
+		// what the last WM_PAINT painted
+		const TPaintStats& GetPaintStats() const;
 
 		BYTE GetOpacity() const;
 		void SetOpacity(BYTE nOpacity);
@@ -285,6 +306,9 @@ namespace DuiLib {
 		static void SetResourcePath(LPCTSTR pStrPath);
 		static void SetResourceZip(LPVOID pVoid, unsigned int len, LPCTSTR password = NULL);
 		static void SetResourceZip(LPCTSTR pstrZip, bool bCachedResourceZip = false, LPCTSTR password = NULL);
+		static LPBYTE LoadResourceZipItem(LPCTSTR pstrName, DWORD* pdwSize, int* piView);
+		static void FreeResourceZipItem(LPBYTE pData, int iView);
+		static void PrefetchResourceZip(LPCTSTR pstrSkinFile);
 		static void SetResourceType(int nType);
 		static int GetResourceType();
 		static bool GetHSL(short* H, short* S, short* L);
@@ -324,15 +348,29 @@ namespace DuiLib {
 		void RemoveAllFonts(bool bShared = false);
 		TFontInfo* GetFontInfo(int id);
 		TFontInfo* GetFontInfo(HFONT hFont);
+		// moves on whenever a font or an image is replaced or freed, in any window
+		static UINT GetResourceSerial();
+		CHtmlLayoutCache* GetHtmlLayoutCache();
 
 		const TImageInfo* GetImage(LPCTSTR bitmap);
 		const TImageInfo* GetImageEx(LPCTSTR bitmap, LPCTSTR type = NULL, DWORD mask = 0, bool bUseHSL = false, HINSTANCE instance = NULL);
+		// the image file bitmap as drawn at uScale percent: the skin's own bitmap@uScale if it
+		// has one, else one resampled from bitmap@200 or bitmap and kept in the image cache
+		const TImageInfo* GetScaledImage(LPCTSTR bitmap, UINT uScale, DWORD mask = 0);
 		const TImageInfo* AddImage(LPCTSTR bitmap, LPCTSTR type = NULL, DWORD mask = 0, bool bUseHSL = false, bool bShared = false, HINSTANCE instance = NULL);
 		const TImageInfo* AddImage(LPCTSTR bitmap, HBITMAP hBitmap, int iWidth, int iHeight, bool bAlpha, bool bShared = false);
 		void RemoveImage(LPCTSTR bitmap, bool bShared = false);
 		void RemoveAllImages(bool bShared = false);
 		static void ReloadSharedImages();
 		void ReloadImages();
+		// for the decoded images and, on their own, the GIF atlases
+		static void SetImageCacheBudget(size_t cbBudget);
+		static void SetImageDecodeThreads(int nThreads);
+		static void GetImageCacheStats(TImageCacheStats* pStats);
+		const TGifAtlasInfo* GetGifAtlas(LPCTSTR bitmap, DWORD mask = 0);
+		// keeps the atlas through the trim after each paint, for as long as a control shows it
+		static void PinGifAtlas(LPCTSTR bitmap, DWORD mask = 0);
+		static void UnpinGifAtlas(LPCTSTR bitmap, DWORD mask = 0);
 
 		const TDrawInfo* GetDrawInfo(LPCTSTR pStrImage, LPCTSTR pStrModify);
 		void RemoveDrawInfo(LPCTSTR pStrImage, LPCTSTR pStrModify);
@@ -449,8 +487,10 @@ namespace DuiLib {
 		static CControlUI* CALLBACK __FindControlsFromClass(CControlUI* pThis, LPVOID pData);
 		static CControlUI* CALLBACK __FindControlsFromUpdate(CControlUI* pThis, LPVOID pData);
 
-		static void AdjustSharedImagesHSL();
-		void AdjustImagesHSL();
+		void ScheduleClock();
+		static void GetImagesHSL(TResInfo& resInfo, CStdPtrArray& aImages);
+		static CImageCache* GetImageCache();
+		static CImageCache* GetGifCache();
 
 	private:
 		CDuiString m_sName;
@@ -491,6 +531,14 @@ namespace DuiLib {
 		CControlUI* m_pEventHover;
 		CControlUI* m_pEventClick;
 		CControlUI* m_pEventKey;
+		CHitTestIndex* m_pHitTest;
+		CAnimationClock* m_pClock;
+		DWORD m_dwClockFire;
+		bool m_bClockSet;
+		bool m_bClockTicking;
+		CHtmlLayoutCache* m_pHtmlLayouts;
+		CDamageRegion* m_pDamage;
+		TPaintStats m_PaintStats;
 		//
 		POINT m_ptLastMousePos;
 		SIZE m_szMinWindow;
@@ -499,9 +547,9 @@ namespace DuiLib {
 		RECT m_rcSizeBox;
 		SIZE m_szRoundCorner;
 		RECT m_rcCaption;
-		UINT m_uTimerID;
 		bool m_bFirstLayout;
 		bool m_bUpdateNeeded;
+		bool m_bFullLayout;
 		bool m_bFocusNeeded;
 		bool m_bOffscreenPaint;
 		
@@ -509,7 +557,6 @@ namespace DuiLib {
 		bool m_bLayered;
 		RECT m_rcLayeredInset;
 		bool m_bLayeredChanged;
-		RECT m_rcLayeredUpdate;
 		//TDrawInfo m_diLayered;
 
 		bool m_bMouseTracking;
@@ -519,7 +566,6 @@ namespace DuiLib {
 
 		//
 		CStdPtrArray m_aNotifiers;
-		CStdPtrArray m_aTimers;
 		CStdPtrArray m_aTranslateAccelerator;
 		CStdPtrArray m_aPreMessageFilters;
 		CStdPtrArray m_aMessageFilters;
@@ -555,6 +601,9 @@ namespace DuiLib {
 		static short m_S;
 		static short m_L;
 		static CStdPtrArray m_aPreMessages;
+		static CImageCache* m_pImageCache;
+		static CImageCache* m_pGifCache;
+		static UINT m_uResourceSerial;
 		static CStdPtrArray m_aPlugins;
 	};
 
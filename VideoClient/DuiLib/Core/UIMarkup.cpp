@@ -4,7 +4,220 @@
 #define TRACE
 #endif
 
+#if defined(_M_IX86) || defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define XML_SCAN_SSE2
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
 namespace DuiLib {
+
+static const DWORD XMLCOMPILED_MAGIC = 0x42495544; // "DUIB"
+static const DWORD XMLCOMPILED_VERSION = 2;
+
+// A UTF-8 skin is parsed in a buffer with this many zero bytes after the text, the first
+// one terminates it and the scanner may load 16 bytes anywhere up to that terminator.
+static const DWORD XMLSCAN_PADDING = 16;
+
+// The DUIATTR_* ids of a compiled skin hold for the DUI_ATTRIBUTE_LIST it was compiled against,
+// a skin whose header carries another hash of the list has them looked up again when it is loaded.
+static LPCTSTR const s_aAttributeNames[] = {
+    NULL,
+#define DUI_ATTRIBUTE_NAME(id, name) _T(name),
+    DUI_ATTRIBUTE_LIST(DUI_ATTRIBUTE_NAME)
+#undef DUI_ATTRIBUTE_NAME
+};
+
+static DWORD _GetAttributeListHash()
+{
+    DWORD dwHash = 2166136261u;
+    for( int i = 1; i < DUIATTR_COUNT; i++ ) {
+        LPCTSTR pstr = s_aAttributeNames[i];
+        do {
+            dwHash = (dwHash ^ (DWORD)*pstr) * 16777619u;
+        } while( *pstr++ != _T('\0') );
+    }
+    return dwHash;
+}
+
+// Linear, it only runs when a skin is compiled or was compiled against another list
+static WORD _FindAttributeId(LPCTSTR pstrName)
+{
+    for( int i = 1; i < DUIATTR_COUNT; i++ ) {
+        if( _tcsicmp(s_aAttributeNames[i], pstrName) == 0 ) return (WORD)i;
+    }
+    return DUIATTR_UNKNOWN;
+}
+
+// The value of an attribute as numbers when it is nothing but one to four decimal numbers
+// separated by commas or a '#' colour, anything else (spaces too) stays XMLVALUE_TEXT
+static BYTE _ParseNumbers(LPCTSTR pstrValue, LONG* pNumbers, BYTE& nNumbers)
+{
+    nNumbers = 0;
+    LPCTSTR pstr = pstrValue;
+    if( *pstr == _T('#') ) {
+        DWORD dwColor = 0;
+        int nDigits = 0;
+        for( pstr++; *pstr != _T('\0') && nDigits < 8; pstr++, nDigits++ ) {
+            TCHAR ch = *pstr;
+            if( ch >= _T('0') && ch <= _T('9') ) dwColor = (dwColor << 4) | (DWORD)(ch - _T('0'));
+            else if( (ch | 0x20) >= _T('a') && (ch | 0x20) <= _T('f') ) dwColor = (dwColor << 4) | (DWORD)((ch | 0x20) - _T('a') + 10);
+            else break;
+        }
+        if( nDigits == 0 || *pstr != _T('\0') ) return XMLVALUE_TEXT;
+        pNumbers[nNumbers++] = (LONG)dwColor;
+        return XMLVALUE_COLOR;
+    }
+    for( ; ; ) {
+        bool bNegative = *pstr == _T('-');
+        if( bNegative ) pstr++;
+        LONG nValue = 0;
+        int nDigits = 0;
+        // Nine digits cannot overflow a LONG, longer numbers are left to the control
+        for( ; *pstr >= _T('0') && *pstr <= _T('9') && nDigits < 9; pstr++, nDigits++ ) nValue = nValue * 10 + (*pstr - _T('0'));
+        if( nDigits == 0 || nNumbers == 4 ) return XMLVALUE_TEXT;
+        pNumbers[nNumbers++] = bNegative ? -nValue : nValue;
+        if( *pstr == _T('\0') ) return XMLVALUE_INT;
+        if( *pstr++ != _T(',') ) break;
+    }
+    nNumbers = 0;
+    return XMLVALUE_TEXT;
+}
+
+static inline int _LowestBit(unsigned int mask)
+{
+#ifdef _MSC_VER
+    unsigned long iBit;
+    _BitScanForward(&iBit, mask);
+    return (int)iBit;
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+static inline ULONG _CountBits(unsigned int mask)
+{
+    mask = mask - ((mask >> 1) & 0x55555555);
+    mask = (mask & 0x33333333) + ((mask >> 2) & 0x33333333);
+    return (((mask + (mask >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24;
+}
+
+// Counts '<' and '"' in the text, every element starts with one '<' and every attribute
+// value takes two quotes, so the counts bound the element and attribute tables.
+static void _CountMarkupUTF8(LPCSTR pstr, LPCSTR pstrEnd, ULONG& nTags, ULONG& nQuotes)
+{
+    nTags = nQuotes = 0;
+#ifdef XML_SCAN_SSE2
+    const __m128i vTag = _mm_set1_epi8('<');
+    const __m128i vQuote = _mm_set1_epi8('\"');
+    for( ; pstrEnd - pstr >= 16; pstr += 16 ) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pstr));
+        nTags += _CountBits(_mm_movemask_epi8(_mm_cmpeq_epi8(v, vTag)));
+        nQuotes += _CountBits(_mm_movemask_epi8(_mm_cmpeq_epi8(v, vQuote)));
+    }
+#endif
+    for( ; pstr < pstrEnd; pstr++ ) {
+        if( *pstr == '<' ) nTags++;
+        else if( *pstr == '\"' ) nQuotes++;
+    }
+}
+
+// Returns the first c1, c2, c3 or '\0' at or after pstr. Bytes of multibyte UTF-8
+// sequences are all above 0x7F, so they never match an ASCII delimiter.
+static inline LPSTR _ScanUTF8(LPSTR pstr, char c1, char c2, char c3)
+{
+#ifdef XML_SCAN_SSE2
+    const __m128i v1 = _mm_set1_epi8(c1);
+    const __m128i v2 = _mm_set1_epi8(c2);
+    const __m128i v3 = _mm_set1_epi8(c3);
+    const __m128i vZero = _mm_setzero_si128();
+    for( ; ; pstr += 16 ) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pstr));
+        __m128i vMatch = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, v1), _mm_cmpeq_epi8(v, v2)),
+            _mm_or_si128(_mm_cmpeq_epi8(v, v3), _mm_cmpeq_epi8(v, vZero)));
+        int mask = _mm_movemask_epi8(vMatch);
+        if( mask != 0 ) return pstr + _LowestBit(mask);
+    }
+#else
+    while( *pstr != '\0' && *pstr != c1 && *pstr != c2 && *pstr != c3 ) pstr++;
+    return pstr;
+#endif
+}
+
+static inline void _SkipWhitespaceUTF8(LPSTR& pstr)
+{
+    // Between attributes there is mostly a single space, only indentation takes the vector loop
+    if( (BYTE)(*pstr - 1) >= ' ' ) return;
+    if( (BYTE)(*++pstr - 1) >= ' ' ) return;
+#ifdef XML_SCAN_SSE2
+    const __m128i vZero = _mm_setzero_si128();
+    const __m128i vSpace = _mm_set1_epi8(' ' + 1);
+    for( ; ; pstr += 16 ) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pstr));
+        __m128i vWhite = _mm_and_si128(_mm_cmpgt_epi8(v, vZero), _mm_cmplt_epi8(v, vSpace));
+        int mask = ~_mm_movemask_epi8(vWhite) & 0xFFFF;
+        if( mask != 0 ) {
+            pstr += _LowestBit(mask);
+            return;
+        }
+    }
+#else
+    while( (BYTE)(*pstr - 1) < ' ' ) pstr++;
+#endif
+}
+
+static inline void _SkipIdentifierUTF8(LPSTR& pstr)
+{
+    for( ; ; pstr++ ) {
+        char ch = *pstr;
+        if( !((ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || (ch >= '0' && ch <= '9') || ch == '_' || ch == ':') ) return;
+    }
+}
+
+template<typename T> static void _DecodeMetaChar(T*& pstrText, T*& pstrDest)
+{
+    if( pstrText[0] == 'a' && pstrText[1] == 'm' && pstrText[2] == 'p' && pstrText[3] == ';' ) {
+        *pstrDest++ = '&';
+        pstrText += 4;
+    }
+    else if( pstrText[0] == 'l' && pstrText[1] == 't' && pstrText[2] == ';' ) {
+        *pstrDest++ = '<';
+        pstrText += 3;
+    }
+    else if( pstrText[0] == 'g' && pstrText[1] == 't' && pstrText[2] == ';' ) {
+        *pstrDest++ = '>';
+        pstrText += 3;
+    }
+    else if( pstrText[0] == 'q' && pstrText[1] == 'u' && pstrText[2] == 'o' && pstrText[3] == 't' && pstrText[4] == ';' ) {
+        *pstrDest++ = '\"';
+        pstrText += 5;
+    }
+    else if( pstrText[0] == 'a' && pstrText[1] == 'p' && pstrText[2] == 'o' && pstrText[3] == 's' && pstrText[4] == ';' ) {
+        *pstrDest++ = '\'';
+        pstrText += 5;
+    }
+    else {
+        *pstrDest++ = '&';
+    }
+}
+
+// Converts the UTF-8 string to at most cchMax TCHARs including the terminator.
+static void _ConvertUTF8(LPCSTR pstr, LPTSTR pstrDest, int cchMax)
+{
+#ifdef _UNICODE
+    if( ::MultiByteToWideChar(CP_UTF8, 0, pstr, -1, pstrDest, cchMax) == 0 ) pstrDest[cchMax - 1] = L'\0';
+#else
+    WCHAR szWide[256];
+    int nWide = ::MultiByteToWideChar(CP_UTF8, 0, pstr, -1, NULL, 0);
+    LPWSTR pstrWide = nWide <= lengthof(szWide) ? szWide : static_cast<LPWSTR>(malloc(nWide * sizeof(WCHAR)));
+    ::MultiByteToWideChar(CP_UTF8, 0, pstr, -1, pstrWide, nWide);
+    if( ::WideCharToMultiByte(CP_ACP, 0, pstrWide, nWide, pstrDest, cchMax, NULL, NULL) == 0 ) pstrDest[cchMax - 1] = '\0';
+    if( pstrWide != szWide ) free(pstrWide);
+#endif
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////
 //
 //
@@ -45,7 +258,7 @@ CMarkupNode CMarkupNode::GetChild(LPCTSTR pstrName)
     if( m_pOwner == NULL ) return CMarkupNode();
     ULONG iPos = m_pOwner->m_pElements[m_iPos].iChild;
     while( iPos != 0 ) {
-        if( _tcsicmp(m_pOwner->m_pstrXML + m_pOwner->m_pElements[iPos].iStart, pstrName) == 0 ) {
+        if( _tcsicmp(m_pOwner->_GetString(m_pOwner->m_pElements[iPos].iStart), pstrName) == 0 ) {
             return CMarkupNode(m_pOwner, iPos);
         }
         iPos = m_pOwner->m_pElements[iPos].iNext;
@@ -75,13 +288,13 @@ bool CMarkupNode::IsValid() const
 LPCTSTR CMarkupNode::GetName() const
 {
     if( m_pOwner == NULL ) return NULL;
-    return m_pOwner->m_pstrXML + m_pOwner->m_pElements[m_iPos].iStart;
+    return m_pOwner->_GetString(m_pOwner->m_pElements[m_iPos].iStart);
 }
 
 LPCTSTR CMarkupNode::GetValue() const
 {
     if( m_pOwner == NULL ) return NULL;
-    return m_pOwner->m_pstrXML + m_pOwner->m_pElements[m_iPos].iData;
+    return m_pOwner->_GetString(m_pOwner->m_pElements[m_iPos].iData);
 }
 
 LPCTSTR CMarkupNode::GetAttributeName(int iIndex)
@@ -89,7 +302,7 @@ LPCTSTR CMarkupNode::GetAttributeName(int iIndex)
     if( m_pOwner == NULL ) return NULL;
     if( m_nAttributes == 0 ) _MapAttributes();
     if( iIndex < 0 || iIndex >= m_nAttributes ) return _T("");
-    return m_pOwner->m_pstrXML + m_aAttributes[iIndex].iName;
+    return m_pOwner->_GetString(m_aAttributes[iIndex].iName);
 }
 
 LPCTSTR CMarkupNode::GetAttributeValue(int iIndex)
@@ -97,7 +310,7 @@ LPCTSTR CMarkupNode::GetAttributeValue(int iIndex)
     if( m_pOwner == NULL ) return NULL;
     if( m_nAttributes == 0 ) _MapAttributes();
     if( iIndex < 0 || iIndex >= m_nAttributes ) return _T("");
-    return m_pOwner->m_pstrXML + m_aAttributes[iIndex].iValue;
+    return m_pOwner->_GetString(m_aAttributes[iIndex].iValue);
 }
 
 LPCTSTR CMarkupNode::GetAttributeValue(LPCTSTR pstrName)
@@ -105,7 +318,7 @@ LPCTSTR CMarkupNode::GetAttributeValue(LPCTSTR pstrName)
     if( m_pOwner == NULL ) return NULL;
     if( m_nAttributes == 0 ) _MapAttributes();
     for( int i = 0; i < m_nAttributes; i++ ) {
-        if( _tcsicmp(m_pOwner->m_pstrXML + m_aAttributes[i].iName, pstrName) == 0 ) return m_pOwner->m_pstrXML + m_aAttributes[i].iValue;
+        if( _tcsicmp(m_pOwner->_GetString(m_aAttributes[i].iName), pstrName) == 0 ) return m_pOwner->_GetString(m_aAttributes[i].iValue);
     }
     return _T("");
 }
@@ -115,7 +328,7 @@ bool CMarkupNode::GetAttributeValue(int iIndex, LPTSTR pstrValue, SIZE_T cchMax)
     if( m_pOwner == NULL ) return false;
     if( m_nAttributes == 0 ) _MapAttributes();
     if( iIndex < 0 || iIndex >= m_nAttributes ) return false;
-    _tcsncpy(pstrValue, m_pOwner->m_pstrXML + m_aAttributes[iIndex].iValue, cchMax);
+    _tcsncpy(pstrValue, m_pOwner->_GetString(m_aAttributes[iIndex].iValue), cchMax);
     return true;
 }
 
@@ -124,8 +337,8 @@ bool CMarkupNode::GetAttributeValue(LPCTSTR pstrName, LPTSTR pstrValue, SIZE_T c
     if( m_pOwner == NULL ) return false;
     if( m_nAttributes == 0 ) _MapAttributes();
     for( int i = 0; i < m_nAttributes; i++ ) {
-        if( _tcsicmp(m_pOwner->m_pstrXML + m_aAttributes[i].iName, pstrName) == 0 ) {
-            _tcsncpy(pstrValue, m_pOwner->m_pstrXML + m_aAttributes[i].iValue, cchMax);
+        if( _tcsicmp(m_pOwner->_GetString(m_aAttributes[i].iName), pstrName) == 0 ) {
+            _tcsncpy(pstrValue, m_pOwner->_GetString(m_aAttributes[i].iValue), cchMax);
             return true;
         }
     }
@@ -151,14 +364,55 @@ bool CMarkupNode::HasAttribute(LPCTSTR pstrName)
     if( m_pOwner == NULL ) return false;
     if( m_nAttributes == 0 ) _MapAttributes();
     for( int i = 0; i < m_nAttributes; i++ ) {
-        if( _tcsicmp(m_pOwner->m_pstrXML + m_aAttributes[i].iName, pstrName) == 0 ) return true;
+        if( _tcsicmp(m_pOwner->_GetString(m_aAttributes[i].iName), pstrName) == 0 ) return true;
     }
     return false;
 }
 
+int CMarkupNode::GetClassIndex() const
+{
+    if( m_pOwner == NULL || m_pOwner->m_pElementClasses == NULL ) return -1;
+    return (int)m_pOwner->m_pElementClasses[m_iPos];
+}
+
+int CMarkupNode::GetAttributeId(int iIndex)
+{
+    if( m_pOwner == NULL || m_pOwner->m_pAttributeInfo == NULL ) return -1;
+    if( m_nAttributes == 0 ) _MapAttributes();
+    if( iIndex < 0 || iIndex >= m_nAttributes ) return -1;
+    return m_pOwner->m_pAttributeInfo[m_pOwner->m_pAttributeIndex[m_iPos] + iIndex].wId;
+}
+
+int CMarkupNode::GetAttributeType(int iIndex)
+{
+    if( m_pOwner == NULL || m_pOwner->m_pAttributeInfo == NULL ) return XMLVALUE_TEXT;
+    if( m_nAttributes == 0 ) _MapAttributes();
+    if( iIndex < 0 || iIndex >= m_nAttributes ) return XMLVALUE_TEXT;
+    return m_pOwner->m_pAttributeInfo[m_pOwner->m_pAttributeIndex[m_iPos] + iIndex].bType;
+}
+
+int CMarkupNode::GetAttributeNumbers(int iIndex, LONG* pNumbers, int nMax)
+{
+    if( m_pOwner == NULL || m_pOwner->m_pAttributeInfo == NULL ) return 0;
+    if( m_nAttributes == 0 ) _MapAttributes();
+    if( iIndex < 0 || iIndex >= m_nAttributes ) return 0;
+    const CMarkup::XMLATTRIBUTEINFO& info = m_pOwner->m_pAttributeInfo[m_pOwner->m_pAttributeIndex[m_iPos] + iIndex];
+    int nNumbers = info.nNumbers < nMax ? info.nNumbers : nMax;
+    for( int i = 0; i < nNumbers; i++ ) pNumbers[i] = m_pOwner->m_pNumbers[info.iNumbers + i];
+    return info.nNumbers;
+}
+
 void CMarkupNode::_MapAttributes()
 {
     m_nAttributes = 0;
+    if( m_pOwner->m_pAttributeIndex != NULL ) {
+        ULONG iLast = m_pOwner->m_pAttributeIndex[m_iPos + 1];
+        for( ULONG i = m_pOwner->m_pAttributeIndex[m_iPos]; i < iLast && m_nAttributes < MAX_XML_ATTRIBUTES; i++ ) {
+            m_aAttributes[m_nAttributes].iName = m_pOwner->m_pAttributes[i * 2];
+            m_aAttributes[m_nAttributes++].iValue = m_pOwner->m_pAttributes[i * 2 + 1];
+        }
+        return;
+    }
     LPCTSTR pstr = m_pOwner->m_pstrXML + m_pOwner->m_pElements[m_iPos].iStart;
     LPCTSTR pstrEnd = m_pOwner->m_pstrXML + m_pOwner->m_pElements[m_iPos].iData;
     pstr += _tcslen(pstr) + 1;
@@ -184,8 +438,20 @@ void CMarkupNode::_MapAttributes()
 CMarkup::CMarkup(LPCTSTR pstrXML)
 {
     m_pstrXML = NULL;
+    m_pstrUTF8 = NULL;
+    m_cbUTF8 = 0;
+    m_pConverted = NULL;
     m_pElements = NULL;
+    m_pAttributeIndex = NULL;
+    m_pAttributes = NULL;
+    m_pElementClasses = NULL;
+    m_pClasses = NULL;
+    m_nClasses = 0;
+    m_pAttributeInfo = NULL;
+    m_pNumbers = NULL;
     m_nElements = 0;
+    m_nAttributes = 0;
+    m_bArena = false;
     m_bPreserveWhitespace = true;
     if( pstrXML != NULL ) Load(pstrXML);
 }
@@ -200,6 +466,71 @@ bool CMarkup::IsValid() const
     return m_pElements != NULL;
 }
 
+template<typename T> static void _SwapValue(T& a, T& b)
+{
+    T temp = a;
+    a = b;
+    b = temp;
+}
+
+void CMarkup::Swap(CMarkup& markup)
+{
+    _SwapValue(m_pstrXML, markup.m_pstrXML);
+    _SwapValue(m_pstrUTF8, markup.m_pstrUTF8);
+    _SwapValue(m_cbUTF8, markup.m_cbUTF8);
+    _SwapValue(m_pConverted, markup.m_pConverted);
+    _SwapValue(m_pElements, markup.m_pElements);
+    _SwapValue(m_pAttributeIndex, markup.m_pAttributeIndex);
+    _SwapValue(m_pAttributes, markup.m_pAttributes);
+    _SwapValue(m_pElementClasses, markup.m_pElementClasses);
+    _SwapValue(m_pClasses, markup.m_pClasses);
+    _SwapValue(m_nClasses, markup.m_nClasses);
+    _SwapValue(m_pAttributeInfo, markup.m_pAttributeInfo);
+    _SwapValue(m_pNumbers, markup.m_pNumbers);
+    _SwapValue(m_nElements, markup.m_nElements);
+    _SwapValue(m_nReservedElements, markup.m_nReservedElements);
+    _SwapValue(m_nAttributes, markup.m_nAttributes);
+    _SwapValue(m_nReservedAttributes, markup.m_nReservedAttributes);
+    _SwapValue(m_bArena, markup.m_bArena);
+    _SwapValue(m_bPreserveWhitespace, markup.m_bPreserveWhitespace);
+    TCHAR szErrorMsg[lengthof(m_szErrorMsg)];
+    TCHAR szErrorXML[lengthof(m_szErrorXML)];
+    ::CopyMemory(szErrorMsg, m_szErrorMsg, sizeof(m_szErrorMsg));
+    ::CopyMemory(szErrorXML, m_szErrorXML, sizeof(m_szErrorXML));
+    ::CopyMemory(m_szErrorMsg, markup.m_szErrorMsg, sizeof(m_szErrorMsg));
+    ::CopyMemory(m_szErrorXML, markup.m_szErrorXML, sizeof(m_szErrorXML));
+    ::CopyMemory(markup.m_szErrorMsg, szErrorMsg, sizeof(m_szErrorMsg));
+    ::CopyMemory(markup.m_szErrorXML, szErrorXML, sizeof(m_szErrorXML));
+}
+
+void CMarkup::IndexAttributes()
+{
+    if( m_nElements == 0 || m_pAttributeIndex != NULL ) return;
+
+    ULONG* pIndex = static_cast<ULONG*>(malloc((m_nElements + 1) * sizeof(ULONG)));
+    ULONG* pAttributes = static_cast<ULONG*>(malloc(sizeof(ULONG)));
+    ULONG nAttributes = 0;
+    ULONG nReservedAttributes = 0;
+    pIndex[0] = 0;
+    for( ULONG i = 1; i < m_nElements; i++ ) {
+        CMarkupNode node(this, i);
+        int nCount = node.GetAttributeCount();
+        pIndex[i] = nAttributes;
+        if( nAttributes + nCount > nReservedAttributes ) {
+            nReservedAttributes += (nReservedAttributes / 2) + nCount + 500;
+            pAttributes = static_cast<ULONG*>(realloc(pAttributes, nReservedAttributes * 2 * sizeof(ULONG)));
+        }
+        for( int j = 0; j < nCount; j++ ) {
+            pAttributes[nAttributes * 2] = node.m_aAttributes[j].iName;
+            pAttributes[nAttributes * 2 + 1] = node.m_aAttributes[j].iValue;
+            nAttributes++;
+        }
+    }
+    pIndex[m_nElements] = nAttributes;
+    m_pAttributeIndex = pIndex;
+    m_pAttributes = pAttributes;
+}
+
 void CMarkup::SetPreserveWhitespace(bool bPreserve)
 {
     m_bPreserveWhitespace = bPreserve;
@@ -218,20 +549,18 @@ bool CMarkup::Load(LPCTSTR pstrXML)
 
 bool CMarkup::LoadFromMem(BYTE* pByte, DWORD dwSize, int encoding)
 {
-#ifdef _UNICODE
-    if (encoding == XMLFILE_ENCODING_UTF8)
-    {
-        if( dwSize >= 3 && pByte[0] == 0xEF && pByte[1] == 0xBB && pByte[2] == 0xBF ) 
-        {
-            pByte += 3; dwSize -= 3;
-        }
-        DWORD nWide = ::MultiByteToWideChar( CP_UTF8, 0, (LPCSTR)pByte, dwSize, NULL, 0 );
-
-        m_pstrXML = static_cast<LPTSTR>(malloc((nWide + 1)*sizeof(TCHAR)));
-        ::MultiByteToWideChar( CP_UTF8, 0, (LPCSTR)pByte, dwSize, m_pstrXML, nWide );
-        m_pstrXML[nWide] = _T('\0');
+    Release();
+    if( dwSize >= sizeof(XMLCOMPILEDHEADER) && *(DWORD UNALIGNED*)pByte == XMLCOMPILED_MAGIC ) {
+        return _LoadCompiled(pByte, dwSize);
     }
-    else if (encoding == XMLFILE_ENCODING_ASNI)
+    if( encoding == XMLFILE_ENCODING_UTF8 ) {
+        LPSTR pstrBuffer = static_cast<LPSTR>(malloc(dwSize + XMLSCAN_PADDING));
+        ::CopyMemory(pstrBuffer, pByte, dwSize);
+        return _LoadUTF8(pstrBuffer, dwSize);
+    }
+
+#ifdef _UNICODE
+    if (encoding == XMLFILE_ENCODING_ASNI)
     {
         DWORD nWide = ::MultiByteToWideChar( CP_ACP, 0, (LPCSTR)pByte, dwSize, NULL, 0 );
 
@@ -269,27 +598,7 @@ bool CMarkup::LoadFromMem(BYTE* pByte, DWORD dwSize, int encoding)
         }
     }
 #else // !_UNICODE
-    if (encoding == XMLFILE_ENCODING_UTF8)
-    {
-        if( dwSize >= 3 && pByte[0] == 0xEF && pByte[1] == 0xBB && pByte[2] == 0xBF ) 
-        {
-            pByte += 3; dwSize -= 3;
-        }
-        DWORD nWide = ::MultiByteToWideChar( CP_UTF8, 0, (LPCSTR)pByte, dwSize, NULL, 0 );
-
-        LPWSTR w_str = static_cast<LPWSTR>(malloc((nWide + 1)*sizeof(WCHAR)));
-        ::MultiByteToWideChar( CP_UTF8, 0, (LPCSTR)pByte, dwSize, w_str, nWide );
-        w_str[nWide] = L'\0';
-
-        DWORD wide = ::WideCharToMultiByte(CP_ACP, 0, (LPCWSTR)w_str, nWide, NULL, 0, NULL, NULL);
-
-        m_pstrXML = static_cast<LPTSTR>(malloc((wide + 1)*sizeof(TCHAR)));
-        ::WideCharToMultiByte( CP_ACP, 0, (LPCWSTR)w_str, nWide, m_pstrXML, wide, NULL, NULL);
-        m_pstrXML[wide] = _T('\0');
-
-        free(w_str);
-    }
-    else if (encoding == XMLFILE_ENCODING_UNICODE)
+    if (encoding == XMLFILE_ENCODING_UNICODE)
     {
         if ( dwSize >= 2 && ( ( pByte[0] == 0xFE && pByte[1] == 0xFF ) || ( pByte[0] == 0xFF && pByte[1] == 0xFE ) ) )
         {
@@ -345,67 +654,327 @@ bool CMarkup::LoadFromFile(LPCTSTR pstrFilename, int encoding)
         if ( dwSize > 4096*1024 ) return _Failed(_T("File too large"));
 
         DWORD dwRead = 0;
-        BYTE* pByte = new BYTE[ dwSize ];
+        BYTE* pByte = static_cast<BYTE*>(malloc(dwSize + XMLSCAN_PADDING));
         ::ReadFile( hFile, pByte, dwSize, &dwRead, NULL );
         ::CloseHandle( hFile );
         if( dwRead != dwSize ) {
-            delete[] pByte;
+            free(pByte);
 			pByte = NULL;
             Release();
             return _Failed(_T("Could not read file"));
         }
 
-        bool ret = LoadFromMem(pByte, dwSize, encoding);
-        delete[] pByte;
-		pByte = NULL;
-
-        return ret;
+        return _LoadBuffer(pByte, dwSize, encoding);
     }
     else {
-		sFile += CPaintManagerUI::GetResourceZip();
-		HZIP hz = NULL;
-        if( CPaintManagerUI::IsCachedResourceZip() ) hz = (HZIP)CPaintManagerUI::GetResourceZipHandle();
-        else {
-			CDuiString sFilePwd = CPaintManagerUI::GetResourceZipPwd();
-#ifdef UNICODE
-			char* pwd = w2a((wchar_t*)sFilePwd.GetData());
-			hz = OpenZip(sFile.GetData(), pwd);
-			if(pwd) delete[] pwd;
-#else
-            hz = OpenZip(sFile.GetData(), sFilePwd.GetData());
-#endif
-		}
-        if( hz == NULL ) return _Failed(_T("Error opening zip file"));
-        ZIPENTRY ze; 
-        int i = 0; 
-		CDuiString key = pstrFilename;
-		key.Replace(_T("\\"), _T("/"));
-        if( FindZipItem(hz, key, true, &i, &ze) != 0 ) return _Failed(_T("Could not find ziped file"));
-        DWORD dwSize = ze.unc_size;
-        if( dwSize == 0 ) return _Failed(_T("File is empty"));
-        if ( dwSize > 4096*1024 ) return _Failed(_T("File too large"));
-        BYTE* pByte = new BYTE[ dwSize ];
-        int res = UnzipItem(hz, i, pByte, dwSize);
-        if( res != 0x00000000 && res != 0x00000600) {
-            delete[] pByte;
-            if( !CPaintManagerUI::IsCachedResourceZip() ) CloseZip(hz);
-            return _Failed(_T("Could not unzip file"));
+        DWORD dwSize = 0;
+        int iZipView = -1;
+        LPBYTE pData = CPaintManagerUI::LoadResourceZipItem(pstrFilename, &dwSize, &iZipView);
+        if( pData == NULL ) return _Failed(_T("Could not find ziped file"));
+        if ( dwSize > 4096*1024 ) {
+            CPaintManagerUI::FreeResourceZipItem(pData, iZipView);
+            return _Failed(_T("File too large"));
         }
-        if( !CPaintManagerUI::IsCachedResourceZip() ) CloseZip(hz);
-        bool ret = LoadFromMem(pByte, dwSize, encoding);
-        delete[] pByte;
-		pByte = NULL;
-        return ret;
+        // The parser works in a padded buffer of its own, the zip item may be a view into the zip
+        BYTE* pByte = static_cast<BYTE*>(malloc(dwSize + XMLSCAN_PADDING));
+        ::CopyMemory(pByte, pData, dwSize);
+        CPaintManagerUI::FreeResourceZipItem(pData, iZipView);
+        return _LoadBuffer(pByte, dwSize, encoding);
     }
 }
 
+bool CMarkup::_LoadBuffer(BYTE* pByte, DWORD dwSize, int encoding)
+{
+    // A UTF-8 file is parsed in the buffer it was read into, anything else goes the usual way
+    if( encoding == XMLFILE_ENCODING_UTF8 && !(dwSize >= sizeof(XMLCOMPILEDHEADER) && *(DWORD UNALIGNED*)pByte == XMLCOMPILED_MAGIC) ) {
+        return _LoadUTF8(reinterpret_cast<LPSTR>(pByte), dwSize);
+    }
+    bool bRes = LoadFromMem(pByte, dwSize, encoding);
+    free(pByte);
+    return bRes;
+}
+
 void CMarkup::Release()
 {
     if( m_pstrXML != NULL ) free(m_pstrXML);
+    if( m_pstrUTF8 != NULL ) free(m_pstrUTF8);
+    if( m_pConverted != NULL ) free(m_pConverted);
     if( m_pElements != NULL ) free(m_pElements);
+    if( !m_bArena ) {
+        if( m_pAttributeIndex != NULL ) free(m_pAttributeIndex);
+        if( m_pAttributes != NULL ) free(m_pAttributes);
+    }
+    if( m_pElementClasses != NULL ) free(m_pElementClasses);
+    if( m_pClasses != NULL ) free(m_pClasses);
+    if( m_pAttributeInfo != NULL ) free(m_pAttributeInfo);
+    if( m_pNumbers != NULL ) free(m_pNumbers);
     m_pstrXML = NULL;
+    m_pstrUTF8 = NULL;
+    m_cbUTF8 = 0;
+    m_pConverted = NULL;
     m_pElements = NULL;
+    m_pAttributeIndex = NULL;
+    m_pAttributes = NULL;
+    m_pElementClasses = NULL;
+    m_pClasses = NULL;
+    m_nClasses = 0;
+    m_pAttributeInfo = NULL;
+    m_pNumbers = NULL;
     m_nElements = 0;
+    m_nAttributes = 0;
+    m_bArena = false;
+}
+
+LPCTSTR CMarkup::_GetString(ULONG iOffset)
+{
+    if( m_pstrUTF8 == NULL ) return m_pstrXML + iOffset;
+    LPCSTR pstr = m_pstrUTF8 + iOffset;
+#ifndef _UNICODE
+    // ASCII reads the same in the ANSI code page and is handed out in place
+    LPCSTR pstrChar = pstr;
+    while( (BYTE)(*pstrChar - 1) < 0x7F ) pstrChar++;
+    if( *pstrChar == '\0' ) return pstr;
+#endif
+    if( m_pstrXML == NULL ) {
+        m_pstrXML = static_cast<LPTSTR>(malloc(m_cbUTF8 * sizeof(TCHAR)));
+        m_pConverted = static_cast<BYTE*>(calloc((m_cbUTF8 + 7) / 8, 1));
+    }
+    BYTE bMask = (BYTE)(1 << (iOffset & 7));
+    if( (m_pConverted[iOffset >> 3] & bMask) == 0 ) {
+        // No string gets longer in TCHARs than it is in UTF-8 bytes, so it fits at its own offset
+        _ConvertUTF8(pstr, m_pstrXML + iOffset, (int)strlen(pstr) + 1);
+        m_pConverted[iOffset >> 3] |= bMask;
+    }
+    return m_pstrXML + iOffset;
+}
+
+// The string table of a compiled skin, every distinct string is stored once:
+// a skin repeats the same control and attribute names all over.
+class CMarkupStringTable
+{
+public:
+    CMarkupStringTable() : m_pstr(NULL), m_cch(0), m_cchReserved(0)
+    {
+    }
+
+    ~CMarkupStringTable()
+    {
+        if( m_pstr != NULL ) free(m_pstr);
+    }
+
+    ULONG Add(LPCTSTR pstr)
+    {
+        LPVOID pOffset = m_mOffsets.Find(pstr);
+        if( pOffset != NULL ) return (ULONG)((UINT_PTR)pOffset - 1);
+
+        ULONG cch = (ULONG)_tcslen(pstr) + 1;
+        if( m_cch + cch > m_cchReserved ) {
+            m_cchReserved += (m_cchReserved / 2) + cch + 4096;
+            m_pstr = static_cast<LPTSTR>(realloc(m_pstr, m_cchReserved * sizeof(TCHAR)));
+        }
+        ULONG iOffset = m_cch;
+        ::CopyMemory(m_pstr + iOffset, pstr, cch * sizeof(TCHAR));
+        m_cch += cch;
+        m_mOffsets.Insert(pstr, (LPVOID)(UINT_PTR)(iOffset + 1));
+        return iOffset;
+    }
+
+    LPCTSTR GetData() const { return m_pstr; }
+    ULONG GetLength() const { return m_cch; }
+
+private:
+    LPTSTR m_pstr;
+    ULONG m_cch;
+    ULONG m_cchReserved;
+    CStdStringPtrMap m_mOffsets;
+};
+
+bool CMarkup::SaveCompiledFile(LPCTSTR pstrFilename)
+{
+    if( m_nElements == 0 ) return _Failed(_T("Nothing to compile"));
+
+    // Element 0 is the reserved error slot, it is kept so the indexes stay the same
+    XMLELEMENT* pElements = static_cast<XMLELEMENT*>(malloc(m_nElements * sizeof(XMLELEMENT)));
+    ULONG* pElementClasses = static_cast<ULONG*>(malloc(m_nElements * sizeof(ULONG)));
+    ULONG* pIndex = static_cast<ULONG*>(malloc((m_nElements + 1) * sizeof(ULONG)));
+    ULONG* pAttributes = NULL;
+    XMLATTRIBUTEINFO* pAttributeInfo = NULL;
+    ULONG nAttributes = 0;
+    ULONG nReservedAttributes = 0;
+    LONG* pNumbers = NULL;
+    ULONG nNumbers = 0;
+    ULONG nReservedNumbers = 0;
+    // Every distinct element name is a class, the map holds its index plus one
+    ULONG* pClasses = NULL;
+    ULONG nClasses = 0;
+    CStdStringPtrMap mClasses;
+    CMarkupStringTable strings;
+    ::ZeroMemory(&pElements[0], sizeof(XMLELEMENT));
+    pElementClasses[0] = 0;
+    pIndex[0] = 0;
+    for( ULONG i = 1; i < m_nElements; i++ ) {
+        CMarkupNode node(this, i);
+        LPCTSTR pstrName = node.GetName();
+        pElements[i] = m_pElements[i];
+        pElements[i].iStart = strings.Add(pstrName);
+        pElements[i].iData = strings.Add(node.GetValue());
+        UINT_PTR iClass = (UINT_PTR)mClasses.Find(pstrName);
+        if( iClass == 0 ) {
+            if( (nClasses & 63) == 0 ) pClasses = static_cast<ULONG*>(realloc(pClasses, (nClasses + 64) * sizeof(ULONG)));
+            pClasses[nClasses++] = pElements[i].iStart;
+            iClass = nClasses;
+            mClasses.Insert(pstrName, (LPVOID)iClass);
+        }
+        pElementClasses[i] = (ULONG)(iClass - 1);
+        pIndex[i] = nAttributes;
+        int nCount = node.GetAttributeCount();
+        if( nAttributes + nCount > nReservedAttributes ) {
+            nReservedAttributes += (nReservedAttributes / 2) + nCount + 500;
+            pAttributes = static_cast<ULONG*>(realloc(pAttributes, nReservedAttributes * 2 * sizeof(ULONG)));
+            pAttributeInfo = static_cast<XMLATTRIBUTEINFO*>(realloc(pAttributeInfo, nReservedAttributes * sizeof(XMLATTRIBUTEINFO)));
+        }
+        for( int j = 0; j < nCount; j++ ) {
+            LPCTSTR pstrValue = node.GetAttributeValue(j);
+            pAttributes[nAttributes * 2] = strings.Add(node.GetAttributeName(j));
+            pAttributes[nAttributes * 2 + 1] = strings.Add(pstrValue);
+            if( nNumbers + 4 > nReservedNumbers ) {
+                nReservedNumbers += (nReservedNumbers / 2) + 1000;
+                pNumbers = static_cast<LONG*>(realloc(pNumbers, nReservedNumbers * sizeof(LONG)));
+            }
+            XMLATTRIBUTEINFO& info = pAttributeInfo[nAttributes];
+            ::ZeroMemory(&info, sizeof(info));
+            info.wId = _FindAttributeId(node.GetAttributeName(j));
+            info.bType = _ParseNumbers(pstrValue, pNumbers + nNumbers, info.nNumbers);
+            info.iNumbers = nNumbers;
+            nNumbers += info.nNumbers;
+            nAttributes++;
+        }
+    }
+    pIndex[m_nElements] = nAttributes;
+
+    XMLCOMPILEDHEADER header = { 0 };
+    header.dwMagic = XMLCOMPILED_MAGIC;
+    header.dwVersion = XMLCOMPILED_VERSION;
+    header.cbChar = sizeof(TCHAR);
+    header.nElements = m_nElements;
+    header.nAttributes = nAttributes;
+    header.cchStrings = strings.GetLength();
+    header.nClasses = nClasses;
+    header.nNumbers = nNumbers;
+    header.dwAttributeList = _GetAttributeListHash();
+
+    bool bRes = false;
+    HANDLE hFile = ::CreateFile(pstrFilename, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if( hFile != INVALID_HANDLE_VALUE ) {
+        const void* pBlocks[] = { &header, pElements, pElementClasses, pIndex, pAttributes, pAttributeInfo, pNumbers, pClasses, strings.GetData() };
+        DWORD cbBlocks[] = { (DWORD)sizeof(header), (DWORD)(m_nElements * sizeof(XMLELEMENT)), (DWORD)(m_nElements * sizeof(ULONG)),
+            (DWORD)((m_nElements + 1) * sizeof(ULONG)), (DWORD)(nAttributes * 2 * sizeof(ULONG)), (DWORD)(nAttributes * sizeof(XMLATTRIBUTEINFO)),
+            (DWORD)(nNumbers * sizeof(LONG)), (DWORD)(nClasses * sizeof(ULONG)), (DWORD)(strings.GetLength() * sizeof(TCHAR)) };
+        bRes = true;
+        for( SIZE_T i = 0; i < lengthof(pBlocks) && bRes; i++ ) {
+            DWORD dwWritten = 0;
+            if( cbBlocks[i] == 0 ) continue;
+            bRes = ::WriteFile(hFile, pBlocks[i], cbBlocks[i], &dwWritten, NULL) && dwWritten == cbBlocks[i];
+        }
+        ::CloseHandle(hFile);
+        if( !bRes ) ::DeleteFile(pstrFilename);
+    }
+
+    free(pElements);
+    free(pElementClasses);
+    free(pIndex);
+    if( pAttributes != NULL ) free(pAttributes);
+    if( pAttributeInfo != NULL ) free(pAttributeInfo);
+    if( pNumbers != NULL ) free(pNumbers);
+    if( pClasses != NULL ) free(pClasses);
+    if( hFile == INVALID_HANDLE_VALUE ) return _Failed(_T("Error creating file"));
+    if( !bRes ) return _Failed(_T("Could not write file"));
+    return true;
+}
+
+bool CMarkup::_LoadCompiled(const BYTE* pByte, DWORD dwSize)
+{
+    ::ZeroMemory(m_szErrorMsg, sizeof(m_szErrorMsg));
+    ::ZeroMemory(m_szErrorXML, sizeof(m_szErrorXML));
+    XMLCOMPILEDHEADER header;
+    ::CopyMemory(&header, pByte, sizeof(header));
+    if( header.dwVersion != XMLCOMPILED_VERSION || header.cbChar != sizeof(TCHAR) ) return _Failed(_T("Compiled skin version mismatch"));
+    // Each count is bounded by the file size first, so the sums below cannot overflow
+    if( header.nElements < 2 || header.nElements > dwSize / sizeof(XMLELEMENT)
+        || header.nAttributes > dwSize / (2 * sizeof(ULONG))
+        || header.cchStrings == 0 || header.cchStrings > dwSize / sizeof(TCHAR)
+        || header.nClasses == 0 || header.nClasses > dwSize / sizeof(ULONG)
+        || header.nNumbers > dwSize / sizeof(LONG) ) return _Failed(_T("Corrupt compiled skin"));
+    SIZE_T cbElements = header.nElements * sizeof(XMLELEMENT);
+    SIZE_T cbElementClasses = header.nElements * sizeof(ULONG);
+    SIZE_T cbIndex = (header.nElements + 1) * sizeof(ULONG);
+    SIZE_T cbAttributes = header.nAttributes * 2 * sizeof(ULONG);
+    SIZE_T cbAttributeInfo = header.nAttributes * sizeof(XMLATTRIBUTEINFO);
+    SIZE_T cbNumbers = header.nNumbers * sizeof(LONG);
+    SIZE_T cbClasses = header.nClasses * sizeof(ULONG);
+    SIZE_T cbStrings = header.cchStrings * sizeof(TCHAR);
+    if( sizeof(header) + cbElements + cbElementClasses + cbIndex + cbAttributes + cbAttributeInfo + cbNumbers + cbClasses + cbStrings != dwSize ) {
+        return _Failed(_T("Corrupt compiled skin"));
+    }
+
+    pByte += sizeof(header);
+    m_pElements = static_cast<XMLELEMENT*>(malloc(cbElements));
+    ::CopyMemory(m_pElements, pByte, cbElements);
+    pByte += cbElements;
+    m_pElementClasses = static_cast<ULONG*>(malloc(cbElementClasses));
+    ::CopyMemory(m_pElementClasses, pByte, cbElementClasses);
+    pByte += cbElementClasses;
+    m_pAttributeIndex = static_cast<ULONG*>(malloc(cbIndex));
+    ::CopyMemory(m_pAttributeIndex, pByte, cbIndex);
+    pByte += cbIndex;
+    m_pAttributes = static_cast<ULONG*>(malloc(cbAttributes + sizeof(ULONG)));
+    ::CopyMemory(m_pAttributes, pByte, cbAttributes);
+    pByte += cbAttributes;
+    m_pAttributeInfo = static_cast<XMLATTRIBUTEINFO*>(malloc(cbAttributeInfo + sizeof(XMLATTRIBUTEINFO)));
+    ::CopyMemory(m_pAttributeInfo, pByte, cbAttributeInfo);
+    pByte += cbAttributeInfo;
+    m_pNumbers = static_cast<LONG*>(malloc(cbNumbers + sizeof(LONG)));
+    ::CopyMemory(m_pNumbers, pByte, cbNumbers);
+    pByte += cbNumbers;
+    m_pClasses = static_cast<ULONG*>(malloc(cbClasses));
+    ::CopyMemory(m_pClasses, pByte, cbClasses);
+    pByte += cbClasses;
+    m_pstrXML = static_cast<LPTSTR>(malloc(cbStrings));
+    ::CopyMemory(m_pstrXML, pByte, cbStrings);
+    m_nElements = m_nReservedElements = header.nElements;
+    m_nClasses = header.nClasses;
+
+    // The nodes index these tables directly, a damaged file must not send them out of bounds.
+    // Children and siblings always follow their element, so no walk can loop either.
+    bool bValid = m_pstrXML[header.cchStrings - 1] == _T('\0') && m_pAttributeIndex[0] == 0
+        && m_pAttributeIndex[header.nElements] == header.nAttributes;
+    for( ULONG i = 1; i < header.nElements && bValid; i++ ) {
+        const XMLELEMENT& el = m_pElements[i];
+        bValid = el.iStart < header.cchStrings && el.iData < header.cchStrings
+            && el.iChild < header.nElements && (el.iChild == 0 || el.iChild > i)
+            && el.iNext < header.nElements && (el.iNext == 0 || el.iNext > i) && el.iParent < i
+            && m_pAttributeIndex[i] <= m_pAttributeIndex[i + 1] && m_pElementClasses[i] < header.nClasses;
+    }
+    m_pElementClasses[0] = 0;
+    for( ULONG i = 0; i < header.nClasses && bValid; i++ ) {
+        bValid = m_pClasses[i] < header.cchStrings;
+    }
+    for( ULONG i = 0; i < header.nAttributes * 2 && bValid; i++ ) {
+        bValid = m_pAttributes[i] < header.cchStrings;
+    }
+    bool bSameList = header.dwAttributeList == _GetAttributeListHash();
+    for( ULONG i = 0; i < header.nAttributes && bValid; i++ ) {
+        XMLATTRIBUTEINFO& info = m_pAttributeInfo[i];
+        if( info.bType == XMLVALUE_TEXT ) bValid = info.nNumbers == 0;
+        else bValid = info.bType <= XMLVALUE_COLOR && info.nNumbers >= 1 && info.nNumbers <= 4
+            && info.iNumbers <= header.nNumbers && info.nNumbers <= header.nNumbers - info.iNumbers;
+        if( !bSameList || info.wId >= DUIATTR_COUNT ) info.wId = _FindAttributeId(m_pstrXML + m_pAttributes[i * 2]);
+    }
+    if( !bValid ) {
+        Release();
+        return _Failed(_T("Corrupt compiled skin"));
+    }
+    return true;
 }
 
 void CMarkup::GetLastErrorMessage(LPTSTR pstrMessage, SIZE_T cchMax) const
@@ -418,9 +987,21 @@ void CMarkup::GetLastErrorLocation(LPTSTR pstrSource, SIZE_T cchMax) const
     _tcsncpy(pstrSource, m_szErrorXML, cchMax);
 }
 
+int CMarkup::GetClassCount() const
+{
+    return (int)m_nClasses;
+}
+
+LPCTSTR CMarkup::GetClass(int iClass)
+{
+    if( iClass < 0 || iClass >= (int)m_nClasses ) return NULL;
+    return _GetString(m_pClasses[iClass]);
+}
+
 CMarkupNode CMarkup::GetRoot()
 {
-    if( m_nElements == 0 ) return CMarkupNode();
+    // Element 0 is the error slot, a skin with nothing but comments and directives has no root
+    if( m_nElements < 2 ) return CMarkupNode();
     return CMarkupNode(this, 1);
 }
 
@@ -486,7 +1067,12 @@ bool CMarkup::_Parse(LPTSTR& pstrText, ULONG iParent)
             LPTSTR pstrDest = pstrText;
             if( !_ParseData(pstrText, pstrDest, _T('<')) ) return false;
             // Determine type of next element
-            if( *pstrText == _T('\0') && iParent <= 1 ) return true;
+            if( *pstrText == _T('\0') && iParent <= 1 ) {
+                // the text ends inside the element, its name and data still need their ends
+                *pstrDest = _T('\0');
+                *pstrNameEnd = _T('\0');
+                return true;
+            }
             if( *pstrText != _T('<') ) return _Failed(_T("Expected end-tag start"), pstrText);
             if( pstrText[0] == _T('<') && pstrText[1] != _T('/') ) 
             {
@@ -502,7 +1088,8 @@ bool CMarkup::_Parse(LPTSTR& pstrText, ULONG iParent)
                 if( _tcsncmp(pstrText, pstrName, cchName) != 0 ) return _Failed(_T("Unmatched closing tag"), pstrText);
                 pstrText += cchName;
                 _SkipWhitespace(pstrText);
-                if( *pstrText++ != _T('>') ) return _Failed(_T("Unmatched closing tag"), pstrText);
+                if( *pstrText != _T('>') ) return _Failed(_T("Unmatched closing tag"), pstrText);
+                pstrText++;
             }
         }
         *pstrNameEnd = _T('\0');
@@ -558,7 +1145,8 @@ bool CMarkup::_ParseAttributes(LPTSTR& pstrText)
         *pstrText++ = _T(' ');
         *pstrIdentifierEnd = _T('\0');
         _SkipWhitespace(pstrText);
-        if( *pstrText++ != _T('\"') ) return _Failed(_T("Expected attribute value"), pstrText);
+        if( *pstrText != _T('\"') ) return _Failed(_T("Expected attribute value"), pstrText);
+        pstrText++;
         LPTSTR pstrDest = pstrText;
         if( !_ParseData(pstrText, pstrDest, _T('\"')) ) return false;
         if( *pstrText == _T('\0') ) return _Failed(_T("Error while parsing attribute string"), pstrText);
@@ -601,31 +1189,198 @@ bool CMarkup::_ParseData(LPTSTR& pstrText, LPTSTR& pstrDest, char cEnd)
 
 void CMarkup::_ParseMetaChar(LPTSTR& pstrText, LPTSTR& pstrDest)
 {
-    if( pstrText[0] == _T('a') && pstrText[1] == _T('m') && pstrText[2] == _T('p') && pstrText[3] == _T(';') ) {
-        *pstrDest++ = _T('&');
-        pstrText += 4;
-    }
-    else if( pstrText[0] == _T('l') && pstrText[1] == _T('t') && pstrText[2] == _T(';') ) {
-        *pstrDest++ = _T('<');
-        pstrText += 3;
-    }
-    else if( pstrText[0] == _T('g') && pstrText[1] == _T('t') && pstrText[2] == _T(';') ) {
-        *pstrDest++ = _T('>');
-        pstrText += 3;
-    }
-    else if( pstrText[0] == _T('q') && pstrText[1] == _T('u') && pstrText[2] == _T('o') && pstrText[3] == _T('t') && pstrText[4] == _T(';') ) {
-        *pstrDest++ = _T('\"');
-        pstrText += 5;
+    _DecodeMetaChar(pstrText, pstrDest);
+}
+
+bool CMarkup::_LoadUTF8(LPSTR pstrBuffer, DWORD dwSize)
+{
+    // The markup owns the buffer from here on, the text is tokenised in it
+    ::ZeroMemory(pstrBuffer + dwSize, XMLSCAN_PADDING);
+    m_pstrUTF8 = pstrBuffer;
+    m_cbUTF8 = dwSize + 1;
+    ::ZeroMemory(m_szErrorMsg, sizeof(m_szErrorMsg));
+    ::ZeroMemory(m_szErrorXML, sizeof(m_szErrorXML));
+    LPSTR pstrText = pstrBuffer;
+    if( dwSize >= 3 && (BYTE)pstrText[0] == 0xEF && (BYTE)pstrText[1] == 0xBB && (BYTE)pstrText[2] == 0xBF ) pstrText += 3;
+
+    // One block for the elements, the attribute index and the attributes, sized by the counts.
+    // Element 0 is reserved for errors.
+    ULONG nTags = 0;
+    ULONG nQuotes = 0;
+    _CountMarkupUTF8(pstrText, pstrBuffer + dwSize, nTags, nQuotes);
+    m_nReservedElements = nTags + 2;
+    m_nReservedAttributes = nQuotes / 2;
+    SIZE_T cbElements = m_nReservedElements * sizeof(XMLELEMENT);
+    SIZE_T cbIndex = (m_nReservedElements + 1) * sizeof(ULONG);
+    SIZE_T cbAttributes = m_nReservedAttributes * 2 * sizeof(ULONG);
+    BYTE* pArena = static_cast<BYTE*>(malloc(cbElements + cbIndex + cbAttributes + sizeof(ULONG)));
+    m_pElements = reinterpret_cast<XMLELEMENT*>(pArena);
+    m_pAttributeIndex = reinterpret_cast<ULONG*>(pArena + cbElements);
+    m_pAttributes = reinterpret_cast<ULONG*>(pArena + cbElements + cbIndex);
+    m_bArena = true;
+    ::ZeroMemory(m_pElements, 2 * sizeof(XMLELEMENT));
+    m_pElements[1].iStart = m_pElements[1].iData = dwSize;
+    m_pAttributeIndex[0] = 0;
+    m_nElements = 1;
+    m_nAttributes = 0;
+
+    bool bRes = _ParseUTF8(pstrText, 0);
+    // The entry after the last element too
+    m_pAttributeIndex[m_nElements] = m_pAttributeIndex[m_nElements + 1] = m_nAttributes;
+    if( !bRes ) Release();
+    return bRes;
+}
+
+bool CMarkup::_ParseUTF8(LPSTR& pstrText, ULONG iParent)
+{
+    _SkipWhitespaceUTF8(pstrText);
+    ULONG iPrevious = 0;
+    for( ; ; )
+    {
+        if( *pstrText == '\0' && iParent <= 1 ) return true;
+        _SkipWhitespaceUTF8(pstrText);
+        if( *pstrText != '<' ) return _FailedUTF8(_T("Expected start tag"), pstrText);
+        if( pstrText[1] == '/' ) return true;
+        *pstrText++ = '\0';
+        _SkipWhitespaceUTF8(pstrText);
+        // Skip comment or processing directive
+        if( *pstrText == '!' || *pstrText == '?' ) {
+            char ch = *pstrText == '!' ? '-' : '?';
+            do {
+                pstrText = _ScanUTF8(pstrText + 1, '>', '>', '>');
+            } while( *pstrText != '\0' && pstrText[-1] != ch );
+            if( *pstrText != '\0' ) pstrText++;
+            _SkipWhitespaceUTF8(pstrText);
+            continue;
+        }
+        _SkipWhitespaceUTF8(pstrText);
+        // Fill out element structure, the counted '<' leave room for every element
+        if( m_nElements >= m_nReservedElements - 1 ) return _FailedUTF8(_T("Too many elements"), pstrText);
+        ULONG iPos = m_nElements++;
+        XMLELEMENT* pEl = &m_pElements[iPos];
+        pEl->iStart = pstrText - m_pstrUTF8;
+        pEl->iParent = iParent;
+        pEl->iNext = pEl->iChild = 0;
+        if( iPrevious != 0 ) m_pElements[iPrevious].iNext = iPos;
+        else if( iParent > 0 ) m_pElements[iParent].iChild = iPos;
+        iPrevious = iPos;
+        m_pAttributeIndex[iPos] = m_nAttributes;
+        // Parse name
+        LPCSTR pstrName = pstrText;
+        _SkipIdentifierUTF8(pstrText);
+        LPSTR pstrNameEnd = pstrText;
+        if( *pstrText == '\0' ) return _FailedUTF8(_T("Error parsing element name"), pstrText);
+        // Parse attributes
+        if( !_ParseAttributesUTF8(pstrText) ) return false;
+        _SkipWhitespaceUTF8(pstrText);
+        if( pstrText[0] == '/' && pstrText[1] == '>' )
+        {
+            pEl->iData = pstrText - m_pstrUTF8;
+            *pstrText = '\0';
+            pstrText += 2;
+        }
+        else
+        {
+            if( *pstrText != '>' ) return _FailedUTF8(_T("Expected start-tag closing"), pstrText);
+            // Parse node data
+            pEl->iData = ++pstrText - m_pstrUTF8;
+            LPSTR pstrDest = pstrText;
+            _ParseDataUTF8(pstrText, pstrDest, '<');
+            // Determine type of next element
+            if( *pstrText == '\0' && iParent <= 1 ) {
+                *pstrDest = '\0';
+                *pstrNameEnd = '\0';
+                return true;
+            }
+            if( *pstrText != '<' ) return _FailedUTF8(_T("Expected end-tag start"), pstrText);
+            if( pstrText[0] == '<' && pstrText[1] != '/' )
+            {
+                if( !_ParseUTF8(pstrText, iPos) ) return false;
+            }
+            if( pstrText[0] == '<' && pstrText[1] == '/' )
+            {
+                *pstrDest = '\0';
+                *pstrText = '\0';
+                pstrText += 2;
+                _SkipWhitespaceUTF8(pstrText);
+                SIZE_T cchName = pstrNameEnd - pstrName;
+                if( strncmp(pstrText, pstrName, cchName) != 0 ) return _FailedUTF8(_T("Unmatched closing tag"), pstrText);
+                pstrText += cchName;
+                _SkipWhitespaceUTF8(pstrText);
+                if( *pstrText != '>' ) return _FailedUTF8(_T("Unmatched closing tag"), pstrText);
+                pstrText++;
+            }
+        }
+        *pstrNameEnd = '\0';
+        _SkipWhitespaceUTF8(pstrText);
     }
-    else if( pstrText[0] == _T('a') && pstrText[1] == _T('p') && pstrText[2] == _T('o') && pstrText[3] == _T('s') && pstrText[4] == _T(';') ) {
-        *pstrDest++ = _T('\'');
-        pstrText += 5;
+}
+
+bool CMarkup::_ParseAttributesUTF8(LPSTR& pstrText)
+{
+    if( pstrText[0] == '/' && pstrText[1] == '>' ) return true;
+    if( *pstrText == '>' ) return true;
+    *pstrText++ = '\0';
+    _SkipWhitespaceUTF8(pstrText);
+    while( *pstrText != '\0' && *pstrText != '>' && *pstrText != '/' ) {
+        LPSTR pstrName = pstrText;
+        _SkipIdentifierUTF8(pstrText);
+        LPSTR pstrNameEnd = pstrText;
+        _SkipWhitespaceUTF8(pstrText);
+        if( *pstrText != '=' ) return _FailedUTF8(_T("Error while parsing attributes"), pstrText);
+        pstrText++;
+        *pstrNameEnd = '\0';
+        _SkipWhitespaceUTF8(pstrText);
+        if( *pstrText != '\"' ) return _FailedUTF8(_T("Expected attribute value"), pstrText);
+        pstrText++;
+        LPSTR pstrDest = pstrText;
+        LPSTR pstrValue = pstrText;
+        _ParseDataUTF8(pstrText, pstrDest, '\"');
+        if( *pstrText == '\0' ) return _FailedUTF8(_T("Error while parsing attribute string"), pstrText);
+        *pstrDest = '\0';
+        pstrText++;
+        // The counted quotes leave room for every attribute
+        if( m_nAttributes >= m_nReservedAttributes ) return _FailedUTF8(_T("Too many attributes"), pstrText);
+        m_pAttributes[m_nAttributes * 2] = pstrName - m_pstrUTF8;
+        m_pAttributes[m_nAttributes * 2 + 1] = pstrValue - m_pstrUTF8;
+        m_nAttributes++;
+        _SkipWhitespaceUTF8(pstrText);
     }
-    else {
-        *pstrDest++ = _T('&');
+    return true;
+}
+
+void CMarkup::_ParseDataUTF8(LPSTR& pstrText, LPSTR& pstrDest, char cEnd)
+{
+    // Plain text is skipped 16 bytes at a time and only moved once an entity shortened it
+    char cSpace = m_bPreserveWhitespace ? cEnd : ' ';
+    for( ; ; ) {
+        LPSTR pstrStop = _ScanUTF8(pstrText, cEnd, '&', cSpace);
+        if( pstrDest != pstrText ) ::MoveMemory(pstrDest, pstrText, pstrStop - pstrText);
+        pstrDest += pstrStop - pstrText;
+        pstrText = pstrStop;
+        if( *pstrText == '&' ) {
+            _DecodeMetaChar(++pstrText, pstrDest);
+        }
+        else if( *pstrText == ' ' && cSpace == ' ' ) {
+            *pstrDest++ = *pstrText++;
+            _SkipWhitespaceUTF8(pstrText);
+        }
+        else {
+            return;
+        }
     }
 }
 
+bool CMarkup::_FailedUTF8(LPCTSTR pstrError, LPCSTR pstrLocation)
+{
+    char szLocation[lengthof(m_szErrorXML)];
+    strncpy(szLocation, pstrLocation, lengthof(szLocation) - 1);
+    szLocation[lengthof(szLocation) - 1] = '\0';
+    TCHAR szXML[lengthof(m_szErrorXML)];
+    _ConvertUTF8(szLocation, szXML, lengthof(szXML));
+    return _Failed(pstrError, szXML);
+}
+
 bool CMarkup::_Failed(LPCTSTR pstrError, LPCTSTR pstrLocation)
 {
     // Register last error
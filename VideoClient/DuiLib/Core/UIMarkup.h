@@ -12,6 +12,14 @@ namespace DuiLib {
 		XMLFILE_ENCODING_ASNI = 2,
 	};
 
+	// How a compiled skin stored an attribute value, see CMarkupNode::GetAttributeType
+	enum
+	{
+		XMLVALUE_TEXT = 0,
+		XMLVALUE_INT = 1,	// one to four decimal numbers separated by commas, "12" or "0,0,0,32"
+		XMLVALUE_COLOR = 2,	// '#' and up to eight hex digits, "#FF333333"
+	};
+
 	class CMarkup;
 	class CMarkupNode;
 
@@ -26,8 +34,15 @@ namespace DuiLib {
 		bool Load(LPCTSTR pstrXML);
 		bool LoadFromMem(BYTE* pByte, DWORD dwSize, int encoding = XMLFILE_ENCODING_UTF8);
 		bool LoadFromFile(LPCTSTR pstrFilename, int encoding = XMLFILE_ENCODING_UTF8);
+		// Writes the parsed markup as a compiled skin. LoadFromMem and LoadFromFile recognise
+		// one by its header and load it without converting or tokenising any text.
+		bool SaveCompiledFile(LPCTSTR pstrFilename);
 		void Release();
 		bool IsValid() const;
+		void Swap(CMarkup& markup);
+		// Maps the attributes of every element once, so the nodes of a markup that is walked
+		// many times copy them instead of scanning the text. Compiled skins come mapped.
+		void IndexAttributes();
 
 		void SetPreserveWhitespace(bool bPreserve = true);
 		void GetLastErrorMessage(LPTSTR pstrMessage, SIZE_T cchMax) const;
@@ -35,6 +50,11 @@ namespace DuiLib {
 
 		CMarkupNode GetRoot();
 
+		// The distinct element names of a compiled skin, CMarkupNode::GetClassIndex indexes them.
+		// A markup parsed from text has none.
+		int GetClassCount() const;
+		LPCTSTR GetClass(int iClass);
+
 	private:
 		typedef struct tagXMLELEMENT
 		{
@@ -45,10 +65,54 @@ namespace DuiLib {
 			ULONG iData;
 		} XMLELEMENT;
 
+		// The DUIATTR_* id of an attribute of a compiled skin and its value as numbers,
+		// nNumbers of them at iNumbers in the number table when bType is not XMLVALUE_TEXT
+		typedef struct tagXMLATTRIBUTEINFO
+		{
+			WORD wId;
+			BYTE bType;
+			BYTE nNumbers;
+			ULONG iNumbers;
+		} XMLATTRIBUTEINFO;
+
+		// A compiled skin is this header, the element table, the class of every element, the
+		// first attribute of every element (plus one past the last), the name/value offsets of
+		// the attributes, their ids and types, the number table, the class table (the name
+		// offset of every distinct element name) and the string table they all point into.
+		// dwAttributeList is a hash of the DUI_ATTRIBUTE_LIST the ids were taken from.
+		typedef struct tagXMLCOMPILEDHEADER
+		{
+			DWORD dwMagic;
+			DWORD dwVersion;
+			DWORD cbChar;
+			DWORD nElements;
+			DWORD nAttributes;
+			DWORD cchStrings;
+			DWORD nClasses;
+			DWORD nNumbers;
+			DWORD dwAttributeList;
+		} XMLCOMPILEDHEADER;
+
+		// UTF-8 skins are parsed in place in m_pstrUTF8 and every offset points into it, m_pstrXML then
+		// holds the strings converted to TCHAR at the same offsets, one bit of m_pConverted per offset.
 		LPTSTR m_pstrXML;
+		LPSTR m_pstrUTF8;
+		ULONG m_cbUTF8;
+		BYTE* m_pConverted;
 		XMLELEMENT* m_pElements;
+		ULONG* m_pAttributeIndex; // compiled and UTF-8 skins, NULL when TCHAR text was parsed
+		ULONG* m_pAttributes;
+		// Compiled skins only, NULL otherwise
+		ULONG* m_pElementClasses;
+		ULONG* m_pClasses;
+		ULONG m_nClasses;
+		XMLATTRIBUTEINFO* m_pAttributeInfo;
+		LONG* m_pNumbers;
 		ULONG m_nElements;
 		ULONG m_nReservedElements;
+		ULONG m_nAttributes;
+		ULONG m_nReservedAttributes;
+		bool m_bArena; // the element, index and attribute tables are one block at m_pElements
 		TCHAR m_szErrorMsg[100];
 		TCHAR m_szErrorXML[50];
 		bool m_bPreserveWhitespace;
@@ -56,6 +120,13 @@ namespace DuiLib {
 	private:
 		bool _Parse();
 		bool _Parse(LPTSTR& pstrText, ULONG iParent);
+		bool _LoadCompiled(const BYTE* pByte, DWORD dwSize);
+		bool _LoadBuffer(BYTE* pByte, DWORD dwSize, int encoding);
+		bool _LoadUTF8(LPSTR pstrBuffer, DWORD dwSize);
+		bool _ParseUTF8(LPSTR& pstrText, ULONG iParent);
+		bool _ParseAttributesUTF8(LPSTR& pstrText);
+		void _ParseDataUTF8(LPSTR& pstrText, LPSTR& pstrDest, char cEnd);
+		LPCTSTR _GetString(ULONG iOffset);
 		XMLELEMENT* _ReserveElement();
 		inline void _SkipWhitespace(LPTSTR& pstr) const;
 		inline void _SkipWhitespace(LPCTSTR& pstr) const;
@@ -65,6 +136,7 @@ namespace DuiLib {
 		void _ParseMetaChar(LPTSTR& pstrText, LPTSTR& pstrDest);
 		bool _ParseAttributes(LPTSTR& pstrText);
 		bool _Failed(LPCTSTR pstrError, LPCTSTR pstrLocation = NULL);
+		bool _FailedUTF8(LPCTSTR pstrError, LPCSTR pstrLocation);
 	};
 
 
@@ -97,6 +169,15 @@ namespace DuiLib {
 		bool GetAttributeValue(int iIndex, LPTSTR pstrValue, SIZE_T cchMax);
 		bool GetAttributeValue(LPCTSTR pstrName, LPTSTR pstrValue, SIZE_T cchMax);
 
+		// What a compiled skin worked out when it was compiled: the index of the element name in
+		// CMarkup::GetClass, the DUIATTR_* id of an attribute and its value as numbers.
+		// GetClassIndex and GetAttributeId return -1 for a markup parsed from text, GetAttributeType
+		// XMLVALUE_TEXT, and GetAttributeNumbers copies up to nMax numbers and returns their count.
+		int GetClassIndex() const;
+		int GetAttributeId(int iIndex);
+		int GetAttributeType(int iIndex);
+		int GetAttributeNumbers(int iIndex, LONG* pNumbers, int nMax);
+
 	private:
 		void _MapAttributes();
 
@@ -0,0 +1,872 @@
+#include "StdAfx.h"
+#include <math.h>
+#include <vector>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#include <immintrin.h>
+#define PIXEL_KERNEL_SIMD
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>
+#define PIXEL_KERNEL_AVX2
+#elif defined(PIXEL_KERNEL_SIMD)
+#define PIXEL_KERNEL_AVX2 __attribute__((target("avx2")))
+#endif
+
+namespace DuiLib {
+
+	/////////////////////////////////////////////////////////////////////////////////////
+	//
+	// The plain C loops say what every kernel does; the SSE2 and AVX2 ones do the same a
+	// register at a time and hand whatever is left over to them.
+
+	static bool PremultiplyC(DWORD* pDest, const BYTE* pRGBA, int nPixels, DWORD dwMask)
+	{
+		bool bAlpha = false;
+		for( int i = 0; i < nPixels; i++ ) {
+			const BYTE* p = pRGBA + i * 4;
+			DWORD a = p[3];
+			DWORD dw;
+			if( a < 255 ) {
+				dw = (a << 24) | ((p[0] * a / 255) << 16) | ((p[1] * a / 255) << 8) | (p[2] * a / 255);
+				bAlpha = true;
+			}
+			else dw = 0xFF000000 | (p[0] << 16) | (p[1] << 8) | p[2];
+			if( dw == dwMask ) {
+				dw = 0;
+				bAlpha = true;
+			}
+			pDest[i] = dw;
+		}
+		return bAlpha;
+	}
+
+	static void UnpremultiplyC(DWORD* pBits, int nPixels)
+	{
+		for( int i = 0; i < nPixels; i++ ) {
+			DWORD dw = pBits[i];
+			DWORD a = dw >> 24;
+			if( a == 0 ) {
+				pBits[i] = 0;
+				continue;
+			}
+			DWORD dwResult = dw & 0xFF000000;
+			for( int nShift = 0; nShift < 24; nShift += 8 ) {
+				DWORD c = (((dw >> nShift) & 0xFF) * 255 + a / 2) / a;
+				dwResult |= (c > 255 ? 255 : c) << nShift;
+			}
+			pBits[i] = dwResult;
+		}
+	}
+
+	static void FillC(DWORD* pBits, int nPixels, DWORD dwColor)
+	{
+		for( int i = 0; i < nPixels; i++ ) pBits[i] = dwColor;
+	}
+
+	static void RestoreAlphaC(DWORD* pBits, int nPixels)
+	{
+		for( int i = 0; i < nPixels; i++ ) {
+			if( (pBits[i] & 0xFF000000) == 0 && (pBits[i] & 0x00FFFFFF) != 0 ) pBits[i] |= 0xFF000000;
+		}
+	}
+
+	static void MakeOpaqueC(DWORD* pBits, int nPixels)
+	{
+		for( int i = 0; i < nPixels; i++ ) {
+			if( pBits[i] != 0 ) pBits[i] |= 0xFF000000;
+		}
+	}
+
+	// resampling weights are fixed point and sum to exactly 1 << RESAMPLE_SHIFT for every
+	// destination pixel; none is negative, so no channel can come out past 255
+	enum { RESAMPLE_SHIFT = 14, RESAMPLE_ROUND = 1 << (RESAMPLE_SHIFT - 1) };
+
+	static DWORD ResamplePack(const int* pSum)
+	{
+		DWORD dw = 0;
+		for( int c = 0; c < 4; c++ ) dw |= (DWORD)((pSum[c] + RESAMPLE_ROUND) >> RESAMPLE_SHIFT) << (c * 8);
+		return dw;
+	}
+
+	// pDest[i] from pixel i of each of the nTaps rows, for i from iFirst on; the SIMD columns
+	// hand their tails to it
+	static void ResampleColumnSpanC(DWORD* pDest, int iFirst, int nPixels, const DWORD* const* ppRows, const short* pWeights, int nTaps)
+	{
+		for( int i = iFirst; i < nPixels; i++ ) {
+			int sum[4] = { 0 };
+			for( int k = 0; k < nTaps; k++ ) {
+				for( int c = 0; c < 4; c++ ) sum[c] += pWeights[k] * (int)((ppRows[k][i] >> (c * 8)) & 0xFF);
+			}
+			pDest[i] = ResamplePack(sum);
+		}
+	}
+
+#ifndef PIXEL_KERNEL_SIMD
+	// pDest[x] from the nTaps source pixels starting at pSrc[pStart[x]]
+	static void ResampleRowC(DWORD* pDest, int cxDest, const DWORD* pSrc, const int* pStart, const short* pWeights, int nTaps)
+	{
+		for( int x = 0; x < cxDest; x++ ) {
+			const DWORD* p = pSrc + pStart[x];
+			const short* w = pWeights + x * nTaps;
+			int sum[4] = { 0 };
+			for( int k = 0; k < nTaps; k++ ) {
+				for( int c = 0; c < 4; c++ ) sum[c] += w[k] * (int)((p[k] >> (c * 8)) & 0xFF);
+			}
+			pDest[x] = ResamplePack(sum);
+		}
+	}
+
+	static void ResampleColumnC(DWORD* pDest, int nPixels, const DWORD* const* ppRows, const short* pWeights, int nTaps)
+	{
+		ResampleColumnSpanC(pDest, 0, nPixels, ppRows, pWeights, nTaps);
+	}
+#endif
+
+	// SetHSL's adjustment of a colour, in the float steps RGBtoHSL and HSLtoRGB have always
+	// taken. The SSE2 and AVX2 copies take the same steps in the same order, so every pixel
+	// comes out bit for bit the same. A run also remembers the colours it has converted in a
+	// small direct-mapped table, which covers most of the flat areas of skin art.
+	typedef struct tagTHSLAdjust
+	{
+		float fH;
+		float fS;
+		float fL;
+	} THSLAdjust;
+
+	typedef struct tagTHSLMemo
+	{
+		DWORD dwColor[4096];
+		DWORD dwResult[4096];
+	} THSLMemo;
+
+#define HSL_MEMO_SLOT(c) (((c) * 0x9E3779B1u) >> 20)
+
+	static const float OneThird = 1.0f / 3;
+
+	static inline float HSLMin(float a, float b) { return a < b ? a : b; }
+	static inline float HSLMax(float a, float b) { return a > b ? a : b; }
+
+	static void RGBtoHSL(DWORD ARGB, float* H, float* S, float* L) {
+		const float
+			R = (float)GetRValue(ARGB),
+			G = (float)GetGValue(ARGB),
+			B = (float)GetBValue(ARGB),
+			nR = (R<0?0:(R>255?255:R))/255,
+			nG = (G<0?0:(G>255?255:G))/255,
+			nB = (B<0?0:(B>255?255:B))/255,
+			m = HSLMin(HSLMin(nR,nG),nB),
+			M = HSLMax(HSLMax(nR,nG),nB);
+		*L = (m + M)/2;
+		if (M==m) *H = *S = 0;
+		else {
+			const float
+				f = (nR==m)?(nG-nB):((nG==m)?(nB-nR):(nR-nG)),
+				i = (nR==m)?3.0f:((nG==m)?5.0f:1.0f);
+			*H = (i-f/(M-m));
+			if (*H>=6) *H-=6;
+			*H*=60;
+			*S = (2*(*L)<=1)?((M-m)/(M+m)):((M-m)/(2-M-m));
+		}
+	}
+
+	static void HSLtoRGB(DWORD* ARGB, float H, float S, float L) {
+		const float
+			q = 2*L<1?L*(1+S):(L+S-L*S),
+			p = 2*L-q,
+			h = H/360,
+			tr = h + OneThird,
+			tg = h,
+			tb = h - OneThird,
+			ntr = tr<0?tr+1:(tr>1?tr-1:tr),
+			ntg = tg<0?tg+1:(tg>1?tg-1:tg),
+			ntb = tb<0?tb+1:(tb>1?tb-1:tb),
+			B = 255*(6*ntr<1?p+(q-p)*6*ntr:(2*ntr<1?q:(3*ntr<2?p+(q-p)*6*(2.0f*OneThird-ntr):p))),
+			G = 255*(6*ntg<1?p+(q-p)*6*ntg:(2*ntg<1?q:(3*ntg<2?p+(q-p)*6*(2.0f*OneThird-ntg):p))),
+			R = 255*(6*ntb<1?p+(q-p)*6*ntb:(2*ntb<1?q:(3*ntb<2?p+(q-p)*6*(2.0f*OneThird-ntb):p)));
+		*ARGB &= 0xFF000000;
+		*ARGB |= RGB( (BYTE)(R<0?0:(R>255?255:R)), (BYTE)(G<0?0:(G>255?255:G)), (BYTE)(B<0?0:(B>255?255:B)) );
+	}
+
+	static DWORD AdjustPixelHSL(DWORD dwSrc, const THSLAdjust& adj)
+	{
+		float fH, fS, fL;
+		RGBtoHSL(dwSrc, &fH, &fS, &fL);
+		fH += adj.fH;
+		fH = fH > 0 ? fH : fH + 360;
+		fS *= adj.fS;
+		fL *= adj.fL;
+		DWORD dwDest = dwSrc;
+		HSLtoRGB(&dwDest, fH, fS, fL);
+		return dwDest;
+	}
+
+	static void AdjustHSLC(DWORD* pDest, const DWORD* pSrc, int nPixels, const THSLAdjust& adj, THSLMemo* pMemo)
+	{
+		for( int i = 0; i < nPixels; i++ ) {
+			DWORD dwColor = pSrc[i] & 0x00FFFFFF;
+			DWORD dwSlot = HSL_MEMO_SLOT(dwColor);
+			if( pMemo->dwColor[dwSlot] != dwColor ) {
+				pMemo->dwColor[dwSlot] = dwColor;
+				pMemo->dwResult[dwSlot] = AdjustPixelHSL(dwColor, adj) & 0x00FFFFFF;
+			}
+			pDest[i] = (pSrc[i] & 0xFF000000) | pMemo->dwResult[dwSlot];
+		}
+	}
+
+#ifdef PIXEL_KERNEL_SIMD
+	/////////////////////////////////////////////////////////////////////////////////////
+	//
+	// c * a / 255 is worked out in 16-bit lanes as (x + 1 + (x >> 8)) >> 8 with x = c * a,
+	// which is exact for every x up to 255 * 255. Unpremultiplying divides in float, which
+	// can't round across a whole number for values this small.
+
+	static bool PremultiplySSE2(DWORD* pDest, const BYTE* pRGBA, int nPixels, DWORD dwMask)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i one = _mm_set1_epi16(1);
+		const __m128i alpha = _mm_set1_epi32((int)0xFF000000);
+		const __m128i mask = _mm_set1_epi32((int)dwMask);
+		__m128i flags = zero;
+		int i = 0;
+		for( ; i + 4 <= nPixels; i += 4 ) {
+			__m128i px = _mm_loadu_si128((const __m128i*)(pRGBA + i * 4));
+			__m128i lo = _mm_unpacklo_epi8(px, zero);
+			__m128i hi = _mm_unpackhi_epi8(px, zero);
+			lo = _mm_mullo_epi16(lo, _mm_shufflehi_epi16(_mm_shufflelo_epi16(lo, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3)));
+			hi = _mm_mullo_epi16(hi, _mm_shufflehi_epi16(_mm_shufflelo_epi16(hi, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3)));
+			lo = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(lo, one), _mm_srli_epi16(lo, 8)), 8);
+			hi = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(hi, one), _mm_srli_epi16(hi, 8)), 8);
+			lo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(lo, _MM_SHUFFLE(3, 0, 1, 2)), _MM_SHUFFLE(3, 0, 1, 2));
+			hi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(hi, _MM_SHUFFLE(3, 0, 1, 2)), _MM_SHUFFLE(3, 0, 1, 2));
+			__m128i a = _mm_and_si128(px, alpha);
+			__m128i dw = _mm_or_si128(_mm_andnot_si128(alpha, _mm_packus_epi16(lo, hi)), a);
+			__m128i masked = _mm_cmpeq_epi32(dw, mask);
+			flags = _mm_or_si128(flags, _mm_or_si128(masked, _mm_andnot_si128(_mm_cmpeq_epi32(a, alpha), alpha)));
+			_mm_storeu_si128((__m128i*)(pDest + i), _mm_andnot_si128(masked, dw));
+		}
+		bool bAlpha = _mm_movemask_epi8(flags) != 0;
+		if( PremultiplyC(pDest + i, pRGBA + i * 4, nPixels - i, dwMask) ) bAlpha = true;
+		return bAlpha;
+	}
+
+	static void UnpremultiplySSE2(DWORD* pBits, int nPixels)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i low = _mm_set1_epi32(0xFF);
+		const __m128 c255 = _mm_set1_ps(255.0f);
+		int i = 0;
+		for( ; i + 4 <= nPixels; i += 4 ) {
+			__m128i px = _mm_loadu_si128((const __m128i*)(pBits + i));
+			__m128i a = _mm_srli_epi32(px, 24);
+			__m128 fa = _mm_cvtepi32_ps(a);
+			__m128i half = _mm_srli_epi32(a, 1);
+			__m128i dw = _mm_slli_epi32(a, 24);
+			for( int nShift = 0; nShift < 24; nShift += 8 ) {
+				__m128i c = _mm_and_si128(_mm_srli_epi32(px, nShift), low);
+				__m128i x = _mm_add_epi32(_mm_sub_epi32(_mm_slli_epi32(c, 8), c), half);
+				__m128 q = _mm_min_ps(_mm_div_ps(_mm_cvtepi32_ps(x), fa), c255);
+				dw = _mm_or_si128(dw, _mm_slli_epi32(_mm_cvttps_epi32(q), nShift));
+			}
+			dw = _mm_andnot_si128(_mm_cmpeq_epi32(a, zero), dw);
+			_mm_storeu_si128((__m128i*)(pBits + i), dw);
+		}
+		UnpremultiplyC(pBits + i, nPixels - i);
+	}
+
+	static void FillSSE2(DWORD* pBits, int nPixels, DWORD dwColor)
+	{
+		const __m128i color = _mm_set1_epi32((int)dwColor);
+		int i = 0;
+		for( ; i + 4 <= nPixels; i += 4 ) _mm_storeu_si128((__m128i*)(pBits + i), color);
+		FillC(pBits + i, nPixels - i, dwColor);
+	}
+
+	static void RestoreAlphaSSE2(DWORD* pBits, int nPixels)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i alpha = _mm_set1_epi32((int)0xFF000000);
+		int i = 0;
+		for( ; i + 4 <= nPixels; i += 4 ) {
+			__m128i px = _mm_loadu_si128((const __m128i*)(pBits + i));
+			__m128i clear = _mm_cmpeq_epi32(_mm_and_si128(px, alpha), zero);
+			__m128i black = _mm_cmpeq_epi32(_mm_andnot_si128(alpha, px), zero);
+			px = _mm_or_si128(px, _mm_and_si128(_mm_andnot_si128(black, clear), alpha));
+			_mm_storeu_si128((__m128i*)(pBits + i), px);
+		}
+		RestoreAlphaC(pBits + i, nPixels - i);
+	}
+
+	static void MakeOpaqueSSE2(DWORD* pBits, int nPixels)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i alpha = _mm_set1_epi32((int)0xFF000000);
+		int i = 0;
+		for( ; i + 4 <= nPixels; i += 4 ) {
+			__m128i px = _mm_loadu_si128((const __m128i*)(pBits + i));
+			px = _mm_or_si128(px, _mm_andnot_si128(_mm_cmpeq_epi32(px, zero), alpha));
+			_mm_storeu_si128((__m128i*)(pBits + i), px);
+		}
+		MakeOpaqueC(pBits + i, nPixels - i);
+	}
+
+	// Resampling multiplies two taps at a time with madd: the channels of both go in as
+	// interleaved 16-bit lanes next to their two weights, and come out as four 32-bit sums.
+
+	static __m128i ResampleRound(__m128i sum)
+	{
+		return _mm_srai_epi32(_mm_add_epi32(sum, _mm_set1_epi32(RESAMPLE_ROUND)), RESAMPLE_SHIFT);
+	}
+
+	static void ResampleRowSSE2(DWORD* pDest, int cxDest, const DWORD* pSrc, const int* pStart, const short* pWeights, int nTaps)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		for( int x = 0; x < cxDest; x++ ) {
+			const DWORD* p = pSrc + pStart[x];
+			const short* w = pWeights + x * nTaps;
+			__m128i sum = zero;
+			int k = 0;
+			for( ; k + 2 <= nTaps; k += 2 ) {
+				__m128i px = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(p + k)), zero);
+				px = _mm_unpacklo_epi16(px, _mm_srli_si128(px, 8));
+				__m128i wt = _mm_set1_epi32((int)(((DWORD)(WORD)w[k + 1] << 16) | (WORD)w[k]));
+				sum = _mm_add_epi32(sum, _mm_madd_epi16(px, wt));
+			}
+			if( k < nTaps ) {
+				__m128i px = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128((int)p[k]), zero), zero);
+				sum = _mm_add_epi32(sum, _mm_madd_epi16(px, _mm_set1_epi32((WORD)w[k])));
+			}
+			sum = ResampleRound(sum);
+			sum = _mm_packus_epi16(_mm_packs_epi32(sum, sum), zero);
+			pDest[x] = (DWORD)_mm_cvtsi128_si32(sum);
+		}
+	}
+
+	static void ResampleColumnSSE2(DWORD* pDest, int nPixels, const DWORD* const* ppRows, const short* pWeights, int nTaps)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		int i = 0;
+		for( ; i + 4 <= nPixels; i += 4 ) {
+			__m128i sum0 = zero, sum1 = zero, sum2 = zero, sum3 = zero;
+			for( int k = 0; k < nTaps; k += 2 ) {
+				__m128i a = _mm_loadu_si128((const __m128i*)(ppRows[k] + i));
+				__m128i b = zero;
+				DWORD wt = (WORD)pWeights[k];
+				if( k + 1 < nTaps ) {
+					b = _mm_loadu_si128((const __m128i*)(ppRows[k + 1] + i));
+					wt |= (DWORD)(WORD)pWeights[k + 1] << 16;
+				}
+				const __m128i w = _mm_set1_epi32((int)wt);
+				__m128i alo = _mm_unpacklo_epi8(a, zero), ahi = _mm_unpackhi_epi8(a, zero);
+				__m128i blo = _mm_unpacklo_epi8(b, zero), bhi = _mm_unpackhi_epi8(b, zero);
+				sum0 = _mm_add_epi32(sum0, _mm_madd_epi16(_mm_unpacklo_epi16(alo, blo), w));
+				sum1 = _mm_add_epi32(sum1, _mm_madd_epi16(_mm_unpackhi_epi16(alo, blo), w));
+				sum2 = _mm_add_epi32(sum2, _mm_madd_epi16(_mm_unpacklo_epi16(ahi, bhi), w));
+				sum3 = _mm_add_epi32(sum3, _mm_madd_epi16(_mm_unpackhi_epi16(ahi, bhi), w));
+			}
+			__m128i lo = _mm_packs_epi32(ResampleRound(sum0), ResampleRound(sum1));
+			__m128i hi = _mm_packs_epi32(ResampleRound(sum2), ResampleRound(sum3));
+			_mm_storeu_si128((__m128i*)(pDest + i), _mm_packus_epi16(lo, hi));
+		}
+		ResampleColumnSpanC(pDest, i, nPixels, ppRows, pWeights, nTaps);
+	}
+
+	// a register of pixels whose colours are all in the table is served from it; otherwise all
+	// of them are converted and go into it
+	static bool AdjustHSLFromMemo(DWORD* pDest, const DWORD* pSrc, int nPixels, const THSLMemo* pMemo, DWORD* pSlots)
+	{
+		bool bHit = true;
+		for( int j = 0; j < nPixels; j++ ) {
+			DWORD dwColor = pSrc[j] & 0x00FFFFFF;
+			pSlots[j] = HSL_MEMO_SLOT(dwColor);
+			if( pMemo->dwColor[pSlots[j]] != dwColor ) bHit = false;
+		}
+		if( !bHit ) return false;
+		for( int j = 0; j < nPixels; j++ ) pDest[j] = (pSrc[j] & 0xFF000000) | pMemo->dwResult[pSlots[j]];
+		return true;
+	}
+
+	static void AdjustHSLToMemo(const DWORD* pDest, const DWORD* pSrc, int nPixels, THSLMemo* pMemo, const DWORD* pSlots)
+	{
+		for( int j = 0; j < nPixels; j++ ) {
+			pMemo->dwColor[pSlots[j]] = pSrc[j] & 0x00FFFFFF;
+			pMemo->dwResult[pSlots[j]] = pDest[j] & 0x00FFFFFF;
+		}
+	}
+
+	// HSLtoRGB works the three channels out of the hue plus a third, the hue and the hue less
+	// a third; each branch of it becomes a select
+	static inline __m128 HSLSelect(__m128 mask, __m128 a, __m128 b)
+	{
+		return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+	}
+
+	static inline __m128i HSLToChannel(__m128 t, __m128 p, __m128 q)
+	{
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 one = _mm_set1_ps(1.0f);
+		const __m128 c255 = _mm_set1_ps(255.0f);
+		__m128 nt = HSLSelect(_mm_cmplt_ps(t, zero), _mm_add_ps(t, one), HSLSelect(_mm_cmpgt_ps(t, one), _mm_sub_ps(t, one), t));
+		__m128 qp6 = _mm_mul_ps(_mm_sub_ps(q, p), _mm_set1_ps(6.0f));
+		__m128 v = HSLSelect(_mm_cmplt_ps(_mm_mul_ps(_mm_set1_ps(3.0f), nt), _mm_set1_ps(2.0f)),
+			_mm_add_ps(p, _mm_mul_ps(qp6, _mm_sub_ps(_mm_set1_ps(2.0f*OneThird), nt))), p);
+		v = HSLSelect(_mm_cmplt_ps(_mm_mul_ps(_mm_set1_ps(2.0f), nt), one), q, v);
+		v = HSLSelect(_mm_cmplt_ps(_mm_mul_ps(_mm_set1_ps(6.0f), nt), one), _mm_add_ps(p, _mm_mul_ps(qp6, nt)), v);
+		v = _mm_mul_ps(c255, v);
+		v = HSLSelect(_mm_cmplt_ps(v, zero), zero, HSLSelect(_mm_cmpgt_ps(v, c255), c255, v));
+		return _mm_cvttps_epi32(v);
+	}
+
+	static void AdjustHSL4SSE2(DWORD* pDest, const DWORD* pSrc, const THSLAdjust& adj)
+	{
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 one = _mm_set1_ps(1.0f);
+		const __m128 two = _mm_set1_ps(2.0f);
+		const __m128 six = _mm_set1_ps(6.0f);
+		const __m128 c255 = _mm_set1_ps(255.0f);
+		const __m128i low = _mm_set1_epi32(0xFF);
+		__m128i px = _mm_loadu_si128((const __m128i*)pSrc);
+
+		// RGBtoHSL
+		__m128 nR = _mm_div_ps(_mm_cvtepi32_ps(_mm_and_si128(px, low)), c255);
+		__m128 nG = _mm_div_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(px, 8), low)), c255);
+		__m128 nB = _mm_div_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(px, 16), low)), c255);
+		__m128 m = _mm_min_ps(_mm_min_ps(nR, nG), nB);
+		__m128 M = _mm_max_ps(_mm_max_ps(nR, nG), nB);
+		__m128 L = _mm_div_ps(_mm_add_ps(m, M), two);
+		__m128 d = _mm_sub_ps(M, m);
+		__m128 rIsMin = _mm_cmpeq_ps(nR, m);
+		__m128 gIsMin = _mm_cmpeq_ps(nG, m);
+		__m128 f = HSLSelect(rIsMin, _mm_sub_ps(nG, nB), HSLSelect(gIsMin, _mm_sub_ps(nB, nR), _mm_sub_ps(nR, nG)));
+		__m128 i = HSLSelect(rIsMin, _mm_set1_ps(3.0f), HSLSelect(gIsMin, _mm_set1_ps(5.0f), one));
+		__m128 H = _mm_sub_ps(i, _mm_div_ps(f, d));
+		H = HSLSelect(_mm_cmpge_ps(H, six), _mm_sub_ps(H, six), H);
+		H = _mm_mul_ps(H, _mm_set1_ps(60.0f));
+		__m128 S = HSLSelect(_mm_cmple_ps(_mm_mul_ps(two, L), one), _mm_div_ps(d, _mm_add_ps(M, m)), _mm_div_ps(d, _mm_sub_ps(_mm_sub_ps(two, M), m)));
+		__m128 grey = _mm_cmpeq_ps(M, m);
+		H = _mm_andnot_ps(grey, H);
+		S = _mm_andnot_ps(grey, S);
+
+		// the adjustment
+		H = _mm_add_ps(H, _mm_set1_ps(adj.fH));
+		H = HSLSelect(_mm_cmpgt_ps(H, zero), H, _mm_add_ps(H, _mm_set1_ps(360.0f)));
+		S = _mm_mul_ps(S, _mm_set1_ps(adj.fS));
+		L = _mm_mul_ps(L, _mm_set1_ps(adj.fL));
+
+		// HSLtoRGB
+		__m128 L2 = _mm_mul_ps(two, L);
+		__m128 q = HSLSelect(_mm_cmplt_ps(L2, one), _mm_mul_ps(L, _mm_add_ps(one, S)), _mm_sub_ps(_mm_add_ps(L, S), _mm_mul_ps(L, S)));
+		__m128 p = _mm_sub_ps(L2, q);
+		__m128 h = _mm_div_ps(H, _mm_set1_ps(360.0f));
+		__m128i b = HSLToChannel(_mm_add_ps(h, _mm_set1_ps(OneThird)), p, q);
+		__m128i g = HSLToChannel(h, p, q);
+		__m128i r = HSLToChannel(_mm_sub_ps(h, _mm_set1_ps(OneThird)), p, q);
+		__m128i out = _mm_and_si128(px, _mm_set1_epi32((int)0xFF000000));
+		out = _mm_or_si128(out, _mm_and_si128(r, low));
+		out = _mm_or_si128(out, _mm_slli_epi32(_mm_and_si128(g, low), 8));
+		out = _mm_or_si128(out, _mm_slli_epi32(_mm_and_si128(b, low), 16));
+		_mm_storeu_si128((__m128i*)pDest, out);
+	}
+
+	static void AdjustHSLSSE2(DWORD* pDest, const DWORD* pSrc, int nPixels, const THSLAdjust& adj, THSLMemo* pMemo)
+	{
+		int i = 0;
+		for( ; i + 4 <= nPixels; i += 4 ) {
+			DWORD dwSlots[4];
+			if( AdjustHSLFromMemo(pDest + i, pSrc + i, 4, pMemo, dwSlots) ) continue;
+			AdjustHSL4SSE2(pDest + i, pSrc + i, adj);
+			AdjustHSLToMemo(pDest + i, pSrc + i, 4, pMemo, dwSlots);
+		}
+		AdjustHSLC(pDest + i, pSrc + i, nPixels - i, adj, pMemo);
+	}
+
+	PIXEL_KERNEL_AVX2 static bool PremultiplyAVX2(DWORD* pDest, const BYTE* pRGBA, int nPixels, DWORD dwMask)
+	{
+		const __m256i zero = _mm256_setzero_si256();
+		const __m256i one = _mm256_set1_epi16(1);
+		const __m256i alpha = _mm256_set1_epi32((int)0xFF000000);
+		const __m256i mask = _mm256_set1_epi32((int)dwMask);
+		__m256i flags = zero;
+		int i = 0;
+		for( ; i + 8 <= nPixels; i += 8 ) {
+			__m256i px = _mm256_loadu_si256((const __m256i*)(pRGBA + i * 4));
+			__m256i lo = _mm256_unpacklo_epi8(px, zero);
+			__m256i hi = _mm256_unpackhi_epi8(px, zero);
+			lo = _mm256_mullo_epi16(lo, _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(lo, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3)));
+			hi = _mm256_mullo_epi16(hi, _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(hi, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3)));
+			lo = _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(lo, one), _mm256_srli_epi16(lo, 8)), 8);
+			hi = _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(hi, one), _mm256_srli_epi16(hi, 8)), 8);
+			lo = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(lo, _MM_SHUFFLE(3, 0, 1, 2)), _MM_SHUFFLE(3, 0, 1, 2));
+			hi = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(hi, _MM_SHUFFLE(3, 0, 1, 2)), _MM_SHUFFLE(3, 0, 1, 2));
+			__m256i a = _mm256_and_si256(px, alpha);
+			__m256i dw = _mm256_or_si256(_mm256_andnot_si256(alpha, _mm256_packus_epi16(lo, hi)), a);
+			__m256i masked = _mm256_cmpeq_epi32(dw, mask);
+			flags = _mm256_or_si256(flags, _mm256_or_si256(masked, _mm256_andnot_si256(_mm256_cmpeq_epi32(a, alpha), alpha)));
+			_mm256_storeu_si256((__m256i*)(pDest + i), _mm256_andnot_si256(masked, dw));
+		}
+		bool bAlpha = _mm256_movemask_epi8(flags) != 0;
+		if( PremultiplyC(pDest + i, pRGBA + i * 4, nPixels - i, dwMask) ) bAlpha = true;
+		return bAlpha;
+	}
+
+	PIXEL_KERNEL_AVX2 static void UnpremultiplyAVX2(DWORD* pBits, int nPixels)
+	{
+		const __m256i zero = _mm256_setzero_si256();
+		const __m256i low = _mm256_set1_epi32(0xFF);
+		const __m256 c255 = _mm256_set1_ps(255.0f);
+		int i = 0;
+		for( ; i + 8 <= nPixels; i += 8 ) {
+			__m256i px = _mm256_loadu_si256((const __m256i*)(pBits + i));
+			__m256i a = _mm256_srli_epi32(px, 24);
+			__m256 fa = _mm256_cvtepi32_ps(a);
+			__m256i half = _mm256_srli_epi32(a, 1);
+			__m256i dw = _mm256_slli_epi32(a, 24);
+			for( int nShift = 0; nShift < 24; nShift += 8 ) {
+				__m256i c = _mm256_and_si256(_mm256_srli_epi32(px, nShift), low);
+				__m256i x = _mm256_add_epi32(_mm256_sub_epi32(_mm256_slli_epi32(c, 8), c), half);
+				__m256 q = _mm256_min_ps(_mm256_div_ps(_mm256_cvtepi32_ps(x), fa), c255);
+				dw = _mm256_or_si256(dw, _mm256_slli_epi32(_mm256_cvttps_epi32(q), nShift));
+			}
+			dw = _mm256_andnot_si256(_mm256_cmpeq_epi32(a, zero), dw);
+			_mm256_storeu_si256((__m256i*)(pBits + i), dw);
+		}
+		UnpremultiplyC(pBits + i, nPixels - i);
+	}
+
+	PIXEL_KERNEL_AVX2 static void FillAVX2(DWORD* pBits, int nPixels, DWORD dwColor)
+	{
+		const __m256i color = _mm256_set1_epi32((int)dwColor);
+		int i = 0;
+		for( ; i + 8 <= nPixels; i += 8 ) _mm256_storeu_si256((__m256i*)(pBits + i), color);
+		FillC(pBits + i, nPixels - i, dwColor);
+	}
+
+	PIXEL_KERNEL_AVX2 static void RestoreAlphaAVX2(DWORD* pBits, int nPixels)
+	{
+		const __m256i zero = _mm256_setzero_si256();
+		const __m256i alpha = _mm256_set1_epi32((int)0xFF000000);
+		int i = 0;
+		for( ; i + 8 <= nPixels; i += 8 ) {
+			__m256i px = _mm256_loadu_si256((const __m256i*)(pBits + i));
+			__m256i clear = _mm256_cmpeq_epi32(_mm256_and_si256(px, alpha), zero);
+			__m256i black = _mm256_cmpeq_epi32(_mm256_andnot_si256(alpha, px), zero);
+			px = _mm256_or_si256(px, _mm256_and_si256(_mm256_andnot_si256(black, clear), alpha));
+			_mm256_storeu_si256((__m256i*)(pBits + i), px);
+		}
+		RestoreAlphaC(pBits + i, nPixels - i);
+	}
+
+	PIXEL_KERNEL_AVX2 static void MakeOpaqueAVX2(DWORD* pBits, int nPixels)
+	{
+		const __m256i zero = _mm256_setzero_si256();
+		const __m256i alpha = _mm256_set1_epi32((int)0xFF000000);
+		int i = 0;
+		for( ; i + 8 <= nPixels; i += 8 ) {
+			__m256i px = _mm256_loadu_si256((const __m256i*)(pBits + i));
+			px = _mm256_or_si256(px, _mm256_andnot_si256(_mm256_cmpeq_epi32(px, zero), alpha));
+			_mm256_storeu_si256((__m256i*)(pBits + i), px);
+		}
+		MakeOpaqueC(pBits + i, nPixels - i);
+	}
+
+	// unpacking and packing both stay within each 128-bit half, so the pixels come back in order
+	PIXEL_KERNEL_AVX2 static void ResampleColumnAVX2(DWORD* pDest, int nPixels, const DWORD* const* ppRows, const short* pWeights, int nTaps)
+	{
+		const __m256i zero = _mm256_setzero_si256();
+		const __m256i round = _mm256_set1_epi32(RESAMPLE_ROUND);
+		int i = 0;
+		for( ; i + 8 <= nPixels; i += 8 ) {
+			__m256i sum0 = zero, sum1 = zero, sum2 = zero, sum3 = zero;
+			for( int k = 0; k < nTaps; k += 2 ) {
+				__m256i a = _mm256_loadu_si256((const __m256i*)(ppRows[k] + i));
+				__m256i b = zero;
+				DWORD wt = (WORD)pWeights[k];
+				if( k + 1 < nTaps ) {
+					b = _mm256_loadu_si256((const __m256i*)(ppRows[k + 1] + i));
+					wt |= (DWORD)(WORD)pWeights[k + 1] << 16;
+				}
+				const __m256i w = _mm256_set1_epi32((int)wt);
+				__m256i alo = _mm256_unpacklo_epi8(a, zero), ahi = _mm256_unpackhi_epi8(a, zero);
+				__m256i blo = _mm256_unpacklo_epi8(b, zero), bhi = _mm256_unpackhi_epi8(b, zero);
+				sum0 = _mm256_add_epi32(sum0, _mm256_madd_epi16(_mm256_unpacklo_epi16(alo, blo), w));
+				sum1 = _mm256_add_epi32(sum1, _mm256_madd_epi16(_mm256_unpackhi_epi16(alo, blo), w));
+				sum2 = _mm256_add_epi32(sum2, _mm256_madd_epi16(_mm256_unpacklo_epi16(ahi, bhi), w));
+				sum3 = _mm256_add_epi32(sum3, _mm256_madd_epi16(_mm256_unpackhi_epi16(ahi, bhi), w));
+			}
+			sum0 = _mm256_srai_epi32(_mm256_add_epi32(sum0, round), RESAMPLE_SHIFT);
+			sum1 = _mm256_srai_epi32(_mm256_add_epi32(sum1, round), RESAMPLE_SHIFT);
+			sum2 = _mm256_srai_epi32(_mm256_add_epi32(sum2, round), RESAMPLE_SHIFT);
+			sum3 = _mm256_srai_epi32(_mm256_add_epi32(sum3, round), RESAMPLE_SHIFT);
+			__m256i px = _mm256_packus_epi16(_mm256_packs_epi32(sum0, sum1), _mm256_packs_epi32(sum2, sum3));
+			_mm256_storeu_si256((__m256i*)(pDest + i), px);
+		}
+		ResampleColumnSpanC(pDest, i, nPixels, ppRows, pWeights, nTaps);
+	}
+
+	// the compares are the ordered, quiet ones, which answer NaN lanes as SSE2's do; those
+	// are only ever grey pixels, whose hue and saturation are zeroed anyway
+	PIXEL_KERNEL_AVX2 static inline __m256i HSLToChannel8(__m256 t, __m256 p, __m256 q)
+	{
+		const __m256 zero = _mm256_setzero_ps();
+		const __m256 one = _mm256_set1_ps(1.0f);
+		const __m256 c255 = _mm256_set1_ps(255.0f);
+		__m256 nt = _mm256_blendv_ps(_mm256_blendv_ps(t, _mm256_sub_ps(t, one), _mm256_cmp_ps(t, one, _CMP_GT_OQ)), _mm256_add_ps(t, one), _mm256_cmp_ps(t, zero, _CMP_LT_OQ));
+		__m256 qp6 = _mm256_mul_ps(_mm256_sub_ps(q, p), _mm256_set1_ps(6.0f));
+		__m256 v = _mm256_blendv_ps(p, _mm256_add_ps(p, _mm256_mul_ps(qp6, _mm256_sub_ps(_mm256_set1_ps(2.0f*OneThird), nt))),
+			_mm256_cmp_ps(_mm256_mul_ps(_mm256_set1_ps(3.0f), nt), _mm256_set1_ps(2.0f), _CMP_LT_OQ));
+		v = _mm256_blendv_ps(v, q, _mm256_cmp_ps(_mm256_mul_ps(_mm256_set1_ps(2.0f), nt), one, _CMP_LT_OQ));
+		v = _mm256_blendv_ps(v, _mm256_add_ps(p, _mm256_mul_ps(qp6, nt)), _mm256_cmp_ps(_mm256_mul_ps(_mm256_set1_ps(6.0f), nt), one, _CMP_LT_OQ));
+		v = _mm256_mul_ps(c255, v);
+		v = _mm256_blendv_ps(_mm256_blendv_ps(v, c255, _mm256_cmp_ps(v, c255, _CMP_GT_OQ)), zero, _mm256_cmp_ps(v, zero, _CMP_LT_OQ));
+		return _mm256_cvttps_epi32(v);
+	}
+
+	PIXEL_KERNEL_AVX2 static void AdjustHSL8AVX2(DWORD* pDest, const DWORD* pSrc, const THSLAdjust& adj)
+	{
+		const __m256 zero = _mm256_setzero_ps();
+		const __m256 one = _mm256_set1_ps(1.0f);
+		const __m256 two = _mm256_set1_ps(2.0f);
+		const __m256 six = _mm256_set1_ps(6.0f);
+		const __m256 c255 = _mm256_set1_ps(255.0f);
+		const __m256i low = _mm256_set1_epi32(0xFF);
+		__m256i px = _mm256_loadu_si256((const __m256i*)pSrc);
+
+		// RGBtoHSL
+		__m256 nR = _mm256_div_ps(_mm256_cvtepi32_ps(_mm256_and_si256(px, low)), c255);
+		__m256 nG = _mm256_div_ps(_mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(px, 8), low)), c255);
+		__m256 nB = _mm256_div_ps(_mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(px, 16), low)), c255);
+		__m256 m = _mm256_min_ps(_mm256_min_ps(nR, nG), nB);
+		__m256 M = _mm256_max_ps(_mm256_max_ps(nR, nG), nB);
+		__m256 L = _mm256_div_ps(_mm256_add_ps(m, M), two);
+		__m256 d = _mm256_sub_ps(M, m);
+		__m256 rIsMin = _mm256_cmp_ps(nR, m, _CMP_EQ_OQ);
+		__m256 gIsMin = _mm256_cmp_ps(nG, m, _CMP_EQ_OQ);
+		__m256 f = _mm256_blendv_ps(_mm256_blendv_ps(_mm256_sub_ps(nR, nG), _mm256_sub_ps(nB, nR), gIsMin), _mm256_sub_ps(nG, nB), rIsMin);
+		__m256 i = _mm256_blendv_ps(_mm256_blendv_ps(one, _mm256_set1_ps(5.0f), gIsMin), _mm256_set1_ps(3.0f), rIsMin);
+		__m256 H = _mm256_sub_ps(i, _mm256_div_ps(f, d));
+		H = _mm256_blendv_ps(H, _mm256_sub_ps(H, six), _mm256_cmp_ps(H, six, _CMP_GE_OQ));
+		H = _mm256_mul_ps(H, _mm256_set1_ps(60.0f));
+		__m256 S = _mm256_blendv_ps(_mm256_div_ps(d, _mm256_sub_ps(_mm256_sub_ps(two, M), m)), _mm256_div_ps(d, _mm256_add_ps(M, m)),
+			_mm256_cmp_ps(_mm256_mul_ps(two, L), one, _CMP_LE_OQ));
+		__m256 grey = _mm256_cmp_ps(M, m, _CMP_EQ_OQ);
+		H = _mm256_andnot_ps(grey, H);
+		S = _mm256_andnot_ps(grey, S);
+
+		// the adjustment
+		H = _mm256_add_ps(H, _mm256_set1_ps(adj.fH));
+		H = _mm256_blendv_ps(_mm256_add_ps(H, _mm256_set1_ps(360.0f)), H, _mm256_cmp_ps(H, zero, _CMP_GT_OQ));
+		S = _mm256_mul_ps(S, _mm256_set1_ps(adj.fS));
+		L = _mm256_mul_ps(L, _mm256_set1_ps(adj.fL));
+
+		// HSLtoRGB
+		__m256 L2 = _mm256_mul_ps(two, L);
+		__m256 q = _mm256_blendv_ps(_mm256_sub_ps(_mm256_add_ps(L, S), _mm256_mul_ps(L, S)), _mm256_mul_ps(L, _mm256_add_ps(one, S)), _mm256_cmp_ps(L2, one, _CMP_LT_OQ));
+		__m256 p = _mm256_sub_ps(L2, q);
+		__m256 h = _mm256_div_ps(H, _mm256_set1_ps(360.0f));
+		__m256i b = HSLToChannel8(_mm256_add_ps(h, _mm256_set1_ps(OneThird)), p, q);
+		__m256i g = HSLToChannel8(h, p, q);
+		__m256i r = HSLToChannel8(_mm256_sub_ps(h, _mm256_set1_ps(OneThird)), p, q);
+		__m256i out = _mm256_and_si256(px, _mm256_set1_epi32((int)0xFF000000));
+		out = _mm256_or_si256(out, _mm256_and_si256(r, low));
+		out = _mm256_or_si256(out, _mm256_slli_epi32(_mm256_and_si256(g, low), 8));
+		out = _mm256_or_si256(out, _mm256_slli_epi32(_mm256_and_si256(b, low), 16));
+		_mm256_storeu_si256((__m256i*)pDest, out);
+	}
+
+	PIXEL_KERNEL_AVX2 static void AdjustHSLAVX2(DWORD* pDest, const DWORD* pSrc, int nPixels, const THSLAdjust& adj, THSLMemo* pMemo)
+	{
+		int i = 0;
+		for( ; i + 8 <= nPixels; i += 8 ) {
+			DWORD dwSlots[8];
+			if( AdjustHSLFromMemo(pDest + i, pSrc + i, 8, pMemo, dwSlots) ) continue;
+			AdjustHSL8AVX2(pDest + i, pSrc + i, adj);
+			AdjustHSLToMemo(pDest + i, pSrc + i, 8, pMemo, dwSlots);
+		}
+		AdjustHSLC(pDest + i, pSrc + i, nPixels - i, adj, pMemo);
+	}
+
+	static bool HasAVX2()
+	{
+#ifdef _MSC_VER
+		int info[4] = { 0 };
+		__cpuid(info, 0);
+		if( info[0] < 7 ) return false;
+		__cpuid(info, 1);
+		// the CPU has AVX and the OS saves the YMM registers
+		if( (info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0 ) return false;
+		if( (_xgetbv(0) & 6) != 6 ) return false;
+		__cpuidex(info, 7, 0);
+		return (info[1] & (1 << 5)) != 0;
+#else
+		return __builtin_cpu_supports("avx2") != 0;
+#endif
+	}
+#endif
+
+	/////////////////////////////////////////////////////////////////////////////////////
+	//
+	//
+
+	typedef struct tagTPixelKernels
+	{
+		LPCTSTR pstrName;
+		bool (*pfnPremultiply)(DWORD* pDest, const BYTE* pRGBA, int nPixels, DWORD dwMask);
+		void (*pfnUnpremultiply)(DWORD* pBits, int nPixels);
+		void (*pfnFill)(DWORD* pBits, int nPixels, DWORD dwColor);
+		void (*pfnRestoreAlpha)(DWORD* pBits, int nPixels);
+		void (*pfnMakeOpaque)(DWORD* pBits, int nPixels);
+		void (*pfnResampleRow)(DWORD* pDest, int cxDest, const DWORD* pSrc, const int* pStart, const short* pWeights, int nTaps);
+		void (*pfnResampleColumn)(DWORD* pDest, int nPixels, const DWORD* const* ppRows, const short* pWeights, int nTaps);
+		void (*pfnAdjustHSL)(DWORD* pDest, const DWORD* pSrc, int nPixels, const THSLAdjust& adj, THSLMemo* pMemo);
+	} TPixelKernels;
+
+	static const TPixelKernels* SelectPixelKernels()
+	{
+#ifdef PIXEL_KERNEL_SIMD
+		// a row is one pixel at a time whatever the width, so AVX2 has nothing to add to it
+		static const TPixelKernels sse2 = { _T("SSE2"), PremultiplySSE2, UnpremultiplySSE2, FillSSE2, RestoreAlphaSSE2, MakeOpaqueSSE2,
+			ResampleRowSSE2, ResampleColumnSSE2, AdjustHSLSSE2 };
+		static const TPixelKernels avx2 = { _T("AVX2"), PremultiplyAVX2, UnpremultiplyAVX2, FillAVX2, RestoreAlphaAVX2, MakeOpaqueAVX2,
+			ResampleRowSSE2, ResampleColumnAVX2, AdjustHSLAVX2 };
+		return HasAVX2() ? &avx2 : &sse2;
+#else
+		static const TPixelKernels c = { _T("C"), PremultiplyC, UnpremultiplyC, FillC, RestoreAlphaC, MakeOpaqueC,
+			ResampleRowC, ResampleColumnC, AdjustHSLC };
+		return &c;
+#endif
+	}
+
+	static const TPixelKernels* GetPixelKernels()
+	{
+		static const TPixelKernels* pKernels = SelectPixelKernels();
+		return pKernels;
+	}
+
+	bool CPixelKernel::Premultiply(DWORD* pDest, const BYTE* pRGBA, int nPixels, DWORD dwMask)
+	{
+		return GetPixelKernels()->pfnPremultiply(pDest, pRGBA, nPixels, dwMask);
+	}
+
+	void CPixelKernel::Unpremultiply(DWORD* pBits, int nPixels)
+	{
+		GetPixelKernels()->pfnUnpremultiply(pBits, nPixels);
+	}
+
+	void CPixelKernel::Fill(DWORD* pBits, int nPixels, DWORD dwColor)
+	{
+		GetPixelKernels()->pfnFill(pBits, nPixels, dwColor);
+	}
+
+	void CPixelKernel::FillRect(DWORD* pBits, int nStride, const RECT& rc, DWORD dwColor)
+	{
+		if( rc.right <= rc.left ) return;
+		const TPixelKernels* pKernels = GetPixelKernels();
+		for( LONG y = rc.top; y < rc.bottom; y++ ) pKernels->pfnFill(pBits + y * nStride + rc.left, rc.right - rc.left, dwColor);
+	}
+
+	void CPixelKernel::RestoreAlpha(DWORD* pBits, int nStride, const RECT& rc)
+	{
+		if( rc.right <= rc.left ) return;
+		const TPixelKernels* pKernels = GetPixelKernels();
+		for( LONG y = rc.top; y < rc.bottom; y++ ) pKernels->pfnRestoreAlpha(pBits + y * nStride + rc.left, rc.right - rc.left);
+	}
+
+	void CPixelKernel::MakeOpaque(DWORD* pBits, int nPixels)
+	{
+		GetPixelKernels()->pfnMakeOpaque(pBits, nPixels);
+	}
+
+	// For each of nDest pixels, where its nTaps weights start among the nSrc: the filter is
+	// centred on the destination pixel's middle, clamped at the edges by giving the taps past
+	// them to the edge pixel, and every window is shifted inside the source so all have nTaps.
+	static int MakeResampleTaps(int nSrc, int nDest, std::vector<int>& aStart, std::vector<short>& aWeights)
+	{
+		double fScale = (double)nSrc / nDest;
+		double fRadius = fScale > 1.0 ? fScale : 1.0;
+		int nTaps = (int)ceil(fRadius * 2) + 1;
+		if( nTaps > nSrc ) nTaps = nSrc;
+		aStart.resize(nDest);
+		aWeights.assign(nDest * nTaps, 0);
+		std::vector<double> aTap(nTaps);
+		for( int x = 0; x < nDest; x++ ) {
+			double fCenter = (x + 0.5) * fScale - 0.5;
+			int iLeft = (int)ceil(fCenter - fRadius);
+			int iRight = (int)floor(fCenter + fRadius);
+			int iFirst = iLeft < 0 ? 0 : iLeft;
+			int iLast = iRight > nSrc - 1 ? nSrc - 1 : iRight;
+			int iStart = iFirst < nSrc - nTaps ? iFirst : nSrc - nTaps;
+			aStart[x] = iStart;
+			for( int k = 0; k < nTaps; k++ ) aTap[k] = 0.0;
+			double fTotal = 0.0;
+			for( int i = iLeft; i <= iRight; i++ ) {
+				double fWeight = 1.0 - fabs(i - fCenter) / fRadius;
+				if( fWeight <= 0.0 ) continue;
+				int iTap = (i < iFirst ? iFirst : i > iLast ? iLast : i) - iStart;
+				aTap[iTap] += fWeight;
+				fTotal += fWeight;
+			}
+			// rounding each weight may leave the sum a little off; the biggest takes the difference
+			short* pWeights = &aWeights[x * nTaps];
+			int nSum = 0, iBiggest = 0;
+			for( int k = 0; k < nTaps; k++ ) {
+				pWeights[k] = (short)floor(aTap[k] / fTotal * (1 << RESAMPLE_SHIFT) + 0.5);
+				nSum += pWeights[k];
+				if( pWeights[k] > pWeights[iBiggest] ) iBiggest = k;
+			}
+			pWeights[iBiggest] += (short)((1 << RESAMPLE_SHIFT) - nSum);
+		}
+		return nTaps;
+	}
+
+	void CPixelKernel::Resample(DWORD* pDest, int cxDest, int cyDest, const DWORD* pSrc, int cxSrc, int cySrc)
+	{
+		if( cxDest <= 0 || cyDest <= 0 || cxSrc <= 0 || cySrc <= 0 ) return;
+		const TPixelKernels* pKernels = GetPixelKernels();
+		std::vector<int> aStart;
+		std::vector<short> aWeights;
+		// across first, into cxDest x cySrc
+		int nTaps = MakeResampleTaps(cxSrc, cxDest, aStart, aWeights);
+		std::vector<DWORD> aRows(cxDest * cySrc);
+		for( int y = 0; y < cySrc; y++ ) {
+			pKernels->pfnResampleRow(&aRows[y * cxDest], cxDest, pSrc + y * cxSrc, &aStart[0], &aWeights[0], nTaps);
+		}
+		// then down
+		nTaps = MakeResampleTaps(cySrc, cyDest, aStart, aWeights);
+		std::vector<const DWORD*> aTapRows(nTaps);
+		for( int y = 0; y < cyDest; y++ ) {
+			for( int k = 0; k < nTaps; k++ ) aTapRows[k] = &aRows[(aStart[y] + k) * cxDest];
+			pKernels->pfnResampleColumn(pDest + y * cxDest, cxDest, &aTapRows[0], &aWeights[y * nTaps], nTaps);
+		}
+	}
+
+	static THSLAdjust MakeHSLAdjust(short H, short S, short L)
+	{
+		THSLAdjust adj;
+		adj.fH = (float)(H - 180);
+		adj.fS = S / 100.0f;
+		adj.fL = L / 100.0f;
+		return adj;
+	}
+
+	void CPixelKernel::AdjustHSL(DWORD* pDest, const DWORD* pSrc, int nPixels, short H, short S, short L)
+	{
+		if( nPixels <= 0 ) return;
+		THSLMemo* pMemo = new THSLMemo;
+		// no colour has the top byte set, so every slot starts empty
+		memset(pMemo->dwColor, 0xFF, sizeof(pMemo->dwColor));
+		GetPixelKernels()->pfnAdjustHSL(pDest, pSrc, nPixels, MakeHSLAdjust(H, S, L), pMemo);
+		delete pMemo;
+	}
+
+	DWORD CPixelKernel::AdjustHSL(DWORD dwColor, short H, short S, short L)
+	{
+		return AdjustPixelHSL(dwColor, MakeHSLAdjust(H, S, L));
+	}
+
+	LPCTSTR CPixelKernel::GetInstructionSet()
+	{
+		return GetPixelKernels()->pstrName;
+	}
+
+} // namespace DuiLib
@@ -0,0 +1,42 @@
+#ifndef __UIPIXEL_H__
+#define __UIPIXEL_H__
+
+#pragma once
+
+namespace DuiLib {
+	/////////////////////////////////////////////////////////////////////////////////////
+	//
+	// Loops over 32-bit BGRA pixels, as CreateDIBSection gives them, that run on every paint
+	// of a layered window, on every image load or on every image when the skin's HSL changes.
+	// Each picks the widest instruction set the CPU has the first time any of them is called,
+	// and all of them give the same pixels.
+
+	class UILIB_API CPixelKernel
+	{
+	public:
+		// stb_image RGBA to the premultiplied BGRA LoadImage keeps, with pixels equal to dwMask
+		// made transparent. Returns true if any pixel came out less than opaque.
+		static bool Premultiply(DWORD* pDest, const BYTE* pRGBA, int nPixels, DWORD dwMask);
+		// back to straight alpha, rounding to nearest; fully transparent pixels become 0
+		static void Unpremultiply(DWORD* pBits, int nPixels);
+		static void Fill(DWORD* pBits, int nPixels, DWORD dwColor);
+		static void FillRect(DWORD* pBits, int nStride, const RECT& rc, DWORD dwColor);
+		// GDI draws with alpha 0; anything drawn in rc that isn't black gets alpha 255
+		static void RestoreAlpha(DWORD* pBits, int nStride, const RECT& rc);
+		// every pixel that isn't 0 gets alpha 255
+		static void MakeOpaque(DWORD* pBits, int nPixels);
+		// premultiplied BGRA scaled to cxDest x cyDest through a tent filter a source pixel wide
+		// when enlarging and a destination pixel wide when shrinking, so every source pixel
+		// counts; both bitmaps run the same way up, rows packed
+		static void Resample(DWORD* pDest, int cxDest, int cyDest, const DWORD* pSrc, int cxSrc, int cySrc);
+		// the colours turned H - 180 degrees round the hue circle and scaled to S and L percent of
+		// their saturation and lightness, alpha left alone: SetHSL's adjustment of an image, and
+		// of one colour the way CRenderEngine::AdjustColor makes it
+		static void AdjustHSL(DWORD* pDest, const DWORD* pSrc, int nPixels, short H, short S, short L);
+		static DWORD AdjustHSL(DWORD dwColor, short H, short S, short L);
+		static LPCTSTR GetInstructionSet();
+	};
+
+} // namespace DuiLib
+
+#endif // __UIPIXEL_H__
@@ -1,4 +1,7 @@
 #include "StdAfx.h"
+#include <thread>
+#include <atomic>
+#include <vector>
 
 #define STB_IMAGE_IMPLEMENTATION
 #include "..\Utils\stb_image.h"
@@ -73,49 +76,6 @@ namespace DuiLib {
 	//
 	//
 
-	static const float OneThird = 1.0f / 3;
-
-	static void RGBtoHSL(DWORD ARGB, float* H, float* S, float* L) {
-		const float
-			R = (float)GetRValue(ARGB),
-			G = (float)GetGValue(ARGB),
-			B = (float)GetBValue(ARGB),
-			nR = (R<0?0:(R>255?255:R))/255,
-			nG = (G<0?0:(G>255?255:G))/255,
-			nB = (B<0?0:(B>255?255:B))/255,
-			m = min(min(nR,nG),nB),
-			M = max(max(nR,nG),nB);
-		*L = (m + M)/2;
-		if (M==m) *H = *S = 0;
-		else {
-			const float
-				f = (nR==m)?(nG-nB):((nG==m)?(nB-nR):(nR-nG)),
-				i = (nR==m)?3.0f:((nG==m)?5.0f:1.0f);
-			*H = (i-f/(M-m));
-			if (*H>=6) *H-=6;
-			*H*=60;
-			*S = (2*(*L)<=1)?((M-m)/(M+m)):((M-m)/(2-M-m));
-		}
-	}
-
-	static void HSLtoRGB(DWORD* ARGB, float H, float S, float L) {
-		const float
-			q = 2*L<1?L*(1+S):(L+S-L*S),
-			p = 2*L-q,
-			h = H/360,
-			tr = h + OneThird,
-			tg = h,
-			tb = h - OneThird,
-			ntr = tr<0?tr+1:(tr>1?tr-1:tr),
-			ntg = tg<0?tg+1:(tg>1?tg-1:tg),
-			ntb = tb<0?tb+1:(tb>1?tb-1:tb),
-			B = 255*(6*ntr<1?p+(q-p)*6*ntr:(2*ntr<1?q:(3*ntr<2?p+(q-p)*6*(2.0f*OneThird-ntr):p))),
-			G = 255*(6*ntg<1?p+(q-p)*6*ntg:(2*ntg<1?q:(3*ntg<2?p+(q-p)*6*(2.0f*OneThird-ntg):p))),
-			R = 255*(6*ntb<1?p+(q-p)*6*ntb:(2*ntb<1?q:(3*ntb<2?p+(q-p)*6*(2.0f*OneThird-ntb):p)));
-		*ARGB &= 0xFF000000;
-		*ARGB |= RGB( (BYTE)(R<0?0:(R>255?255:R)), (BYTE)(G<0?0:(G>255?255:G)), (BYTE)(B<0?0:(B>255?255:B)) );
-	}
-
 	static COLORREF PixelAlpha(COLORREF clrSrc, double src_darken, COLORREF clrDest, double dest_darken)
 	{
 		return RGB (GetRValue (clrSrc) * src_darken + GetRValue (clrDest) * dest_darken, 
@@ -239,13 +199,16 @@ namespace DuiLib {
 	
 	bool DrawImage(HDC hDC, CPaintManagerUI* pManager, const RECT& rc, const RECT& rcPaint, const CDuiString& sImageName, \
 		const CDuiString& sImageResType, RECT rcItem, RECT rcBmpPart, RECT rcCorner, DWORD dwMask, BYTE bFade, \
-		bool bHole, bool bTiledX, bool bTiledY, HINSTANCE instance = NULL)
+		bool bHole, bool bTiledX, bool bTiledY, HINSTANCE instance = NULL, UINT uScale = 100)
 	{
 		if (sImageName.IsEmpty()) {
 			return false;
 		}
 		const TImageInfo* data = NULL;
-		if( sImageResType.IsEmpty() ) {
+		if( sImageResType.IsEmpty() && uScale != 100 ) {
+			data = pManager->GetScaledImage((LPCTSTR)sImageName, uScale, dwMask);
+		}
+		else if( sImageResType.IsEmpty() ) {
 			data = pManager->GetImageEx((LPCTSTR)sImageName, NULL, dwMask, false, instance);
 		}
 		else {
@@ -272,22 +235,16 @@ namespace DuiLib {
 	DWORD CRenderEngine::AdjustColor(DWORD dwColor, short H, short S, short L)
 	{
 		if( H == 180 && S == 100 && L == 100 ) return dwColor;
-		float fH, fS, fL;
-		float S1 = S / 100.0f;
-		float L1 = L / 100.0f;
-		RGBtoHSL(dwColor, &fH, &fS, &fL);
-		fH += (H - 180);
-		fH = fH > 0 ? fH : fH + 360; 
-		fS *= S1;
-		fL *= L1;
-		HSLtoRGB(&dwColor, fH, fS, fL);
-		return dwColor;
+		return CPixelKernel::AdjustHSL(dwColor, H, S, L);
 	}
 
-	TImageInfo* CRenderEngine::LoadImage(STRINGorID bitmap, LPCTSTR type, DWORD mask, HINSTANCE instance)
+	// the file bytes of an image, from the resource path, the zip, the dll or a full path;
+	// the zip hands out views, so piZipView says how FreeImageData gives them back
+	static LPBYTE LoadImageData(const STRINGorID& bitmap, LPCTSTR type, HINSTANCE instance, DWORD* pdwSize, int* piZipView)
 	{
 		LPBYTE pData = NULL;
 		DWORD dwSize = 0;
+		int iZipView = -1;
 		do 
 		{
 			if( type == NULL ) {
@@ -312,37 +269,7 @@ namespace DuiLib {
 					}
 				}
 				else {
-					sFile += CPaintManagerUI::GetResourceZip();
-					CDuiString sFilePwd = CPaintManagerUI::GetResourceZipPwd();  //Garfield 20160325 zip
-					HZIP hz = NULL;
-					if( CPaintManagerUI::IsCachedResourceZip() ) hz = (HZIP)CPaintManagerUI::GetResourceZipHandle();
-					else
-					{
-#ifdef UNICODE
-						char* pwd = w2a((wchar_t*)sFilePwd.GetData());
-						hz = OpenZip(sFile.GetData(), pwd);
-						if(pwd) delete[] pwd;
-#else
-						hz = OpenZip(sFile.GetData(), sFilePwd.GetData());
-#endif
-					}
-					if( hz == NULL ) break;
-					ZIPENTRY ze; 
-					int i = 0; 
-					CDuiString key = bitmap.m_lpstr;
-					key.Replace(_T("\\"), _T("/"));
-					if( FindZipItem(hz, key, true, &i, &ze) != 0 ) break;
-					dwSize = ze.unc_size;
-					if( dwSize == 0 ) break;
-					pData = new BYTE[ dwSize ];
-					int res = UnzipItem(hz, i, pData, dwSize);
-					if( res != 0x00000000 && res != 0x00000600) {
-						delete[] pData;
-						pData = NULL;
-						if( !CPaintManagerUI::IsCachedResourceZip() ) CloseZip(hz);
-						break;
-					}
-					if( !CPaintManagerUI::IsCachedResourceZip() ) CloseZip(hz);
+					pData = CPaintManagerUI::LoadResourceZipItem(bitmap.m_lpstr, &dwSize, &iZipView);
 				}
 			}
 			else {
@@ -391,6 +318,22 @@ namespace DuiLib {
 			}
 			break;
 		}
+		*pdwSize = dwSize;
+		*piZipView = iZipView;
+		return pData;
+	}
+
+	static void FreeImageData(LPBYTE pData, int iZipView)
+	{
+		if( iZipView >= 0 ) CPaintManagerUI::FreeResourceZipItem(pData, iZipView);
+		else delete[] pData;
+	}
+
+	TImageInfo* CRenderEngine::LoadImage(STRINGorID bitmap, LPCTSTR type, DWORD mask, HINSTANCE instance)
+	{
+		DWORD dwSize = 0;
+		int iZipView = -1;
+		LPBYTE pData = LoadImageData(bitmap, type, instance, &dwSize, &iZipView);
 		if (!pData)
 		{
 			//::MessageBox(0, _T("ȡͼƬʧܣ"), _T("ץBUG"), MB_OK);
@@ -400,7 +343,7 @@ namespace DuiLib {
 		LPBYTE pImage = NULL;
 		int x,y,n;
 		pImage = stbi_load_from_memory(pData, dwSize, &x, &y, &n, 4);
-		delete[] pData;
+		FreeImageData(pData, iZipView);
 		if( !pImage ) {
 			//::MessageBox(0, _T("ͼƬʧ"), _T("ץBUG"), MB_OK);
 			return NULL;
@@ -416,7 +359,6 @@ namespace DuiLib {
 		bmi.bmiHeader.biCompression = BI_RGB;
 		bmi.bmiHeader.biSizeImage = x * y * 4;
 
-		bool bAlphaChannel = false;
 		LPBYTE pDest = NULL;
 		HBITMAP hBitmap = ::CreateDIBSection(NULL, &bmi, DIB_RGB_COLORS, (void**)&pDest, NULL, 0);
 		if( !hBitmap ) {
@@ -424,36 +366,12 @@ namespace DuiLib {
 			return NULL;
 		}
 
-		for( int i = 0; i < x * y; i++ ) 
-		{
-			pDest[i*4 + 3] = pImage[i*4 + 3];
-			if( pDest[i*4 + 3] < 255 )
-			{
-				pDest[i*4] = (BYTE)(DWORD(pImage[i*4 + 2])*pImage[i*4 + 3]/255);
-				pDest[i*4 + 1] = (BYTE)(DWORD(pImage[i*4 + 1])*pImage[i*4 + 3]/255);
-				pDest[i*4 + 2] = (BYTE)(DWORD(pImage[i*4])*pImage[i*4 + 3]/255); 
-				bAlphaChannel = true;
-			}
-			else
-			{
-				pDest[i*4] = pImage[i*4 + 2];
-				pDest[i*4 + 1] = pImage[i*4 + 1];
-				pDest[i*4 + 2] = pImage[i*4]; 
-			}
-
-			if( *(DWORD*)(&pDest[i*4]) == mask ) {
-				pDest[i*4] = (BYTE)0;
-				pDest[i*4 + 1] = (BYTE)0;
-				pDest[i*4 + 2] = (BYTE)0; 
-				pDest[i*4 + 3] = (BYTE)0;
-				bAlphaChannel = true;
-			}
-		}
+		bool bAlphaChannel = CPixelKernel::Premultiply((DWORD*)pDest, pImage, x * y, mask);
 
 		stbi_image_free(pImage);
 
 		TImageInfo* data = new TImageInfo;
-		data->pBits = NULL;
+		data->pBits = pDest;
 		data->pSrcBits = NULL;
 		data->hBitmap = hBitmap;
 		data->nX = x;
@@ -461,6 +379,95 @@ namespace DuiLib {
 		data->bAlpha = bAlphaChannel;
 		return data;
 	}
+
+	TImageInfo* CRenderEngine::ResampleImage(const TImageInfo* pImage, int cx, int cy)
+	{
+		if( pImage == NULL || pImage->pBits == NULL || cx <= 0 || cy <= 0 ) return NULL;
+
+		BITMAPINFO bmi;
+		::ZeroMemory(&bmi, sizeof(BITMAPINFO));
+		bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+		bmi.bmiHeader.biWidth = cx;
+		bmi.bmiHeader.biHeight = -cy;
+		bmi.bmiHeader.biPlanes = 1;
+		bmi.bmiHeader.biBitCount = 32;
+		bmi.bmiHeader.biCompression = BI_RGB;
+		bmi.bmiHeader.biSizeImage = cx * cy * 4;
+
+		LPBYTE pDest = NULL;
+		HBITMAP hBitmap = ::CreateDIBSection(NULL, &bmi, DIB_RGB_COLORS, (void**)&pDest, NULL, 0);
+		if( !hBitmap ) return NULL;
+
+		// both top-down, so rows line up
+		CPixelKernel::Resample((DWORD*)pDest, cx, cy, (const DWORD*)pImage->pBits, pImage->nX, pImage->nY);
+
+		TImageInfo* data = new TImageInfo;
+		data->pBits = pDest;
+		data->pSrcBits = NULL;
+		data->hBitmap = hBitmap;
+		data->nX = cx;
+		data->nY = cy;
+		data->bAlpha = pImage->bAlpha;
+		data->bUseHSL = pImage->bUseHSL;
+		data->dwMask = pImage->dwMask;
+		return data;
+	}
+
+	TGifAtlasInfo* CRenderEngine::LoadGifAtlas(LPCTSTR pStrImage, DWORD mask, size_t cbMax)
+	{
+		DWORD dwSize = 0;
+		int iZipView = -1;
+		LPBYTE pData = LoadImageData(STRINGorID(pStrImage), NULL, NULL, &dwSize, &iZipView);
+		if( !pData ) return NULL;
+		CGifAtlas* pAtlas = CGifAtlas::Decode(pData, (int)dwSize, mask, cbMax);
+		FreeImageData(pData, iZipView);
+		if( !pAtlas ) return NULL;
+
+		// one bitmap for all the frames, so showing a frame is a blit of its rows
+		int x = pAtlas->GetWidth();
+		int y = pAtlas->GetHeight() * pAtlas->GetFrameCount();
+		BITMAPINFO bmi;
+		::ZeroMemory(&bmi, sizeof(BITMAPINFO));
+		bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+		bmi.bmiHeader.biWidth = x;
+		bmi.bmiHeader.biHeight = -y;
+		bmi.bmiHeader.biPlanes = 1;
+		bmi.bmiHeader.biBitCount = 32;
+		bmi.bmiHeader.biCompression = BI_RGB;
+		bmi.bmiHeader.biSizeImage = x * y * 4;
+
+		LPBYTE pDest = NULL;
+		HBITMAP hBitmap = ::CreateDIBSection(NULL, &bmi, DIB_RGB_COLORS, (void**)&pDest, NULL, 0);
+		if( !hBitmap ) {
+			delete pAtlas;
+			return NULL;
+		}
+		::CopyMemory(pDest, pAtlas->GetBits(), x * y * 4);
+
+		TGifAtlasInfo* data = new TGifAtlasInfo;
+		data->image.pBits = pDest;
+		data->image.pSrcBits = NULL;
+		data->image.hBitmap = hBitmap;
+		data->image.nX = x;
+		data->image.nY = y;
+		data->image.bAlpha = pAtlas->IsAlpha();
+		data->image.bUseHSL = false;
+		data->image.dwMask = mask;
+		data->nFrameY = pAtlas->GetHeight();
+		data->nFrames = pAtlas->GetFrameCount();
+		data->pDelays = new int[data->nFrames];
+		for( int i = 0; i < data->nFrames; i++ ) data->pDelays[i] = pAtlas->GetDelay(i);
+		delete pAtlas;
+		return data;
+	}
+
+	void CRenderEngine::FreeGifAtlas(TGifAtlasInfo* pAtlas)
+	{
+		if( pAtlas == NULL ) return;
+		FreeImage(&pAtlas->image, false);
+		delete[] pAtlas->pDelays;
+		delete pAtlas;
+	}
 #ifdef USE_XIMAGE_EFFECT
 	static DWORD LoadImage2Memory(const STRINGorID &bitmap, LPCTSTR type,LPBYTE &pData)
 	{
@@ -497,41 +504,16 @@ namespace DuiLib {
 				}
 				else 
 				{
-					sFile += CPaintManagerUI::GetResourceZip();
-					HZIP hz = NULL;
-					if( CPaintManagerUI::IsCachedResourceZip() ) 
-						hz = (HZIP)CPaintManagerUI::GetResourceZipHandle();
-					else {
-						CDuiString sFilePwd = CPaintManagerUI::GetResourceZipPwd();
-#ifdef UNICODE
-						char* pwd = w2a((wchar_t*)sFilePwd.GetData());
-						hz = OpenZip((void*)sFile.GetData(), pwd);
-						if(pwd) delete[] pwd;
-#else
-						hz = OpenZip((void*)sFile.GetData(), sFilePwd.GetData());
-#endif
-					}
-					if( hz == NULL ) break;
-					ZIPENTRY ze; 
-					int i = 0; 
-					CDuiString key = bitmap.m_lpstr;
-					key.Replace(_T("\\"), _T("/")); 
-					if( FindZipItem(hz, key, true, &i, &ze) != 0 ) break;
-					dwSize = ze.unc_size;
-					if( dwSize == 0 ) break;
-					pData = new BYTE[ dwSize ];
-					int res = UnzipItem(hz, i, pData, dwSize, 3);
-					if( res != 0x00000000 && res != 0x00000600)
+					int iZipView = -1;
+					pData = CPaintManagerUI::LoadResourceZipItem(bitmap.m_lpstr, &dwSize, &iZipView);
+					if( pData != NULL && iZipView >= 0 )
 					{
-						delete[] pData;
-						pData = NULL;
-						dwSize = 0U;
-						if( !CPaintManagerUI::IsCachedResourceZip() )
-							CloseZip(hz);
-						break;
+						// the caller delete[]s what it gets
+						LPBYTE pView = pData;
+						pData = new BYTE[ dwSize ];
+						::CopyMemory(pData, pView, dwSize);
+						CPaintManagerUI::FreeResourceZipItem(pView, iZipView);
 					}
-					if( !CPaintManagerUI::IsCachedResourceZip() )
-						CloseZip(hz);
 				}
 			}
 			else 
@@ -605,6 +587,7 @@ namespace DuiLib {
 	{
 		LPBYTE pData = NULL;
 		DWORD dwSize = 0;
+		int iZipView = -1;
 
 		do 
 		{
@@ -629,36 +612,7 @@ namespace DuiLib {
 				}
 			}
 			else {
-				sFile += CPaintManagerUI::GetResourceZip();
-				HZIP hz = NULL;
-				if( CPaintManagerUI::IsCachedResourceZip() ) hz = (HZIP)CPaintManagerUI::GetResourceZipHandle();
-				else {
-					CDuiString sFilePwd = CPaintManagerUI::GetResourceZipPwd();
-#ifdef UNICODE
-					char* pwd = w2a((wchar_t*)sFilePwd.GetData());
-					hz = OpenZip(sFile.GetData(), pwd);
-					if(pwd) delete[] pwd;
-#else
-					hz = OpenZip(sFile.GetData(), sFilePwd.GetData());
-#endif
-				}
-				if( hz == NULL ) break;
-				ZIPENTRY ze; 
-				int i = 0; 
-				CDuiString key = pstrPath;
-				key.Replace(_T("\\"), _T("/"));
-				if( FindZipItem(hz, key, true, &i, &ze) != 0 ) break;
-				dwSize = ze.unc_size;
-				if( dwSize == 0 ) break;
-				pData = new BYTE[ dwSize ];
-				int res = UnzipItem(hz, i, pData, dwSize);
-				if( res != 0x00000000 && res != 0x00000600) {
-					delete[] pData;
-					pData = NULL;
-					if( !CPaintManagerUI::IsCachedResourceZip() ) CloseZip(hz);
-					break;
-				}
-				if( !CPaintManagerUI::IsCachedResourceZip() ) CloseZip(hz);
+				pData = CPaintManagerUI::LoadResourceZipItem(pstrPath, &dwSize, &iZipView);
 			}
 
 		} while (0);
@@ -686,7 +640,8 @@ namespace DuiLib {
 		Gdiplus::Image* pImage = NULL;
 		if(pData != NULL) {
 			pImage = GdiplusLoadImage(pData, dwSize);
-			delete pData;
+			if( iZipView >= 0 ) CPaintManagerUI::FreeResourceZipItem(pData, iZipView);
+			else delete[] pData;
 			pData = NULL;
 		}
 		return pImage;
@@ -716,9 +671,7 @@ namespace DuiLib {
 			::DeleteObject(bitmap->hBitmap);
 		}
 		bitmap->hBitmap = NULL;
-		if (bitmap->pBits) {
-			delete[] bitmap->pBits;
-		}
+		// pBits are the bitmap's own pixels and went with it
 		bitmap->pBits = NULL;
 		if (bitmap->pSrcBits) {
 			delete[] bitmap->pSrcBits;
@@ -1411,8 +1364,13 @@ namespace DuiLib {
 				rcDest.bottom = rcItem.top + pDrawInfo->rcDest.bottom;
 				if( rcDest.bottom > rcItem.bottom ) rcDest.bottom = rcItem.bottom;
 		}
-		bool bRet = DuiLib::DrawImage(hDC, pManager, rcItem, rcPaint, pDrawInfo->sImageName, pDrawInfo->sResType, rcDest, \
-			pDrawInfo->rcSource, pDrawInfo->rcCorner, pDrawInfo->dwMask, pDrawInfo->uFade, pDrawInfo->bHole, pDrawInfo->bTiledX, pDrawInfo->bTiledY, instance);
+		// files are drawn from an image made for the window's scale, as big as the scaled source,
+		// so a part drawn at its own size goes out 1:1 rather than stretched; resources only
+		// come at the sizes they were built at
+		bool bScaled = pDrawInfo->uScale != 100 && pDrawInfo->sResType.IsEmpty();
+		bool bRet = DuiLib::DrawImage(hDC, pManager, rcItem, rcPaint, bScaled ? pDrawInfo->sBaseName : pDrawInfo->sImageName, pDrawInfo->sResType, rcDest, \
+			pDrawInfo->rcSource, pDrawInfo->rcCorner, pDrawInfo->dwMask, pDrawInfo->uFade, pDrawInfo->bHole, pDrawInfo->bTiledX, pDrawInfo->bTiledY, instance, \
+			bScaled ? pDrawInfo->uScale : 100);
 		
 		return bRet;
 	}
@@ -1695,6 +1653,114 @@ namespace DuiLib {
 		}
 	}
 
+	/////////////////////////////////////////////////////////////////////////////////////
+	//
+	//
+
+	// The fonts the markup asks for are made as they are needed. Each one keeps an id of its
+	// own, so they stay alive together while the cached layouts point at them.
+	static CStdStringPtrMap g_mHtmlFontIDs;
+
+	static TFontInfo* GetHtmlFont(CPaintManagerUI* pManager, LPCTSTR pstrFace, int nSize, bool bBold, bool bUnderline, bool bItalic)
+	{
+		HFONT hFont = pManager->GetFont(pstrFace, nSize, bBold, bUnderline, bItalic);
+		if( hFont != NULL ) return pManager->GetFontInfo(hFont);
+
+		CDuiString sKey;
+		sKey.Format(_T("%s,%d,%d%d%d"), pstrFace, nSize, bBold, bUnderline, bItalic);
+		int iFont = (int)(INT_PTR)g_mHtmlFontIDs.Find(sKey);
+		if( iFont == 0 ) {
+			iFont = g_iFontID++;
+			g_mHtmlFontIDs.Insert(sKey, (LPVOID)(INT_PTR)iFont);
+		}
+		else {
+			// made before under a face name that GetFont doesn't match, like an empty one
+			TFontInfo* pFontInfo = pManager->GetFontInfo(iFont);
+			if( pFontInfo != pManager->GetDefaultFontInfo() ) return pFontInfo;
+		}
+		hFont = pManager->AddFont(iFont, pstrFace, nSize, bBold, bUnderline, bItalic);
+		return pManager->GetFontInfo(hFont);
+	}
+
+	// What CHtmlLayout measures with: the fonts of the paint manager on the DC being drawn on
+	class CHtmlRenderHost : public IHtmlLayoutHost
+	{
+	public:
+		CHtmlRenderHost(HDC hDC, CPaintManagerUI* pManager) : m_hDC(hDC), m_pManager(pManager), m_hSelected(NULL)
+		{
+		}
+
+		LPVOID GetDefaultFont()
+		{
+			return m_pManager->GetDefaultFontInfo();
+		}
+
+		LPVOID GetFont(int iFont)
+		{
+			return m_pManager->GetFontInfo(iFont);
+		}
+
+		LPVOID GetFont(LPCTSTR pstrFace, int nSize, bool bBold, bool bUnderline, bool bItalic)
+		{
+			return GetHtmlFont(m_pManager, pstrFace, nSize, bBold, bUnderline, bItalic);
+		}
+
+		LPVOID GetFont(LPVOID hFont, bool bBold, bool bUnderline, bool bItalic)
+		{
+			TFontInfo* pFontInfo = static_cast<TFontInfo*>(hFont);
+			return GetHtmlFont(m_pManager, pFontInfo->sFontName, pFontInfo->iSize, bBold, bUnderline, bItalic);
+		}
+
+		void GetFontInfo(LPVOID hFont, THtmlFontInfo& info)
+		{
+			TFontInfo* pFontInfo = static_cast<TFontInfo*>(hFont);
+			info.cyHeight = pFontInfo->tm.tmHeight;
+			info.cyExternalLeading = pFontInfo->tm.tmExternalLeading;
+			info.cxMaxChar = pFontInfo->tm.tmMaxCharWidth;
+			info.bSlanted = pFontInfo->tm.tmItalic != 0;
+			info.bBold = pFontInfo->bBold;
+			info.bUnderline = pFontInfo->bUnderline;
+			info.bItalic = pFontInfo->bItalic;
+		}
+
+		int GetTextWidth(LPVOID hFont, LPCTSTR pstrText, int cchText)
+		{
+			SelectFont(hFont);
+			SIZE szText = { 0 };
+			::GetTextExtentPoint32(m_hDC, pstrText, cchText, &szText);
+			return szText.cx;
+		}
+
+		int GetSpaceOverhang(LPVOID hFont)
+		{
+			SelectFont(hFont);
+			ABC abc = { 0 };
+			::GetCharABCWidths(m_hDC, _T(' '), _T(' '), &abc);
+			return abc.abcC;
+		}
+
+		bool GetImageSize(LPCTSTR pstrName, LPCTSTR pstrType, int& cx, int& cy)
+		{
+			const TImageInfo* pImageInfo = m_pManager->GetImageEx(pstrName, pstrType);
+			if( pImageInfo == NULL ) return false;
+			cx = pImageInfo->nX;
+			cy = pImageInfo->nY;
+			return true;
+		}
+
+	private:
+		void SelectFont(LPVOID hFont)
+		{
+			if( hFont == m_hSelected ) return;
+			::SelectObject(m_hDC, static_cast<TFontInfo*>(hFont)->hFont);
+			m_hSelected = hFont;
+		}
+
+		HDC m_hDC;
+		CPaintManagerUI* m_pManager;
+		LPVOID m_hSelected;
+	};
+
 	void CRenderEngine::DrawHtmlText(HDC hDC, CPaintManagerUI* pManager, RECT& rc, LPCTSTR pstrText, DWORD dwTextColor, RECT* prcLinks, CDuiString* sLinks, int& nLinkRects, UINT uStyle)
 	{
 		// ǵxml༭ʹ<>Ų㣬ʹ{}Ŵ
@@ -1721,17 +1787,12 @@ namespace DuiLib {
 
 		bool bDraw = (uStyle & DT_CALCRECT) == 0;
 
-		CStdPtrArray aFontArray(10);
-		CStdPtrArray aColorArray(10);
-		CStdPtrArray aPIndentArray(10);
-
 		RECT rcClip = { 0 };
 		::GetClipBox(hDC, &rcClip);
 		HRGN hOldRgn = ::CreateRectRgnIndirect(&rcClip);
 		HRGN hRgn = ::CreateRectRgnIndirect(&rc);
 		if( bDraw ) ::ExtSelectClipRgn(hDC, hRgn, RGN_AND);
 
-		TEXTMETRIC* pTm = &pManager->GetDefaultFontInfo()->tm;
 		HFONT hOldFont = (HFONT) ::SelectObject(hDC, pManager->GetDefaultFontInfo()->hFont);
 		::SetBkMode(hDC, TRANSPARENT);
 		::SetTextColor(hDC, RGB(GetBValue(dwTextColor), GetGValue(dwTextColor), GetRValue(dwTextColor)));
@@ -1772,602 +1833,79 @@ namespace DuiLib {
 			}
 		}
 
-		POINT pt = { rc.left, rc.top };
-		int iLinkIndex = 0;
-		int cyLine = pTm->tmHeight + pTm->tmExternalLeading + (int)aPIndentArray.GetAt(aPIndentArray.GetSize() - 1);
-		int cyMinHeight = 0;
-		int cxMaxWidth = 0;
-		POINT ptLinkStart = { 0 };
-		bool bLineEnd = false;
-		bool bInRaw = false;
-		bool bInLink = false;
-		bool bInSelected = false;
-		int iLineLinkIndex = 0;
-
-		// Űϰͼĵײ룬ÿлƶҪȼ߶ȣٻ
-		CStdPtrArray aLineFontArray;
-		CStdPtrArray aLineColorArray;
-		CStdPtrArray aLinePIndentArray;
-		LPCTSTR pstrLineBegin = pstrText;
-		bool bLineInRaw = false;
-		bool bLineInLink = false;
-		bool bLineInSelected = false;
-		int cyLineHeight = 0;
-		bool bLineDraw = false; // еĵڶ׶Σ
-		while( *pstrText != _T('\0') ) {
-			if( pt.x >= rc.right || *pstrText == _T('\n') || bLineEnd ) {
-				if( *pstrText == _T('\n') ) pstrText++;
-				if( bLineEnd ) bLineEnd = false;
-				if( !bLineDraw ) {
-					if( bInLink && iLinkIndex < nLinkRects ) {
-						::SetRect(&prcLinks[iLinkIndex++], ptLinkStart.x, ptLinkStart.y, MIN(pt.x, rc.right), pt.y + cyLine);
-						CDuiString *pStr1 = (CDuiString*)(sLinks + iLinkIndex - 1);
-						CDuiString *pStr2 = (CDuiString*)(sLinks + iLinkIndex);
-						*pStr2 = *pStr1;
-					}
-					for( int i = iLineLinkIndex; i < iLinkIndex; i++ ) {
-						prcLinks[i].bottom = pt.y + cyLine;
-					}
-					if( bDraw ) {
-						bInLink = bLineInLink;
-						iLinkIndex = iLineLinkIndex;
-					}
-				}
-				else {
-					if( bInLink && iLinkIndex < nLinkRects ) iLinkIndex++;
-					bLineInLink = bInLink;
-					iLineLinkIndex = iLinkIndex;
-				}
-				if( (uStyle & DT_SINGLELINE) != 0 && (!bDraw || bLineDraw) ) break;
-				if( bDraw ) bLineDraw = !bLineDraw; // !
-				pt.x = rc.left;
-				if( !bLineDraw ) pt.y += cyLine;
-				if( pt.y > rc.bottom && bDraw ) break;
-				ptLinkStart = pt;
-				cyLine = pTm->tmHeight + pTm->tmExternalLeading + (int)aPIndentArray.GetAt(aPIndentArray.GetSize() - 1);
-				if( pt.x >= rc.right ) break;
-			}
-			else if( !bInRaw && ( *pstrText == _T('<') || *pstrText == _T('{') )
-				&& ( pstrText[1] >= _T('a') && pstrText[1] <= _T('z') )
-				&& ( pstrText[2] == _T(' ') || pstrText[2] == _T('>') || pstrText[2] == _T('}') ) ) {
-					pstrText++;
-					LPCTSTR pstrNextStart = NULL;
-					switch( *pstrText ) {
-					case _T('a'):  // Link
-						{
-							pstrText++;
-							while( *pstrText > _T('\0') && *pstrText <= _T(' ') ) pstrText = ::CharNext(pstrText);
-							if( iLinkIndex < nLinkRects && !bLineDraw ) {
-								CDuiString *pStr = (CDuiString*)(sLinks + iLinkIndex);
-								pStr->Empty();
-								while( *pstrText != _T('\0') && *pstrText != _T('>') && *pstrText != _T('}') ) {
-									LPCTSTR pstrTemp = ::CharNext(pstrText);
-									while( pstrText < pstrTemp) {
-										*pStr += *pstrText++;
-									}
-								}
-							}
-
-							DWORD clrColor = dwTextColor;
-							if(clrColor == 0) pManager->GetDefaultLinkFontColor();
-							if( bHoverLink && iLinkIndex < nLinkRects ) {
-								CDuiString *pStr = (CDuiString*)(sLinks + iLinkIndex);
-								if( sHoverLink == *pStr ) clrColor = pManager->GetDefaultLinkHoverFontColor();
-							}
-							//else if( prcLinks == NULL ) {
-							//    if( ::PtInRect(&rc, ptMouse) )
-							//        clrColor = pManager->GetDefaultLinkHoverFontColor();
-							//}
-							aColorArray.Add((LPVOID)clrColor);
-							::SetTextColor(hDC,  RGB(GetBValue(clrColor), GetGValue(clrColor), GetRValue(clrColor)));
-							TFontInfo* pFontInfo = pManager->GetDefaultFontInfo();
-							if( aFontArray.GetSize() > 0 ) pFontInfo = (TFontInfo*)aFontArray.GetAt(aFontArray.GetSize() - 1);
-							if( pFontInfo->bUnderline == false ) {
-								HFONT hFont = pManager->GetFont(pFontInfo->sFontName, pFontInfo->iSize, pFontInfo->bBold, true, pFontInfo->bItalic);
-								if( hFont == NULL ) hFont = pManager->AddFont(g_iFontID, pFontInfo->sFontName, pFontInfo->iSize, pFontInfo->bBold, true, pFontInfo->bItalic);
-								pFontInfo = pManager->GetFontInfo(hFont);
-								aFontArray.Add(pFontInfo);
-								pTm = &pFontInfo->tm;
-								::SelectObject(hDC, pFontInfo->hFont);
-								cyLine = MAX(cyLine, pTm->tmHeight + pTm->tmExternalLeading + (int)aPIndentArray.GetAt(aPIndentArray.GetSize() - 1));
-							}
-							ptLinkStart = pt;
-							bInLink = true;
-						}
-						break;
-					case _T('b'):  // Bold
-						{
-							pstrText++;
-							TFontInfo* pFontInfo = pManager->GetDefaultFontInfo();
-							if( aFontArray.GetSize() > 0 ) pFontInfo = (TFontInfo*)aFontArray.GetAt(aFontArray.GetSize() - 1);
-							if( pFontInfo->bBold == false ) {
-								HFONT hFont = pManager->GetFont(pFontInfo->sFontName, pFontInfo->iSize, true, pFontInfo->bUnderline, pFontInfo->bItalic);
-								if( hFont == NULL ) hFont = pManager->AddFont(g_iFontID, pFontInfo->sFontName, pFontInfo->iSize, true, pFontInfo->bUnderline, pFontInfo->bItalic);
-								pFontInfo = pManager->GetFontInfo(hFont);
-								aFontArray.Add(pFontInfo);
-								pTm = &pFontInfo->tm;
-								::SelectObject(hDC, pFontInfo->hFont);
-								cyLine = MAX(cyLine, pTm->tmHeight + pTm->tmExternalLeading + (int)aPIndentArray.GetAt(aPIndentArray.GetSize() - 1));
-							}
-						}
-						break;
-					case _T('c'):  // Color
-						{
-							pstrText++;
-							while( *pstrText > _T('\0') && *pstrText <= _T(' ') ) pstrText = ::CharNext(pstrText);
-							if( *pstrText == _T('#')) pstrText++;
-							DWORD clrColor = _tcstol(pstrText, const_cast<LPTSTR*>(&pstrText), 16);
-							aColorArray.Add((LPVOID)clrColor);
-							::SetTextColor(hDC, RGB(GetBValue(clrColor), GetGValue(clrColor), GetRValue(clrColor)));
-						}
-						break;
-					case _T('f'):  // Font
-						{
-							pstrText++;
-							while( *pstrText > _T('\0') && *pstrText <= _T(' ') ) pstrText = ::CharNext(pstrText);
-							LPCTSTR pstrTemp = pstrText;
-							int iFont = (int) _tcstol(pstrText, const_cast<LPTSTR*>(&pstrText), 10);
-							//if( isdigit(*pstrText) ) { // debug汾쳣
-							if( pstrTemp != pstrText ) {
-								TFontInfo* pFontInfo = pManager->GetFontInfo(iFont);
-								aFontArray.Add(pFontInfo);
-								pTm = &pFontInfo->tm;
-								::SelectObject(hDC, pFontInfo->hFont);
-							}
-							else {
-								CDuiString sFontName;
-								int iFontSize = 10;
-								CDuiString sFontAttr;
-								bool bBold = false;
-								bool bUnderline = false;
-								bool bItalic = false;
-								while( *pstrText != _T('\0') && *pstrText != _T('>') && *pstrText != _T('}') && *pstrText != _T(' ') ) {
-									pstrTemp = ::CharNext(pstrText);
-									while( pstrText < pstrTemp) {
-										sFontName += *pstrText++;
-									}
-								}
-								while( *pstrText > _T('\0') && *pstrText <= _T(' ') ) pstrText = ::CharNext(pstrText);
-								if( isdigit(*pstrText) ) {
-									iFontSize = (int) _tcstol(pstrText, const_cast<LPTSTR*>(&pstrText), 10);
-								}
-								while( *pstrText > _T('\0') && *pstrText <= _T(' ') ) pstrText = ::CharNext(pstrText);
-								while( *pstrText != _T('\0') && *pstrText != _T('>') && *pstrText != _T('}') ) {
-									pstrTemp = ::CharNext(pstrText);
-									while( pstrText < pstrTemp) {
-										sFontAttr += *pstrText++;
-									}
-								}
-								sFontAttr.MakeLower();
-								if( sFontAttr.Find(_T("bold")) >= 0 ) bBold = true;
-								if( sFontAttr.Find(_T("underline")) >= 0 ) bUnderline = true;
-								if( sFontAttr.Find(_T("italic")) >= 0 ) bItalic = true;
-								HFONT hFont = pManager->GetFont(sFontName, iFontSize, bBold, bUnderline, bItalic);
-								if( hFont == NULL ) hFont = pManager->AddFont(g_iFontID, sFontName, iFontSize, bBold, bUnderline, bItalic);
-								TFontInfo* pFontInfo = pManager->GetFontInfo(hFont);
-								aFontArray.Add(pFontInfo);
-								pTm = &pFontInfo->tm;
-								::SelectObject(hDC, pFontInfo->hFont);
-							}
-							cyLine = MAX(cyLine, pTm->tmHeight + pTm->tmExternalLeading + (int)aPIndentArray.GetAt(aPIndentArray.GetSize() - 1));
-						}
-						break;
-					case _T('i'):  // Italic or Image
-						{    
-							pstrNextStart = pstrText - 1;
-							pstrText++;
-							CDuiString sImageString = pstrText;
-							int iWidth = 0;
-							int iHeight = 0;
-							while( *pstrText > _T('\0') && *pstrText <= _T(' ') ) pstrText = ::CharNext(pstrText);
-							const TImageInfo* pImageInfo = NULL;
-							CDuiString sName;
-							while( *pstrText != _T('\0') && *pstrText != _T('>') && *pstrText != _T('}') && *pstrText != _T(' ') ) {
-								LPCTSTR pstrTemp = ::CharNext(pstrText);
-								while( pstrText < pstrTemp) {
-									sName += *pstrText++;
-								}
-							}
-							if( sName.IsEmpty() ) { // Italic
-								pstrNextStart = NULL;
-								TFontInfo* pFontInfo = pManager->GetDefaultFontInfo();
-								if( aFontArray.GetSize() > 0 ) pFontInfo = (TFontInfo*)aFontArray.GetAt(aFontArray.GetSize() - 1);
-								if( pFontInfo->bItalic == false ) {
-									HFONT hFont = pManager->GetFont(pFontInfo->sFontName, pFontInfo->iSize, pFontInfo->bBold, pFontInfo->bUnderline, true);
-									if( hFont == NULL ) hFont = pManager->AddFont(g_iFontID, pFontInfo->sFontName, pFontInfo->iSize, pFontInfo->bBold, pFontInfo->bUnderline, true);
-									pFontInfo = pManager->GetFontInfo(hFont);
-									aFontArray.Add(pFontInfo);
-									pTm = &pFontInfo->tm;
-									::SelectObject(hDC, pFontInfo->hFont);
-									cyLine = MAX(cyLine, pTm->tmHeight + pTm->tmExternalLeading + (int)aPIndentArray.GetAt(aPIndentArray.GetSize() - 1));
-								}
-							}
-							else {
-								while( *pstrText > _T('\0') && *pstrText <= _T(' ') ) pstrText = ::CharNext(pstrText);
-								int iImageListNum = (int) _tcstol(pstrText, const_cast<LPTSTR*>(&pstrText), 10);
-								if( iImageListNum <= 0 ) iImageListNum = 1;
-								while( *pstrText > _T('\0') && *pstrText <= _T(' ') ) pstrText = ::CharNext(pstrText);
-								int iImageListIndex = (int) _tcstol(pstrText, const_cast<LPTSTR*>(&pstrText), 10);
-								if( iImageListIndex < 0 || iImageListIndex >= iImageListNum ) iImageListIndex = 0;
-
-								if( _tcsstr(sImageString.GetData(), _T("file=\'")) != NULL || _tcsstr(sImageString.GetData(), _T("res=\'")) != NULL ) {
-									CDuiString sImageResType;
-									CDuiString sImageName;
-									LPCTSTR pStrImage = sImageString.GetData();
-									CDuiString sItem;
-									CDuiString sValue;
-									while( *pStrImage != _T('\0') ) {
-										sItem.Empty();
-										sValue.Empty();
-										while( *pStrImage > _T('\0') && *pStrImage <= _T(' ') ) pStrImage = ::CharNext(pStrImage);
-										while( *pStrImage != _T('\0') && *pStrImage != _T('=') && *pStrImage > _T(' ') ) {
-											LPTSTR pstrTemp = ::CharNext(pStrImage);
-											while( pStrImage < pstrTemp) {
-												sItem += *pStrImage++;
-											}
-										}
-										while( *pStrImage > _T('\0') && *pStrImage <= _T(' ') ) pStrImage = ::CharNext(pStrImage);
-										if( *pStrImage++ != _T('=') ) break;
-										while( *pStrImage > _T('\0') && *pStrImage <= _T(' ') ) pStrImage = ::CharNext(pStrImage);
-										if( *pStrImage++ != _T('\'') ) break;
-										while( *pStrImage != _T('\0') && *pStrImage != _T('\'') ) {
-											LPTSTR pstrTemp = ::CharNext(pStrImage);
-											while( pStrImage < pstrTemp) {
-												sValue += *pStrImage++;
-											}
-										}
-										if( *pStrImage++ != _T('\'') ) break;
-										if( !sValue.IsEmpty() ) {
-											if( sItem == _T("file") || sItem == _T("res") ) {
-												sImageName = sValue;
-											}
-											else if( sItem == _T("restype") ) {
-												sImageResType = sValue;
-											}
-										}
-										if( *pStrImage++ != _T(' ') ) break;
-									}
-
-									pImageInfo = pManager->GetImageEx((LPCTSTR)sImageName, sImageResType);
-								}
-								else
-									pImageInfo = pManager->GetImageEx((LPCTSTR)sName);
-
-								if( pImageInfo ) {
-									iWidth = pImageInfo->nX;
-									iHeight = pImageInfo->nY;
-									if( iImageListNum > 1 ) iWidth /= iImageListNum;
+		// the layout at the origin, made once for this text, rect size, style and hover
+		CHtmlLayoutCache::TKey key;
+		key.sText = pstrText;
+		key.sHoverLink = bHoverLink ? sHoverLink.GetData() : _T("");
+		key.bHoverLink = bHoverLink;
+		key.cx = rc.right - rc.left;
+		key.cy = rc.bottom - rc.top;
+		key.uStyle = uStyle;
+		key.dwTextColor = dwTextColor;
+		key.dwLinkHoverColor = pManager->GetDefaultLinkHoverFontColor();
+		key.nLinkRects = nLinkRects;
+		key.nScale = pManager->GetDPIObj()->GetScale();
+		key.uSerial = CPaintManagerUI::GetResourceSerial();
+		CHtmlLayoutCache* pCache = pManager->GetHtmlLayoutCache();
+		CHtmlLayout* pUncached = NULL;
+		const CHtmlLayout* pLayout = pCache->Find(key);
+		if( pLayout == NULL ) {
+			CHtmlRenderHost host(hDC, pManager);
+			CHtmlLayout* pBuilt = new CHtmlLayout;
+			pBuilt->Build(&host, pstrText, key.cx, key.cy, uStyle, dwTextColor, key.dwLinkHoverColor, \
+				bHoverLink ? sHoverLink.GetData() : NULL, nLinkRects);
+			// building may have made fonts, which moves the serial on
+			key.uSerial = CPaintManagerUI::GetResourceSerial();
+			if( pBuilt->IsComplete() ) pLayout = pCache->Add(key, pBuilt);
+			else pLayout = pUncached = pBuilt;
+		}
 
-									if( pt.x + iWidth > rc.right && pt.x > rc.left && (uStyle & DT_SINGLELINE) == 0 ) {
-										bLineEnd = true;
-									}
-									else {
-										pstrNextStart = NULL;
-										if( bDraw && bLineDraw ) {
-											CDuiRect rcImage(pt.x, pt.y + cyLineHeight - iHeight, pt.x + iWidth, pt.y + cyLineHeight);
-											if( iHeight < cyLineHeight ) { 
-												rcImage.bottom -= (cyLineHeight - iHeight) / 2;
-												rcImage.top = rcImage.bottom -  iHeight;
-											}
-											CDuiRect rcBmpPart(0, 0, iWidth, iHeight);
-											rcBmpPart.left = iWidth * iImageListIndex;
-											rcBmpPart.right = iWidth * (iImageListIndex + 1);
-											CDuiRect rcCorner(0, 0, 0, 0);
-											DrawImage(hDC, pImageInfo->hBitmap, rcImage, rcImage, rcBmpPart, rcCorner, \
-												pImageInfo->bAlpha, 255);
-										}
-
-										cyLine = MAX(iHeight, cyLine);
-										pt.x += iWidth;
-										cyMinHeight = pt.y + iHeight;
-										cxMaxWidth = MAX(cxMaxWidth, pt.x);
-									}
-								}
-								else pstrNextStart = NULL;
-							}
-						}
-						break;
-					case _T('n'):  // Newline
-						{
-							pstrText++;
-							if( (uStyle & DT_SINGLELINE) != 0 ) break;
-							bLineEnd = true;
-						}
-						break;
-					case _T('p'):  // Paragraph
-						{
-							pstrText++;
-							if( pt.x > rc.left ) bLineEnd = true;
-							while( *pstrText > _T('\0') && *pstrText <= _T(' ') ) pstrText = ::CharNext(pstrText);
-							int cyLineExtra = (int)_tcstol(pstrText, const_cast<LPTSTR*>(&pstrText), 10);
-							aPIndentArray.Add((LPVOID)cyLineExtra);
-							cyLine = MAX(cyLine, pTm->tmHeight + pTm->tmExternalLeading + cyLineExtra);
-						}
-						break;
-					case _T('r'):  // Raw Text
-						{
-							pstrText++;
-							bInRaw = true;
-						}
-						break;
-					case _T('s'):  // Selected text background color
-						{
-							pstrText++;
-							bInSelected = !bInSelected;
-							if( bDraw && bLineDraw ) {
-								if( bInSelected ) ::SetBkMode(hDC, OPAQUE);
-								else ::SetBkMode(hDC, TRANSPARENT);
-							}
-						}
-						break;
-					case _T('u'):  // Underline text
-						{
-							pstrText++;
-							TFontInfo* pFontInfo = pManager->GetDefaultFontInfo();
-							if( aFontArray.GetSize() > 0 ) pFontInfo = (TFontInfo*)aFontArray.GetAt(aFontArray.GetSize() - 1);
-							if( pFontInfo->bUnderline == false ) {
-								HFONT hFont = pManager->GetFont(pFontInfo->sFontName, pFontInfo->iSize, pFontInfo->bBold, true, pFontInfo->bItalic);
-								if( hFont == NULL ) hFont = pManager->AddFont(g_iFontID, pFontInfo->sFontName, pFontInfo->iSize, pFontInfo->bBold, true, pFontInfo->bItalic);
-								pFontInfo = pManager->GetFontInfo(hFont);
-								aFontArray.Add(pFontInfo);
-								pTm = &pFontInfo->tm;
-								::SelectObject(hDC, pFontInfo->hFont);
-								cyLine = MAX(cyLine, pTm->tmHeight + pTm->tmExternalLeading + (int)aPIndentArray.GetAt(aPIndentArray.GetSize() - 1));
-							}
-						}
-						break;
-					case _T('x'):  // X Indent
-						{
-							pstrText++;
-							while( *pstrText > _T('\0') && *pstrText <= _T(' ') ) pstrText = ::CharNext(pstrText);
-							int iWidth = (int) _tcstol(pstrText, const_cast<LPTSTR*>(&pstrText), 10);
-							pt.x += iWidth;
-							cxMaxWidth = MAX(cxMaxWidth, pt.x);
-						}
-						break;
-					case _T('y'):  // Y Indent
-						{
-							pstrText++;
-							while( *pstrText > _T('\0') && *pstrText <= _T(' ') ) pstrText = ::CharNext(pstrText);
-							cyLine = (int) _tcstol(pstrText, const_cast<LPTSTR*>(&pstrText), 10);
-						}
-						break;
-					}
-					if( pstrNextStart != NULL ) pstrText = pstrNextStart;
-					else {
-						while( *pstrText != _T('\0') && *pstrText != _T('>') && *pstrText != _T('}') ) pstrText = ::CharNext(pstrText);
-						pstrText = ::CharNext(pstrText);
-					}
-			}
-			else if( !bInRaw && ( *pstrText == _T('<') || *pstrText == _T('{') ) && pstrText[1] == _T('/') )
-			{
-				pstrText++;
-				pstrText++;
-				switch( *pstrText )
-				{
-				case _T('c'):
-					{
-						pstrText++;
-						aColorArray.Remove(aColorArray.GetSize() - 1);
-						DWORD clrColor = dwTextColor;
-						if( aColorArray.GetSize() > 0 ) clrColor = (int)aColorArray.GetAt(aColorArray.GetSize() - 1);
-						::SetTextColor(hDC, RGB(GetBValue(clrColor), GetGValue(clrColor), GetRValue(clrColor)));
-					}
-					break;
-				case _T('p'):
-					pstrText++;
-					if( pt.x > rc.left ) bLineEnd = true;
-					aPIndentArray.Remove(aPIndentArray.GetSize() - 1);
-					cyLine = MAX(cyLine, pTm->tmHeight + pTm->tmExternalLeading + (int)aPIndentArray.GetAt(aPIndentArray.GetSize() - 1));
-					break;
-				case _T('s'):
-					{
-						pstrText++;
-						bInSelected = !bInSelected;
-						if( bDraw && bLineDraw ) {
-							if( bInSelected ) ::SetBkMode(hDC, OPAQUE);
-							else ::SetBkMode(hDC, TRANSPARENT);
-						}
-					}
-					break;
-				case _T('a'):
-					{
-						if( iLinkIndex < nLinkRects ) {
-							if( !bLineDraw ) ::SetRect(&prcLinks[iLinkIndex], ptLinkStart.x, ptLinkStart.y, MIN(pt.x, rc.right), pt.y + pTm->tmHeight + pTm->tmExternalLeading);
-							iLinkIndex++;
-						}
-						aColorArray.Remove(aColorArray.GetSize() - 1);
-						DWORD clrColor = dwTextColor;
-						if( aColorArray.GetSize() > 0 ) clrColor = (int)aColorArray.GetAt(aColorArray.GetSize() - 1);
-						::SetTextColor(hDC, RGB(GetBValue(clrColor), GetGValue(clrColor), GetRValue(clrColor)));
-						bInLink = false;
-					}
-				case _T('b'):
-				case _T('f'):
-				case _T('i'):
-				case _T('u'):
-					{
-						pstrText++;
-						aFontArray.Remove(aFontArray.GetSize() - 1);
-						TFontInfo* pFontInfo = (TFontInfo*)aFontArray.GetAt(aFontArray.GetSize() - 1);
-						if( pFontInfo == NULL ) pFontInfo = pManager->GetDefaultFontInfo();
-						if( pTm->tmItalic && pFontInfo->bItalic == false ) {
-							ABC abc;
-							::GetCharABCWidths(hDC, _T(' '), _T(' '), &abc);
-							pt.x += abc.abcC / 2; // һбŵ, ȷӦhttp://support.microsoft.com/kb/244798/en-us
-						}
-						pTm = &pFontInfo->tm;
-						::SelectObject(hDC, pFontInfo->hFont);
-						cyLine = MAX(cyLine, pTm->tmHeight + pTm->tmExternalLeading + (int)aPIndentArray.GetAt(aPIndentArray.GetSize() - 1));
-					}
-					break;
-				}
-				while( *pstrText != _T('\0') && *pstrText != _T('>') && *pstrText != _T('}') ) pstrText = ::CharNext(pstrText);
-				pstrText = ::CharNext(pstrText);
-			}
-			else if( !bInRaw &&  *pstrText == _T('<') && pstrText[2] == _T('>') && (pstrText[1] == _T('{')  || pstrText[1] == _T('}')) )
-			{
-				SIZE szSpace = { 0 };
-				::GetTextExtentPoint32(hDC, &pstrText[1], 1, &szSpace);
-				if( bDraw && bLineDraw ) ::TextOut(hDC, pt.x, pt.y + cyLineHeight - pTm->tmHeight - pTm->tmExternalLeading, &pstrText[1], 1);
-				pt.x += szSpace.cx;
-				cxMaxWidth = MAX(cxMaxWidth, pt.x);
-				pstrText++;pstrText++;pstrText++;
+		if( prcLinks != NULL ) {
+			for( int i = 0; i < pLayout->GetLinkRectCount(); i++ ) {
+				prcLinks[i] = pLayout->GetLinkRect(i);
+				::OffsetRect(&prcLinks[i], rc.left, rc.top);
 			}
-			else if( !bInRaw &&  *pstrText == _T('{') && pstrText[2] == _T('}') && (pstrText[1] == _T('<')  || pstrText[1] == _T('>')) )
-			{
-				SIZE szSpace = { 0 };
-				::GetTextExtentPoint32(hDC, &pstrText[1], 1, &szSpace);
-				if( bDraw && bLineDraw ) ::TextOut(hDC, pt.x,  pt.y + cyLineHeight - pTm->tmHeight - pTm->tmExternalLeading, &pstrText[1], 1);
-				pt.x += szSpace.cx;
-				cxMaxWidth = MAX(cxMaxWidth, pt.x);
-				pstrText++;pstrText++;pstrText++;
-			}
-			else if( !bInRaw &&  *pstrText == _T(' ') )
-			{
-				SIZE szSpace = { 0 };
-				::GetTextExtentPoint32(hDC, _T(" "), 1, &szSpace);
-				// Still need to paint the space because the font might have
-				// underline formatting.
-				if( bDraw && bLineDraw ) ::TextOut(hDC, pt.x,  pt.y + cyLineHeight - pTm->tmHeight - pTm->tmExternalLeading, _T(" "), 1);
-				pt.x += szSpace.cx;
-				cxMaxWidth = MAX(cxMaxWidth, pt.x);
-				pstrText++;
-			}
-			else
-			{
-				POINT ptPos = pt;
-				int cchChars = 0;
-				int cchSize = 0;
-				int cchLastGoodWord = 0;
-				int cchLastGoodSize = 0;
-				LPCTSTR p = pstrText;
-				LPCTSTR pstrNext;
-				SIZE szText = { 0 };
-				if( !bInRaw && *p == _T('<') || *p == _T('{') ) p++, cchChars++, cchSize++;
-				while( *p != _T('\0') && *p != _T('\n') ) {
-					// This part makes sure that we're word-wrapping if needed or providing support
-					// for DT_END_ELLIPSIS. Unfortunately the GetTextExtentPoint32() call is pretty
-					// slow when repeated so often.
-					// TODO: Rewrite and use GetTextExtentExPoint() instead!
-					if( bInRaw ) {
-						if( ( *p == _T('<') || *p == _T('{') ) && p[1] == _T('/') 
-							&& p[2] == _T('r') && ( p[3] == _T('>') || p[3] == _T('}') ) ) {
-								p += 4;
-								bInRaw = false;
-								break;
-						}
-					}
-					else {
-						if( *p == _T('<') || *p == _T('{') ) break;
-					}
-					pstrNext = ::CharNext(p);
-					cchChars++;
-					cchSize += (int)(pstrNext - p);
-					szText.cx = cchChars * pTm->tmMaxCharWidth;
-					if( pt.x + szText.cx >= rc.right ) {
-						::GetTextExtentPoint32(hDC, pstrText, cchSize, &szText);
-					}
-					if( pt.x + szText.cx > rc.right ) {
-						if( pt.x + szText.cx > rc.right && pt.x != rc.left) {
-							cchChars--;
-							cchSize -= (int)(pstrNext - p);
-						}
-						if( (uStyle & DT_WORDBREAK) != 0 && cchLastGoodWord > 0 ) {
-							cchChars = cchLastGoodWord;
-							cchSize = cchLastGoodSize;                 
-						}
-						if( (uStyle & DT_END_ELLIPSIS) != 0 && cchChars > 0 ) {
-							cchChars -= 1;
-							LPCTSTR pstrPrev = ::CharPrev(pstrText, p);
-							if( cchChars > 0 ) {
-								cchChars -= 1;
-								pstrPrev = ::CharPrev(pstrText, pstrPrev);
-								cchSize -= (int)(p - pstrPrev);
-							}
-							else 
-								cchSize -= (int)(p - pstrPrev);
-							pt.x = rc.right;
-						}
-						bLineEnd = true;
-						cxMaxWidth = MAX(cxMaxWidth, pt.x);
-						break;
-					}
-					if (!( ( p[0] >= _T('a') && p[0] <= _T('z') ) || ( p[0] >= _T('A') && p[0] <= _T('Z') ) )) {
-						cchLastGoodWord = cchChars;
-						cchLastGoodSize = cchSize;
-					}
-					if( *p == _T(' ') ) {
-						cchLastGoodWord = cchChars;
-						cchLastGoodSize = cchSize;
-					}
-					p = ::CharNext(p);
+		}
+		if( sLinks != NULL ) {
+			for( int i = 0; i < pLayout->GetLinkTextCount(); i++ ) sLinks[i] = pLayout->GetLinkText(i);
+		}
+		nLinkRects = pLayout->GetLinkCount();
+
+		if( bDraw ) {
+			// building measured on this DC, so nothing is known about what it has selected
+			LPVOID hFont = NULL;
+			DWORD dwColor = dwTextColor;
+			bool bOpaque = false;
+			for( int i = 0; i < pLayout->GetRunCount(); i++ ) {
+				const CHtmlLayout::TRun& run = pLayout->GetRun(i);
+				if( run.iKind == CHtmlLayout::RUN_IMAGE ) {
+					const TImageInfo* pImageInfo = pManager->GetImageEx(pLayout->GetChars(run.iText), pLayout->GetChars(run.iType));
+					if( pImageInfo == NULL ) continue;
+					CDuiRect rcImage(run.rc);
+					rcImage.Offset(rc.left, rc.top);
+					CDuiRect rcCorner(0, 0, 0, 0);
+					DrawImage(hDC, pImageInfo->hBitmap, rcImage, rcImage, run.rcSource, rcCorner, pImageInfo->bAlpha, 255);
+					continue;
 				}
-
-				::GetTextExtentPoint32(hDC, pstrText, cchSize, &szText);
-				if( bDraw && bLineDraw ) {
-					if( (uStyle & DT_SINGLELINE) == 0 && (uStyle & DT_CENTER) != 0 ) {
-						ptPos.x += (rc.right - rc.left - szText.cx)/2;
-					}
-					else if( (uStyle & DT_SINGLELINE) == 0 && (uStyle & DT_RIGHT) != 0) {
-						ptPos.x += (rc.right - rc.left - szText.cx);
-					}
-					::TextOut(hDC, ptPos.x, ptPos.y + cyLineHeight - pTm->tmHeight - pTm->tmExternalLeading, pstrText, cchSize);
-					if( pt.x >= rc.right && (uStyle & DT_END_ELLIPSIS) != 0 ) 
-						::TextOut(hDC, ptPos.x + szText.cx, ptPos.y, _T("..."), 3);
+				if( run.hFont != hFont ) {
+					hFont = run.hFont;
+					::SelectObject(hDC, static_cast<TFontInfo*>(hFont)->hFont);
 				}
-				pt.x += szText.cx;
-				cxMaxWidth = MAX(cxMaxWidth, pt.x);
-				pstrText += cchSize;
-			}
-
-			if( pt.x >= rc.right || *pstrText == _T('\n') || *pstrText == _T('\0') ) bLineEnd = true;
-			if( bDraw && bLineEnd ) {
-				if( !bLineDraw ) {
-					aFontArray.Resize(aLineFontArray.GetSize());
-					::CopyMemory(aFontArray.GetData(), aLineFontArray.GetData(), aLineFontArray.GetSize() * sizeof(LPVOID));
-					aColorArray.Resize(aLineColorArray.GetSize());
-					::CopyMemory(aColorArray.GetData(), aLineColorArray.GetData(), aLineColorArray.GetSize() * sizeof(LPVOID));
-					aPIndentArray.Resize(aLinePIndentArray.GetSize());
-					::CopyMemory(aPIndentArray.GetData(), aLinePIndentArray.GetData(), aLinePIndentArray.GetSize() * sizeof(LPVOID));
-
-					cyLineHeight = cyLine;
-					pstrText = pstrLineBegin;
-					bInRaw = bLineInRaw;
-					bInSelected = bLineInSelected;
-
-					DWORD clrColor = dwTextColor;
-					if( aColorArray.GetSize() > 0 ) clrColor = (int)aColorArray.GetAt(aColorArray.GetSize() - 1);
-					::SetTextColor(hDC, RGB(GetBValue(clrColor), GetGValue(clrColor), GetRValue(clrColor)));
-					TFontInfo* pFontInfo = (TFontInfo*)aFontArray.GetAt(aFontArray.GetSize() - 1);
-					if( pFontInfo == NULL ) pFontInfo = pManager->GetDefaultFontInfo();
-					pTm = &pFontInfo->tm;
-					::SelectObject(hDC, pFontInfo->hFont);
-					if( bInSelected ) ::SetBkMode(hDC, OPAQUE);
+				if( run.dwColor != dwColor ) {
+					dwColor = run.dwColor;
+					::SetTextColor(hDC, RGB(GetBValue(dwColor), GetGValue(dwColor), GetRValue(dwColor)));
 				}
-				else {
-					aLineFontArray.Resize(aFontArray.GetSize());
-					::CopyMemory(aLineFontArray.GetData(), aFontArray.GetData(), aFontArray.GetSize() * sizeof(LPVOID));
-					aLineColorArray.Resize(aColorArray.GetSize());
-					::CopyMemory(aLineColorArray.GetData(), aColorArray.GetData(), aColorArray.GetSize() * sizeof(LPVOID));
-					aLinePIndentArray.Resize(aPIndentArray.GetSize());
-					::CopyMemory(aLinePIndentArray.GetData(), aPIndentArray.GetData(), aPIndentArray.GetSize() * sizeof(LPVOID));
-					pstrLineBegin = pstrText;
-					bLineInSelected = bInSelected;
-					bLineInRaw = bInRaw;
+				if( run.bOpaque != bOpaque ) {
+					bOpaque = run.bOpaque;
+					::SetBkMode(hDC, bOpaque ? OPAQUE : TRANSPARENT);
 				}
+				::TextOut(hDC, rc.left + run.rc.left, rc.top + run.rc.top, pLayout->GetChars(run.iText), run.cchText);
 			}
-
-			ASSERT(iLinkIndex<=nLinkRects);
 		}
 
-		nLinkRects = iLinkIndex;
-
 		// Return size of text when requested
-		if( (uStyle & DT_CALCRECT) != 0 ) {
-			rc.bottom = MAX(cyMinHeight, pt.y + cyLine);
-			rc.right = MIN(rc.right, cxMaxWidth);
-		}
+		if( (uStyle & DT_CALCRECT) != 0 ) pLayout->GetCalcRect(rc);
+		delete pUncached;
 
 		if( bDraw ) ::SelectClipRgn(hDC, hOldRgn);
 		::DeleteObject(hOldRgn);
@@ -2443,15 +1981,7 @@ namespace DuiLib {
 
 	void CRenderEngine::RestoreAlphaColor(LPBYTE pBits, int bitsWidth, PRECT rc)
 	{
-		for (int i = rc->top; i < rc->bottom; ++i)
-		{
-			for (int j = rc->left; j < rc->right; ++j)
-			{
-				int x = (i*bitsWidth + j) * 4;
-				if ((pBits[x + 3] == 0) && (pBits[x + 0] != 0 || pBits[x + 1] != 0 || pBits[x + 2] != 0))
-					pBits[x + 3] = 255;
-			}
-		}
+		CPixelKernel::RestoreAlpha((DWORD*)pBits, bitsWidth, *rc);
 	}
 
 	HBITMAP CRenderEngine::CreateARGB32Bitmap(HDC hDC, int cx, int cy, BYTE** pBits)
@@ -2479,25 +2009,71 @@ namespace DuiLib {
 
 	void CRenderEngine::AdjustImage(bool bUseHSL, TImageInfo* imageInfo, short H, short S, short L)
 	{
-		if( imageInfo == NULL || imageInfo->bUseHSL == false || imageInfo->hBitmap == NULL || 
-			imageInfo->pBits == NULL || imageInfo->pSrcBits == NULL ) 
-			return;
-		if( bUseHSL == false || (H == 180 && S == 100 && L == 100)) {
-			::CopyMemory(imageInfo->pBits, imageInfo->pSrcBits, imageInfo->nX * imageInfo->nY * 4);
-			return;
+		AdjustImages(bUseHSL, &imageInfo, 1, H, S, L);
+	}
+
+	typedef struct tagTHSLRun
+	{
+		const DWORD* pSrc;
+		DWORD* pDst;
+		int nPixels;
+	} THSLRun;
+
+	typedef struct tagTHSLJob
+	{
+		std::vector<THSLRun> aRuns;
+		std::atomic<size_t> nNext;
+		short H;
+		short S;
+		short L;
+	} THSLJob;
+
+	static void AdjustRunsHSL(THSLJob* pJob)
+	{
+		for( size_t i = pJob->nNext++; i < pJob->aRuns.size(); i = pJob->nNext++ ) {
+			const THSLRun& run = pJob->aRuns[i];
+			CPixelKernel::AdjustHSL(run.pDst, run.pSrc, run.nPixels, pJob->H, pJob->S, pJob->L);
 		}
+	}
 
-		float fH, fS, fL;
-		float S1 = S / 100.0f;
-		float L1 = L / 100.0f;
-		for( int i = 0; i < imageInfo->nX * imageInfo->nY; i++ ) {
-			RGBtoHSL(*(DWORD*)(imageInfo->pSrcBits + i*4), &fH, &fS, &fL);
-			fH += (H - 180);
-			fH = fH > 0 ? fH : fH + 360; 
-			fS *= S1;
-			fL *= L1;
-			HSLtoRGB((DWORD*)(imageInfo->pBits + i*4), fH, fS, fL);
+	void CRenderEngine::AdjustImages(bool bUseHSL, TImageInfo** ppImageInfo, int nCount, short H, short S, short L)
+	{
+		// The images are cut into runs that every core takes from in turn, so a skin with a few
+		// big backgrounds keeps them all as busy as one with many small images.
+		const int nRunPixels = 64 * 1024;
+		THSLJob job;
+		job.nNext = 0;
+		job.H = H;
+		job.S = S;
+		job.L = L;
+		::GdiFlush();
+		for( int i = 0; i < nCount; i++ ) {
+			TImageInfo* imageInfo = ppImageInfo[i];
+			if( imageInfo == NULL || imageInfo->bUseHSL == false || imageInfo->hBitmap == NULL || 
+				imageInfo->pBits == NULL || imageInfo->pSrcBits == NULL ) 
+				continue;
+			int nPixels = imageInfo->nX * imageInfo->nY;
+			if( bUseHSL == false || (H == 180 && S == 100 && L == 100)) {
+				::CopyMemory(imageInfo->pBits, imageInfo->pSrcBits, nPixels * 4);
+				continue;
+			}
+			for( int nStart = 0; nStart < nPixels; nStart += nRunPixels ) {
+				THSLRun run;
+				run.pSrc = (const DWORD*)imageInfo->pSrcBits + nStart;
+				run.pDst = (DWORD*)imageInfo->pBits + nStart;
+				run.nPixels = MIN(nRunPixels, nPixels - nStart);
+				job.aRuns.push_back(run);
+			}
 		}
+		if( job.aRuns.empty() ) return;
+
+		int nThreads = (int)std::thread::hardware_concurrency();
+		nThreads = CLAMP(nThreads, 1, 8);
+		if( nThreads > (int)job.aRuns.size() ) nThreads = (int)job.aRuns.size();
+		std::vector<std::thread> aThreads;
+		for( int i = 1; i < nThreads; i++ ) aThreads.push_back(std::thread(AdjustRunsHSL, &job));
+		AdjustRunsHSL(&job);
+		for( size_t i = 0; i < aThreads.size(); i++ ) aThreads[i].join();
 	}
 
 } // namespace DuiLib
@@ -34,6 +34,7 @@ namespace DuiLib {
 		static DWORD AdjustColor(DWORD dwColor, short H, short S, short L);
 		static HBITMAP CreateARGB32Bitmap(HDC hDC, int cx, int cy, BYTE** pBits);
 		static void AdjustImage(bool bUseHSL, TImageInfo* imageInfo, short H, short S, short L);
+		static void AdjustImages(bool bUseHSL, TImageInfo** ppImageInfo, int nCount, short H, short S, short L);
 	    static TImageInfo* LoadImage(STRINGorID bitmap, LPCTSTR type = NULL, DWORD mask = 0, HINSTANCE instance = NULL);
 #ifdef USE_XIMAGE_EFFECT
 		static CxImage *LoadGifImageX(STRINGorID bitmap, LPCTSTR type = NULL, DWORD mask = 0);
@@ -41,6 +42,11 @@ namespace DuiLib {
 		static void FreeImage(TImageInfo* bitmap, bool bDelete = true);
 		static TImageInfo* LoadImage(LPCTSTR pStrImage, LPCTSTR type = NULL, DWORD mask = 0, HINSTANCE instance = NULL);
 		static TImageInfo* LoadImage(UINT nID, LPCTSTR type = NULL, DWORD mask = 0, HINSTANCE instance = NULL);
+		// a copy of pImage resampled to cx x cy, as LoadImage would have made it
+		static TImageInfo* ResampleImage(const TImageInfo* pImage, int cx, int cy);
+		// cbMax caps the bitmap as CGifAtlas::Decode does, 0 for no cap
+		static TGifAtlasInfo* LoadGifAtlas(LPCTSTR pStrImage, DWORD mask = 0, size_t cbMax = 0);
+		static void FreeGifAtlas(TGifAtlasInfo* pAtlas);
 
 		static Gdiplus::Image*	GdiplusLoadImage(LPCTSTR pstrPath);
 		static Gdiplus::Image* GdiplusLoadImage(LPVOID pBuf, size_t dwSize);
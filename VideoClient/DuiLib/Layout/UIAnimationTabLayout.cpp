@@ -135,9 +135,9 @@ namespace DuiLib {
 		NeedParentUpdate();
 	}
 
-	void CAnimationTabLayoutUI::SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue)
+	void CAnimationTabLayoutUI::SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue)
 	{
-		if( _tcsicmp(pstrName, _T("animation_direction")) == 0 && _tcsicmp( pstrValue, _T("vertical")) == 0 ) m_bIsVerticalDirection = true; // pstrValue = "vertical" or "horizontal"
-		return CTabLayoutUI::SetAttribute(pstrName, pstrValue);
+		if( nAttr == DUIATTR_ANIMATION_DIRECTION && _tcsicmp( pstrValue, _T("vertical")) == 0 ) m_bIsVerticalDirection = true; // pstrValue = "vertical" or "horizontal"
+		return CTabLayoutUI::SetAttributeById(nAttr, pstrName, pstrValue);
 	}
 } // namespace DuiLib
\ No newline at end of file
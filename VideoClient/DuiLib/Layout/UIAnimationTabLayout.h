@@ -21,7 +21,7 @@ namespace DuiLib
 		virtual void OnAnimationStep(INT nTotalFrame, INT nCurFrame, INT nAnimationID);
 		virtual void OnAnimationStop(INT nAnimationID);
 
-		void SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue);
+		void SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue);
 
 	protected:
 		bool m_bIsVerticalDirection;
@@ -27,12 +27,12 @@ namespace DuiLib
 		}
 	}
 
-	void CChildLayoutUI::SetAttribute( LPCTSTR pstrName, LPCTSTR pstrValue )
+	void CChildLayoutUI::SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue)
 	{
-		if( _tcsicmp(pstrName, _T("xmlfile")) == 0 )
+		if( nAttr == DUIATTR_XMLFILE )
 			SetChildLayoutXML(pstrValue);
 		else
-			CContainerUI::SetAttribute(pstrName,pstrValue);
+			CContainerUI::SetAttributeById(nAttr, pstrName, pstrValue);
 	}
 
 	void CChildLayoutUI::SetChildLayoutXML( DuiLib::CDuiString pXML )
@@ -12,7 +12,7 @@ namespace DuiLib
 		CChildLayoutUI();
 
 		void Init();
-		void SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue);
+		void SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue);
 		void SetChildLayoutXML(CDuiString pXML);
 		CDuiString GetChildLayoutXML();
 		virtual LPVOID GetInterface(LPCTSTR pstrName);
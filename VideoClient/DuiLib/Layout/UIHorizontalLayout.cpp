@@ -34,7 +34,7 @@ namespace DuiLib
 
 		// Adjust for inset
 		RECT m_rcInset = CHorizontalLayoutUI::m_rcInset;
-		GetManager()->GetDPIObj()->Scale(&m_rcInset);
+		if( m_pManager != NULL ) m_pManager->GetDPIObj()->Scale(&m_rcInset);
 		rc.left += m_rcInset.left;
 		rc.top += m_rcInset.top;
 		rc.right -= m_rcInset.right;
@@ -58,6 +58,8 @@ namespace DuiLib
 		int nAdjustables = 0;
 		int cxFixed = 0;
 		int nEstimateNum = 0;
+		// the placing loop asks again, mostly for the same space
+		std::vector<TItemSize> aItemSizes(m_items.GetSize());
 		SIZE szControlAvailable;
 		int iControlMaxWidth = 0;
 		int iControlMaxHeight = 0;
@@ -75,6 +77,8 @@ namespace DuiLib
 			if (szControlAvailable.cx > iControlMaxWidth) szControlAvailable.cx = iControlMaxWidth;
 			if (szControlAvailable.cy > iControlMaxHeight) szControlAvailable.cy = iControlMaxHeight;
 			SIZE sz = pControl->EstimateSize(szControlAvailable);
+			TItemSize itemSize = { szControlAvailable, sz, true };
+			aItemSizes[it1] = itemSize;
 			if( sz.cx == 0 ) {
 				nAdjustables++;
 			}
@@ -127,7 +131,11 @@ namespace DuiLib
 			if (szControlAvailable.cy > iControlMaxHeight) szControlAvailable.cy = iControlMaxHeight;
 			cxFixedRemaining = cxFixedRemaining - (rcPadding.left + rcPadding.right);
 			if (iEstimate > 1) cxFixedRemaining = cxFixedRemaining - m_iChildPadding;
-			SIZE sz = pControl->EstimateSize(szControlAvailable);
+			const TItemSize& itemSize = aItemSizes[it2];
+			SIZE sz = itemSize.sz;
+			if( !itemSize.bValid || itemSize.szAvailable.cx != szControlAvailable.cx || itemSize.szAvailable.cy != szControlAvailable.cy ) {
+				sz = pControl->EstimateSize(szControlAvailable);
+			}
 			if( sz.cx == 0 ) {
 				iAdjustable++;
 				sz.cx = cxExpand;
@@ -158,7 +166,7 @@ namespace DuiLib
 					iPosY -= m_pVerticalScrollBar->GetScrollPos();
 				}
 				RECT rcCtrl = { iPosX + rcPadding.left, iPosY - sz.cy/2, iPosX + sz.cx + rcPadding.left, iPosY + sz.cy - sz.cy/2 };
-				pControl->SetPos(rcCtrl, false);
+				SetItemPos(pControl, rcCtrl);
 			}
 			else if (iChildAlign == DT_BOTTOM) {
 				int iPosY = rc.bottom;
@@ -167,7 +175,7 @@ namespace DuiLib
 					iPosY -= m_pVerticalScrollBar->GetScrollPos();
 				}
 				RECT rcCtrl = { iPosX + rcPadding.left, iPosY - rcPadding.bottom - sz.cy, iPosX + sz.cx + rcPadding.left, iPosY - rcPadding.bottom };
-				pControl->SetPos(rcCtrl, false);
+				SetItemPos(pControl, rcCtrl);
 			}
 			else {
 				int iPosY = rc.top;
@@ -175,7 +183,7 @@ namespace DuiLib
 					iPosY -= m_pVerticalScrollBar->GetScrollPos();
 				}
 				RECT rcCtrl = { iPosX + rcPadding.left, iPosY + rcPadding.top, iPosX + sz.cx + rcPadding.left, iPosY + sz.cy + rcPadding.top };
-				pControl->SetPos(rcCtrl, false);
+				SetItemPos(pControl, rcCtrl);
 			}
 
 			iPosX += sz.cx + m_iChildPadding + rcPadding.left + rcPadding.right;
@@ -221,11 +229,11 @@ namespace DuiLib
 		return m_bImmMode;
 	}
 
-	void CHorizontalLayoutUI::SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue)
+	void CHorizontalLayoutUI::SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue)
 	{
-		if( _tcsicmp(pstrName, _T("sepwidth")) == 0 ) SetSepWidth(_ttoi(pstrValue));
-		else if( _tcsicmp(pstrName, _T("sepimm")) == 0 ) SetSepImmMode(_tcsicmp(pstrValue, _T("true")) == 0);
-		else CContainerUI::SetAttribute(pstrName, pstrValue);
+		if( nAttr == DUIATTR_SEPWIDTH ) SetSepWidth(_ttoi(pstrValue));
+		else if( nAttr == DUIATTR_SEPIMM ) SetSepImmMode(_tcsicmp(pstrValue, _T("true")) == 0);
+		else CContainerUI::SetAttributeById(nAttr, pstrName, pstrValue);
 	}
 
 	void CHorizontalLayoutUI::DoEvent(TEventUI& event)
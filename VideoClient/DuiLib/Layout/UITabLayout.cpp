@@ -130,10 +130,10 @@ namespace DuiLib
 			return SelectItem(iIndex);
 	}
 
-	void CTabLayoutUI::SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue)
+	void CTabLayoutUI::SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue)
 	{
-		if( _tcsicmp(pstrName, _T("selectedid")) == 0 ) SelectItem(_ttoi(pstrValue));
-		return CContainerUI::SetAttribute(pstrName, pstrValue);
+		if( nAttr == DUIATTR_SELECTEDID ) SelectItem(_ttoi(pstrValue));
+		return CContainerUI::SetAttributeById(nAttr, pstrName, pstrValue);
 	}
 
 	void CTabLayoutUI::SetPos(RECT rc, bool bNeedInvalidate)
@@ -179,7 +179,7 @@ namespace DuiLib
 			if( sz.cy > pControl->GetMaxHeight() ) sz.cy = pControl->GetMaxHeight();
 
 			RECT rcCtrl = { rc.left, rc.top, rc.left + sz.cx, rc.top + sz.cy};
-			pControl->SetPos(rcCtrl);
+			SetItemPos(pControl, rcCtrl, true);
 		}
 	}
 }
@@ -45,17 +45,17 @@ namespace DuiLib
 		NeedUpdate();
 	}
 
-	void CTileLayoutUI::SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue)
+	void CTileLayoutUI::SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue)
 	{
-		if( _tcsicmp(pstrName, _T("itemsize")) == 0 ) {
+		if( nAttr == DUIATTR_ITEMSIZE ) {
 			SIZE szItem = { 0 };
 			LPTSTR pstr = NULL;
 			szItem.cx = _tcstol(pstrValue, &pstr, 10);  ASSERT(pstr);    
 			szItem.cy = _tcstol(pstr + 1, &pstr, 10);   ASSERT(pstr);     
 			SetItemSize(szItem);
 		}
-		else if( _tcsicmp(pstrName, _T("columns")) == 0 ) SetColumns(_ttoi(pstrValue));
-		else CContainerUI::SetAttribute(pstrName, pstrValue);
+		else if( nAttr == DUIATTR_COLUMNS ) SetColumns(_ttoi(pstrValue));
+		else CContainerUI::SetAttributeById(nAttr, pstrName, pstrValue);
 	}
 
 	void CTileLayoutUI::SetPos(RECT rc, bool bNeedInvalidate)
@@ -164,7 +164,7 @@ namespace DuiLib
 			if( szTile.cy > pControl->GetMaxHeight() ) szTile.cy = pControl->GetMaxHeight();
 			RECT rcPos = {(rcTile.left + rcTile.right - szTile.cx) / 2, (rcTile.top + rcTile.bottom - szTile.cy) / 2,
 				(rcTile.left + rcTile.right - szTile.cx) / 2 + szTile.cx, (rcTile.top + rcTile.bottom - szTile.cy) / 2 + szTile.cy};
-			pControl->SetPos(rcPos);
+			SetItemPos(pControl, rcPos, true);
 
 			if( (++iCount % m_nColumns) == 0 ) {
 				ptTile.x = iPosX;
@@ -21,7 +21,7 @@ namespace DuiLib
 		int GetColumns() const;
 		void SetColumns(int nCols);
 
-		void SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue);
+		void SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue);
 
 	protected:
 		SIZE m_szItem;
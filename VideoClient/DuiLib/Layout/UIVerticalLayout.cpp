@@ -34,7 +34,7 @@ namespace DuiLib
 
 		// Adjust for inset
 		RECT m_rcInset = CVerticalLayoutUI::m_rcInset;
-		GetManager()->GetDPIObj()->Scale(&m_rcInset);
+		if( m_pManager != NULL ) m_pManager->GetDPIObj()->Scale(&m_rcInset);
 		rc.left += m_rcInset.left;
 		rc.top += m_rcInset.top;
 		rc.right -= m_rcInset.right;
@@ -58,6 +58,8 @@ namespace DuiLib
 		int nAdjustables = 0;
 		int cyFixed = 0;
 		int nEstimateNum = 0;
+		// the placing loop asks again, mostly for the same space
+		std::vector<TItemSize> aItemSizes(m_items.GetSize());
 		SIZE szControlAvailable;
 		int iControlMaxWidth = 0;
 		int iControlMaxHeight = 0;
@@ -75,6 +77,8 @@ namespace DuiLib
 			if (szControlAvailable.cx > iControlMaxWidth) szControlAvailable.cx = iControlMaxWidth;
 			if (szControlAvailable.cy > iControlMaxHeight) szControlAvailable.cy = iControlMaxHeight;
 			SIZE sz = pControl->EstimateSize(szControlAvailable);
+			TItemSize itemSize = { szControlAvailable, sz, true };
+			aItemSizes[it1] = itemSize;
 			if( sz.cy == 0 ) {
 				nAdjustables++;
 			}
@@ -128,7 +132,11 @@ namespace DuiLib
 			if (szControlAvailable.cy > iControlMaxHeight) szControlAvailable.cy = iControlMaxHeight;
       cyFixedRemaining = cyFixedRemaining - (rcPadding.top + rcPadding.bottom);
 			if (iEstimate > 1) cyFixedRemaining = cyFixedRemaining - m_iChildPadding;
-			SIZE sz = pControl->EstimateSize(szControlAvailable);
+			const TItemSize& itemSize = aItemSizes[it2];
+			SIZE sz = itemSize.sz;
+			if( !itemSize.bValid || itemSize.szAvailable.cx != szControlAvailable.cx || itemSize.szAvailable.cy != szControlAvailable.cy ) {
+				sz = pControl->EstimateSize(szControlAvailable);
+			}
 			if( sz.cy == 0 ) {
 				iAdjustable++;
 				sz.cy = cyExpand;
@@ -159,7 +167,7 @@ namespace DuiLib
 					iPosX -= m_pHorizontalScrollBar->GetScrollPos();
 				}
 				RECT rcCtrl = { iPosX - sz.cx/2, iPosY + rcPadding.top, iPosX + sz.cx - sz.cx/2, iPosY + sz.cy + rcPadding.top };
-				pControl->SetPos(rcCtrl, false);
+				SetItemPos(pControl, rcCtrl);
 			}
 			else if (iChildAlign == DT_RIGHT) {
 				int iPosX = rc.right;
@@ -168,7 +176,7 @@ namespace DuiLib
 					iPosX -= m_pHorizontalScrollBar->GetScrollPos();
 				}
 				RECT rcCtrl = { iPosX - rcPadding.right - sz.cx, iPosY + rcPadding.top, iPosX - rcPadding.right, iPosY + sz.cy + rcPadding.top };
-				pControl->SetPos(rcCtrl, false);
+				SetItemPos(pControl, rcCtrl);
 			}
 			else {
 				int iPosX = rc.left;
@@ -176,7 +184,7 @@ namespace DuiLib
 					iPosX -= m_pHorizontalScrollBar->GetScrollPos();
 				}
 				RECT rcCtrl = { iPosX + rcPadding.left, iPosY + rcPadding.top, iPosX + rcPadding.left + sz.cx, iPosY + sz.cy + rcPadding.top };
-				pControl->SetPos(rcCtrl, false);
+				SetItemPos(pControl, rcCtrl);
 			}
 
 			iPosY += sz.cy + m_iChildPadding + rcPadding.top + rcPadding.bottom;
@@ -222,11 +230,11 @@ namespace DuiLib
 		return m_bImmMode;
 	}
 
-	void CVerticalLayoutUI::SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue)
+	void CVerticalLayoutUI::SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue)
 	{
-		if( _tcsicmp(pstrName, _T("sepheight")) == 0 ) SetSepHeight(_ttoi(pstrValue));
-		else if( _tcsicmp(pstrName, _T("sepimm")) == 0 ) SetSepImmMode(_tcsicmp(pstrValue, _T("true")) == 0);
-		else CContainerUI::SetAttribute(pstrName, pstrValue);
+		if( nAttr == DUIATTR_SEPHEIGHT ) SetSepHeight(_ttoi(pstrValue));
+		else if( nAttr == DUIATTR_SEPIMM ) SetSepImmMode(_tcsicmp(pstrValue, _T("true")) == 0);
+		else CContainerUI::SetAttributeById(nAttr, pstrName, pstrValue);
 	}
 
 	void CVerticalLayoutUI::DoEvent(TEventUI& event)
@@ -51,9 +51,15 @@
 #include "Utils/DragDropImpl.h"
 #include "Utils/TrayIcon.h"
 #include "Utils/DPI.h"
+#include "Utils/ImageCache.h"
+#include "Utils/GifAtlas.h"
 
 #include "Core/UIDefine.h"
 #include "Core/UIResourceManager.h"
+#include "Core/UIHitTest.h"
+#include "Core/UIAnimationClock.h"
+#include "Core/UIHtmlLayout.h"
+#include "Core/UIDamageRegion.h"
 #include "Core/UIManager.h"
 #include "Core/UIBase.h"
 #include "Core/ControlFactory.h"
@@ -62,6 +68,7 @@
 
 #include "Core/UIDlgBuilder.h"
 #include "Core/UIRender.h"
+#include "Core/UIPixel.h"
 #include "Utils/WinImplBase.h"
 
 #include "Layout/UIVerticalLayout.h"
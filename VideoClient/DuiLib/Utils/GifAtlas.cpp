@@ -0,0 +1,118 @@
+#include "StdAfx.h"
+#include "GifAtlas.h"
+#include <algorithm>
+
+// stb_image only gives the first frame of a GIF through its API, so this file builds its own
+// GIF-only copy to get at the frame loop. UIRender.cpp has the one for every other format.
+#define STB_IMAGE_STATIC
+#define STBI_ONLY_GIF
+#define STBI_NO_STDIO
+#define STB_IMAGE_IMPLEMENTATION
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable: 4505)
+#endif
+#include "stb_image.h"
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+namespace DuiLib
+{
+	/////////////////////////////////////////////////////////////////////////////////////
+	//
+	//
+
+	CGifAtlas::CGifAtlas() :
+		m_nX(0),
+		m_nY(0),
+		m_bAlpha(false)
+	{
+	}
+
+	CGifAtlas* CGifAtlas::Decode(const BYTE* pData, int cbData, DWORD dwMask, size_t cbMax)
+	{
+		if( pData == NULL || cbData <= 0 ) return NULL;
+		stbi__context s;
+		stbi__start_mem(&s, pData, cbData);
+		if( !stbi__gif_test(&s) ) return NULL;
+
+		// the decoder state carries a 4096 entry code table, too much for the stack
+		stbi__gif* g = (stbi__gif*)calloc(1, sizeof(stbi__gif));
+		if( g == NULL ) return NULL;
+		CGifAtlas* pAtlas = new CGifAtlas;
+		std::vector<stbi_uc*> aCanvases;
+		for( ;; ) {
+			int nComp = 0;
+			stbi_uc* pFrame = stbi__gif_load_next(&s, g, &nComp, 4);
+			// Every frame is drawn on a new canvas, and stb_image only keeps the current one and
+			// the one "dispose to previous" goes back to. The rest are ours to free.
+			if( g->out != NULL && std::find(aCanvases.begin(), aCanvases.end(), g->out) == aCanvases.end() ) {
+				aCanvases.push_back(g->out);
+			}
+			for( size_t i = 0; i < aCanvases.size(); ) {
+				if( aCanvases[i] != g->out && aCanvases[i] != g->old_out ) {
+					STBI_FREE(aCanvases[i]);
+					aCanvases.erase(aCanvases.begin() + i);
+				}
+				else i++;
+			}
+			if( pFrame == NULL || pFrame == (stbi_uc*)&s || g->w <= 0 || g->h <= 0 ) break;
+
+			int nPixels = g->w * g->h;
+			size_t nFirst = pAtlas->m_aBits.size();
+			if( cbMax > 0 && (nFirst + nPixels) * sizeof(DWORD) > cbMax ) {
+				// a still is better than a strip the size of the whole cache
+				pAtlas->m_aBits.resize(pAtlas->m_aDelays.empty() ? 0 : nPixels);
+				if( pAtlas->m_aDelays.size() > 1 ) pAtlas->m_aDelays.resize(1);
+				break;
+			}
+			pAtlas->m_aBits.resize(nFirst + nPixels);
+			if( CPixelKernel::Premultiply(&pAtlas->m_aBits[nFirst], pFrame, nPixels, dwMask) ) pAtlas->m_bAlpha = true;
+			pAtlas->m_aDelays.push_back(g->delay * 10);
+			pAtlas->m_nX = g->w;
+			pAtlas->m_nY = g->h;
+		}
+		for( size_t i = 0; i < aCanvases.size(); i++ ) STBI_FREE(aCanvases[i]);
+		free(g);
+
+		// a GIF cut short still shows the frames that came before the damage
+		if( pAtlas->m_aDelays.empty() ) {
+			delete pAtlas;
+			return NULL;
+		}
+		return pAtlas;
+	}
+
+	int CGifAtlas::GetWidth() const
+	{
+		return m_nX;
+	}
+
+	int CGifAtlas::GetHeight() const
+	{
+		return m_nY;
+	}
+
+	int CGifAtlas::GetFrameCount() const
+	{
+		return (int)m_aDelays.size();
+	}
+
+	int CGifAtlas::GetDelay(int iFrame) const
+	{
+		if( iFrame < 0 || iFrame >= (int)m_aDelays.size() ) return 0;
+		return m_aDelays[iFrame];
+	}
+
+	bool CGifAtlas::IsAlpha() const
+	{
+		return m_bAlpha;
+	}
+
+	const DWORD* CGifAtlas::GetBits() const
+	{
+		return m_aBits.empty() ? NULL : &m_aBits[0];
+	}
+
+} // namespace DuiLib
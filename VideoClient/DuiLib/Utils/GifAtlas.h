@@ -0,0 +1,44 @@
+#ifndef __GIFATLAS_H__
+#define __GIFATLAS_H__
+
+#pragma once
+#include <vector>
+
+namespace DuiLib
+{
+	/////////////////////////////////////////////////////////////////////////////////////
+	//
+	// Every frame of a GIF, decoded once and composited as the GIF says, in one strip of
+	// premultiplied BGRA pixels: frame i is rows [i * GetHeight(), (i + 1) * GetHeight()).
+	// Nothing in here knows about GDI; the owner turns the strip into a bitmap and draws a
+	// frame by picking its rows.
+
+	class CGifAtlas
+	{
+	public:
+		// NULL if pData isn't a GIF or not even its first frame decodes. A GIF whose frames
+		// together come to more than cbMax bytes keeps only its first, and is NULL if that one
+		// is more too; 0 is no limit.
+		static CGifAtlas* Decode(const BYTE* pData, int cbData, DWORD dwMask = 0, size_t cbMax = 0);
+
+		int GetWidth() const;
+		int GetHeight() const;
+		int GetFrameCount() const;
+		// in milliseconds, as the GIF has it, so 0 for frames that don't say
+		int GetDelay(int iFrame) const;
+		bool IsAlpha() const;
+		const DWORD* GetBits() const;
+
+	private:
+		CGifAtlas();
+
+		std::vector<DWORD> m_aBits;
+		std::vector<int> m_aDelays;
+		int m_nX;
+		int m_nY;
+		bool m_bAlpha;
+	};
+
+} // namespace DuiLib
+
+#endif // __GIFATLAS_H__
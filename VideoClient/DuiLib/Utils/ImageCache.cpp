@@ -0,0 +1,343 @@
+#include "StdAfx.h"
+#include "ImageCache.h"
+#include <algorithm>
+
+namespace DuiLib
+{
+	/////////////////////////////////////////////////////////////////////////////////////
+	//
+	//
+
+	CImageCache::CImageCache(DecodeProc decode, FreeProc free, ReadyProc ready) :
+		m_decode(decode),
+		m_free(free),
+		m_ready(ready),
+		m_bStopping(false),
+		m_nUsers(0),
+		m_cbBudget(64 * 1024 * 1024)
+	{
+		memset(&m_stats, 0, sizeof(m_stats));
+	}
+
+	CImageCache::~CImageCache()
+	{
+		std::unique_lock<std::mutex> lock(m_lock);
+		StopThreads(lock);
+		std::vector<void*> aFree;
+		aFree.swap(m_aDropped);
+		while( !m_mEntries.empty() ) Unlink(m_mEntries.begin(), aFree);
+		lock.unlock();
+		for( size_t i = 0; i < aFree.size(); i++ ) m_free(aFree[i]);
+	}
+
+	CImageCache::Key CImageCache::MakeKey(const Key& sName, unsigned int uParam)
+	{
+		Key sKey = sName;
+		sKey += Key::value_type(0);
+		for( int i = 0; i < 8; i++ ) sKey += Key::value_type('a' + ((uParam >> (i * 4)) & 0xF));
+		return sKey;
+	}
+
+	void* CImageCache::Get(const Key& sName, unsigned int uParam, void* pWaiter)
+	{
+		std::unique_lock<std::mutex> lock(m_lock);
+		Key sKey = MakeKey(sName, uParam);
+		TEntry* pEntry = NULL;
+		bool bJoined = false;
+		while( pEntry == NULL ) {
+			EntryMap::iterator it = m_mEntries.find(sKey);
+			if( it == m_mEntries.end() ) {
+				m_stats.nMisses++;
+				pEntry = new TEntry;
+				pEntry->sName = sName;
+				pEntry->uParam = uParam;
+				pEntry->iState = STATE_QUEUED;
+				pEntry->pImage = NULL;
+				pEntry->cbSize = 0;
+				m_mEntries[sKey] = pEntry;
+				if( pWaiter != NULL && !m_aThreads.empty() ) {
+					pEntry->aWaiters.push_back(pWaiter);
+					m_qQueue.push_back(pEntry);
+					m_cvQueued.notify_one();
+					return NULL;
+				}
+				Decode(lock, pEntry);
+				break;
+			}
+
+			TEntry* pFound = it->second;
+			if( pFound->iState == STATE_READY || pFound->iState == STATE_FAILED ) {
+				if( !bJoined ) m_stats.nHits++;
+				m_lLru.splice(m_lLru.begin(), m_lLru, pFound->itLru);
+				return pFound->pImage;
+			}
+			if( !bJoined ) m_stats.nJoins++;
+			bJoined = true;
+			if( pWaiter != NULL && !m_aThreads.empty() ) {
+				if( std::find(pFound->aWaiters.begin(), pFound->aWaiters.end(), pWaiter) == pFound->aWaiters.end() ) {
+					pFound->aWaiters.push_back(pWaiter);
+				}
+				return NULL;
+			}
+			if( pFound->iState == STATE_QUEUED ) {
+				// not started yet, so decode it here rather than wait behind the rest of the queue
+				m_qQueue.erase(std::find(m_qQueue.begin(), m_qQueue.end(), pFound));
+				pEntry = Decode(lock, pFound);
+			}
+			else m_cvDone.wait(lock);
+		}
+
+		void* pImage = pEntry->pImage;
+		std::vector<void*> aWaiters;
+		aWaiters.swap(pEntry->aWaiters);
+		lock.unlock();
+		Notify(aWaiters);
+		return pImage;
+	}
+
+	void* CImageCache::Find(const Key& sName, unsigned int uParam)
+	{
+		std::unique_lock<std::mutex> lock(m_lock);
+		EntryMap::iterator it = m_mEntries.find(MakeKey(sName, uParam));
+		if( it == m_mEntries.end() || it->second->iState != STATE_READY ) return NULL;
+		m_stats.nHits++;
+		m_lLru.splice(m_lLru.begin(), m_lLru, it->second->itLru);
+		return it->second->pImage;
+	}
+
+	void CImageCache::Prefetch(const Key& sName, unsigned int uParam)
+	{
+		std::unique_lock<std::mutex> lock(m_lock);
+		if( m_aThreads.empty() ) return;
+		Key sKey = MakeKey(sName, uParam);
+		if( m_mEntries.find(sKey) != m_mEntries.end() ) return;
+		m_stats.nMisses++;
+		TEntry* pEntry = new TEntry;
+		pEntry->sName = sName;
+		pEntry->uParam = uParam;
+		pEntry->iState = STATE_QUEUED;
+		pEntry->pImage = NULL;
+		pEntry->cbSize = 0;
+		m_mEntries[sKey] = pEntry;
+		m_qQueue.push_back(pEntry);
+		m_cvQueued.notify_one();
+	}
+
+	void CImageCache::Remove(const Key& sName)
+	{
+		RemoveIf(std::bind(std::equal_to<Key>(), std::placeholders::_1, sName));
+	}
+
+	void CImageCache::RemoveIf(const MatchProc& match)
+	{
+		// every mask of the names; images being decoded are left to finish
+		std::unique_lock<std::mutex> lock(m_lock);
+		for( EntryMap::iterator it = m_mEntries.begin(); it != m_mEntries.end(); ) {
+			EntryMap::iterator itNext = it;
+			++itNext;
+			TEntry* pEntry = it->second;
+			if( (pEntry->iState == STATE_READY || pEntry->iState == STATE_FAILED) && match(pEntry->sName) ) {
+				Unlink(it, m_aDropped);
+			}
+			it = itNext;
+		}
+	}
+
+	void CImageCache::Purge()
+	{
+		std::unique_lock<std::mutex> lock(m_lock);
+		for( EntryMap::iterator it = m_mEntries.begin(); it != m_mEntries.end(); ) {
+			EntryMap::iterator itNext = it;
+			++itNext;
+			if( it->second->iState == STATE_READY || it->second->iState == STATE_FAILED ) Unlink(it, m_aDropped);
+			it = itNext;
+		}
+	}
+
+	void CImageCache::BeginUse()
+	{
+		std::unique_lock<std::mutex> lock(m_lock);
+		m_nUsers++;
+	}
+
+	void CImageCache::EndUse()
+	{
+		std::unique_lock<std::mutex> lock(m_lock);
+		if( m_nUsers > 0 ) m_nUsers--;
+		bool bTrim = (m_nUsers == 0);
+		lock.unlock();
+		if( bTrim ) Trim();
+	}
+
+	void CImageCache::Trim()
+	{
+		std::vector<void*> aFree;
+		std::unique_lock<std::mutex> lock(m_lock);
+		if( m_nUsers > 0 ) return;
+		aFree.swap(m_aDropped);
+		std::list<TEntry*>::iterator it = m_lLru.end();
+		while( m_stats.cbUsed > m_cbBudget && it != m_lLru.begin() ) {
+			TEntry* pEntry = *--it;
+			Key sKey = MakeKey(pEntry->sName, pEntry->uParam);
+			if( m_mPins.find(sKey) != m_mPins.end() ) continue;
+			// step past it first, as Unlink takes it out of the list
+			++it;
+			if( pEntry->iState == STATE_READY ) m_stats.nEvictions++;
+			Unlink(m_mEntries.find(sKey), aFree);
+		}
+		lock.unlock();
+		for( size_t i = 0; i < aFree.size(); i++ ) m_free(aFree[i]);
+	}
+
+	void CImageCache::Pin(const Key& sName, unsigned int uParam)
+	{
+		std::unique_lock<std::mutex> lock(m_lock);
+		m_mPins[MakeKey(sName, uParam)]++;
+	}
+
+	void CImageCache::Unpin(const Key& sName, unsigned int uParam)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_lock);
+			std::unordered_map<Key, int>::iterator it = m_mPins.find(MakeKey(sName, uParam));
+			if( it == m_mPins.end() ) return;
+			if( --it->second > 0 ) return;
+			m_mPins.erase(it);
+		}
+		// what it held may be over the budget now
+		Trim();
+	}
+
+	void CImageCache::SetThreads(int nThreads)
+	{
+		if( nThreads < 0 ) nThreads = 0;
+		if( nThreads > 8 ) nThreads = 8;
+		std::unique_lock<std::mutex> lock(m_lock);
+		StopThreads(lock);
+		for( int i = 0; i < nThreads; i++ ) m_aThreads.push_back(std::thread(&CImageCache::WorkerProc, this));
+	}
+
+	int CImageCache::GetThreads()
+	{
+		std::unique_lock<std::mutex> lock(m_lock);
+		return (int)m_aThreads.size();
+	}
+
+	void CImageCache::SetBudget(size_t cbBudget)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_lock);
+			m_cbBudget = cbBudget;
+		}
+		Trim();
+	}
+
+	size_t CImageCache::GetBudget()
+	{
+		std::unique_lock<std::mutex> lock(m_lock);
+		return m_cbBudget;
+	}
+
+	void CImageCache::GetStats(TImageCacheStats* pStats)
+	{
+		std::unique_lock<std::mutex> lock(m_lock);
+		*pStats = m_stats;
+		pStats->nImages = (unsigned int)m_mEntries.size();
+		pStats->cbBudget = m_cbBudget;
+	}
+
+	void CImageCache::ResetStats()
+	{
+		std::unique_lock<std::mutex> lock(m_lock);
+		size_t cbUsed = m_stats.cbUsed;
+		memset(&m_stats, 0, sizeof(m_stats));
+		m_stats.cbUsed = cbUsed;
+		m_stats.cbPeak = cbUsed;
+	}
+
+	CImageCache::TEntry* CImageCache::Decode(std::unique_lock<std::mutex>& lock, TEntry* pEntry)
+	{
+		pEntry->iState = STATE_DECODING;
+		lock.unlock();
+		size_t cbSize = 0;
+		void* pImage = m_decode(pEntry->sName, pEntry->uParam, &cbSize);
+		lock.lock();
+		Finish(pEntry, pImage, cbSize);
+		return pEntry;
+	}
+
+	void CImageCache::Finish(TEntry* pEntry, void* pImage, size_t cbSize)
+	{
+		pEntry->pImage = pImage;
+		pEntry->cbSize = (pImage != NULL) ? cbSize : 0;
+		pEntry->iState = (pImage != NULL) ? STATE_READY : STATE_FAILED;
+		m_lLru.push_front(pEntry);
+		pEntry->itLru = m_lLru.begin();
+		if( pImage != NULL ) m_stats.nDecodes++;
+		else m_stats.nFailures++;
+		m_stats.cbUsed += pEntry->cbSize;
+		if( m_stats.cbUsed > m_stats.cbPeak ) m_stats.cbPeak = m_stats.cbUsed;
+		m_cvDone.notify_all();
+	}
+
+	void CImageCache::Notify(std::vector<void*>& aWaiters)
+	{
+		if( !m_ready ) return;
+		for( size_t i = 0; i < aWaiters.size(); i++ ) m_ready(aWaiters[i]);
+	}
+
+	void CImageCache::Unlink(EntryMap::iterator it, std::vector<void*>& aFree)
+	{
+		TEntry* pEntry = it->second;
+		if( pEntry->iState == STATE_READY || pEntry->iState == STATE_FAILED ) {
+			m_lLru.erase(pEntry->itLru);
+			m_stats.cbUsed -= pEntry->cbSize;
+		}
+		if( pEntry->pImage != NULL ) aFree.push_back(pEntry->pImage);
+		m_mEntries.erase(it);
+		delete pEntry;
+	}
+
+	void CImageCache::StopThreads(std::unique_lock<std::mutex>& lock)
+	{
+		if( m_aThreads.empty() ) return;
+		std::vector<std::thread> aThreads;
+		aThreads.swap(m_aThreads);
+		m_bStopping = true;
+		m_cvQueued.notify_all();
+		lock.unlock();
+		for( size_t i = 0; i < aThreads.size(); i++ ) aThreads[i].join();
+		lock.lock();
+		m_bStopping = false;
+
+		// whatever is still queued is dropped, and its waiters are told so they ask again
+		std::vector<void*> aWaiters;
+		while( !m_qQueue.empty() ) {
+			TEntry* pEntry = m_qQueue.front();
+			m_qQueue.pop_front();
+			aWaiters.insert(aWaiters.end(), pEntry->aWaiters.begin(), pEntry->aWaiters.end());
+			Unlink(m_mEntries.find(MakeKey(pEntry->sName, pEntry->uParam)), m_aDropped);
+		}
+		lock.unlock();
+		Notify(aWaiters);
+		lock.lock();
+	}
+
+	void CImageCache::WorkerProc()
+	{
+		std::unique_lock<std::mutex> lock(m_lock);
+		for( ;; ) {
+			while( !m_bStopping && m_qQueue.empty() ) m_cvQueued.wait(lock);
+			if( m_bStopping ) break;
+			TEntry* pEntry = m_qQueue.front();
+			m_qQueue.pop_front();
+			Decode(lock, pEntry);
+			std::vector<void*> aWaiters;
+			aWaiters.swap(pEntry->aWaiters);
+			lock.unlock();
+			Notify(aWaiters);
+			lock.lock();
+		}
+	}
+
+} // namespace DuiLib
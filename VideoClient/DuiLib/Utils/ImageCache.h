@@ -0,0 +1,132 @@
+#ifndef __IMAGECACHE_H__
+#define __IMAGECACHE_H__
+
+#pragma once
+#include <string>
+#include <list>
+#include <deque>
+#include <vector>
+#include <unordered_map>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace DuiLib
+{
+	/////////////////////////////////////////////////////////////////////////////////////
+	//
+
+	typedef struct tagTImageCacheStats
+	{
+		unsigned int nHits;         // found decoded, or found to be missing
+		unsigned int nMisses;       // had to be decoded
+		unsigned int nJoins;        // asked for while another request was decoding it
+		unsigned int nDecodes;
+		unsigned int nFailures;
+		unsigned int nEvictions;
+		unsigned int nImages;
+		size_t cbUsed;
+		size_t cbPeak;
+		size_t cbBudget;
+	} TImageCacheStats;
+
+	/////////////////////////////////////////////////////////////////////////////////////
+	//
+	// Decoded images keyed by name and a caller value (the colour mask), shared by every
+	// paint manager. Nothing in here knows about GDI: the owner says how an image is decoded
+	// and freed, and how a window that asked for one is told it has arrived.
+	//
+	// Get decodes on the calling thread, or with a waiter queues the decode for the worker
+	// threads and returns NULL; ReadyProc is called with the waiter once it is done. Requests
+	// for a key already being decoded wait for that decode instead of starting another.
+	//
+	// Images are only freed by Trim, which runs when the last BeginUse is balanced by EndUse:
+	// the least recently used go first until the total is back under the budget. So an image
+	// from Get stays valid until then, and for the whole pass between BeginUse and EndUse.
+	// Pinned images are passed over by Trim, and still count against the budget.
+
+	class CImageCache
+	{
+	public:
+#ifdef _UNICODE
+		typedef std::wstring Key;
+#else
+		typedef std::string Key;
+#endif
+		typedef std::function<void* (const Key& sName, unsigned int uParam, size_t* pcbSize)> DecodeProc;
+		typedef std::function<void (void* pImage)> FreeProc;
+		typedef std::function<void (void* pWaiter)> ReadyProc;
+		typedef std::function<bool (const Key& sName)> MatchProc;
+
+		CImageCache(DecodeProc decode, FreeProc free, ReadyProc ready = ReadyProc());
+		~CImageCache();
+
+		void* Get(const Key& sName, unsigned int uParam, void* pWaiter = NULL);
+		void* Find(const Key& sName, unsigned int uParam);
+		void Prefetch(const Key& sName, unsigned int uParam);
+		void Remove(const Key& sName);
+		// every name match says yes to, as Remove
+		void RemoveIf(const MatchProc& match);
+		void Purge();
+
+		void BeginUse();
+		void EndUse();
+		void Trim();
+		// A pin is on the name and value, not the image, so it also holds the image decoded
+		// again after Remove or Purge. Pins are counted; each Pin wants its own Unpin.
+		void Pin(const Key& sName, unsigned int uParam);
+		void Unpin(const Key& sName, unsigned int uParam);
+
+		void SetThreads(int nThreads);
+		int GetThreads();
+		void SetBudget(size_t cbBudget);
+		size_t GetBudget();
+		void GetStats(TImageCacheStats* pStats);
+		void ResetStats();
+
+	private:
+		enum { STATE_QUEUED, STATE_DECODING, STATE_READY, STATE_FAILED };
+
+		struct TEntry
+		{
+			Key sName;
+			unsigned int uParam;
+			int iState;
+			void* pImage;
+			size_t cbSize;
+			std::list<TEntry*>::iterator itLru;
+			std::vector<void*> aWaiters;
+		};
+		typedef std::unordered_map<Key, TEntry*> EntryMap;
+
+		static Key MakeKey(const Key& sName, unsigned int uParam);
+		TEntry* Decode(std::unique_lock<std::mutex>& lock, TEntry* pEntry);
+		void Finish(TEntry* pEntry, void* pImage, size_t cbSize);
+		void Notify(std::vector<void*>& aWaiters);
+		void Unlink(EntryMap::iterator it, std::vector<void*>& aFree);
+		void StopThreads(std::unique_lock<std::mutex>& lock);
+		void WorkerProc();
+
+		DecodeProc m_decode;
+		FreeProc m_free;
+		ReadyProc m_ready;
+
+		std::mutex m_lock;
+		std::condition_variable m_cvQueued;
+		std::condition_variable m_cvDone;
+		EntryMap m_mEntries;
+		std::list<TEntry*> m_lLru;
+		std::unordered_map<Key, int> m_mPins;
+		std::deque<TEntry*> m_qQueue;
+		std::vector<void*> m_aDropped;
+		std::vector<std::thread> m_aThreads;
+		bool m_bStopping;
+		int m_nUsers;
+		size_t m_cbBudget;
+		TImageCacheStats m_stats;
+	};
+
+} // namespace DuiLib
+
+#endif // __IMAGECACHE_H__
@@ -517,28 +517,20 @@ void CShadowUI::MakeShadow(UINT32 *pShadBits, HWND hParent, RECT *rcParent)
 		i < max(szShadow.cy - nKernelSize, min(szParent.cy + m_nSize - m_nyOffset, szParent.cy + 2 * m_nSize));
 		i++)
 	{
-		UINT32 *pLine = pShadBits + (szShadow.cy - i - 1) * szShadow.cx;
+		DWORD *pLine = (DWORD*)pShadBits + (szShadow.cy - i - 1) * szShadow.cx;
 		if(i - m_nSize + m_nyOffset < 0 || i - m_nSize + m_nyOffset >= szParent.cy)	// Line is not covered by parent window
 		{
-			for(int j = ptAnchors[i][0]; j < ptAnchors[i][1]; j++)
-			{
-				*(pLine + j) = clCenter;
-			}
+			CPixelKernel::Fill(pLine + ptAnchors[i][0], ptAnchors[i][1] - ptAnchors[i][0], clCenter);
 		}
 		else
 		{
-			for(int j = ptAnchors[i][0];
-				j < min(ptAnchorsOri[i - m_nSize + m_nyOffset][0] + m_nSize - m_nxOffset, ptAnchors[i][1]);
-				j++)
-				*(pLine + j) = clCenter;
-			for(int j = max(ptAnchorsOri[i - m_nSize + m_nyOffset][0] + m_nSize - m_nxOffset, 0);
-				j < min(ptAnchorsOri[i - m_nSize + m_nyOffset][1] + m_nSize - m_nxOffset, szShadow.cx);
-				j++)
-				*(pLine + j) = 0;
-			for(int j = max(ptAnchorsOri[i - m_nSize + m_nyOffset][1] + m_nSize - m_nxOffset, ptAnchors[i][0]);
-				j < ptAnchors[i][1];
-				j++)
-				*(pLine + j) = clCenter;
+			int nLeft = ptAnchorsOri[i - m_nSize + m_nyOffset][0] + m_nSize - m_nxOffset;
+			int nRight = ptAnchorsOri[i - m_nSize + m_nyOffset][1] + m_nSize - m_nxOffset;
+			int nEnd = min(nLeft, ptAnchors[i][1]);
+			CPixelKernel::Fill(pLine + ptAnchors[i][0], nEnd - ptAnchors[i][0], clCenter);
+			nEnd = min(nRight, szShadow.cx);
+			CPixelKernel::Fill(pLine + max(nLeft, 0), nEnd - max(nLeft, 0), 0);
+			CPixelKernel::Fill(pLine + max(nRight, ptAnchors[i][0]), ptAnchors[i][1] - max(nRight, ptAnchors[i][0]), clCenter);
 		}
 	}
 
@@ -350,6 +350,156 @@ namespace DuiLib
 	}
 
 
+	/////////////////////////////////////////////////////////////////////////////////////
+	//
+	//
+
+	CStdIndexSet::CStdIndexSet() : m_aRanges(NULL), m_nRanges(0), m_nAllocated(0), m_nCount(0)
+	{
+	}
+
+	CStdIndexSet::~CStdIndexSet()
+	{
+		if( m_aRanges != NULL ) free(m_aRanges);
+	}
+
+	void CStdIndexSet::Empty()
+	{
+		m_nRanges = 0;  // NOTE: We keep the memory in place
+		m_nCount = 0;
+	}
+
+	bool CStdIndexSet::IsEmpty() const
+	{
+		return m_nCount == 0;
+	}
+
+	int CStdIndexSet::Lookup(int iIndex) const
+	{
+		// the first range that ends at or after iIndex
+		int iLow = 0, iHigh = m_nRanges;
+		while( iLow < iHigh ) {
+			int iMid = (iLow + iHigh) / 2;
+			if( m_aRanges[iMid].iLast < iIndex ) iLow = iMid + 1;
+			else iHigh = iMid;
+		}
+		return iLow;
+	}
+
+	bool CStdIndexSet::Find(int iIndex) const
+	{
+		int iRange = Lookup(iIndex);
+		return iRange < m_nRanges && m_aRanges[iRange].iFirst <= iIndex;
+	}
+
+	bool CStdIndexSet::InsertRange(int iRange, int iFirst, int iLast)
+	{
+		if( m_nRanges >= m_nAllocated ) {
+			int nAllocated = m_nAllocated * 2;
+			if( nAllocated == 0 ) nAllocated = 4;
+			TRANGE* aRanges = static_cast<TRANGE*>(realloc(m_aRanges, nAllocated * sizeof(TRANGE)));
+			if( aRanges == NULL ) return false;
+			m_nAllocated = nAllocated;
+			m_aRanges = aRanges;
+		}
+		if( iRange < m_nRanges ) ::MoveMemory(m_aRanges + iRange + 1, m_aRanges + iRange, (m_nRanges - iRange) * sizeof(TRANGE));
+		m_aRanges[iRange].iFirst = iFirst;
+		m_aRanges[iRange].iLast = iLast;
+		m_nRanges++;
+		return true;
+	}
+
+	bool CStdIndexSet::Add(int iIndex)
+	{
+		return AddRange(iIndex, iIndex);
+	}
+
+	bool CStdIndexSet::AddRange(int iFirst, int iLast)
+	{
+		if( iFirst < 0 || iFirst > iLast ) return false;
+		// the ranges that overlap or touch [iFirst, iLast] become one
+		int iRange = Lookup(iFirst - 1);
+		int iEnd = iRange;
+		while( iEnd < m_nRanges && m_aRanges[iEnd].iFirst - 1 <= iLast ) iEnd++;
+		if( iEnd == iRange ) {
+			if( !InsertRange(iRange, iFirst, iLast) ) return false;
+			m_nCount += iLast - iFirst + 1;
+			return true;
+		}
+		int nCovered = 0;
+		for( int i = iRange; i < iEnd; i++ ) nCovered += m_aRanges[i].iLast - m_aRanges[i].iFirst + 1;
+		if( m_aRanges[iRange].iFirst < iFirst ) iFirst = m_aRanges[iRange].iFirst;
+		if( m_aRanges[iEnd - 1].iLast > iLast ) iLast = m_aRanges[iEnd - 1].iLast;
+		m_aRanges[iRange].iFirst = iFirst;
+		m_aRanges[iRange].iLast = iLast;
+		if( iEnd < m_nRanges ) ::MoveMemory(m_aRanges + iRange + 1, m_aRanges + iEnd, (m_nRanges - iEnd) * sizeof(TRANGE));
+		m_nRanges -= iEnd - iRange - 1;
+		int nAdded = iLast - iFirst + 1 - nCovered;
+		m_nCount += nAdded;
+		return nAdded > 0;
+	}
+
+	bool CStdIndexSet::Remove(int iIndex)
+	{
+		int iRange = Lookup(iIndex);
+		if( iRange >= m_nRanges || m_aRanges[iRange].iFirst > iIndex ) return false;
+		TRANGE& range = m_aRanges[iRange];
+		if( range.iFirst == iIndex && range.iLast == iIndex ) {
+			if( iRange < m_nRanges - 1 ) ::MoveMemory(m_aRanges + iRange, m_aRanges + iRange + 1, (m_nRanges - iRange - 1) * sizeof(TRANGE));
+			m_nRanges--;
+		}
+		else if( range.iFirst == iIndex ) range.iFirst++;
+		else if( range.iLast == iIndex ) range.iLast--;
+		else {
+			// split in two; InsertRange may move the ranges, so keep no reference across it
+			int iLast = range.iLast;
+			range.iLast = iIndex - 1;
+			if( !InsertRange(iRange + 1, iIndex + 1, iLast) ) {
+				m_aRanges[iRange].iLast = iLast;
+				return false;
+			}
+		}
+		m_nCount--;
+		return true;
+	}
+
+	void CStdIndexSet::RemoveFrom(int iIndex)
+	{
+		int iRange = Lookup(iIndex);
+		for( int i = iRange; i < m_nRanges; i++ ) m_nCount -= m_aRanges[i].iLast - m_aRanges[i].iFirst + 1;
+		// the range iIndex falls in keeps what comes before it
+		if( iRange < m_nRanges && m_aRanges[iRange].iFirst < iIndex ) {
+			m_aRanges[iRange].iLast = iIndex - 1;
+			m_nCount += iIndex - m_aRanges[iRange].iFirst;
+			iRange++;
+		}
+		m_nRanges = iRange;
+	}
+
+	int CStdIndexSet::GetSize() const
+	{
+		return m_nCount;
+	}
+
+	int CStdIndexSet::GetFirst() const
+	{
+		return m_nRanges > 0 ? m_aRanges[0].iFirst : -1;
+	}
+
+	int CStdIndexSet::GetLast() const
+	{
+		return m_nRanges > 0 ? m_aRanges[m_nRanges - 1].iLast : -1;
+	}
+
+	int CStdIndexSet::GetNext(int iIndex) const
+	{
+		// the first index after iIndex, in its own range or at the start of the next one
+		int iRange = Lookup(iIndex + 1);
+		if( iRange >= m_nRanges ) return -1;
+		return m_aRanges[iRange].iFirst > iIndex + 1 ? m_aRanges[iRange].iFirst : iIndex + 1;
+	}
+
+
 	/////////////////////////////////////////////////////////////////////////////////////
 	//
 	//
@@ -780,9 +930,8 @@ namespace DuiLib
 
 	static UINT HashKey(LPCTSTR Key)
 	{
-		UINT i = 0;
-		SIZE_T len = _tcslen(Key);
-		while( len-- > 0 ) i = (i << 5) + i + Key[len];
+		UINT i = 5381;
+		while( *Key ) i = (i << 5) + i + (UINT)*Key++;
 		return i;
 	}
 
@@ -791,175 +940,182 @@ namespace DuiLib
 		return HashKey((LPCTSTR)Key);
 	};
 
-	CStdStringPtrMap::CStdStringPtrMap(int nSize) : m_nCount(0)
+	static int SlotOf(UINT hash, int nSlots)
 	{
-		if( nSize < 16 ) nSize = 16;
-		m_nBuckets = nSize;
-		m_aT = new TITEM*[nSize];
-		memset(m_aT, 0, nSize * sizeof(TITEM*));
+		return (int)((hash ^ (hash >> 16)) & (nSlots - 1));
+	}
+
+	CStdStringPtrMap::CStdStringPtrMap(int nSize) : m_aT(NULL), m_aSlots(NULL), m_nSlots(0), m_nAllocated(0), m_nCount(0)
+	{
+		// nSize was the bucket count of the chained table. The table sizes itself now and
+		// allocates nothing before the first insert, most controls never add a custom attribute.
+		(void)nSize;
 	}
 
 	CStdStringPtrMap::~CStdStringPtrMap()
 	{
-		if( m_aT ) {
-			int len = m_nBuckets;
-			while( len-- ) {
-				TITEM* pItem = m_aT[len];
-				while( pItem ) {
-					TITEM* pKill = pItem;
-					pItem = pItem->pNext;
-					delete pKill;
-				}
-			}
-			delete [] m_aT;
-			m_aT = NULL;
-		}
+		delete [] m_aT;
+		delete [] m_aSlots;
 	}
 
 	void CStdStringPtrMap::RemoveAll()
 	{
-		this->Resize(m_nBuckets);
+		for( int i = 0; i < m_nCount; i++ ) m_aT[i].Key.Empty();
+		if( m_aSlots ) memset(m_aSlots, 0, m_nSlots * sizeof(TSLOT));
+		m_nCount = 0;
 	}
 
 	void CStdStringPtrMap::Resize(int nSize)
 	{
-		if( m_aT ) {
-			int len = m_nBuckets;
-			while( len-- ) {
-				TITEM* pItem = m_aT[len];
-				while( pItem ) {
-					TITEM* pKill = pItem;
-					pItem = pItem->pNext;
-					delete pKill;
-				}
-			}
-			delete [] m_aT;
-			m_aT = NULL;
+		(void)nSize;
+		delete [] m_aT;
+		delete [] m_aSlots;
+		m_aT = NULL;
+		m_aSlots = NULL;
+		m_nSlots = 0;
+		m_nAllocated = 0;
+		m_nCount = 0;
+	}
+
+	int CStdStringPtrMap::Lookup(LPCTSTR key, UINT hash) const
+	{
+		if( m_nCount == 0 ) return -1;
+		int mask = m_nSlots - 1;
+		for( int pos = SlotOf(hash, m_nSlots); m_aSlots[pos].Item != 0; pos = (pos + 1) & mask ) {
+			if( m_aSlots[pos].Hash == hash && m_aT[m_aSlots[pos].Item - 1].Key == key ) return pos;
 		}
+		return -1;
+	}
 
-		if( nSize < 0 ) nSize = 0;
-		if( nSize > 0 ) {
-			m_aT = new TITEM*[nSize];
-			memset(m_aT, 0, nSize * sizeof(TITEM*));
-		} 
-		m_nBuckets = nSize;
-		m_nCount = 0;
+	void CStdStringPtrMap::Place(UINT hash, int iItem)
+	{
+		int mask = m_nSlots - 1;
+		int pos = SlotOf(hash, m_nSlots);
+		while( m_aSlots[pos].Item != 0 ) pos = (pos + 1) & mask;
+		m_aSlots[pos].Hash = hash;
+		m_aSlots[pos].Item = iItem + 1;
 	}
 
-	LPVOID CStdStringPtrMap::Find(LPCTSTR key, bool optimize) const
+	void CStdStringPtrMap::GrowSlots()
 	{
-		if( m_nBuckets == 0 || GetSize() == 0 ) return NULL;
-
-		UINT slot = HashKey(key) % m_nBuckets;
-		for( TITEM* pItem = m_aT[slot]; pItem; pItem = pItem->pNext ) {
-			if( pItem->Key == key ) {
-				if (optimize && pItem != m_aT[slot]) {
-					if (pItem->pNext) {
-						pItem->pNext->pPrev = pItem->pPrev;
-					}
-					pItem->pPrev->pNext = pItem->pNext;
-					pItem->pPrev = NULL;
-					pItem->pNext = m_aT[slot];
-					pItem->pNext->pPrev = pItem;
-					//itemƶͷ
-					m_aT[slot] = pItem;
-				}
-				return pItem->Data;
-			}        
+		int nSlots = m_nSlots == 0 ? 8 : m_nSlots * 2;
+		delete [] m_aSlots;
+		m_aSlots = new TSLOT[nSlots];
+		memset(m_aSlots, 0, nSlots * sizeof(TSLOT));
+		m_nSlots = nSlots;
+		// The items keep their hashes, no key is hashed again.
+		for( int i = 0; i < m_nCount; i++ ) Place(m_aT[i].Hash, i);
+	}
+
+	void CStdStringPtrMap::GrowItems()
+	{
+		int nAllocated = m_nAllocated == 0 ? 4 : m_nAllocated * 2;
+		TITEM* aT = new TITEM[nAllocated];
+		for( int i = 0; i < m_nCount; i++ ) {
+			aT[i].Key = m_aT[i].Key;
+			aT[i].Data = m_aT[i].Data;
+			aT[i].Hash = m_aT[i].Hash;
 		}
+		delete [] m_aT;
+		m_aT = aT;
+		m_nAllocated = nAllocated;
+	}
 
-		return NULL;
+	void CStdStringPtrMap::Append(LPCTSTR key, UINT hash, LPVOID pData)
+	{
+		if( m_nCount == m_nAllocated ) GrowItems();
+		if( (m_nCount + 1) * 2 > m_nSlots ) GrowSlots();
+		TITEM& item = m_aT[m_nCount];
+		item.Key = key;
+		item.Data = pData;
+		item.Hash = hash;
+		Place(hash, m_nCount);
+		m_nCount++;
+	}
+
+	LPVOID CStdStringPtrMap::Find(LPCTSTR key, bool optimize) const
+	{
+		// optimize moved the found item to the head of its chain, the probing has nothing to reorder.
+		(void)optimize;
+		if( m_nCount == 0 ) return NULL;
+
+		int pos = Lookup(key, HashKey(key));
+		return pos < 0 ? NULL : m_aT[m_aSlots[pos].Item - 1].Data;
 	}
 
 	bool CStdStringPtrMap::Insert(LPCTSTR key, LPVOID pData)
 	{
-		if( m_nBuckets == 0 ) return false;
-		if( Find(key) ) return false;
-
-		// Add first in bucket
-		UINT slot = HashKey(key) % m_nBuckets;
-		TITEM* pItem = new TITEM;
-		pItem->Key = key;
-		pItem->Data = pData;
-		pItem->pPrev = NULL;
-		pItem->pNext = m_aT[slot];
-		if (pItem->pNext)
-			pItem->pNext->pPrev = pItem;
-		m_aT[slot] = pItem;
-		m_nCount++;
+		UINT hash = HashKey(key);
+		if( Lookup(key, hash) >= 0 ) return false;
+
+		Append(key, hash, pData);
 		return true;
 	}
 
 	LPVOID CStdStringPtrMap::Set(LPCTSTR key, LPVOID pData)
 	{
-		if( m_nBuckets == 0 ) return pData;
-
-		if (GetSize()>0) {
-			UINT slot = HashKey(key) % m_nBuckets;
+		UINT hash = HashKey(key);
+		int pos = Lookup(key, hash);
+		if( pos >= 0 ) {
 			// Modify existing item
-			for( TITEM* pItem = m_aT[slot]; pItem; pItem = pItem->pNext ) {
-				if( pItem->Key == key ) {
-					LPVOID pOldData = pItem->Data;
-					pItem->Data = pData;
-					return pOldData;
-				}
-			}
+			TITEM& item = m_aT[m_aSlots[pos].Item - 1];
+			LPVOID pOldData = item.Data;
+			item.Data = pData;
+			return pOldData;
 		}
 
-		Insert(key, pData);
+		Append(key, hash, pData);
 		return NULL;
 	}
 
 	bool CStdStringPtrMap::Remove(LPCTSTR key)
 	{
-		if( m_nBuckets == 0 || GetSize() == 0 ) return false;
-
-		UINT slot = HashKey(key) % m_nBuckets;
-		TITEM** ppItem = &m_aT[slot];
-		while( *ppItem ) {
-			if( (*ppItem)->Key == key ) {
-				TITEM* pKill = *ppItem;
-				*ppItem = (*ppItem)->pNext;
-				if (*ppItem)
-					(*ppItem)->pPrev = pKill->pPrev;
-				delete pKill;
-				m_nCount--;
-				return true;
+		if( m_nCount == 0 ) return false;
+
+		int pos = Lookup(key, HashKey(key));
+		if( pos < 0 ) return false;
+
+		// Shift the rest of the probe run back into the hole, so lookups need no deleted marks.
+		int iItem = m_aSlots[pos].Item - 1;
+		int mask = m_nSlots - 1;
+		int hole = pos;
+		for( int next = (hole + 1) & mask; m_aSlots[next].Item != 0; next = (next + 1) & mask ) {
+			int home = SlotOf(m_aSlots[next].Hash, m_nSlots);
+			if( ((next - home) & mask) >= ((next - hole) & mask) ) {
+				m_aSlots[hole] = m_aSlots[next];
+				hole = next;
 			}
-			ppItem = &((*ppItem)->pNext);
 		}
-
-		return false;
+		m_aSlots[hole].Item = 0;
+
+		// The last item fills the gap, so the items stay packed for GetAt.
+		int iLast = m_nCount - 1;
+		if( iItem != iLast ) {
+			UINT hash = m_aT[iLast].Hash;
+			for( int p = SlotOf(hash, m_nSlots); ; p = (p + 1) & mask ) {
+				if( m_aSlots[p].Item == iLast + 1 ) {
+					m_aSlots[p].Item = iItem + 1;
+					break;
+				}
+			}
+			m_aT[iItem].Key = m_aT[iLast].Key;
+			m_aT[iItem].Data = m_aT[iLast].Data;
+			m_aT[iItem].Hash = hash;
+		}
+		m_aT[iLast].Key.Empty();
+		m_nCount--;
+		return true;
 	}
 
 	int CStdStringPtrMap::GetSize() const
 	{
-#if 0//def _DEBUG
-		int nCount = 0;
-		int len = m_nBuckets;
-		while( len-- ) {
-			for( const TITEM* pItem = m_aT[len]; pItem; pItem = pItem->pNext ) nCount++;
-		}
-		ASSERT(m_nCount==nCount);
-#endif
 		return m_nCount;
 	}
 
 	LPCTSTR CStdStringPtrMap::GetAt(int iIndex) const
 	{
-		if( m_nBuckets == 0 || GetSize() == 0 ) return false;
-
-		int pos = 0;
-		int len = m_nBuckets;
-		while( len-- ) {
-			for( TITEM* pItem = m_aT[len]; pItem; pItem = pItem->pNext ) {
-				if( pos++ == iIndex ) {
-					return pItem->Key.GetData();
-				}
-			}
-		}
-
-		return NULL;
+		if( iIndex < 0 || iIndex >= m_nCount ) return NULL;
+		return m_aT[iIndex].Key.GetData();
 	}
 
 	LPCTSTR CStdStringPtrMap::operator[] (int nIndex) const
@@ -127,6 +127,46 @@ namespace DuiLib
 	};
 
 
+	/////////////////////////////////////////////////////////////////////////////////////
+	//
+
+	// Set of indices from 0 up, kept as sorted, disjoint ranges, so a run of indices costs one
+	// range however long it is. Find, Add and Remove are a binary search over the ranges.
+	class UILIB_API CStdIndexSet
+	{
+	public:
+		CStdIndexSet();
+		~CStdIndexSet();
+
+		void Empty();
+		bool IsEmpty() const;
+		bool Find(int iIndex) const;
+		bool Add(int iIndex);
+		bool AddRange(int iFirst, int iLast);
+		bool Remove(int iIndex);
+		void RemoveFrom(int iIndex);
+		int GetSize() const;
+		// -1 when there is none
+		int GetFirst() const;
+		int GetLast() const;
+		int GetNext(int iIndex) const;
+
+	protected:
+		struct TRANGE
+		{
+			int iFirst;
+			int iLast;
+		};
+		int Lookup(int iIndex) const;
+		bool InsertRange(int iRange, int iFirst, int iLast);
+
+		TRANGE* m_aRanges;
+		int m_nRanges;
+		int m_nAllocated;
+		int m_nCount;	// indices, not ranges
+	};
+
+
 	/////////////////////////////////////////////////////////////////////////////////////
 	//
 
@@ -223,10 +263,11 @@ namespace DuiLib
 	{
 		CDuiString Key;
 		LPVOID Data;
-		struct TITEM* pPrev;
-		struct TITEM* pNext;
+		UINT Hash;
 	};
 
+	// Open addressing string map. The items are packed in one array, so GetAt is a plain index,
+	// and a linear probing index of (hash, item) slots finds them. Both grow with the count.
 	class UILIB_API CStdStringPtrMap
 	{
 	public:
@@ -244,8 +285,21 @@ namespace DuiLib
 		LPCTSTR operator[] (int nIndex) const;
 
 	protected:
-		TITEM** m_aT;
-		int m_nBuckets;
+		struct TSLOT
+		{
+			UINT Hash;
+			int Item;	// item index + 1, 0 is an empty slot
+		};
+		int Lookup(LPCTSTR key, UINT hash) const;
+		void Append(LPCTSTR key, UINT hash, LPVOID pData);
+		void Place(UINT hash, int iItem);
+		void GrowSlots();
+		void GrowItems();
+
+		TITEM* m_aT;
+		TSLOT* m_aSlots;
+		int m_nSlots;		// power of 2, at least twice the count
+		int m_nAllocated;
 		int m_nCount;
 	};
 
@@ -4,6 +4,16 @@
 #include <stdlib.h>
 #include <string.h>
 #include <tchar.h>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 #include "unzip.h"
 
 #pragma warning(disable : 4996)	// disable bogus deprecation warning
@@ -2609,12 +2619,65 @@ typedef struct
   HANDLE h; bool herr; unsigned long initial_offset; bool mustclosehandle;
   // for memory:
   void *buf; unsigned int len,pos; // if it's a memory block
+  bool mustunmap;                  // the block is our own mapping of a file
 } LUFILE;
 
 
+// lufmapfile - maps a whole zip file read-only, so that the central directory,
+// the name index and stored items are read straight out of the page cache.
+// Returns NULL if the file can't be mapped (e.g. it's empty); the caller then
+// falls back to reading it through a handle.
+void *lufmapfile(const TCHAR *fn,unsigned int *len)
+{ void *view=NULL; *len=0;
+#ifdef _WIN32
+  HANDLE h=CreateFile(fn,GENERIC_READ,FILE_SHARE_READ,NULL,OPEN_EXISTING,FILE_ATTRIBUTE_NORMAL,NULL);
+  if (h==INVALID_HANDLE_VALUE) return NULL;
+  DWORD size=GetFileSize(h,NULL);
+  if (size!=0 && size!=INVALID_FILE_SIZE)
+  { HANDLE hmap=CreateFileMapping(h,NULL,PAGE_READONLY,0,0,NULL);
+    // the view holds its own reference to the mapping, so neither handle is kept
+    if (hmap!=NULL) {view=MapViewOfFile(hmap,FILE_MAP_READ,0,0,0); CloseHandle(hmap);}
+  }
+  CloseHandle(h);
+  if (view!=NULL) *len=size;
+#else
+  int fd=open(fn,O_RDONLY);
+  if (fd<0) return NULL;
+  struct stat st;
+  if (fstat(fd,&st)==0 && st.st_size>0 && (unsigned long long)st.st_size<0xFFFFFFFFULL)
+  { view=mmap(NULL,(size_t)st.st_size,PROT_READ,MAP_SHARED,fd,0);
+    if (view==MAP_FAILED) view=NULL;
+  }
+  close(fd);
+  if (view!=NULL) *len=(unsigned int)st.st_size;
+#endif
+  return view;
+}
+
+void lufunmapfile(void *view,unsigned int len)
+{
+#ifdef _WIN32
+  UnmapViewOfFile(view); (void)len;
+#else
+  munmap(view,len);
+#endif
+}
+
+
 LUFILE *lufopen(void *z,unsigned int len,DWORD flags,ZRESULT *err)
 { if (flags!=ZIP_HANDLE && flags!=ZIP_FILENAME && flags!=ZIP_MEMORY) {*err=ZR_ARGS; return NULL;}
   //
+  if (flags==ZIP_FILENAME)
+  { unsigned int maplen; void *view=lufmapfile((const TCHAR*)z,&maplen);
+    if (view!=NULL)
+    { LUFILE *lf = new LUFILE;
+      lf->is_handle=false; lf->canseek=true;
+      lf->mustclosehandle=false; lf->mustunmap=true;
+      lf->buf=view; lf->len=maplen; lf->pos=0; lf->initial_offset=0;
+      *err=ZR_OK;
+      return lf;
+    }
+  }
   HANDLE h=0; bool canseek=false; *err=ZR_OK;
   bool mustclosehandle=false;
   if (flags==ZIP_HANDLE||flags==ZIP_FILENAME)
@@ -2636,6 +2699,7 @@ LUFILE *lufopen(void *z,unsigned int len,DWORD flags,ZRESULT *err)
     canseek = (res!=0xFFFFFFFF);
   }
   LUFILE *lf = new LUFILE;
+  lf->mustunmap=false;
   if (flags==ZIP_HANDLE||flags==ZIP_FILENAME)
   { lf->is_handle=true; lf->mustclosehandle=mustclosehandle;
     lf->canseek=canseek;
@@ -2657,6 +2721,7 @@ LUFILE *lufopen(void *z,unsigned int len,DWORD flags,ZRESULT *err)
 int lufclose(LUFILE *stream)
 { if (stream==NULL) return EOF;
   if (stream->mustclosehandle) CloseHandle(stream->h);
+  if (stream->mustunmap) lufunmapfile(stream->buf,stream->len);
   delete stream;
   return 0;
 }
@@ -2697,7 +2762,9 @@ size_t lufread(void *ptr,size_t size,size_t n,LUFILE *stream)
     if (!res) stream->herr=true;
     return red/size;
   }
-  if (stream->pos+toread > stream->len) toread = stream->len-stream->pos;
+  // a corrupt offset can seek past the end, and zips opened by name are mapped into memory
+  if (stream->pos >= stream->len) toread = 0;
+  else if (toread > stream->len-stream->pos) toread = stream->len-stream->pos;
   memcpy(ptr, (char*)stream->buf + stream->pos, toread); DWORD red = toread;
   stream->pos += red;
   return red/size;
@@ -3238,6 +3305,30 @@ int unzGoToNextFile (unzFile file)
 }
 
 
+//  Set the current file of the zipfile to the file num_file, whose record
+//  in the central dir starts at pos_in_central_dir (as found by an earlier walk).
+//  return UNZ_OK if there is no problem
+int unzGoToFileAt (unzFile file, uLong num_file, uLong pos_in_central_dir)
+{
+	unz_s* s;
+	int err;
+
+	if (file==NULL)
+		return UNZ_PARAMERROR;
+	s=(unz_s*)file;
+	if (num_file>=s->gi.number_entry)
+		return UNZ_PARAMERROR;
+
+	s->pos_in_central_dir = pos_in_central_dir;
+	s->num_file = num_file;
+	err = unzlocal_GetCurrentFileInfoInternal(file,&s->cur_file_info,
+											   &s->cur_file_info_internal,
+											   NULL,0,NULL,0,NULL,0);
+	s->current_file_ok = (err == UNZ_OK);
+	return err;
+}
+
+
 //  Try locate the file szFileName in the zipfile.
 //  For the iCaseSensitivity signification, see unzStringFileNameCompare
 //  return value :
@@ -3752,22 +3843,127 @@ FILETIME dosdatetime2filetime(WORD dosdate,WORD dostime)
 
 
 
+// unzNameHash - FNV-1a of a filename folded the way strcmpcasenosensitive_internal
+// folds it, so names that compare equal either way hash equal.
+unsigned int unzNameHash(const char *name)
+{ unsigned int h=2166136261U;
+  for (const char *c=name; *c!=0; c++)
+  { char ch=*c; if (ch>='a' && ch<='z') ch-=(char)0x20;
+    h=(h^(unsigned char)ch)*16777619U;
+  }
+  return h;
+}
+
+// TUnzipIndex - the central directory, walked once when the zip is opened.
+// It records where each item's record starts, so that items can be reached
+// without stepping through all the ones before them, and hashes the names
+// into an open-addressed table, so that Find doesn't read every record.
+// Items with the same name keep their zip order along a probe chain, so a
+// lookup finds the first of them, as unzLocateFile did.
+class TUnzipIndex
+{ public:
+  TUnzipIndex() : mask(0) {}
+
+  std::vector<uLong> pos;          // record of item i in the central dir
+  std::vector<unsigned int> hash;  // unzNameHash of item i
+  std::vector<unsigned int> name;  // offset of item i's name in names
+  std::vector<char> direct;        // item i is stored and not encrypted
+  std::vector<char> names;
+  std::vector<int> slots;          // item index, or -1
+  unsigned int mask;
+
+  bool Build(unzFile uf);
+  int Lookup(const char *name,bool ic) const; // -1 if it's not there
+  bool IsBuilt() const {return !slots.empty();}
+};
+
+bool TUnzipIndex::Build(unzFile uf)
+{ int n = (int)uf->gi.number_entry;
+  unsigned int size=16; while (size<(unsigned int)n*2) size<<=1;
+  mask=size-1;
+  pos.resize(n); hash.resize(n); name.resize(n); direct.resize(n);
+  names.clear(); names.reserve(uf->size_central_dir);
+  slots.assign(size,-1);
+  int err = (n>0) ? unzGoToFirstFile(uf) : UNZ_OK;
+  for (int i=0; i<n; i++)
+  { if (err!=UNZ_OK) {slots.clear(); return false;}
+    char fn[UNZ_MAXFILENAMEINZIP+1];
+    unzGetCurrentFileInfo(uf,NULL,fn,sizeof(fn)-1,NULL,0,NULL,0);
+    fn[sizeof(fn)-1]=0;
+    pos[i]=uf->pos_in_central_dir;
+    hash[i]=unzNameHash(fn);
+    name[i]=(unsigned int)names.size();
+    names.insert(names.end(),fn,fn+strlen(fn)+1);
+    direct[i]=(uf->cur_file_info.compression_method==0 && (uf->cur_file_info.flag&1)==0);
+    unsigned int s=hash[i]&mask; while (slots[s]!=-1) s=(s+1)&mask;
+    slots[s]=i;
+    if (i+1<n) err=unzGoToNextFile(uf);
+  }
+  if (n>0) unzGoToFirstFile(uf);
+  return true;
+}
+
+int TUnzipIndex::Lookup(const char *fn,bool ic) const
+{ if (!IsBuilt() || strlen(fn)>=UNZ_MAXFILENAMEINZIP) return -1;
+  unsigned int h=unzNameHash(fn);
+  for (unsigned int s=h&mask; slots[s]!=-1; s=(s+1)&mask)
+  { int i=slots[s];
+    if (hash[i]!=h) continue;
+    if (unzStringFileNameCompare(&names[name[i]],fn,ic?CASE_INSENSITIVE:CASE_SENSITIVE)==0) return i;
+  }
+  return -1;
+}
+
+
+// An item inflated ahead of use by the prefetch workers. Items move from
+// queued to inflating to ready (or failed); an item still queued when it is
+// asked for is taken back and inflated by the caller instead.
+#define UNZ_ITEM_NONE      0
+#define UNZ_ITEM_QUEUED    1
+#define UNZ_ITEM_INFLATING 2
+#define UNZ_ITEM_READY     3
+#define UNZ_ITEM_FAILED    4
+
+typedef struct
+{ char *data;
+  unsigned int len;
+  int state;
+} unz_prefetched;
+
+
 class TUnzip
 { public:
-  TUnzip(const char *pwd) : uf(0), unzbuf(0), currentfile(-1), czei(-1), password(0) {if (pwd!=0) {password=new char[strlen(pwd)+1]; strcpy(password,pwd);}}
+  TUnzip(const char *pwd) : uf(0), unzbuf(0), currentfile(-1), czei(-1), password(0), inmem(false), qhead(0), running(0), stopping(false) {if (pwd!=0) {password=new char[strlen(pwd)+1]; strcpy(password,pwd);}}
   ~TUnzip() {if (password!=0) delete[] password; password=0; if (unzbuf!=0) delete[] unzbuf; unzbuf=0;}
 
   unzFile uf; int currentfile; ZIPENTRY cze; int czei;
   char *password;
   char *unzbuf;            // lazily created and destroyed, used by Unzip
   TCHAR rootdir[MAX_PATH]; // includes a trailing slash
+  TUnzipIndex idx;
+
+  // Prefetching needs the zip in memory: each worker reads through its own
+  // copy of the zip state, taken from this pristine one made at Open.
+  bool inmem; unz_s base; LUFILE basefile;
+  std::vector<unz_prefetched> prefetched;
+  std::vector<int> queue; size_t qhead;
+  std::vector<std::thread> workers; int running; bool stopping;
+  std::mutex lock;
+  std::condition_variable changed;
 
   ZRESULT Open(void *z,unsigned int len,DWORD flags);
   ZRESULT Get(int index,ZIPENTRY *ze);
   ZRESULT Find(const TCHAR *name,bool ic,int *index,ZIPENTRY *ze);
   ZRESULT Unzip(int index,void *dst,unsigned int len,DWORD flags);
+  ZRESULT GetData(int index,const void **data,unsigned int *len);
+  ZRESULT ReleaseData(int index);
+  ZRESULT Prefetch(const TCHAR * const *names,int count);
   ZRESULT SetUnzipBaseDir(const TCHAR *dir);
   ZRESULT Close();
+
+  int Goto(int index);
+  int TakePrefetched(int index,std::unique_lock<std::mutex> &l);
+  void PrefetchWorker();
 };
 
 
@@ -3792,9 +3988,27 @@ ZRESULT TUnzip::Open(void *z,unsigned int len,DWORD flags)
   if (f==NULL) return e;
   uf = unzOpenInternal(f);
   if (uf==0) return ZR_NOFILE;
+  // a zip whose directory can't be walked is still served by the old linear search
+  idx.Build(uf);
+  if (!uf->file->is_handle && idx.IsBuilt())
+  { inmem=true; base=*uf; basefile=*uf->file;
+    unz_prefetched none = {0,0,UNZ_ITEM_NONE};
+    prefetched.assign(uf->gi.number_entry,none);
+  }
   return ZR_OK;
 }
 
+int TUnzip::Goto(int index)
+{ if (index<0 || index>=(int)uf->gi.number_entry) return UNZ_PARAMERROR;
+  if (idx.IsBuilt())
+  { if (index==(int)uf->num_file && uf->current_file_ok) return UNZ_OK;
+    return unzGoToFileAt(uf,index,idx.pos[index]);
+  }
+  if (index<(int)uf->num_file) unzGoToFirstFile(uf);
+  while ((int)uf->num_file<index) unzGoToNextFile(uf);
+  return UNZ_OK;
+}
+
 ZRESULT TUnzip::SetUnzipBaseDir(const TCHAR *dir)
 { _tcscpy(rootdir,dir);
   TCHAR lastchar = rootdir[_tcslen(rootdir)-1];
@@ -3817,8 +4031,7 @@ ZRESULT TUnzip::Get(int index,ZIPENTRY *ze)
     ze->unc_size=0;
     return ZR_OK;
   }
-  if (index<(int)uf->num_file) unzGoToFirstFile(uf);
-  while ((int)uf->num_file<index) unzGoToNextFile(uf);
+  if (Goto(index)!=UNZ_OK) return ZR_CORRUPT;
   unz_file_info ufi; char fn[MAX_PATH];
   unzGetCurrentFileInfo(uf,&ufi,fn,MAX_PATH,NULL,0,NULL,0);
   // now get the extra header. We do this ourselves, instead of
@@ -3932,14 +4145,15 @@ ZRESULT TUnzip::Find(const TCHAR *tname,bool ic,int *index,ZIPENTRY *ze)
 #else
   strcpy(name,tname);
 #endif
-  int res = unzLocateFile(uf,name,ic?CASE_INSENSITIVE:CASE_SENSITIVE);
-  if (res!=UNZ_OK)
+  int i = -1;
+  if (idx.IsBuilt()) i = idx.Lookup(name,ic);
+  else if (unzLocateFile(uf,name,ic?CASE_INSENSITIVE:CASE_SENSITIVE)==UNZ_OK) i = (int)uf->num_file;
+  if (i<0)
   { if (index!=0) *index=-1;
     if (ze!=NULL) {ZeroMemory(ze,sizeof(ZIPENTRY)); ze->index=-1;}
     return ZR_NOTFOUND;
   }
   if (currentfile!=-1) unzCloseCurrentFile(uf); currentfile=-1;
-  int i = (int)uf->num_file;
   if (index!=NULL) *index=i;
   if (ze!=NULL)
   { ZRESULT zres = Get(i,ze);
@@ -3971,9 +4185,14 @@ ZRESULT TUnzip::Unzip(int index,void *dst,unsigned int len,DWORD flags)
   if (flags==ZIP_MEMORY)
   { if (index!=currentfile)
     { if (currentfile!=-1) unzCloseCurrentFile(uf); currentfile=-1;
-      if (index>=(int)uf->gi.number_entry) return ZR_ARGS;
-      if (index<(int)uf->num_file) unzGoToFirstFile(uf);
-      while ((int)uf->num_file<index) unzGoToNextFile(uf);
+      if (index<0 || index>=(int)uf->gi.number_entry) return ZR_ARGS;
+      if (inmem)
+      { // an item the workers have already inflated is just copied out
+        std::unique_lock<std::mutex> l(lock);
+        unz_prefetched &p = prefetched[index];
+        if (TakePrefetched(index,l)==UNZ_ITEM_READY && len>=p.len) {memcpy(dst,p.data,p.len); return ZR_OK;}
+      }
+      if (Goto(index)!=UNZ_OK) return ZR_CORRUPT;
       unzOpenCurrentFile(uf,password); currentfile=index;
     }
     bool reached_eof;
@@ -3987,8 +4206,7 @@ ZRESULT TUnzip::Unzip(int index,void *dst,unsigned int len,DWORD flags)
   // otherwise we're writing to a handle or a file
   if (currentfile!=-1) unzCloseCurrentFile(uf); currentfile=-1;
   if (index>=(int)uf->gi.number_entry) return ZR_ARGS;
-  if (index<(int)uf->num_file) unzGoToFirstFile(uf);
-  while ((int)uf->num_file<index) unzGoToNextFile(uf);
+  if (Goto(index)!=UNZ_OK) return ZR_CORRUPT;
   ZIPENTRY ze; Get(index,&ze);
   // zipentry=directory is handled specially
   if ((ze.attr&FILE_ATTRIBUTE_DIRECTORY)!=0)
@@ -4040,8 +4258,114 @@ ZRESULT TUnzip::Unzip(int index,void *dst,unsigned int len,DWORD flags)
   return ZR_OK;
 }
 
+// Waits for an item the workers are inflating. An item they haven't started
+// yet is taken back, so the caller inflates it now instead of queueing behind
+// the rest of the prefetch; a failed one is left for the caller to retry.
+int TUnzip::TakePrefetched(int index,std::unique_lock<std::mutex> &l)
+{ unz_prefetched &p = prefetched[index];
+  while (p.state==UNZ_ITEM_INFLATING) changed.wait(l);
+  if (p.state==UNZ_ITEM_QUEUED || p.state==UNZ_ITEM_FAILED) p.state=UNZ_ITEM_NONE;
+  return p.state;
+}
+
+ZRESULT TUnzip::GetData(int index,const void **data,unsigned int *len)
+{ *data=0; *len=0;
+  if (index<0 || index>=(int)uf->gi.number_entry) return ZR_ARGS;
+  if (!inmem) return ZR_NOTMMAP;
+  { std::unique_lock<std::mutex> l(lock);
+    unz_prefetched &p = prefetched[index];
+    if (TakePrefetched(index,l)==UNZ_ITEM_READY) {*data=p.data; *len=p.len; return ZR_OK;}
+  }
+  if (!idx.direct[index]) return ZR_NOTMMAP;
+  // a stored item is its own bytes in the zip, just past its local header
+  if (currentfile!=-1) unzCloseCurrentFile(uf); currentfile=-1;
+  if (Goto(index)!=UNZ_OK) return ZR_CORRUPT;
+  unsigned int extralen,iSizeVar; unsigned long offset;
+  if (unzlocal_CheckCurrentFileCoherencyHeader(uf,&iSizeVar,&offset,&extralen)!=UNZ_OK) return ZR_CORRUPT;
+  uLong start = uf->byte_before_the_zipfile + uf->cur_file_info_internal.offset_curfile + SIZEZIPLOCALHEADER + iSizeVar;
+  uLong size = uf->cur_file_info.uncompressed_size;
+  if (start>uf->file->len || size>uf->file->len-start) return ZR_CORRUPT;
+  *data=(const char*)uf->file->buf+start; *len=(unsigned int)size;
+  return ZR_OK;
+}
+
+ZRESULT TUnzip::ReleaseData(int index)
+{ if (index<0 || index>=(int)uf->gi.number_entry) return ZR_ARGS;
+  if (!inmem) return ZR_OK;
+  std::unique_lock<std::mutex> l(lock);
+  unz_prefetched &p = prefetched[index];
+  if (p.state==UNZ_ITEM_READY) {delete[] p.data; p.data=0; p.len=0; p.state=UNZ_ITEM_NONE;}
+  return ZR_OK;
+}
+
+ZRESULT TUnzip::Prefetch(const TCHAR * const *names,int count)
+{ if (!inmem) return ZR_NOTMMAP;
+  std::unique_lock<std::mutex> l(lock);
+  for (int n=0; n<count; n++)
+  { char name[MAX_PATH];
+#ifdef UNICODE
+    WideCharToMultiByte(CP_UTF8,0,names[n],-1,name,MAX_PATH,0,0);
+#else
+    strncpy(name,names[n],MAX_PATH-1); name[MAX_PATH-1]=0;
+#endif
+    int i = idx.Lookup(name,true);
+    // stored items are handed out in place and don't need inflating
+    if (i<0 || idx.direct[i] || prefetched[i].state!=UNZ_ITEM_NONE) continue;
+    prefetched[i].state=UNZ_ITEM_QUEUED;
+    queue.push_back(i);
+  }
+  int pool = (int)std::thread::hardware_concurrency()-1;
+  if (pool<1) pool=1;
+  if (pool>4) pool=4;
+  while (running<pool && (size_t)running<queue.size()-qhead)
+  { workers.push_back(std::thread(&TUnzip::PrefetchWorker,this));
+    running++;
+  }
+  return ZR_OK;
+}
+
+void TUnzip::PrefetchWorker()
+{ LUFILE *f = new LUFILE; *f=basefile;
+  f->pos=0; f->mustunmap=false;
+  unz_s *s = (unz_s*)zmalloc(sizeof(unz_s)); *s=base;
+  s->file=f; s->pfile_in_zip_read=NULL;
+  std::unique_lock<std::mutex> l(lock);
+  while (!stopping && qhead<queue.size())
+  { int i = queue[qhead++];
+    if (qhead==queue.size()) {queue.clear(); qhead=0;}
+    if (prefetched[i].state!=UNZ_ITEM_QUEUED) continue; // taken back meanwhile
+    prefetched[i].state=UNZ_ITEM_INFLATING;
+    l.unlock();
+    char *data=0; unsigned int got=0; bool ok=false;
+    if (unzGoToFileAt(s,i,idx.pos[i])==UNZ_OK && unzOpenCurrentFile(s,password)==UNZ_OK)
+    { unsigned int len = s->cur_file_info.uncompressed_size;
+      data = new char[len>0?len:1];
+      bool reached_eof=false; int res=1;
+      while (got<len && !reached_eof && res>0)
+      { res = unzReadCurrentFile(s,data+got,len-got,&reached_eof);
+        if (res>0) got+=res;
+      }
+      ok = (got==len && res>=0);
+      unzCloseCurrentFile(s);
+    }
+    l.lock();
+    unz_prefetched &p = prefetched[i];
+    if (ok && !stopping) {p.data=data; p.len=got; p.state=UNZ_ITEM_READY;}
+    else {delete[] data; p.state=UNZ_ITEM_FAILED;}
+    changed.notify_all();
+  }
+  running--;
+  l.unlock();
+  unzClose(s);
+}
+
 ZRESULT TUnzip::Close()
-{ if (currentfile!=-1) unzCloseCurrentFile(uf); currentfile=-1;
+{ { std::unique_lock<std::mutex> l(lock); stopping=true; }
+  for (size_t i=0; i<workers.size(); i++) workers[i].join();
+  workers.clear();
+  for (size_t i=0; i<prefetched.size(); i++) if (prefetched[i].data!=0) delete[] prefetched[i].data;
+  prefetched.clear();
+  if (currentfile!=-1) unzCloseCurrentFile(uf); currentfile=-1;
   if (uf!=0) unzClose(uf); uf=0;
   return ZR_OK;
 }
@@ -4135,6 +4459,34 @@ ZRESULT UnzipItemHandle(HZIP hz, int index, HANDLE h) {return UnzipItemInternal(
 ZRESULT UnzipItem(HZIP hz, int index, const TCHAR *fn) {return UnzipItemInternal(hz,index,(void*)fn,0,ZIP_FILENAME);}
 ZRESULT UnzipItem(HZIP hz, int index, void *z,unsigned int len) {return UnzipItemInternal(hz,index,z,len,ZIP_MEMORY);}
 
+ZRESULT GetZipItemData(HZIP hz, int index, const void **data, unsigned int *len)
+{ *data=0; *len=0;
+  if (hz==0) {lasterrorU=ZR_ARGS;return ZR_ARGS;}
+  TUnzipHandleData *han = (TUnzipHandleData*)hz;
+  if (han->flag!=1) {lasterrorU=ZR_ZMODE;return ZR_ZMODE;}
+  TUnzip *unz = han->unz;
+  lasterrorU = unz->GetData(index,data,len);
+  return lasterrorU;
+}
+
+ZRESULT ReleaseZipItemData(HZIP hz, int index)
+{ if (hz==0) {lasterrorU=ZR_ARGS;return ZR_ARGS;}
+  TUnzipHandleData *han = (TUnzipHandleData*)hz;
+  if (han->flag!=1) {lasterrorU=ZR_ZMODE;return ZR_ZMODE;}
+  TUnzip *unz = han->unz;
+  lasterrorU = unz->ReleaseData(index);
+  return lasterrorU;
+}
+
+ZRESULT PrefetchZipItems(HZIP hz, const TCHAR * const *names, int count)
+{ if (hz==0 || (names==0 && count>0)) {lasterrorU=ZR_ARGS;return ZR_ARGS;}
+  TUnzipHandleData *han = (TUnzipHandleData*)hz;
+  if (han->flag!=1) {lasterrorU=ZR_ZMODE;return ZR_ZMODE;}
+  TUnzip *unz = han->unz;
+  lasterrorU = unz->Prefetch(names,count);
+  return lasterrorU;
+}
+
 ZRESULT SetUnzipBaseDir(HZIP hz, const TCHAR *dir)
 { if (hz==0) {lasterrorU=ZR_ARGS;return ZR_ARGS;}
   TUnzipHandleData *han = (TUnzipHandleData*)hz;
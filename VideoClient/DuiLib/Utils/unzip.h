@@ -89,6 +89,26 @@ ZRESULT SetUnzipBaseDir(HZIP hz, const TCHAR *dir);
 // if unzipping to a filename, and it's a relative filename, then it will be relative to here.
 // (defaults to current-directory).
 
+ZRESULT GetZipItemData(HZIP hz, int index, const void **data, unsigned int *len);
+ZRESULT ReleaseZipItemData(HZIP hz, int index);
+// GetZipItemData - gives the bytes of an item without copying them. This works
+// for zips opened from memory or by name (which are mapped into memory), and
+// for items that are either stored uncompressed without a password, in which
+// case data points into the zip itself, or have been prefetched, in which case
+// it points at the inflated copy. Otherwise it returns ZR_NOTMMAP and you
+// should UnzipItem as usual. The data stays valid until CloseZip; a prefetched
+// copy may be dropped earlier with ReleaseZipItemData once you're done with it.
+
+ZRESULT PrefetchZipItems(HZIP hz, const TCHAR * const *names, int count);
+// PrefetchZipItems - starts inflating the named items on worker threads and
+// returns at once. Names are matched insensitive to case, names not in the zip
+// are skipped, and stored items are left alone since GetZipItemData hands them
+// out in place. Later calls to GetZipItemData or UnzipItem for a prefetched item
+// wait for it if it's still being inflated. Like GetZipItemData this needs a
+// zip opened from memory or by name, otherwise it returns ZR_NOTMMAP.
+// Note: FindZipItem goes through a hash of the names built when the zip is
+// opened, so looking items up no longer reads the whole central directory.
+
 
 ZRESULT CloseZip(HZIP hz);
 // CloseZip - the zip handle must be closed with this function.
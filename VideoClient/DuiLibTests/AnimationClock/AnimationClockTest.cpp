@@ -0,0 +1,236 @@
+// AnimationClockTest.cpp : CAnimationClock against a model, a plain list of timers. Timers are
+// set, killed one by one and by control, and killed and set again while the timers of a tick are
+// being handed out; the tick count starts just short of the wrap and runs across it. After every
+// step the due timers, their order, IsCurrent and GetNextDue must be those of the model.
+
+#include "StdAfx.h"
+#include "TestCheck.h"
+#include <stdlib.h>
+#include <algorithm>
+#include <vector>
+
+using namespace DuiLib;
+
+struct TModelTimer
+{
+	CControlUI* pControl;
+	UINT nTimerID;
+	UINT uElapse;
+	DWORD dwDue;
+	UINT uSerial;
+};
+
+// What CAnimationClock promises, the slow way
+class CModel
+{
+public:
+	CModel() : m_uSerial(0) { }
+
+	bool SetTimer(CControlUI* pControl, UINT nTimerID, UINT uElapse, DWORD dwNow)
+	{
+		if( Find(pControl, nTimerID) >= 0 ) return false;
+		TModelTimer timer = { pControl, nTimerID, uElapse == 0 ? 1 : uElapse, 0, ++m_uSerial };
+		timer.dwDue = dwNow + timer.uElapse;
+		m_aTimers.push_back(timer);
+		return true;
+	}
+	bool KillTimer(CControlUI* pControl, UINT nTimerID)
+	{
+		int i = Find(pControl, nTimerID);
+		if( i < 0 ) return false;
+		m_aTimers.erase(m_aTimers.begin() + i);
+		return true;
+	}
+	void KillTimer(CControlUI* pControl)
+	{
+		for( size_t i = m_aTimers.size(); i-- > 0; ) {
+			if( m_aTimers[i].pControl == pControl ) m_aTimers.erase(m_aTimers.begin() + i);
+		}
+	}
+	// due before dwNow + FRAME_TIME, soonest first and then in the order they were set
+	void Tick(DWORD dwNow, std::vector<CAnimationClock::TDue>& aDue)
+	{
+		// m_aTimers is in the order the timers were set, so a stable sort on the time left is it
+		std::vector<std::pair<int, CAnimationClock::TDue> > aFired;
+		for( size_t i = 0; i < m_aTimers.size(); i++ ) {
+			int iLeft = (int)(m_aTimers[i].dwDue - dwNow);
+			if( iLeft >= CAnimationClock::FRAME_TIME ) continue;
+			CAnimationClock::TDue due = { m_aTimers[i].pControl, m_aTimers[i].nTimerID, m_aTimers[i].uSerial };
+			aFired.push_back(std::make_pair(iLeft, due));
+		}
+		std::stable_sort(aFired.begin(), aFired.end(), LessLeft);
+		aDue.clear();
+		for( size_t i = 0; i < aFired.size(); i++ ) aDue.push_back(aFired[i].second);
+		for( size_t i = 0; i < m_aTimers.size(); i++ ) {
+			TModelTimer& timer = m_aTimers[i];
+			if( (int)(timer.dwDue - dwNow) >= CAnimationClock::FRAME_TIME ) continue;
+			timer.dwDue += timer.uElapse;
+			if( (int)(timer.dwDue - dwNow) <= 0 ) timer.dwDue = dwNow + timer.uElapse;
+		}
+	}
+	bool IsCurrent(const CAnimationClock::TDue& due) const
+	{
+		int i = Find(due.pControl, due.nTimerID);
+		return i >= 0 && m_aTimers[i].uSerial == due.uSerial;
+	}
+	int GetNextDue(DWORD dwNow) const
+	{
+		int iNext = -1;
+		for( size_t i = 0; i < m_aTimers.size(); i++ ) {
+			int iLeft = (int)(m_aTimers[i].dwDue - dwNow);
+			if( iLeft < 0 ) iLeft = 0;
+			if( iNext < 0 || iLeft < iNext ) iNext = iLeft;
+		}
+		return iNext;
+	}
+	int GetCount() const { return (int)m_aTimers.size(); }
+
+private:
+	static bool LessLeft(const std::pair<int, CAnimationClock::TDue>& a, const std::pair<int, CAnimationClock::TDue>& b)
+	{
+		return a.first < b.first;
+	}
+	int Find(CControlUI* pControl, UINT nTimerID) const
+	{
+		for( size_t i = 0; i < m_aTimers.size(); i++ ) {
+			if( m_aTimers[i].pControl == pControl && m_aTimers[i].nTimerID == nTimerID ) return (int)i;
+		}
+		return -1;
+	}
+
+	std::vector<TModelTimer> m_aTimers;
+	UINT m_uSerial;
+};
+
+static bool SameDue(const std::vector<CAnimationClock::TDue>& a, const std::vector<CAnimationClock::TDue>& b)
+{
+	if( a.size() != b.size() ) return false;
+	for( size_t i = 0; i < a.size(); i++ ) {
+		if( a[i].pControl != b[i].pControl || a[i].nTimerID != b[i].nTimerID || a[i].uSerial != b[i].uSerial ) return false;
+	}
+	return true;
+}
+
+static CControlUI* Control(int i)
+{
+	static char aControls[8];
+	return reinterpret_cast<CControlUI*>(&aControls[i]);
+}
+
+static void TestKilled()
+{
+	CAnimationClock clock;
+	DWORD dwNow = 1000;
+	CHECK(clock.GetNextDue(dwNow) == -1);
+	CHECK(clock.SetTimer(Control(0), 1, 16, dwNow));
+	CHECK(clock.SetTimer(Control(0), 2, 16, dwNow));
+	CHECK(clock.SetTimer(Control(1), 1, 50, dwNow));
+	CHECK(!clock.SetTimer(Control(0), 1, 100, dwNow));
+	CHECK(clock.GetNextDue(dwNow) == 16);
+	CHECK(clock.GetNextDue(dwNow + 10) == 6);
+	CHECK(clock.GetNextDue(dwNow + 40) == 0);
+
+	std::vector<CAnimationClock::TDue> aDue;
+	clock.Tick(dwNow + 10, aDue);
+	CHECK(aDue.size() == 2);
+	CHECK(aDue[0].pControl == Control(0) && aDue[0].nTimerID == 1);
+	CHECK(aDue[1].pControl == Control(0) && aDue[1].nTimerID == 2);
+	CHECK(clock.IsCurrent(aDue[0]) && clock.IsCurrent(aDue[1]));
+	CHECK(clock.GetNextDue(dwNow + 10) == 22);
+
+	// the first handler kills the second timer, and kills and sets the first one again: neither
+	// may be handed to its control from this tick
+	CHECK(clock.KillTimer(Control(0), 2));
+	CHECK(!clock.IsCurrent(aDue[1]));
+	CHECK(clock.KillTimer(Control(0), 1));
+	CHECK(clock.SetTimer(Control(0), 1, 16, dwNow + 10));
+	CHECK(!clock.IsCurrent(aDue[0]));
+	CHECK(!clock.KillTimer(Control(0), 2));
+
+	// killing a control kills its timers and no others
+	clock.Tick(dwNow + 60, aDue);
+	CHECK(aDue.size() == 2);
+	clock.KillTimer(Control(1));
+	CHECK(clock.GetCount() == 1);
+	for( size_t i = 0; i < aDue.size(); i++ ) CHECK(clock.IsCurrent(aDue[i]) == (aDue[i].pControl == Control(0)));
+	clock.RemoveAll();
+	CHECK(clock.GetCount() == 0 && clock.GetNextDue(dwNow) == -1);
+}
+
+static void TestWrap()
+{
+	CAnimationClock clock;
+	DWORD dwNow = 0xFFFFFFF0;
+	CHECK(clock.SetTimer(Control(0), 1, 40, dwNow));		// due at 0x18, after the wrap
+	CHECK(clock.SetTimer(Control(1), 1, 8, dwNow));		// due at 0xFFFFFFF8, before it
+	CHECK(clock.GetNextDue(dwNow) == 8);
+
+	std::vector<CAnimationClock::TDue> aDue;
+	clock.Tick(dwNow + 4, aDue);
+	CHECK(aDue.size() == 1 && aDue[0].pControl == Control(1));
+	// the one due before the wrap comes first, though its due time is the larger number
+	clock.Tick(0x10, aDue);
+	CHECK(aDue.size() == 2 && aDue[0].pControl == Control(1) && aDue[1].pControl == Control(0));
+	CHECK(clock.GetNextDue(0x10) == 8);
+	// a late timer is due now, not in four billion ms
+	CHECK(clock.GetNextDue(0x30) == 0);
+}
+
+static void TestModel()
+{
+	srand(72);
+	for( int nRun = 0; nRun < 200; nRun++ ) {
+		CAnimationClock clock;
+		CModel model;
+		DWORD dwNow = 0xFFFFFFFF - (DWORD)(rand() % 5000);
+		std::vector<CAnimationClock::TDue> aDue, aModelDue;
+		for( int nStep = 0; nStep < 500; nStep++ ) {
+			int iControl = rand() % 8;
+			UINT nTimerID = rand() % 4;
+			switch( rand() % 6 ) {
+			case 0:
+			case 1:
+				{
+					UINT uElapse = rand() % 5 == 0 ? 0 : rand() % 100;
+					CHECK(clock.SetTimer(Control(iControl), nTimerID, uElapse, dwNow) == model.SetTimer(Control(iControl), nTimerID, uElapse, dwNow));
+				}
+				break;
+			case 2:
+				CHECK(clock.KillTimer(Control(iControl), nTimerID) == model.KillTimer(Control(iControl), nTimerID));
+				break;
+			case 3:
+				clock.KillTimer(Control(iControl));
+				model.KillTimer(Control(iControl));
+				break;
+			default:
+				{
+					// time goes on, sometimes much longer than a frame
+					dwNow += rand() % 4 == 0 ? rand() % 300 : rand() % 20;
+					clock.Tick(dwNow, aDue);
+					model.Tick(dwNow, aModelDue);
+					CHECK(SameDue(aDue, aModelDue));
+					// the handlers kill timers, or kill and set them again, as they run
+					for( size_t i = 0; i < aDue.size(); i++ ) {
+						CHECK(clock.IsCurrent(aDue[i]) == model.IsCurrent(aDue[i]));
+						if( rand() % 4 != 0 ) continue;
+						const CAnimationClock::TDue& due = aDue[rand() % aDue.size()];
+						CHECK(clock.KillTimer(due.pControl, due.nTimerID) == model.KillTimer(due.pControl, due.nTimerID));
+						if( rand() % 2 ) CHECK(clock.SetTimer(due.pControl, due.nTimerID, 16, dwNow) && model.SetTimer(due.pControl, due.nTimerID, 16, dwNow));
+						CHECK(!clock.IsCurrent(due));
+					}
+				}
+				break;
+			}
+			CHECK(clock.GetCount() == model.GetCount());
+			CHECK(clock.GetNextDue(dwNow) == model.GetNextDue(dwNow));
+		}
+	}
+}
+
+int main()
+{
+	TestKilled();
+	TestWrap();
+	TestModel();
+	return TestResult("AnimationClockTest");
+}
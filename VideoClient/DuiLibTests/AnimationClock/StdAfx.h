@@ -0,0 +1,4 @@
+#pragma once
+
+#include "Win32Shim.h"
+#include "Core/UIAnimationClock.h"
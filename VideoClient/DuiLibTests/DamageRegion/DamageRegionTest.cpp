@@ -0,0 +1,167 @@
+// DamageRegionTest.cpp : CDamageRegion::Add and MergeCheapest on random sets of rects, from a few
+// small ones to many more than MAX_RECTS. Whatever was added has to be painted, so every pixel of
+// every rect added must be in a rect of the region; the region keeps MAX_RECTS rects at most, none
+// of them empty, its bounds are those of the rects added and it never paints more than one rect
+// around them all would. Clip, Intersects and RemoveAll are checked on the way.
+
+#include "StdAfx.h"
+#include "TestCheck.h"
+#include <stdlib.h>
+#include <algorithm>
+#include <vector>
+
+using namespace DuiLib;
+
+enum { WIDTH = 1280, HEIGHT = 800 };
+
+static int Area(const RECT& rc)
+{
+	return (rc.right - rc.left) * (rc.bottom - rc.top);
+}
+
+static RECT RandomRect()
+{
+	RECT rc = { 0 };
+	int cx, cy;
+	switch( rand() % 4 ) {
+	case 0: cx = 1 + rand() % 16; cy = 1 + rand() % 16; break;			// a caret, an icon
+	case 1: cx = 20 + rand() % 200; cy = 10 + rand() % 40; break;		// a label, a button
+	case 2: cx = 1 + rand() % WIDTH; cy = 1 + rand() % 8; break;		// a line
+	default: cx = 100 + rand() % 600; cy = 100 + rand() % 400; break;	// a panel
+	}
+	rc.left = rand() % WIDTH;
+	rc.top = rand() % HEIGHT;
+	rc.right = std::min(rc.left + cx, (int)WIDTH);
+	rc.bottom = std::min(rc.top + cy, (int)HEIGHT);
+	// now and then one that is empty, which Add leaves out
+	if( rand() % 50 == 0 ) rc.right = rc.left;
+	return rc;
+}
+
+static bool Covers(const CDamageRegion& region, int x, int y)
+{
+	for( int i = 0; i < region.GetCount(); i++ ) {
+		const RECT& rc = region.GetAt(i);
+		if( x >= rc.left && x < rc.right && y >= rc.top && y < rc.bottom ) return true;
+	}
+	return false;
+}
+
+// Every pixel of the rects added is in the region. The edges of all the rects cut the plane into
+// cells that are wholly in or out of each rect, so one pixel of each cell stands for all of it.
+static bool CoversAll(const CDamageRegion& region, const std::vector<RECT>& aAdded)
+{
+	std::vector<int> aX, aY;
+	for( size_t i = 0; i < aAdded.size(); i++ ) {
+		aX.push_back(aAdded[i].left); aX.push_back(aAdded[i].right);
+		aY.push_back(aAdded[i].top); aY.push_back(aAdded[i].bottom);
+	}
+	for( int i = 0; i < region.GetCount(); i++ ) {
+		const RECT& rc = region.GetAt(i);
+		aX.push_back(rc.left); aX.push_back(rc.right);
+		aY.push_back(rc.top); aY.push_back(rc.bottom);
+	}
+	std::sort(aX.begin(), aX.end());
+	aX.erase(std::unique(aX.begin(), aX.end()), aX.end());
+	std::sort(aY.begin(), aY.end());
+	aY.erase(std::unique(aY.begin(), aY.end()), aY.end());
+	for( size_t i = 0; i < aAdded.size(); i++ ) {
+		const RECT& rc = aAdded[i];
+		size_t x0 = std::lower_bound(aX.begin(), aX.end(), rc.left) - aX.begin();
+		size_t y0 = std::lower_bound(aY.begin(), aY.end(), rc.top) - aY.begin();
+		for( size_t ix = x0; ix + 1 < aX.size() && aX[ix] < rc.right; ix++ ) {
+			for( size_t iy = y0; iy + 1 < aY.size() && aY[iy] < rc.bottom; iy++ ) {
+				if( !Covers(region, aX[ix], aY[iy]) ) return false;
+			}
+		}
+	}
+	return true;
+}
+
+static void TestRandomSets()
+{
+	srand(74);
+	CDamageRegion region;
+	for( int nSet = 0; nSet < 10000; nSet++ ) {
+		region.RemoveAll();
+		CHECK(region.IsEmpty() && region.GetCount() == 0 && region.GetArea() == 0);
+		int nRects = nSet % 4 == 0 ? 1 + rand() % 4 : 1 + rand() % 40;
+		std::vector<RECT> aAdded;
+		RECT rcBounds = { 0 };
+		for( int i = 0; i < nRects; i++ ) {
+			RECT rc = RandomRect();
+			region.Add(rc);
+			if( ::IsRectEmpty(&rc) ) continue;
+			aAdded.push_back(rc);
+			::UnionRect(&rcBounds, &rcBounds, &rc);
+			CHECK(region.GetCount() <= CDamageRegion::MAX_RECTS);
+		}
+		CHECK(region.IsEmpty() == aAdded.empty());
+		for( int i = 0; i < region.GetCount(); i++ ) CHECK(!::IsRectEmpty(&region.GetAt(i)));
+		CHECK(CoversAll(region, aAdded));
+
+		RECT rcRegion = region.GetBounds();
+		CHECK(::EqualRect(&rcRegion, &rcBounds));
+		CHECK(region.GetArea() <= (DWORD)Area(rcBounds));
+		if( aAdded.size() == 1 ) CHECK(region.GetCount() == 1 && ::EqualRect(&region.GetAt(0), &aAdded[0]));
+
+		// Intersects is true exactly where the region paints
+		for( int k = 0; k < 8; k++ ) {
+			RECT rcProbe = { 0 };
+			rcProbe.left = rand() % WIDTH;
+			rcProbe.top = rand() % HEIGHT;
+			rcProbe.right = rcProbe.left + 1;
+			rcProbe.bottom = rcProbe.top + 1;
+			CHECK(region.Intersects(rcProbe) == Covers(region, rcProbe.left, rcProbe.top));
+		}
+
+		// clipped to a part of the window, the region covers what was added inside it
+		RECT rcClip = RandomRect();
+		if( ::IsRectEmpty(&rcClip) ) continue;
+		region.Clip(rcClip);
+		std::vector<RECT> aClipped;
+		for( size_t i = 0; i < aAdded.size(); i++ ) {
+			RECT rc;
+			if( ::IntersectRect(&rc, &aAdded[i], &rcClip) ) aClipped.push_back(rc);
+		}
+		CHECK(CoversAll(region, aClipped));
+		for( int i = 0; i < region.GetCount(); i++ ) {
+			RECT rc;
+			CHECK(::IntersectRect(&rc, &region.GetAt(i), &rcClip) && ::EqualRect(&rc, &region.GetAt(i)));
+		}
+	}
+}
+
+static void TestFolding()
+{
+	CDamageRegion region;
+	// two small changes in opposite corners stay apart
+	RECT rcA = { 0, 0, 10, 10 };
+	RECT rcB = { 1000, 700, 1010, 710 };
+	region.Add(rcA);
+	region.Add(rcB);
+	CHECK(region.GetCount() == 2 && region.GetArea() == 200);
+	// one next to the first folds into it
+	RECT rcC = { 10, 0, 20, 10 };
+	region.Add(rcC);
+	CHECK(region.GetCount() == 2 && region.GetArea() == 300);
+	// one inside a rect adds nothing
+	RECT rcD = { 2, 2, 4, 4 };
+	region.Add(rcD);
+	CHECK(region.GetCount() == 2 && region.GetArea() == 300);
+
+	// a row of far apart rects folds down to MAX_RECTS
+	region.RemoveAll();
+	for( int i = 0; i < 3 * CDamageRegion::MAX_RECTS; i++ ) {
+		RECT rc = { i * 300, (i % 2) * 700, i * 300 + 10, (i % 2) * 700 + 10 };
+		region.Add(rc);
+		CHECK(region.GetCount() == std::min(i + 1, (int)CDamageRegion::MAX_RECTS));
+	}
+}
+
+int main()
+{
+	TestFolding();
+	TestRandomSets();
+	return TestResult("DamageRegionTest");
+}
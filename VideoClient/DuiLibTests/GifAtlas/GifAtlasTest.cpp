@@ -0,0 +1,47 @@
+// GifAtlasTest.cpp : CGifAtlas::Decode on a two frame GIF of one pixel, written out by hand, with
+// and without the byte cap: the frames that fit are all kept, a GIF over the cap keeps its first
+// frame only, and one whose first frame is over it too is not decoded.
+
+#include "StdAfx.h"
+#include "TestCheck.h"
+#include "Utils/GifAtlas.h"
+
+using namespace DuiLib;
+
+// 1x1, a red and green palette, the first frame 100ms and the second 200ms, both colour 0
+static const BYTE GIF_TWO_FRAMES[] = {
+	'G', 'I', 'F', '8', '9', 'a', 1, 0, 1, 0, 0x80, 0, 0, 0xFF, 0, 0, 0, 0xFF, 0,
+	0x21, 0xF9, 4, 0, 10, 0, 0, 0, 0x2C, 0, 0, 0, 0, 1, 0, 1, 0, 0, 2, 2, 0x44, 0x01, 0,
+	0x21, 0xF9, 4, 0, 20, 0, 0, 0, 0x2C, 0, 0, 0, 0, 1, 0, 1, 0, 0, 2, 2, 0x44, 0x01, 0,
+	0x3B
+};
+
+int main()
+{
+	CGifAtlas* pAtlas = CGifAtlas::Decode(GIF_TWO_FRAMES, sizeof(GIF_TWO_FRAMES));
+	CHECK(pAtlas != NULL);
+	if( pAtlas != NULL ) {
+		CHECK(pAtlas->GetWidth() == 1 && pAtlas->GetHeight() == 1 && pAtlas->GetFrameCount() == 2);
+		CHECK(pAtlas->GetDelay(0) == 100 && pAtlas->GetDelay(1) == 200);
+		CHECK(pAtlas->GetBits()[0] == 0xFFFF0000 && pAtlas->GetBits()[1] == 0xFFFF0000);
+		delete pAtlas;
+	}
+
+	// exactly the two frames
+	pAtlas = CGifAtlas::Decode(GIF_TWO_FRAMES, sizeof(GIF_TWO_FRAMES), 0, 2 * sizeof(DWORD));
+	CHECK(pAtlas != NULL && pAtlas->GetFrameCount() == 2);
+	delete pAtlas;
+
+	// a byte short: a still of the first frame
+	pAtlas = CGifAtlas::Decode(GIF_TWO_FRAMES, sizeof(GIF_TWO_FRAMES), 0, 2 * sizeof(DWORD) - 1);
+	CHECK(pAtlas != NULL);
+	if( pAtlas != NULL ) {
+		CHECK(pAtlas->GetFrameCount() == 1 && pAtlas->GetHeight() == 1 && pAtlas->GetDelay(0) == 100);
+		CHECK(pAtlas->GetBits()[0] == 0xFFFF0000);
+		delete pAtlas;
+	}
+
+	CHECK(CGifAtlas::Decode(GIF_TWO_FRAMES, sizeof(GIF_TWO_FRAMES), 0, sizeof(DWORD) - 1) == NULL);
+	CHECK(CGifAtlas::Decode(GIF_TWO_FRAMES, 6) == NULL);
+	return TestResult("GifAtlasTest");
+}
@@ -0,0 +1,259 @@
+// HitTest.cpp : CHitTestIndex::Find against the FindControl walk it stands in for, on random
+// trees of overlapping, clipped, hidden, float and mouse-disabled controls with insets and
+// scroll bars, for every flag combination the paint manager passes, at points inside and
+// around the window; then after the tree changes and the index is invalidated, and on a
+// video wall laid out as the client lays one out.
+
+#include "StdAfx.h"
+#include "TestCheck.h"
+#include "Core/UIHitTest.cpp"
+
+namespace DuiLib {
+
+	// as in UIControl.cpp
+	CControlUI* CControlUI::FindControl(FINDCONTROLPROC Proc, LPVOID pData, UINT uFlags)
+	{
+		if( (uFlags & UIFIND_VISIBLE) != 0 && !IsVisible() ) return NULL;
+		if( (uFlags & UIFIND_ENABLED) != 0 && !IsEnabled() ) return NULL;
+		if( (uFlags & UIFIND_HITTEST) != 0 && (!m_bMouseEnabled || !::PtInRect(&m_rcItem, * static_cast<LPPOINT>(pData))) ) return NULL;
+		return Proc(this, pData);
+	}
+
+	// as in UIContainer.cpp
+	CControlUI* CContainerUI::FindControl(FINDCONTROLPROC Proc, LPVOID pData, UINT uFlags)
+	{
+		if( (uFlags & UIFIND_VISIBLE) != 0 && !IsVisible() ) return NULL;
+		if( (uFlags & UIFIND_ENABLED) != 0 && !IsEnabled() ) return NULL;
+		if( (uFlags & UIFIND_HITTEST) != 0 && !::PtInRect(&m_rcItem, *(static_cast<LPPOINT>(pData))) ) return NULL;
+		if( (uFlags & UIFIND_UPDATETEST) != 0 && Proc(this, pData) != NULL ) return NULL;
+
+		CControlUI* pResult = NULL;
+		if( (uFlags & UIFIND_ME_FIRST) != 0 ) {
+			if( (uFlags & UIFIND_HITTEST) == 0 || IsMouseEnabled() ) pResult = Proc(this, pData);
+		}
+		if( pResult == NULL && m_pVerticalScrollBar != NULL ) {
+			if( (uFlags & UIFIND_HITTEST) == 0 || IsMouseEnabled() ) pResult = m_pVerticalScrollBar->FindControl(Proc, pData, uFlags);
+		}
+		if( pResult == NULL && m_pHorizontalScrollBar != NULL ) {
+			if( (uFlags & UIFIND_HITTEST) == 0 || IsMouseEnabled() ) pResult = m_pHorizontalScrollBar->FindControl(Proc, pData, uFlags);
+		}
+		if( pResult != NULL ) return pResult;
+
+		if( (uFlags & UIFIND_HITTEST) == 0 || IsMouseChildEnabled() ) {
+			RECT rc = m_rcItem;
+			rc.left += m_rcInset.left;
+			rc.top += m_rcInset.top;
+			rc.right -= m_rcInset.right;
+			rc.bottom -= m_rcInset.bottom;
+			if( m_pVerticalScrollBar && m_pVerticalScrollBar->IsVisible() ) rc.right -= m_pVerticalScrollBar->GetFixedWidth();
+			if( m_pHorizontalScrollBar && m_pHorizontalScrollBar->IsVisible() ) rc.bottom -= m_pHorizontalScrollBar->GetFixedHeight();
+			if( (uFlags & UIFIND_TOP_FIRST) != 0 ) {
+				for( int it = m_items.GetSize() - 1; it >= 0; it-- ) {
+					pResult = static_cast<CControlUI*>(m_items[it])->FindControl(Proc, pData, uFlags);
+					if( pResult != NULL ) {
+						if( (uFlags & UIFIND_HITTEST) != 0 && !pResult->IsFloat() && !::PtInRect(&rc, *(static_cast<LPPOINT>(pData))) )
+							continue;
+						else
+							return pResult;
+					}
+				}
+			}
+			else {
+				for( int it = 0; it < m_items.GetSize(); it++ ) {
+					pResult = static_cast<CControlUI*>(m_items[it])->FindControl(Proc, pData, uFlags);
+					if( pResult != NULL ) {
+						if( (uFlags & UIFIND_HITTEST) != 0 && !pResult->IsFloat() && !::PtInRect(&rc, *(static_cast<LPPOINT>(pData))) )
+							continue;
+						else
+							return pResult;
+					}
+				}
+			}
+		}
+
+		pResult = NULL;
+		if( pResult == NULL && (uFlags & UIFIND_ME_FIRST) == 0 ) {
+			if( (uFlags & UIFIND_HITTEST) == 0 || IsMouseEnabled() ) pResult = Proc(this, pData);
+		}
+		return pResult;
+	}
+
+} // namespace DuiLib
+
+using namespace DuiLib;
+
+// the FindControl(pt) callback of CPaintManagerUI
+static CControlUI* CALLBACK __FindControlFromPoint(CControlUI* pThis, LPVOID pData)
+{
+	LPPOINT pPoint = static_cast<LPPOINT>(pData);
+	return ::PtInRect(&pThis->GetPos(), *pPoint) ? pThis : NULL;
+}
+
+static const UINT FLAGS[] =
+{
+	UIFIND_VISIBLE | UIFIND_HITTEST | UIFIND_TOP_FIRST,
+	UIFIND_VISIBLE | UIFIND_HITTEST,
+	UIFIND_HITTEST | UIFIND_TOP_FIRST,
+	UIFIND_VISIBLE | UIFIND_HITTEST | UIFIND_TOP_FIRST | UIFIND_ME_FIRST,
+	UIFIND_VISIBLE | UIFIND_HITTEST | UIFIND_ME_FIRST,
+};
+
+static int Random(int n)
+{
+	return rand() % n;
+}
+
+// somewhere in and around the parent, sometimes empty, with random flags
+static void Scatter(CControlUI* pControl, const RECT& rcParent)
+{
+	int cx = rcParent.right - rcParent.left < 2 ? 2 : rcParent.right - rcParent.left;
+	int cy = rcParent.bottom - rcParent.top < 2 ? 2 : rcParent.bottom - rcParent.top;
+	RECT& rc = pControl->m_rcItem;
+	rc.left = rcParent.left + Random(cx) - cx / 8;
+	rc.top = rcParent.top + Random(cy) - cy / 8;
+	rc.right = rc.left + Random(cx) + 1;
+	rc.bottom = rc.top + Random(cy) + 1;
+	if( Random(10) == 0 ) rc.right = rc.left;
+	pControl->m_bVisible = Random(12) != 0;
+	pControl->m_bInternVisible = Random(20) != 0;
+	pControl->m_bMouseEnabled = Random(5) != 0;
+	pControl->m_bFloat = Random(6) == 0;
+	pControl->m_cxyFixed = Random(20);
+}
+
+static CControlUI* MakeTree(const RECT& rcParent, int nDepth, std::vector<CControlUI*>& aControls)
+{
+	if( nDepth == 0 || Random(3) == 0 ) {
+		CControlUI* pControl = new CControlUI;
+		Scatter(pControl, rcParent);
+		aControls.push_back(pControl);
+		return pControl;
+	}
+	CContainerUI* pContainer = new CContainerUI;
+	Scatter(pContainer, rcParent);
+	aControls.push_back(pContainer);
+	pContainer->m_bMouseChildEnabled = Random(8) != 0;
+	RECT rcInset = { Random(15), Random(15), Random(15), Random(15) };
+	pContainer->m_rcInset = rcInset;
+	if( Random(3) == 0 ) {
+		pContainer->m_pVerticalScrollBar = new CScrollBarUI;
+		Scatter(pContainer->m_pVerticalScrollBar, pContainer->m_rcItem);
+		aControls.push_back(pContainer->m_pVerticalScrollBar);
+	}
+	if( Random(4) == 0 ) {
+		pContainer->m_pHorizontalScrollBar = new CScrollBarUI;
+		Scatter(pContainer->m_pHorizontalScrollBar, pContainer->m_rcItem);
+		aControls.push_back(pContainer->m_pHorizontalScrollBar);
+	}
+	int nItems = Random(7);
+	for( int i = 0; i < nItems; i++ ) pContainer->m_items.Add(MakeTree(pContainer->m_rcItem, nDepth - 1, aControls));
+	return pContainer;
+}
+
+// every flag combination at points in and just outside the window
+static int Compare(CHitTestIndex& index, CContainerUI* pRoot, int nPoints)
+{
+	const RECT& rc = pRoot->m_rcItem;
+	int nHits = 0;
+	for( size_t f = 0; f < lengthof(FLAGS); f++ ) {
+		for( int q = 0; q < nPoints; q++ ) {
+			POINT pt = { rc.left + Random(rc.right - rc.left + 40) - 20, rc.top + Random(rc.bottom - rc.top + 40) - 20 };
+			CControlUI* pExpected = pRoot->FindControl(__FindControlFromPoint, &pt, FLAGS[f]);
+			CControlUI* pFound = index.Find(pRoot, pt, FLAGS[f]);
+			CHECK(pFound == pExpected);
+			if( pFound != NULL ) nHits++;
+		}
+	}
+	return nHits;
+}
+
+static void TestRandomTrees()
+{
+	int nHits = 0, nControls = 0;
+	for( int t = 0; t < 1500; t++ ) {
+		std::vector<CControlUI*> aControls;
+		CContainerUI* pRoot = new CContainerUI;
+		RECT rcRoot = { 0, 0, 200 + Random(2000), 200 + Random(1200) };
+		pRoot->m_rcItem = rcRoot;
+		pRoot->m_bMouseEnabled = Random(2) != 0;
+		int nItems = 1 + Random(8);
+		for( int i = 0; i < nItems; i++ ) pRoot->m_items.Add(MakeTree(rcRoot, 1 + Random(5), aControls));
+		nControls += (int)aControls.size();
+
+		CHitTestIndex index;
+		nHits += Compare(index, pRoot, 200);
+
+		// the index keeps its answers until it is told the tree changed
+		if( !aControls.empty() ) {
+			for( int i = 0; i < 5; i++ ) Scatter(aControls[Random((int)aControls.size())], rcRoot);
+			index.Invalidate();
+			CHECK(!index.IsValid());
+			nHits += Compare(index, pRoot, 100);
+			CHECK(index.IsValid());
+		}
+		delete pRoot;
+	}
+	printf("random trees: %d controls, %d hits\n", nControls, nHits);
+}
+
+// 10x10 tiles, each a video with a caption of mouse-transparent labels and a bar of buttons
+static void TestVideoWall()
+{
+	CContainerUI* pRoot = new CContainerUI;
+	RECT rcRoot = { 0, 0, 1920, 1080 };
+	pRoot->m_rcItem = rcRoot;
+	for( int y = 0; y < 10; y++ ) {
+		for( int x = 0; x < 10; x++ ) {
+			CContainerUI* pTile = new CContainerUI;
+			RECT rcTile = { x * 192, y * 108, x * 192 + 192, y * 108 + 108 };
+			pTile->m_rcItem = rcTile;
+			CControlUI* pVideo = new CControlUI;
+			pVideo->m_rcItem = rcTile;
+			pTile->m_items.Add(pVideo);
+			for( int i = 0; i < 4; i++ ) {
+				CControlUI* pLabel = new CControlUI;
+				RECT rcLabel = { rcTile.left + 4, rcTile.top + 4 + i * 12, rcTile.left + 100, rcTile.top + 14 + i * 12 };
+				pLabel->m_rcItem = rcLabel;
+				pLabel->m_bMouseEnabled = false;
+				pTile->m_items.Add(pLabel);
+			}
+			CContainerUI* pBar = new CContainerUI;
+			RECT rcBar = { rcTile.left, rcTile.bottom - 24, rcTile.right, rcTile.bottom };
+			pBar->m_rcItem = rcBar;
+			for( int i = 0; i < 6; i++ ) {
+				CControlUI* pButton = new CControlUI;
+				RECT rcButton = { rcBar.left + i * 24, rcBar.top, rcBar.left + i * 24 + 22, rcBar.bottom };
+				pButton->m_rcItem = rcButton;
+				pBar->m_items.Add(pButton);
+			}
+			pTile->m_items.Add(pBar);
+			pRoot->m_items.Add(pTile);
+		}
+	}
+	CHitTestIndex index;
+	Compare(index, pRoot, 20000);
+	CHECK(index.GetCount() == 1 + 100 * (1 + 1 + 4 + 1 + 6));
+
+	// over a button of the bar, over the gap between two, and over a label over the video
+	POINT pt = { 192 * 3 + 24 + 5, 108 * 2 + 100 };
+	CContainerUI* pTile = static_cast<CContainerUI*>(pRoot->m_items[2 * 10 + 3]);
+	CContainerUI* pBar = static_cast<CContainerUI*>(pTile->m_items[5]);
+	CHECK(index.Find(pRoot, pt, FLAGS[0]) == pBar->m_items[1]);
+	pt.x = 192 * 3 + 22;
+	CHECK(index.Find(pRoot, pt, FLAGS[0]) == pBar);
+	pt.x = 192 * 3 + 10;
+	pt.y = 108 * 2 + 10;
+	CHECK(index.Find(pRoot, pt, FLAGS[0]) == pTile->m_items[0]);
+	delete pRoot;
+}
+
+int main()
+{
+	srand(68);
+	TestRandomTrees();
+	TestVideoWall();
+	CHitTestIndex index;
+	POINT pt = { 0, 0 };
+	CHECK(index.Find(NULL, pt, FLAGS[0]) == NULL);
+	return TestResult("HitTest");
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "Win32Shim.h"
+#include "Utils/Utils.h"
+#include <vector>
+
+// Stand-ins for the controls, with just what CHitTestIndex and the FindControl walk read.
+// The real ones need a paint manager and a window; HitTest.cpp carries FindControl as it is
+// in UIControl.cpp and UIContainer.cpp.
+
+#define UIFIND_ALL           0x00000000
+#define UIFIND_VISIBLE       0x00000001
+#define UIFIND_ENABLED       0x00000002
+#define UIFIND_HITTEST       0x00000004
+#define UIFIND_UPDATETEST    0x00000008
+#define UIFIND_TOP_FIRST     0x00000010
+#define UIFIND_ME_FIRST      0x80000000
+
+namespace DuiLib {
+
+	class CControlUI;
+	typedef CControlUI* (CALLBACK* FINDCONTROLPROC)(CControlUI*, LPVOID);
+
+	class CControlUI
+	{
+	public:
+		CControlUI() : m_bVisible(true), m_bInternVisible(true), m_bEnabled(true), m_bMouseEnabled(true), m_bFloat(false), m_cxyFixed(0)
+		{
+			::ZeroMemory(&m_rcItem, sizeof(m_rcItem));
+		}
+		virtual ~CControlUI() { }
+
+		const RECT& GetPos() const { return m_rcItem; }
+		bool IsVisible() const { return m_bVisible && m_bInternVisible; }
+		bool IsEnabled() const { return m_bEnabled; }
+		bool IsMouseEnabled() const { return m_bMouseEnabled; }
+		bool IsFloat() const { return m_bFloat; }
+		int GetFixedWidth() const { return m_cxyFixed; }
+		int GetFixedHeight() const { return m_cxyFixed; }
+		virtual CControlUI* FindControl(FINDCONTROLPROC Proc, LPVOID pData, UINT uFlags);
+
+		RECT m_rcItem;
+		bool m_bVisible;
+		bool m_bInternVisible;
+		bool m_bEnabled;
+		bool m_bMouseEnabled;
+		bool m_bFloat;
+		int m_cxyFixed;
+	};
+
+	class CScrollBarUI : public CControlUI
+	{
+	};
+
+	class CContainerUI : public CControlUI
+	{
+		friend class CHitTestIndex;
+	public:
+		CContainerUI() : m_bMouseChildEnabled(true), m_pVerticalScrollBar(NULL), m_pHorizontalScrollBar(NULL)
+		{
+			::ZeroMemory(&m_rcInset, sizeof(m_rcInset));
+		}
+		virtual ~CContainerUI()
+		{
+			for( int it = 0; it < m_items.GetSize(); it++ ) delete static_cast<CControlUI*>(m_items[it]);
+			delete m_pVerticalScrollBar;
+			delete m_pHorizontalScrollBar;
+		}
+
+		bool IsMouseChildEnabled() const { return m_bMouseChildEnabled; }
+		CControlUI* FindControl(FINDCONTROLPROC Proc, LPVOID pData, UINT uFlags);
+
+		CStdPtrArray m_items;
+		RECT m_rcInset;
+		bool m_bMouseChildEnabled;
+		CScrollBarUI* m_pVerticalScrollBar;
+		CScrollBarUI* m_pHorizontalScrollBar;
+	};
+
+} // namespace DuiLib
+
+#include "Core/UIHitTest.h"
@@ -0,0 +1,108 @@
+// HtmlLayoutBench.cpp : a list of showhtml cells painted over and over, laid out afresh on every
+// paint as DrawHtmlText used to, against looked up in a CHtmlLayoutCache as it does now. Also
+// counts the text measurements, the GetTextExtentPoint32 calls of the real host.
+// usage: HtmlLayoutBench [cells] [paints]
+
+#include "StdAfx.h"
+#include "TestHost.h"
+#include <chrono>
+
+using namespace DuiLib;
+
+typedef std::chrono::steady_clock Clock;
+
+static double Ms(Clock::time_point t0, Clock::time_point t1)
+{
+	return std::chrono::duration<double, std::milli>(t1 - t0).count();
+}
+
+struct TCell
+{
+	std::string sText;
+	int cx;
+	UINT uStyle;
+};
+
+static std::vector<TCell> MakeCells(int nCells)
+{
+	std::vector<TCell> aCells(nCells);
+	char sz[256];
+	for( int i = 0; i < nCells; i++ ) {
+		switch( i % 3 ) {
+		case 0:
+			snprintf(sz, sizeof(sz), "<b>Contact %d</b> <c #888888>away since 10:%02d</c>", i, i % 60);
+			aCells[i].uStyle = DT_SINGLELINE | DT_END_ELLIPSIS;
+			break;
+		case 1:
+			snprintf(sz, sizeof(sz), "<i icon.png 4 %d> %d.mp4 <a open %d>open</a> <a folder>show in folder</a>", i % 4, i, i);
+			aCells[i].uStyle = DT_SINGLELINE;
+			break;
+		default:
+			snprintf(sz, sizeof(sz), "The call with <b>room %d</b> was recorded; <u>the recording</u> is kept for %d days<n>"
+				"<f 1>%d</f> participants", i, 7 + i % 30, 2 + i % 9);
+			aCells[i].uStyle = DT_WORDBREAK;
+			break;
+		}
+		aCells[i].sText = sz;
+		aCells[i].cx = 120 + (i * 37) % 120;
+	}
+	return aCells;
+}
+
+int main(int argc, char* argv[])
+{
+	int nCells = argc > 1 ? atoi(argv[1]) : 200;
+	int nPaints = argc > 2 ? atoi(argv[2]) : 500;
+	std::vector<TCell> aCells = MakeCells(nCells);
+	printf("%d cells, %d paints\n", nCells, nPaints);
+
+	CTestHost host;
+	size_t nRuns = 0;
+	Clock::time_point t0 = Clock::now();
+	for( int p = 0; p < nPaints; p++ ) {
+		for( int i = 0; i < nCells; i++ ) {
+			CHtmlLayout layout;
+			layout.Build(&host, aCells[i].sText.c_str(), aCells[i].cx, 40, aCells[i].uStyle, 0x333333, 0x0000FF, NULL, 8);
+			nRuns += layout.GetRunCount();
+		}
+	}
+	Clock::time_point t1 = Clock::now();
+	int nBuildWidths = host.m_nTextWidths;
+
+	host.m_nTextWidths = 0;
+	CHtmlLayoutCache cache;
+	size_t nCachedRuns = 0;
+	Clock::time_point t2 = Clock::now();
+	for( int p = 0; p < nPaints; p++ ) {
+		for( int i = 0; i < nCells; i++ ) {
+			CHtmlLayoutCache::TKey key;
+			key.sText = aCells[i].sText;
+			key.bHoverLink = false;
+			key.cx = aCells[i].cx;
+			key.cy = 40;
+			key.uStyle = aCells[i].uStyle;
+			key.dwTextColor = 0x333333;
+			key.dwLinkHoverColor = 0x0000FF;
+			key.nLinkRects = 8;
+			key.nScale = 100;
+			key.uSerial = 1;
+			const CHtmlLayout* pLayout = cache.Find(key);
+			if( pLayout == NULL ) {
+				CHtmlLayout* pNew = new CHtmlLayout;
+				pNew->Build(&host, key.sText.c_str(), key.cx, key.cy, key.uStyle, key.dwTextColor, key.dwLinkHoverColor, NULL, key.nLinkRects);
+				pLayout = cache.Add(key, pNew);
+			}
+			nCachedRuns += pLayout->GetRunCount();
+		}
+	}
+	Clock::time_point t3 = Clock::now();
+	if( nRuns != nCachedRuns ) {
+		printf("the cached layouts differ\n");
+		return 1;
+	}
+
+	printf("build every paint: %8.4f ms a paint, %7.1f measurements a paint\n", Ms(t0, t1) / nPaints, (double)nBuildWidths / nPaints);
+	printf("cached:            %8.4f ms a paint, %7.1f measurements a paint, %d layouts\n", Ms(t2, t3) / nPaints,
+		(double)host.m_nTextWidths / nPaints, cache.GetCount());
+	return 0;
+}
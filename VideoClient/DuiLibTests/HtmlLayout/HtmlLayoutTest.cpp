@@ -0,0 +1,310 @@
+// HtmlLayoutTest.cpp : CHtmlLayout::Build against a host with made-up font metrics, so the
+// parser and the line breaker run without a DC. Hand-worked layouts cover the tags, word
+// breaking, links, images, escapes, alignment and DT_CALCRECT; random markup checks that every
+// visible character comes out once and in order, and that broken lines stay inside the rect.
+// Then CHtmlLayoutCache: hits, the least recently drawn layout dropped, and the serial.
+
+#include "StdAfx.h"
+#include "TestCheck.h"
+#include "TestHost.h"
+
+using namespace DuiLib;
+
+static std::string RunText(const CHtmlLayout& layout, int iRun)
+{
+	const CHtmlLayout::TRun& run = layout.GetRun(iRun);
+	return std::string(layout.GetChars(run.iText), run.cchText);
+}
+
+static bool IsText(const CHtmlLayout& layout, int iRun, const char* pstrText, int x, int y)
+{
+	if( iRun >= layout.GetRunCount() ) return false;
+	const CHtmlLayout::TRun& run = layout.GetRun(iRun);
+	if( run.iKind != CHtmlLayout::RUN_TEXT || RunText(layout, iRun) != pstrText || run.rc.left != x || run.rc.top != y ) {
+		fprintf(stderr, "run %d is '%s' at %d,%d\n", iRun, RunText(layout, iRun).c_str(), (int)run.rc.left, (int)run.rc.top);
+		return false;
+	}
+	return true;
+}
+
+static bool IsRect(const RECT& rc, int left, int top, int right, int bottom)
+{
+	return rc.left == left && rc.top == top && rc.right == right && rc.bottom == bottom;
+}
+
+static void TestKnownLayouts()
+{
+	CTestHost host;
+	CTestHost::TFont* pDefault = &host.m_aFonts[0];
+	CHtmlLayout layout;
+
+	layout.Build(&host, "Hello", 100, 100, 0, 0x123456, 0, NULL, 0);
+	CHECK(layout.GetRunCount() == 1 && IsText(layout, 0, "Hello", 0, 0));
+	CHECK(layout.GetRun(0).hFont == pDefault && layout.GetRun(0).dwColor == 0x123456 && !layout.GetRun(0).bOpaque);
+	CHECK(layout.IsComplete() && layout.GetLinkCount() == 0);
+
+	// a piece of text runs up to the next tag
+	layout.Build(&host, "ab <b>cd</b>e", 100, 100, 0, 0, 0, NULL, 0);
+	CHECK(layout.GetRunCount() == 3);
+	CHECK(IsText(layout, 0, "ab ", 0, 0) && IsText(layout, 1, "cd", 18, 0) && IsText(layout, 2, "e", 32, 0));
+	CTestHost::TFont* pBold = static_cast<CTestHost::TFont*>(layout.GetRun(1).hFont);
+	CHECK(pBold->bBold && !pBold->bUnderline && pBold->nSize == 12 && layout.GetRun(2).hFont == pDefault);
+
+	// colours nest and come back
+	layout.Build(&host, "<c #FF0000>r<c 00FF00>g</c>r</c>d", 100, 100, 0, 0x111111, 0, NULL, 0);
+	CHECK(layout.GetRunCount() == 4);
+	CHECK(layout.GetRun(0).dwColor == 0xFF0000 && layout.GetRun(1).dwColor == 0x00FF00);
+	CHECK(layout.GetRun(2).dwColor == 0xFF0000 && layout.GetRun(3).dwColor == 0x111111);
+
+	// broken after the last space that fits, the rest on the next line
+	layout.Build(&host, "aaaa bbbb cccc", 60, 100, DT_WORDBREAK, 0, 0, NULL, 0);
+	CHECK(layout.GetRunCount() == 2 && IsText(layout, 0, "aaaa bbbb ", 0, 0) && IsText(layout, 1, "cccc", 0, 18));
+	// and without DT_WORDBREAK wherever the line is full
+	layout.Build(&host, "aaaa bbbb cccc", 60, 100, 0, 0, 0, NULL, 0);
+	CHECK(layout.GetRunCount() == 2 && IsText(layout, 0, "aaaa bbbb c", 0, 0) && IsText(layout, 1, "ccc", 0, 18));
+
+	// a larger font on the line puts everything on the same bottom
+	layout.Build(&host, "a<f 1>B</f><n>c", 100, 100, 0, 0, 0, NULL, 0);
+	CHECK(layout.GetRunCount() == 3);
+	CHECK(IsText(layout, 0, "a", 0, 8) && IsText(layout, 1, "B", 6, 0) && IsText(layout, 2, "c", 0, 26));
+	CHECK(static_cast<CTestHost::TFont*>(layout.GetRun(1).hFont)->nSize == 20);
+	layout.Build(&host, "<f Mono 8 Bold Italic>x</f>", 100, 100, 0, 0, 0, NULL, 0);
+	CTestHost::TFont* pMono = static_cast<CTestHost::TFont*>(layout.GetRun(0).hFont);
+	CHECK(pMono->sFace == "Mono" && pMono->nSize == 8 && pMono->bBold && pMono->bItalic && !pMono->bUnderline);
+
+	// links: the rect and the text of each, and the hover colour on the hovered one; a space
+	// after a tag is a run of its own
+	layout.Build(&host, "go <a http://x>here</a> or <a y>there</a>", 200, 100, 0, 0x111111, 0x0000FF, "y", 4);
+	CHECK(layout.GetLinkCount() == 2 && layout.GetLinkRectCount() == 2 && layout.GetLinkTextCount() == 2);
+	CHECK(strcmp(layout.GetLinkText(0), "http://x") == 0 && strcmp(layout.GetLinkText(1), "y") == 0);
+	CHECK(IsRect(layout.GetLinkRect(0), 18, 0, 42, 18) && IsRect(layout.GetLinkRect(1), 66, 0, 96, 18));
+	CHECK(layout.GetRunCount() == 5 && IsText(layout, 1, "here", 18, 0) && IsText(layout, 2, " ", 42, 0));
+	CHECK(IsText(layout, 3, "or ", 48, 0) && IsText(layout, 4, "there", 66, 0));
+	CHECK(static_cast<CTestHost::TFont*>(layout.GetRun(1).hFont)->bUnderline);
+	CHECK(layout.GetRun(1).dwColor == 0x111111 && layout.GetRun(4).dwColor == 0x0000FF);
+	// no more links than there is room for, and the text after is drawn all the same
+	layout.Build(&host, "<a p>1</a><a q>2</a>3", 100, 100, 0, 0, 0, NULL, 1);
+	CHECK(layout.GetLinkCount() == 1 && strcmp(layout.GetLinkText(0), "p") == 0 && layout.GetRunCount() == 3);
+	// a link broken over two lines is two rects under the same text
+	layout.Build(&host, "<a z>aaaa bbbb</a>", 30, 100, DT_WORDBREAK, 0, 0, NULL, 4);
+	CHECK(layout.GetLinkCount() == 2 && strcmp(layout.GetLinkText(1), "z") == 0);
+	CHECK(IsRect(layout.GetLinkRect(0), 0, 0, 30, 18) && IsRect(layout.GetLinkRect(1), 0, 18, 24, 36));
+
+	// an imagelist cell, centred on the line; an image that isn't there yet leaves the layout
+	// incomplete
+	layout.Build(&host, "<i img.png 2 1>x", 100, 100, 0, 0, 0, NULL, 0);
+	CHECK(layout.GetRunCount() == 2 && layout.GetRun(0).iKind == CHtmlLayout::RUN_IMAGE && layout.IsComplete());
+	CHECK(IsRect(layout.GetRun(0).rc, 0, 4, 20, 14) && IsRect(layout.GetRun(0).rcSource, 20, 0, 40, 10));
+	CHECK(RunText(layout, 0) == "img.png" && layout.GetRun(0).iType == -1 && IsText(layout, 1, "x", 20, 0));
+	layout.Build(&host, "<i file='a.png' restype='PNG'>", 100, 100, 0, 0, 0, NULL, 0);
+	CHECK(layout.GetRunCount() == 1 && RunText(layout, 0) == "a.png" && strcmp(layout.GetChars(layout.GetRun(0).iType), "PNG") == 0);
+	layout.Build(&host, "<i missing.png>x", 100, 100, 0, 0, 0, NULL, 0);
+	CHECK(!layout.IsComplete() && layout.GetRunCount() == 1 && IsText(layout, 0, "x", 0, 0));
+	// <i> without a name is italic
+	layout.Build(&host, "<i>x</i>", 100, 100, 0, 0, 0, NULL, 0);
+	CHECK(static_cast<CTestHost::TFont*>(layout.GetRun(0).hFont)->bItalic);
+
+	// escapes, and tags as text inside <r>
+	layout.Build(&host, "<{>{>}", 100, 100, 0, 0, 0, NULL, 0);
+	CHECK(layout.GetRunCount() == 2 && IsText(layout, 0, "{", 0, 0) && IsText(layout, 1, ">", 6, 0));
+	layout.Build(&host, "<r><b>x</r><b>y", 100, 100, 0, 0, 0, NULL, 0);
+	CHECK(layout.GetRunCount() == 2 && IsText(layout, 0, "<b>x", 0, 0) && layout.GetRun(0).hFont == pDefault);
+	CHECK(IsText(layout, 1, "y", 24, 0) && static_cast<CTestHost::TFont*>(layout.GetRun(1).hFont)->bBold);
+
+	// <s> is drawn on the background; <x> moves the text on, and <p> starts a line and makes
+	// the one it is on higher as well
+	layout.Build(&host, "a<s>b</s>c<x 10>d<p 4>e", 100, 100, 0, 0, 0, NULL, 0);
+	CHECK(layout.GetRunCount() == 5 && !layout.GetRun(0).bOpaque && layout.GetRun(1).bOpaque && !layout.GetRun(2).bOpaque);
+	CHECK(IsText(layout, 0, "a", 0, 4) && IsText(layout, 3, "d", 28, 4) && IsText(layout, 4, "e", 0, 26));
+
+	// DT_SINGLELINE keeps to one line, DT_CENTER and DT_RIGHT place each piece on its own
+	layout.Build(&host, "a<n>b\nc", 100, 100, DT_SINGLELINE, 0, 0, NULL, 0);
+	CHECK(layout.GetRunCount() == 2 && IsText(layout, 0, "a", 0, 0) && IsText(layout, 1, "b", 6, 0));
+	layout.Build(&host, "ab", 100, 100, DT_CENTER, 0, 0, NULL, 0);
+	CHECK(IsText(layout, 0, "ab", 44, 0));
+	layout.Build(&host, "ab", 100, 100, DT_RIGHT, 0, 0, NULL, 0);
+	CHECK(IsText(layout, 0, "ab", 88, 0));
+	// DT_END_ELLIPSIS drops the character that crossed the edge and the one before it, and
+	// puts "..." after the rest
+	layout.Build(&host, "abcdefghij", 30, 100, DT_SINGLELINE | DT_END_ELLIPSIS, 0, 0, NULL, 0);
+	CHECK(layout.GetRunCount() == 2 && IsText(layout, 0, "abcd", 0, 0) && IsText(layout, 1, "...", 24, 0));
+
+	// DT_CALCRECT draws nothing and says how much of the rect the text takes
+	layout.Build(&host, "ab<n>cde", 1000, 1000, DT_CALCRECT, 0, 0, NULL, 0);
+	CHECK(layout.GetRunCount() == 0);
+	RECT rc = { 10, 20, 1000, 1000 };
+	layout.GetCalcRect(rc);
+	CHECK(IsRect(rc, 10, 20, 28, 56));
+	layout.Build(&host, "", 1000, 1000, DT_CALCRECT, 0, 0, NULL, 0);
+	RECT rcEmpty = { 10, 20, 1000, 1000 };
+	layout.GetCalcRect(rcEmpty);
+	CHECK(IsRect(rcEmpty, 10, 20, 0, 38));
+
+	layout.Build(&host, NULL, 100, 100, 0, 0, 0, NULL, 0);
+	CHECK(layout.GetRunCount() == 0 && layout.IsComplete());
+}
+
+// Markup of words, spaces and the tags that don't add or drop characters; the text it shows
+// is sVisible.
+static std::string RandomMarkup(std::string& sVisible)
+{
+	static const char* WORDS[] = { "a", "to", "the", "wide", "letters", "x,y", "3.14", "supercalifragilistic" };
+	static const char* TAGS[] = { "<b>", "</b>", "<u>", "</u>", "<i>", "</i>", "<c #FF00FF>", "</c>", "<s>", "</s>",
+		"<f 1>", "</f>", "{b}", "{/b}", "<n>", "<p 3>", "</p>", "<a link>", "</a>" };
+	std::string sMarkup;
+	sVisible.clear();
+	int nTokens = rand() % 40;
+	for( int i = 0; i < nTokens; i++ ) {
+		int iKind = rand() % 10;
+		if( iKind < 5 ) {
+			const char* pstrWord = WORDS[rand() % lengthof(WORDS)];
+			sMarkup += pstrWord;
+			sVisible += pstrWord;
+		}
+		else if( iKind < 7 ) {
+			sMarkup += ' ';
+			sVisible += ' ';
+		}
+		else if( iKind < 8 ) {
+			sMarkup += '\n';
+		}
+		else {
+			sMarkup += TAGS[rand() % lengthof(TAGS)];
+		}
+	}
+	return sMarkup;
+}
+
+static void TestRandomMarkup()
+{
+	CTestHost host;
+	static const UINT STYLES[] = { 0, DT_WORDBREAK, DT_CENTER | DT_WORDBREAK, DT_RIGHT };
+	srand(73);
+	int nLayouts = 0;
+	for( int nRound = 0; nRound < 20000; nRound++ ) {
+		std::string sVisible;
+		std::string sMarkup = RandomMarkup(sVisible);
+		int cx = 12 + rand() % 200;
+		UINT uStyle = STYLES[rand() % lengthof(STYLES)];
+		CHtmlLayout layout;
+		layout.Build(&host, sMarkup.c_str(), cx, 100000, uStyle, 0, 0x00FF00, rand() % 2 ? "link" : NULL, rand() % 4);
+		nLayouts++;
+
+		// every character once and in order, each run on the bottom of its line and the lines
+		// going down, and broken lines inside the rect: a space may hang off the end, and a
+		// word cut at the start of a line keeps the character that crossed the edge. Centred
+		// and right aligned text places each piece on its own, so only left aligned is held
+		// to the rect.
+		std::string sRuns;
+		int yBottom = 0;
+		bool bInside = true;
+		for( int i = 0; i < layout.GetRunCount(); i++ ) {
+			const CHtmlLayout::TRun& run = layout.GetRun(i);
+			const CTestHost::TFont* pFont = static_cast<const CTestHost::TFont*>(run.hFont);
+			std::string sRun = RunText(layout, i);
+			sRuns += sRun;
+			int yRunBottom = run.rc.top + pFont->nSize + 4 + 2;
+			if( yRunBottom < yBottom ) bInside = false;
+			yBottom = yRunBottom;
+			int cxRun = ((int)sRun.size() - 1) * CTestHost::CharWidth(pFont);
+			if( uStyle == DT_WORDBREAK && sRun != " " && run.rc.left + cxRun > cx ) bInside = false;
+		}
+		if( sRuns != sVisible || !bInside ) {
+			fprintf(stderr, "cx %d style %x: '%s'\n gives '%s'\n", cx, uStyle, sMarkup.c_str(), sRuns.c_str());
+		}
+		CHECK(sRuns == sVisible);
+		CHECK(bInside);
+		CHECK(layout.GetLinkCount() <= 3 && layout.GetLinkRectCount() <= 3 && layout.GetLinkTextCount() <= 3);
+		CHECK(layout.IsComplete());
+
+		// the same markup lays out the same
+		CHtmlLayout again;
+		again.Build(&host, sMarkup.c_str(), cx, 100000, uStyle, 0, 0x00FF00, NULL, 0);
+		CHtmlLayout plain;
+		plain.Build(&host, sMarkup.c_str(), cx, 100000, uStyle, 0, 0x00FF00, NULL, 0);
+		bool bSame = again.GetRunCount() == plain.GetRunCount();
+		for( int i = 0; bSame && i < again.GetRunCount(); i++ ) {
+			bSame = memcmp(&again.GetRun(i).rc, &plain.GetRun(i).rc, sizeof(RECT)) == 0 && RunText(again, i) == RunText(plain, i)
+				&& again.GetRun(i).hFont == plain.GetRun(i).hFont;
+		}
+		CHECK(bSame);
+	}
+	printf("%d random layouts\n", nLayouts);
+}
+
+static CHtmlLayoutCache::TKey MakeKey(const char* pstrText, UINT uSerial)
+{
+	CHtmlLayoutCache::TKey key;
+	key.sText = pstrText;
+	key.bHoverLink = false;
+	key.cx = 100;
+	key.cy = 20;
+	key.uStyle = DT_SINGLELINE;
+	key.dwTextColor = 0;
+	key.dwLinkHoverColor = 0;
+	key.nLinkRects = 0;
+	key.nScale = 100;
+	key.uSerial = uSerial;
+	return key;
+}
+
+static void TestCache()
+{
+	CHtmlLayoutCache cache(3);
+	CHtmlLayoutCache::TKey keyA = MakeKey("a", 1);
+	CHECK(cache.Find(keyA) == NULL);
+	CHtmlLayout* pA = new CHtmlLayout;
+	CHECK(cache.Add(keyA, pA) == pA && cache.Find(keyA) == pA);
+
+	// everything Build reads is part of the key
+	CHtmlLayoutCache::TKey key = keyA;
+	key.sText = "b";
+	CHECK(cache.Find(key) == NULL);
+	key = keyA; key.cx++;
+	CHECK(cache.Find(key) == NULL);
+	key = keyA; key.cy++;
+	CHECK(cache.Find(key) == NULL);
+	key = keyA; key.uStyle |= DT_CENTER;
+	CHECK(cache.Find(key) == NULL);
+	key = keyA; key.dwTextColor = 1;
+	CHECK(cache.Find(key) == NULL);
+	key = keyA; key.dwLinkHoverColor = 1;
+	CHECK(cache.Find(key) == NULL);
+	key = keyA; key.nLinkRects = 1;
+	CHECK(cache.Find(key) == NULL);
+	key = keyA; key.nScale = 150;
+	CHECK(cache.Find(key) == NULL);
+	key = keyA; key.bHoverLink = true;
+	CHECK(cache.Find(key) == NULL);
+	key = keyA; key.bHoverLink = true; key.sHoverLink = "x";
+	CHECK(cache.Find(key) == NULL);
+	CHECK(cache.Find(keyA) == pA && cache.GetCount() == 1);
+
+	// the same key again replaces the layout
+	CHtmlLayout* pA2 = new CHtmlLayout;
+	CHECK(cache.Add(keyA, pA2) == pA2 && cache.Find(keyA) == pA2 && cache.GetCount() == 1);
+
+	// full, the least recently drawn goes
+	CHtmlLayoutCache::TKey keyB = MakeKey("b", 1), keyC = MakeKey("c", 1), keyD = MakeKey("d", 1);
+	cache.Add(keyB, new CHtmlLayout);
+	cache.Add(keyC, new CHtmlLayout);
+	CHECK(cache.Find(keyA) == pA2);
+	cache.Add(keyD, new CHtmlLayout);
+	CHECK(cache.GetCount() == 3 && cache.Find(keyB) == NULL);
+	CHECK(cache.Find(keyA) == pA2 && cache.Find(keyC) != NULL && cache.Find(keyD) != NULL);
+
+	// a new serial drops every layout, as their fonts may be gone
+	CHECK(cache.Find(MakeKey("a", 2)) == NULL && cache.GetCount() == 0);
+	cache.Add(MakeKey("a", 2), new CHtmlLayout);
+	CHECK(cache.GetCount() == 1);
+	cache.RemoveAll();
+	CHECK(cache.GetCount() == 0);
+}
+
+int main()
+{
+	TestKnownLayouts();
+	TestRandomMarkup();
+	TestCache();
+	return TestResult("HtmlLayoutTest");
+}
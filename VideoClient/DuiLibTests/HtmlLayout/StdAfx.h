@@ -0,0 +1,19 @@
+#pragma once
+
+#include "Win32Shim.h"
+
+// What UIHtmlLayout.cpp takes from the library's StdAfx.h besides the shim: the DrawText
+// styles it reads, and MIN and MAX, which are min and max there.
+
+#define MAX(a, b) (((a) > (b)) ? (a) : (b))
+#define MIN(a, b) (((a) < (b)) ? (a) : (b))
+#define DT_CENTER 0x00000001
+#define DT_RIGHT 0x00000002
+#define DT_VCENTER 0x00000004
+#define DT_BOTTOM 0x00000008
+#define DT_WORDBREAK 0x00000010
+#define DT_SINGLELINE 0x00000020
+#define DT_CALCRECT 0x00000400
+#define DT_END_ELLIPSIS 0x00008000
+
+#include "Core/UIHtmlLayout.h"
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <deque>
+#include <string>
+
+// The host of HtmlLayoutTest and HtmlLayoutBench, in place of the DC CHtmlRenderHost measures
+// with. A character is half the font size wide, and one more when bold; a line is the size plus
+// 4 high with 2 of leading. Fonts 0 and 1 are "Sans" 12 and 20, font 0 the default.
+class CTestHost : public DuiLib::IHtmlLayoutHost
+{
+public:
+	struct TFont
+	{
+		std::string sFace;
+		int nSize;
+		bool bBold;
+		bool bUnderline;
+		bool bItalic;
+	};
+
+	CTestHost() : m_nTextWidths(0)
+	{
+		GetFont("Sans", 12, false, false, false);
+		GetFont("Sans", 20, false, false, false);
+	}
+
+	LPVOID GetDefaultFont() { return &m_aFonts[0]; }
+	LPVOID GetFont(int iFont) { return iFont >= 0 && iFont < 2 ? &m_aFonts[iFont] : &m_aFonts[0]; }
+	LPVOID GetFont(LPCTSTR pstrFace, int nSize, bool bBold, bool bUnderline, bool bItalic)
+	{
+		for( size_t i = 0; i < m_aFonts.size(); i++ ) {
+			const TFont& font = m_aFonts[i];
+			if( font.sFace == pstrFace && font.nSize == nSize && font.bBold == bBold && font.bUnderline == bUnderline
+				&& font.bItalic == bItalic ) return &m_aFonts[i];
+		}
+		TFont font = { pstrFace, nSize, bBold, bUnderline, bItalic };
+		m_aFonts.push_back(font);
+		return &m_aFonts.back();
+	}
+	LPVOID GetFont(LPVOID hFont, bool bBold, bool bUnderline, bool bItalic)
+	{
+		const TFont* pFont = static_cast<const TFont*>(hFont);
+		return GetFont(pFont->sFace.c_str(), pFont->nSize, bBold, bUnderline, bItalic);
+	}
+	void GetFontInfo(LPVOID hFont, DuiLib::THtmlFontInfo& info)
+	{
+		const TFont* pFont = static_cast<const TFont*>(hFont);
+		info.cyHeight = pFont->nSize + 4;
+		info.cyExternalLeading = 2;
+		info.cxMaxChar = CharWidth(pFont) + 1;
+		info.bSlanted = pFont->bItalic;
+		info.bBold = pFont->bBold;
+		info.bUnderline = pFont->bUnderline;
+		info.bItalic = pFont->bItalic;
+	}
+	int GetTextWidth(LPVOID hFont, LPCTSTR, int cchText)
+	{
+		m_nTextWidths++;
+		return cchText * CharWidth(static_cast<const TFont*>(hFont));
+	}
+	int GetSpaceOverhang(LPVOID) { return -2; }
+	bool GetImageSize(LPCTSTR pstrName, LPCTSTR, int& cx, int& cy)
+	{
+		if( strncmp(pstrName, "missing", 7) == 0 ) return false;
+		cx = 40;
+		cy = 10;
+		return true;
+	}
+
+	static int CharWidth(const TFont* pFont) { return pFont->nSize / 2 + (pFont->bBold ? 1 : 0); }
+
+	std::deque<TFont> m_aFonts;
+	int m_nTextWidths;
+};
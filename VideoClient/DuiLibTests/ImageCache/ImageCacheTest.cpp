@@ -0,0 +1,512 @@
+// ImageCacheTest.cpp : CImageCache with a decoder the test holds back at will, so that requests
+// meet a decode in every state: synchronous and worker decodes, requests that join one, waiters
+// told once whatever happens, queued work taken back by a synchronous Get, failed decodes
+// remembered, least recently used images trimmed to the budget only outside BeginUse/EndUse,
+// pinned images kept by the trim, Remove and Purge deferred the same way, RemoveIf taking the
+// image made for every scale out with the image, threads stopped with work queued, and a stress
+// run.
+
+#include "StdAfx.h"
+#include "TestCheck.h"
+#include "Utils/ImageCache.h"
+#include <map>
+#include <set>
+#include <chrono>
+
+using namespace DuiLib;
+
+struct TImage
+{
+	std::string sName;
+	unsigned int uParam;
+	std::thread::id idThread;
+};
+
+// Every image is 1000 bytes, names starting with "missing" fail, and a closed name blocks its
+// decode until it is opened.
+class CDecoder
+{
+public:
+	CDecoder() : m_nLive(0), m_nFreed(0) { }
+
+	void* Decode(const std::string& sName, unsigned int uParam, size_t* pcbSize)
+	{
+		std::unique_lock<std::mutex> lock(m_lock);
+		m_mDecodes[sName]++;
+		m_sEntered.insert(sName);
+		m_cv.notify_all();
+		while( m_sClosed.count(sName) ) m_cv.wait(lock);
+		if( sName.compare(0, 7, "missing") == 0 ) return NULL;
+		m_nLive++;
+		*pcbSize = 1000;
+		TImage* pImage = new TImage;
+		pImage->sName = sName;
+		pImage->uParam = uParam;
+		pImage->idThread = std::this_thread::get_id();
+		return pImage;
+	}
+	void Free(void* pImage)
+	{
+		std::unique_lock<std::mutex> lock(m_lock);
+		m_nLive--;
+		m_nFreed++;
+		delete (TImage*)pImage;
+	}
+	void Ready(void* pWaiter)
+	{
+		std::unique_lock<std::mutex> lock(m_lock);
+		m_mReady[pWaiter]++;
+		m_cv.notify_all();
+	}
+
+	void Close(const std::string& sName) { std::unique_lock<std::mutex> lock(m_lock); m_sClosed.insert(sName); }
+	void Open(const std::string& sName) { std::unique_lock<std::mutex> lock(m_lock); m_sClosed.erase(sName); m_cv.notify_all(); }
+	bool WaitEntered(const std::string& sName)
+	{
+		std::unique_lock<std::mutex> lock(m_lock);
+		return m_cv.wait_for(lock, std::chrono::seconds(10), [&] { return m_sEntered.count(sName) != 0; });
+	}
+	bool WaitReady(void* pWaiter, int nTimes)
+	{
+		std::unique_lock<std::mutex> lock(m_lock);
+		return m_cv.wait_for(lock, std::chrono::seconds(10), [&] { return m_mReady[pWaiter] >= nTimes; });
+	}
+	int Decodes(const std::string& sName) { std::unique_lock<std::mutex> lock(m_lock); return m_mDecodes[sName]; }
+	int ReadyCount(void* pWaiter) { std::unique_lock<std::mutex> lock(m_lock); return m_mReady[pWaiter]; }
+	int Live() { std::unique_lock<std::mutex> lock(m_lock); return m_nLive; }
+	int Freed() { std::unique_lock<std::mutex> lock(m_lock); return m_nFreed; }
+
+private:
+	std::mutex m_lock;
+	std::condition_variable m_cv;
+	std::map<std::string, int> m_mDecodes;
+	std::map<void*, int> m_mReady;
+	std::set<std::string> m_sEntered;
+	std::set<std::string> m_sClosed;
+	int m_nLive;
+	int m_nFreed;
+};
+
+static CImageCache* NewCache(CDecoder& decoder)
+{
+	return new CImageCache(
+		[&decoder](const CImageCache::Key& sName, unsigned int uParam, size_t* pcbSize) { return decoder.Decode(sName, uParam, pcbSize); },
+		[&decoder](void* pImage) { decoder.Free(pImage); },
+		[&decoder](void* pWaiter) { decoder.Ready(pWaiter); });
+}
+
+static TImageCacheStats Stats(CImageCache& cache)
+{
+	TImageCacheStats stats;
+	cache.GetStats(&stats);
+	return stats;
+}
+
+static bool IsImage(void* pImage, const char* pstrName, unsigned int uParam)
+{
+	return pImage != NULL && ((TImage*)pImage)->sName == pstrName && ((TImage*)pImage)->uParam == uParam;
+}
+
+static void* const WAITER_1 = (void*)1;
+static void* const WAITER_2 = (void*)2;
+
+static void TestSynchronous()
+{
+	CDecoder decoder;
+	CImageCache* pCache = NewCache(decoder);
+	void* pImage = pCache->Get("a.png", 0);
+	CHECK(IsImage(pImage, "a.png", 0));
+	CHECK(pCache->Get("a.png", 0) == pImage);
+	CHECK(pCache->Find("a.png", 0) == pImage);
+	void* pMasked = pCache->Get("a.png", 0xFF00FF);
+	CHECK(IsImage(pMasked, "a.png", 0xFF00FF) && pMasked != pImage);
+	CHECK(pCache->Find("b.png", 0) == NULL);
+	CHECK(decoder.Decodes("b.png") == 0);
+	// without threads a waiter changes nothing
+	CHECK(IsImage(pCache->Get("c.png", 0, WAITER_1), "c.png", 0));
+	CHECK(decoder.ReadyCount(WAITER_1) == 0);
+
+	// a failed decode is remembered until the name is removed
+	CHECK(pCache->Get("missing.png", 0) == NULL);
+	CHECK(pCache->Get("missing.png", 0) == NULL);
+	CHECK(pCache->Find("missing.png", 0) == NULL);
+	CHECK(decoder.Decodes("missing.png") == 1);
+	TImageCacheStats stats = Stats(*pCache);
+	CHECK(stats.nMisses == 4 && stats.nHits == 3 && stats.nDecodes == 3 && stats.nFailures == 1);
+	CHECK(stats.nImages == 4 && stats.cbUsed == 3000 && stats.cbPeak == 3000);
+	pCache->Remove("missing.png");
+	CHECK(pCache->Get("missing.png", 0) == NULL);
+	CHECK(decoder.Decodes("missing.png") == 2);
+
+	pCache->ResetStats();
+	stats = Stats(*pCache);
+	CHECK(stats.nMisses == 0 && stats.nHits == 0 && stats.cbUsed == 3000 && stats.cbPeak == 3000);
+	delete pCache;
+	CHECK(decoder.Live() == 0);
+}
+
+// Requests for an image another thread is decoding wait for that decode.
+static void TestJoin()
+{
+	CDecoder decoder;
+	CImageCache* pCache = NewCache(decoder);
+	decoder.Close("slow.png");
+	void* aImages[8] = { 0 };
+	std::vector<std::thread> aThreads;
+	aThreads.push_back(std::thread([&] { aImages[0] = pCache->Get("slow.png", 0); }));
+	CHECK(decoder.WaitEntered("slow.png"));
+	for( int i = 1; i < 8; i++ ) aThreads.push_back(std::thread([&, i] { aImages[i] = pCache->Get("slow.png", 0); }));
+	for( int nTry = 0; nTry < 1000 && Stats(*pCache).nJoins < 7; nTry++ ) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	CHECK(Stats(*pCache).nJoins == 7);
+	decoder.Open("slow.png");
+	for( size_t i = 0; i < aThreads.size(); i++ ) aThreads[i].join();
+	for( int i = 0; i < 8; i++ ) CHECK(aImages[i] == aImages[0] && IsImage(aImages[i], "slow.png", 0));
+	CHECK(decoder.Decodes("slow.png") == 1);
+	TImageCacheStats stats = Stats(*pCache);
+	CHECK(stats.nMisses == 1 && stats.nHits == 0 && stats.nDecodes == 1);
+
+	// and a failure is shared the same way
+	decoder.Close("missing.png");
+	std::thread first([&] { aImages[0] = pCache->Get("missing.png", 0); });
+	CHECK(decoder.WaitEntered("missing.png"));
+	std::thread second([&] { aImages[1] = pCache->Get("missing.png", 0); });
+	for( int nTry = 0; nTry < 1000 && Stats(*pCache).nJoins < 8; nTry++ ) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	decoder.Open("missing.png");
+	first.join();
+	second.join();
+	CHECK(aImages[0] == NULL && aImages[1] == NULL);
+	CHECK(decoder.Decodes("missing.png") == 1);
+	delete pCache;
+	CHECK(decoder.Live() == 0);
+}
+
+// With threads, a request with a waiter queues the decode, and every waiter of it is told once.
+static void TestWaiters()
+{
+	CDecoder decoder;
+	CImageCache* pCache = NewCache(decoder);
+	pCache->SetThreads(1);
+	CHECK(pCache->GetThreads() == 1);
+	decoder.Close("w.png");
+	CHECK(pCache->Get("w.png", 0, WAITER_1) == NULL);
+	CHECK(decoder.WaitEntered("w.png"));
+	CHECK(pCache->Get("w.png", 0, WAITER_2) == NULL);
+	CHECK(pCache->Get("w.png", 0, WAITER_1) == NULL);
+	CHECK(pCache->Find("w.png", 0) == NULL);
+	decoder.Open("w.png");
+	CHECK(decoder.WaitReady(WAITER_1, 1) && decoder.WaitReady(WAITER_2, 1));
+	void* pImage = pCache->Get("w.png", 0, WAITER_1);
+	CHECK(IsImage(pImage, "w.png", 0) && ((TImage*)pImage)->idThread != std::this_thread::get_id());
+	CHECK(decoder.ReadyCount(WAITER_1) == 1 && decoder.ReadyCount(WAITER_2) == 1);
+
+	// a failure is told too, and is then found failed without another decode
+	CHECK(pCache->Get("missing.png", 0, WAITER_2) == NULL);
+	CHECK(decoder.WaitReady(WAITER_2, 2));
+	CHECK(pCache->Get("missing.png", 0, WAITER_2) == NULL);
+	CHECK(decoder.Decodes("missing.png") == 1);
+	CHECK(Stats(*pCache).nFailures == 1);
+
+	// a prefetch has nobody to tell, a later Get finds it decoded
+	pCache->Prefetch("p.png", 0);
+	pCache->Prefetch("p.png", 0);
+	for( int nTry = 0; nTry < 1000 && Stats(*pCache).nDecodes < 2; nTry++ ) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	unsigned int nHits = Stats(*pCache).nHits;
+	CHECK(IsImage(pCache->Get("p.png", 0), "p.png", 0));
+	CHECK(Stats(*pCache).nHits == nHits + 1);
+	CHECK(decoder.Decodes("p.png") == 1);
+	delete pCache;
+	CHECK(decoder.Live() == 0);
+}
+
+// A synchronous Get takes a queued decode back and does it on its own thread, telling the
+// waiters of it; one that a worker has started is waited for.
+static void TestTakeBack()
+{
+	CDecoder decoder;
+	CImageCache* pCache = NewCache(decoder);
+	pCache->SetThreads(1);
+	decoder.Close("busy.png");
+	CHECK(pCache->Get("busy.png", 0, WAITER_1) == NULL);
+	CHECK(decoder.WaitEntered("busy.png"));
+	CHECK(pCache->Get("queued.png", 0, WAITER_2) == NULL);
+	void* pImage = pCache->Get("queued.png", 0);
+	CHECK(IsImage(pImage, "queued.png", 0) && ((TImage*)pImage)->idThread == std::this_thread::get_id());
+	CHECK(decoder.ReadyCount(WAITER_2) == 1);
+	CHECK(Stats(*pCache).nJoins == 1);
+
+	void* pBusy = NULL;
+	std::thread waiting([&] { pBusy = pCache->Get("busy.png", 0); });
+	for( int nTry = 0; nTry < 1000 && Stats(*pCache).nJoins < 2; nTry++ ) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	decoder.Open("busy.png");
+	waiting.join();
+	CHECK(IsImage(pBusy, "busy.png", 0) && ((TImage*)pBusy)->idThread != std::this_thread::get_id());
+	CHECK(decoder.WaitReady(WAITER_1, 1));
+	CHECK(decoder.Decodes("busy.png") == 1 && decoder.Decodes("queued.png") == 1);
+	delete pCache;
+	CHECK(decoder.Live() == 0);
+}
+
+// Nothing is freed while a pass is using the cache; the pass that ends last trims the least
+// recently used images back under the budget.
+static void TestTrim()
+{
+	CDecoder decoder;
+	CImageCache* pCache = NewCache(decoder);
+	pCache->SetBudget(2500);
+	pCache->BeginUse();
+	pCache->BeginUse();
+	void* pA = pCache->Get("a.png", 0);
+	pCache->Get("b.png", 0);
+	pCache->Get("missing.png", 0);
+	pCache->Get("c.png", 0);
+	void* pD = pCache->Get("d.png", 0);
+	CHECK(pCache->Get("a.png", 0) == pA);
+	pCache->Trim();
+	CHECK(Stats(*pCache).cbUsed == 4000 && decoder.Freed() == 0);
+	pCache->EndUse();
+	CHECK(Stats(*pCache).cbUsed == 4000 && decoder.Freed() == 0);
+	CHECK(IsImage(pA, "a.png", 0));
+	pCache->EndUse();
+	// least recent first: b, the failure, then c
+	TImageCacheStats stats = Stats(*pCache);
+	CHECK(stats.cbUsed == 2000 && stats.nEvictions == 2 && stats.nImages == 2 && decoder.Freed() == 2);
+	CHECK(pCache->Find("a.png", 0) == pA && pCache->Find("d.png", 0) == pD);
+	CHECK(pCache->Find("b.png", 0) == NULL && pCache->Find("c.png", 0) == NULL);
+	pCache->Get("missing.png", 0);
+	CHECK(decoder.Decodes("missing.png") == 2);
+	// an unbalanced EndUse does not leave the count below zero
+	pCache->EndUse();
+	pCache->BeginUse();
+	pCache->Get("e.png", 0);
+	pCache->Trim();
+	CHECK(Stats(*pCache).cbUsed == 3000);
+	// the Finds above left a behind d
+	pCache->EndUse();
+	CHECK(Stats(*pCache).cbUsed == 2000 && pCache->Find("a.png", 0) == NULL && pCache->Find("d.png", 0) == pD);
+
+	// Remove and Purge take the images out of the cache at once, and free them when the pass ends
+	pCache->BeginUse();
+	void* pMasked = pCache->Get("d.png", 1);
+	pCache->Remove("d.png");
+	CHECK(pCache->Find("d.png", 0) == NULL && pCache->Find("d.png", 1) == NULL);
+	CHECK(IsImage(pMasked, "d.png", 1) && decoder.Live() == 3);
+	pCache->EndUse();
+	CHECK(decoder.Live() == 1);
+	pCache->BeginUse();
+	pCache->Purge();
+	CHECK(Stats(*pCache).nImages == 0 && Stats(*pCache).cbUsed == 0 && decoder.Live() == 1);
+	pCache->EndUse();
+	CHECK(decoder.Live() == 0);
+
+	// a lower budget trims at once when nothing is in use
+	pCache->SetBudget(100000);
+	for( int i = 0; i < 10; i++ ) pCache->Get(std::string(1, (char)('f' + i)), 0);
+	pCache->SetBudget(3000);
+	CHECK(Stats(*pCache).cbUsed == 3000 && Stats(*pCache).cbBudget == 3000 && decoder.Live() == 3);
+	CHECK(pCache->Find("o", 0) != NULL && pCache->Find("f", 0) == NULL);
+	delete pCache;
+	CHECK(decoder.Live() == 0);
+}
+
+// The paint manager keeps what it made of an image for a scale under "|<scale>|<name>".
+// RemoveImage takes all of them out with the image, whatever scale the window is at now.
+static bool IsImageKeyOf(const CImageCache::Key& sKey, const char* pstrName)
+{
+	if( sKey == pstrName ) return true;
+	if( sKey.empty() || sKey[0] != '|' ) return false;
+	size_t iBar = sKey.find('|', 1);
+	return iBar != std::string::npos && sKey.compare(iBar + 1, std::string::npos, pstrName) == 0;
+}
+
+static void TestRemoveIf()
+{
+	CDecoder decoder;
+	CImageCache* pCache = NewCache(decoder);
+	pCache->BeginUse();
+	const char* aKeys[] = { "a.png", "|125|a.png", "|150|a.png", "|200|a.png", "|150|ba.png", "b.png", "|150|b.png" };
+	for( size_t i = 0; i < lengthof(aKeys); i++ ) pCache->Get(aKeys[i], 0);
+	void* pMasked = pCache->Get("|150|a.png", 0xFF00FF);
+	pCache->Get("missing.png", 0);
+	CHECK(Stats(*pCache).nImages == 9);
+
+	// the window is at 150% now, and was at 125% and 200% before
+	pCache->RemoveIf(std::bind(IsImageKeyOf, std::placeholders::_1, "a.png"));
+	CHECK(pCache->Find("a.png", 0) == NULL && pCache->Find("|125|a.png", 0) == NULL);
+	CHECK(pCache->Find("|150|a.png", 0) == NULL && pCache->Find("|200|a.png", 0) == NULL);
+	CHECK(pCache->Find("|150|a.png", 0xFF00FF) == NULL);
+	CHECK(pCache->Find("|150|ba.png", 0) != NULL && pCache->Find("b.png", 0) != NULL && pCache->Find("|150|b.png", 0) != NULL);
+	CHECK(Stats(*pCache).nImages == 4 && Stats(*pCache).cbUsed == 3000);
+	// freed when the pass ends, as with Remove
+	CHECK(IsImage(pMasked, "|150|a.png", 0xFF00FF) && decoder.Live() == 8);
+	pCache->EndUse();
+	CHECK(decoder.Live() == 3);
+
+	// failures go too, so the next Get tries again
+	pCache->RemoveIf(std::bind(IsImageKeyOf, std::placeholders::_1, "missing.png"));
+	pCache->Get("missing.png", 0);
+	CHECK(decoder.Decodes("missing.png") == 2);
+	// decoded again on the next Get
+	CHECK(IsImage(pCache->Get("|200|a.png", 0), "|200|a.png", 0) && decoder.Decodes("|200|a.png") == 2);
+
+	// a decode under way is left to finish
+	pCache->SetThreads(1);
+	decoder.Close("|125|c.png");
+	CHECK(pCache->Get("|125|c.png", 0, WAITER_1) == NULL);
+	CHECK(decoder.WaitEntered("|125|c.png"));
+	pCache->RemoveIf(std::bind(IsImageKeyOf, std::placeholders::_1, "c.png"));
+	decoder.Open("|125|c.png");
+	CHECK(decoder.WaitReady(WAITER_1, 1));
+	CHECK(IsImage(pCache->Find("|125|c.png", 0), "|125|c.png", 0) && decoder.Decodes("|125|c.png") == 1);
+	delete pCache;
+	CHECK(decoder.Live() == 0);
+}
+
+// Pinned images are passed over by the trim, wherever they are in the list, until the last
+// Unpin; the pin is on the key, so it holds what is decoded again after Remove and Purge.
+static void TestPin()
+{
+	CDecoder decoder;
+	CImageCache* pCache = NewCache(decoder);
+	pCache->SetBudget(2000);
+	pCache->Pin("a.png", 0);
+	pCache->Pin("a.png", 0);
+	void* pA = pCache->Get("a.png", 0);
+	pCache->Get("b.png", 0);
+	pCache->Get("c.png", 0);
+	void* pD = pCache->Get("d.png", 0);
+	pCache->Trim();
+	CHECK(Stats(*pCache).cbUsed == 2000 && Stats(*pCache).nEvictions == 2);
+	CHECK(pCache->Find("a.png", 0) == pA && pCache->Find("d.png", 0) == pD);
+	CHECK(pCache->Find("b.png", 0) == NULL && pCache->Find("c.png", 0) == NULL);
+	// a is the least recent now, so d goes for the new image
+	void* pMasked = pCache->Get("a.png", 1);
+	pCache->Trim();
+	CHECK(pCache->Find("d.png", 0) == NULL && pCache->Find("a.png", 1) == pMasked);
+	// the mask is part of the key: over the budget with nothing else to let go, only the
+	// pinned image stays
+	pCache->SetBudget(500);
+	CHECK(pCache->Find("a.png", 0) == pA && pCache->Find("a.png", 1) == NULL);
+	CHECK(Stats(*pCache).cbUsed == 1000 && decoder.Decodes("a.png") == 2);
+
+	// held across Remove for the image decoded after it
+	pCache->Remove("a.png");
+	pA = pCache->Get("a.png", 0);
+	pCache->Trim();
+	CHECK(pCache->Find("a.png", 0) == pA && decoder.Decodes("a.png") == 3);
+	// and freed by the trim that comes with the last Unpin
+	pCache->Unpin("a.png", 0);
+	CHECK(pCache->Find("a.png", 0) == pA);
+	pCache->BeginUse();
+	pCache->Unpin("a.png", 0);
+	CHECK(pCache->Find("a.png", 0) == pA);
+	pCache->EndUse();
+	CHECK(pCache->Find("a.png", 0) == NULL && Stats(*pCache).cbUsed == 0);
+	// an Unpin without its Pin changes nothing
+	pCache->Unpin("b.png", 0);
+	delete pCache;
+	CHECK(decoder.Live() == 0);
+}
+
+// Stopping the threads drops what is still queued and tells its waiters, who ask again.
+static void TestStopThreads()
+{
+	CDecoder decoder;
+	CImageCache* pCache = NewCache(decoder);
+	pCache->SetThreads(1);
+	decoder.Close("busy.png");
+	pCache->Prefetch("busy.png", 0);
+	CHECK(decoder.WaitEntered("busy.png"));
+	char szName[16];
+	for( int i = 0; i < 10; i++ ) {
+		sprintf(szName, "q%d.png", i);
+		CHECK(pCache->Get(szName, 0, WAITER_1) == NULL);
+		CHECK(pCache->Get(szName, 0, WAITER_2) == NULL);
+	}
+	// the worker is held in its decode until the stop has been asked for
+	std::thread stopper([&] { pCache->SetThreads(0); });
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	decoder.Open("busy.png");
+	stopper.join();
+	CHECK(pCache->GetThreads() == 0);
+	CHECK(decoder.ReadyCount(WAITER_1) == 10 && decoder.ReadyCount(WAITER_2) == 10);
+	for( int i = 0; i < 10; i++ ) {
+		sprintf(szName, "q%d.png", i);
+		CHECK(pCache->Find(szName, 0) == NULL || decoder.Decodes(szName) == 1);
+		CHECK(IsImage(pCache->Get(szName, 0, WAITER_1), szName, 0));
+	}
+	CHECK(IsImage(pCache->Find("busy.png", 0), "busy.png", 0));
+
+	// new threads pick up where the old ones left off; a cache deleted with work queued tells the waiters too
+	pCache->SetThreads(2);
+	CHECK(pCache->GetThreads() == 2);
+	decoder.Close("busy2.png");
+	decoder.Close("busy3.png");
+	pCache->Prefetch("busy2.png", 0);
+	pCache->Prefetch("busy3.png", 0);
+	for( int i = 0; i < 10; i++ ) {
+		sprintf(szName, "r%d.png", i);
+		pCache->Get(szName, 0, WAITER_2);
+	}
+	std::thread deleter([&] { delete pCache; });
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	decoder.Open("busy2.png");
+	decoder.Open("busy3.png");
+	deleter.join();
+	CHECK(decoder.ReadyCount(WAITER_2) == 20);
+	CHECK(decoder.Live() == 0);
+}
+
+// Threads asking for, finding and removing images over a small budget, with and without
+// waiters; an image is checked while its pass is still going.
+static void TestStress()
+{
+	CDecoder decoder;
+	CImageCache* pCache = NewCache(decoder);
+	pCache->SetThreads(3);
+	pCache->SetBudget(5000);
+	int aWaiters[4];
+	// CHECK is not for other threads, they count what they find wrong
+	int aWrong[4] = { 0 };
+	std::vector<std::thread> aThreads;
+	for( int t = 0; t < 4; t++ ) {
+		aThreads.push_back(std::thread([&, t] {
+			char szName[16];
+			for( int i = 0; i < 2000; i++ ) {
+				int n = (i * 7 + t) % 40;
+				sprintf(szName, n % 13 ? "h%d.png" : "missing%d.png", n);
+				pCache->BeginUse();
+				void* pImage = pCache->Get(szName, n % 3, (i & 1) ? &aWaiters[t] : NULL);
+				if( pImage != NULL && !IsImage(pImage, szName, n % 3) ) aWrong[t]++;
+				pImage = pCache->Find(szName, n % 3);
+				if( pImage != NULL && !IsImage(pImage, szName, n % 3) ) aWrong[t]++;
+				pCache->EndUse();
+				if( i % 50 == 0 ) pCache->Remove(szName);
+				if( i % 500 == 0 ) pCache->Purge();
+			}
+		}));
+	}
+	for( size_t i = 0; i < aThreads.size(); i++ ) aThreads[i].join();
+	for( int t = 0; t < 4; t++ ) CHECK(aWrong[t] == 0);
+	pCache->SetThreads(0);
+	pCache->Trim();
+	TImageCacheStats stats = Stats(*pCache);
+	CHECK(stats.cbUsed <= 5000 && stats.cbUsed == (size_t)decoder.Live() * 1000);
+	printf("stress: %u hits, %u misses, %u joins, %u decodes, %u failures, %u evictions\n",
+		stats.nHits, stats.nMisses, stats.nJoins, stats.nDecodes, stats.nFailures, stats.nEvictions);
+	delete pCache;
+	CHECK(decoder.Live() == 0);
+}
+
+int main()
+{
+	TestSynchronous();
+	TestJoin();
+	TestWaiters();
+	TestTakeBack();
+	TestTrim();
+	TestRemoveIf();
+	TestPin();
+	TestStopThreads();
+	TestStress();
+	return TestResult("ImageCacheTest");
+}
@@ -0,0 +1,3 @@
+#pragma once
+
+#include "Win32Shim.h"
@@ -0,0 +1,126 @@
+// IndexSetTest.cpp : CStdIndexSet against a std::set of the same indices. Random adds, ranges,
+// removes and cut-offs, bunched so that ranges touch, merge and split, must leave the same
+// indices, walked in the same order, in as few ranges as the runs they make; then the rows of
+// a list a million long, all selected and thinned out, as CListUI keeps them.
+
+#include "StdAfx.h"
+#include "TestCheck.h"
+#include <set>
+
+using namespace DuiLib;
+
+// the ranges, which the set keeps to itself
+class CIndexSetProbe : public CStdIndexSet
+{
+public:
+	int GetRanges() const { return m_nRanges; }
+};
+
+static int CountRuns(const std::set<int>& model)
+{
+	int nRuns = 0, iPrev = -2;
+	for( std::set<int>::const_iterator it = model.begin(); it != model.end(); ++it ) {
+		if( *it != iPrev + 1 ) nRuns++;
+		iPrev = *it;
+	}
+	return nRuns;
+}
+
+static bool SameAsModel(const CIndexSetProbe& set, const std::set<int>& model, int nRange)
+{
+	if( set.GetSize() != (int)model.size() ) return false;
+	if( set.IsEmpty() != model.empty() ) return false;
+	if( set.GetFirst() != (model.empty() ? -1 : *model.begin()) ) return false;
+	if( set.GetLast() != (model.empty() ? -1 : *model.rbegin()) ) return false;
+	if( set.GetRanges() != CountRuns(model) ) return false;
+	for( int i = -1; i <= nRange + 1; i++ ) {
+		if( set.Find(i) != (model.count(i) != 0) ) return false;
+		std::set<int>::const_iterator it = model.upper_bound(i);
+		if( set.GetNext(i) != (it == model.end() ? -1 : *it) ) return false;
+	}
+	return true;
+}
+
+static void TestAgainstModel()
+{
+	int nOps = 0;
+	for( int nRound = 0; nRound < 300; nRound++ ) {
+		CIndexSetProbe set;
+		std::set<int> model;
+		// small ranges bunch the indices, large ones spread them
+		int nRange = 8 + rand() % (nRound % 3 == 0 ? 40 : 400);
+		for( int nOp = 0; nOp < 400; nOp++ ) {
+			int i = rand() % nRange;
+			switch( rand() % 10 ) {
+			case 0: case 1: case 2:
+				CHECK(set.Add(i) == model.insert(i).second);
+				break;
+			case 3: case 4: case 5:
+				CHECK(set.Remove(i) == (model.erase(i) != 0));
+				break;
+			case 6: case 7:
+				{
+					int iLast = i + rand() % 20 - 2;
+					size_t nBefore = model.size();
+					for( int j = i; j <= iLast; j++ ) model.insert(j);
+					CHECK(set.AddRange(i, iLast) == (model.size() != nBefore));
+				}
+				break;
+			case 8:
+				if( rand() % 8 == 0 ) {
+					set.RemoveFrom(i);
+					model.erase(model.lower_bound(i), model.end());
+				}
+				break;
+			case 9:
+				if( rand() % 30 == 0 ) {
+					set.Empty();
+					model.clear();
+				}
+				break;
+			}
+			CHECK(SameAsModel(set, model, nRange + 20));
+			nOps++;
+		}
+	}
+	// what it refuses
+	CStdIndexSet set;
+	CHECK(!set.Add(-1));
+	CHECK(!set.AddRange(5, 4));
+	CHECK(!set.Remove(0));
+	CHECK(set.IsEmpty() && set.GetNext(-1) == -1);
+	printf("%d operations\n", nOps);
+}
+
+// select all, deselect every other row of a stretch, and walk the selection
+static void TestLongList()
+{
+	const int nRows = 1000000;
+	CIndexSetProbe set;
+	CHECK(set.AddRange(0, nRows - 1));
+	CHECK(set.GetSize() == nRows && set.GetRanges() == 1);
+	for( int i = 1000; i < 3000; i += 2 ) CHECK(set.Remove(i));
+	CHECK(set.GetSize() == nRows - 1000 && set.GetRanges() == 1001);
+	CHECK(set.Find(999) && !set.Find(1000) && set.Find(1001) && set.Find(nRows - 1) && !set.Find(nRows));
+	int nWalked = 0, iPrev = -1;
+	for( int i = set.GetFirst(); i >= 0; i = set.GetNext(i) ) {
+		if( i <= iPrev ) break;
+		iPrev = i;
+		nWalked++;
+	}
+	CHECK(nWalked == set.GetSize());
+	// the rows come back one at a time, and merge back into one range
+	for( int i = 1000; i < 3000; i += 2 ) CHECK(set.Add(i));
+	CHECK(set.GetSize() == nRows && set.GetRanges() == 1);
+	// the list loses its last half
+	set.RemoveFrom(nRows / 2);
+	CHECK(set.GetSize() == nRows / 2 && set.GetLast() == nRows / 2 - 1);
+}
+
+int main()
+{
+	srand(70);
+	TestAgainstModel();
+	TestLongList();
+	return TestResult("IndexSetTest");
+}
@@ -0,0 +1,548 @@
+// LayoutTest.cpp : the vertical and horizontal layouts, laid out only where something asked
+// for it, against the same tree laid out in full every time. Random trees of nested layouts
+// with fixed, stretching, auto-sized, padded, limited, float and hidden children go through
+// a few dozen changes each (sizes, visibility, child padding, the window size, a full layout
+// asked for), and after every paint both trees must have every visible control in the same
+// place. A few small layouts are also checked against rects worked out by hand.
+
+#include "StdAfx.h"
+#include "TestCheck.h"
+#include "Layout/UIVerticalLayout.cpp"
+#include "Layout/UIHorizontalLayout.cpp"
+
+namespace DuiLib {
+
+	// as in UIControl.cpp, without the invalidating and OnSize
+	void CControlUI::SetPos(RECT rc, bool bNeedInvalidate)
+	{
+		if( rc.right < rc.left ) rc.right = rc.left;
+		if( rc.bottom < rc.top ) rc.bottom = rc.top;
+
+		m_nSetPos++;
+		m_rcItem = rc;
+		if( m_pManager == NULL ) return;
+		m_pManager->NeedHitTestUpdate();
+
+		m_bUpdateNeeded = false;
+	}
+
+	SIZE CControlUI::EstimateSize(SIZE szAvailable)
+	{
+		m_nEstimates++;
+		if( m_cxAutoWidth > 0 ) {
+			bool bWrap = szAvailable.cy >= 40;
+			m_cxyFixed.cx = bWrap ? (m_cxAutoWidth + 1) / 2 : m_cxAutoWidth;
+			if( m_cxyFixed.cy == 0 ) {
+				SIZE sz = { m_cxyFixed.cx, bWrap ? 32 : 16 };
+				return sz;
+			}
+		}
+		return m_cxyFixed;
+	}
+
+	void CControlUI::SetVisible(bool bVisible)
+	{
+		if( m_bVisible == bVisible ) return;
+
+		bool v = IsVisible();
+		m_bVisible = bVisible;
+		if( IsVisible() != v ) {
+			// NeedUpdate isn't recorded while hidden, so lay out again whatever changed meanwhile
+			if( !v ) m_bUpdateNeeded = true;
+			NeedParentUpdate();
+		}
+	}
+
+	void CControlUI::SetInternVisible(bool bVisible)
+	{
+		if( bVisible && !m_bInternVisible && m_bVisible ) m_bUpdateNeeded = true;
+		m_bInternVisible = bVisible;
+		if( m_pManager != NULL ) m_pManager->NeedHitTestUpdate();
+	}
+
+	void CControlUI::NeedUpdate()
+	{
+		if( !IsVisible() ) return;
+		m_bUpdateNeeded = true;
+		Invalidate();
+
+		if( m_pManager != NULL ) m_pManager->NeedUpdate();
+	}
+
+	void CControlUI::NeedParentUpdate()
+	{
+		if( GetParent() ) {
+			GetParent()->NeedUpdate();
+			GetParent()->Invalidate();
+		}
+		else {
+			NeedUpdate();
+		}
+
+		if( m_pManager != NULL ) m_pManager->NeedUpdate();
+	}
+
+	void CControlUI::GetVisible(std::vector<CControlUI*>& aControls)
+	{
+		if( IsVisible() ) aControls.push_back(this);
+	}
+
+	// as in UIContainer.cpp
+	void CContainerUI::SetVisible(bool bVisible)
+	{
+		if( m_bVisible == bVisible ) return;
+		CControlUI::SetVisible(bVisible);
+		for( int it = 0; it < m_items.GetSize(); it++ ) {
+			static_cast<CControlUI*>(m_items[it])->SetInternVisible(IsVisible());
+		}
+	}
+
+	void CContainerUI::SetInternVisible(bool bVisible)
+	{
+		CControlUI::SetInternVisible(bVisible);
+		if( m_items.IsEmpty() ) return;
+		for( int it = 0; it < m_items.GetSize(); it++ ) {
+			static_cast<CControlUI*>(m_items[it])->SetInternVisible(IsVisible());
+		}
+	}
+
+	void CContainerUI::SetPos(RECT rc, bool bNeedInvalidate)
+	{
+		CControlUI::SetPos(rc, bNeedInvalidate);
+		if( m_items.IsEmpty() ) return;
+
+		rc = m_rcItem;
+		rc.left += m_rcInset.left;
+		rc.top += m_rcInset.top;
+		rc.right -= m_rcInset.right;
+		rc.bottom -= m_rcInset.bottom;
+
+		for( int it = 0; it < m_items.GetSize(); it++ ) {
+			CControlUI* pControl = static_cast<CControlUI*>(m_items[it]);
+			if( !pControl->IsVisible() ) continue;
+			if( pControl->IsFloat() ) {
+				SetFloatPos(it);
+			}
+			else {
+				SIZE sz = { rc.right - rc.left, rc.bottom - rc.top };
+				if( sz.cx < pControl->GetMinWidth() ) sz.cx = pControl->GetMinWidth();
+				if( sz.cx > pControl->GetMaxWidth() ) sz.cx = pControl->GetMaxWidth();
+				if( sz.cy < pControl->GetMinHeight() ) sz.cy = pControl->GetMinHeight();
+				if( sz.cy > pControl->GetMaxHeight() ) sz.cy = pControl->GetMaxHeight();
+				RECT rcCtrl = { rc.left, rc.top, rc.left + sz.cx, rc.top + sz.cy };
+				SetItemPos(pControl, rcCtrl);
+			}
+		}
+	}
+
+	void CContainerUI::SetFloatPos(int iIndex)
+	{
+		if( iIndex < 0 || iIndex >= m_items.GetSize() ) return;
+
+		CControlUI* pControl = static_cast<CControlUI*>(m_items[iIndex]);
+
+		if( !pControl->IsVisible() ) return;
+		if( !pControl->IsFloat() ) return;
+
+		SIZE szXY = pControl->GetFixedXY();
+		SIZE sz = {pControl->GetFixedWidth(), pControl->GetFixedHeight()};
+
+		int nParentWidth = m_rcItem.right - m_rcItem.left;
+		int nParentHeight = m_rcItem.bottom - m_rcItem.top;
+
+		UINT uAlign = pControl->GetFloatAlign();
+		if(uAlign != 0) {
+			RECT rcCtrl = {0, 0, sz.cx, sz.cy};
+			if((uAlign & DT_CENTER) != 0) {
+				::OffsetRect(&rcCtrl, (nParentWidth - sz.cx) / 2, 0);
+			}
+			else if((uAlign & DT_RIGHT) != 0) {
+				::OffsetRect(&rcCtrl, nParentWidth - sz.cx, 0);
+			}
+			else {
+				::OffsetRect(&rcCtrl, szXY.cx, 0);
+			}
+
+			if((uAlign & DT_VCENTER) != 0) {
+				::OffsetRect(&rcCtrl, 0, (nParentHeight - sz.cy) / 2);
+			}
+			else if((uAlign & DT_BOTTOM) != 0) {
+				::OffsetRect(&rcCtrl, 0, nParentHeight - sz.cy);
+			}
+			else {
+				::OffsetRect(&rcCtrl, 0, szXY.cy);
+			}
+
+			::OffsetRect(&rcCtrl, m_rcItem.left, m_rcItem.top);
+			SetItemPos(pControl, rcCtrl);
+		}
+		else {
+			TPercentInfo rcPercent = pControl->GetFloatPercent();
+			LONG width = m_rcItem.right - m_rcItem.left;
+			LONG height = m_rcItem.bottom - m_rcItem.top;
+			RECT rcCtrl = { 0 };
+			rcCtrl.left = (LONG)(width*rcPercent.left) + szXY.cx+ m_rcItem.left;
+			rcCtrl.top = (LONG)(height*rcPercent.top) + szXY.cy+ m_rcItem.top;
+			rcCtrl.right = (LONG)(width*rcPercent.right) + szXY.cx + sz.cx+ m_rcItem.left;
+			rcCtrl.bottom = (LONG)(height*rcPercent.bottom) + szXY.cy + sz.cy+ m_rcItem.top;
+			SetItemPos(pControl, rcCtrl);
+		}
+	}
+
+	void CContainerUI::SetItemPos(CControlUI* pControl, RECT rc, bool bNeedInvalidate)
+	{
+		// SetPos keeps rc like this
+		if( rc.right < rc.left ) rc.right = rc.left;
+		if( rc.bottom < rc.top ) rc.bottom = rc.top;
+
+		// Below an unchanged rect only controls that asked for an update need a layout, and
+		// the paint manager finds and lays out those after the layout from the root.
+		if( !pControl->IsUpdateNeeded() && ::EqualRect(&rc, &pControl->GetPos()) ) {
+			if( m_pManager == NULL || !m_pManager->IsFullLayoutNeeded() ) return;
+		}
+		pControl->SetPos(rc, bNeedInvalidate);
+	}
+
+	void CContainerUI::GetVisible(std::vector<CControlUI*>& aControls)
+	{
+		if( !IsVisible() ) return;
+		aControls.push_back(this);
+		for( int it = 0; it < m_items.GetSize(); it++ ) static_cast<CControlUI*>(m_items[it])->GetVisible(aControls);
+	}
+
+	// as in UIManager.cpp
+	void CPaintManagerUI::NeedFullLayout()
+	{
+		m_bFullLayout = true;
+		if( m_pRoot != NULL ) m_pRoot->NeedUpdate();
+		NeedUpdate();
+	}
+
+	// the layout WM_PAINT does before it paints
+	void CPaintManagerUI::Paint(const RECT& rcClient)
+	{
+		if( !m_bUpdateNeeded ) return;
+		m_bUpdateNeeded = false;
+		if( m_pRoot->IsUpdateNeeded() || m_bFullLayout ) {
+			m_pRoot->SetPos(rcClient, true);
+			m_bFullLayout = false;
+		}
+		std::vector<CControlUI*> aFoundControls;
+		m_pRoot->GetVisible(aFoundControls);
+		for( size_t it = 0; it < aFoundControls.size(); it++ ) {
+			CControlUI* pControl = aFoundControls[it];
+			if( !pControl->IsUpdateNeeded() ) continue;
+			pControl->SetPos(pControl->GetPos(), true);
+		}
+	}
+
+} // namespace DuiLib
+
+using namespace DuiLib;
+
+// the same numbers for both trees of a seed
+class CRandom
+{
+public:
+	explicit CRandom(unsigned int uSeed) : m_uState(uSeed) { }
+	int Next(int n)
+	{
+		m_uState = m_uState * 1103515245u + 12345u;
+		return (int)((m_uState >> 8) % (unsigned int)n);
+	}
+
+private:
+	unsigned int m_uState;
+};
+
+static CControlUI* MakeTree(CRandom& random, CPaintManagerUI* pManager, int nDepth, std::vector<CControlUI*>& aControls, std::vector<CContainerUI*>& aContainers)
+{
+	CControlUI* pControl;
+	int nKind = nDepth == 0 ? 0 : (nDepth > 3 ? 3 : random.Next(5));
+	if( nKind < 3 ) {
+		CContainerUI* pContainer;
+		if( nKind == 0 ) pContainer = new CVerticalLayoutUI;
+		else if( nKind == 1 ) pContainer = new CHorizontalLayoutUI;
+		else pContainer = new CContainerUI;
+		pContainer->m_pManager = pManager;
+		pContainer->m_iChildPadding = random.Next(3) * 2;
+		pContainer->m_iChildAlign = random.Next(3) == 0 ? DT_CENTER : random.Next(2) ? DT_RIGHT : DT_LEFT;
+		pContainer->m_iChildVAlign = random.Next(3) == 0 ? DT_VCENTER : random.Next(2) ? DT_BOTTOM : DT_TOP;
+		RECT rcInset = { random.Next(3), random.Next(3), random.Next(3), random.Next(3) };
+		pContainer->m_rcInset = rcInset;
+		int nItems = 1 + random.Next(nDepth == 0 ? 8 : 5);
+		for( int i = 0; i < nItems; i++ ) pContainer->Add(MakeTree(random, pManager, nDepth + 1, aControls, aContainers));
+		aContainers.push_back(pContainer);
+		pControl = pContainer;
+	}
+	else {
+		pControl = new CControlUI;
+		pControl->m_pManager = pManager;
+		if( random.Next(2) ) pControl->m_cxyFixed.cx = 5 + random.Next(60);
+		if( random.Next(2) ) pControl->m_cxyFixed.cy = 5 + random.Next(40);
+		if( random.Next(4) == 0 ) pControl->m_cxAutoWidth = 10 + random.Next(80);
+		if( random.Next(5) == 0 ) pControl->m_cxyMin.cx = random.Next(20);
+		if( random.Next(5) == 0 ) pControl->m_cxyMax.cy = 10 + random.Next(40);
+		if( random.Next(4) == 0 ) {
+			RECT rcPadding = { random.Next(4), random.Next(4), random.Next(4), random.Next(4) };
+			pControl->m_rcPadding = rcPadding;
+		}
+	}
+	if( nDepth > 0 && random.Next(12) == 0 ) {
+		pControl->m_bFloat = true;
+		pControl->m_cXY.cx = random.Next(30);
+		pControl->m_cXY.cy = random.Next(30);
+		pControl->m_cxyFixed.cx = 5 + random.Next(30);
+		pControl->m_cxyFixed.cy = 5 + random.Next(30);
+		pControl->m_uFloatAlign = random.Next(2) ? DT_RIGHT | DT_BOTTOM : 0;
+	}
+	if( nDepth > 0 && random.Next(10) == 0 ) pControl->m_bVisible = false;
+	aControls.push_back(pControl);
+	return pControl;
+}
+
+class CLayoutRun
+{
+public:
+	CLayoutRun(unsigned int uSeed, bool bFull) : m_random(uSeed), m_bFull(bFull), m_nEstimates(0), m_nSetPos(0)
+	{
+		m_pRoot = MakeTree(m_random, &m_manager, 0, m_aControls, m_aContainers);
+		m_manager.SetRoot(m_pRoot);
+		// the hidden ones were hidden before they were added
+		for( size_t i = 0; i < m_aContainers.size(); i++ ) {
+			CContainerUI* pContainer = m_aContainers[i];
+			for( int it = 0; it < pContainer->m_items.GetSize(); it++ ) {
+				static_cast<CControlUI*>(pContainer->m_items[it])->SetInternVisible(pContainer->IsVisible());
+			}
+		}
+		RECT rcClient = { 0, 0, 400 + m_random.Next(400), 300 + m_random.Next(300) };
+		m_rcClient = rcClient;
+		m_manager.NeedFullLayout();
+		m_manager.Paint(m_rcClient);
+		Count();
+		m_nEstimates = m_nSetPos = 0;
+	}
+	~CLayoutRun()
+	{
+		delete m_pRoot;
+	}
+
+	void Change()
+	{
+		CControlUI* pControl = m_aControls[m_random.Next((int)m_aControls.size())];
+		CContainerUI* pContainer = m_aContainers[m_random.Next((int)m_aContainers.size())];
+		switch( m_random.Next(8) ) {
+		case 0:
+			if( dynamic_cast<CContainerUI*>(pControl) == NULL ) {
+				pControl->m_cxyFixed.cy = m_random.Next(2) ? 5 + m_random.Next(40) : 0;
+				pControl->NeedParentUpdate();
+			}
+			break;
+		case 1:
+			if( pControl != m_pRoot ) pControl->SetVisible(!pControl->m_bVisible);
+			break;
+		case 2:
+			m_rcClient.right = 300 + m_random.Next(500);
+			m_rcClient.bottom = 200 + m_random.Next(400);
+			m_pRoot->NeedUpdate();
+			break;
+		case 3:
+			pContainer->m_iChildPadding = m_random.Next(4) * 2;
+			pContainer->NeedUpdate();
+			break;
+		case 4:
+			break;
+		case 5:
+			if( pControl->m_cxAutoWidth > 0 ) {
+				pControl->m_cxAutoWidth = 10 + m_random.Next(80);
+				pControl->NeedParentUpdate();
+			}
+			break;
+		case 6:
+			pControl->m_cxyFixed.cx = m_random.Next(2) ? 5 + m_random.Next(60) : 0;
+			pControl->NeedParentUpdate();
+			break;
+		case 7:
+			if( m_random.Next(8) == 0 ) m_manager.NeedFullLayout();
+			break;
+		}
+		if( m_bFull ) m_manager.NeedFullLayout();
+		m_manager.Paint(m_rcClient);
+		Count();
+	}
+
+	std::vector<RECT> GetVisibleRects()
+	{
+		std::vector<CControlUI*> aVisible;
+		m_pRoot->GetVisible(aVisible);
+		std::vector<RECT> aRects;
+		for( size_t i = 0; i < aVisible.size(); i++ ) aRects.push_back(aVisible[i]->GetPos());
+		return aRects;
+	}
+
+	long m_nEstimates;
+	long m_nSetPos;
+
+private:
+	void Count()
+	{
+		for( size_t i = 0; i < m_aControls.size(); i++ ) {
+			m_nEstimates += m_aControls[i]->m_nEstimates;
+			m_nSetPos += m_aControls[i]->m_nSetPos;
+			m_aControls[i]->m_nEstimates = m_aControls[i]->m_nSetPos = 0;
+		}
+	}
+
+	CRandom m_random;
+	bool m_bFull;
+	CPaintManagerUI m_manager;
+	CControlUI* m_pRoot;
+	std::vector<CControlUI*> m_aControls;
+	std::vector<CContainerUI*> m_aContainers;
+	RECT m_rcClient;
+};
+
+static bool SameRects(const std::vector<RECT>& a, const std::vector<RECT>& b)
+{
+	if( a.size() != b.size() ) return false;
+	for( size_t i = 0; i < a.size(); i++ ) {
+		if( !::EqualRect(&a[i], &b[i]) ) return false;
+	}
+	return true;
+}
+
+static void TestAgainstFullLayout()
+{
+	long nEstimates[2] = { 0 }, nSetPos[2] = { 0 };
+	int nSteps = 0;
+	for( unsigned int uSeed = 1; uSeed <= 2000; uSeed++ ) {
+		CLayoutRun incremental(uSeed, false), full(uSeed, true);
+		CHECK(SameRects(incremental.GetVisibleRects(), full.GetVisibleRects()));
+		for( int nStep = 0; nStep < 40; nStep++ ) {
+			incremental.Change();
+			full.Change();
+			bool bSame = SameRects(incremental.GetVisibleRects(), full.GetVisibleRects());
+			CHECK(bSame);
+			if( !bSame ) {
+				fprintf(stderr, "seed %u step %d\n", uSeed, nStep);
+				break;
+			}
+			nSteps++;
+		}
+		nEstimates[0] += incremental.m_nEstimates;
+		nSetPos[0] += incremental.m_nSetPos;
+		nEstimates[1] += full.m_nEstimates;
+		nSetPos[1] += full.m_nSetPos;
+	}
+	printf("%d steps; laid out where asked: %ld EstimateSize, %ld SetPos; in full: %ld EstimateSize, %ld SetPos\n",
+		nSteps, nEstimates[0], nSetPos[0], nEstimates[1], nSetPos[1]);
+	CHECK(nSetPos[0] < nSetPos[1] / 2);
+}
+
+static bool IsRect(const CControlUI* pControl, LONG left, LONG top, LONG right, LONG bottom)
+{
+	RECT rc = { left, top, right, bottom };
+	return ::EqualRect(&pControl->GetPos(), &rc) != FALSE;
+}
+
+// a fixed child, two that share what is left, and one placed by a float
+static void TestKnownLayouts()
+{
+	CPaintManagerUI manager;
+	CVerticalLayoutUI* pVertical = new CVerticalLayoutUI;
+	pVertical->m_pManager = &manager;
+	pVertical->m_iChildPadding = 4;
+	RECT rcInset = { 10, 10, 10, 10 };
+	pVertical->m_rcInset = rcInset;
+	CControlUI* pTitle = new CControlUI;
+	pTitle->m_cxyFixed.cy = 30;
+	CControlUI* pTop = new CControlUI;
+	CControlUI* pBottom = new CControlUI;
+	CControlUI* pBadge = new CControlUI;
+	pBadge->m_bFloat = true;
+	pBadge->m_cxyFixed.cx = 16;
+	pBadge->m_cxyFixed.cy = 16;
+	pBadge->m_uFloatAlign = DT_RIGHT | DT_BOTTOM;
+	pVertical->Add(pTitle);
+	pVertical->Add(pTop);
+	pVertical->Add(pBottom);
+	pVertical->Add(pBadge);
+	manager.SetRoot(pVertical);
+	manager.NeedFullLayout();
+	RECT rcClient = { 0, 0, 200, 151 };
+	manager.Paint(rcClient);
+	CHECK(IsRect(pVertical, 0, 0, 200, 151));
+	CHECK(IsRect(pTitle, 10, 10, 190, 40));
+	// 131 high inside the inset, less 30 and two paddings, leaves 93: 46 and the 47 left over
+	CHECK(IsRect(pTop, 10, 44, 190, 90));
+	CHECK(IsRect(pBottom, 10, 94, 190, 141));
+	CHECK(IsRect(pBadge, 184, 135, 200, 151));
+
+	// the title grows: only the layout and its children move, and each is laid out once
+	pTitle->m_cxyFixed.cy = 50;
+	pTitle->NeedParentUpdate();
+	pTop->m_nSetPos = pBottom->m_nSetPos = pBadge->m_nSetPos = 0;
+	manager.Paint(rcClient);
+	CHECK(IsRect(pTitle, 10, 10, 190, 60));
+	CHECK(IsRect(pTop, 10, 64, 190, 100));
+	CHECK(IsRect(pBottom, 10, 104, 190, 141));
+	CHECK(pTop->m_nSetPos == 1 && pBottom->m_nSetPos == 1 && pBadge->m_nSetPos == 0);
+
+	// nothing asked: nothing is laid out
+	pTitle->m_nSetPos = pTop->m_nSetPos = 0;
+	manager.NeedUpdate();
+	manager.Paint(rcClient);
+	CHECK(pTitle->m_nSetPos == 0 && pTop->m_nSetPos == 0);
+	delete pVertical;
+
+	// a label that would wrap in the whole height but gets only what the header leaves: the
+	// placing loop must measure it again
+	CPaintManagerUI wrap;
+	CVerticalLayoutUI* pColumn = new CVerticalLayoutUI;
+	pColumn->m_pManager = &wrap;
+	CControlUI* pHeader = new CControlUI;
+	pHeader->m_cxyFixed.cy = 30;
+	CControlUI* pLabel = new CControlUI;
+	pLabel->m_cxAutoWidth = 50;
+	pColumn->Add(pHeader);
+	pColumn->Add(pLabel);
+	wrap.SetRoot(pColumn);
+	wrap.NeedFullLayout();
+	RECT rcColumn = { 0, 0, 100, 60 };
+	wrap.Paint(rcColumn);
+	CHECK(IsRect(pHeader, 0, 0, 100, 30));
+	// one line high, not the two it measured in the whole height
+	CHECK(pLabel->GetPos().top == 30 && pLabel->GetPos().bottom == 46);
+	CHECK(pLabel->m_cxyFixed.cx == 50);
+	delete pColumn;
+
+	// a row of two fixed and one stretching, right-aligned when it has room
+	CPaintManagerUI row;
+	CHorizontalLayoutUI* pHorizontal = new CHorizontalLayoutUI;
+	pHorizontal->m_pManager = &row;
+	pHorizontal->m_iChildPadding = 2;
+	CControlUI* pIcon = new CControlUI;
+	pIcon->m_cxyFixed.cx = 24;
+	CControlUI* pText = new CControlUI;
+	CControlUI* pButton = new CControlUI;
+	pButton->m_cxyFixed.cx = 60;
+	pButton->m_cxyFixed.cy = 20;
+	pHorizontal->Add(pIcon);
+	pHorizontal->Add(pText);
+	pHorizontal->Add(pButton);
+	row.SetRoot(pHorizontal);
+	row.NeedFullLayout();
+	RECT rcRow = { 0, 0, 300, 32 };
+	row.Paint(rcRow);
+	CHECK(IsRect(pIcon, 0, 0, 24, 32));
+	CHECK(IsRect(pText, 26, 0, 238, 32));
+	CHECK(IsRect(pButton, 240, 0, 300, 20));
+	delete pHorizontal;
+}
+
+int main()
+{
+	TestKnownLayouts();
+	TestAgainstFullLayout();
+	return TestResult("LayoutTest");
+}
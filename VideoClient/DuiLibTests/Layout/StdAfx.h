@@ -0,0 +1,210 @@
+#pragma once
+
+#include "Win32Shim.h"
+#include "Utils/Utils.h"
+#include <vector>
+
+// Stand-ins for the controls and the paint manager, with what the vertical and horizontal
+// layouts read and call. The real ones need a window; LayoutTest.cpp carries the layout
+// parts of CControlUI and CContainerUI as they are in UIControl.cpp and UIContainer.cpp.
+
+#define MAX(a, b) (((a) > (b)) ? (a) : (b))
+#define MIN(a, b) (((a) < (b)) ? (a) : (b))
+#define DT_LEFT 0x00000000
+#define DT_TOP 0x00000000
+#define DT_CENTER 0x00000001
+#define DT_RIGHT 0x00000002
+#define DT_VCENTER 0x00000004
+#define DT_BOTTOM 0x00000008
+#define IDC_SIZENS 32645
+#define IDC_SIZEWE 32644
+#define UISTATE_CAPTURED 0x00000040
+#define UIFLAG_SETCURSOR 0x00000002
+#define DUI_CTR_VERTICALLAYOUT (_T("VerticalLayout"))
+#define DUI_CTR_HORIZONTALLAYOUT (_T("HorizontalLayout"))
+#define DECLARE_DUICONTROL(class_name)
+#define IMPLEMENT_DUICONTROL(class_name)
+
+namespace DuiLib {
+
+	enum { DUIATTR_UNKNOWN = 0, DUIATTR_SEPHEIGHT, DUIATTR_SEPWIDTH, DUIATTR_SEPIMM };
+	enum { UIEVENT_MOUSEMOVE = 1, UIEVENT_BUTTONDOWN, UIEVENT_BUTTONUP, UIEVENT_SETCURSOR };
+
+	class CControlUI;
+
+	typedef struct tagTEventUI
+	{
+		int Type;
+		POINT ptMouse;
+	} TEventUI;
+
+	typedef struct tagTPercentInfo
+	{
+		double left;
+		double top;
+		double right;
+		double bottom;
+	} TPercentInfo;
+
+	class CRenderEngine
+	{
+	public:
+		static void DrawColor(HDC, const RECT&, DWORD) { }
+	};
+
+	class CDPI
+	{
+	public:
+		void Scale(RECT*) { }
+	};
+
+	class CPaintManagerUI
+	{
+	public:
+		CPaintManagerUI() : m_pRoot(NULL), m_bFullLayout(false), m_bUpdateNeeded(false) { }
+		CDPI* GetDPIObj() { return &m_dpi; }
+		void NeedUpdate() { m_bUpdateNeeded = true; }
+		void NeedFullLayout();
+		bool IsFullLayoutNeeded() const { return m_bFullLayout; }
+		void NeedHitTestUpdate() { }
+		void Invalidate(RECT&) { }
+		bool AddPostPaint(CControlUI*) { return true; }
+		bool RemovePostPaint(CControlUI*) { return true; }
+		void SetRoot(CControlUI* pRoot) { m_pRoot = pRoot; }
+		void Paint(const RECT& rcClient);
+
+		CDPI m_dpi;
+		CControlUI* m_pRoot;
+		bool m_bFullLayout;
+		bool m_bUpdateNeeded;
+	};
+
+	class CControlUI
+	{
+	public:
+		CControlUI() : m_pManager(NULL), m_pParent(NULL), m_bVisible(true), m_bInternVisible(true), m_bFloat(false),
+			m_bUpdateNeeded(true), m_uFloatAlign(0), m_cxAutoWidth(0), m_nEstimates(0), m_nSetPos(0)
+		{
+			::ZeroMemory(&m_rcItem, sizeof(m_rcItem));
+			::ZeroMemory(&m_rcPadding, sizeof(m_rcPadding));
+			::ZeroMemory(&m_cXY, sizeof(m_cXY));
+			::ZeroMemory(&m_cxyFixed, sizeof(m_cxyFixed));
+			::ZeroMemory(&m_piFloatPercent, sizeof(m_piFloatPercent));
+			m_cxyMin.cx = m_cxyMin.cy = 0;
+			m_cxyMax.cx = m_cxyMax.cy = 9999;
+		}
+		virtual ~CControlUI() { }
+
+		virtual LPVOID GetInterface(LPCTSTR) { return NULL; }
+		virtual void SetAttributeById(int, LPCTSTR, LPCTSTR) { }
+		virtual void DoEvent(TEventUI&) { }
+		bool IsEnabled() const { return true; }
+
+		const RECT& GetPos() const { return m_rcItem; }
+		RECT GetPadding() const { return m_rcPadding; }
+		SIZE GetFixedXY() const { return m_cXY; }
+		int GetFixedWidth() const { return m_cxyFixed.cx; }
+		int GetFixedHeight() const { return m_cxyFixed.cy; }
+		int GetMinWidth() const { return m_cxyMin.cx; }
+		int GetMaxWidth() const { return m_cxyMax.cx; }
+		int GetMinHeight() const { return m_cxyMin.cy; }
+		int GetMaxHeight() const { return m_cxyMax.cy; }
+		TPercentInfo GetFloatPercent() const { return m_piFloatPercent; }
+		UINT GetFloatAlign() const { return m_uFloatAlign; }
+		bool IsVisible() const { return m_bVisible && m_bInternVisible; }
+		bool IsFloat() const { return m_bFloat; }
+		bool IsUpdateNeeded() const { return m_bUpdateNeeded; }
+		CControlUI* GetParent() const { return m_pParent; }
+		CPaintManagerUI* GetManager() const { return m_pManager; }
+		void Invalidate() { }
+
+		virtual void SetPos(RECT rc, bool bNeedInvalidate = true);
+		// an auto-sized label: it writes the width of its text into m_cxyFixed and, without a
+		// fixed height, is as high as its lines, as CLabelUI is; the text wraps onto two lines
+		// when there is the height for them
+		virtual SIZE EstimateSize(SIZE szAvailable);
+		virtual void SetVisible(bool bVisible = true);
+		virtual void SetInternVisible(bool bVisible = true);
+		void NeedUpdate();
+		void NeedParentUpdate();
+		// the visible controls below and including this one, parents first
+		virtual void GetVisible(std::vector<CControlUI*>& aControls);
+
+		CPaintManagerUI* m_pManager;
+		CControlUI* m_pParent;
+		RECT m_rcItem;
+		RECT m_rcPadding;
+		SIZE m_cXY;
+		SIZE m_cxyFixed;
+		SIZE m_cxyMin;
+		SIZE m_cxyMax;
+		TPercentInfo m_piFloatPercent;
+		bool m_bVisible;
+		bool m_bInternVisible;
+		bool m_bFloat;
+		bool m_bUpdateNeeded;
+		UINT m_uFloatAlign;
+		int m_cxAutoWidth;
+		int m_nEstimates;
+		int m_nSetPos;
+	};
+
+	class CScrollBarUI : public CControlUI
+	{
+	public:
+		int GetScrollRange() const { return 0; }
+		int GetScrollPos() const { return 0; }
+	};
+
+	class CContainerUI : public CControlUI
+	{
+	public:
+		CContainerUI() : m_iChildPadding(0), m_iChildAlign(DT_LEFT), m_iChildVAlign(DT_TOP), m_pVerticalScrollBar(NULL), m_pHorizontalScrollBar(NULL)
+		{
+			::ZeroMemory(&m_rcInset, sizeof(m_rcInset));
+		}
+		virtual ~CContainerUI()
+		{
+			for( int it = 0; it < m_items.GetSize(); it++ ) delete static_cast<CControlUI*>(m_items[it]);
+		}
+
+		bool Add(CControlUI* pControl)
+		{
+			pControl->m_pParent = this;
+			pControl->m_pManager = m_pManager;
+			return m_items.Add(pControl);
+		}
+		UINT GetChildAlign() const { return m_iChildAlign; }
+		UINT GetChildVAlign() const { return m_iChildVAlign; }
+
+		void SetPos(RECT rc, bool bNeedInvalidate = true);
+		void SetVisible(bool bVisible = true);
+		void SetInternVisible(bool bVisible = true);
+		void GetVisible(std::vector<CControlUI*>& aControls);
+
+	protected:
+		virtual void SetFloatPos(int iIndex);
+		virtual void ProcessScrollBar(RECT, int, int) { }
+		void SetItemPos(CControlUI* pControl, RECT rc, bool bNeedInvalidate = false);
+
+		struct TItemSize
+		{
+			SIZE szAvailable;
+			SIZE sz;
+			bool bValid;
+		};
+
+	public:
+		CStdPtrArray m_items;
+		RECT m_rcInset;
+		int m_iChildPadding;
+		UINT m_iChildAlign;
+		UINT m_iChildVAlign;
+		CScrollBarUI* m_pVerticalScrollBar;
+		CScrollBarUI* m_pHorizontalScrollBar;
+	};
+
+} // namespace DuiLib
+
+#include "Layout/UIVerticalLayout.h"
+#include "Layout/UIHorizontalLayout.h"
@@ -0,0 +1,73 @@
+// MarkupBench.cpp : load time of a large UTF-8 skin, parsed in place by LoadFromMem against
+// Load on the same text as TCHAR, then the time to read every attribute back as a builder does.
+// usage: MarkupBench [controls] [rounds]
+
+#include "StdAfx.h"
+#include <string>
+#include <chrono>
+
+using namespace DuiLib;
+
+typedef std::chrono::steady_clock Clock;
+
+static double Ms(Clock::time_point t0, Clock::time_point t1)
+{
+	return std::chrono::duration<double, std::milli>(t1 - t0).count();
+}
+
+static std::string MakeSkin(int nControls)
+{
+	std::string sXML = "\xEF\xBB\xBF<?xml version=\"1.0\" encoding=\"utf-8\"?>\n<Window size=\"1920,1080\">\n<VerticalLayout name=\"root\">";
+	char sz[512];
+	for( int i = 0; i < nControls; i++ ) {
+		if( i % 8 == 0 ) sXML += "\n  <HorizontalLayout height=\"32\" childpadding=\"4\">";
+		snprintf(sz, sizeof(sz), "\n    <Button name=\"btn%d\" width=\"80\" height=\"28\" text=\"button &amp; more\" tooltip=\"tip %d\" "
+			"textcolor=\"#FF333333\" normalimage=\"file='btn.png' source='0,0,80,28'\" padding=\"2,2,2,2\" />", i, i);
+		sXML += sz;
+		if( i % 8 == 7 || i == nControls - 1 ) sXML += "\n  </HorizontalLayout>";
+	}
+	sXML += "\n</VerticalLayout>\n</Window>\n";
+	return sXML;
+}
+
+static size_t ReadBack(CMarkupNode node)
+{
+	size_t nChars = 0;
+	for( ; node.IsValid(); node = node.GetSibling() ) {
+		int nAttributes = node.GetAttributeCount();
+		for( int i = 0; i < nAttributes; i++ ) nChars += _tcslen(node.GetAttributeName(i)) + _tcslen(node.GetAttributeValue(i));
+		nChars += ReadBack(node.GetChild());
+	}
+	return nChars;
+}
+
+int main(int argc, char* argv[])
+{
+	int nControls = argc > 1 ? atoi(argv[1]) : 100000;
+	int nRounds = argc > 2 ? atoi(argv[2]) : 5;
+	std::string sXML = MakeSkin(nControls);
+	std::string sText = sXML.substr(3);
+	printf("%d controls, %.1f MB\n", nControls, sXML.size() / 1048576.0);
+
+	for( int r = 0; r < nRounds; r++ ) {
+		Clock::time_point t0 = Clock::now();
+		CMarkup inPlace;
+		std::string sBuffer = sXML;
+		bool bInPlace = inPlace.LoadFromMem((BYTE*)&sBuffer[0], (DWORD)sBuffer.size());
+		Clock::time_point t1 = Clock::now();
+		size_t nInPlace = ReadBack(inPlace.GetRoot());
+		Clock::time_point t2 = Clock::now();
+		CMarkup text;
+		bool bText = text.Load(sText.c_str());
+		Clock::time_point t3 = Clock::now();
+		size_t nText = ReadBack(text.GetRoot());
+		Clock::time_point t4 = Clock::now();
+		if( !bInPlace || !bText || nInPlace != nText ) {
+			printf("the parsers disagree\n");
+			return 1;
+		}
+		printf("in place: load %7.2f ms, read back %7.2f ms   TCHAR: load %7.2f ms, read back %7.2f ms\n",
+			Ms(t0, t1), Ms(t1, t2), Ms(t2, t3), Ms(t3, t4));
+	}
+	return 0;
+}
@@ -0,0 +1,214 @@
+// MarkupTest.cpp : the in-place UTF-8 parser of CMarkup against its TCHAR parser.
+// Sample skins and a few hundred random mutations of each go through LoadFromMem and Load,
+// with whitespace preserved and collapsed; both must accept or reject the same text and give
+// the same tree or the same error. The accepted trees also go through Swap, IndexAttributes and a compiled skin,
+// whose classes, attribute ids and numbers must match what the text says.
+// Built twice: with the SSE2 scanner and, with __SSE2__ undefined, with the scalar one.
+
+#include "StdAfx.h"
+#include "TestCheck.h"
+#include <string>
+
+using namespace DuiLib;
+
+static const char* const SAMPLE_SKINS[] =
+{
+	"<?xml version=\"1.0\" encoding=\"utf-8\" standalone=\"yes\" ?>\n"
+	"<Window size=\"800,600\" caption=\"0,0,0,32\" roundcorner=\"4,4\">\n"
+	"  <Font id=\"0\" name=\"Microsoft YaHei\" size=\"12\" default=\"true\" />\n"
+	"  <Default name=\"Button\" value=\"height=&quot;28&quot; textcolor=&quot;#FF333333&quot;\" />\n"
+	"  <!-- the title bar -->\n"
+	"  <VerticalLayout bkcolor=\"#FFF0F0F0\">\n"
+	"    <HorizontalLayout height=\"32\" inset=\"8,0,8,0\">\n"
+	"      <Label name=\"title\" text=\"Video &amp; audio &lt;wall&gt;\" />\n"
+	"      <Button name=\"closebtn\" width=\"32\" normalimage=\"file='close.png' source='0,0,32,32'\" />\n"
+	"    </HorizontalLayout>\n"
+	"    <Text>  two  spaces\tand a tab  </Text>\n"
+	"  </VerticalLayout>\n"
+	"</Window>\n",
+
+	"\xEF\xBB\xBF<Window><Label text=\"\xE4\xB8\xAD\xE6\x96\x87 &#65;&#x42;\"/><Edit text=\"'single' quoted\" tip=\"\"/>"
+	"<Option group=\"g\" selected=\"true\">&apos;x&apos; &quot;y&quot;</Option></Window>",
+
+	"<List header=\"hidden\" itemfont=\"1\"><ListHeader><ListHeaderItem text=\"a\" width=\"40\"/>"
+	"<ListHeaderItem text=\"b\" width=\"60\"/></ListHeader><ListLabelElement text=\"1\"/>"
+	"<ListLabelElement text=\"2\"><Control/><Control/></ListLabelElement>\n\n\n</List>",
+};
+
+static void Dump(CMarkupNode node, std::string& sOut, int nDepth)
+{
+	for( ; node.IsValid(); node = node.GetSibling() ) {
+		sOut.append(nDepth, ' ');
+		sOut += node.GetName();
+		sOut += '|';
+		sOut += node.GetValue();
+		sOut += '|';
+		int nAttributes = node.GetAttributeCount();
+		for( int i = 0; i < nAttributes; i++ ) {
+			sOut += node.GetAttributeName(i);
+			sOut += '=';
+			sOut += node.GetAttributeValue(i);
+			sOut += ';';
+		}
+		sOut += '\n';
+		Dump(node.GetChild(), sOut, nDepth + 1);
+	}
+}
+
+static std::string WithoutBOM(const std::string& sXML)
+{
+	return sXML.compare(0, 3, "\xEF\xBB\xBF") == 0 ? sXML.substr(3) : sXML;
+}
+
+static std::string Parse(const std::string& sXML, bool bInPlace, bool bPreserve)
+{
+	CMarkup markup;
+	markup.SetPreserveWhitespace(bPreserve);
+	bool bOk;
+	if( bInPlace ) {
+		std::string sBuffer = sXML;
+		bOk = markup.LoadFromMem((BYTE*)&sBuffer[0], (DWORD)sBuffer.size());
+	}
+	else {
+		// Load takes TCHAR text, which carries no BOM
+		bOk = markup.Load(WithoutBOM(sXML).c_str());
+	}
+	if( !bOk ) {
+		TCHAR szError[100];
+		markup.GetLastErrorMessage(szError, lengthof(szError));
+		return std::string("FAIL ") + szError;
+	}
+
+	std::string sTree;
+	Dump(markup.GetRoot(), sTree, 0);
+
+	CMarkup swapped;
+	swapped.Swap(markup);
+	swapped.IndexAttributes();
+	std::string sSwapped;
+	Dump(swapped.GetRoot(), sSwapped, 0);
+	CHECK(sSwapped == sTree);
+	return sTree;
+}
+
+static const char* const ATTRIBUTE_NAMES[] =
+{
+	NULL,
+#define DUI_ATTRIBUTE_NAME(id, name) name,
+	DUI_ATTRIBUTE_LIST(DUI_ATTRIBUTE_NAME)
+#undef DUI_ATTRIBUTE_NAME
+};
+
+static void CheckCompiledNode(CMarkup& compiled, CMarkupNode node)
+{
+	for( ; node.IsValid(); node = node.GetSibling() ) {
+		CHECK(node.GetClassIndex() >= 0 && node.GetClassIndex() < compiled.GetClassCount());
+		CHECK(strcmp(compiled.GetClass(node.GetClassIndex()), node.GetName()) == 0);
+		int nAttributes = node.GetAttributeCount();
+		for( int i = 0; i < nAttributes; i++ ) {
+			LPCTSTR pstrName = node.GetAttributeName(i);
+			LPCTSTR pstrValue = node.GetAttributeValue(i);
+			int nId = node.GetAttributeId(i);
+			CHECK(nId >= 0 && nId < DUIATTR_COUNT);
+			if( nId != DUIATTR_UNKNOWN ) CHECK(strcasecmp(ATTRIBUTE_NAMES[nId], pstrName) == 0);
+			else {
+				for( int j = 1; j < DUIATTR_COUNT; j++ ) CHECK(strcasecmp(ATTRIBUTE_NAMES[j], pstrName) != 0);
+			}
+
+			LONG aNumbers[4] = { 0 };
+			int nNumbers = node.GetAttributeNumbers(i, aNumbers, 4);
+			switch( node.GetAttributeType(i) ) {
+			case XMLVALUE_INT: {
+				CHECK(nNumbers >= 1 && nNumbers <= 4);
+				std::string sNumbers;
+				for( int j = 0; j < nNumbers; j++ ) sNumbers += (j > 0 ? "," : "") + std::to_string(aNumbers[j]);
+				CHECK(sNumbers == pstrValue);
+				break;
+			}
+			case XMLVALUE_COLOR:
+				CHECK(nNumbers == 1 && pstrValue[0] == '#' && (DWORD)aNumbers[0] == strtoul(pstrValue + 1, NULL, 16));
+				break;
+			default:
+				CHECK(nNumbers == 0);
+				CHECK(!(pstrValue[0] == '#' && pstrValue[1] != '\0' && strlen(pstrValue) <= 9 && strspn(pstrValue + 1, "0123456789abcdefABCDEF") == strlen(pstrValue + 1)));
+				CHECK(!(pstrValue[0] != '\0' && strspn(pstrValue, "0123456789,") == strlen(pstrValue) && strstr(pstrValue, ",,") == NULL
+					&& pstrValue[0] != ',' && pstrValue[strlen(pstrValue) - 1] != ','));
+				break;
+			}
+		}
+		CheckCompiledNode(compiled, node.GetChild());
+	}
+}
+
+static void TestCompiled(const char* pstrXML)
+{
+	CMarkup markup;
+	CHECK(markup.Load(WithoutBOM(pstrXML).c_str()));
+	std::string sTree;
+	Dump(markup.GetRoot(), sTree, 0);
+	const char* pstrFile = "MarkupTest.duib";
+	CHECK(markup.SaveCompiledFile(pstrFile));
+
+	CHECK(markup.GetClassCount() == 0 && markup.GetRoot().GetClassIndex() == -1 && markup.GetRoot().GetAttributeId(0) == -1);
+
+	CMarkup compiled;
+	CHECK(compiled.LoadFromFile(pstrFile));
+	std::string sCompiled;
+	Dump(compiled.GetRoot(), sCompiled, 0);
+	CHECK(sCompiled == sTree);
+	CheckCompiledNode(compiled, compiled.GetRoot());
+
+	// A skin compiled against another DUI_ATTRIBUTE_LIST gets its ids looked up again
+	FILE* pFile = fopen(pstrFile, "r+b");
+	CHECK(pFile != NULL);
+	if( pFile != NULL ) {
+		DWORD dwOtherList = 0x12345678;
+		fseek(pFile, 8 * sizeof(DWORD), SEEK_SET);
+		fwrite(&dwOtherList, sizeof(dwOtherList), 1, pFile);
+		fclose(pFile);
+	}
+	CMarkup other;
+	CHECK(other.LoadFromFile(pstrFile));
+	CheckCompiledNode(other, other.GetRoot());
+	::DeleteFile(pstrFile);
+}
+
+static void Mutate(std::string& sXML)
+{
+	static const char MUTATIONS[] = "<>\"'&/ =!?-;#\t\xE4";
+	int nMutations = 1 + rand() % 3;
+	for( int i = 0; i < nMutations && !sXML.empty(); i++ ) {
+		size_t pos = rand() % sXML.size();
+		char ch = MUTATIONS[rand() % (sizeof(MUTATIONS) - 1)];
+		switch( rand() % 3 ) {
+		case 0: sXML[pos] = ch; break;
+		case 1: sXML.erase(pos, 1); break;
+		default: sXML.insert(pos, 1, ch); break;
+		}
+	}
+}
+
+int main()
+{
+	srand(63);
+	int nRejected = 0;
+	int nRuns = 0;
+	for( size_t s = 0; s < lengthof(SAMPLE_SKINS); s++ ) {
+		CHECK(Parse(SAMPLE_SKINS[s], true, false).compare(0, 4, "FAIL") != 0);
+		for( int k = 0; k < 400; k++ ) {
+			std::string sXML = SAMPLE_SKINS[s];
+			if( k > 0 ) Mutate(sXML);
+			for( int bPreserve = 0; bPreserve < 2; bPreserve++ ) {
+				std::string sInPlace = Parse(sXML, true, bPreserve != 0);
+				std::string sText = Parse(sXML, false, bPreserve != 0);
+				if( sInPlace.compare(0, 4, "FAIL") == 0 ) nRejected++;
+				nRuns++;
+				CHECK(sInPlace == sText);
+			}
+		}
+		TestCompiled(SAMPLE_SKINS[s]);
+	}
+	CHECK(Parse("", true, false) == Parse("", false, false));
+	printf("%d parses, %d rejected by both parsers\n", nRuns, nRejected);
+	return TestResult("MarkupTest");
+}
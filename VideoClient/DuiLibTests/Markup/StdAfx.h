@@ -0,0 +1,22 @@
+#pragma once
+
+#include "Win32Shim.h"
+#include "Utils/Utils.h"
+
+namespace DuiLib
+{
+	// CMarkup::LoadFromFile reads from the resource path, or from the resource zip when one is set;
+	// the tests load from the working directory
+	class CPaintManagerUI
+	{
+	public:
+		static const CDuiString& GetResourcePath() { static CDuiString s_sPath; return s_sPath; }
+		static const CDuiString& GetResourceZip() { static CDuiString s_sZip; return s_sZip; }
+		static LPBYTE LoadResourceZipItem(LPCTSTR, DWORD*, int*) { return NULL; }
+		static void FreeResourceZipItem(LPBYTE, int) { }
+	};
+}
+
+#include "Core/UIMarkup.h"
+// the DUIATTR_* ids a compiled skin stores
+#include "Core/UIDefine.h"
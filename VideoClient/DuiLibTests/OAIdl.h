@@ -0,0 +1,28 @@
+#ifndef __OAIDL_H__
+#define __OAIDL_H__
+
+#pragma once
+
+// VARIANT as far as CDuiVariant in Utils.h touches it
+
+struct IDispatch;
+
+enum VARENUM { VT_EMPTY = 0, VT_I4 = 3, VT_R4 = 4, VT_BSTR = 8, VT_DISPATCH = 9 };
+
+typedef struct tagVARIANT
+{
+	WORD vt;
+	union
+	{
+		LONG lVal;
+		int intVal;
+		float fltVal;
+		BSTR bstrVal;
+		IDispatch* pdispVal;
+	};
+} VARIANT;
+
+inline void VariantInit(VARIANT* p) { memset(p, 0, sizeof(VARIANT)); }
+inline long VariantClear(VARIANT* p) { p->vt = VT_EMPTY; return 0; }
+
+#endif // __OAIDL_H__
@@ -0,0 +1,170 @@
+// HSLTest.cpp : the C, SSE2 and AVX2 kernels of CPixelKernel::AdjustHSL against the scalar
+// loop CRenderEngine::AdjustImage ran before them, kept here as it was. Every colour goes
+// through a few settings, and random images with repeated colours and odd lengths through
+// many more, so the memo and the tails are taken too; all of them must match bit for bit.
+// The kernels are static, so the test builds UIPixel.cpp itself.
+
+#include "StdAfx.h"
+#include "TestCheck.h"
+#include "Core/UIPixel.cpp"
+#include <vector>
+
+using namespace DuiLib;
+
+namespace Legacy {
+
+#define min(a,b) (((a) < (b)) ? (a) : (b))
+#define max(a,b) (((a) > (b)) ? (a) : (b))
+
+	static const float OneThird = 1.0f / 3;
+
+	static void RGBtoHSL(DWORD ARGB, float* H, float* S, float* L) {
+		const float
+			R = (float)GetRValue(ARGB),
+			G = (float)GetGValue(ARGB),
+			B = (float)GetBValue(ARGB),
+			nR = (R<0?0:(R>255?255:R))/255,
+			nG = (G<0?0:(G>255?255:G))/255,
+			nB = (B<0?0:(B>255?255:B))/255,
+			m = min(min(nR,nG),nB),
+			M = max(max(nR,nG),nB);
+		*L = (m + M)/2;
+		if (M==m) *H = *S = 0;
+		else {
+			const float
+				f = (nR==m)?(nG-nB):((nG==m)?(nB-nR):(nR-nG)),
+				i = (nR==m)?3.0f:((nG==m)?5.0f:1.0f);
+			*H = (i-f/(M-m));
+			if (*H>=6) *H-=6;
+			*H*=60;
+			*S = (2*(*L)<=1)?((M-m)/(M+m)):((M-m)/(2-M-m));
+		}
+	}
+
+	static void HSLtoRGB(DWORD* ARGB, float H, float S, float L) {
+		const float
+			q = 2*L<1?L*(1+S):(L+S-L*S),
+			p = 2*L-q,
+			h = H/360,
+			tr = h + OneThird,
+			tg = h,
+			tb = h - OneThird,
+			ntr = tr<0?tr+1:(tr>1?tr-1:tr),
+			ntg = tg<0?tg+1:(tg>1?tg-1:tg),
+			ntb = tb<0?tb+1:(tb>1?tb-1:tb),
+			B = 255*(6*ntr<1?p+(q-p)*6*ntr:(2*ntr<1?q:(3*ntr<2?p+(q-p)*6*(2.0f*OneThird-ntr):p))),
+			G = 255*(6*ntg<1?p+(q-p)*6*ntg:(2*ntg<1?q:(3*ntg<2?p+(q-p)*6*(2.0f*OneThird-ntg):p))),
+			R = 255*(6*ntb<1?p+(q-p)*6*ntb:(2*ntb<1?q:(3*ntb<2?p+(q-p)*6*(2.0f*OneThird-ntb):p)));
+		*ARGB &= 0xFF000000;
+		*ARGB |= RGB( (BYTE)(R<0?0:(R>255?255:R)), (BYTE)(G<0?0:(G>255?255:G)), (BYTE)(B<0?0:(B>255?255:B)) );
+	}
+
+#undef min
+#undef max
+
+	static void AdjustImage(DWORD* pBits, int nPixels, short H, short S, short L)
+	{
+		float fH, fS, fL;
+		float S1 = S / 100.0f;
+		float L1 = L / 100.0f;
+		for( int i = 0; i < nPixels; i++ ) {
+			RGBtoHSL(pBits[i], &fH, &fS, &fL);
+			fH += (H - 180);
+			fH = fH > 0 ? fH : fH + 360;
+			fS *= S1;
+			fL *= L1;
+			HSLtoRGB(&pBits[i], fH, fS, fL);
+		}
+	}
+
+} // namespace Legacy
+
+typedef void (*PFNADJUSTHSL)(DWORD* pDest, const DWORD* pSrc, int nPixels, const THSLAdjust& adj, THSLMemo* pMemo);
+
+static int Compare(PFNADJUSTHSL pfnAdjust, const std::vector<DWORD>& src, short H, short S, short L, int nFrom, int nCount)
+{
+	std::vector<DWORD> expected(src.begin() + nFrom, src.begin() + nFrom + nCount);
+	Legacy::AdjustImage(expected.empty() ? NULL : &expected[0], nCount, H, S, L);
+
+	THSLMemo* pMemo = new THSLMemo;
+	memset(pMemo->dwColor, 0xFF, sizeof(pMemo->dwColor));
+	// twice over, the second time mostly from the memo
+	int nMismatches = 0;
+	for( int nPass = 0; nPass < 2; nPass++ ) {
+		std::vector<DWORD> actual(nCount + 1, 0xDEADBEEF);
+		pfnAdjust(&actual[0], src.empty() ? NULL : &src[nFrom], nCount, MakeHSLAdjust(H, S, L), pMemo);
+		for( int i = 0; i < nCount; i++ ) {
+			if( actual[i] != expected[i] && nMismatches++ < 3 ) {
+				fprintf(stderr, "HSL %d,%d,%d: %08X gives %08X, not %08X\n", H, S, L, src[nFrom + i], actual[i], expected[i]);
+			}
+		}
+		CHECK(actual[nCount] == 0xDEADBEEF);
+	}
+	delete pMemo;
+	return nMismatches;
+}
+
+int main()
+{
+	PFNADJUSTHSL pfnKernels[3] = { AdjustHSLC, NULL, NULL };
+	const char* pstrKernels[3] = { "C", "SSE2", "AVX2" };
+#ifdef PIXEL_KERNEL_SIMD
+	pfnKernels[1] = AdjustHSLSSE2;
+	if( HasAVX2() ) pfnKernels[2] = AdjustHSLAVX2;
+#endif
+
+	// every colour, with the alpha of each varied
+	std::vector<DWORD> all(1 << 24);
+	for( DWORD i = 0; i < all.size(); i++ ) all[i] = i | ((i * 37) & 0xFF) << 24;
+	static const short ALL_SETTINGS[][3] = { { 0, 100, 100 }, { 270, 30, 200 } };
+	for( size_t s = 0; s < lengthof(ALL_SETTINGS); s++ ) {
+		for( int k = 0; k < 3; k++ ) {
+			if( pfnKernels[k] == NULL ) continue;
+			const short* pSetting = ALL_SETTINGS[s];
+			CHECK(Compare(pfnKernels[k], all, pSetting[0], pSetting[1], pSetting[2], 0, (int)all.size()) == 0);
+		}
+	}
+
+	// images of a few hundred colours, so most registers come out of the memo, at every
+	// setting SetHSL takes in steps, and starting and ending off a register
+	srand(66);
+	std::vector<DWORD> palette(300);
+	for( size_t i = 0; i < palette.size(); i++ ) palette[i] = ((DWORD)rand() << 16) ^ (DWORD)rand();
+	palette[0] = 0xFF000000;
+	palette[1] = 0xFFFFFFFF;
+	palette[2] = 0x80808080;
+	std::vector<DWORD> image(4099);
+	for( size_t i = 0; i < image.size(); i++ ) image[i] = palette[rand() % palette.size()];
+	int nSettings = 0;
+	for( short H = 0; H <= 360; H += 45 ) {
+		for( short S = 0; S <= 200; S += 50 ) {
+			for( short L = 0; L <= 200; L += 50 ) {
+				for( int k = 0; k < 3; k++ ) {
+					if( pfnKernels[k] == NULL ) continue;
+					int nFrom = rand() % 8;
+					int nCount = (int)image.size() - nFrom - rand() % 8;
+					CHECK(Compare(pfnKernels[k], image, H, S, L, nFrom, nCount) == 0);
+					CHECK(Compare(pfnKernels[k], image, H, S, L, nFrom, rand() % 12) == 0);
+				}
+				nSettings++;
+			}
+		}
+	}
+
+	// the public entry points: the dispatched run and the one colour of AdjustColor
+	std::vector<DWORD> out(image.size());
+	CPixelKernel::AdjustHSL(&out[0], &image[0], (int)image.size(), 97, 140, 60);
+	std::vector<DWORD> expected(image);
+	Legacy::AdjustImage(&expected[0], (int)expected.size(), 97, 140, 60);
+	CHECK(out == expected);
+	for( size_t i = 0; i < palette.size(); i++ ) {
+		DWORD dwColor = palette[i];
+		Legacy::AdjustImage(&dwColor, 1, 300, 80, 120);
+		CHECK(CPixelKernel::AdjustHSL(palette[i], 300, 80, 120) == dwColor);
+	}
+	CPixelKernel::AdjustHSL(NULL, NULL, 0, 0, 0, 0);
+
+	printf("%s kernels, %d settings on the sample image\n", CPixelKernel::GetInstructionSet(), nSettings);
+	for( int k = 0; k < 3; k++ ) printf("%s: %s\n", pstrKernels[k], pfnKernels[k] ? "compared" : "not on this CPU");
+	return TestResult("HSLTest");
+}
@@ -0,0 +1,321 @@
+// PixelTest.cpp : every kernel table of CPixelKernel against plain loops written here from
+// what UIPixel.h says each does, pixel for pixel, over random runs of every short length at
+// every alignment with the values that take the special paths mixed in; then Resample against
+// the same two passes done with those loops, and against what a resample must keep: a flat
+// image stays flat and a same-size one is copied.
+// Built twice: with the SSE2 and AVX2 tables and, with __SSE2__ undefined, with the C one.
+// The kernels are static, so the test builds UIPixel.cpp itself.
+
+#include "StdAfx.h"
+#include "TestCheck.h"
+#include "Core/UIPixel.cpp"
+#include <vector>
+
+using namespace DuiLib;
+
+static DWORD Random()
+{
+	return ((DWORD)rand() << 16) ^ (DWORD)rand();
+}
+
+// mostly random pixels, with transparent, opaque, black and mask ones among them
+static DWORD RandomPixel(DWORD dwMask)
+{
+	DWORD dw = Random();
+	switch( rand() % 8 ) {
+	case 0: return dw & 0x00FFFFFF;
+	case 1: return dw | 0xFF000000;
+	case 2: return dw & 0xFF000000;
+	case 3: return dwMask;
+	case 4: return 0;
+	default: return dw;
+	}
+}
+
+static bool RefPremultiply(DWORD* pDest, const BYTE* pRGBA, int nPixels, DWORD dwMask)
+{
+	bool bAlpha = false;
+	for( int i = 0; i < nPixels; i++ ) {
+		DWORD r = pRGBA[i * 4], g = pRGBA[i * 4 + 1], b = pRGBA[i * 4 + 2], a = pRGBA[i * 4 + 3];
+		DWORD dw = (a << 24) | ((r * a / 255) << 16) | ((g * a / 255) << 8) | (b * a / 255);
+		if( dw == dwMask ) dw = 0;
+		if( (dw >> 24) != 255 ) bAlpha = true;
+		pDest[i] = dw;
+	}
+	return bAlpha;
+}
+
+static void RefUnpremultiply(DWORD* pBits, int nPixels)
+{
+	for( int i = 0; i < nPixels; i++ ) {
+		DWORD a = pBits[i] >> 24;
+		DWORD dw = a << 24;
+		for( int c = 0; c < 3 && a != 0; c++ ) {
+			DWORD v = (((pBits[i] >> (c * 8)) & 0xFF) * 255 + a / 2) / a;
+			dw |= (v > 255 ? 255 : v) << (c * 8);
+		}
+		pBits[i] = dw;
+	}
+}
+
+static void RefFill(DWORD* pBits, int nPixels, DWORD dwColor)
+{
+	for( int i = 0; i < nPixels; i++ ) pBits[i] = dwColor;
+}
+
+static void RefRestoreAlpha(DWORD* pBits, int nPixels)
+{
+	for( int i = 0; i < nPixels; i++ ) {
+		if( (pBits[i] >> 24) == 0 && pBits[i] != 0 ) pBits[i] = pBits[i] | 0xFF000000;
+	}
+}
+
+static void RefMakeOpaque(DWORD* pBits, int nPixels)
+{
+	for( int i = 0; i < nPixels; i++ ) {
+		if( pBits[i] != 0 ) pBits[i] = pBits[i] | 0xFF000000;
+	}
+}
+
+static DWORD RefWeigh(const DWORD* pPixels, int nStep, const short* pWeights, int nTaps)
+{
+	DWORD dw = 0;
+	for( int c = 0; c < 4; c++ ) {
+		int nSum = 0;
+		for( int k = 0; k < nTaps; k++ ) nSum += pWeights[k] * (int)((pPixels[k * nStep] >> (c * 8)) & 0xFF);
+		dw |= (DWORD)((nSum + (1 << 13)) >> 14) << (c * 8);
+	}
+	return dw;
+}
+
+static void RefResampleRow(DWORD* pDest, int cxDest, const DWORD* pSrc, const int* pStart, const short* pWeights, int nTaps)
+{
+	for( int x = 0; x < cxDest; x++ ) pDest[x] = RefWeigh(pSrc + pStart[x], 1, pWeights + x * nTaps, nTaps);
+}
+
+static void RefResampleColumn(DWORD* pDest, int nPixels, const DWORD* const* ppRows, const short* pWeights, int nTaps)
+{
+	for( int i = 0; i < nPixels; i++ ) {
+		std::vector<DWORD> aColumn(nTaps);
+		for( int k = 0; k < nTaps; k++ ) aColumn[k] = ppRows[k][i];
+		pDest[i] = RefWeigh(&aColumn[0], 1, pWeights, nTaps);
+	}
+}
+
+// a run of nPixels at an offset into a buffer that has guard pixels on both sides
+class CRun
+{
+public:
+	CRun(int nPixels, int nOffset) : m_aBuffer(nPixels + nOffset + 16, 0xDEADBEEF), m_nPixels(nPixels), m_nOffset(nOffset + 8) { }
+	DWORD* Get() { return &m_aBuffer[m_nOffset]; }
+	bool operator==(const CRun& other) const { return m_aBuffer == other.m_aBuffer; }
+	bool GuardsIntact() const
+	{
+		for( int i = 0; i < m_nOffset; i++ ) if( m_aBuffer[i] != 0xDEADBEEF ) return false;
+		for( size_t i = m_nOffset + m_nPixels; i < m_aBuffer.size(); i++ ) if( m_aBuffer[i] != 0xDEADBEEF ) return false;
+		return true;
+	}
+
+private:
+	std::vector<DWORD> m_aBuffer;
+	int m_nPixels;
+	int m_nOffset;
+};
+
+// nTaps weights that are never negative and sum to exactly 1 << 14, as MakeResampleTaps gives
+static void RandomWeights(short* pWeights, int nTaps)
+{
+	int nLeft = 1 << RESAMPLE_SHIFT;
+	for( int k = 0; k < nTaps - 1; k++ ) {
+		pWeights[k] = (short)(rand() % (nLeft + 1));
+		nLeft -= pWeights[k];
+	}
+	pWeights[nTaps - 1] = (short)nLeft;
+}
+
+static void TestKernels(const TPixelKernels& kernels)
+{
+	static const int LENGTHS[] = { 0, 1, 2, 3, 4, 5, 7, 8, 9, 15, 16, 17, 31, 33, 64, 1001 };
+	int nFailures = g_nTestFailures;
+	for( size_t l = 0; l < lengthof(LENGTHS); l++ ) {
+		int nPixels = LENGTHS[l];
+		for( int nOffset = 0; nOffset < 8; nOffset++ ) {
+			DWORD dwMask = rand() % 2 ? 0xFF000000 | Random() : Random();
+			std::vector<BYTE> aRGBA(nPixels * 4 + 1);
+			for( int i = 0; i < nPixels; i++ ) {
+				DWORD dw = RandomPixel(dwMask);
+				memcpy(&aRGBA[i * 4], &dw, 4);
+			}
+			CRun expected(nPixels, nOffset), actual(nPixels, nOffset);
+			bool bExpected = RefPremultiply(expected.Get(), &aRGBA[0], nPixels, dwMask);
+			CHECK(kernels.pfnPremultiply(actual.Get(), &aRGBA[0], nPixels, dwMask) == bExpected);
+			CHECK(actual == expected);
+
+			CRun pixels(nPixels, nOffset);
+			for( int i = 0; i < nPixels; i++ ) pixels.Get()[i] = RandomPixel(dwMask);
+			expected = pixels; actual = pixels;
+			RefUnpremultiply(expected.Get(), nPixels);
+			kernels.pfnUnpremultiply(actual.Get(), nPixels);
+			CHECK(actual == expected);
+
+			expected = pixels; actual = pixels;
+			RefFill(expected.Get(), nPixels, dwMask);
+			kernels.pfnFill(actual.Get(), nPixels, dwMask);
+			CHECK(actual == expected);
+
+			expected = pixels; actual = pixels;
+			RefRestoreAlpha(expected.Get(), nPixels);
+			kernels.pfnRestoreAlpha(actual.Get(), nPixels);
+			CHECK(actual == expected);
+
+			expected = pixels; actual = pixels;
+			RefMakeOpaque(expected.Get(), nPixels);
+			kernels.pfnMakeOpaque(actual.Get(), nPixels);
+			CHECK(actual == expected);
+			CHECK(actual.GuardsIntact());
+
+			// the two resampling passes, with as many taps as a shrink to a ninth takes
+			int nTaps = 1 + rand() % 20;
+			std::vector<short> aWeights(nPixels * nTaps + nTaps);
+			std::vector<int> aStart(nPixels);
+			std::vector<DWORD> aSrc(nPixels + nTaps);
+			for( size_t i = 0; i < aSrc.size(); i++ ) aSrc[i] = RandomPixel(dwMask);
+			for( int x = 0; x < nPixels; x++ ) {
+				aStart[x] = rand() % (nPixels + 1);
+				RandomWeights(&aWeights[x * nTaps], nTaps);
+			}
+			expected = pixels; actual = pixels;
+			RefResampleRow(expected.Get(), nPixels, &aSrc[0], nPixels ? &aStart[0] : NULL, &aWeights[0], nTaps);
+			kernels.pfnResampleRow(actual.Get(), nPixels, &aSrc[0], nPixels ? &aStart[0] : NULL, &aWeights[0], nTaps);
+			CHECK(actual == expected);
+
+			std::vector<std::vector<DWORD> > aRows(nTaps, std::vector<DWORD>(nPixels + 1));
+			std::vector<const DWORD*> aRowPointers(nTaps);
+			for( int k = 0; k < nTaps; k++ ) {
+				for( int i = 0; i < nPixels; i++ ) aRows[k][i] = RandomPixel(dwMask);
+				aRowPointers[k] = &aRows[k][0];
+			}
+			RandomWeights(&aWeights[0], nTaps);
+			expected = pixels; actual = pixels;
+			RefResampleColumn(expected.Get(), nPixels, &aRowPointers[0], &aWeights[0], nTaps);
+			kernels.pfnResampleColumn(actual.Get(), nPixels, &aRowPointers[0], &aWeights[0], nTaps);
+			CHECK(actual == expected);
+			CHECK(actual.GuardsIntact());
+		}
+	}
+	printf("%s: %s\n", kernels.pstrName, g_nTestFailures == nFailures ? "pixel exact" : "differs");
+}
+
+// Resample as UIPixel.cpp lays it out, with the plain loops
+static void RefResample(DWORD* pDest, int cxDest, int cyDest, const DWORD* pSrc, int cxSrc, int cySrc)
+{
+	std::vector<int> aStart;
+	std::vector<short> aWeights;
+	int nTaps = MakeResampleTaps(cxSrc, cxDest, aStart, aWeights);
+	std::vector<DWORD> aRows(cxDest * cySrc);
+	for( int y = 0; y < cySrc; y++ ) RefResampleRow(&aRows[y * cxDest], cxDest, pSrc + y * cxSrc, &aStart[0], &aWeights[0], nTaps);
+	nTaps = MakeResampleTaps(cySrc, cyDest, aStart, aWeights);
+	for( int y = 0; y < cyDest; y++ ) {
+		for( int x = 0; x < cxDest; x++ ) {
+			pDest[y * cxDest + x] = RefWeigh(&aRows[aStart[y] * cxDest + x], cxDest, &aWeights[y * nTaps], nTaps);
+		}
+	}
+}
+
+static void TestResampleTaps()
+{
+	static const int SIZES[] = { 1, 2, 3, 5, 16, 17, 100, 333, 1000 };
+	for( size_t s = 0; s < lengthof(SIZES); s++ ) {
+		for( size_t d = 0; d < lengthof(SIZES); d++ ) {
+			std::vector<int> aStart;
+			std::vector<short> aWeights;
+			int nTaps = MakeResampleTaps(SIZES[s], SIZES[d], aStart, aWeights);
+			CHECK(nTaps >= 1 && nTaps <= SIZES[s]);
+			for( int x = 0; x < SIZES[d]; x++ ) {
+				CHECK(aStart[x] >= 0 && aStart[x] + nTaps <= SIZES[s]);
+				int nSum = 0;
+				for( int k = 0; k < nTaps; k++ ) {
+					CHECK(aWeights[x * nTaps + k] >= 0);
+					nSum += aWeights[x * nTaps + k];
+				}
+				CHECK(nSum == 1 << RESAMPLE_SHIFT);
+			}
+		}
+	}
+}
+
+static void TestResample()
+{
+	for( int n = 0; n < 300; n++ ) {
+		int cxSrc = 1 + rand() % 70, cySrc = 1 + rand() % 70;
+		int cxDest = 1 + rand() % 70, cyDest = 1 + rand() % 70;
+		if( n % 10 == 0 ) { cxDest = cxSrc; cyDest = cySrc; }
+		std::vector<DWORD> aSrc(cxSrc * cySrc);
+		for( size_t i = 0; i < aSrc.size(); i++ ) aSrc[i] = RandomPixel(0);
+		std::vector<DWORD> aExpected(cxDest * cyDest), aActual(cxDest * cyDest + 1, 0xDEADBEEF);
+		RefResample(&aExpected[0], cxDest, cyDest, &aSrc[0], cxSrc, cySrc);
+		CPixelKernel::Resample(&aActual[0], cxDest, cyDest, &aSrc[0], cxSrc, cySrc);
+		CHECK(aActual[cxDest * cyDest] == 0xDEADBEEF);
+		aActual.pop_back();
+		CHECK(aActual == aExpected);
+		if( cxDest == cxSrc && cyDest == cySrc ) CHECK(aActual == aSrc);
+
+		DWORD dwFlat = RandomPixel(0);
+		std::vector<DWORD> aFlat(cxSrc * cySrc, dwFlat);
+		CPixelKernel::Resample(&aActual[0], cxDest, cyDest, &aFlat[0], cxSrc, cySrc);
+		CHECK(aActual == std::vector<DWORD>(cxDest * cyDest, dwFlat));
+	}
+	// nothing to do for an empty bitmap on either side
+	DWORD dw = 0x12345678;
+	CPixelKernel::Resample(&dw, 0, 1, &dw, 1, 1);
+	CPixelKernel::Resample(&dw, 1, 1, &dw, 1, 0);
+	CHECK(dw == 0x12345678);
+}
+
+// the rectangle entry points go through the dispatched kernels a row at a time
+static void TestRects()
+{
+	const int cx = 37, cy = 11;
+	std::vector<DWORD> aBits(cx * cy), aExpected;
+	for( size_t i = 0; i < aBits.size(); i++ ) aBits[i] = RandomPixel(0);
+	RECT rc = { 3, 2, 30, 9 };
+	aExpected = aBits;
+	for( int y = rc.top; y < rc.bottom; y++ ) RefRestoreAlpha(&aExpected[y * cx + rc.left], rc.right - rc.left);
+	CPixelKernel::RestoreAlpha(&aBits[0], cx, rc);
+	CHECK(aBits == aExpected);
+	for( int y = rc.top; y < rc.bottom; y++ ) RefFill(&aExpected[y * cx + rc.left], rc.right - rc.left, 0x80402010);
+	CPixelKernel::FillRect(&aBits[0], cx, rc, 0x80402010);
+	CHECK(aBits == aExpected);
+	RECT rcEmpty = { 5, 2, 5, 9 };
+	CPixelKernel::FillRect(&aBits[0], cx, rcEmpty, 0);
+	CHECK(aBits == aExpected);
+}
+
+int main()
+{
+	srand(67);
+#ifdef PIXEL_KERNEL_SIMD
+	static const TPixelKernels sse2 = { _T("SSE2"), PremultiplySSE2, UnpremultiplySSE2, FillSSE2, RestoreAlphaSSE2, MakeOpaqueSSE2,
+		ResampleRowSSE2, ResampleColumnSSE2, AdjustHSLSSE2 };
+	static const TPixelKernels avx2 = { _T("AVX2"), PremultiplyAVX2, UnpremultiplyAVX2, FillAVX2, RestoreAlphaAVX2, MakeOpaqueAVX2,
+		ResampleRowSSE2, ResampleColumnAVX2, AdjustHSLAVX2 };
+	TestKernels(sse2);
+	if( HasAVX2() ) TestKernels(avx2);
+	else printf("AVX2: not on this CPU\n");
+#endif
+	// in the SIMD build these are the tails every wider kernel ends on, and the C resampling
+	// loops, which only the C table uses, are not built
+	static const TPixelKernels c = { _T("C"), PremultiplyC, UnpremultiplyC, FillC, RestoreAlphaC, MakeOpaqueC,
+#ifdef PIXEL_KERNEL_SIMD
+		RefResampleRow, RefResampleColumn, AdjustHSLC };
+#else
+		ResampleRowC, ResampleColumnC, AdjustHSLC };
+#endif
+	TestKernels(c);
+
+	TestResampleTaps();
+	TestResample();
+	TestRects();
+	printf("dispatched to %s\n", CPixelKernel::GetInstructionSet());
+	return TestResult("PixelTest");
+}
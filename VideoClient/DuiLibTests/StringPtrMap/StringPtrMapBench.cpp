@@ -0,0 +1,80 @@
+// StringPtrMapBench.cpp : ns per Find, Insert and Remove of CStdStringPtrMap from a handful of
+// keys, the custom attributes of one control, to the names of every control of a big window.
+// std::unordered_map runs the same keys as the yardstick.
+// usage: StringPtrMapBench [max keys]
+
+#include "StdAfx.h"
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <chrono>
+
+using namespace DuiLib;
+
+typedef std::chrono::steady_clock Clock;
+
+static double NsPer(Clock::time_point t0, Clock::time_point t1, size_t nOps)
+{
+	return std::chrono::duration<double, std::nano>(t1 - t0).count() / (double)nOps;
+}
+
+static void Run(int nKeys)
+{
+	std::vector<std::string> keys, misses;
+	char sz[64];
+	for( int i = 0; i < nKeys; i++ ) {
+		sprintf(sz, "control_%d_name", i * 7919);
+		keys.push_back(sz);
+		sprintf(sz, "control_%d_text", i * 7919);
+		misses.push_back(sz);
+	}
+	int nRounds = (std::max)(1, 2000000 / nKeys);
+	size_t nOps = (size_t)nRounds * nKeys;
+	volatile UINT_PTR sink = 0;
+
+	Clock::time_point t0 = Clock::now();
+	for( int r = 0; r < nRounds; r++ ) {
+		CStdStringPtrMap map;
+		for( int i = 0; i < nKeys; i++ ) map.Insert(keys[i].c_str(), (LPVOID)(UINT_PTR)(i + 1));
+		sink += map.GetSize();
+	}
+	Clock::time_point t1 = Clock::now();
+	CStdStringPtrMap map;
+	for( int i = 0; i < nKeys; i++ ) map.Insert(keys[i].c_str(), (LPVOID)(UINT_PTR)(i + 1));
+	Clock::time_point t2 = Clock::now();
+	for( int r = 0; r < nRounds; r++ ) {
+		for( int i = 0; i < nKeys; i++ ) sink += (UINT_PTR)map.Find(keys[i].c_str());
+	}
+	Clock::time_point t3 = Clock::now();
+	for( int r = 0; r < nRounds; r++ ) {
+		for( int i = 0; i < nKeys; i++ ) sink += (UINT_PTR)map.Find(misses[i].c_str());
+	}
+	Clock::time_point t4 = Clock::now();
+	for( int r = 0; r < nRounds; r++ ) {
+		for( int i = 0; i < nKeys; i++ ) map.Remove(keys[i].c_str());
+		for( int i = 0; i < nKeys; i++ ) map.Insert(keys[i].c_str(), (LPVOID)(UINT_PTR)(i + 1));
+	}
+	Clock::time_point t5 = Clock::now();
+
+	std::unordered_map<std::string, LPVOID> std_map;
+	for( int i = 0; i < nKeys; i++ ) std_map[keys[i]] = (LPVOID)(UINT_PTR)(i + 1);
+	Clock::time_point t6 = Clock::now();
+	for( int r = 0; r < nRounds; r++ ) {
+		for( int i = 0; i < nKeys; i++ ) {
+			// a std::string per lookup, as a caller holding an LPCTSTR pays for it
+			std::unordered_map<std::string, LPVOID>::const_iterator it = std_map.find(keys[i].c_str());
+			sink += (UINT_PTR)it->second;
+		}
+	}
+	Clock::time_point t7 = Clock::now();
+
+	printf("%7d keys: insert %6.1f  find %6.1f  miss %6.1f  remove+insert %6.1f  unordered_map find %6.1f ns\n",
+		nKeys, NsPer(t0, t1, nOps), NsPer(t2, t3, nOps), NsPer(t3, t4, nOps), NsPer(t4, t5, nOps * 2), NsPer(t6, t7, nOps));
+}
+
+int main(int argc, char* argv[])
+{
+	int nMaxKeys = argc > 1 ? atoi(argv[1]) : 65536;
+	for( int nKeys = 4; nKeys <= nMaxKeys; nKeys *= 4 ) Run(nKeys);
+	return 0;
+}
@@ -0,0 +1,223 @@
+// StringPtrMapTest.cpp : CStdStringPtrMap against a plain model of what it promises.
+// Find, Insert, Set and Remove behave like a std::map, and GetAt walks the items in insertion
+// order where a Remove moves the last item into the hole it leaves.
+
+#include "StdAfx.h"
+#include "TestCheck.h"
+#include <string>
+#include <vector>
+#include <map>
+
+using namespace DuiLib;
+
+struct CModel
+{
+	std::vector<std::pair<std::string, LPVOID> > items;
+	std::map<std::string, int> index;
+
+	LPVOID Find(const std::string& key) const
+	{
+		std::map<std::string, int>::const_iterator it = index.find(key);
+		return it == index.end() ? NULL : items[it->second].second;
+	}
+	bool Insert(const std::string& key, LPVOID pData)
+	{
+		if( index.count(key) ) return false;
+		index[key] = (int)items.size();
+		items.push_back(std::make_pair(key, pData));
+		return true;
+	}
+	LPVOID Set(const std::string& key, LPVOID pData)
+	{
+		std::map<std::string, int>::iterator it = index.find(key);
+		if( it == index.end() ) {
+			Insert(key, pData);
+			return NULL;
+		}
+		LPVOID pOld = items[it->second].second;
+		items[it->second].second = pData;
+		return pOld;
+	}
+	bool Remove(const std::string& key)
+	{
+		std::map<std::string, int>::iterator it = index.find(key);
+		if( it == index.end() ) return false;
+		int iItem = it->second;
+		index.erase(it);
+		if( iItem != (int)items.size() - 1 ) {
+			items[iItem] = items.back();
+			index[items[iItem].first] = iItem;
+		}
+		items.pop_back();
+		return true;
+	}
+};
+
+static bool SameAsModel(const CStdStringPtrMap& map, const CModel& model, const std::vector<std::string>& keys)
+{
+	if( map.GetSize() != (int)model.items.size() ) return false;
+	for( int i = 0; i < map.GetSize(); i++ ) {
+		if( map.GetAt(i) == NULL || model.items[i].first != map.GetAt(i) ) return false;
+		if( map.Find(map[i]) != model.items[i].second ) return false;
+	}
+	if( map.GetAt(map.GetSize()) != NULL || map.GetAt(-1) != NULL ) return false;
+	for( size_t i = 0; i < keys.size(); i++ ) {
+		if( map.Find(keys[i].c_str()) != model.Find(keys[i]) ) return false;
+	}
+	return true;
+}
+
+static LPVOID Data(int i)
+{
+	return (LPVOID)(UINT_PTR)(i + 1);
+}
+
+// "aB" and "b!" hash alike, every string of n of them shares one hash with 2^n - 1 others
+static std::vector<std::string> CollidingKeys(int nBlocks)
+{
+	std::vector<std::string> keys;
+	for( int bits = 0; bits < (1 << nBlocks); bits++ ) {
+		std::string key;
+		for( int i = 0; i < nBlocks; i++ ) key += (bits >> i) & 1 ? "b!" : "aB";
+		keys.push_back(key);
+	}
+	return keys;
+}
+
+static void TestEmpty()
+{
+	CStdStringPtrMap map;
+	CHECK(map.GetSize() == 0);
+	CHECK(map.Find(_T("")) == NULL);
+	CHECK(map.Find(_T("name")) == NULL);
+	CHECK(!map.Remove(_T("name")));
+	CHECK(map.GetAt(0) == NULL);
+	map.RemoveAll();
+	map.Resize();
+	CHECK(map.GetSize() == 0);
+}
+
+static void TestInsertFindSet()
+{
+	CStdStringPtrMap map;
+	CHECK(map.Insert(_T("name"), Data(0)));
+	CHECK(map.Insert(_T(""), Data(1)));
+	CHECK(!map.Insert(_T("name"), Data(2)));
+	CHECK(map.Find(_T("name")) == Data(0));
+	CHECK(map.Find(_T("")) == Data(1));
+	CHECK(map.Find(_T("Name")) == NULL);
+	CHECK(map.Set(_T("name"), Data(3)) == Data(0));
+	CHECK(map.Find(_T("name")) == Data(3));
+	CHECK(map.Set(_T("text"), Data(4)) == NULL);
+	CHECK(map.GetSize() == 3);
+	CHECK(strcmp(map.GetAt(0), _T("name")) == 0);
+	CHECK(strcmp(map.GetAt(1), _T("")) == 0);
+	CHECK(strcmp(map[2], _T("text")) == 0);
+}
+
+static void TestGrowth()
+{
+	// the items start at 4 and the slots at 8, both double: cross every size up to 4096
+	CStdStringPtrMap map;
+	CModel model;
+	std::vector<std::string> keys;
+	char sz[32];
+	for( int i = 0; i < 4096; i++ ) {
+		sprintf(sz, "key%d", i);
+		keys.push_back(sz);
+		CHECK(map.Insert(sz, Data(i)) == model.Insert(sz, Data(i)));
+		if( (i & (i + 1)) == 0 || i % 997 == 0 ) CHECK(SameAsModel(map, model, keys));
+	}
+	CHECK(SameAsModel(map, model, keys));
+	map.RemoveAll();
+	CHECK(map.GetSize() == 0);
+	CHECK(map.Find(_T("key1")) == NULL);
+	CHECK(map.Insert(_T("key1"), Data(7)));
+	CHECK(map.Find(_T("key1")) == Data(7));
+	map.Resize();
+	CHECK(map.GetSize() == 0);
+	CHECK(map.Insert(_T("key2"), Data(8)));
+	CHECK(map.Find(_T("key2")) == Data(8));
+}
+
+static void TestCollisions()
+{
+	// whole probe runs of one hash: every Remove has to shift the rest of the run back
+	std::vector<std::string> keys = CollidingKeys(6);
+	CStdStringPtrMap map;
+	CModel model;
+	for( size_t i = 0; i < keys.size(); i++ ) {
+		CHECK(map.Insert(keys[i].c_str(), Data((int)i)));
+		model.Insert(keys[i], Data((int)i));
+	}
+	CHECK(SameAsModel(map, model, keys));
+	for( size_t i = 0; i < keys.size(); i += 3 ) {
+		CHECK(map.Remove(keys[i].c_str()));
+		model.Remove(keys[i]);
+		CHECK(SameAsModel(map, model, keys));
+	}
+	for( size_t i = keys.size(); i-- > 0; ) {
+		CHECK(map.Remove(keys[i].c_str()) == model.Remove(keys[i]));
+	}
+	CHECK(map.GetSize() == 0);
+	CHECK(SameAsModel(map, model, keys));
+}
+
+static void TestRandom()
+{
+	// random operations on key sets small enough for the runs to wrap around the slot table
+	srand(59);
+	for( int round = 0; round < 200; round++ ) {
+		std::vector<std::string> keys;
+		int nKeys = 1 + rand() % (round < 100 ? 12 : 300);
+		char sz[32];
+		for( int i = 0; i < nKeys; i++ ) {
+			if( rand() % 4 == 0 ) {
+				std::vector<std::string> colliding = CollidingKeys(3);
+				keys.push_back(colliding[rand() % colliding.size()]);
+			}
+			else {
+				sprintf(sz, "%x", rand() % 4096);
+				keys.push_back(sz);
+			}
+		}
+
+		CStdStringPtrMap map;
+		CModel model;
+		for( int op = 0; op < 2000; op++ ) {
+			const std::string& key = keys[rand() % keys.size()];
+			LPVOID pData = Data(op);
+			switch( rand() % 7 ) {
+			case 0: case 1: case 2:
+				CHECK(map.Insert(key.c_str(), pData) == model.Insert(key, pData));
+				break;
+			case 3:
+				CHECK(map.Set(key.c_str(), pData) == model.Set(key, pData));
+				break;
+			case 4: case 5:
+				CHECK(map.Remove(key.c_str()) == model.Remove(key));
+				break;
+			default:
+				if( rand() % 50 == 0 ) {
+					map.RemoveAll();
+					model = CModel();
+				}
+				break;
+			}
+			if( !SameAsModel(map, model, keys) ) {
+				CHECK(!"map and model differ");
+				return;
+			}
+		}
+	}
+}
+
+int main()
+{
+	TestEmpty();
+	TestInsertFindSet();
+	TestGrowth();
+	TestCollisions();
+	TestRandom();
+	return TestResult("StringPtrMapTest");
+}
@@ -0,0 +1,27 @@
+#ifndef __TESTCHECK_H__
+#define __TESTCHECK_H__
+
+#pragma once
+
+#include <stdio.h>
+
+// CHECK reports a failed condition and goes on, TestResult is the exit code of the test.
+
+static int g_nTestChecks = 0;
+static int g_nTestFailures = 0;
+
+#define CHECK(expr) \
+	do { \
+		g_nTestChecks++; \
+		if( !(expr) ) { \
+			if( g_nTestFailures++ < 20 ) fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #expr); \
+		} \
+	} while( 0 )
+
+static inline int TestResult(const char* pstrName)
+{
+	printf("%s: %d checks, %d failed\n", pstrName, g_nTestChecks, g_nTestFailures);
+	return g_nTestFailures == 0 ? 0 : 1;
+}
+
+#endif // __TESTCHECK_H__
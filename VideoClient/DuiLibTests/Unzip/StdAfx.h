@@ -0,0 +1,35 @@
+#pragma once
+
+#include "Win32Shim.h"
+#include <sys/stat.h>
+
+// what unzip.cpp needs on top of the shim: handles that seek, file times and directories
+// for unzipping to a file, none of which the test uses beyond seeking
+#define DECLARE_HANDLE(name) struct name##__ { int unused; }; typedef struct name##__ *name
+#define INVALID_FILE_SIZE 0xFFFFFFFF
+#define FILE_BEGIN 0
+#define FILE_CURRENT 1
+#define FILE_END 2
+#define FILE_ATTRIBUTE_READONLY 0x01
+#define FILE_ATTRIBUTE_HIDDEN 0x02
+#define FILE_ATTRIBUTE_SYSTEM 0x04
+#define FILE_ATTRIBUTE_DIRECTORY 0x10
+#define FILE_ATTRIBUTE_ARCHIVE 0x20
+#define __int32 int
+#define Int32x32To64(a, b) ((long long)(a) * (long long)(b))
+
+typedef long long LONGLONG;
+typedef struct _FILETIME { DWORD dwLowDateTime; DWORD dwHighDateTime; } FILETIME;
+typedef struct _SYSTEMTIME { WORD wYear, wMonth, wDayOfWeek, wDay, wHour, wMinute, wSecond, wMilliseconds; } SYSTEMTIME;
+
+inline DWORD SetFilePointer(HANDLE h, LONG nOffset, LONG*, DWORD dwMethod)
+{
+	if( fseek((FILE*)h, nOffset, dwMethod == FILE_BEGIN ? SEEK_SET : dwMethod == FILE_CURRENT ? SEEK_CUR : SEEK_END) != 0 ) return 0xFFFFFFFF;
+	return (DWORD)ftell((FILE*)h);
+}
+inline DWORD GetFileAttributes(LPCSTR pstrName) { struct stat st; return stat(pstrName, &st) == 0 ? (S_ISDIR(st.st_mode) ? FILE_ATTRIBUTE_DIRECTORY : 0) : 0xFFFFFFFF; }
+inline BOOL CreateDirectory(LPCSTR pstrName, void*) { return mkdir(pstrName, 0777) == 0; }
+inline BOOL SetFileTime(HANDLE, const FILETIME*, const FILETIME*, const FILETIME*) { return TRUE; }
+inline BOOL SystemTimeToFileTime(const SYSTEMTIME*, FILETIME* pft) { pft->dwLowDateTime = pft->dwHighDateTime = 0; return TRUE; }
+inline BOOL LocalFileTimeToFileTime(const FILETIME* pLocal, FILETIME* pft) { *pft = *pLocal; return TRUE; }
+#define wsprintf sprintf
@@ -0,0 +1,381 @@
+// UnzipTest.cpp : the name index, the mapped zip, zero-copy access and prefetch of unzip.cpp.
+// The test writes its own zips: items stored or deflated (fixed Huffman blocks with matches,
+// mixed with stored blocks), names that differ only in case, an exact duplicate, a zip behind
+// a self-extractor stub, one with thousands of items and an empty one. Each is opened by name,
+// from memory and through a handle, and every item is found, unzipped and, where the zip is in
+// memory, read in place before and after a prefetch of all of them.
+
+#include "StdAfx.h"
+#include "TestCheck.h"
+#include "Utils/unzip.h"
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <unistd.h>
+
+struct CZipItem
+{
+	std::string sName;
+	std::string sData;
+	bool bDeflate;
+};
+
+// ---- the writer ----
+
+static DWORD Crc32(const std::string& sData)
+{
+	static DWORD s_table[256];
+	if( s_table[1] == 0 ) {
+		for( DWORD n = 0; n < 256; n++ ) {
+			DWORD c = n;
+			for( int k = 0; k < 8; k++ ) c = (c & 1) ? 0xEDB88320 ^ (c >> 1) : c >> 1;
+			s_table[n] = c;
+		}
+	}
+	DWORD crc = 0xFFFFFFFF;
+	for( size_t i = 0; i < sData.size(); i++ ) crc = s_table[(crc ^ (BYTE)sData[i]) & 0xFF] ^ (crc >> 8);
+	return crc ^ 0xFFFFFFFF;
+}
+
+class CBitWriter
+{
+public:
+	CBitWriter(std::string& sOut) : m_sOut(sOut), m_dwBits(0), m_nBits(0) { }
+	void Put(DWORD dwValue, int nBits)
+	{
+		m_dwBits |= dwValue << m_nBits;
+		m_nBits += nBits;
+		while( m_nBits >= 8 ) {
+			m_sOut += (char)(m_dwBits & 0xFF);
+			m_dwBits >>= 8;
+			m_nBits -= 8;
+		}
+	}
+	// Huffman codes go most significant bit first
+	void PutCode(DWORD dwCode, int nBits)
+	{
+		DWORD dwReversed = 0;
+		for( int i = 0; i < nBits; i++ ) dwReversed |= ((dwCode >> i) & 1) << (nBits - 1 - i);
+		Put(dwReversed, nBits);
+	}
+	void Align() { if( m_nBits > 0 ) Put(0, 8 - m_nBits); }
+
+private:
+	std::string& m_sOut;
+	DWORD m_dwBits;
+	int m_nBits;
+};
+
+static void PutLiteral(CBitWriter& bits, int nSymbol)
+{
+	if( nSymbol < 144 ) bits.PutCode(0x30 + nSymbol, 8);
+	else if( nSymbol < 256 ) bits.PutCode(0x190 + nSymbol - 144, 9);
+	else if( nSymbol < 280 ) bits.PutCode(nSymbol - 256, 7);
+	else bits.PutCode(0xC0 + nSymbol - 280, 8);
+}
+
+static void PutMatch(CBitWriter& bits, int nLength, int nDistance)
+{
+	static const int LENGTH_BASE[] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+	static const int LENGTH_EXTRA[] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+	static const int DISTANCE_BASE[] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+	static const int DISTANCE_EXTRA[] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+	int l = 28;
+	while( LENGTH_BASE[l] > nLength ) l--;
+	PutLiteral(bits, 257 + l);
+	bits.Put(nLength - LENGTH_BASE[l], LENGTH_EXTRA[l]);
+	int d = 29;
+	while( DISTANCE_BASE[d] > nDistance ) d--;
+	bits.PutCode(d, 5);
+	bits.Put(nDistance - DISTANCE_BASE[d], DISTANCE_EXTRA[d]);
+}
+
+// Blocks of up to 40000 bytes, each either stored or fixed Huffman with greedy matches
+// found through the last position of every 3-byte prefix, which may reach into earlier blocks.
+static std::string Deflate(const std::string& sData)
+{
+	std::string sOut;
+	CBitWriter bits(sOut);
+	std::vector<int> last(1 << 16, -1);
+	size_t nBlockStart = 0;
+	do {
+		size_t nBlockEnd = (std::min)(sData.size(), nBlockStart + 40000);
+		bool bFinal = nBlockEnd == sData.size();
+		if( rand() % 4 == 0 ) {
+			bits.Put(bFinal ? 1 : 0, 1);
+			bits.Put(0, 2);
+			bits.Align();
+			WORD wLength = (WORD)(nBlockEnd - nBlockStart);
+			bits.Put(wLength, 16);
+			bits.Put((WORD)~wLength, 16);
+			sOut.append(sData, nBlockStart, nBlockEnd - nBlockStart);
+			for( size_t i = nBlockStart; i + 2 < nBlockEnd; i++ ) last[((BYTE)sData[i] << 8 ^ (BYTE)sData[i + 1] << 4 ^ (BYTE)sData[i + 2]) & 0xFFFF] = (int)i;
+		}
+		else {
+			bits.Put(bFinal ? 1 : 0, 1);
+			bits.Put(1, 2);
+			size_t i = nBlockStart;
+			while( i < nBlockEnd ) {
+				int nLength = 0;
+				int nDistance = 0;
+				if( i + 2 < nBlockEnd ) {
+					int& nLast = last[((BYTE)sData[i] << 8 ^ (BYTE)sData[i + 1] << 4 ^ (BYTE)sData[i + 2]) & 0xFFFF];
+					if( nLast >= 0 && i - nLast <= 32768 ) {
+						while( nLength < 258 && i + nLength < nBlockEnd && sData[nLast + nLength] == sData[i + nLength] ) nLength++;
+						nDistance = (int)(i - nLast);
+					}
+					nLast = (int)i;
+				}
+				if( nLength >= 3 ) {
+					PutMatch(bits, nLength, nDistance);
+					i += nLength;
+				}
+				else {
+					PutLiteral(bits, (BYTE)sData[i]);
+					i++;
+				}
+			}
+			PutLiteral(bits, 256);
+		}
+		nBlockStart = nBlockEnd;
+	} while( nBlockStart < sData.size() );
+	bits.Align();
+	return sOut;
+}
+
+static void Put16(std::string& sOut, DWORD dw) { sOut += (char)(dw & 0xFF); sOut += (char)((dw >> 8) & 0xFF); }
+static void Put32(std::string& sOut, DWORD dw) { Put16(sOut, dw & 0xFFFF); Put16(sOut, dw >> 16); }
+
+// The offsets are from the start of the zip, a stub in front of it is found the way a
+// self-extractor's is, from where the central directory ends up.
+static std::string WriteZip(const std::vector<CZipItem>& items, size_t nStub)
+{
+	std::string sZip;
+	std::string sDirectory;
+	for( size_t i = 0; i < items.size(); i++ ) {
+		const CZipItem& item = items[i];
+		std::string sPacked = item.bDeflate ? Deflate(item.sData) : item.sData;
+		DWORD dwCrc = Crc32(item.sData);
+		DWORD dwOffset = (DWORD)sZip.size();
+		Put32(sZip, 0x04034b50);
+		Put16(sZip, 20); Put16(sZip, 0); Put16(sZip, item.bDeflate ? 8 : 0); Put16(sZip, 0); Put16(sZip, 0x21);
+		Put32(sZip, dwCrc); Put32(sZip, (DWORD)sPacked.size()); Put32(sZip, (DWORD)item.sData.size());
+		Put16(sZip, (DWORD)item.sName.size()); Put16(sZip, 0);
+		sZip += item.sName;
+		sZip += sPacked;
+
+		Put32(sDirectory, 0x02014b50);
+		Put16(sDirectory, 20); Put16(sDirectory, 20); Put16(sDirectory, 0); Put16(sDirectory, item.bDeflate ? 8 : 0); Put16(sDirectory, 0); Put16(sDirectory, 0x21);
+		Put32(sDirectory, dwCrc); Put32(sDirectory, (DWORD)sPacked.size()); Put32(sDirectory, (DWORD)item.sData.size());
+		Put16(sDirectory, (DWORD)item.sName.size()); Put16(sDirectory, 0); Put16(sDirectory, 0); Put16(sDirectory, 0); Put16(sDirectory, 0);
+		Put32(sDirectory, 0); Put32(sDirectory, dwOffset);
+		sDirectory += item.sName;
+	}
+	DWORD dwDirectory = (DWORD)sZip.size();
+	sZip += sDirectory;
+	Put32(sZip, 0x06054b50);
+	Put16(sZip, 0); Put16(sZip, 0); Put16(sZip, (DWORD)items.size()); Put16(sZip, (DWORD)items.size());
+	Put32(sZip, (DWORD)sDirectory.size()); Put32(sZip, dwDirectory); Put16(sZip, 0);
+	return std::string(nStub, 'P') + sZip;
+}
+
+static std::vector<CZipItem> MakeItems(int nItems, int nMaxSize)
+{
+	static const char* const FOLDERS[] = { "skin/", "skin/Img/", "font/", "", "a/b/c/" };
+	static const char* const EXTENSIONS[] = { ".png", ".xml", ".ttf", ".PNG", "" };
+	static const int SIZES[] = { 0, 1, 10, 1000, 20000, 300000 };
+	std::vector<CZipItem> items;
+	for( int i = 0; i < nItems; i++ ) {
+		CZipItem item;
+		item.sName = FOLDERS[rand() % lengthof(FOLDERS)];
+		int nLength = 1 + rand() % 20;
+		for( int k = 0; k < nLength; k++ ) item.sName += "abcdefGHIJ_0123"[rand() % 15];
+		item.sName += EXTENSIONS[rand() % lengthof(EXTENSIONS)];
+		int nSize = (std::min)(SIZES[rand() % lengthof(SIZES)], nMaxSize);
+		for( int k = 0; k < nSize; k++ ) item.sData += rand() % 5 ? "abcdefgh  \n"[rand() % 11] : (char)(rand() % 256);
+		item.bDeflate = i % 3 != 0;
+		items.push_back(item);
+	}
+	if( nItems > 8 ) {
+		// the first of names equal but for case wins a lookup that ignores case
+		CZipItem item = items[5];
+		std::transform(item.sName.begin(), item.sName.end(), item.sName.begin(), ::toupper);
+		item.sData = "upper";
+		items.push_back(item);
+		std::transform(item.sName.begin(), item.sName.end(), item.sName.begin(), ::tolower);
+		item.sData = "lower";
+		items.push_back(item);
+		item = items[7];
+		item.sData = "duplicate";
+		items.push_back(item);
+	}
+	return items;
+}
+
+// ---- the reader ----
+
+static int FirstMatch(const std::vector<CZipItem>& items, const std::string& sName, bool bIgnoreCase)
+{
+	for( size_t i = 0; i < items.size(); i++ ) {
+		if( bIgnoreCase ? strcasecmp(items[i].sName.c_str(), sName.c_str()) == 0 : items[i].sName == sName ) return (int)i;
+	}
+	return -1;
+}
+
+static bool SameData(const void* pData, unsigned int nLength, const std::string& sData)
+{
+	return nLength == sData.size() && (sData.empty() || memcmp(pData, sData.data(), nLength) == 0);
+}
+
+static bool UnzipMatches(HZIP hz, int i, const std::string& sData)
+{
+	std::vector<char> buffer(sData.size() + 1);
+	ZRESULT zr = UnzipItem(hz, i, &buffer[0], (unsigned int)sData.size());
+	if( sData.empty() ) return true;
+	return (zr == ZR_OK || zr == ZR_MORE) && memcmp(&buffer[0], sData.data(), sData.size()) == 0;
+}
+
+enum { OPEN_BY_NAME, OPEN_FROM_MEMORY, OPEN_BY_HANDLE };
+
+static void TestZip(const char* pstrFile, std::string& sZip, const std::vector<CZipItem>& items, int nOpen)
+{
+	FILE* pFile = NULL;
+	HZIP hz = NULL;
+	if( nOpen == OPEN_BY_NAME ) hz = OpenZip(pstrFile, 0);
+	else if( nOpen == OPEN_FROM_MEMORY ) hz = OpenZip(&sZip[0], (unsigned int)sZip.size(), 0);
+	else {
+		pFile = fopen(pstrFile, "rb");
+		hz = OpenZipHandle((HANDLE)pFile, 0);
+	}
+	CHECK(hz != NULL);
+	if( hz == NULL ) return;
+	bool bInMemory = nOpen != OPEN_BY_HANDLE;
+
+	ZIPENTRY ze;
+	CHECK(GetZipItem(hz, -1, &ze) == ZR_OK && ze.index == (int)items.size());
+	std::vector<int> order(items.size());
+	for( size_t i = 0; i < order.size(); i++ ) order[i] = (int)i;
+	std::random_shuffle(order.begin(), order.end());
+
+	for( size_t k = 0; k < order.size(); k++ ) {
+		int i = order[k];
+		const CZipItem& item = items[i];
+		int nIgnoreCase = FirstMatch(items, item.sName, true);
+		int nIndex = -2;
+		CHECK(FindZipItem(hz, item.sName.c_str(), true, &nIndex, &ze) == ZR_OK && nIndex == nIgnoreCase);
+		CHECK(ze.index == nIgnoreCase && ze.unc_size == (long)items[nIgnoreCase].sData.size());
+		CHECK(FindZipItem(hz, item.sName.c_str(), false, &nIndex, &ze) == ZR_OK && nIndex == FirstMatch(items, item.sName, false));
+		CHECK(FindZipItem(hz, (item.sName + "~").c_str(), true, &nIndex, &ze) == ZR_NOTFOUND && nIndex == -1);
+		CHECK(UnzipMatches(hz, i, item.sData));
+
+		const void* pData = NULL;
+		unsigned int nLength = 0;
+		ZRESULT zr = GetZipItemData(hz, i, &pData, &nLength);
+		if( bInMemory && !item.bDeflate ) CHECK(zr == ZR_OK && SameData(pData, nLength, item.sData));
+		else CHECK(zr == ZR_NOTMMAP && pData == NULL);
+	}
+
+	std::vector<const char*> names;
+	for( size_t i = 0; i < items.size(); i++ ) names.push_back(items[i].sName.c_str());
+	const char* const* ppNames = names.empty() ? NULL : &names[0];
+	CHECK(PrefetchZipItems(hz, ppNames, (int)names.size()) == (bInMemory ? ZR_OK : ZR_NOTMMAP));
+	if( bInMemory ) {
+		// taken in another order than the workers go: a stored item is in place, a deflated one is
+		// inflated, or waited for, or taken back when no worker has got to it yet, and then the
+		// caller unzips it; half of them are dropped again straight away
+		std::random_shuffle(order.begin(), order.end());
+		for( size_t k = 0; k < order.size(); k++ ) {
+			int i = order[k];
+			const void* pData = NULL;
+			unsigned int nLength = 0;
+			ZRESULT zr = GetZipItemData(hz, i, &pData, &nLength);
+			if( items[i].bDeflate ) CHECK(zr == ZR_OK || zr == ZR_NOTMMAP);
+			else CHECK(zr == ZR_OK);
+			if( zr == ZR_OK ) CHECK(SameData(pData, nLength, items[i].sData));
+			CHECK(UnzipMatches(hz, i, items[i].sData));
+			if( i % 2 ) ReleaseZipItemData(hz, i);
+		}
+		// a deflated item prefetched on its own is handed out inflated once a worker is done with it
+		int nDeflated = -1;
+		for( size_t i = 0; i < items.size() && nDeflated < 0; i++ ) {
+			if( items[i].bDeflate && FirstMatch(items, items[i].sName, true) == (int)i ) nDeflated = (int)i;
+		}
+		if( nDeflated >= 0 ) {
+			ZRESULT zr = ZR_NOTMMAP;
+			const void* pData = NULL;
+			unsigned int nLength = 0;
+			for( int nTry = 0; nTry < 100 && zr != ZR_OK; nTry++ ) {
+				PrefetchZipItems(hz, &ppNames[nDeflated], 1);
+				usleep(10000);
+				zr = GetZipItemData(hz, nDeflated, &pData, &nLength);
+			}
+			CHECK(zr == ZR_OK && SameData(pData, nLength, items[nDeflated].sData));
+		}
+		// again, so that the workers are busy when the zip is closed
+		PrefetchZipItems(hz, ppNames, (int)names.size());
+	}
+	CloseZip(hz);
+	if( pFile != NULL ) fclose(pFile);
+}
+
+// The first item's local header put past the end of the zip fails to unzip, the fourth one's
+// compressed size put past it is read no further than the end; the others still unzip.
+static void TestCorrupt(const std::vector<CZipItem>& items)
+{
+	std::string sZip = WriteZip(items, 0);
+	size_t nFirst = sZip.find("PK\x01\x02");
+	std::string sHuge("\xF0\xFF\xFF\x7F", 4);
+	sZip.replace(nFirst + 42, 4, sHuge);
+	size_t nFourth = nFirst;
+	for( int i = 0; i < 3; i++ ) nFourth = sZip.find("PK\x01\x02", nFourth + 4);
+	sZip.replace(nFourth + 20, 4, sHuge);
+	HZIP hz = OpenZip(&sZip[0], (unsigned int)sZip.size(), 0);
+	CHECK(hz != NULL);
+	if( hz == NULL ) return;
+	std::vector<char> buffer(1001);
+	CHECK(UnzipItem(hz, 0, &buffer[0], 1000) != ZR_OK);
+	const void* pData = NULL;
+	unsigned int nLength = 0;
+	CHECK(GetZipItemData(hz, 0, &pData, &nLength) != ZR_OK);
+	UnzipItem(hz, 3, &buffer[0], 1000);
+	GetZipItemData(hz, 3, &pData, &nLength);
+	for( size_t i = 1; i < items.size(); i++ ) {
+		if( i != 3 ) CHECK(UnzipMatches(hz, (int)i, items[i].sData));
+	}
+	CloseZip(hz);
+}
+
+int main()
+{
+	srand(64);
+	struct { const char* pstrFile; int nItems; int nMaxSize; size_t nStub; } zips[] = {
+		{ "UnzipTest.zip", 150, 300000, 0 },
+		{ "UnzipTestStub.zip", 60, 300000, 1000 },
+		{ "UnzipTestMany.zip", 5000, 10, 0 },
+		{ "UnzipTestEmpty.zip", 0, 0, 0 },
+	};
+	for( size_t z = 0; z < lengthof(zips); z++ ) {
+		std::vector<CZipItem> items = MakeItems(zips[z].nItems, zips[z].nMaxSize);
+		std::string sZip = WriteZip(items, zips[z].nStub);
+		FILE* pFile = fopen(zips[z].pstrFile, "wb");
+		fwrite(sZip.data(), 1, sZip.size(), pFile);
+		fclose(pFile);
+		for( int nOpen = OPEN_BY_NAME; nOpen <= OPEN_BY_HANDLE; nOpen++ ) TestZip(zips[z].pstrFile, sZip, items, nOpen);
+		// a prefetch that the close cuts short
+		for( int k = 0; k < 20 && !items.empty(); k++ ) {
+			HZIP hz = OpenZip(zips[z].pstrFile, 0);
+			std::vector<const char*> names;
+			for( size_t i = 0; i < items.size(); i++ ) names.push_back(items[i].sName.c_str());
+			PrefetchZipItems(hz, &names[0], (int)names.size());
+			if( k % 2 ) {
+				const void* pData = NULL;
+				unsigned int nLength = 0;
+				GetZipItemData(hz, (int)items.size() / 2, &pData, &nLength);
+			}
+			CloseZip(hz);
+		}
+		::DeleteFile(zips[z].pstrFile);
+	}
+	TestCorrupt(MakeItems(20, 1000));
+	return TestResult("UnzipTest");
+}
@@ -0,0 +1,4 @@
+#pragma once
+
+// unzip.cpp includes the SDK header; the _tcs mappings are in Win32Shim.h
+#include "StdAfx.h"
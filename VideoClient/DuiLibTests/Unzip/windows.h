@@ -0,0 +1,4 @@
+#pragma once
+
+// unzip.cpp includes the SDK header; everything it takes from it is in StdAfx.h
+#include "StdAfx.h"
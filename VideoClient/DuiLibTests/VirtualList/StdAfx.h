@@ -0,0 +1,124 @@
+#pragma once
+
+#include "Win32Shim.h"
+#include "Utils/Utils.h"
+
+// Stand-ins for the controls and the paint manager, with what the virtual mode of the list
+// reads and calls, and the real Control/UIList.h on top of them. VirtualListTest.cpp carries
+// the parts of CListUI and CListBodyUI that live in UIList.cpp as far as the test needs them.
+
+#define MAX(a, b) (((a) > (b)) ? (a) : (b))
+#define MIN(a, b) (((a) < (b)) ? (a) : (b))
+#define CLAMP(x,a,b) (MIN(b,MAX(a,x)))
+#define DECLARE_DUICONTROL(class_name)
+#define IMPLEMENT_DUICONTROL(class_name)
+
+namespace DuiLib {
+
+	typedef struct tagTEventUI
+	{
+		int Type;
+		POINT ptMouse;
+	} TEventUI;
+
+	class CDPI
+	{
+	public:
+		int Scale(int iValue) { return iValue; }
+	};
+
+	class CPaintManagerUI
+	{
+	public:
+		CDPI* GetDPIObj() { return &m_dpi; }
+
+		CDPI m_dpi;
+	};
+
+	class CControlUI
+	{
+	public:
+		CControlUI() : m_pManager(NULL), m_pParent(NULL), m_bVisible(true), m_bUpdateNeeded(false)
+		{
+			::ZeroMemory(&m_rcItem, sizeof(m_rcItem));
+			::ZeroMemory(&m_rcPadding, sizeof(m_rcPadding));
+		}
+		virtual ~CControlUI() { }
+
+		virtual LPVOID GetInterface(LPCTSTR) { return NULL; }
+		virtual void SetPos(RECT rc, bool = true) { m_rcItem = rc; }
+		virtual void SetVisible(bool bVisible = true) { m_bVisible = bVisible; }
+		bool IsVisible() const { return m_bVisible; }
+		const RECT& GetPos() const { return m_rcItem; }
+		RECT GetPadding() const { return m_rcPadding; }
+		int GetFixedWidth() const { return 0; }
+		int GetFixedHeight() const { return 0; }
+		void NeedUpdate() { m_bUpdateNeeded = true; }
+
+		CPaintManagerUI* m_pManager;
+		CControlUI* m_pParent;
+		RECT m_rcItem;
+		RECT m_rcPadding;
+		bool m_bVisible;
+		bool m_bUpdateNeeded;
+	};
+
+	class CScrollBarUI : public CControlUI
+	{
+	public:
+		CScrollBarUI() : m_nRange(0), m_nPos(0) { }
+		int GetScrollRange() const { return m_nRange; }
+		int GetScrollPos() const { return m_nPos; }
+
+		int m_nRange;
+		int m_nPos;
+	};
+
+	class CContainerUI : public CControlUI
+	{
+	public:
+		CContainerUI() : m_iChildPadding(0), m_cyRequired(0), m_pVerticalScrollBar(NULL), m_pHorizontalScrollBar(NULL)
+		{
+			::ZeroMemory(&m_rcInset, sizeof(m_rcInset));
+		}
+		virtual ~CContainerUI() { RemoveAll(); }
+
+		bool Add(CControlUI* pControl)
+		{
+			pControl->m_pParent = this;
+			pControl->m_pManager = m_pManager;
+			return m_items.Add(pControl);
+		}
+		void RemoveAll()
+		{
+			for( int it = 0; it < m_items.GetSize(); it++ ) delete static_cast<CControlUI*>(m_items[it]);
+			m_items.Empty();
+		}
+		int GetCount() const { return m_items.GetSize(); }
+		CControlUI* GetItemAt(int iIndex) const { return static_cast<CControlUI*>(m_items[iIndex]); }
+		int FindSelectable(int iIndex, bool) const { return iIndex; }
+
+	protected:
+		void SetItemPos(CControlUI* pControl, RECT rc, bool bNeedInvalidate = false) { pControl->SetPos(rc, bNeedInvalidate); }
+		void ProcessScrollBar(RECT, int, int cyRequired) { m_cyRequired = cyRequired; }
+
+	public:
+		CStdPtrArray m_items;
+		RECT m_rcInset;
+		int m_iChildPadding;
+		int m_cyRequired;
+		CScrollBarUI* m_pVerticalScrollBar;
+		CScrollBarUI* m_pHorizontalScrollBar;
+	};
+
+	class CVerticalLayoutUI : public CContainerUI
+	{
+	};
+
+	class CHorizontalLayoutUI : public CContainerUI
+	{
+	};
+
+} // namespace DuiLib
+
+#include "Control/UIList.h"
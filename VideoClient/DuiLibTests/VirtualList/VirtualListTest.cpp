@@ -0,0 +1,330 @@
+// VirtualListTest.cpp : CListBodyUI::SetVirtualPos and the virtual mode of CListUI with a stub
+// data source. A list of rows scrolls in small steps, by pages and to random places, while
+// rows are selected and unselected; after every layout the pool control of every row in view
+// is the one of row % pool, rows that stayed in view were not bound again, rows that came into
+// view were bound once, rows that left are unbound and hidden, every row is where it belongs
+// and shows whether it is selected. ReloadItems then shrinks the list under the view.
+
+#include "StdAfx.h"
+#include "TestCheck.h"
+#include <set>
+#include <vector>
+
+using namespace DuiLib;
+
+namespace DuiLib {
+
+	// as in UIList.cpp, without the header and the list info
+	CListUI::CListUI() : m_pCallback(NULL), m_pDataSource(NULL), m_bSyncingItems(false), m_bScrollSelect(false), m_iCurSel(-1), m_iExpandedItem(-1), m_bMultiSel(false)
+	{
+		m_bFixedScrollbar = false;
+		m_pList = new CListBodyUI(this);
+		m_pHeader = NULL;
+		CVerticalLayoutUI::Add(m_pList);
+	}
+
+	int CListUI::GetCount() const
+	{
+		if( m_pDataSource != NULL ) return m_pDataSource->GetItemCount(const_cast<CListUI*>(this));
+		return m_pList->GetCount();
+	}
+
+	bool CListUI::IsFixedScrollbar() { return m_bFixedScrollbar; }
+	CListHeaderUI* CListUI::GetHeader() const { return m_pHeader; }
+	CContainerUI* CListUI::GetList() const { return m_pList; }
+	LPVOID CListUI::GetInterface(LPCTSTR) { return NULL; }
+	void CListUI::SetPos(RECT rc, bool bNeedInvalidate) { CControlUI::SetPos(rc, bNeedInvalidate); }
+	void CListUI::DoEvent(TEventUI&) { }
+	UINT CListUI::GetListType() { return 0; }
+	TListInfoUI* CListUI::GetListInfo() { return &m_ListInfo; }
+	int CListUI::GetCurSel() const { return m_iCurSel; }
+	bool CListUI::SelectItem(int, bool) { return false; }
+	bool CListUI::SelectMultiItem(int, bool) { return false; }
+	bool CListUI::UnSelectItem(int, bool) { return false; }
+	IListCallbackUI* CListUI::GetTextCallback() const { return m_pCallback; }
+	void CListUI::SetTextCallback(IListCallbackUI* pCallback) { m_pCallback = pCallback; }
+	bool CListUI::ExpandItem(int, bool) { return false; }
+	int CListUI::GetExpandedItem() const { return m_iExpandedItem; }
+	void CListUI::SetMultiSelect(bool bMultiSel) { m_bMultiSel = bMultiSel; }
+	bool CListUI::IsMultiSelect() const { return m_bMultiSel; }
+	void CListUI::SelectAllItems() { }
+	void CListUI::UnSelectAllItems() { }
+	int CListUI::GetSelectItemCount() const { return m_aSelItems.GetSize(); }
+	int CListUI::GetNextSelItem(int) const { return -1; }
+	CScrollBarUI* CListUI::GetVerticalScrollBar() const { return m_pList->m_pVerticalScrollBar; }
+	CScrollBarUI* CListUI::GetHorizontalScrollBar() const { return m_pList->m_pHorizontalScrollBar; }
+
+	CListBodyUI::CListBodyUI(CListUI* pOwner) : m_pOwner(pOwner)
+	{
+	}
+
+	// as in UIList.cpp, for a list with a data source
+	void CListBodyUI::SetPos(RECT rc, bool bNeedInvalidate)
+	{
+		SetVirtualPos(rc, bNeedInvalidate);
+	}
+
+	SIZE CListHeaderUI::EstimateSize(SIZE szAvailable) { return szAvailable; }
+
+} // namespace DuiLib
+
+// A pool control, counting how often it was bound
+class CTestRow : public CControlUI, public IListItemUI
+{
+public:
+	CTestRow() : m_iIndex(-1), m_bSelected(false), m_iBound(-1), m_nBinds(0), m_pOwner(NULL) { }
+
+	LPVOID GetInterface(LPCTSTR pstrName)
+	{
+		if( strcmp(pstrName, "ListItem") == 0 ) return static_cast<IListItemUI*>(this);
+		return NULL;
+	}
+	int GetIndex() const { return m_iIndex; }
+	void SetIndex(int iIndex) { m_iIndex = iIndex; }
+	IListOwnerUI* GetOwner() { return m_pOwner; }
+	void SetOwner(CControlUI* pOwner) { m_pOwner = static_cast<CListUI*>(pOwner); }
+	bool IsSelected() const { return m_bSelected; }
+	bool Select(bool bSelect) { m_bSelected = bSelect; return true; }
+	bool SelectMulti(bool bSelect) { m_bSelected = bSelect; return true; }
+	bool IsExpanded() const { return false; }
+	bool Expand(bool) { return false; }
+	void DrawItemText(HDC, const RECT&) { }
+
+	int m_iIndex;
+	bool m_bSelected;
+	int m_iBound;	// the row the data source last bound
+	int m_nBinds;
+	CListUI* m_pOwner;
+};
+
+class CDataSource : public IListDataSourceUI
+{
+public:
+	CDataSource(int nCount) : m_nCount(nCount), m_nCreated(0) { }
+
+	int GetItemCount(CControlUI*) { return m_nCount; }
+	int GetItemHeight(CControlUI*) { return ITEM_HEIGHT; }
+	CControlUI* CreateItem(CControlUI*)
+	{
+		m_nCreated++;
+		return new CTestRow;
+	}
+	void BindItem(CControlUI* pList, CControlUI* pItem, int iIndex)
+	{
+		CTestRow* pRow = static_cast<CTestRow*>(pItem);
+		CHECK(iIndex >= 0 && iIndex < m_nCount);
+		// the list sets the index and the selection before it asks for the data
+		CHECK(pRow->m_iIndex == iIndex && pRow->IsVisible());
+		CHECK(pRow->m_bSelected == static_cast<CListUI*>(pList)->IsItemSelected(iIndex));
+		pRow->m_iBound = iIndex;
+		pRow->m_nBinds++;
+	}
+
+	enum { ITEM_HEIGHT = 20 };
+	int m_nCount;
+	int m_nCreated;
+};
+
+// The protected parts the test looks at
+class CTestList : public CListUI
+{
+public:
+	CListBodyUI* GetBody() const { return m_pList; }
+	CStdIndexSet& GetSelection() { return m_aSelItems; }
+	void SetCurSel(int iCurSel) { m_iCurSel = iCurSel; }
+	void Sync() { SyncItemSelection(); }
+};
+
+enum { VIEW_HEIGHT = 210, CHILD_PADDING = 2 };
+
+// Lays the body out at iScrollPos and checks every pool control against the rows in view;
+// bRebindAll when every row in view must be bound again (after ReloadItems).
+static void LayoutAndCheck(CTestList& list, CScrollBarUI& scroll, const std::set<int>& sSelected, int iScrollPos, bool bRebindAll = false)
+{
+	CListBodyUI* pBody = list.GetBody();
+	int nPool = pBody->GetCount();
+	std::vector<int> aIndex(nPool), aBinds(nPool);
+	for( int it = 0; it < nPool; it++ ) {
+		CTestRow* pRow = static_cast<CTestRow*>(pBody->GetItemAt(it));
+		aIndex[it] = pRow->IsVisible() ? pRow->m_iIndex : -1;
+		aBinds[it] = pRow->m_nBinds;
+	}
+
+	scroll.m_nPos = iScrollPos;
+	RECT rc = { 0, 0, 300, VIEW_HEIGHT };
+	pBody->SetPos(rc);
+
+	int nCount = list.GetCount();
+	int cyStep = CDataSource::ITEM_HEIGHT + CHILD_PADDING;
+	int iFirst = MIN(iScrollPos / cyStep, nCount);
+	int nRows = MIN(VIEW_HEIGHT / cyStep + 2, nCount - iFirst);
+	CHECK(pBody->GetCount() >= nRows);
+	nPool = pBody->GetCount();
+	aIndex.resize(nPool, -1);
+	aBinds.resize(nPool, 0);
+	std::vector<int> aSlotOfRow(nRows, -1);
+	for( int it = 0; it < nPool; it++ ) {
+		CTestRow* pRow = static_cast<CTestRow*>(pBody->GetItemAt(it));
+		int iIndex = pRow->m_iIndex;
+		if( !pRow->IsVisible() ) {
+			// a row that left the view is unbound
+			CHECK(iIndex == -1 && !pRow->m_bSelected);
+			CHECK(pRow->m_nBinds == aBinds[it]);
+			continue;
+		}
+		CHECK(iIndex >= iFirst && iIndex < iFirst + nRows);
+		if( iIndex < iFirst || iIndex >= iFirst + nRows ) continue;
+		CHECK(aSlotOfRow[iIndex - iFirst] == -1);
+		aSlotOfRow[iIndex - iFirst] = it;
+		// pool control it holds row iFirst + (it - iFirst % nPool + nPool) % nPool, i.e. row
+		// iIndex always has pool control iIndex % nPool
+		CHECK(iIndex == iFirst + (it - iFirst % nPool + nPool) % nPool);
+		CHECK(it == iIndex % nPool);
+		CHECK(pRow->m_iBound == iIndex);
+		// a row that stayed in view keeps its binding, one that came into view is bound once
+		if( aIndex[it] == iIndex && !bRebindAll ) CHECK(pRow->m_nBinds == aBinds[it]);
+		else CHECK(pRow->m_nBinds == aBinds[it] + 1);
+		CHECK(pRow->m_bSelected == (sSelected.count(iIndex) != 0));
+		CHECK(pRow->m_pOwner == &list);
+
+		RECT rcRow = pRow->GetPos();
+		CHECK(rcRow.top == iIndex * cyStep - iScrollPos && rcRow.bottom == rcRow.top + CDataSource::ITEM_HEIGHT);
+		CHECK(rcRow.left == 0 && rcRow.right == 300);
+		CHECK(pBody->GetVirtualItem(iIndex) == pRow);
+		RECT rcVirtual = pBody->GetVirtualItemPos(iIndex);
+		CHECK(rcVirtual.top == rcRow.top && rcVirtual.bottom == rcRow.bottom);
+	}
+	for( int i = 0; i < nRows; i++ ) CHECK(aSlotOfRow[i] != -1);
+	CHECK(pBody->m_cyRequired == (nCount > 0 ? nCount * cyStep - CHILD_PADDING : 0));
+	if( iFirst > 0 ) CHECK(pBody->GetVirtualItem(iFirst - 1) == NULL);
+	CHECK(pBody->GetVirtualItem(iFirst + nRows) == NULL);
+}
+
+static void TestScroll()
+{
+	CDataSource source(1000);
+	CTestList list;
+	CScrollBarUI scroll;
+	scroll.SetVisible(true);
+	list.GetBody()->m_pVerticalScrollBar = &scroll;
+	list.GetBody()->m_iChildPadding = CHILD_PADDING;
+	list.SetDataSource(&source);
+	CHECK(list.GetDataSource() == &source);
+	CHECK(list.GetCount() == 1000);
+
+	std::set<int> sSelected;
+	int cyStep = CDataSource::ITEM_HEIGHT + CHILD_PADDING;
+	int iMaxScroll = 1000 * cyStep - CHILD_PADDING - VIEW_HEIGHT;
+	int iScrollPos = 0;
+	LayoutAndCheck(list, scroll, sSelected, iScrollPos);
+	int nPool = list.GetBody()->GetCount();
+	CHECK(nPool == VIEW_HEIGHT / cyStep + 2);
+
+	srand(70);
+	for( int k = 0; k < 3000; k++ ) {
+		switch( rand() % 4 ) {
+		case 0: iScrollPos += rand() % cyStep; break;				// less than a row
+		case 1: iScrollPos -= rand() % (3 * cyStep); break;			// a few rows back
+		case 2: iScrollPos += (rand() % 2 ? 1 : -1) * VIEW_HEIGHT; break;	// a page
+		default: iScrollPos = rand() % (iMaxScroll + 1); break;		// anywhere
+		}
+		iScrollPos = CLAMP(iScrollPos, 0, iMaxScroll);
+
+		// the selection changes by row, bound or not; SyncItemSelection shows it in the view
+		if( rand() % 3 == 0 ) {
+			int iRow = rand() % 1000;
+			if( sSelected.count(iRow) ) {
+				sSelected.erase(iRow);
+				list.GetSelection().Remove(iRow);
+			}
+			else {
+				sSelected.insert(iRow);
+				list.GetSelection().Add(iRow);
+			}
+			// a row in view near the top, so the sync has something to show
+			int iVisible = iScrollPos / cyStep + rand() % 3;
+			if( iVisible < 1000 && !sSelected.count(iVisible) ) {
+				sSelected.insert(iVisible);
+				list.GetSelection().Add(iVisible);
+			}
+			list.Sync();
+			CListBodyUI* pBody = list.GetBody();
+			for( int it = 0; it < pBody->GetCount(); it++ ) {
+				CTestRow* pRow = static_cast<CTestRow*>(pBody->GetItemAt(it));
+				if( pRow->m_iIndex >= 0 ) CHECK(pRow->m_bSelected == (sSelected.count(pRow->m_iIndex) != 0));
+				else CHECK(!pRow->m_bSelected);
+			}
+		}
+		LayoutAndCheck(list, scroll, sSelected, iScrollPos);
+		CHECK(list.GetBody()->GetCount() == nPool);
+	}
+	// the pool never grew past the rows in view
+	CHECK(source.m_nCreated == nPool);
+}
+
+static void TestReload()
+{
+	CDataSource source(500);
+	CTestList list;
+	CScrollBarUI scroll;
+	scroll.SetVisible(true);
+	list.GetBody()->m_pVerticalScrollBar = &scroll;
+	list.GetBody()->m_iChildPadding = CHILD_PADDING;
+	list.SetDataSource(&source);
+	int cyStep = CDataSource::ITEM_HEIGHT + CHILD_PADDING;
+
+	std::set<int> sSelected;
+	int aSelect[] = { 3, 40, 41, 120, 499 };
+	for( size_t i = 0; i < lengthof(aSelect); i++ ) {
+		sSelected.insert(aSelect[i]);
+		list.GetSelection().Add(aSelect[i]);
+	}
+	list.SetCurSel(120);
+	LayoutAndCheck(list, scroll, sSelected, 35 * cyStep + 5);
+
+	// the data changed in place: every row in view is bound again
+	list.ReloadItems();
+	LayoutAndCheck(list, scroll, sSelected, 35 * cyStep + 5, true);
+	CHECK(list.GetCurSel() == 120);
+
+	// shrunk to fewer rows than the view shows: rows past the end lose their selection and the
+	// pool controls past the last row are unbound
+	source.m_nCount = 42;
+	list.ReloadItems();
+	sSelected.erase(120);
+	sSelected.erase(499);
+	CHECK(list.GetCurSel() == -1);
+	CHECK(list.GetSelectItemCount() == 3);
+	CHECK(list.IsItemSelected(41) && !list.IsItemSelected(120) && !list.IsItemSelected(499));
+	LayoutAndCheck(list, scroll, sSelected, 42 * cyStep - CHILD_PADDING - VIEW_HEIGHT, true);
+	int nBound = 0;
+	for( int it = 0; it < list.GetBody()->GetCount(); it++ ) {
+		if( static_cast<CTestRow*>(list.GetBody()->GetItemAt(it))->m_iIndex >= 0 ) nBound++;
+	}
+	CHECK(nBound == MIN(42 - (42 * cyStep - CHILD_PADDING - VIEW_HEIGHT) / cyStep, VIEW_HEIGHT / cyStep + 2));
+
+	// and to fewer rows than the pool, scrolled back to the top
+	source.m_nCount = 3;
+	list.ReloadItems();
+	sSelected.clear();
+	list.GetSelection().Add(1);
+	sSelected.insert(1);
+	list.Sync();
+	LayoutAndCheck(list, scroll, sSelected, 0, true);
+	CHECK(list.GetSelectItemCount() == 1 && list.IsItemSelected(1) && !list.IsItemSelected(3));
+	CHECK(list.FindSelectable(7) == 2 && list.FindSelectable(-1) == 0);
+
+	// and empty
+	source.m_nCount = 0;
+	list.ReloadItems();
+	sSelected.clear();
+	LayoutAndCheck(list, scroll, sSelected, 0, true);
+	CHECK(list.GetSelectItemCount() == 0 && list.FindSelectable(0) == -1);
+}
+
+int main()
+{
+	TestScroll();
+	TestReload();
+	return TestResult("VirtualListTest");
+}
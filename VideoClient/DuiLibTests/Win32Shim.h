@@ -0,0 +1,217 @@
+#ifndef __WIN32SHIM_H__
+#define __WIN32SHIM_H__
+
+#pragma once
+
+// The few Win32 types, calls and tchar mappings the DuiLib sources under test use, so that they
+// build as an ANSI (TCHAR is char) library with gcc or clang. Only what the tests compile is here;
+// anything that draws or talks to a window stays out of the tests.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <wchar.h>
+#include <assert.h>
+#include <alloca.h>
+#include <algorithm>
+
+#define WINAPI
+#define CALLBACK
+#define PASCAL
+#define __cdecl
+#define __stdcall
+#define UILIB_API
+
+#ifndef NULL
+#define NULL 0
+#endif
+#ifndef FALSE
+#define FALSE 0
+#define TRUE 1
+#endif
+#define MAX_PATH 260
+#define CP_ACP 0
+#define CP_UTF8 65001
+#define UNALIGNED
+
+#define ASSERT(expr) assert(expr)
+
+typedef int BOOL;
+typedef unsigned char BYTE;
+typedef uint16_t WORD;
+typedef uint32_t DWORD;
+typedef int32_t LONG;
+typedef uint32_t ULONG;
+typedef unsigned int UINT;
+typedef intptr_t INT_PTR;
+typedef uintptr_t UINT_PTR;
+typedef intptr_t LONG_PTR;
+typedef uintptr_t ULONG_PTR;
+typedef uintptr_t DWORD_PTR;
+typedef size_t SIZE_T;
+typedef intptr_t LPARAM;
+typedef uintptr_t WPARAM;
+typedef intptr_t LRESULT;
+typedef void* LPVOID;
+typedef const void* LPCVOID;
+typedef BYTE* LPBYTE;
+typedef DWORD* LPDWORD;
+typedef char CHAR;
+typedef wchar_t WCHAR;
+typedef char* LPSTR;
+typedef const char* LPCSTR;
+typedef wchar_t* LPWSTR;
+typedef const wchar_t* LPCWSTR;
+typedef wchar_t* LPOLESTR;
+typedef wchar_t* BSTR;
+typedef void* HANDLE;
+typedef void* HINSTANCE;
+typedef void* HWND;
+typedef void* HDC;
+typedef void* HCURSOR;
+typedef void* HBITMAP;
+
+typedef char TCHAR;
+typedef char* LPTSTR;
+typedef const char* LPCTSTR;
+#define _T(x) x
+#define MAKEINTRESOURCE(i) ((LPTSTR)(ULONG_PTR)(WORD)(i))
+
+typedef struct tagPOINT { LONG x; LONG y; } POINT, *LPPOINT;
+typedef struct tagSIZE { LONG cx; LONG cy; } SIZE, *LPSIZE;
+typedef struct tagRECT { LONG left; LONG top; LONG right; LONG bottom; } RECT, *LPRECT;
+typedef const RECT* LPCRECT;
+
+#define LOWORD(l) ((WORD)(((DWORD_PTR)(l)) & 0xffff))
+#define HIWORD(l) ((WORD)((((DWORD_PTR)(l)) >> 16) & 0xffff))
+#define GET_X_LPARAM(lp) ((int)(short)LOWORD(lp))
+#define GET_Y_LPARAM(lp) ((int)(short)HIWORD(lp))
+
+typedef DWORD COLORREF;
+#define RGB(r, g, b) ((COLORREF)(((BYTE)(r) | ((WORD)((BYTE)(g)) << 8)) | (((DWORD)(BYTE)(b)) << 16)))
+#define GetRValue(rgb) ((BYTE)(rgb))
+#define GetGValue(rgb) ((BYTE)(((WORD)(rgb)) >> 8))
+#define GetBValue(rgb) ((BYTE)((rgb) >> 16))
+
+#define CopyMemory(d, s, n) memcpy((d), (s), (n))
+#define ZeroMemory(d, n) memset((d), 0, (n))
+#define MoveMemory(d, s, n) memmove((d), (s), (n))
+#define lengthof(x) (sizeof(x)/sizeof(*x))
+#define _alloca alloca
+
+inline UINT GetACP() { return 936; }
+inline LPSTR CharNext(LPCSTR p) { return (LPSTR)(*p ? p + 1 : p); }
+inline LPSTR CharPrev(LPCSTR pStart, LPCSTR p) { return (LPSTR)(p > pStart ? p - 1 : p); }
+inline BOOL IsBadStringPtrA(LPCSTR p, UINT_PTR) { return p == NULL; }
+inline BOOL IsBadStringPtrW(LPCWSTR p, UINT_PTR) { return p == NULL; }
+#define IsBadStringPtr IsBadStringPtrA
+
+#define IDC_WAIT MAKEINTRESOURCE(32514)
+inline HCURSOR LoadCursor(HINSTANCE, LPCTSTR) { return NULL; }
+inline HCURSOR SetCursor(HCURSOR) { return NULL; }
+
+// every code page maps a byte to the WCHAR of the same value and back, which is enough for
+// the conversions to round trip; a buffer too small fails as it does on Windows
+inline int MultiByteToWideChar(UINT, DWORD, LPCSTR src, int n, LPWSTR dst, int cch)
+{
+	if( n < 0 ) n = (int)strlen(src) + 1;
+	if( cch == 0 ) return n;
+	if( cch < n ) return 0;
+	for( int i = 0; i < n; i++ ) dst[i] = (unsigned char)src[i];
+	return n;
+}
+
+inline int WideCharToMultiByte(UINT, DWORD, LPCWSTR src, int n, LPSTR dst, int cb, LPCSTR, BOOL*)
+{
+	if( n < 0 ) n = (int)wcslen(src) + 1;
+	if( cb == 0 ) return n;
+	if( cb < n ) return 0;
+	for( int i = 0; i < n; i++ ) dst[i] = (char)src[i];
+	return n;
+}
+
+// files are FILE*, only whole-file reads and writes are needed
+#define INVALID_HANDLE_VALUE ((HANDLE)0)
+#define GENERIC_READ 0x80000000
+#define GENERIC_WRITE 0x40000000
+#define FILE_SHARE_READ 1
+#define OPEN_EXISTING 3
+#define CREATE_ALWAYS 2
+#define FILE_ATTRIBUTE_NORMAL 0x80
+
+inline HANDLE CreateFile(LPCSTR pstrName, DWORD dwAccess, DWORD, void*, DWORD, DWORD, HANDLE)
+{
+	return fopen(pstrName, dwAccess == GENERIC_WRITE ? "wb" : "rb");
+}
+inline DWORD GetFileSize(HANDLE h, LPDWORD)
+{
+	long nPos = ftell((FILE*)h);
+	fseek((FILE*)h, 0, SEEK_END);
+	long nSize = ftell((FILE*)h);
+	fseek((FILE*)h, nPos, SEEK_SET);
+	return (DWORD)nSize;
+}
+inline BOOL ReadFile(HANDLE h, LPVOID p, DWORD n, LPDWORD pRead, void*) { *pRead = (DWORD)fread(p, 1, n, (FILE*)h); return TRUE; }
+inline BOOL WriteFile(HANDLE h, LPCVOID p, DWORD n, LPDWORD pWritten, void*) { *pWritten = (DWORD)fwrite(p, 1, n, (FILE*)h); return TRUE; }
+inline BOOL CloseHandle(HANDLE h) { return fclose((FILE*)h) == 0; }
+inline BOOL DeleteFile(LPCSTR pstrName) { return remove(pstrName) == 0; }
+
+inline BOOL IsRectEmpty(const RECT* p) { return p->left >= p->right || p->top >= p->bottom; }
+inline BOOL PtInRect(const RECT* p, POINT pt) { return pt.x >= p->left && pt.x < p->right && pt.y >= p->top && pt.y < p->bottom; }
+inline BOOL SetRect(RECT* p, int l, int t, int r, int b) { p->left = l; p->top = t; p->right = r; p->bottom = b; return TRUE; }
+inline BOOL SetRectEmpty(RECT* p) { return SetRect(p, 0, 0, 0, 0); }
+inline BOOL OffsetRect(RECT* p, int dx, int dy) { p->left += dx; p->right += dx; p->top += dy; p->bottom += dy; return TRUE; }
+inline BOOL InflateRect(RECT* p, int dx, int dy) { p->left -= dx; p->right += dx; p->top -= dy; p->bottom += dy; return TRUE; }
+inline BOOL EqualRect(const RECT* a, const RECT* b) { return a->left == b->left && a->top == b->top && a->right == b->right && a->bottom == b->bottom; }
+
+inline BOOL IntersectRect(RECT* d, const RECT* a, const RECT* b)
+{
+	RECT rc = { (std::max)(a->left, b->left), (std::max)(a->top, b->top), (std::min)(a->right, b->right), (std::min)(a->bottom, b->bottom) };
+	if( IsRectEmpty(&rc) ) { SetRectEmpty(d); return FALSE; }
+	*d = rc;
+	return TRUE;
+}
+
+inline BOOL UnionRect(RECT* d, const RECT* a, const RECT* b)
+{
+	if( IsRectEmpty(a) ) { if( IsRectEmpty(b) ) return SetRectEmpty(d), FALSE; *d = *b; return TRUE; }
+	if( IsRectEmpty(b) ) { *d = *a; return TRUE; }
+	RECT rc = { (std::min)(a->left, b->left), (std::min)(a->top, b->top), (std::max)(a->right, b->right), (std::max)(a->bottom, b->bottom) };
+	*d = rc;
+	return TRUE;
+}
+
+inline char* _strlwr(char* p) { for( char* q = p; *q; q++ ) *q = (char)tolower((unsigned char)*q); return p; }
+inline char* _strupr(char* p) { for( char* q = p; *q; q++ ) *q = (char)toupper((unsigned char)*q); return p; }
+
+#define _tcslen strlen
+#define _tcscpy strcpy
+#define _tcsncpy strncpy
+#define _tcscat strcat
+#define _tcschr strchr
+#define _tcsrchr strrchr
+#define _tcsstr strstr
+#define _tcscmp strcmp
+#define _tcsncmp strncmp
+#define _tcsicmp strcasecmp
+#define _tcsnicmp strncasecmp
+#define _stricmp strcasecmp
+#define _tcstol strtol
+#define _tcstoul strtoul
+#define _tcstod strtod
+#define _ttoi atoi
+#define _tcslwr _strlwr
+#define _tcsupr _strupr
+#define _stprintf sprintf
+#define _sntprintf snprintf
+#define _vsntprintf vsnprintf
+#define _istdigit isdigit
+#define _istspace isspace
+#define _istalpha isalpha
+#define _istalnum isalnum
+
+#endif // __WIN32SHIM_H__
@@ -17,6 +17,7 @@ CISVideoClientWnd::CISVideoClientWnd( LPCTSTR pszXMLPath ) : m_strXmlPath(pszXML
 	 m_pbuttonStop = NULL;
 	 m_pbuttonSetting = NULL;
 	 m_pVerPlayPanel = NULL;
+	 m_nUrlItemHeight = 0;
 	 m_pIsVideoManageThread = new CIsVideoManageThread;
 }
 
@@ -53,6 +54,7 @@ void CISVideoClientWnd::InitWindow()
 	ASSERT(m_pVerLeftPanel);
 	m_pListUrl = GetControlByName<CListUI>("UrlList");
 	ASSERT(m_pListUrl);
+	m_pListUrl->SetDataSource(this);
 	m_pTileLayoutList = GetControlByName<CTileLayoutUI>("VideoList");
 	ASSERT(m_pTileLayoutList);
 	m_nVideoColums = m_pTileLayoutList->GetColumns();
@@ -206,9 +208,7 @@ void CISVideoClientWnd::ChangeVideoDisplayByID(int index)
 void CISVideoClientWnd::InitVideoDisplayInfo()
 {
 	vector<string>& UrlList = CIsSystem::GetInstance()->m_IsOption.GetUrlList();
-	CDialogBuilder builder1;
 	m_pTileLayoutList->RemoveAll();
-	m_pListUrl->RemoveAll();
 	m_vectCurrentVideoInfo.clear();
 	for (int i = 0; i < UrlList.size(); i++)
 	{
@@ -220,17 +220,46 @@ void CISVideoClientWnd::InitVideoDisplayInfo()
 		pViewCtrl->SetText(str);
 		pViewCtrl->SetUserData(UrlList[i].c_str());
 		m_pTileLayoutList->Add(pViewCtrl);
-		CListContainerElementUI* pListItem1 = (CListContainerElementUI*)builder1.Create(_T("listitem.xml"), NULL, this, &m_pm, NULL);
-		CLabelUI*	pLabel		= GetSubControlByName<CLabelUI>("Info", pListItem1);
-		CButtonUI*	pUrlStatus	= GetSubControlByName<CButtonUI>("UrlStatus", pListItem1);
-		str.Format(_T("%02d. 192.168.110.64:554"), i + 1);
-		pLabel->SetText(str);
-		pUrlStatus->SetUserData(UrlList[i].c_str());
-		str.Format("ַ: %s", UrlList[i].c_str());
-		pLabel->SetToolTip(str);
-		m_pListUrl->Add(pListItem1);
 		m_vectCurrentVideoInfo.push_back(make_tuple(pViewCtrl->GetHostWindow(), UrlList[i].c_str(), pViewCtrl));
 	}
+	// the list only builds items for the rows in view and binds them from m_vectUrls
+	m_vectUrls = UrlList;
+	m_pListUrl->ReloadItems();
+}
+
+int CISVideoClientWnd::GetItemCount(CControlUI* pList)
+{
+	return (int)m_vectUrls.size();
+}
+
+int CISVideoClientWnd::GetItemHeight(CControlUI* pList)
+{
+	// every row is a listitem.xml, measure one
+	if (m_nUrlItemHeight == 0)
+	{
+		CControlUI* pItem = CreateItem(pList);
+		m_nUrlItemHeight = (pItem != NULL && pItem->GetFixedHeight() > 0) ? pItem->GetFixedHeight() : 30;
+		delete pItem;
+	}
+	return m_nUrlItemHeight;
+}
+
+CControlUI* CISVideoClientWnd::CreateItem(CControlUI* pList)
+{
+	CDialogBuilder builder;
+	return builder.Create(_T("listitem.xml"), NULL, this, &m_pm, NULL);
+}
+
+void CISVideoClientWnd::BindItem(CControlUI* pList, CControlUI* pItem, int iIndex)
+{
+	CLabelUI*	pLabel		= GetSubControlByName<CLabelUI>("Info", pItem);
+	CButtonUI*	pUrlStatus	= GetSubControlByName<CButtonUI>("UrlStatus", pItem);
+	CDuiString str;
+	str.Format(_T("%02d. 192.168.110.64:554"), iIndex + 1);
+	pLabel->SetText(str);
+	pUrlStatus->SetUserData(m_vectUrls[iIndex].c_str());
+	str.Format("ַ: %s", m_vectUrls[iIndex].c_str());
+	pLabel->SetToolTip(str);
 }
 
 LRESULT CISVideoClientWnd::HandleCustomMessage(UINT uMsg, WPARAM wParam, LPARAM lParam, BOOL& bHandled)
@@ -4,7 +4,7 @@
 #include "IsPlayOpencv.h"
 #include "IsVideoManageThread.h"
 
-class CISVideoClientWnd: public WindowImplBase
+class CISVideoClientWnd: public WindowImplBase, public IListDataSourceUI
 {
 public:
 	CISVideoClientWnd(LPCTSTR pszXMLPath);
@@ -23,6 +23,12 @@ public:
 	 LRESULT OnTimer(UINT uMsg, WPARAM wParam, LPARAM lParam, BOOL& bHandled);
 	 LRESULT OnChangeVideoMode(UINT uMsg, WPARAM wParam, LPARAM lParam, BOOL& bHandled);
 
+	//override IListDataSourceUI, the rows of m_pListUrl
+	int GetItemCount(CControlUI* pList) override;
+	int GetItemHeight(CControlUI* pList) override;
+	CControlUI* CreateItem(CControlUI* pList) override;
+	void BindItem(CControlUI* pList, CControlUI* pItem, int iIndex) override;
+
 private:
 
 	//
@@ -49,6 +55,8 @@ private:
 
 	//VideoData
 	Vect_VideoInfo					m_vectCurrentVideoInfo;
+	vector<string>					m_vectUrls;
+	int								m_nUrlItemHeight;
 
 	//ڲ
 	void StartTaskProcess(BOOL bStart);
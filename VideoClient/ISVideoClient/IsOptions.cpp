@@ -4,7 +4,7 @@
 #include  <stdlib.h>
 #include <io.h>
 #include <boost/property_tree/ini_parser.hpp>
-#include "log4z.h"
+#include "../log4z/log4z.h"
 
 #define PASSWORD_KEY	_T("isvision base version 1.0.0.0")
 using namespace boost::property_tree;
@@ -326,9 +326,9 @@ void CViewCtrlUI::DoInit()
 	}	
 }
 
-void CViewCtrlUI::SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue)
+void CViewCtrlUI::SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue)
 {
-	if (_tcsicmp(pstrName, _T("borderround")) == 0)
+	if (nAttr == DUIATTR_BORDERROUND)
 	{
 		SIZE cxyRound = { 0 };
 		LPTSTR pstr = NULL;
@@ -336,8 +336,8 @@ void CViewCtrlUI::SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue)
 		cxyRound.cy = _tcstol(pstr + 1, &pstr, 10);    ASSERT(pstr);
 		SetHostRound(cxyRound);
 	}
-	if( _tcscmp(pstrName, _T("statusImage")) == 0 ) m_strStatusImage = pstrValue;
-	CControlUI::SetAttribute(pstrName, pstrValue);
+	if( nAttr == DUIATTR_STATUSIMAGE ) m_strStatusImage = pstrValue;
+	CControlUI::SetAttributeById(nAttr, pstrName, pstrValue);
 }
 
 void CViewCtrlUI::PaintStatusImage(HDC hDC)
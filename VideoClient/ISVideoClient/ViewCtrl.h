@@ -61,7 +61,7 @@ public:
 	void	DoInit() override;
 	void	SetPos(RECT rc, bool bNeedInvalidate = true) override;	
 	void	DoEvent(TEventUI& event) override;	
-	void	SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue) override;
+	void	SetAttributeById(int nAttr, LPCTSTR pstrName, LPCTSTR pstrValue) override;
 	void	SetURL( wstring strValue);
 	void	SetFile(wstring strValue);
 
@@ -47,7 +47,7 @@
 
 #include "..\Duilib\Uilib.h"
 #include "dlib/threads.h"
-#include "log4z.h"
+#include "../log4z/log4z.h"
 #include "opencv2/opencv.hpp"
 #include "resource.h"
 
@@ -0,0 +1,3968 @@
+/*
+ * Log4z License
+ * -----------
+ * 
+ * Log4z is licensed under the terms of the MIT license reproduced below.
+ * This means that Log4z is free software and can be used for both academic
+ * and commercial purposes at absolutely no cost.
+ * 
+ * 
+ * ===============================================================================
+ * 
+ * Copyright (C) 2010-2013 YaweiZhang <yawei_zhang@foxmail.com>.
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * 
+ * ===============================================================================
+ * 
+ * (end of COPYRIGHT)
+ */
+
+#include "log4z.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <time.h>
+#include <string.h>
+#include <stddef.h>
+#include <ctype.h>
+
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <list>
+#include <sstream>
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+
+#ifdef WIN32
+#include <io.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/utime.h>
+#include <shlwapi.h>
+#include <process.h>
+#pragma comment(lib, "shlwapi")
+#pragma warning(disable:4996)
+
+#else
+#include <unistd.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include<pthread.h>
+#include <sys/time.h>
+#include <sys/stat.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <semaphore.h>
+#include <sys/uio.h>
+#include <sys/mman.h>
+#include <utime.h>
+#endif
+
+
+#ifdef __APPLE__
+#include <dispatch/dispatch.h>
+#include <libproc.h>
+#endif
+
+#ifdef __linux__
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#endif
+
+
+
+_ZSUMMER_BEGIN
+_ZSUMMER_LOG4Z_BEGIN
+
+static const char *const LOG_STRING[]=
+{
+	"TRACE",
+	"DEBUG",
+	"INFO ",
+	"WARN ",
+	"ERROR",
+	"ALARM",
+	"FATAL",
+};
+
+#ifdef WIN32
+const static WORD LOG_COLOR[LOG_LEVEL_FATAL + 1] = {
+	0,
+	0,
+	FOREGROUND_BLUE | FOREGROUND_GREEN,
+	FOREGROUND_GREEN | FOREGROUND_RED,
+	FOREGROUND_RED,
+	FOREGROUND_GREEN,
+	FOREGROUND_RED | FOREGROUND_BLUE };
+#else
+
+const static char LOG_COLOR[LOG_LEVEL_FATAL + 1][50] = {
+	"\e[0m",
+	"\e[0m",
+	"\e[34m\e[1m",//hight blue
+	"\e[33m", //yellow
+	"\e[31m", //red
+	"\e[32m", //green
+	"\e[35m" };
+#endif
+
+//////////////////////////////////////////////////////////////////////////
+//! Log4zFileHandler
+//////////////////////////////////////////////////////////////////////////
+//! the first line of a mapped log file, followed by the committed length in 16 hex digits and '\n'.
+static const char LOG4Z_MAP_HEAD[] = "#log4z length ";
+static const size_t LOG4Z_MAP_HEAD_SIZE = sizeof(LOG4Z_MAP_HEAD) - 1 + 17;
+
+class Log4zFileHandler
+{
+public:
+	Log4zFileHandler()
+	{
+		_file = NULL; _buffer = NULL; _bufferSize = 0; _bufferLen = 0;
+		_map = NULL; _head = NULL; _mapBase = 0; _mapSize = 0; _mapLen = 0; _fileSize = 0;
+#ifdef WIN32
+		_mapFile = INVALID_HANDLE_VALUE; _mapping = NULL;
+#else
+		_mapFd = -1;
+#endif
+	}
+	~Log4zFileHandler(){ close(); delete [] _buffer; }
+	inline bool isOpen(){ return _file != NULL || _map != NULL; }
+	inline bool open(const char *path, const char * mod)
+	{
+		close();
+		_file = fopen(path, mod);
+		return _file != NULL;
+	}
+	//! open path for appending through a memory mapped window of extend bytes, which moves along the file.
+	//! a new file starts with the committed length line, opening it after a crash truncates it to that length.
+	bool openMap(const char * path, size_t extend);
+	//! publish the written length of a mapped file to its first line, a crash loses the records after it.
+	inline void commit()
+	{
+		if (_head == NULL)
+		{
+			return;
+		}
+		char * digits = _head + sizeof(LOG4Z_MAP_HEAD) - 1;
+		unsigned long long len = _mapLen;
+		for (int i = 15; i >= 0; i--)
+		{
+			digits[i] = "0123456789abcdef"[len & 0xf];
+			len >>= 4;
+		}
+	}
+	inline void close()
+	{
+		if (_file != NULL){flushBuffer(); fclose(_file);_file = NULL;}
+		_bufferLen = 0;
+		closeMap(false);
+	}
+	//! collect the writes in a buffer of size bytes and hand it to the system with one write, call it after open.
+	inline void setBuffer(size_t size)
+	{
+		if (_file == NULL || size == 0)
+		{
+			return;
+		}
+		if (_bufferSize != size)
+		{
+			delete [] _buffer;
+			_buffer = new char[size];
+			_bufferSize = size;
+			_bufferLen = 0;
+		}
+		setvbuf(_file, NULL, _IONBF, 0);
+	}
+	inline size_t bufferedBytes(){ return _bufferLen; }
+	//! close this file and take over the open file of other, the buffer stays.
+	inline void adopt(Log4zFileHandler & other)
+	{
+		close();
+		std::swap(_file, other._file);
+		std::swap(_map, other._map);
+		std::swap(_head, other._head);
+		std::swap(_mapBase, other._mapBase);
+		std::swap(_mapSize, other._mapSize);
+		std::swap(_mapLen, other._mapLen);
+		std::swap(_fileSize, other._fileSize);
+#ifdef WIN32
+		std::swap(_mapFile, other._mapFile);
+		std::swap(_mapping, other._mapping);
+#else
+		std::swap(_mapFd, other._mapFd);
+#endif
+	}
+	//! write the buffer and give up the file, the caller closes it.
+	//! a mapped file is truncated to its length here and handed over as a FILE.
+	inline FILE * detach()
+	{
+		if (_file == NULL)
+		{
+			return closeMap(true);
+		}
+		flushBuffer();
+		FILE * file = _file;
+		_file = NULL;
+		return file;
+	}
+	inline void write(const char * data, size_t len)
+	{
+		if (_map != NULL)
+		{
+			while (len > 0)
+			{
+				if (_mapLen == _mapBase + _mapSize && !remap())
+				{
+					close();
+					return;
+				}
+				size_t room = (size_t)(_mapBase + _mapSize - _mapLen);
+				size_t part = len < room ? len : room;
+				memcpy(_map + (size_t)(_mapLen - _mapBase), data, part);
+				_mapLen += part;
+				data += part;
+				len -= part;
+			}
+			return;
+		}
+		if (_file && len > 0)
+		{
+			if (_buffer == NULL)
+			{
+				if (fwrite(data, 1, len, _file) != len)
+				{
+					close();
+				}
+				return;
+			}
+			if (_bufferLen + len <= _bufferSize)
+			{
+				memcpy(_buffer + _bufferLen, data, len);
+				_bufferLen += len;
+				return;
+			}
+			//the buffer and the data go out together.
+			size_t bufferLen = _bufferLen;
+			_bufferLen = 0;
+			if (!writeGather(_buffer, bufferLen, data, len))
+			{
+				close();
+			}
+		}
+	}
+	inline void flush()
+	{
+		commit();
+		flushBuffer();
+		if (_file) fflush(_file);
+	}
+	//! flush and sync the file to the disk.
+	inline void sync()
+	{
+		flush();
+		if (_map != NULL)
+		{
+			syncMap();
+			return;
+		}
+		if (_file == NULL)
+		{
+			return;
+		}
+#ifdef WIN32
+		_commit(_fileno(_file));
+#else
+		fsync(fileno(_file));
+#endif
+	}
+
+	inline std::string readLine()
+	{
+		char buf[500] = { 0 };
+		if (_file && fgets(buf, 500, _file) != NULL)
+		{
+			return std::string(buf);
+		}
+		return std::string();
+	}
+	inline const std::string readContent();
+private:
+	inline void flushBuffer()
+	{
+		if (_file && _bufferLen > 0)
+		{
+			size_t bufferLen = _bufferLen;
+			_bufferLen = 0;
+			if (!writeGather(_buffer, bufferLen, NULL, 0))
+			{
+				fclose(_file);
+				_file = NULL;
+			}
+		}
+	}
+	bool writeGather(const char * first, size_t firstLen, const char * second, size_t secondLen);
+	bool readMap(unsigned long long offset, char * buf, size_t len);
+	bool remap();
+	void syncMap();
+	FILE * closeMap(bool detach);
+public:
+	FILE *_file;
+private:
+	char * _buffer;
+	size_t _bufferSize;
+	size_t _bufferLen;
+
+	char * _map;		//the mapped window at _mapBase
+	char * _head;		//the mapped length line, NULL when the file has none
+	unsigned long long _mapBase;
+	size_t _mapSize;
+	unsigned long long _mapLen;		//written bytes
+	unsigned long long _fileSize;	//allocated bytes
+#ifdef WIN32
+	HANDLE _mapFile;
+	HANDLE _mapping;
+#else
+	int _mapFd;
+#endif
+};
+
+
+//////////////////////////////////////////////////////////////////////////
+//! UTILITY
+//////////////////////////////////////////////////////////////////////////
+
+
+//////////////////////////////////////////////////////////////////////////
+//! ThreadHelper
+//////////////////////////////////////////////////////////////////////////
+#ifdef WIN32
+static unsigned int WINAPI  threadProc(LPVOID lpParam);
+#else
+static void * threadProc(void * pParam);
+#endif
+
+
+#ifdef WIN32
+unsigned int WINAPI  threadProc(LPVOID lpParam)
+{
+	ThreadHelper * p = (ThreadHelper *) lpParam;
+	p->run();
+	return 0;
+}
+#else
+void * threadProc(void * pParam)
+{
+	ThreadHelper * p = (ThreadHelper *) pParam;
+	p->run();
+	return NULL;
+}
+#endif
+
+
+//////////////////////////////////////////////////////////////////////////
+//! LogData
+//////////////////////////////////////////////////////////////////////////
+struct LogData
+{
+	LoggerId _id;		//dest logger id
+	int	_level;	//log level
+	time_t _time;		//create time
+	unsigned int _precise; //create time 
+	int _contentLen;
+	int _formatId;		//binary input format id, -1 is text
+	unsigned long long _tick; //binary input create tick
+	char _content[LOG4Z_LOG_BUF_SIZE]; //content, or packed arguments of binary input
+};
+
+//! the LogData bytes before _content, a record in the log queue is the head plus _contentLen bytes.
+const int LOG4Z_LOG_DATA_HEAD_SIZE = (int)(sizeof(LogData) - LOG4Z_LOG_BUF_SIZE);
+
+//////////////////////////////////////////////////////////////////////////
+//! LogQueue
+//! bounded multi-producer/single-consumer ring of fixed-size slots.
+//! a producer claims continuous slots by CAS on the tail, copies the record in
+//! and commits it by storing the sequence of the first slot.
+//! the consumer copies the committed record at the head out and releases it by CAS on the head,
+//! so a producer with the drop-oldest policy can move the head too.
+//////////////////////////////////////////////////////////////////////////
+class LogQueue
+{
+public:
+	LogQueue();
+	~LogQueue();
+	//! producer, thread safe. push the head of pLog and _contentLen bytes of content. return false when the queue is full.
+	bool push(const LogData * pLog, const char * content);
+	//! producer, thread safe. drop the oldest committed record.
+	bool dropFront();
+	//! consumer, the log thread only.
+	bool pop(LogData * pLog);
+	inline bool empty(){ return _head.load(std::memory_order_acquire) == _tail.load(std::memory_order_acquire); }
+	//! claimed slots, approximate while producers run.
+	inline unsigned long long size(){ return _tail.load(std::memory_order_relaxed) - _head.load(std::memory_order_relaxed); }
+private:
+	inline unsigned long long slotsOf(int contentLen)
+	{
+		return (LOG4Z_LOG_DATA_HEAD_SIZE + contentLen + LOG4Z_LOG_QUEUE_SLOT_SIZE - 1) / LOG4Z_LOG_QUEUE_SLOT_SIZE;
+	}
+	void copyIn(unsigned long long pos, int offset, const char * data, int len);
+	void copyOut(unsigned long long pos, char * data, int len);
+	LogQueue(const LogQueue &);
+	LogQueue & operator =(const LogQueue &);
+private:
+	char * _buffer;
+	std::atomic<unsigned long long> * _seqs; //the committed position + 1 of the record starts at this slot.
+	std::atomic<unsigned long long> _head;   //the first slot not released by the consumer.
+	std::atomic<unsigned long long> _tail;   //the first slot not claimed by producers.
+};
+
+//////////////////////////////////////////////////////////////////////////
+//! LoggerInfo
+//////////////////////////////////////////////////////////////////////////
+struct LoggerInfo 
+{
+	//! attribute
+	std::string _key;   //logger key
+	std::string _name;	// one logger one name.
+	std::string _path;	//path for log file.
+	int  _level;		//filter level
+	bool _display;		//display to screen 
+	bool _outfile;		//output to file
+	bool _monthdir;		//create directory per month 
+	unsigned int _limitsize; //limit file's size, unit Million byte.
+	bool _enable;		//logger is enable 
+	bool _fileLine;		//enable/disable the log's suffix.(file name:line number)
+	bool _binary;		//write binary input as is to a *.blog file
+	bool _compress;		//compress the rolled files
+	unsigned int _reserveSize; //keep the files under this total size, unit Million byte. 0 is no limit.
+	unsigned int _reserveDays; //remove the files older than this. 0 is no limit.
+	bool _mmap;			//write the *.log file through a memory map
+
+	//! runtime info
+	time_t _curFileCreateTime;	//file create time
+	time_t _curDayBegin;		//the day of the file create time, [begin, end)
+	time_t _curDayEnd;
+	unsigned int _curFileIndex; //rolling file index
+	unsigned int _curWriteLen;  //current file length
+	std::string _curFilePath;	//current file path
+	Log4zFileHandler	_handle;		//file handle.
+	std::vector<bool> _binaryFormats; //format ids already written to the current *.blog file
+	bool _nextPrepared;			//the file of the next roll is requested from the maintainer
+
+	//! hot update name or path for the logger 
+	bool _hotChange;
+	
+	LoggerInfo()
+	{
+		_enable = false; 
+		_path = LOG4Z_DEFAULT_PATH; 
+		_level = LOG4Z_DEFAULT_LEVEL; 
+		_display = LOG4Z_DEFAULT_DISPLAY; 
+		_outfile = LOG4Z_DEFAULT_OUTFILE;
+
+		_monthdir = LOG4Z_DEFAULT_MONTHDIR; 
+		_limitsize = LOG4Z_DEFAULT_LIMITSIZE;
+		_fileLine = LOG4Z_DEFAULT_SHOWSUFFIX;
+		_binary = LOG4Z_DEFAULT_BINARY;
+		_compress = LOG4Z_DEFAULT_COMPRESS;
+		_reserveSize = LOG4Z_DEFAULT_RESERVE_SIZE;
+		_reserveDays = LOG4Z_DEFAULT_RESERVE_DAYS;
+		_mmap = LOG4Z_DEFAULT_MMAP;
+
+		_curFileCreateTime = 0;
+		_curDayBegin = 0;
+		_curDayEnd = 0;
+		_curFileIndex = 0;
+		_curWriteLen = 0;
+		_nextPrepared = false;
+
+		_hotChange = false;
+	}
+};
+
+
+//////////////////////////////////////////////////////////////////////////
+//! LogMaintainer
+//! a low priority thread for the slow work of rolling: opening the next files ahead of the roll,
+//! closing the rolled files, compressing them and removing the old files, so the log thread never waits for it.
+//////////////////////////////////////////////////////////////////////////
+//! the next file of a logger is prepared this long before its day ends.
+const time_t LOG4Z_PREPARE_AHEAD_SECONDS = 60;
+
+class LogMaintainer : public ThreadHelper
+{
+public:
+	LogMaintainer();
+	virtual ~LogMaintainer();
+	bool start();
+	bool stop();
+	//! thread safe. a log file is going to be opened at path, reserve keeps it as is.
+	void openFile(const std::string & path);
+	//! thread safe. the file at path was closed by the caller.
+	void forgetFile(const std::string & path);
+	//! thread safe. close the file, then compress it when compress is true.
+	void closeFile(FILE * file, const std::string & path, bool compress);
+	//! thread safe. create the directory and open the file at path for the next roll of a logger.
+	//! a file prepared before for the logger and not taken is closed, and removed when it is empty.
+	void prepareFile(LoggerId id, const std::string & path, bool mmap);
+	//! thread safe. move the file prepared at path into handle. false when it is not prepared in this mode,
+	//! the caller opens it then. waits when the file is being opened.
+	bool takeFile(LoggerId id, const std::string & path, bool mmap, Log4zFileHandler & handle);
+	//! thread safe. compress the finished files of a logger and remove the old ones.
+	//! dir is the log root, prefix the file name prefix of the logger.
+	void reserve(const std::string & dir, const std::string & prefix,
+		bool compress, unsigned long long reserveSize, unsigned int reserveDays);
+	virtual void run();
+private:
+	enum
+	{
+		MAINTAIN_CLOSE,
+		MAINTAIN_RESERVE,
+		MAINTAIN_PREPARE,
+		MAINTAIN_DISCARD,
+	};
+	struct MaintainTask
+	{
+		int _type;
+		FILE * _file;
+		std::string _path;		//the file to close, prepare or discard, or the log root to reserve
+		std::string _prefix;
+		bool _compress;
+		unsigned long long _reserveSize;
+		unsigned int _reserveDays;
+		LoggerId _id;
+		bool _mmap;
+	};
+	struct PreparedFile
+	{
+		std::string _path;
+		bool _mmap;
+		Log4zFileHandler _handle;
+	};
+	void push(const MaintainTask & task);
+	void doReserve(const MaintainTask & task);
+	void doPrepare(const MaintainTask & task);
+	void discardFile(FILE * file, const std::string & path, bool mmap);
+	bool compressFile(const std::string & path);
+	bool removeFile(const std::string & path);
+private:
+	bool _runing;
+	std::list<MaintainTask> _tasks;
+	//! a file is registered once by the log thread and once by its prepare.
+	std::multiset<std::string> _openFiles;
+	LockHelper _lock;
+	SemHelper _semaphore;
+	//! held while a prepared file is opened, so the log thread never opens the same file beside it.
+	//! taken before _lock.
+	PreparedFile _prepared[LOG4Z_LOGGER_MAX];
+	LockHelper _prepareLock;
+};
+
+//////////////////////////////////////////////////////////////////////////
+//! LogerManager
+//////////////////////////////////////////////////////////////////////////
+class LogerManager : public ThreadHelper, public ILog4zManager
+{
+public:
+	LogerManager();
+	virtual ~LogerManager();
+	
+	bool configFromStringImpl(std::string content, bool isUpdate);
+	//! ?????????
+	virtual bool config(const char* configPath);
+	virtual bool configFromString(const char* configContent);
+
+	//! ?????
+	virtual LoggerId createLogger(const char* key);
+	virtual bool start();
+	virtual bool stop();
+	virtual bool prePushLog(LoggerId id, int level);
+	virtual bool pushLog(LoggerId id, int level, const char * log, const char * file, int line);
+	virtual int registerFormat(const char * format, const char * file, int line);
+	virtual bool pushBinaryLog(LoggerId id, int level, int formatId, const char * args, int argsLen);
+#ifdef LOG4Z_LIMIT_ENABLE
+	virtual bool registerLimit(Log4zLimit * site);
+#endif
+	//! ??ID
+	virtual LoggerId findLogger(const char*  key);
+
+	virtual bool enableLogger(LoggerId id, bool enable);
+	virtual bool setLoggerName(LoggerId id, const char * name);
+	virtual bool setLoggerPath(LoggerId id, const char * path);
+	virtual bool setLoggerLevel(LoggerId id, int nLevel);
+	virtual bool setLoggerFileLine(LoggerId id, bool enable);
+	virtual bool setLoggerDisplay(LoggerId id, bool enable);
+	virtual bool setLoggerOutFile(LoggerId id, bool enable);
+	virtual bool setLoggerLimitsize(LoggerId id, unsigned int limitsize);
+	virtual bool setLoggerMonthdir(LoggerId id, bool enable);
+	virtual bool setLoggerBinary(LoggerId id, bool enable);
+	virtual bool setLoggerCompress(LoggerId id, bool enable);
+	virtual bool setLoggerReserveSize(LoggerId id, unsigned int reserveSize);
+	virtual bool setLoggerReserveDays(LoggerId id, unsigned int reserveDays);
+	virtual bool setLoggerMmap(LoggerId id, bool enable);
+	virtual bool setOverflowPolicy(int policy);
+	virtual bool setFlushInterval(int interval);
+	virtual bool setDurability(int durability);
+
+	virtual bool setAutoUpdate(int interval);
+	virtual bool updateConfig();
+	virtual bool isRunning(){return _runing;}
+	virtual bool isLoggerEnable(LoggerId id);
+	virtual unsigned long long getStatusTotalWriteCount(){return _ullStatusTotalWriteFileCount;}
+	virtual unsigned long long getStatusTotalWriteBytes(){return _ullStatusTotalWriteFileBytes;}
+	virtual unsigned long long getStatusWaitingCount()
+	{
+		//the counters move while they are read one by one, so the pops can run ahead of the pushes read.
+		unsigned long long gone = _ullStatusTotalPopLog + _ullStatusTotalDropOldest;
+		unsigned long long pushed = _ullStatusTotalPushLog;
+		return pushed > gone ? pushed - gone : 0;
+	}
+	virtual unsigned long long getStatusTotalDropNewestCount(){return _ullStatusTotalDropNewest;}
+	virtual unsigned long long getStatusTotalDropOldestCount(){return _ullStatusTotalDropOldest;}
+	virtual unsigned int getStatusActiveLoggers();
+protected:
+	void showColorText(const char *text, int level = LOG_LEVEL_DEBUG);
+	void formatLog(LogData * pLog, const char * log, const char * file, int line);
+	void formatBinaryLog(LogData * pLog);
+	bool pushLogData(LogData * pLog, const char * content);
+	void wakeUp(LoggerId id);
+	void writeBinaryLog(LogData * pLog);
+	bool openLogger(LogData * log);
+	std::string makeLogPath(LoggerInfo * pLogger, const std::string & root, const std::string & name,
+		time_t createTime, unsigned int index, std::string & dir);
+	bool closeLogger(LoggerId id);
+#ifdef LOG4Z_LIMIT_ENABLE
+	void tickLimits(LogData * pLog, unsigned long long elapsed);
+#endif
+	virtual void run();
+private:
+
+	//! thread status.
+	bool		_runing;
+	//! wait thread started.
+	SemHelper		_semaphore;
+	//! close, compress and remove the rolled files.
+	LogMaintainer _maintainer;
+
+	//! hot change name or path for one logger
+	LockHelper _hotLock;
+	int _hotUpdateInterval;
+
+	//! the process info.
+	std::string _pid;
+	std::string _proName;
+
+	//! config file name
+	std::string _configFile;
+
+	//! logger id manager, [logger name]:[logger id].
+	std::map<std::string, LoggerId> _ids; 
+	// the last used id of _loggers
+	LoggerId	_lastId; 
+	LoggerInfo _loggers[LOG4Z_LOGGER_MAX];
+
+	//! binary input call sites, append only.
+	struct FormatInfo
+	{
+		const char * _format;
+		const char * _file;
+		int _line;
+	};
+	FormatInfo _formats[LOG4Z_FORMAT_MAX];
+	std::atomic<int> _formatCount;
+	LockHelper _formatLock;
+#ifdef LOG4Z_LIMIT_ENABLE
+	//! limited call sites, append only.
+	std::vector<Log4zLimit *> _limits;
+	LockHelper _limitLock;
+#endif
+	//! binary input tick to time.
+	unsigned long long _baseTick;
+	unsigned long long _baseMillisecond;
+	unsigned long long _tickFrequency;
+
+	//! log queue
+	LogQueue _logs;
+	int _overflowPolicy;
+	//! the log thread sleeps on _wakeUp while _waiting, the first producer after that posts it.
+	SemHelper _wakeUp;
+	std::atomic<bool> _waiting;
+	//! file write policy of the log thread.
+	int _flushInterval;
+	int _durability;
+	//! synchronous output lock
+	LockHelper	_logLock;
+
+	//show color lock
+	LockHelper _scLock;
+	//status statistics
+	//write file
+	unsigned long long _ullStatusTotalWriteFileCount;
+	unsigned long long _ullStatusTotalWriteFileBytes;
+
+	//Log queue statistics
+	std::atomic<unsigned long long> _ullStatusTotalPushLog;
+	std::atomic<unsigned long long> _ullStatusTotalPopLog;
+	std::atomic<unsigned long long> _ullStatusTotalDropNewest;
+	std::atomic<unsigned long long> _ullStatusTotalDropOldest;
+
+};
+
+
+
+
+//////////////////////////////////////////////////////////////////////////
+//! Log4zFileHandler
+//////////////////////////////////////////////////////////////////////////
+
+const std::string Log4zFileHandler::readContent()
+{
+	std::string content;
+
+	if (!_file)
+	{
+		return content;
+	}
+	fseek(_file, 0, SEEK_SET);
+	int beginpos = ftell(_file);
+	fseek(_file, 0, SEEK_END);
+	int endpos = ftell(_file);
+	fseek(_file, 0, SEEK_SET);
+	int filelen = endpos - beginpos;
+	if (filelen > 10*1024*1024 || filelen <= 0)
+	{
+		return content;
+	}
+	content.resize(filelen+10);
+	if (fread(&content[0], 1, filelen, _file) != (size_t)filelen)
+	{
+		content.clear();
+		return content;
+	}
+	content = content.c_str();
+	return content;
+}
+
+//! write the two blocks in order, with one system call where the platform has a gather write.
+bool Log4zFileHandler::writeGather(const char * first, size_t firstLen, const char * second, size_t secondLen)
+{
+#ifdef WIN32
+	int fd = _fileno(_file);
+	while (firstLen > 0)
+	{
+		int ret = _write(fd, first, (unsigned int)firstLen);
+		if (ret <= 0)
+		{
+			return false;
+		}
+		first += ret;
+		firstLen -= ret;
+	}
+	while (secondLen > 0)
+	{
+		int ret = _write(fd, second, (unsigned int)secondLen);
+		if (ret <= 0)
+		{
+			return false;
+		}
+		second += ret;
+		secondLen -= ret;
+	}
+#else
+	int fd = fileno(_file);
+	struct iovec iov[2];
+	iov[0].iov_base = (void *)first;
+	iov[0].iov_len = firstLen;
+	iov[1].iov_base = (void *)second;
+	iov[1].iov_len = secondLen;
+	int index = 0;
+	while (index < 2)
+	{
+		if (iov[index].iov_len == 0)
+		{
+			index++;
+			continue;
+		}
+		ssize_t ret = writev(fd, iov + index, 2 - index);
+		if (ret < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			return false;
+		}
+		while (index < 2 && (size_t)ret >= iov[index].iov_len)
+		{
+			ret -= iov[index].iov_len;
+			iov[index].iov_len = 0;
+			index++;
+		}
+		if (index < 2)
+		{
+			iov[index].iov_base = (char *)iov[index].iov_base + ret;
+			iov[index].iov_len -= ret;
+		}
+	}
+#endif
+	return true;
+}
+
+bool Log4zFileHandler::openMap(const char * path, size_t extend)
+{
+	close();
+#ifdef WIN32
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	size_t align = info.dwAllocationGranularity;
+	_mapFile = CreateFileA(path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+		NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (_mapFile == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(_mapFile, &fileSize))
+	{
+		CloseHandle(_mapFile);
+		_mapFile = INVALID_HANDLE_VALUE;
+		return false;
+	}
+	_fileSize = (unsigned long long)fileSize.QuadPart;
+#else
+	size_t align = (size_t)sysconf(_SC_PAGESIZE);
+	_mapFd = ::open(path, O_RDWR | O_CREAT, 0644);
+	if (_mapFd < 0)
+	{
+		return false;
+	}
+	struct stat st;
+	if (fstat(_mapFd, &st) != 0)
+	{
+		::close(_mapFd);
+		_mapFd = -1;
+		return false;
+	}
+	_fileSize = (unsigned long long)st.st_size;
+#endif
+	//the windows start at the map alignment.
+	_mapSize = (extend + align - 1) / align * align;
+	if (_mapSize == 0)
+	{
+		_mapSize = align;
+	}
+	bool head = _fileSize == 0;
+	_mapLen = _fileSize == 0 ? LOG4Z_MAP_HEAD_SIZE : _fileSize;
+	if (_fileSize >= LOG4Z_MAP_HEAD_SIZE)
+	{
+		//a committed length is trusted when it ends a record.
+		char line[LOG4Z_MAP_HEAD_SIZE + 1] = { 0 };
+		char last = 0;
+		char * end = NULL;
+		unsigned long long committed = 0;
+		if (readMap(0, line, LOG4Z_MAP_HEAD_SIZE)
+			&& memcmp(line, LOG4Z_MAP_HEAD, sizeof(LOG4Z_MAP_HEAD) - 1) == 0
+			&& line[LOG4Z_MAP_HEAD_SIZE - 1] == '\n')
+		{
+			committed = strtoull(line + sizeof(LOG4Z_MAP_HEAD) - 1, &end, 16);
+		}
+		if (end == line + LOG4Z_MAP_HEAD_SIZE - 1 && committed >= LOG4Z_MAP_HEAD_SIZE && committed <= _fileSize
+			&& readMap(committed - 1, &last, 1) && last == '\n')
+		{
+			head = true;
+			_mapLen = committed;
+		}
+	}
+	if (!head)
+	{
+		//a file without the length line, drop the unwritten tail of a crashed mapping.
+		char tail[4096];
+		while (_mapLen > 0)
+		{
+			size_t len = _mapLen < sizeof(tail) ? (size_t)_mapLen : sizeof(tail);
+			if (!readMap(_mapLen - len, tail, len))
+			{
+				break;
+			}
+			while (len > 0 && tail[len - 1] == '\0')
+			{
+				len--;
+				_mapLen--;
+			}
+			if (len > 0)
+			{
+				break;
+			}
+		}
+	}
+	if (!remap())
+	{
+		closeMap(false);
+		return false;
+	}
+	if (head)
+	{
+#ifdef WIN32
+		_head = (char *)MapViewOfFile(_mapping, FILE_MAP_WRITE, 0, 0, LOG4Z_MAP_HEAD_SIZE);
+#else
+		void * map = mmap(NULL, LOG4Z_MAP_HEAD_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, _mapFd, 0);
+		_head = map == MAP_FAILED ? NULL : (char *)map;
+#endif
+		if (_head == NULL)
+		{
+			closeMap(false);
+			return false;
+		}
+		if (_mapLen == LOG4Z_MAP_HEAD_SIZE)
+		{
+			memcpy(_head, LOG4Z_MAP_HEAD, sizeof(LOG4Z_MAP_HEAD) - 1);
+			_head[LOG4Z_MAP_HEAD_SIZE - 1] = '\n';
+		}
+		commit();
+	}
+	return true;
+}
+
+bool Log4zFileHandler::readMap(unsigned long long offset, char * buf, size_t len)
+{
+#ifdef WIN32
+	LARGE_INTEGER pos;
+	pos.QuadPart = (LONGLONG)offset;
+	DWORD readLen = 0;
+	return SetFilePointerEx(_mapFile, pos, NULL, FILE_BEGIN)
+		&& ReadFile(_mapFile, buf, (DWORD)len, &readLen, NULL) && readLen == len;
+#else
+	return pread(_mapFd, buf, len, (off_t)offset) == (ssize_t)len;
+#endif
+}
+
+//! move the window to the written length, the file grows by a window when the window passes its end.
+//! the blocks are allocated so a full disk fails here and not in a write.
+bool Log4zFileHandler::remap()
+{
+	unsigned long long base = _mapLen / _mapSize * _mapSize;
+	unsigned long long end = base + _mapSize;
+#ifdef WIN32
+	if (_map != NULL)
+	{
+		UnmapViewOfFile(_map);
+		_map = NULL;
+	}
+	if (_mapping == NULL || _fileSize < end)
+	{
+		if (_mapping != NULL)
+		{
+			CloseHandle(_mapping);
+		}
+		_fileSize = _fileSize < end ? end : _fileSize;
+		_mapping = CreateFileMappingA(_mapFile, NULL, PAGE_READWRITE, (DWORD)(_fileSize >> 32), (DWORD)_fileSize, NULL);
+		if (_mapping == NULL)
+		{
+			return false;
+		}
+	}
+	_map = (char *)MapViewOfFile(_mapping, FILE_MAP_WRITE, (DWORD)(base >> 32), (DWORD)base, _mapSize);
+	if (_map == NULL)
+	{
+		return false;
+	}
+#else
+	if (_map != NULL)
+	{
+		munmap(_map, _mapSize);
+		_map = NULL;
+	}
+	if (_fileSize < end)
+	{
+#ifdef __linux__
+		if (posix_fallocate(_mapFd, (off_t)_fileSize, (off_t)(end - _fileSize)) != 0)
+		{
+			return false;
+		}
+#endif
+		if (ftruncate(_mapFd, (off_t)end) != 0)
+		{
+			return false;
+		}
+		_fileSize = end;
+	}
+	int flags = MAP_SHARED;
+#ifdef MAP_POPULATE
+	flags |= MAP_POPULATE;
+#endif
+	void * map = mmap(NULL, _mapSize, PROT_READ | PROT_WRITE, flags, _mapFd, (off_t)base);
+	if (map == MAP_FAILED)
+	{
+		return false;
+	}
+	_map = (char *)map;
+#endif
+	_mapBase = base;
+	return true;
+}
+
+void Log4zFileHandler::syncMap()
+{
+#ifdef WIN32
+	FlushViewOfFile(_map, (size_t)(_mapLen - _mapBase));
+	if (_head != NULL)
+	{
+		FlushViewOfFile(_head, LOG4Z_MAP_HEAD_SIZE);
+	}
+	FlushFileBuffers(_mapFile);
+#else
+	fsync(_mapFd);
+#endif
+}
+
+//! unmap and cut the file to its written length, detach hands the open file over as a FILE.
+FILE * Log4zFileHandler::closeMap(bool detach)
+{
+	FILE * file = NULL;
+#ifdef WIN32
+	if (_mapFile == INVALID_HANDLE_VALUE)
+	{
+		return NULL;
+	}
+	commit();
+	if (_head != NULL)
+	{
+		UnmapViewOfFile(_head);
+		_head = NULL;
+	}
+	if (_map != NULL)
+	{
+		UnmapViewOfFile(_map);
+		_map = NULL;
+	}
+	if (_mapping != NULL)
+	{
+		CloseHandle(_mapping);
+		_mapping = NULL;
+	}
+	LARGE_INTEGER pos;
+	pos.QuadPart = (LONGLONG)_mapLen;
+	SetFilePointerEx(_mapFile, pos, NULL, FILE_BEGIN);
+	SetEndOfFile(_mapFile);
+	int fd = detach ? _open_osfhandle((intptr_t)_mapFile, _O_APPEND) : -1;
+	if (fd >= 0)
+	{
+		file = _fdopen(fd, "ab");
+		if (file == NULL)
+		{
+			_close(fd);
+		}
+	}
+	else
+	{
+		CloseHandle(_mapFile);
+	}
+	_mapFile = INVALID_HANDLE_VALUE;
+#else
+	if (_mapFd < 0)
+	{
+		return NULL;
+	}
+	commit();
+	if (_head != NULL)
+	{
+		munmap(_head, LOG4Z_MAP_HEAD_SIZE);
+		_head = NULL;
+	}
+	if (_map != NULL)
+	{
+		munmap(_map, _mapSize);
+		_map = NULL;
+	}
+	//a failed cut keeps the unwritten tail, the length line still tells where it starts.
+	int ret = ftruncate(_mapFd, (off_t)_mapLen);
+	(void)ret;
+	if (detach)
+	{
+		file = fdopen(_mapFd, "ab");
+	}
+	if (file == NULL)
+	{
+		::close(_mapFd);
+	}
+	_mapFd = -1;
+#endif
+	_mapBase = 0;
+	_mapLen = 0;
+	_fileSize = 0;
+	return file;
+}
+
+
+
+
+//////////////////////////////////////////////////////////////////////////
+//! LogQueue
+//////////////////////////////////////////////////////////////////////////
+LogQueue::LogQueue()
+{
+	_buffer = new char[LOG4Z_LOG_QUEUE_SLOTS * LOG4Z_LOG_QUEUE_SLOT_SIZE];
+	_seqs = new std::atomic<unsigned long long>[LOG4Z_LOG_QUEUE_SLOTS];
+	for (int i = 0; i < LOG4Z_LOG_QUEUE_SLOTS; i++)
+	{
+		_seqs[i].store(0);
+	}
+	_head.store(0);
+	_tail.store(0);
+}
+
+LogQueue::~LogQueue()
+{
+	delete [] _buffer;
+	delete [] _seqs;
+}
+
+void LogQueue::copyIn(unsigned long long pos, int offset, const char * data, int len)
+{
+	const int total = LOG4Z_LOG_QUEUE_SLOTS * LOG4Z_LOG_QUEUE_SLOT_SIZE;
+	offset = ((int)(pos & (LOG4Z_LOG_QUEUE_SLOTS - 1)) * LOG4Z_LOG_QUEUE_SLOT_SIZE + offset) % total;
+	int first = (std::min)(len, total - offset);
+	memcpy(_buffer + offset, data, first);
+	if (first < len)
+	{
+		memcpy(_buffer, data + first, len - first);
+	}
+}
+
+void LogQueue::copyOut(unsigned long long pos, char * data, int len)
+{
+	const int total = LOG4Z_LOG_QUEUE_SLOTS * LOG4Z_LOG_QUEUE_SLOT_SIZE;
+	int offset = (int)(pos & (LOG4Z_LOG_QUEUE_SLOTS - 1)) * LOG4Z_LOG_QUEUE_SLOT_SIZE;
+	int first = (std::min)(len, total - offset);
+	memcpy(data, _buffer + offset, first);
+	if (first < len)
+	{
+		memcpy(data + first, _buffer, len - first);
+	}
+}
+
+bool LogQueue::push(const LogData * pLog, const char * content)
+{
+	unsigned long long count = slotsOf(pLog->_contentLen);
+	unsigned long long pos = 0;
+	for (;;)
+	{
+		//the head first: a tail read after it is never behind it, where a tail kept from an earlier
+		//try can be, and would make a queue with free slots look full.
+		unsigned long long head = _head.load(std::memory_order_acquire);
+		pos = _tail.load(std::memory_order_acquire);
+		if (head > pos)
+		{
+			continue;
+		}
+		if (pos + count > head + (unsigned long long)LOG4Z_LOG_QUEUE_SLOTS)
+		{
+			return false;
+		}
+		if (_tail.compare_exchange_weak(pos, pos + count, std::memory_order_acq_rel, std::memory_order_relaxed))
+		{
+			break;
+		}
+	}
+
+	copyIn(pos, 0, (const char *)pLog, LOG4Z_LOG_DATA_HEAD_SIZE);
+	copyIn(pos, LOG4Z_LOG_DATA_HEAD_SIZE, content, pLog->_contentLen);
+	_seqs[pos & (LOG4Z_LOG_QUEUE_SLOTS - 1)].store(pos + 1, std::memory_order_release);
+	return true;
+}
+
+bool LogQueue::dropFront()
+{
+	unsigned long long head = _head.load(std::memory_order_acquire);
+	if (_seqs[head & (LOG4Z_LOG_QUEUE_SLOTS - 1)].load(std::memory_order_acquire) != head + 1)
+	{
+		//empty, or the oldest record is still being written.
+		return false;
+	}
+	//the head slot never wraps because the slot is larger than the record head.
+	int contentLen = 0;
+	memcpy(&contentLen, _buffer + (head & (LOG4Z_LOG_QUEUE_SLOTS - 1)) * LOG4Z_LOG_QUEUE_SLOT_SIZE + offsetof(LogData, _contentLen), sizeof(contentLen));
+	if (contentLen < 0 || contentLen >= LOG4Z_LOG_BUF_SIZE)
+	{
+		return false;
+	}
+	return _head.compare_exchange_strong(head, head + slotsOf(contentLen), std::memory_order_acq_rel);
+}
+
+bool LogQueue::pop(LogData * pLog)
+{
+	do 
+	{
+		unsigned long long head = _head.load(std::memory_order_acquire);
+		if (_seqs[head & (LOG4Z_LOG_QUEUE_SLOTS - 1)].load(std::memory_order_acquire) != head + 1)
+		{
+			return false;
+		}
+		copyOut(head, (char*)pLog, LOG4Z_LOG_DATA_HEAD_SIZE);
+		if (pLog->_contentLen < 0 || pLog->_contentLen >= LOG4Z_LOG_BUF_SIZE)
+		{
+			//overwritten after a producer dropped it, read the new head again.
+			continue;
+		}
+		copyOut(head, (char*)pLog, LOG4Z_LOG_DATA_HEAD_SIZE + pLog->_contentLen);
+		if (_head.compare_exchange_strong(head, head + slotsOf(pLog->_contentLen), std::memory_order_acq_rel))
+		{
+			pLog->_content[pLog->_contentLen] = '\0';
+			return true;
+		}
+		//a producer dropped this record while it was copied out, the copy may be torn.
+	} while (true);
+	return false;
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+//! utility
+//////////////////////////////////////////////////////////////////////////
+
+
+void sleepMillisecond(unsigned int ms)
+{
+#ifdef WIN32
+	::Sleep(ms);
+#else
+	usleep(1000*ms);
+#endif
+}
+
+struct tm timeToTm(time_t t)
+{
+#ifdef WIN32
+#if _MSC_VER < 1400 //VS2003
+	return * localtime(&t);
+#else //vs2005->vs2013->
+	struct tm tt = { 0 };
+	localtime_s(&tt, &t);
+	return tt;
+#endif
+#else //linux
+	struct tm tt = { 0 };
+	localtime_r(&t, &tt);
+	return tt;
+#endif
+}
+
+//! monotonic tick for binary input, cheap enough for the caller's thread.
+static unsigned long long getTick()
+{
+#ifdef WIN32
+	LARGE_INTEGER tick;
+	QueryPerformanceCounter(&tick);
+	return (unsigned long long)tick.QuadPart;
+#else
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#endif
+}
+
+static unsigned long long getTickFrequency()
+{
+#ifdef WIN32
+	LARGE_INTEGER freq;
+	QueryPerformanceFrequency(&freq);
+	return (unsigned long long)freq.QuadPart;
+#else
+	return 1000000000ULL;
+#endif
+}
+
+//! millisecond since epoch.
+static unsigned long long getMillisecond()
+{
+#ifdef WIN32
+	FILETIME ft;
+	GetSystemTimeAsFileTime(&ft);
+	unsigned long long now = ft.dwHighDateTime;
+	now <<= 32;
+	now |= ft.dwLowDateTime;
+	now /=10;
+	now -=11644473600000000ULL;
+	now /=1000;
+	return now;
+#else
+	struct timeval tm;
+	gettimeofday(&tm, NULL);
+	return (unsigned long long)tm.tv_sec * 1000 + tm.tv_usec/1000;
+#endif
+}
+
+bool isSameDay(time_t t1, time_t t2)
+{
+	tm tm1 = timeToTm(t1);
+	tm tm2 = timeToTm(t2);
+	if ( tm1.tm_year == tm2.tm_year
+		&& tm1.tm_yday == tm2.tm_yday)
+	{
+		return true;
+	}
+	return false;
+}
+
+
+void fixPath(std::string &path)
+{
+	if (path.empty()){return;}
+	for (std::string::iterator iter = path.begin(); iter != path.end(); ++iter)
+	{
+		if (*iter == '\\'){*iter = '/';}
+	}
+	if (path.at(path.length()-1) != '/'){path.append("/");}
+}
+
+void trimLogConfig(std::string &str, std::string extIgnore)
+{
+	if (str.empty()){return;}
+	extIgnore += "\r\n\t ";
+	int length = (int)str.length();
+	int posBegin = 0;
+	int posEnd = 0;
+
+	//trim utf8 file bom
+	if (str.length() >= 3 
+		&& (unsigned char)str[0] == 0xef
+		&& (unsigned char)str[1] == 0xbb
+		&& (unsigned char)str[2] == 0xbf)
+	{
+		posBegin = 3;
+	}
+
+	//trim character 
+	for (int i = posBegin; i<length; i++)
+	{
+		bool bCheck = false;
+		for (int j = 0; j < (int)extIgnore.length(); j++)
+		{
+			if (str[i] == extIgnore[j])
+			{
+				bCheck = true;
+			}
+		}
+		if (bCheck)
+		{
+			if (i == posBegin)
+			{
+				posBegin++;
+			}
+		}
+		else
+		{
+			posEnd = i + 1;
+		}
+	}
+	if (posBegin < posEnd)
+	{
+		str = str.substr(posBegin, posEnd-posBegin);
+	}
+	else
+	{
+		str.clear();
+	}
+}
+
+
+void splitStdString(std::vector<std::string>& dst, const std::string& str, const std::string & delimiter)
+{
+	std::string::size_type pos = str.find(delimiter.c_str());
+	if (pos == std::string::npos)
+	{
+		dst.push_back(str);
+		return;
+	}
+
+	dst.push_back(str.substr(0, pos));
+	splitStdString(dst, str.substr(pos + 1), delimiter);
+}
+
+
+//split
+std::pair<std::string, std::string> splitPairString(const std::string & str, const std::string & delimiter)
+{
+	std::string::size_type pos = str.find(delimiter.c_str());
+	if (pos == std::string::npos)
+	{
+		return std::make_pair(str, "");
+	}
+	return std::make_pair(str.substr(0, pos), str.substr(pos+delimiter.length()));
+}
+
+static bool parseConfigLine(const std::string& line, int curLineNum, std::string & key, std::map<std::string, LoggerInfo> & outInfo)
+{
+	std::pair<std::string, std::string> kv = splitPairString(line, "=");
+	if (kv.first.empty())
+	{
+		return false;
+	}
+
+	trimLogConfig(kv.first);
+	trimLogConfig(kv.second);
+	if (kv.first.empty() || kv.first.at(0) == '#')
+	{
+		return true;
+	}
+
+	if (kv.first.at(0) == '[')
+	{
+		trimLogConfig(kv.first, "[]");
+		key = kv.first;
+		{
+			std::string tmpstr = kv.first;
+			std::transform(tmpstr.begin(), tmpstr.end(), tmpstr.begin(), ::tolower);
+			if (tmpstr == "main")
+			{
+				key = "Main";
+			}
+		}
+		std::map<std::string, LoggerInfo>::iterator iter = outInfo.find(key);
+		if (iter == outInfo.end())
+		{
+			LoggerInfo li;
+			li._enable = true;
+			li._key = key;
+			li._name = key;
+			outInfo.insert(std::make_pair(li._key, li));
+		}
+		else
+		{
+			std::cout << "log4z configure warning: duplicate logger key:["<< key << "] at line:" << curLineNum << std::endl;
+		}
+		return true;
+	}
+	trimLogConfig(kv.first);
+	trimLogConfig(kv.second);
+	std::map<std::string, LoggerInfo>::iterator iter = outInfo.find(key);
+	if (iter == outInfo.end())
+	{
+		std::cout << "log4z configure warning: not found current logger name:["<< key << "] at line:" << curLineNum
+			<< ", key=" << kv.first << ", value=" << kv.second << std::endl;
+		return true;
+	}
+	std::transform(kv.first.begin(), kv.first.end(), kv.first.begin(), ::tolower);
+	//! path
+	if (kv.first == "path")
+	{
+		iter->second._path = kv.second;
+		return true;
+	}
+	else if (kv.first == "name")
+	{
+		iter->second._name = kv.second;
+		return true;
+	}
+	std::transform(kv.second.begin(), kv.second.end(), kv.second.begin(), ::tolower);
+	//! level
+	if (kv.first == "level")
+	{
+		if (kv.second == "trace" || kv.second == "all")
+		{
+			iter->second._level = LOG_LEVEL_TRACE;
+		}
+		else if (kv.second == "debug")
+		{
+			iter->second._level = LOG_LEVEL_DEBUG;
+		}
+		else if (kv.second == "info")
+		{
+			iter->second._level = LOG_LEVEL_INFO;
+		}
+		else if (kv.second == "warn" || kv.second == "warning")
+		{
+			iter->second._level = LOG_LEVEL_WARN;
+		}
+		else if (kv.second == "error")
+		{
+			iter->second._level = LOG_LEVEL_ERROR;
+		}
+		else if (kv.second == "alarm")
+		{
+			iter->second._level = LOG_LEVEL_ALARM;
+		}
+		else if (kv.second == "fatal")
+		{
+			iter->second._level = LOG_LEVEL_FATAL;
+		}
+	}
+	//! display
+	else if (kv.first == "display")
+	{
+		if (kv.second == "false" || kv.second == "0")
+		{
+			iter->second._display = false;
+		}
+		else
+		{
+			iter->second._display = true;
+		}
+	}
+	//! output to file
+	else if (kv.first == "outfile")
+	{
+		if (kv.second == "false" || kv.second == "0")
+		{
+			iter->second._outfile = false;
+		}
+		else
+		{
+			iter->second._outfile = true;
+		}
+	}
+	//! monthdir
+	else if (kv.first == "monthdir")
+	{
+		if (kv.second == "false" || kv.second == "0")
+		{
+			iter->second._monthdir = false;
+		}
+		else
+		{
+			iter->second._monthdir = true;
+		}
+	}
+	//! limit file size
+	else if (kv.first == "limitsize")
+	{
+		iter->second._limitsize = atoi(kv.second.c_str());
+	}
+	//! display log in file line
+	else if (kv.first == "fileline")
+	{
+		if (kv.second == "false" || kv.second == "0")
+		{
+			iter->second._fileLine = false;
+		}
+		else
+		{
+			iter->second._fileLine = true;
+		}
+	}
+	//! write binary input as is
+	else if (kv.first == "binary")
+	{
+		if (kv.second == "false" || kv.second == "0")
+		{
+			iter->second._binary = false;
+		}
+		else
+		{
+			iter->second._binary = true;
+		}
+	}
+	//! compress the rolled files
+	else if (kv.first == "compress")
+	{
+		if (kv.second == "false" || kv.second == "0")
+		{
+			iter->second._compress = false;
+		}
+		else
+		{
+			iter->second._compress = true;
+		}
+	}
+	//! reserve total file size
+	else if (kv.first == "reservesize")
+	{
+		iter->second._reserveSize = atoi(kv.second.c_str());
+	}
+	//! reserve file days
+	else if (kv.first == "reservedays")
+	{
+		iter->second._reserveDays = atoi(kv.second.c_str());
+	}
+	//! write through a memory map
+	else if (kv.first == "mmap")
+	{
+		if (kv.second == "false" || kv.second == "0")
+		{
+			iter->second._mmap = false;
+		}
+		else
+		{
+			iter->second._mmap = true;
+		}
+	}
+	//! enable/disable one logger
+	else if (kv.first == "enable")
+	{
+		if (kv.second == "false" || kv.second == "0")
+		{
+			iter->second._enable = false;
+		}
+		else
+		{
+			iter->second._enable = true;
+		}
+	}
+	return true;
+}
+
+static bool parseConfigFromString(std::string content, std::map<std::string, LoggerInfo> & outInfo)
+{
+
+	std::string key;
+	int curLine = 1;
+	std::string line;
+	std::string::size_type curPos = 0;
+	if (content.empty())
+	{
+		return true;
+	}
+	do
+	{
+		std::string::size_type pos = std::string::npos;
+		for (std::string::size_type i = curPos; i < content.length(); ++i)
+		{
+			//support linux/unix/windows LRCF
+			if (content[i] == '\r' || content[i] == '\n')
+			{
+				pos = i;
+				break;
+			}
+		}
+		line = content.substr(curPos, pos - curPos);
+		parseConfigLine(line, curLine, key, outInfo);
+		curLine++;
+
+		if (pos == std::string::npos)
+		{
+			break;
+		}
+		else
+		{
+			curPos = pos+1;
+		}
+	} while (1);
+	return true;
+}
+
+
+
+bool isDirectory(std::string path)
+{
+#ifdef WIN32
+	return PathIsDirectoryA(path.c_str()) ? true : false;
+#else
+	DIR * pdir = opendir(path.c_str());
+	if (pdir == NULL)
+	{
+		return false;
+	}
+	else
+	{
+		closedir(pdir);
+		pdir = NULL;
+		return true;
+	}
+#endif
+}
+
+
+
+bool createRecursionDir(std::string path)
+{
+	if (path.length() == 0) return true;
+	std::string sub;
+	fixPath(path);
+
+	std::string::size_type pos = path.find('/');
+	while (pos != std::string::npos)
+	{
+		std::string cur = path.substr(0, pos-0);
+		if (cur.length() > 0 && !isDirectory(cur))
+		{
+			bool ret = false;
+#ifdef WIN32
+			ret = CreateDirectoryA(cur.c_str(), NULL) ? true : false;
+#else
+			ret = (mkdir(cur.c_str(), S_IRWXU|S_IRWXG|S_IRWXO) == 0);
+#endif
+			if (!ret)
+			{
+				return false;
+			}
+		}
+		pos = path.find('/', pos+1);
+	}
+
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+//! gzip for the rolled files
+//! deflate with greedy LZ77 matching and the fixed huffman codes, enough for text logs.
+//////////////////////////////////////////////////////////////////////////
+static unsigned int crc32Update(unsigned int crc, const unsigned char * data, size_t len)
+{
+	static unsigned int table[256] = { 0 };
+	static bool tableReady = false;
+	if (!tableReady)
+	{
+		for (unsigned int i = 0; i < 256; i++)
+		{
+			unsigned int c = i;
+			for (int k = 0; k < 8; k++)
+			{
+				c = (c & 1) ? 0xedb88320U ^ (c >> 1) : c >> 1;
+			}
+			table[i] = c;
+		}
+		tableReady = true;
+	}
+	crc = ~crc;
+	for (size_t i = 0; i < len; i++)
+	{
+		crc = table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+	}
+	return ~crc;
+}
+
+class DeflateWriter
+{
+public:
+	DeflateWriter(FILE * file) : _file(file), _bits(0), _count(0), _outLen(0), _error(false){}
+	inline bool error(){ return _error; }
+	//! one block with the fixed huffman codes.
+	void block(const unsigned char * data, int len, bool final);
+	void flush()
+	{
+		if (_count > 0)
+		{
+			put(0, 8 - _count);
+		}
+		writeOut();
+		fflush(_file);
+	}
+	void writeRaw(const unsigned char * data, int len)
+	{
+		for (int i = 0; i < len; i++)
+		{
+			putByte(data[i]);
+		}
+	}
+private:
+	inline void putByte(unsigned char c)
+	{
+		_out[_outLen++] = c;
+		if (_outLen == sizeof(_out))
+		{
+			writeOut();
+		}
+	}
+	inline void writeOut()
+	{
+		if (_outLen > 0 && fwrite(_out, 1, _outLen, _file) != _outLen)
+		{
+			_error = true;
+		}
+		_outLen = 0;
+	}
+	inline void put(unsigned int value, int bits)
+	{
+		_bits |= (unsigned long long)value << _count;
+		_count += bits;
+		while (_count >= 8)
+		{
+			putByte((unsigned char)(_bits & 0xff));
+			_bits >>= 8;
+			_count -= 8;
+		}
+	}
+	//! huffman codes are packed from the most significant bit.
+	inline void putCode(unsigned int code, int bits)
+	{
+		unsigned int reversed = 0;
+		for (int i = 0; i < bits; i++)
+		{
+			reversed = (reversed << 1) | ((code >> i) & 1);
+		}
+		put(reversed, bits);
+	}
+	inline void putLiteral(int v)
+	{
+		if (v < 144) putCode(0x30 + v, 8);
+		else if (v < 256) putCode(0x190 + v - 144, 9);
+		else if (v < 280) putCode(v - 256, 7);
+		else putCode(0xc0 + v - 280, 8);
+	}
+	void putMatch(int len, int dist);
+private:
+	FILE * _file;
+	unsigned long long _bits;
+	int _count;
+	unsigned char _out[64*1024];
+	size_t _outLen;
+	bool _error;
+};
+
+void DeflateWriter::putMatch(int len, int dist)
+{
+	static const int lenBase[29] = { 3,4,5,6,7,8,9,10,11,13,15,17,19,23,27,31,35,43,51,59,67,83,99,115,131,163,195,227,258 };
+	static const int lenExtra[29] = { 0,0,0,0,0,0,0,0,1,1,1,1,2,2,2,2,3,3,3,3,4,4,4,4,5,5,5,5,0 };
+	static const int distBase[30] = { 1,2,3,4,5,7,9,13,17,25,33,49,65,97,129,193,257,385,513,769,1025,1537,2049,3073,4097,6145,8193,12289,16385,24577 };
+	static const int distExtra[30] = { 0,0,0,0,1,1,2,2,3,3,4,4,5,5,6,6,7,7,8,8,9,9,10,10,11,11,12,12,13,13 };
+	int l = 28;
+	while (lenBase[l] > len) l--;
+	putLiteral(257 + l);
+	if (lenExtra[l] > 0) put(len - lenBase[l], lenExtra[l]);
+	int d = 29;
+	while (distBase[d] > dist) d--;
+	putCode(d, 5);
+	if (distExtra[d] > 0) put(dist - distBase[d], distExtra[d]);
+}
+
+void DeflateWriter::block(const unsigned char * data, int len, bool final)
+{
+	const int hashBits = 15;
+	const int window = 32768;
+	const int maxChain = 32;
+	std::vector<int> head(1 << hashBits, -1);
+	std::vector<int> prev(len > 0 ? len : 1);
+
+	put(final ? 1 : 0, 1);
+	put(1, 2);
+	int i = 0;
+	while (i < len)
+	{
+		int bestLen = 0;
+		int bestDist = 0;
+		unsigned int h = 0;
+		if (i + 3 <= len)
+		{
+			h = ((data[i] << 10) ^ (data[i+1] << 5) ^ data[i+2]) & ((1 << hashBits) - 1);
+			int maxLen = len - i < 258 ? len - i : 258;
+			int chain = maxChain;
+			for (int cand = head[h]; cand >= 0 && i - cand <= window && chain-- > 0; cand = prev[cand])
+			{
+				if (data[cand + bestLen] != data[i + bestLen])
+				{
+					continue;
+				}
+				int l = 0;
+				while (l < maxLen && data[cand + l] == data[i + l]) l++;
+				if (l > bestLen)
+				{
+					bestLen = l;
+					bestDist = i - cand;
+					if (l == maxLen) break;
+				}
+			}
+		}
+		int step = bestLen >= 3 ? bestLen : 1;
+		if (bestLen >= 3)
+		{
+			putMatch(bestLen, bestDist);
+		}
+		else
+		{
+			putLiteral(data[i]);
+		}
+		for (int end = i + step; i < end; i++)
+		{
+			if (i + 3 <= len)
+			{
+				h = ((data[i] << 10) ^ (data[i+1] << 5) ^ data[i+2]) & ((1 << hashBits) - 1);
+				prev[i] = head[h];
+				head[h] = i;
+			}
+		}
+	}
+	putLiteral(256);
+}
+
+//! compress src and append it as a gzip member to dst, concatenated members are still one gzip file.
+static bool gzipFile(const std::string & src, const std::string & dst)
+{
+	Log4zFileHandler in;
+	if (!in.open(src.c_str(), "rb"))
+	{
+		return false;
+	}
+	Log4zFileHandler out;
+	if (!out.open(dst.c_str(), "ab"))
+	{
+		return false;
+	}
+	static const unsigned char header[10] = { 0x1f, 0x8b, 8, 0, 0, 0, 0, 0, 0, 0xff };
+	const int chunkSize = 256*1024;
+	std::vector<unsigned char> chunk(chunkSize);
+	DeflateWriter writer(out._file);
+	writer.writeRaw(header, sizeof(header));
+	unsigned int crc = 0;
+	unsigned int total = 0;
+	while (true)
+	{
+		int len = (int)fread(&chunk[0], 1, chunkSize, in._file);
+		if (len <= 0)
+		{
+			break;
+		}
+		crc = crc32Update(crc, &chunk[0], len);
+		total += (unsigned int)len;
+		writer.block(&chunk[0], len, false);
+	}
+	writer.block(NULL, 0, true);
+	writer.flush();
+	unsigned char trailer[8];
+	for (int i = 0; i < 4; i++)
+	{
+		trailer[i] = (unsigned char)(crc >> (8*i));
+		trailer[4+i] = (unsigned char)(total >> (8*i));
+	}
+	writer.writeRaw(trailer, sizeof(trailer));
+	writer.flush();
+	bool ok = !ferror(in._file) && !writer.error();
+	in.close();
+	out.close();
+	return ok;
+}
+
+//////////////////////////////////////////////////////////////////////////
+//! log file list for the maintain thread
+//////////////////////////////////////////////////////////////////////////
+struct LogFileStat
+{
+	std::string _path;
+	unsigned long long _size;
+	time_t _time;
+	bool operator < (const LogFileStat & other) const { return _time < other._time; }
+};
+
+//! the files in dir named prefix followed by a digit, and in its sub directories when recursion.
+static void listLogFiles(const std::string & dir, const std::string & prefix, bool recursion, std::vector<LogFileStat> & files)
+{
+#ifdef WIN32
+	WIN32_FIND_DATAA fd;
+	HANDLE hFind = FindFirstFileA((dir + "*").c_str(), &fd);
+	if (hFind == INVALID_HANDLE_VALUE)
+	{
+		return;
+	}
+	do 
+	{
+		std::string name = fd.cFileName;
+		if (name == "." || name == "..")
+		{
+			continue;
+		}
+		if (fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+		{
+			if (recursion)
+			{
+				listLogFiles(dir + name + "/", prefix, false, files);
+			}
+			continue;
+		}
+		if (name.length() > prefix.length() && name.compare(0, prefix.length(), prefix) == 0 && isdigit((unsigned char)name[prefix.length()]))
+		{
+			LogFileStat file;
+			file._path = dir + name;
+			file._size = ((unsigned long long)fd.nFileSizeHigh << 32) | fd.nFileSizeLow;
+			unsigned long long ft = ((unsigned long long)fd.ftLastWriteTime.dwHighDateTime << 32) | fd.ftLastWriteTime.dwLowDateTime;
+			file._time = (time_t)(ft / 10000000ULL - 11644473600ULL);
+			files.push_back(file);
+		}
+	} while (FindNextFileA(hFind, &fd));
+	FindClose(hFind);
+#else
+	DIR * pdir = opendir(dir.c_str());
+	if (pdir == NULL)
+	{
+		return;
+	}
+	struct dirent * pent = NULL;
+	while ((pent = readdir(pdir)) != NULL)
+	{
+		std::string name = pent->d_name;
+		if (name == "." || name == "..")
+		{
+			continue;
+		}
+		struct stat st;
+		if (stat((dir + name).c_str(), &st) != 0)
+		{
+			continue;
+		}
+		if (S_ISDIR(st.st_mode))
+		{
+			if (recursion)
+			{
+				listLogFiles(dir + name + "/", prefix, false, files);
+			}
+			continue;
+		}
+		if (name.length() > prefix.length() && name.compare(0, prefix.length(), prefix) == 0 && isdigit((unsigned char)name[prefix.length()]))
+		{
+			LogFileStat file;
+			file._path = dir + name;
+			file._size = (unsigned long long)st.st_size;
+			file._time = st.st_mtime;
+			files.push_back(file);
+		}
+	}
+	closedir(pdir);
+#endif
+}
+
+std::string getProcessID()
+{
+	std::string pid = "0";
+	char buf[260] = {0};
+#ifdef WIN32
+	DWORD winPID = GetCurrentProcessId();
+	sprintf(buf, "%06d", winPID);
+	pid = buf;
+#else
+	sprintf(buf, "%06d", getpid());
+	pid = buf;
+#endif
+	return pid;
+}
+
+
+std::string getProcessName()
+{
+	std::string name = "MainLog";
+	char buf[260] = {0};
+#ifdef WIN32
+	if (GetModuleFileNameA(NULL, buf, 259) > 0)
+	{
+		name = buf;
+	}
+	std::string::size_type pos = name.rfind("\\");
+	if (pos != std::string::npos)
+	{
+		name = name.substr(pos+1, std::string::npos);
+	}
+	pos = name.rfind(".");
+	if (pos != std::string::npos)
+	{
+		name = name.substr(0, pos-0);
+	}
+
+#elif defined(__APPLE__)
+
+	proc_name(getpid(), buf, 260);
+	name = buf;
+	return name;;
+#else
+	sprintf(buf, "/proc/%d/cmdline", (int)getpid());
+	Log4zFileHandler i;
+	i.open(buf, "r");
+	if (!i.isOpen())
+	{
+		return name;
+	}
+	name = i.readLine();
+	i.close();
+
+	std::string::size_type pos = name.rfind("/");
+	if (pos != std::string::npos)
+	{
+		name = name.substr(pos+1, std::string::npos);
+	}
+#endif
+
+
+	return name;
+}
+
+
+std::string getProcessPath()
+{
+	std::string path = LOG4Z_DEFAULT_PATH;
+	char buf[260] = { 0 };
+#ifdef WIN32
+	if (GetModuleFileNameA(NULL, buf, 259) > 0)
+	{
+		path = buf;
+	}
+	std::string::size_type pos = path.rfind("\\");
+	if (pos != std::string::npos)
+	{
+		path = path.substr(0, pos);
+	}
+
+#elif defined(__APPLE__)
+	proc_path(getpid(), buf, 260);
+	path = buf;
+	return path;;
+#else
+	size_t len = readlink("/proc/self/exe", buf, 259);
+	if (len > 0 && len < 259)
+	{
+		path = buf;
+	}
+
+	std::string::size_type pos = path.rfind("/");
+	if (pos != std::string::npos)
+	{
+		path = path.substr(0, pos);
+	}
+#endif
+
+	return path;
+}
+
+
+
+//////////////////////////////////////////////////////////////////////////
+// LockHelper
+//////////////////////////////////////////////////////////////////////////
+LockHelper::LockHelper()
+{
+#ifdef WIN32
+	InitializeCriticalSection(&_crit);
+#else
+	//_crit = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
+	pthread_mutexattr_t attr;
+	pthread_mutexattr_init(&attr);
+	pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+	pthread_mutex_init(&_crit, &attr);
+	pthread_mutexattr_destroy(&attr);
+#endif
+}
+LockHelper::~LockHelper()
+{
+#ifdef WIN32
+	DeleteCriticalSection(&_crit);
+#else
+	pthread_mutex_destroy(&_crit);
+#endif
+}
+
+void LockHelper::lock()
+{
+#ifdef WIN32
+	EnterCriticalSection(&_crit);
+#else
+	pthread_mutex_lock(&_crit);
+#endif
+}
+void LockHelper::unLock()
+{
+#ifdef WIN32
+	LeaveCriticalSection(&_crit);
+#else
+	pthread_mutex_unlock(&_crit);
+#endif
+}
+//////////////////////////////////////////////////////////////////////////
+// SemHelper
+//////////////////////////////////////////////////////////////////////////
+SemHelper::SemHelper()
+{
+#ifdef WIN32
+	_hSem = NULL;
+#elif defined(__APPLE__)
+	_semid = NULL;
+#else
+	_isCreate = false;
+#endif
+
+}
+SemHelper::~SemHelper()
+{
+#ifdef WIN32
+	if (_hSem != NULL)
+	{
+		CloseHandle(_hSem);
+		_hSem = NULL;
+	}
+#elif defined(__APPLE__)
+	if (_semid)
+	{
+		dispatch_release(_semid);
+		_semid = NULL;
+	}
+#else
+	if (_isCreate)
+	{
+		_isCreate = false;
+		sem_destroy(&_semid);
+	}
+#endif
+
+}
+
+bool SemHelper::create(int initcount)
+{
+	if (initcount < 0)
+	{
+		initcount = 0;
+	}
+#ifdef WIN32
+	if (initcount > 64)
+	{
+		return false;
+	}
+	_hSem = CreateSemaphore(NULL, initcount, 64, NULL);
+	if (_hSem == NULL)
+	{
+		return false;
+	}
+#elif defined(__APPLE__)
+	_semid = dispatch_semaphore_create(initcount);
+	if (!_semid)
+	{
+		return false;
+	}
+#else
+	if (sem_init(&_semid, 0, initcount) != 0)
+	{
+		return false;
+	}
+	_isCreate = true;
+#endif
+
+	return true;
+}
+bool SemHelper::wait(int timeout)
+{
+#ifdef WIN32
+	if (timeout < 0)
+	{
+		timeout = INFINITE;
+	}
+	if (WaitForSingleObject(_hSem, timeout) != WAIT_OBJECT_0)
+	{
+		return false;
+	}
+#elif defined(__APPLE__)
+	dispatch_time_t when = timeout < 0 ? DISPATCH_TIME_FOREVER : dispatch_time(DISPATCH_TIME_NOW, (int64_t)timeout*NSEC_PER_MSEC);
+	if (dispatch_semaphore_wait(_semid, when) != 0)
+	{
+		return false;
+	}
+#else
+	if (timeout <= 0)
+	{
+		return (sem_wait(&_semid) == 0);
+	}
+	else
+	{
+		struct timespec ts;
+		clock_gettime(CLOCK_REALTIME, &ts);
+		ts.tv_sec += timeout / 1000;
+		ts.tv_nsec += (long)(timeout % 1000) * 1000000;
+		if (ts.tv_nsec >= 1000000000)
+		{
+			ts.tv_sec++;
+			ts.tv_nsec -= 1000000000;
+		}
+		int ret = 0;
+		do 
+		{
+			ret = sem_timedwait(&_semid, &ts);
+		} while (ret == -1 && errno == EINTR);
+		return ret == 0;
+	}
+#endif
+	return true;
+}
+
+bool SemHelper::post()
+{
+#ifdef WIN32
+	return ReleaseSemaphore(_hSem, 1, NULL) ? true : false;
+#elif defined(__APPLE__)
+	return dispatch_semaphore_signal(_semid) == 0;
+#else
+	return (sem_post(&_semid) == 0);
+#endif
+
+}
+
+//////////////////////////////////////////////////////////////////////////
+//! ThreadHelper
+//////////////////////////////////////////////////////////////////////////
+bool ThreadHelper::start()
+{
+	_hSemHelper.create(0);
+#ifdef WIN32
+	unsigned thrdaddr = 0;
+	unsigned long long ret = _beginthreadex(NULL, 0, threadProc, (void *) this, 0, &thrdaddr);
+
+	if (ret == -1 || ret == 0)
+	{
+		std::cout << "log4z: create log4z thread error! \r\n" <<std::endl;
+		return false;
+	}
+	_hThreadID = ret;
+#else
+	int ret = pthread_create(&_phtreadID, NULL, threadProc, (void*)this);
+	if (ret != 0)
+	{
+		std::cout <<"log4z: create log4z thread error! \r\n" << std::endl;
+		return false;
+	}
+#endif
+	return true;
+}
+
+
+bool ThreadHelper::stop(int timeout)
+{
+	_nExitFlag = 1;
+	_hSemHelper.post();
+#ifdef WIN32
+	if (WaitForSingleObject((HANDLE)_hThreadID, timeout) != WAIT_OBJECT_0)
+	{
+		return false;
+	}
+#else
+	struct timespec abstime = { 0 };
+	abstime.tv_nsec = timeout * 1000 * 1000;
+	if (pthread_timedjoin_np(_phtreadID, NULL, &abstime) != 0)
+	{
+		pthread_detach(_phtreadID);
+	}
+#endif
+	return true;
+}
+
+
+bool ThreadHelper::wait()
+{
+#ifdef WIN32
+	if (WaitForSingleObject((HANDLE)_hThreadID, INFINITE) != WAIT_OBJECT_0)
+	{
+		return false;
+	}
+#else
+	if (pthread_join(_phtreadID, NULL) != 0)
+	{
+		return false;
+	}
+#endif
+	return true;
+}
+
+bool ThreadHelper::wait(int timeout)
+{
+	return _hSemHelper.wait(timeout);
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+//! LogMaintainer
+//////////////////////////////////////////////////////////////////////////
+LogMaintainer::LogMaintainer()
+{
+	_runing = false;
+}
+LogMaintainer::~LogMaintainer()
+{
+	stop();
+}
+bool LogMaintainer::start()
+{
+	if (_runing)
+	{
+		return false;
+	}
+	_semaphore.create(0);
+	_runing = true;
+	if (!ThreadHelper::start())
+	{
+		_runing = false;
+		return false;
+	}
+	return true;
+}
+bool LogMaintainer::stop()
+{
+	if (_runing == true)
+	{
+		_runing = false;
+		_semaphore.post();
+		wait();
+		return true;
+	}
+	return false;
+}
+void LogMaintainer::openFile(const std::string & path)
+{
+	AutoLock l(_lock);
+	_openFiles.insert(path);
+}
+void LogMaintainer::forgetFile(const std::string & path)
+{
+	AutoLock l(_lock);
+	std::multiset<std::string>::iterator iter = _openFiles.find(path);
+	if (iter != _openFiles.end())
+	{
+		_openFiles.erase(iter);
+	}
+}
+//! compress path to path.gz. the file is renamed to *.tmp under the lock first,
+//! so a log file opened at the same path again is a new file and never compressed or removed.
+bool LogMaintainer::compressFile(const std::string & path)
+{
+	std::string src = path;
+	std::string dst = path + ".gz";
+	if (path.length() > 4 && path.compare(path.length() - 4, 4, ".tmp") == 0)
+	{
+		dst = path.substr(0, path.length() - 4) + ".gz";
+	}
+	else
+	{
+		AutoLock l(_lock);
+		if (_openFiles.find(path) != _openFiles.end())
+		{
+			return false;
+		}
+		src = path + ".tmp";
+		if (rename(path.c_str(), src.c_str()) != 0)
+		{
+			return false;
+		}
+	}
+	if (!gzipFile(src, dst))
+	{
+		return false;
+	}
+	remove(src.c_str());
+	return true;
+}
+bool LogMaintainer::removeFile(const std::string & path)
+{
+	AutoLock l(_lock);
+	if (_openFiles.find(path) != _openFiles.end())
+	{
+		return false;
+	}
+	return remove(path.c_str()) == 0;
+}
+void LogMaintainer::closeFile(FILE * file, const std::string & path, bool compress)
+{
+	if (file == NULL)
+	{
+		//closed already, the next reserve compresses it.
+		forgetFile(path);
+		return;
+	}
+	MaintainTask task;
+	task._type = MAINTAIN_CLOSE;
+	task._file = file;
+	task._path = path;
+	task._compress = compress;
+	task._reserveSize = 0;
+	task._reserveDays = 0;
+	task._id = 0;
+	task._mmap = false;
+	if (!_runing)
+	{
+		fclose(file);
+		forgetFile(path);
+		return;
+	}
+	push(task);
+}
+void LogMaintainer::reserve(const std::string & dir, const std::string & prefix,
+	bool compress, unsigned long long reserveSize, unsigned int reserveDays)
+{
+	if (!_runing)
+	{
+		return;
+	}
+	MaintainTask task;
+	task._type = MAINTAIN_RESERVE;
+	task._file = NULL;
+	task._path = dir;
+	task._prefix = prefix;
+	task._compress = compress;
+	task._reserveSize = reserveSize;
+	task._reserveDays = reserveDays;
+	task._id = 0;
+	task._mmap = false;
+	push(task);
+}
+void LogMaintainer::prepareFile(LoggerId id, const std::string & path, bool mmap)
+{
+	if (!_runing || id < 0 || id >= LOG4Z_LOGGER_MAX)
+	{
+		return;
+	}
+	AutoLock l(_prepareLock);
+	PreparedFile & prepared = _prepared[id];
+	if (prepared._path == path && prepared._mmap == mmap)
+	{
+		return;
+	}
+	MaintainTask task;
+	task._file = NULL;
+	task._compress = false;
+	task._reserveSize = 0;
+	task._reserveDays = 0;
+	task._id = id;
+	if (!prepared._path.empty())
+	{
+		task._type = MAINTAIN_DISCARD;
+		task._file = prepared._handle.detach();
+		task._path = prepared._path;
+		task._mmap = prepared._mmap;
+		push(task);
+		task._file = NULL;
+	}
+	openFile(path);
+	prepared._path = path;
+	prepared._mmap = mmap;
+	task._type = MAINTAIN_PREPARE;
+	task._path = path;
+	task._mmap = mmap;
+	push(task);
+}
+bool LogMaintainer::takeFile(LoggerId id, const std::string & path, bool mmap, Log4zFileHandler & handle)
+{
+	if (id < 0 || id >= LOG4Z_LOGGER_MAX)
+	{
+		return false;
+	}
+	AutoLock l(_prepareLock);
+	PreparedFile & prepared = _prepared[id];
+	if (prepared._path != path)
+	{
+		return false;
+	}
+	//a file not opened yet is opened by the caller, its queued prepare finds the path gone and does nothing.
+	bool taken = prepared._mmap == mmap && prepared._handle.isOpen();
+	if (taken)
+	{
+		handle.adopt(prepared._handle);
+	}
+	else
+	{
+		prepared._handle.close();
+	}
+	prepared._path.clear();
+	//the caller registered the file as its own.
+	forgetFile(path);
+	return taken;
+}
+void LogMaintainer::doPrepare(const MaintainTask & task)
+{
+	AutoLock l(_prepareLock);
+	PreparedFile & prepared = _prepared[task._id];
+	if (prepared._path != task._path || prepared._handle.isOpen())
+	{
+		return;
+	}
+	std::string dir = task._path.substr(0, task._path.rfind('/') + 1);
+	if (!isDirectory(dir))
+	{
+		createRecursionDir(dir);
+	}
+	if (task._mmap)
+	{
+		prepared._handle.openMap(task._path.c_str(), LOG4Z_MMAP_EXTEND_SIZE);
+	}
+	else
+	{
+		prepared._handle.open(task._path.c_str(), "ab");
+	}
+}
+//! close a prepared file the log thread did not roll to, and remove it when nothing was written to it.
+void LogMaintainer::discardFile(FILE * file, const std::string & path, bool mmap)
+{
+	if (file != NULL)
+	{
+		fclose(file);
+	}
+	forgetFile(path);
+	struct stat st;
+	if (stat(path.c_str(), &st) == 0 && (unsigned long long)st.st_size == (mmap ? LOG4Z_MAP_HEAD_SIZE : 0))
+	{
+		removeFile(path);
+	}
+}
+void LogMaintainer::push(const MaintainTask & task)
+{
+	_lock.lock();
+	_tasks.push_back(task);
+	_lock.unLock();
+	_semaphore.post();
+}
+
+void LogMaintainer::doReserve(const MaintainTask & task)
+{
+	//the open files are kept as is, they are registered before they are created.
+	std::vector<LogFileStat> files;
+	listLogFiles(task._path, task._prefix, true, files);
+	for (size_t i = 0; i < files.size(); i++)
+	{
+		LogFileStat & file = files[i];
+		std::string::size_type dot = file._path.rfind('.');
+		std::string ext = dot == std::string::npos ? std::string() : file._path.substr(dot);
+		if (!task._compress || (ext != ".log" && ext != ".blog" && ext != ".tmp"))
+		{
+			continue;
+		}
+		std::string dst = (ext == ".tmp" ? file._path.substr(0, dot) : file._path) + ".gz";
+		if (compressFile(file._path))
+		{
+			file._path = dst;
+			file._size = 0;
+			struct stat st;
+			if (stat(dst.c_str(), &st) == 0)
+			{
+				file._size = (unsigned long long)st.st_size;
+			}
+			//keep the age of the log, not of the compression.
+			struct utimbuf times;
+			times.actime = file._time;
+			times.modtime = file._time;
+			utime(dst.c_str(), &times);
+		}
+	}
+
+	std::sort(files.begin(), files.end());
+	unsigned long long total = 0;
+	for (size_t i = 0; i < files.size(); i++)
+	{
+		total += files[i]._size;
+	}
+	time_t expire = time(NULL) - (time_t)task._reserveDays * 24 * 3600;
+	for (size_t i = 0; i < files.size(); i++)
+	{
+		const LogFileStat & file = files[i];
+		bool tooMuch = task._reserveSize > 0 && total > task._reserveSize;
+		bool tooOld = task._reserveDays > 0 && file._time < expire;
+		if (!tooMuch && !tooOld)
+		{
+			continue;
+		}
+		if (removeFile(file._path))
+		{
+			total -= file._size;
+		}
+	}
+}
+
+void LogMaintainer::run()
+{
+#ifdef WIN32
+	SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_BEGIN);
+#elif defined(__linux__)
+	setpriority(PRIO_PROCESS, (id_t)syscall(SYS_gettid), 19);
+#endif
+	while (true)
+	{
+		_semaphore.wait(1000);
+		while (true)
+		{
+			MaintainTask task;
+			_lock.lock();
+			if (_tasks.empty())
+			{
+				_lock.unLock();
+				break;
+			}
+			task = _tasks.front();
+			_tasks.pop_front();
+			_lock.unLock();
+
+			//stopping, only close the files. the next start compresses and removes.
+			if (task._type == MAINTAIN_CLOSE)
+			{
+				fclose(task._file);
+				forgetFile(task._path);
+				if (task._compress && _runing)
+				{
+					compressFile(task._path);
+				}
+			}
+			else if (task._type == MAINTAIN_DISCARD)
+			{
+				discardFile(task._file, task._path, task._mmap);
+			}
+			else if (task._type == MAINTAIN_PREPARE && _runing)
+			{
+				doPrepare(task);
+			}
+			else if (_runing)
+			{
+				doReserve(task);
+			}
+		}
+		if (!_runing)
+		{
+			break;
+		}
+	}
+
+	//the log thread is gone, the files prepared for rolls that did not come are discarded.
+	AutoLock l(_prepareLock);
+	for (int i = 0; i < LOG4Z_LOGGER_MAX; i++)
+	{
+		PreparedFile & prepared = _prepared[i];
+		if (!prepared._path.empty())
+		{
+			discardFile(prepared._handle.detach(), prepared._path, prepared._mmap);
+			prepared._path.clear();
+		}
+	}
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+//! LogerManager
+//////////////////////////////////////////////////////////////////////////
+LogerManager::LogerManager()
+{
+	_runing = false;
+	_lastId = LOG4Z_MAIN_LOGGER_ID;
+	_hotUpdateInterval = 0;
+	_overflowPolicy = LOG4Z_DEFAULT_OVERFLOW;
+	_waiting = false;
+	_flushInterval = LOG4Z_DEFAULT_FLUSH_INTERVAL;
+	_durability = LOG4Z_DEFAULT_DURABILITY;
+
+	_ullStatusTotalPushLog = 0;
+	_ullStatusTotalPopLog = 0;
+	_ullStatusTotalDropNewest = 0;
+	_ullStatusTotalDropOldest = 0;
+
+	_formatCount = 0;
+	_tickFrequency = getTickFrequency();
+	_baseTick = getTick();
+	_baseMillisecond = getMillisecond();
+	_ullStatusTotalWriteFileCount = 0;
+	_ullStatusTotalWriteFileBytes = 0;
+	
+	_pid = getProcessID();
+	_proName = getProcessName();
+	_loggers[LOG4Z_MAIN_LOGGER_ID]._enable = true;
+	_ids[LOG4Z_MAIN_LOGGER_KEY] = LOG4Z_MAIN_LOGGER_ID;
+	_loggers[LOG4Z_MAIN_LOGGER_ID]._key = LOG4Z_MAIN_LOGGER_KEY;
+	_loggers[LOG4Z_MAIN_LOGGER_ID]._name = _proName;
+
+}
+LogerManager::~LogerManager()
+{
+	stop();
+}
+
+
+
+
+void LogerManager::showColorText(const char *text, int level)
+{
+	if (level <= LOG_LEVEL_DEBUG || level > LOG_LEVEL_FATAL)
+	{
+		printf("%s", text);
+		return;
+	}
+#ifndef WIN32
+	printf("%s%s\e[0m", LOG_COLOR[level], text);
+#else
+
+	AutoLock l(_scLock);
+	HANDLE hStd = ::GetStdHandle(STD_OUTPUT_HANDLE);
+	if (hStd == INVALID_HANDLE_VALUE) return;
+	CONSOLE_SCREEN_BUFFER_INFO oldInfo;
+	if (!GetConsoleScreenBufferInfo(hStd, &oldInfo))
+	{
+		return;
+	}
+	else 
+	{
+		SetConsoleTextAttribute(hStd, LOG_COLOR[level]);
+		printf("%s", text);
+		SetConsoleTextAttribute(hStd, oldInfo.wAttributes);
+	}
+#endif
+	return;
+}
+
+bool LogerManager::configFromStringImpl(std::string content, bool isUpdate)
+{
+	std::map<std::string, LoggerInfo> loggerMap;
+	if (!parseConfigFromString(content, loggerMap))
+	{
+		std::cout << " !!! !!! !!! !!!" << std::endl;
+		std::cout << " !!! !!! log4z load config file error" << std::endl;
+		std::cout << " !!! !!! !!! !!!" << std::endl;
+		return false;
+	}
+	for (std::map<std::string, LoggerInfo>::iterator iter = loggerMap.begin(); iter != loggerMap.end(); ++iter)
+	{
+		LoggerId id = LOG4Z_INVALID_LOGGER_ID;
+		id = findLogger(iter->second._key.c_str());
+		if (id == LOG4Z_INVALID_LOGGER_ID)
+		{
+			if (isUpdate)
+			{
+				continue;
+			}
+			else
+			{
+				id = createLogger(iter->second._key.c_str());
+				if (id == LOG4Z_INVALID_LOGGER_ID)
+				{
+					continue;
+				}
+			}
+		}
+		enableLogger(id, iter->second._enable);
+		setLoggerName(id, iter->second._name.c_str());
+		setLoggerPath(id, iter->second._path.c_str());
+		setLoggerLevel(id, iter->second._level);
+		setLoggerFileLine(id, iter->second._fileLine);
+		setLoggerDisplay(id, iter->second._display);
+		setLoggerOutFile(id, iter->second._outfile);
+		setLoggerLimitsize(id, iter->second._limitsize);
+		setLoggerMonthdir(id, iter->second._monthdir);
+		setLoggerBinary(id, iter->second._binary);
+		setLoggerCompress(id, iter->second._compress);
+		setLoggerReserveSize(id, iter->second._reserveSize);
+		setLoggerReserveDays(id, iter->second._reserveDays);
+		setLoggerMmap(id, iter->second._mmap);
+	}
+	return true;
+}
+
+//! read configure and create with overwriting
+bool LogerManager::config(const char* configPath)
+{
+	if (!_configFile.empty())
+	{
+		std::cout << " !!! !!! !!! !!!" << std::endl;
+		std::cout << " !!! !!! log4z configure error: too many calls to Config. the old config file=" << _configFile << ", the new config file=" << configPath << " !!! !!! " << std::endl;
+		std::cout << " !!! !!! !!! !!!" << std::endl;
+		return false;
+	}
+	_configFile = configPath;
+
+	Log4zFileHandler f;
+	f.open(_configFile.c_str(), "r");
+	if (!f.isOpen())
+	{
+		std::cout << " !!! !!! !!! !!!" << std::endl;
+		std::cout << " !!! !!! log4z load config file error. filename=" << configPath << " !!! !!! " << std::endl;
+		std::cout << " !!! !!! !!! !!!" << std::endl;
+		return false;
+	}
+	return configFromStringImpl(f.readContent().c_str(), false);
+}
+
+//! read configure and create with overwriting
+bool LogerManager::configFromString(const char* configContent)
+{
+	return configFromStringImpl(configContent, false);
+}
+
+//! create with overwriting
+LoggerId LogerManager::createLogger(const char* key)
+{
+	if (key == NULL)
+	{
+		return LOG4Z_INVALID_LOGGER_ID;
+	}
+	
+	std::string copyKey = key;
+	trimLogConfig(copyKey);
+
+	LoggerId newID = LOG4Z_INVALID_LOGGER_ID;
+	{
+		std::map<std::string, LoggerId>::iterator iter = _ids.find(copyKey);
+		if (iter != _ids.end())
+		{
+			newID = iter->second;
+		}
+	}
+	if (newID == LOG4Z_INVALID_LOGGER_ID)
+	{
+		if (_lastId +1 >= LOG4Z_LOGGER_MAX)
+		{
+			showColorText("log4z: CreateLogger can not create|writeover, because loggerid need < LOGGER_MAX! \r\n", LOG_LEVEL_FATAL);
+			return LOG4Z_INVALID_LOGGER_ID;
+		}
+		newID = ++ _lastId;
+		_ids[copyKey] = newID;
+		_loggers[newID]._enable = true;
+		_loggers[newID]._key = copyKey;
+		_loggers[newID]._name = copyKey;
+	}
+
+	return newID;
+}
+
+
+bool LogerManager::start()
+{
+	if (_runing)
+	{
+		return false;
+	}
+	_semaphore.create(0);
+	_wakeUp.create(0);
+	_maintainer.start();
+	bool ret = ThreadHelper::start();
+	return ret && _semaphore.wait(3000);
+}
+bool LogerManager::stop()
+{
+	if (_runing == true)
+	{
+		_runing = false;
+		_wakeUp.post();
+		wait();
+		_maintainer.stop();
+		return true;
+	}
+	return false;
+}
+bool LogerManager::prePushLog(LoggerId id, int level)
+{
+	if (id < 0 || id > _lastId || !_runing || !_loggers[id]._enable)
+	{
+		return false;
+	}
+	if (level < _loggers[id]._level)
+	{
+		return false;
+	}
+	return true;
+}
+bool LogerManager::pushLog(LoggerId id, int level, const char * log, const char * file, int line)
+{
+	// discard log
+	if (id < 0 || id > _lastId || !_runing || !_loggers[id]._enable)
+	{
+		return false;
+	}
+
+	//filter log
+	if (level < _loggers[id]._level)
+	{
+		return false;
+	}
+
+	//create log data on the stack, the queue copies only the used length.
+	LogData logData;
+	LogData * pLog = &logData;
+	pLog->_id =id;
+	pLog->_level = level;
+	pLog->_formatId = -1;
+	pLog->_tick = 0;
+	
+	//append precise time to log
+	{
+		unsigned long long now = getMillisecond();
+		pLog->_time = (time_t)(now/1000);
+		pLog->_precise = (unsigned int)(now%1000);
+	}
+
+	formatLog(pLog, log, file, line);
+	return pushLogData(pLog, pLog->_content);
+}
+
+//! the "yyyy-mm-dd hh:mm:ss." prefix of the current second, formatted once per second per thread.
+struct TimePrefixCache
+{
+	time_t _time;
+	char _prefix[32];
+};
+static const int LOG4Z_TIME_PREFIX_LEN = 20;
+
+static const char * timePrefix(time_t t)
+{
+	static thread_local TimePrefixCache cache = { (time_t)-1, { 0 } };
+	if (cache._time != t)
+	{
+		tm tt = timeToTm(t);
+		//the callers copy LOG4Z_TIME_PREFIX_LEN bytes of it, whatever the fields hold.
+		int year = (std::min)((std::max)(tt.tm_year + 1900, 0), 9999);
+#ifdef WIN32
+		int ret = _snprintf_s(cache._prefix, sizeof(cache._prefix), _TRUNCATE, "%04d-%02d-%02d %02d:%02d:%02d.",
+			year, tt.tm_mon + 1, tt.tm_mday, tt.tm_hour, tt.tm_min, tt.tm_sec);
+#else
+		int ret = snprintf(cache._prefix, sizeof(cache._prefix), "%04d-%02d-%02d %02d:%02d:%02d.",
+			year, tt.tm_mon + 1, tt.tm_mday, tt.tm_hour, tt.tm_min, tt.tm_sec);
+#endif
+		if (ret != LOG4Z_TIME_PREFIX_LEN)
+		{
+			memcpy(cache._prefix, "0000-00-00 00:00:00.", LOG4Z_TIME_PREFIX_LEN + 1);
+		}
+		cache._time = t;
+	}
+	return cache._prefix;
+}
+
+//! format the time, level, content and suffix into pLog->_content.
+void LogerManager::formatLog(LogData * pLog, const char * log, const char * file, int line)
+{
+	//the cached date and time, then the millisecond.
+	bool shortDate = false;
+#ifdef WIN32
+	shortDate = file != NULL && _loggers[pLog->_id]._fileLine;
+#endif
+	int prefixLen = shortDate ? LOG4Z_TIME_PREFIX_LEN - 5 : LOG4Z_TIME_PREFIX_LEN;
+	memcpy(pLog->_content, timePrefix(pLog->_time) + (shortDate ? 5 : 0), prefixLen);
+	pLog->_content[prefixLen++] = (char)('0' + pLog->_precise / 100 % 10);
+	pLog->_content[prefixLen++] = (char)('0' + pLog->_precise / 10 % 10);
+	pLog->_content[prefixLen++] = (char)('0' + pLog->_precise % 10);
+	char * pTail = pLog->_content + prefixLen;
+	int tailSize = LOG4Z_LOG_BUF_SIZE - prefixLen;
+
+	if (file == NULL || !_loggers[pLog->_id]._fileLine)
+	{
+#ifdef WIN32
+		int ret = _snprintf_s(pTail, tailSize, _TRUNCATE, " %s %s \r\n",
+			LOG_STRING[pLog->_level], log);
+		if (ret == -1)
+		{
+			ret = tailSize - 1;
+		}
+		pLog->_contentLen = prefixLen + ret;
+#else
+		int ret = snprintf(pTail, tailSize, " %s %s \r\n",
+			LOG_STRING[pLog->_level], log);
+		if (ret == -1)
+		{
+			ret = 0;
+		}
+		if (ret >= tailSize)
+		{
+			ret = tailSize-1;
+		}
+
+		pLog->_contentLen = prefixLen + ret;
+#endif
+	}
+	else
+	{
+		const char * pNameBegin = file+strlen(file);
+		do 
+		{
+			if (*pNameBegin == '\\' || *pNameBegin == '/'){ pNameBegin++; break;}
+			if (pNameBegin == file){break;}
+			pNameBegin--;
+		} while (true);
+		
+		
+#ifdef WIN32
+		int ret = _snprintf_s(pTail, tailSize, _TRUNCATE, " %s:%d %s %s \r\n",
+			pNameBegin, line,
+			LOG_STRING[pLog->_level], log);
+		if (ret == -1)
+		{
+			ret = tailSize - 1;
+		}
+		pLog->_contentLen = prefixLen + ret;
+#else
+		int ret = snprintf(pTail, tailSize, " %s %s (%s):%d \r\n",
+			LOG_STRING[pLog->_level], log, pNameBegin, line);
+		if (ret == -1)
+		{
+			ret = 0;
+		}
+		if (ret >= tailSize)
+		{
+			ret = tailSize-1;
+		}
+
+		pLog->_contentLen = prefixLen + ret;
+#endif
+	}
+
+	if (pLog->_contentLen >= 2)
+	{
+		pLog->_content[pLog->_contentLen - 2] = '\r';
+		pLog->_content[pLog->_contentLen - 1] = '\n';
+	}
+}
+
+int LogerManager::registerFormat(const char * format, const char * file, int line)
+{
+	if (format == NULL)
+	{
+		return -1;
+	}
+	AutoLock l(_formatLock);
+	int formatId = _formatCount.load(std::memory_order_relaxed);
+	if (formatId >= LOG4Z_FORMAT_MAX)
+	{
+		showColorText("log4z: registerFormat can not register, because format count need < LOG4Z_FORMAT_MAX! \r\n", LOG_LEVEL_FATAL);
+		return -1;
+	}
+	_formats[formatId]._format = format;
+	_formats[formatId]._file = file;
+	_formats[formatId]._line = line;
+	_formatCount.store(formatId + 1, std::memory_order_release);
+	return formatId;
+}
+
+bool LogerManager::pushBinaryLog(LoggerId id, int level, int formatId, const char * args, int argsLen)
+{
+	// discard log
+	if (id < 0 || id > _lastId || !_runing || !_loggers[id]._enable)
+	{
+		return false;
+	}
+
+	//filter log
+	if (level < _loggers[id]._level)
+	{
+		return false;
+	}
+
+	if (formatId < 0 || formatId >= _formatCount.load(std::memory_order_acquire) || argsLen < 0 || argsLen >= LOG4Z_LOG_BUF_SIZE)
+	{
+		return false;
+	}
+
+	//only the head is filled, the queue copies the arguments from args.
+	LogData logData;
+	LogData * pLog = &logData;
+	pLog->_id = id;
+	pLog->_level = level;
+	pLog->_time = 0;
+	pLog->_precise = 0;
+	pLog->_contentLen = argsLen;
+	pLog->_formatId = formatId;
+	pLog->_tick = getTick();
+
+	if (LOG4Z_ALL_SYNCHRONOUS_OUTPUT)
+	{
+		memcpy(pLog->_content, args, argsLen);
+		formatBinaryLog(pLog);
+		return pushLogData(pLog, pLog->_content);
+	}
+	return pushLogData(pLog, args);
+}
+
+#ifdef LOG4Z_LIMIT_ENABLE
+bool LogerManager::registerLimit(Log4zLimit * site)
+{
+	if (!_runing)
+	{
+		return false;
+	}
+	AutoLock l(_limitLock);
+	_limits.push_back(site);
+	return true;
+}
+
+//! refill the buckets of the limited call sites and report the records they suppressed since the last tick.
+//! the log thread pushes the report without waiting, a full queue keeps the count for the next tick.
+void LogerManager::tickLimits(LogData * pLog, unsigned long long elapsed)
+{
+	AutoLock l(_limitLock);
+	for (size_t i = 0; i < _limits.size(); i++)
+	{
+		Log4zLimit * site = _limits[i];
+		site->refill(elapsed);
+		unsigned long long suppressed = site->takeSuppressed();
+		if (suppressed == 0)
+		{
+			continue;
+		}
+		if (site->getReport() != NULL)
+		{
+			site->getReport()(*site, suppressed);
+			continue;
+		}
+		LoggerId id = site->getId();
+		if (!_loggers[id]._enable || site->getLevel() < _loggers[id]._level)
+		{
+			continue;
+		}
+		const char * file = site->getFile();
+		const char * name = file + strlen(file);
+		while (name != file && name[-1] != '/' && name[-1] != '\\')
+		{
+			name--;
+		}
+		char text[LOG4Z_LOG_BUF_SIZE];
+		sprintf(text, "suppressed %llu records of the call site %.200s:%d", suppressed, name, site->getLine());
+		pLog->_id = id;
+		pLog->_level = site->getLevel();
+		pLog->_formatId = -1;
+		pLog->_tick = 0;
+		unsigned long long now = getMillisecond();
+		pLog->_time = (time_t)(now/1000);
+		pLog->_precise = (unsigned int)(now%1000);
+		formatLog(pLog, text, NULL, 0);
+		if (LOG4Z_ALL_SYNCHRONOUS_OUTPUT)
+		{
+			pushLogData(pLog, pLog->_content);
+		}
+		else if (_logs.push(pLog, pLog->_content))
+		{
+			_ullStatusTotalPushLog++;
+		}
+		else
+		{
+			site->putBackSuppressed(suppressed);
+		}
+	}
+}
+#endif
+
+//! format the packed arguments of a binary input log into text, on the log thread.
+void LogerManager::formatBinaryLog(LogData * pLog)
+{
+	unsigned long long now = binaryTickToMillisecond(pLog->_tick, _baseTick, _tickFrequency, _baseMillisecond);
+	pLog->_time = (time_t)(now/1000);
+	pLog->_precise = (unsigned int)(now%1000);
+
+	const FormatInfo & info = _formats[pLog->_formatId];
+	char text[LOG4Z_LOG_BUF_SIZE];
+	formatBinaryArgs(text, LOG4Z_LOG_BUF_SIZE, info._format, pLog->_content, pLog->_contentLen);
+	formatLog(pLog, text, info._file, info._line);
+	pLog->_formatId = -1;
+}
+
+//! output synchronously, or push to the log queue by the overflow policy.
+bool LogerManager::pushLogData(LogData * pLog, const char * content)
+{
+	if (_loggers[pLog->_id]._display && LOG4Z_ALL_SYNCHRONOUS_OUTPUT)
+	{
+		showColorText(pLog->_content, pLog->_level);
+	}
+
+	if (LOG4Z_ALL_DEBUGOUTPUT_DISPLAY && LOG4Z_ALL_SYNCHRONOUS_OUTPUT)
+	{
+#ifdef WIN32
+		OutputDebugStringA(pLog->_content);
+#endif
+	}
+
+	if (_loggers[pLog->_id]._outfile && LOG4Z_ALL_SYNCHRONOUS_OUTPUT)
+	{
+		AutoLock l(_logLock);
+		if (openLogger(pLog))
+		{
+			_loggers[pLog->_id]._handle.write(pLog->_content, pLog->_contentLen);
+			closeLogger(pLog->_id);
+			_ullStatusTotalWriteFileCount++;
+			_ullStatusTotalWriteFileBytes += pLog->_contentLen;
+		}
+	}
+
+	if (LOG4Z_ALL_SYNCHRONOUS_OUTPUT)
+	{
+		return true;
+	}
+	
+	while (!_logs.push(pLog, content))
+	{
+		if (_overflowPolicy == LOG_OVERFLOW_DROP_OLDEST)
+		{
+			if (_logs.dropFront())
+			{
+				_ullStatusTotalDropOldest++;
+			}
+			else
+			{
+				//the oldest record is still being written by its producer, let it run.
+				std::this_thread::yield();
+			}
+		}
+		else if (_overflowPolicy == LOG_OVERFLOW_BLOCK && _runing)
+		{
+			sleepMillisecond(1);
+		}
+		else
+		{
+			_ullStatusTotalDropNewest++;
+			return false;
+		}
+	}
+	_ullStatusTotalPushLog ++;
+	wakeUp(pLog->_id);
+	return true;
+}
+
+//! post the log thread only when it sleeps and the record can not wait for the next flush,
+//! so producers of buffered file logs cost no system call.
+void LogerManager::wakeUp(LoggerId id)
+{
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (!_waiting.load(std::memory_order_relaxed))
+	{
+		return;
+	}
+	if (_durability == LOG_DURABILITY_BUFFERED && !_loggers[id]._display && !LOG4Z_ALL_DEBUGOUTPUT_DISPLAY
+		&& _logs.size() < LOG4Z_LOG_QUEUE_SLOTS / 4)
+	{
+		return;
+	}
+	if (_waiting.exchange(false))
+	{
+		_wakeUp.post();
+	}
+}
+
+//! ??ID
+LoggerId LogerManager::findLogger(const char * key)
+{
+	std::map<std::string, LoggerId>::iterator iter;
+	iter = _ids.find(key);
+	if (iter != _ids.end())
+	{
+		return iter->second;
+	}
+	return LOG4Z_INVALID_LOGGER_ID;
+}
+bool LogerManager::enableLogger(LoggerId id, bool enable)
+{
+	if (id <0 || id > _lastId) return false;
+	_loggers[id]._enable = enable;
+	return true;
+}
+bool LogerManager::setLoggerLevel(LoggerId id, int level)
+{
+	if (id <0 || id > _lastId || level < LOG_LEVEL_TRACE || level >LOG_LEVEL_FATAL) return false;
+	_loggers[id]._level = level;
+	return true;
+}
+bool LogerManager::setLoggerDisplay(LoggerId id, bool enable)
+{
+	if (id <0 || id > _lastId) return false;
+	_loggers[id]._display = enable;
+	return true;
+}
+bool LogerManager::setLoggerOutFile(LoggerId id, bool enable)
+{
+	if (id <0 || id > _lastId) return false;
+	_loggers[id]._outfile = enable;
+	return true;
+}
+bool LogerManager::setLoggerMonthdir(LoggerId id, bool enable)
+{
+	if (id <0 || id > _lastId) return false;
+	_loggers[id]._monthdir = enable;
+	return true;
+}
+bool LogerManager::setLoggerLimitsize(LoggerId id, unsigned int limitsize)
+{
+	if (id <0 || id > _lastId) return false;
+	if (limitsize == 0 ) {limitsize = (unsigned int)-1;}
+	_loggers[id]._limitsize = limitsize;
+	return true;
+}
+bool LogerManager::setLoggerBinary(LoggerId id, bool enable)
+{
+	if (id <0 || id > _lastId) return false;
+	AutoLock l(_hotLock);
+	if (_loggers[id]._binary != enable)
+	{
+		_loggers[id]._binary = enable;
+		_loggers[id]._hotChange = true;
+	}
+	return true;
+}
+bool LogerManager::setLoggerCompress(LoggerId id, bool enable)
+{
+	if (id <0 || id > _lastId) return false;
+	_loggers[id]._compress = enable;
+	return true;
+}
+bool LogerManager::setLoggerReserveSize(LoggerId id, unsigned int reserveSize)
+{
+	if (id <0 || id > _lastId) return false;
+	_loggers[id]._reserveSize = reserveSize;
+	return true;
+}
+bool LogerManager::setLoggerReserveDays(LoggerId id, unsigned int reserveDays)
+{
+	if (id <0 || id > _lastId) return false;
+	_loggers[id]._reserveDays = reserveDays;
+	return true;
+}
+bool LogerManager::setLoggerMmap(LoggerId id, bool enable)
+{
+	if (id <0 || id > _lastId) return false;
+	AutoLock l(_hotLock);
+	if (_loggers[id]._mmap != enable)
+	{
+		_loggers[id]._mmap = enable;
+		_loggers[id]._hotChange = true;
+	}
+	return true;
+}
+bool LogerManager::setOverflowPolicy(int policy)
+{
+	if (policy < LOG_OVERFLOW_DROP_NEWEST || policy > LOG_OVERFLOW_BLOCK) return false;
+	_overflowPolicy = policy;
+	return true;
+}
+bool LogerManager::setFlushInterval(int interval)
+{
+	if (interval < 0) return false;
+	_flushInterval = interval;
+	return true;
+}
+bool LogerManager::setDurability(int durability)
+{
+	if (durability < LOG_DURABILITY_BUFFERED || durability > LOG_DURABILITY_SYNC) return false;
+	_durability = durability;
+	return true;
+}
+bool LogerManager::setLoggerFileLine(LoggerId id, bool enable)
+{
+	if (id <0 || id > _lastId) return false;
+	_loggers[id]._fileLine = enable;
+	return true;
+}
+
+bool LogerManager::setLoggerName(LoggerId id, const char * name)
+{
+	if (id <0 || id > _lastId) return false;
+	//the name by main logger is the process name and it's can't change. 
+	if (id == LOG4Z_MAIN_LOGGER_ID) return false; 
+	
+	if (name == NULL || strlen(name) == 0) 
+	{
+		return false;
+	}
+	AutoLock l(_hotLock);
+	if (_loggers[id]._name != name)
+	{
+		_loggers[id]._name = name;
+		_loggers[id]._hotChange = true;
+	}
+	return true;
+}
+
+bool LogerManager::setLoggerPath(LoggerId id, const char * path)
+{
+	if (id <0 || id > _lastId) return false;
+	std::string copyPath;
+	if (path == NULL || strlen(path) == 0) 
+	{
+		copyPath = LOG4Z_DEFAULT_PATH;
+	}
+	else
+	{
+		 copyPath = path;
+	}
+	
+	{
+		char ch = copyPath.at(copyPath.length() - 1);
+		if (ch != '\\' && ch != '/')
+		{
+			copyPath.append("/");
+		}
+	}
+
+	AutoLock l(_hotLock);
+	if (copyPath != _loggers[id]._path)
+	{
+		_loggers[id]._path = copyPath;
+		_loggers[id]._hotChange = true;
+	}
+	return true;
+}
+bool LogerManager::setAutoUpdate(int interval)
+{
+	_hotUpdateInterval = interval;
+	return true;
+}
+bool LogerManager::updateConfig()
+{
+	if (_configFile.empty())
+	{
+		//LOGW("log4z update config file error. filename is empty.");
+		return false;
+	}
+	Log4zFileHandler f;
+	f.open(_configFile.c_str(), "r");
+	if (!f.isOpen())
+	{
+		std::cout << " !!! !!! !!! !!!" << std::endl;
+		std::cout << " !!! !!! log4z load config file error. filename=" << _configFile << " !!! !!! " << std::endl;
+		std::cout << " !!! !!! !!! !!!" << std::endl;
+		return false;
+	}
+	return configFromStringImpl(f.readContent().c_str(), true);
+}
+
+bool LogerManager::isLoggerEnable(LoggerId id)
+{
+	if (id <0 || id > _lastId) return false;
+	return _loggers[id]._enable;
+}
+
+unsigned int LogerManager::getStatusActiveLoggers()
+{
+	unsigned int actives = 0;
+	for (int i=0; i<= _lastId; i++)
+	{
+		if (_loggers[i]._enable)
+		{
+			actives ++;
+		}
+	}
+	return actives;
+}
+
+
+bool LogerManager::openLogger(LogData * pLog)
+{
+	int id = pLog->_id;
+	if (id < 0 || id >_lastId)
+	{
+		showColorText("log4z: openLogger can not open, invalide logger id! \r\n", LOG_LEVEL_FATAL);
+		return false;
+	}
+
+	LoggerInfo * pLogger = &_loggers[id];
+	if (!pLogger->_enable || !pLogger->_outfile || pLog->_level < pLogger->_level)
+	{
+		return false;
+	}
+
+	bool sameday = pLog->_time >= pLogger->_curDayBegin && pLog->_time < pLogger->_curDayEnd;
+	if (!sameday)
+	{
+		sameday = isSameDay(pLog->_time, pLogger->_curFileCreateTime);
+	}
+	bool needChageFile = pLogger->_curWriteLen > pLogger->_limitsize * 1024 * 1024;
+	if (!sameday || needChageFile || pLogger->_hotChange)
+	{
+		if (!sameday)
+		{
+			pLogger->_curFileIndex = 0;
+			pLogger->_curWriteLen = 0;
+			pLogger->_curFileCreateTime = pLog->_time;
+		}
+		else if (needChageFile)
+		{
+			pLogger->_curFileIndex++;
+			pLogger->_curWriteLen = 0;
+		}
+		if (pLogger->_handle.isOpen())
+		{
+			//a rolled file is finished, a hot changed one may be opened again.
+			if (!sameday || needChageFile)
+			{
+				_maintainer.closeFile(pLogger->_handle.detach(), pLogger->_curFilePath, pLogger->_compress);
+				pLogger->_curFilePath.clear();
+			}
+			else
+			{
+				pLogger->_handle.close();
+			}
+		}
+	}
+	if (!sameday || pLogger->_curDayEnd == 0)
+	{
+		//the same day check of the next records is two compares.
+		tm t = timeToTm(pLogger->_curFileCreateTime);
+		t.tm_hour = 0;
+		t.tm_min = 0;
+		t.tm_sec = 0;
+		t.tm_isdst = -1;
+		pLogger->_curDayBegin = mktime(&t);
+		t.tm_mday++;
+		t.tm_isdst = -1;
+		pLogger->_curDayEnd = mktime(&t);
+	}
+	if (!pLogger->_handle.isOpen())
+	{
+		std::string name;
+		std::string root;
+		std::string dir;
+		_hotLock.lock();
+		name = pLogger->_name;
+		//root = pLogger->_path;
+		root = getProcessPath();
+		root.append("/log/");
+		pLogger->_hotChange = false;
+		_hotLock.unLock();
+
+		bool binary = pLogger->_binary && !LOG4Z_ALL_SYNCHRONOUS_OUTPUT;
+		std::string path = makeLogPath(pLogger, root, name, pLogger->_curFileCreateTime, pLogger->_curFileIndex, dir);
+		bool newPath = path != pLogger->_curFilePath;
+		if (newPath)
+		{
+			_maintainer.openFile(path);
+			if (!pLogger->_curFilePath.empty())
+			{
+				_maintainer.forgetFile(pLogger->_curFilePath);
+			}
+			pLogger->_curFilePath = path;
+		}
+		//the synchronous output opens the file for every record, a map does not pay off there.
+		bool mmap = pLogger->_mmap && !binary && !LOG4Z_ALL_SYNCHRONOUS_OUTPUT;
+		//a roll takes the file the maintainer opened ahead, the directory and the open of a missed one cost here.
+		if (LOG4Z_ALL_SYNCHRONOUS_OUTPUT || !_maintainer.takeFile(id, path, mmap, pLogger->_handle))
+		{
+			if (!isDirectory(dir))
+			{
+				createRecursionDir(dir);
+			}
+			if (mmap)
+			{
+				pLogger->_handle.openMap(path.c_str(), LOG4Z_MMAP_EXTEND_SIZE);
+			}
+			else
+			{
+				pLogger->_handle.open(path.c_str(), "ab");
+			}
+		}
+		pLogger->_nextPrepared = false;
+		if (!pLogger->_handle.isOpen())
+		{
+			pLogger->_outfile = false;
+			return false;
+		}
+		pLogger->_handle.setBuffer(LOG4Z_WRITE_BUFFER_SIZE);
+		if (newPath)
+		{
+			_maintainer.reserve(root, name + "_", pLogger->_compress,
+				(unsigned long long)pLogger->_reserveSize * 1024 * 1024, pLogger->_reserveDays);
+		}
+		if (binary)
+		{
+			//every file starts with its own time base and format records, so it can be decoded alone.
+			unsigned long long base[2] = { _tickFrequency, _baseMillisecond };
+			Log4zBinaryRecord record;
+			memset(&record, 0, sizeof(record));
+			record._type = LOG4Z_BINARY_RECORD_HEAD;
+			record._tick = _baseTick;
+			record._len = sizeof(base);
+			pLogger->_handle.write((const char *)&record, sizeof(record));
+			pLogger->_handle.write((const char *)base, sizeof(base));
+			pLogger->_curWriteLen += sizeof(record) + sizeof(base);
+			pLogger->_binaryFormats.assign(LOG4Z_FORMAT_MAX, false);
+		}
+	}
+
+	//near the size limit or the end of the day the maintainer opens the file of the next roll.
+	if (!pLogger->_nextPrepared && !LOG4Z_ALL_SYNCHRONOUS_OUTPUT)
+	{
+		bool dayEnd = pLog->_time >= pLogger->_curDayEnd - LOG4Z_PREPARE_AHEAD_SECONDS;
+		if (dayEnd || pLogger->_curWriteLen > pLogger->_limitsize * 1024 * 768)
+		{
+			std::string name;
+			std::string root;
+			std::string dir;
+			_hotLock.lock();
+			name = pLogger->_name;
+			_hotLock.unLock();
+			root = getProcessPath();
+			root.append("/log/");
+			bool mmap = pLogger->_mmap && !pLogger->_binary;
+			std::string path = makeLogPath(pLogger, root, name, dayEnd ? pLogger->_curDayEnd : pLogger->_curFileCreateTime,
+				dayEnd ? 0 : pLogger->_curFileIndex + 1, dir);
+			_maintainer.prepareFile(id, path, mmap);
+			pLogger->_nextPrepared = true;
+		}
+	}
+	return true;
+}
+
+//! the path of the file of a logger created at createTime with index, dir is its directory.
+std::string LogerManager::makeLogPath(LoggerInfo * pLogger, const std::string & root, const std::string & name,
+	time_t createTime, unsigned int index, std::string & dir)
+{
+	tm t = timeToTm(createTime);
+	char buf[100] = { 0 };
+	dir = root;
+	if (pLogger->_monthdir)
+	{
+		sprintf(buf, "%04d_%02d/", t.tm_year + 1900, t.tm_mon + 1);
+		dir += buf;
+	}
+
+	//sprintf(buf, "%s_%04d%02d%02d%02d%02d_%s_%03d.log",
+	//	name.c_str(), t.tm_year + 1900, t.tm_mon + 1, t.tm_mday,
+	//	t.tm_hour, t.tm_min, _pid.c_str(), index);
+
+	bool binary = pLogger->_binary && !LOG4Z_ALL_SYNCHRONOUS_OUTPUT;
+	if (index == 0)
+	{
+		sprintf(buf, "%s_%04d%02d%02d.%s",
+			name.c_str(), t.tm_year + 1900, t.tm_mon + 1, t.tm_mday, binary ? "blog" : "log");
+	}
+	else
+	{
+		sprintf(buf, "%s_%04d%02d%02d_%03u.%s",
+			name.c_str(), t.tm_year + 1900, t.tm_mon + 1, t.tm_mday, index, binary ? "blog" : "log");
+	}
+	return dir + buf;
+}
+//! write a record as is to the *.blog file of its logger.
+void LogerManager::writeBinaryLog(LogData * pLog)
+{
+	if (pLog->_formatId >= 0)
+	{
+		unsigned long long now = binaryTickToMillisecond(pLog->_tick, _baseTick, _tickFrequency, _baseMillisecond);
+		pLog->_time = (time_t)(now/1000);
+		pLog->_precise = (unsigned int)(now%1000);
+	}
+	if (!openLogger(pLog))
+	{
+		return;
+	}
+	LoggerInfo & curLogger = _loggers[pLog->_id];
+	Log4zBinaryRecord record;
+	memset(&record, 0, sizeof(record));
+	if (pLog->_formatId >= 0 && !curLogger._binaryFormats[pLog->_formatId])
+	{
+		const FormatInfo & info = _formats[pLog->_formatId];
+		const char * file = info._file == NULL ? "" : info._file;
+		unsigned int fileLen = (unsigned int)strlen(file) + 1;
+		unsigned int formatLen = (unsigned int)strlen(info._format) + 1;
+		record._type = LOG4Z_BINARY_RECORD_FORMAT;
+		record._formatId = pLog->_formatId;
+		record._line = info._line;
+		record._len = fileLen + formatLen;
+		curLogger._handle.write((const char *)&record, sizeof(record));
+		curLogger._handle.write(file, fileLen);
+		curLogger._handle.write(info._format, formatLen);
+		curLogger._curWriteLen += sizeof(record) + record._len;
+		curLogger._binaryFormats[pLog->_formatId] = true;
+	}
+
+	record._type = pLog->_formatId >= 0 ? LOG4Z_BINARY_RECORD_BINARY : LOG4Z_BINARY_RECORD_TEXT;
+	record._level = pLog->_level;
+	record._formatId = pLog->_formatId;
+	record._line = 0;
+	record._tick = pLog->_tick;
+	record._len = (unsigned int)pLog->_contentLen;
+	curLogger._handle.write((const char *)&record, sizeof(record));
+	curLogger._handle.write(pLog->_content, pLog->_contentLen);
+	curLogger._curWriteLen += sizeof(record) + record._len;
+	_ullStatusTotalWriteFileCount++;
+	_ullStatusTotalWriteFileBytes += sizeof(record) + record._len;
+}
+
+bool LogerManager::closeLogger(LoggerId id)
+{
+	if (id < 0 || id >_lastId)
+	{
+		showColorText("log4z: closeLogger can not close, invalide logger id! \r\n", LOG_LEVEL_FATAL);
+		return false;
+	}
+	LoggerInfo * pLogger = &_loggers[id];
+	if (pLogger->_handle.isOpen())
+	{
+		pLogger->_handle.close();
+		return true;
+	}
+	return false;
+}
+void LogerManager::run()
+{
+	_runing = true;
+	pushLog(0, LOG_LEVEL_ALARM, "-----------------  log4z thread started!   ----------------------------", NULL, 0);
+	for (int i = 0; i <= _lastId; i++)
+	{
+		if (_loggers[i]._enable)
+		{
+			std::stringstream ss;
+			ss <<"logger id=" <<i 
+				<<" key=" <<_loggers[i]._key
+				<<" name=" <<_loggers[i]._name
+				<<" path=" <<_loggers[i]._path
+				<<" level=" << _loggers[i]._level
+				<<" display=" << _loggers[i]._display;
+			pushLog(0, LOG_LEVEL_ALARM, ss.str().c_str(), NULL, 0);
+		}
+	}
+
+	_semaphore.post();
+
+
+	LogData * pLog = new LogData;
+	int needFlush[LOG4Z_LOGGER_MAX] = {0};
+	time_t lastCheckUpdate = time(NULL);
+	unsigned long long tickPerMillisecond = _tickFrequency / 1000 > 0 ? _tickFrequency / 1000 : 1;
+	unsigned long long lastFlush = getTick() / tickPerMillisecond;
+	unsigned long long lastLimitTick = lastFlush;
+	while (true)
+	{
+		while(_logs.pop(pLog))
+		{
+			//
+			_ullStatusTotalPopLog ++;
+			//discard
+			LoggerInfo & curLogger = _loggers[pLog->_id];
+			if (!curLogger._enable || pLog->_level <curLogger._level  )
+			{
+				continue;
+			}
+
+			bool binaryFile = curLogger._outfile && curLogger._binary;
+			if (binaryFile)
+			{
+				writeBinaryLog(pLog);
+				needFlush[pLog->_id] ++;
+			}
+			if (pLog->_formatId >= 0)
+			{
+				if (binaryFile && !curLogger._display && !LOG4Z_ALL_DEBUGOUTPUT_DISPLAY)
+				{
+					continue;
+				}
+				formatBinaryLog(pLog);
+			}
+
+
+			if (curLogger._display && !LOG4Z_ALL_SYNCHRONOUS_OUTPUT)
+			{
+				showColorText(pLog->_content, pLog->_level);
+			}
+			if (LOG4Z_ALL_DEBUGOUTPUT_DISPLAY && !LOG4Z_ALL_SYNCHRONOUS_OUTPUT)
+			{
+#ifdef WIN32
+				OutputDebugStringA(pLog->_content);
+#endif
+			}
+
+
+			if (curLogger._outfile && !binaryFile && !LOG4Z_ALL_SYNCHRONOUS_OUTPUT)
+			{
+				if (!openLogger(pLog))
+				{
+					continue;
+				}
+
+				//collected in the file buffer, written when it is full or flushed below.
+				curLogger._handle.write(pLog->_content, pLog->_contentLen);
+				curLogger._curWriteLen += (unsigned int)pLog->_contentLen;
+				needFlush[pLog->_id] ++;
+				_ullStatusTotalWriteFileCount++;
+				_ullStatusTotalWriteFileBytes += pLog->_contentLen;
+			}
+			else if (!binaryFile && !LOG4Z_ALL_SYNCHRONOUS_OUTPUT)
+			{
+				_ullStatusTotalWriteFileCount++;
+				_ullStatusTotalWriteFileBytes += pLog->_contentLen;
+			}
+		}
+
+		//! flush by the durability, the buffered files wait for the flush interval.
+		int durability = _durability;
+		unsigned long long now = getTick() / tickPerMillisecond;
+		bool flushTime = durability != LOG_DURABILITY_BUFFERED || !_runing || now - lastFlush >= (unsigned long long)_flushInterval;
+		bool pending = false;
+		for (int i=0; i<=_lastId; i++)
+		{
+			if (_loggers[i]._enable && needFlush[i] > 0)
+			{
+				if (flushTime)
+				{
+					if (durability == LOG_DURABILITY_SYNC)
+					{
+						_loggers[i]._handle.sync();
+					}
+					else
+					{
+						_loggers[i]._handle.flush();
+					}
+					needFlush[i] = 0;
+				}
+				else
+				{
+					//a mapped file commits every batch, it costs no system call.
+					_loggers[i]._handle.commit();
+					pending = true;
+				}
+			}
+			if(!_loggers[i]._enable && _loggers[i]._handle.isOpen())
+			{
+				_loggers[i]._handle.close();
+			}
+		}
+		if (flushTime)
+		{
+			lastFlush = now;
+		}
+
+#ifdef LOG4Z_LIMIT_ENABLE
+		//! the reports of the limited call sites are written on the next pass.
+		tickLimits(pLog, now - lastLimitTick);
+		lastLimitTick = now;
+#endif
+
+		//! quit
+		if (!_runing && _logs.empty())
+		{
+			break;
+		}
+		
+		if (_hotUpdateInterval != 0 && time(NULL) - lastCheckUpdate > _hotUpdateInterval)
+		{
+			updateConfig();
+			lastCheckUpdate = time(NULL);
+		}
+
+		//! sleep until a producer posts, the next flush, or the next config check.
+		//! buffered file logs do not post, they wait in the queue for the next flush.
+		_waiting.store(true);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (_logs.empty() && _runing)
+		{
+			int timeout = 1000;
+			if (pending || durability == LOG_DURABILITY_BUFFERED)
+			{
+				unsigned long long elapse = now - lastFlush;
+				timeout = elapse >= (unsigned long long)_flushInterval ? 1 : (int)(_flushInterval - elapse);
+				if (timeout > 1000) timeout = 1000;
+			}
+			_wakeUp.wait(timeout);
+		}
+		_waiting.store(false);
+	}
+
+	for (int i=0; i <= _lastId; i++)
+	{
+		if (_loggers[i]._enable)
+		{
+			_loggers[i]._enable = false;
+			closeLogger(i);
+		}
+	}
+	delete pLog;
+}
+
+//////////////////////////////////////////////////////////////////////////
+//ILog4zManager::getInstance
+//////////////////////////////////////////////////////////////////////////
+ILog4zManager * ILog4zManager::getInstance()
+{
+	static LogerManager m;
+	return &m;
+}
+
+
+
+_ZSUMMER_LOG4Z_END
+_ZSUMMER_END
+
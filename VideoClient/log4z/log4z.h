@@ -0,0 +1,1336 @@
+/*
+ * Log4z License
+ * -----------
+ * 
+ * Log4z is licensed under the terms of the MIT license reproduced below.
+ * This means that Log4z is free software and can be used for both academic
+ * and commercial purposes at absolutely no cost.
+ * 
+ * 
+ * ===============================================================================
+ * 
+ * Copyright (C) 2010-2014 YaweiZhang <yawei_zhang@foxmail.com>.
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * 
+ * ===============================================================================
+ * 
+ * (end of COPYRIGHT)
+ */
+
+
+/*
+ * AUTHORS:  YaweiZhang <yawei_zhang@foxmail.com>
+ * VERSION:  3.0.0
+ * PURPOSE:  A lightweight library for error reporting and logging to file and screen .
+ * CREATION: 2010.10.4
+ * LCHANGE:  2014.12.19
+ * LICENSE:  Expat/MIT License, See Copyright Notice at the begin of this file.
+ */
+
+
+/*
+ * contact me:
+ * tencent qq group: 19811947
+ * mail: yawei_zhang@foxmail.com
+ */
+
+
+/* 
+ * UPDATES LOG
+ * 
+ * VERSION 0.1.0 <DATE: 2010.10.4>
+ * 	create the first project.  
+ * 	It support put log to screen and files, 
+ * 	support log level, support one day one log file.
+ * 	support multi-thread, cross-platform.
+ * 
+ * VERSION .... <DATE: ...>
+ * 	...
+ * 
+ * VERSION 0.9.0 <DATE: 2012.12.24>
+ * 	support config files.
+ * 	support color text in screen.
+ * 	support multiple output to different files.
+ * 
+ * VERSION 1.0.0 <DATE: 2012.12.29>
+ * 	support comments in the config file.
+ * 	add a advanced demo in the ./project
+ * 	fix some details.
+ * 
+ * VERSION 1.0.1 <DATE: 2013.01.01>
+ * 	change and add some Comments in the log4z
+ * 	simplify the 'fast_test' demo projects.
+ * 
+ * VERSION 1.1.0 <DATE: 2013.01.24>
+ * 	the method Start will wait for the logger thread started.
+ * 	config and add method change. 
+ * 	namespace change.
+ * 
+ * VERSION 1.1.1 <DATE: 2013.02.23>
+ * 	add status info method.
+ * 	optimize. 
+ *
+ * VERSION 1.2.0 <DATE: 2013.04.05>
+ * 	add stress test demo
+ *  rewrite Stream module,better performance. 
+ * 
+ * VERSION 1.2.1 <DATE: 2013.04.13>
+ * 	fixed type name 'long' stream format on 64/32 operation system.
+ *  logger will not loss any log on process normal exit.
+ *
+ * VERSION 2.0.0 <DATE: 2013.04.25>
+ * 	new interface: 
+ *      merge some Main interface and Dynamic interface
+ *      add Change Logger Attribute method by thread-safe
+ * 	new config design.
+ * 	log file name append process id.
+ *
+ * VERSION 2.1 <DATE: 2013.05.22>
+ * 	support binary text output 
+ *  rewrite write file module, support vs2005 open Chinese characters path
+ *
+ * VERSION 2.2 <DATE: 2013.07.08>
+ *	optimized binary stream output view
+ * 	support wchar * string.
+ *  
+ * VERSION 2.3 <DATE: 2013.08.29>
+ *  adjust output file named.
+ *  support different month different directory.
+ *  adjust some detail.
+ * 
+ * VERSION 2.4 <DATE: 2013.10.07>
+ *  support rolling log file.
+ *  support hot update configure
+ *  used precision time in log.
+ *  micro set default logger attribute
+ *  fix tls bug in windows xp dll
+ *
+ * VERSION 2.5 <DATE: 2014.03.25>
+ *  screen output can choice synchronous or not
+ *  fix sometimes color will disorder on windows.
+ *  eliminate some compiler warning
+ *  fix sem_timewait in linux
+ *  add format-style method at input log, cannot support vs2003 and VC6.
+ *  fix WCHAR String cannot output
+ *  optimize std::string, binary log input, and support std::wstring.
+ *  clean code, better readability
+ *  
+ * VERSION 2.6 <DATE: 2014.08.19>
+ *  add PrePushLog 
+ *  better performance when log is filter out.
+ *  interface replace std::string because it's in shared library is unsafe.
+ *  add log level 'trace'
+ * 
+ * VERSION 2.6.1 <DATE: 2014.08.22>
+ *  fix bug from defined _MSC_VER 
+ *
+ * VERSION 2.7 <DATE: 2014.09.21>
+ *  compatible mac machine,  now  log4z can working in linux/windows/mac.
+ *
+ * VERSION 2.8 <DATE: 2014.09.27>
+ *  support synchronous written to file and thread-safe
+ *  fix compatibility on MinGW. a constant value suffix.
+ *  ignore utf-8 file BOM when load configure file
+ *  use macro WIN32_LEAN_AND_MEAN replace head file winsock2.h
+ *  new naming notations
+ * 
+ * VERSION 3.0 <DATE: 2014.12.19>
+ *  new naming notations
+ *  support for reading config from a string.
+ *  remove all TLS code, used dispatch_semaphore in apple OS.
+ *  support system: windows, linux, mac, iOS
+ *  
+ */
+
+
+#pragma once
+#ifndef _ZSUMMER_LOG4Z_H_
+#define _ZSUMMER_LOG4Z_H_
+
+#include <string>
+#include <sstream>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#ifdef WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#elif defined(__APPLE__)
+#include <pthread.h>
+#include <dispatch/dispatch.h>
+#else
+#include <pthread.h>
+#include <semaphore.h>
+#endif
+
+//! logger ID type. DO NOT TOUCH
+typedef int LoggerId;
+
+//! the invalid logger id. DO NOT TOUCH
+const int LOG4Z_INVALID_LOGGER_ID = -1;
+
+//! the main logger id. DO NOT TOUCH
+//! can use this id to set the main logger's attribute.
+//! example:
+//! ILog4zManager::getPtr()->setLoggerLevel(LOG4Z_MAIN_LOGGER_ID, LOG_LEVEL_WARN);
+//! ILog4zManager::getPtr()->setLoggerDisplay(LOG4Z_MAIN_LOGGER_ID, false);
+const int LOG4Z_MAIN_LOGGER_ID = 0;
+
+//! the main logger name. DO NOT TOUCH
+const char*const LOG4Z_MAIN_LOGGER_KEY = "Main";
+
+//! check VC VERSION. DO NOT TOUCH
+//! format micro cannot support VC6 or VS2003, please use stream input log, like LOGI, LOGD, LOG_DEBUG, LOG_STREAM ...
+#if _MSC_VER >= 1400 //MSVC >= VS2005
+#define LOG4Z_FORMAT_INPUT_ENABLE
+#endif
+
+#ifndef WIN32
+#define LOG4Z_FORMAT_INPUT_ENABLE
+#endif
+
+//! binary input needs variadic templates and thread-safe local static initialization.
+#if _MSC_VER >= 1900 //MSVC >= VS2015
+#define LOG4Z_BINARY_INPUT_ENABLE
+#endif
+
+#if !defined(WIN32) && __cplusplus >= 201103L
+#define LOG4Z_BINARY_INPUT_ENABLE
+#endif
+
+//! call site rate limit and sampling need std::atomic and constexpr, same as binary input.
+#ifdef LOG4Z_BINARY_INPUT_ENABLE
+#define LOG4Z_LIMIT_ENABLE
+#include <atomic>
+#include <time.h>
+#endif
+
+//! LOG Level
+enum ENUM_LOG_LEVEL
+{
+	LOG_LEVEL_TRACE = 0,
+	LOG_LEVEL_DEBUG,
+	LOG_LEVEL_INFO,
+	LOG_LEVEL_WARN,
+	LOG_LEVEL_ERROR,
+	LOG_LEVEL_ALARM,
+	LOG_LEVEL_FATAL,
+};
+
+//! what pushLog does when the log queue is full.
+enum ENUM_LOG_OVERFLOW
+{
+	LOG_OVERFLOW_DROP_NEWEST = 0,	//discard the record being pushed
+	LOG_OVERFLOW_DROP_OLDEST,		//discard the oldest waiting records to make room
+	LOG_OVERFLOW_BLOCK,				//wait for the log thread to make room
+};
+
+//! when the log thread hands the buffered records of a log file to the system.
+enum ENUM_LOG_DURABILITY
+{
+	LOG_DURABILITY_BUFFERED = 0,	//write when the file buffer is full or the flush interval elapses
+	LOG_DURABILITY_WAKEUP,			//write at the end of every log thread wakeup
+	LOG_DURABILITY_SYNC,			//write and sync to the disk at the end of every log thread wakeup
+};
+
+//////////////////////////////////////////////////////////////////////////
+//! -----------------default logger config, can change on this.-----------
+//////////////////////////////////////////////////////////////////////////
+//! the max logger count.
+const int LOG4Z_LOGGER_MAX = 10;
+//! the max log content length.
+const int LOG4Z_LOG_BUF_SIZE = 2048;
+//! the max count of binary log call sites.
+const int LOG4Z_FORMAT_MAX = 4096;
+//! the log queue slot count, must be a power of 2.
+const int LOG4Z_LOG_QUEUE_SLOTS = 8192;
+//! the log queue slot size, unit byte. one record takes as many continuous slots as its length needs.
+const int LOG4Z_LOG_QUEUE_SLOT_SIZE = 128;
+//! default overflow policy when the log queue is full.
+const int LOG4Z_DEFAULT_OVERFLOW = LOG_OVERFLOW_DROP_NEWEST;
+//! the write buffer size of one log file, unit byte. the log thread writes it with one system call.
+const int LOG4Z_WRITE_BUFFER_SIZE = 64*1024;
+//! default flush interval of the buffered log files, unit millisecond.
+const int LOG4Z_DEFAULT_FLUSH_INTERVAL = 100;
+//! default durability of the log files.
+const int LOG4Z_DEFAULT_DURABILITY = LOG_DURABILITY_BUFFERED;
+
+//! all logger synchronous output or not. define LOG4Z_SYNCHRONOUS_OUTPUT to build it in, see log4zbench.
+#ifdef LOG4Z_SYNCHRONOUS_OUTPUT
+const bool LOG4Z_ALL_SYNCHRONOUS_OUTPUT = true;
+#else
+const bool LOG4Z_ALL_SYNCHRONOUS_OUTPUT = false;
+#endif
+//! all logger synchronous display to the windows debug output
+const bool LOG4Z_ALL_DEBUGOUTPUT_DISPLAY = false;
+
+//! default logger output file.
+const char* const LOG4Z_DEFAULT_PATH = "./log/";
+//! default log filter level
+const int LOG4Z_DEFAULT_LEVEL = LOG_LEVEL_DEBUG;
+//! default logger display
+const bool LOG4Z_DEFAULT_DISPLAY = true;
+//! default logger output to file
+const bool LOG4Z_DEFAULT_OUTFILE = true;
+//! default logger month dir used status
+const bool LOG4Z_DEFAULT_MONTHDIR = false;
+//! default logger output file limit size, unit M byte.
+const int LOG4Z_DEFAULT_LIMITSIZE = 100;
+//! default logger show suffix (file name and line number) 
+const bool LOG4Z_DEFAULT_SHOWSUFFIX = true;
+//! default logger writes binary input as is to a *.blog file, see log4zdecoder.
+const bool LOG4Z_DEFAULT_BINARY = false;
+//! default logger compresses its rolled files to *.gz on the maintain thread.
+const bool LOG4Z_DEFAULT_COMPRESS = true;
+//! default logger keeps its files under this total size, unit M byte. 0 is no limit.
+const unsigned int LOG4Z_DEFAULT_RESERVE_SIZE = 1024;
+//! default logger removes its files older than this, unit day. 0 is no limit.
+const unsigned int LOG4Z_DEFAULT_RESERVE_DAYS = 90;
+//! default logger writes its *.log file through a memory map, for the high volume loggers.
+const bool LOG4Z_DEFAULT_MMAP = false;
+//! the mapped window of a mapped log file, the file grows by it. unit byte.
+const unsigned int LOG4Z_MMAP_EXTEND_SIZE = 4*1024*1024;
+
+///////////////////////////////////////////////////////////////////////////
+//! -----------------------------------------------------------------------
+//////////////////////////////////////////////////////////////////////////
+
+
+
+
+
+#ifndef _ZSUMMER_BEGIN
+#define _ZSUMMER_BEGIN namespace zsummer {
+#endif  
+#ifndef _ZSUMMER_LOG4Z_BEGIN
+#define _ZSUMMER_LOG4Z_BEGIN namespace log4z {
+#endif
+_ZSUMMER_BEGIN
+_ZSUMMER_LOG4Z_BEGIN
+
+
+//////////////////////////////////////////////////////////////////////////
+//! UTILITY
+//////////////////////////////////////////////////////////////////////////
+extern void sleepMillisecond(unsigned int ms);
+extern tm timeToTm(time_t t);
+extern bool isSameDay(time_t t1, time_t t2);
+extern void fixPath(std::string &path);
+extern void trimLogConfig(std::string &str, std::string extIgnore = std::string());
+extern void splitStdString(std::vector<std::string>& dst, const std::string& str, const std::string & delimiter);
+extern std::pair<std::string, std::string> splitPairString(const std::string & str, const std::string & delimiter);
+extern bool isDirectory(std::string path);
+extern bool createRecursionDir(std::string path);
+extern std::string getProcessID();
+extern std::string getProcessName();
+extern std::string getProcessPath();
+
+
+//////////////////////////////////////////////////////////////////////////
+//! LockHelper
+//////////////////////////////////////////////////////////////////////////
+class LockHelper
+{
+public:
+	LockHelper();
+	virtual ~LockHelper();
+
+public:
+	void lock();
+	void unLock();
+private:
+#ifdef WIN32
+	CRITICAL_SECTION _crit;
+#else
+	pthread_mutex_t  _crit;
+#endif
+};
+
+//////////////////////////////////////////////////////////////////////////
+//! AutoLock
+//////////////////////////////////////////////////////////////////////////
+class AutoLock
+{
+public:
+	explicit AutoLock(LockHelper & lk) :_lock(lk){ _lock.lock(); }
+	~AutoLock(){ _lock.unLock(); }
+private:
+	LockHelper & _lock;
+};
+
+//////////////////////////////////////////////////////////////////////////
+//! SemHelper
+//////////////////////////////////////////////////////////////////////////
+class SemHelper
+{
+public:
+	SemHelper();
+	virtual ~SemHelper();
+public:
+	bool create(int initcount);
+	bool wait(int timeout = 0);
+	bool post();
+private:
+#ifdef WIN32
+	HANDLE _hSem;
+#elif defined(__APPLE__)
+	dispatch_semaphore_t _semid;
+#else
+	sem_t _semid;
+	bool  _isCreate;
+#endif
+
+};
+
+
+
+//////////////////////////////////////////////////////////////////////////
+//! ThreadHelper
+//////////////////////////////////////////////////////////////////////////
+class ThreadHelper
+{
+public:
+	ThreadHelper() : _hThreadID(0), _nExitFlag(0){}
+	virtual ~ThreadHelper(){}
+public:
+	bool start();
+	bool wait();
+	bool wait(int timeout);
+	bool stop(int timeout = 3000);
+	virtual void run() = 0;
+
+public:
+	unsigned int _nExitFlag;
+
+protected:
+	unsigned long long _hThreadID;
+	SemHelper _hSemHelper;
+#ifndef WIN32
+	pthread_t _phtreadID;
+#endif
+};
+
+#ifdef LOG4Z_LIMIT_ENABLE
+class Log4zLimit;
+#endif
+
+//! log4z class
+class ILog4zManager
+{
+public:
+	ILog4zManager(){};
+	virtual ~ILog4zManager(){};
+
+	//! Log4z Singleton
+	
+	static ILog4zManager * getInstance();
+	inline static ILog4zManager & getRef(){return *getInstance();}
+	inline static ILog4zManager * getPtr(){return getInstance();}
+
+	//! Config or overwrite configure
+	//! Needs to be called before ILog4zManager::Start,, OR Do not call.
+	virtual bool config(const char * configPath) = 0;
+	virtual bool configFromString(const char * configContent) = 0;
+
+	//! Create or overwrite logger.
+	//! Needs to be called before ILog4zManager::Start, OR Do not call.
+	virtual LoggerId createLogger(const char* key) = 0;
+
+	//! Start Log Thread. This method can only be called once by one process.
+	virtual bool start() = 0;
+
+	//! Default the method will be calling at process exit auto.
+	//! Default no need to call and no recommended.
+	virtual bool stop() = 0;
+
+	//! Find logger. thread safe.
+	virtual LoggerId findLogger(const char* key) =0;
+
+	//pre-check the log filter. if filter out return false. 
+	virtual bool prePushLog(LoggerId id, int level) = 0;
+	//! Push log, thread safe.
+	virtual bool pushLog(LoggerId id, int level, const char * log, const char * file = NULL, int line = 0) = 0;
+
+	//! Register the format of a binary log call site, thread safe. 
+	//! format and file must be string literals. return the format id or -1 when LOG4Z_FORMAT_MAX is reached.
+	virtual int registerFormat(const char * format, const char * file, int line) = 0;
+	//! Push binary log, the arguments are packed by Log4zArgs. thread safe.
+	virtual bool pushBinaryLog(LoggerId id, int level, int formatId, const char * args, int argsLen) = 0;
+#ifdef LOG4Z_LIMIT_ENABLE
+	//! Register a limited call site, thread safe. the log thread refills its bucket and reports its suppressed records.
+	//! return false when the log thread is not running.
+	virtual bool registerLimit(Log4zLimit * site) = 0;
+#endif
+
+	//! set logger's attribute, thread safe.
+	virtual bool enableLogger(LoggerId id, bool enable) = 0;
+	virtual bool setLoggerName(LoggerId id, const char * name) = 0;
+	virtual bool setLoggerPath(LoggerId id, const char * path) = 0;
+	virtual bool setLoggerLevel(LoggerId id, int nLevel) = 0;
+	virtual bool setLoggerFileLine(LoggerId id, bool enable) = 0;
+	virtual bool setLoggerDisplay(LoggerId id, bool enable) = 0;
+	virtual bool setLoggerOutFile(LoggerId id, bool enable) = 0;
+	virtual bool setLoggerLimitsize(LoggerId id, unsigned int limitsize) = 0;
+	virtual bool setLoggerMonthdir(LoggerId id, bool enable) = 0;
+	virtual bool setLoggerBinary(LoggerId id, bool enable) = 0;
+	virtual bool setLoggerCompress(LoggerId id, bool enable) = 0;
+	virtual bool setLoggerReserveSize(LoggerId id, unsigned int reserveSize) = 0;
+	virtual bool setLoggerReserveDays(LoggerId id, unsigned int reserveDays) = 0;
+	virtual bool setLoggerMmap(LoggerId id, bool enable) = 0;
+	//! set the log queue overflow policy, ENUM_LOG_OVERFLOW. thread safe.
+	virtual bool setOverflowPolicy(int policy) = 0;
+	//! set the flush interval of the buffered log files, unit millisecond. thread safe.
+	virtual bool setFlushInterval(int interval) = 0;
+	//! set the durability of the log files, ENUM_LOG_DURABILITY. thread safe.
+	virtual bool setDurability(int durability) = 0;
+	
+
+	//! Update logger's attribute from config file, thread safe.
+	virtual bool setAutoUpdate(int interval/*per second, 0 is disable auto update*/) = 0;
+	virtual bool updateConfig() = 0;
+
+	//! Log4z status statistics, thread safe.
+	//! the records pushed while the log thread does not run are dropped.
+	virtual bool isRunning() = 0;
+	virtual bool isLoggerEnable(LoggerId id) = 0;
+	virtual unsigned long long getStatusTotalWriteCount() = 0;
+	virtual unsigned long long getStatusTotalWriteBytes() = 0;
+	virtual unsigned long long getStatusWaitingCount() = 0;
+	virtual unsigned long long getStatusTotalDropNewestCount() = 0;
+	virtual unsigned long long getStatusTotalDropOldestCount() = 0;
+	virtual unsigned int getStatusActiveLoggers() = 0;
+};
+
+class Log4zStream;
+class Log4zBinary;
+class Log4zArgs;
+class Log4zLimit;
+
+#ifndef _ZSUMMER_END
+#define _ZSUMMER_END }
+#endif  
+#ifndef _ZSUMMER_LOG4Z_END
+#define _ZSUMMER_LOG4Z_END }
+#endif
+
+_ZSUMMER_LOG4Z_END
+_ZSUMMER_END
+
+
+
+//! base micro.
+#define LOG_STREAM(id, level, log)\
+{\
+	if (zsummer::log4z::ILog4zManager::getPtr()->prePushLog(id,level)) \
+	{\
+		char logBuf[LOG4Z_LOG_BUF_SIZE];\
+		zsummer::log4z::Log4zStream ss(logBuf, LOG4Z_LOG_BUF_SIZE);\
+		ss << log;\
+		zsummer::log4z::ILog4zManager::getPtr()->pushLog(id, level, logBuf, __FILE__, __LINE__);\
+	}\
+}
+
+
+//! fast micro
+#define LOG_TRACE(id, log) LOG_STREAM(id, LOG_LEVEL_TRACE, log)
+#define LOG_DEBUG(id, log) LOG_STREAM(id, LOG_LEVEL_DEBUG, log)
+#define LOG_INFO(id, log)  LOG_STREAM(id, LOG_LEVEL_INFO, log)
+#define LOG_WARN(id, log)  LOG_STREAM(id, LOG_LEVEL_WARN, log)
+#define LOG_ERROR(id, log) LOG_STREAM(id, LOG_LEVEL_ERROR, log)
+#define LOG_ALARM(id, log) LOG_STREAM(id, LOG_LEVEL_ALARM, log)
+#define LOG_FATAL(id, log) LOG_STREAM(id, LOG_LEVEL_FATAL, log)
+
+//! super micro.
+#define LOGT( log ) LOG_TRACE(LOG4Z_MAIN_LOGGER_ID, log )
+#define LOGD( log ) LOG_DEBUG(LOG4Z_MAIN_LOGGER_ID, log )
+#define LOGI( log ) LOG_INFO(LOG4Z_MAIN_LOGGER_ID, log )
+#define LOGW( log ) LOG_WARN(LOG4Z_MAIN_LOGGER_ID, log )
+#define LOGE( log ) LOG_ERROR(LOG4Z_MAIN_LOGGER_ID, log )
+#define LOGA( log ) LOG_ALARM(LOG4Z_MAIN_LOGGER_ID, log )
+#define LOGF( log ) LOG_FATAL(LOG4Z_MAIN_LOGGER_ID, log )
+
+
+//! format input log.
+#ifdef LOG4Z_FORMAT_INPUT_ENABLE
+#ifdef WIN32
+#define LOG_FORMAT(id, level, logformat, ...) \
+{ \
+	if (zsummer::log4z::ILog4zManager::getPtr()->prePushLog(id,level)) \
+	{\
+		char logbuf[LOG4Z_LOG_BUF_SIZE]; \
+		_snprintf_s(logbuf, LOG4Z_LOG_BUF_SIZE, _TRUNCATE, logformat, ##__VA_ARGS__); \
+		zsummer::log4z::ILog4zManager::getPtr()->pushLog(id, level, logbuf, __FILE__, __LINE__); \
+	}\
+ }
+#else
+#define LOG_FORMAT(id, level, logformat, ...) \
+{ \
+	if (zsummer::log4z::ILog4zManager::getPtr()->prePushLog(id,level)) \
+	{\
+		char logbuf[LOG4Z_LOG_BUF_SIZE]; \
+		snprintf(logbuf, LOG4Z_LOG_BUF_SIZE,logformat, ##__VA_ARGS__); \
+		zsummer::log4z::ILog4zManager::getPtr()->pushLog(id, level, logbuf, __FILE__, __LINE__); \
+	} \
+}
+#endif
+//!format string
+#define LOGFMT_TRACE(id, fmt, ...)  LOG_FORMAT(id, LOG_LEVEL_TRACE, fmt, ##__VA_ARGS__)
+#define LOGFMT_DEBUG(id, fmt, ...)  LOG_FORMAT(id, LOG_LEVEL_DEBUG, fmt, ##__VA_ARGS__)
+#define LOGFMT_INFO(id, fmt, ...)  LOG_FORMAT(id, LOG_LEVEL_INFO, fmt, ##__VA_ARGS__)
+#define LOGFMT_WARN(id, fmt, ...)  LOG_FORMAT(id, LOG_LEVEL_WARN, fmt, ##__VA_ARGS__)
+#define LOGFMT_ERROR(id, fmt, ...)  LOG_FORMAT(id, LOG_LEVEL_ERROR, fmt, ##__VA_ARGS__)
+#define LOGFMT_ALARM(id, fmt, ...)  LOG_FORMAT(id, LOG_LEVEL_ALARM, fmt, ##__VA_ARGS__)
+#define LOGFMT_FATAL(id, fmt, ...)  LOG_FORMAT(id, LOG_LEVEL_FATAL, fmt, ##__VA_ARGS__)
+#define LOGFMTT( fmt, ...) LOGFMT_TRACE(LOG4Z_MAIN_LOGGER_ID, fmt,  ##__VA_ARGS__)
+#define LOGFMTD( fmt, ...) LOGFMT_DEBUG(LOG4Z_MAIN_LOGGER_ID, fmt,  ##__VA_ARGS__)
+#define LOGFMTI( fmt, ...) LOGFMT_INFO(LOG4Z_MAIN_LOGGER_ID, fmt,  ##__VA_ARGS__)
+#define LOGFMTW( fmt, ...) LOGFMT_WARN(LOG4Z_MAIN_LOGGER_ID, fmt,  ##__VA_ARGS__)
+#define LOGFMTE( fmt, ...) LOGFMT_ERROR(LOG4Z_MAIN_LOGGER_ID, fmt,  ##__VA_ARGS__)
+#define LOGFMTA( fmt, ...) LOGFMT_ALARM(LOG4Z_MAIN_LOGGER_ID, fmt,  ##__VA_ARGS__)
+#define LOGFMTF( fmt, ...) LOGFMT_FATAL(LOG4Z_MAIN_LOGGER_ID, fmt,  ##__VA_ARGS__)
+#else
+inline void empty_log_format_function1(LoggerId id, const char*, ...){}
+inline void empty_log_format_function2(const char*, ...){}
+#define LOGFMT_TRACE empty_log_format_function1
+#define LOGFMT_DEBUG LOGFMT_TRACE
+#define LOGFMT_INFO LOGFMT_TRACE
+#define LOGFMT_WARN LOGFMT_TRACE
+#define LOGFMT_ERROR LOGFMT_TRACE
+#define LOGFMT_ALARM LOGFMT_TRACE
+#define LOGFMT_FATAL LOGFMT_TRACE
+#define LOGFMTT empty_log_format_function2
+#define LOGFMTD LOGFMTT
+#define LOGFMTI LOGFMTT
+#define LOGFMTW LOGFMTT
+#define LOGFMTE LOGFMTT
+#define LOGFMTA LOGFMTT
+#define LOGFMTF LOGFMTT
+#endif
+
+
+//! binary input log. only a format id, a tick and the raw arguments are pushed,
+//! the log thread does the formatting. logformat must be a string literal.
+#ifdef LOG4Z_BINARY_INPUT_ENABLE
+#define LOG_BINARY(id, level, logformat, ...) \
+{ \
+	if (zsummer::log4z::ILog4zManager::getPtr()->prePushLog(id,level)) \
+	{\
+		static const int log4zFormatId = zsummer::log4z::ILog4zManager::getPtr()->registerFormat(logformat, __FILE__, __LINE__); \
+		char logbuf[LOG4Z_LOG_BUF_SIZE]; \
+		zsummer::log4z::Log4zArgs log4zArgs(logbuf, LOG4Z_LOG_BUF_SIZE); \
+		zsummer::log4z::packBinaryArgs(log4zArgs, ##__VA_ARGS__); \
+		zsummer::log4z::ILog4zManager::getPtr()->pushBinaryLog(id, level, log4zFormatId, logbuf, log4zArgs.getCurrentLen()); \
+	}\
+}
+#else
+#define LOG_BINARY LOG_FORMAT
+#endif
+#define LOGBIN_TRACE(id, fmt, ...)  LOG_BINARY(id, LOG_LEVEL_TRACE, fmt, ##__VA_ARGS__)
+#define LOGBIN_DEBUG(id, fmt, ...)  LOG_BINARY(id, LOG_LEVEL_DEBUG, fmt, ##__VA_ARGS__)
+#define LOGBIN_INFO(id, fmt, ...)  LOG_BINARY(id, LOG_LEVEL_INFO, fmt, ##__VA_ARGS__)
+#define LOGBIN_WARN(id, fmt, ...)  LOG_BINARY(id, LOG_LEVEL_WARN, fmt, ##__VA_ARGS__)
+#define LOGBIN_ERROR(id, fmt, ...)  LOG_BINARY(id, LOG_LEVEL_ERROR, fmt, ##__VA_ARGS__)
+#define LOGBIN_ALARM(id, fmt, ...)  LOG_BINARY(id, LOG_LEVEL_ALARM, fmt, ##__VA_ARGS__)
+#define LOGBIN_FATAL(id, fmt, ...)  LOG_BINARY(id, LOG_LEVEL_FATAL, fmt, ##__VA_ARGS__)
+#define LOGBINT( fmt, ...) LOGBIN_TRACE(LOG4Z_MAIN_LOGGER_ID, fmt,  ##__VA_ARGS__)
+#define LOGBIND( fmt, ...) LOGBIN_DEBUG(LOG4Z_MAIN_LOGGER_ID, fmt,  ##__VA_ARGS__)
+#define LOGBINI( fmt, ...) LOGBIN_INFO(LOG4Z_MAIN_LOGGER_ID, fmt,  ##__VA_ARGS__)
+#define LOGBINW( fmt, ...) LOGBIN_WARN(LOG4Z_MAIN_LOGGER_ID, fmt,  ##__VA_ARGS__)
+#define LOGBINE( fmt, ...) LOGBIN_ERROR(LOG4Z_MAIN_LOGGER_ID, fmt,  ##__VA_ARGS__)
+#define LOGBINA( fmt, ...) LOGBIN_ALARM(LOG4Z_MAIN_LOGGER_ID, fmt,  ##__VA_ARGS__)
+#define LOGBINF( fmt, ...) LOGBIN_FATAL(LOG4Z_MAIN_LOGGER_ID, fmt,  ##__VA_ARGS__)
+
+
+//! call site limited format input log, for hot paths.
+//! LOG_FORMAT_LIMIT passes limit records per second with bursts of up to limit, LOG_FORMAT_SAMPLE passes 1 of every limit records.
+//! the log thread writes a line with the count a call site suppressed on its next tick, within a second.
+#ifdef LOG4Z_LIMIT_ENABLE
+#define LOG_FORMAT_LIMITED(id, level, sample, limit, logformat, ...) \
+{ \
+	if (zsummer::log4z::ILog4zManager::getPtr()->prePushLog(id,level)) \
+	{\
+		static zsummer::log4z::Log4zLimit log4zLimit(__FILE__, __LINE__); \
+		if (log4zLimit.pass(id, level, sample, limit)) \
+		{\
+			LOG_FORMAT(id, level, logformat, ##__VA_ARGS__); \
+		}\
+	}\
+}
+#define LOG_FORMAT_LIMIT(id, level, limit, logformat, ...) LOG_FORMAT_LIMITED(id, level, false, limit, logformat, ##__VA_ARGS__)
+#define LOG_FORMAT_SAMPLE(id, level, limit, logformat, ...) LOG_FORMAT_LIMITED(id, level, true, limit, logformat, ##__VA_ARGS__)
+#else
+#define LOG_FORMAT_LIMIT(id, level, limit, logformat, ...) LOG_FORMAT(id, level, logformat, ##__VA_ARGS__)
+#define LOG_FORMAT_SAMPLE(id, level, limit, logformat, ...) LOG_FORMAT(id, level, logformat, ##__VA_ARGS__)
+#endif
+#define LOGFMTT_LIMIT(limit, fmt, ...) LOG_FORMAT_LIMIT(LOG4Z_MAIN_LOGGER_ID, LOG_LEVEL_TRACE, limit, fmt, ##__VA_ARGS__)
+#define LOGFMTD_LIMIT(limit, fmt, ...) LOG_FORMAT_LIMIT(LOG4Z_MAIN_LOGGER_ID, LOG_LEVEL_DEBUG, limit, fmt, ##__VA_ARGS__)
+#define LOGFMTI_LIMIT(limit, fmt, ...) LOG_FORMAT_LIMIT(LOG4Z_MAIN_LOGGER_ID, LOG_LEVEL_INFO, limit, fmt, ##__VA_ARGS__)
+#define LOGFMTW_LIMIT(limit, fmt, ...) LOG_FORMAT_LIMIT(LOG4Z_MAIN_LOGGER_ID, LOG_LEVEL_WARN, limit, fmt, ##__VA_ARGS__)
+#define LOGFMTE_LIMIT(limit, fmt, ...) LOG_FORMAT_LIMIT(LOG4Z_MAIN_LOGGER_ID, LOG_LEVEL_ERROR, limit, fmt, ##__VA_ARGS__)
+#define LOGFMTA_LIMIT(limit, fmt, ...) LOG_FORMAT_LIMIT(LOG4Z_MAIN_LOGGER_ID, LOG_LEVEL_ALARM, limit, fmt, ##__VA_ARGS__)
+#define LOGFMTF_LIMIT(limit, fmt, ...) LOG_FORMAT_LIMIT(LOG4Z_MAIN_LOGGER_ID, LOG_LEVEL_FATAL, limit, fmt, ##__VA_ARGS__)
+#define LOGFMTT_SAMPLE(limit, fmt, ...) LOG_FORMAT_SAMPLE(LOG4Z_MAIN_LOGGER_ID, LOG_LEVEL_TRACE, limit, fmt, ##__VA_ARGS__)
+#define LOGFMTD_SAMPLE(limit, fmt, ...) LOG_FORMAT_SAMPLE(LOG4Z_MAIN_LOGGER_ID, LOG_LEVEL_DEBUG, limit, fmt, ##__VA_ARGS__)
+#define LOGFMTI_SAMPLE(limit, fmt, ...) LOG_FORMAT_SAMPLE(LOG4Z_MAIN_LOGGER_ID, LOG_LEVEL_INFO, limit, fmt, ##__VA_ARGS__)
+#define LOGFMTW_SAMPLE(limit, fmt, ...) LOG_FORMAT_SAMPLE(LOG4Z_MAIN_LOGGER_ID, LOG_LEVEL_WARN, limit, fmt, ##__VA_ARGS__)
+#define LOGFMTE_SAMPLE(limit, fmt, ...) LOG_FORMAT_SAMPLE(LOG4Z_MAIN_LOGGER_ID, LOG_LEVEL_ERROR, limit, fmt, ##__VA_ARGS__)
+#define LOGFMTA_SAMPLE(limit, fmt, ...) LOG_FORMAT_SAMPLE(LOG4Z_MAIN_LOGGER_ID, LOG_LEVEL_ALARM, limit, fmt, ##__VA_ARGS__)
+#define LOGFMTF_SAMPLE(limit, fmt, ...) LOG_FORMAT_SAMPLE(LOG4Z_MAIN_LOGGER_ID, LOG_LEVEL_FATAL, limit, fmt, ##__VA_ARGS__)
+
+
+_ZSUMMER_BEGIN
+_ZSUMMER_LOG4Z_BEGIN
+
+//! optimze from std::stringstream to Log4zStream
+#ifdef WIN32
+#pragma warning(push)
+#pragma warning(disable:4996)
+#endif
+class Log4zBinary
+{
+public:
+	Log4zBinary(const char * buf, int len)
+	{
+		_buf = buf;
+		_len = len;
+	}
+	const char * _buf;
+	int  _len;
+};
+class Log4zStream
+{
+public:
+	inline Log4zStream(char * buf, int len);
+	inline int getCurrentLen(){return (int)(_cur - _begin);}
+private:
+	template<class T>
+	inline Log4zStream & writeData(const char * ft, T t);
+	inline Log4zStream & writeLongLong(long long t);
+	inline Log4zStream & writeULongLong(unsigned long long t);
+	inline Log4zStream & writePointer(const void * t);
+	inline Log4zStream & writeString(const wchar_t* t){ return writeData("%s", t); }
+	inline Log4zStream & writeWString(const wchar_t* t);
+	inline Log4zStream & writeBinary(const Log4zBinary & t);
+public:
+	inline Log4zStream & operator <<(const void * t){ return  writePointer(t); }
+
+	inline Log4zStream & operator <<(const char * t){return writeData("%s", t);}
+#ifdef WIN32
+	inline Log4zStream & operator <<(const wchar_t * t){ return writeWString(t);}
+#endif
+	inline Log4zStream & operator <<(bool t){ return (t ? writeData("%s", "true") : writeData("%s", "false"));}
+
+	inline Log4zStream & operator <<(char t){return writeData("%c", t);}
+
+	inline Log4zStream & operator <<(unsigned char t){return writeData("%u",(unsigned int)t);}
+
+	inline Log4zStream & operator <<(short t){ return writeData("%d", (int)t); }
+
+	inline Log4zStream & operator <<(unsigned short t){ return writeData("%u", (unsigned int)t); }
+
+	inline Log4zStream & operator <<(int t){return writeData("%d", t);}
+
+	inline Log4zStream & operator <<(unsigned int t){return writeData("%u", t);}
+
+	inline Log4zStream & operator <<(long t) { return writeLongLong(t); }
+
+	inline Log4zStream & operator <<(unsigned long t){ return writeULongLong(t); }
+
+	inline Log4zStream & operator <<(long long t) { return writeLongLong(t); }
+
+	inline Log4zStream & operator <<(unsigned long long t){ return writeULongLong(t); }
+
+	inline Log4zStream & operator <<(float t){return writeData("%.4f", t);}
+
+	inline Log4zStream & operator <<(double t){return writeData("%.4lf", t);}
+
+	template<class _Elem,class _Traits,class _Alloc> //support std::string, std::wstring
+	inline Log4zStream & operator <<(const std::basic_string<_Elem, _Traits, _Alloc> & t){ return *this << t.c_str(); }
+
+	inline Log4zStream & operator << (const zsummer::log4z::Log4zBinary & binary){ return writeBinary(binary); }
+
+private:
+	Log4zStream(){}
+	Log4zStream(Log4zStream &){}
+	char *  _begin;
+	char *  _end;
+	char *  _cur;
+};
+
+inline Log4zStream::Log4zStream(char * buf, int len)
+{
+	_begin = buf;
+	_end = buf + len;
+	_cur = _begin;
+}
+
+template<class T>
+inline Log4zStream& Log4zStream::writeData(const char * ft, T t)
+{
+	if (_cur < _end)
+	{
+		int len = 0;
+		int count = (int)(_end - _cur);
+#ifdef WIN32
+		len = _snprintf(_cur, count, ft, t);
+		if (len == count || (len == -1 && errno == ERANGE))
+		{
+			len = count;
+			*(_end - 1) = '\0';
+		}
+		else if (len < 0)
+		{
+			*_cur = '\0';
+			len = 0;
+		}
+#else
+		len = snprintf(_cur, count, ft, t);
+		if (len < 0)
+		{
+			*_cur = '\0';
+			len = 0;
+		}
+		else if (len >= count)
+		{
+			len = count;
+			*(_end - 1) = '\0';
+		}
+#endif
+		_cur += len;
+	}
+	return *this;
+}
+
+inline Log4zStream & Log4zStream::writeLongLong(long long t)
+{
+#ifdef WIN32  
+	writeData("%I64d", t);
+#else
+	writeData("%lld", t);
+#endif
+	return *this;
+}
+
+inline Log4zStream & Log4zStream::writeULongLong(unsigned long long t)
+{
+#ifdef WIN32  
+	writeData("%I64u", t);
+#else
+	writeData("%llu", t);
+#endif
+	return *this;
+}
+
+inline Log4zStream & Log4zStream::writePointer(const void * t)
+{
+#ifdef WIN32
+	sizeof(t) == 8 ? writeData("%016I64x", (unsigned long long)t) : writeData("%08I64x", (unsigned long long)t);
+#else
+	sizeof(t) == 8 ? writeData("%016llx", (unsigned long long)t) : writeData("%08llx", (unsigned long long)t);
+#endif
+	return *this;
+}
+
+inline Log4zStream & Log4zStream::writeBinary(const Log4zBinary & t)
+{
+	writeData("%s", "\r\n\t[");
+	for (int i = 0; i < t._len; i++)
+	{
+		if (i % 16 == 0)
+		{
+			writeData("%s", "\r\n\t");
+			*this << (void*)(t._buf + i);
+			writeData("%s", ": ");
+		}
+		writeData("%02x ", (unsigned char)t._buf[i]);
+	}
+	writeData("%s", "\r\n\t]\r\n\t");
+	return *this;
+}
+
+inline zsummer::log4z::Log4zStream & zsummer::log4z::Log4zStream::writeWString(const wchar_t* t)
+{
+#ifdef WIN32
+	DWORD dwLen = WideCharToMultiByte(CP_ACP, 0, t, -1, NULL, 0, NULL, NULL);
+	if (dwLen < LOG4Z_LOG_BUF_SIZE)
+	{
+		std::string str;
+		str.resize(dwLen, '\0');
+		dwLen = WideCharToMultiByte(CP_ACP, 0, t, -1, &str[0], dwLen, NULL, NULL);
+		if (dwLen > 0)
+		{
+			writeData("%s", str.c_str());
+		}
+	}
+#else
+	//not support
+#endif
+	return *this;
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+//! Log4zArgs
+//! pack the arguments of a binary input log as [type][value] items:
+//! integers and pointers take 8 bytes, strings take a 2 bytes length and their bytes with the terminating zero.
+//////////////////////////////////////////////////////////////////////////
+enum ENUM_LOG4Z_ARG
+{
+	LOG4Z_ARG_INT = 'i',
+	LOG4Z_ARG_UINT = 'u',
+	LOG4Z_ARG_DOUBLE = 'f',
+	LOG4Z_ARG_POINTER = 'p',
+	LOG4Z_ARG_STRING = 's',
+};
+
+class Log4zArgs
+{
+public:
+	inline Log4zArgs(char * buf, int len){ _begin = buf; _end = buf + len; _cur = buf; }
+	inline int getCurrentLen(){ return (int)(_cur - _begin); }
+private:
+	template<class T>
+	inline Log4zArgs & writeValue(char type, T t);
+	inline Log4zArgs & writeString(const char * t);
+public:
+	inline Log4zArgs & operator <<(const void * t){ return writeValue(LOG4Z_ARG_POINTER, (unsigned long long)(size_t)t); }
+	inline Log4zArgs & operator <<(const char * t){ return writeString(t); }
+	inline Log4zArgs & operator <<(bool t){ return writeValue(LOG4Z_ARG_INT, (long long)t); }
+	inline Log4zArgs & operator <<(char t){ return writeValue(LOG4Z_ARG_INT, (long long)t); }
+	inline Log4zArgs & operator <<(signed char t){ return writeValue(LOG4Z_ARG_INT, (long long)t); }
+	inline Log4zArgs & operator <<(unsigned char t){ return writeValue(LOG4Z_ARG_UINT, (unsigned long long)t); }
+	inline Log4zArgs & operator <<(short t){ return writeValue(LOG4Z_ARG_INT, (long long)t); }
+	inline Log4zArgs & operator <<(unsigned short t){ return writeValue(LOG4Z_ARG_UINT, (unsigned long long)t); }
+	inline Log4zArgs & operator <<(int t){ return writeValue(LOG4Z_ARG_INT, (long long)t); }
+	inline Log4zArgs & operator <<(unsigned int t){ return writeValue(LOG4Z_ARG_UINT, (unsigned long long)t); }
+	inline Log4zArgs & operator <<(long t){ return writeValue(LOG4Z_ARG_INT, (long long)t); }
+	inline Log4zArgs & operator <<(unsigned long t){ return writeValue(LOG4Z_ARG_UINT, (unsigned long long)t); }
+	inline Log4zArgs & operator <<(long long t){ return writeValue(LOG4Z_ARG_INT, t); }
+	inline Log4zArgs & operator <<(unsigned long long t){ return writeValue(LOG4Z_ARG_UINT, t); }
+	inline Log4zArgs & operator <<(float t){ return writeValue(LOG4Z_ARG_DOUBLE, (double)t); }
+	inline Log4zArgs & operator <<(double t){ return writeValue(LOG4Z_ARG_DOUBLE, t); }
+	template<class _Traits, class _Alloc> //support std::string
+	inline Log4zArgs & operator <<(const std::basic_string<char, _Traits, _Alloc> & t){ return writeString(t.c_str()); }
+private:
+	Log4zArgs(){}
+	Log4zArgs(Log4zArgs &){}
+	char *  _begin;
+	char *  _end;
+	char *  _cur;
+};
+
+template<class T>
+inline Log4zArgs & Log4zArgs::writeValue(char type, T t)
+{
+	if (_end - _cur >= (int)(1 + sizeof(T)))
+	{
+		*_cur++ = type;
+		memcpy(_cur, &t, sizeof(T));
+		_cur += sizeof(T);
+	}
+	return *this;
+}
+
+inline Log4zArgs & Log4zArgs::writeString(const char * t)
+{
+	if (t == NULL)
+	{
+		t = "(null)";
+	}
+	if (_end - _cur < 4)
+	{
+		return *this;
+	}
+	size_t len = strlen(t);
+	size_t room = (size_t)(_end - _cur) - 4;
+	if (len > room)
+	{
+		len = room;
+	}
+	unsigned short stored = (unsigned short)(len + 1);
+	*_cur++ = LOG4Z_ARG_STRING;
+	memcpy(_cur, &stored, sizeof(stored));
+	_cur += sizeof(stored);
+	memcpy(_cur, t, len);
+	_cur += len;
+	*_cur++ = '\0';
+	return *this;
+}
+
+#ifdef LOG4Z_BINARY_INPUT_ENABLE
+inline void packBinaryArgs(Log4zArgs &){}
+
+template<class T, class ... Args>
+inline void packBinaryArgs(Log4zArgs & a, const T & t, const Args & ... args)
+{
+	a << t;
+	packBinaryArgs(a, args...);
+}
+#endif
+
+//! read the next packed argument, return false at the end.
+inline bool readBinaryArg(const char *& cur, const char * end, char & type, unsigned long long & value, double & real, const char *& str)
+{
+	if (cur >= end)
+	{
+		return false;
+	}
+	type = *cur++;
+	if (type == LOG4Z_ARG_STRING)
+	{
+		unsigned short len = 0;
+		if (end - cur < (int)sizeof(len)) { cur = end; return false; }
+		memcpy(&len, cur, sizeof(len));
+		cur += sizeof(len);
+		if (len == 0 || end - cur < len || cur[len - 1] != '\0') { cur = end; return false; }
+		str = cur;
+		cur += len;
+		return true;
+	}
+	if (end - cur < 8) { cur = end; return false; }
+	if (type == LOG4Z_ARG_DOUBLE)
+	{
+		memcpy(&real, cur, sizeof(real));
+	}
+	else
+	{
+		memcpy(&value, cur, sizeof(value));
+	}
+	cur += 8;
+	return true;
+}
+
+//! format the packed arguments by a printf style format on the log thread or in log4zdecoder.
+//! length modifiers in the format are ignored, the packed type decides the width.
+//! return the length written into buf without the terminating zero.
+inline int formatBinaryArgs(char * buf, int len, const char * format, const char * args, int argsLen)
+{
+	if (len <= 0)
+	{
+		return 0;
+	}
+	char * cur = buf;
+	char * end = buf + len - 1;
+	const char * argCur = args;
+	const char * argEnd = args + argsLen;
+	const char * p = format;
+	while (*p != '\0' && cur < end)
+	{
+		if (*p != '%')
+		{
+			*cur++ = *p++;
+			continue;
+		}
+		if (p[1] == '%')
+		{
+			*cur++ = '%';
+			p += 2;
+			continue;
+		}
+
+		//rebuild the conversion with the packed argument width.
+		char spec[64];
+		int n = 0;
+		spec[n++] = *p++;
+		while (*p != '\0' && strchr("-+ #0", *p) != NULL && n < 8)
+		{
+			spec[n++] = *p++;
+		}
+		for (int part = 0; part < 2; part++)
+		{
+			if (part == 1)
+			{
+				if (*p != '.') break;
+				spec[n++] = *p++;
+			}
+			if (*p == '*')
+			{
+				char type = 0;
+				unsigned long long value = 0;
+				double real = 0;
+				const char * str = NULL;
+				readBinaryArg(argCur, argEnd, type, value, real, str);
+				n += sprintf(spec + n, "%d", (int)value);
+				p++;
+			}
+			else
+			{
+				while (*p >= '0' && *p <= '9' && n < 40)
+				{
+					spec[n++] = *p++;
+				}
+			}
+		}
+		while (*p != '\0' && strchr("hlLqjztI", *p) != NULL)
+		{
+			if (*p++ == 'I')
+			{
+				while (*p >= '0' && *p <= '9') p++;
+			}
+		}
+		char conv = *p;
+		if (conv == '\0')
+		{
+			break;
+		}
+		p++;
+
+		char type = 0;
+		unsigned long long value = 0;
+		double real = 0;
+		const char * str = NULL;
+		if (conv != 'n' && readBinaryArg(argCur, argEnd, type, value, real, str))
+		{
+			if (type == LOG4Z_ARG_DOUBLE)
+			{
+				value = (unsigned long long)(long long)real;
+			}
+			else
+			{
+				real = type == LOG4Z_ARG_UINT || type == LOG4Z_ARG_POINTER ? (double)value : (double)(long long)value;
+			}
+		}
+		int count = (int)(end - cur) + 1;
+		int ret = 0;
+		switch (conv)
+		{
+		case 'd': case 'i': case 'u': case 'o': case 'x': case 'X':
+			spec[n++] = 'l';
+			spec[n++] = 'l';
+			spec[n++] = conv;
+			spec[n] = '\0';
+			ret = snprintf(cur, count, spec, value);
+			break;
+		case 'c':
+			spec[n++] = conv;
+			spec[n] = '\0';
+			ret = snprintf(cur, count, spec, (int)value);
+			break;
+		case 'e': case 'E': case 'f': case 'F': case 'g': case 'G': case 'a': case 'A':
+			spec[n++] = conv;
+			spec[n] = '\0';
+			ret = snprintf(cur, count, spec, real);
+			break;
+		case 's':
+			spec[n++] = conv;
+			spec[n] = '\0';
+			ret = snprintf(cur, count, spec, type == LOG4Z_ARG_STRING ? str : "");
+			break;
+		case 'p':
+			spec[n++] = conv;
+			spec[n] = '\0';
+			ret = snprintf(cur, count, spec, (void*)(size_t)value);
+			break;
+		case 'n':
+			break;
+		default:
+			spec[n++] = conv;
+			spec[n] = '\0';
+			ret = snprintf(cur, count, "%s", spec);
+			break;
+		}
+		if (ret < 0)
+		{
+			ret = 0;
+		}
+		else if (ret >= count)
+		{
+			ret = count - 1;
+		}
+		cur += ret;
+	}
+	*cur = '\0';
+	return (int)(cur - buf);
+}
+
+//////////////////////////////////////////////////////////////////////////
+//! binary log file
+//! a *.blog file is a sequence of Log4zBinaryRecord, each followed by _len bytes.
+//! it starts with a head record, a format record is written before the first binary record of each format id.
+//////////////////////////////////////////////////////////////////////////
+enum ENUM_LOG4Z_BINARY_RECORD
+{
+	LOG4Z_BINARY_RECORD_HEAD = 0x425a344c, //'L4ZB', _tick is the base tick. bytes: tick frequency, base time in millisecond. 
+	LOG4Z_BINARY_RECORD_FORMAT = 1,	//_formatId, _line. bytes: file name and format, both end with zero.
+	LOG4Z_BINARY_RECORD_BINARY,		//_formatId, _level, _tick. bytes: the packed arguments.
+	LOG4Z_BINARY_RECORD_TEXT,		//_level. bytes: the formatted log line.
+};
+
+struct Log4zBinaryRecord
+{
+	unsigned int _type;
+	int _level;
+	int _formatId;
+	int _line;
+	unsigned long long _tick;
+	unsigned int _len;
+	unsigned int _reserve;
+};
+
+//! tick to millisecond since epoch, without overflow for high frequency ticks.
+inline unsigned long long binaryTickToMillisecond(unsigned long long tick, unsigned long long baseTick, unsigned long long frequency, unsigned long long baseMillisecond)
+{
+	if (frequency == 0 || tick < baseTick)
+	{
+		return baseMillisecond;
+	}
+	unsigned long long diff = tick - baseTick;
+	return baseMillisecond + diff / frequency * 1000 + diff % frequency * 1000 / frequency;
+}
+
+
+#ifdef LOG4Z_LIMIT_ENABLE
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//! Log4zLimit
+//! the token bucket of one limited call site, a function local static.
+//! a record costs one relaxed fetch_sub, the log thread refills the bucket and reports the suppressed records on its tick.
+//////////////////////////////////////////////////////////////////////////
+typedef void (*Log4zLimitReport)(const Log4zLimit & site, unsigned long long suppressed);
+
+class Log4zLimit
+{
+public:
+	//! file and line name the call site in the report. report writes it instead of the log4z logger when it is set.
+	constexpr Log4zLimit(const char * file, int line, Log4zLimitReport report = nullptr, void * context = nullptr)
+		: _file(file), _line(line), _report(report), _context(context), _id(0), _level(0), _sample(false), _limit(1), _remainder(0),
+		_state(LIMIT_NONE), _tokens(0), _count(0), _suppressed(0){}
+	//! sample false: pass limit records per second, refilled on the log thread tick, limit records deep.
+	//! sample true: pass 1 of every limit records.
+	inline bool pass(LoggerId id, int level, bool sample, unsigned int limit)
+	{
+		if (_state.load(std::memory_order_acquire) != LIMIT_REGISTERED)
+		{
+			return registerSite(id, level, sample, limit);
+		}
+		if (_sample ? _count.fetch_add(1, std::memory_order_relaxed) % _limit == 0
+			: _tokens.fetch_sub(1, std::memory_order_relaxed) > 0)
+		{
+			return true;
+		}
+		_suppressed.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+	//! log thread only. add the tokens of elapsed milliseconds, the bucket holds at most limit.
+	inline void refill(unsigned long long elapsed)
+	{
+		if (_sample)
+		{
+			return;
+		}
+		unsigned long long add = _limit;
+		if (elapsed < 1000)
+		{
+			add = _limit * elapsed + _remainder;
+			_remainder = add % 1000;
+			add /= 1000;
+		}
+		else
+		{
+			_remainder = 0;
+		}
+		if (add == 0)
+		{
+			return;
+		}
+		long long tokens = _tokens.load(std::memory_order_relaxed);
+		long long next = 0;
+		do
+		{
+			next = (tokens > 0 ? tokens : 0) + (long long)add;
+			if (next > (long long)_limit)
+			{
+				next = _limit;
+			}
+		} while (!_tokens.compare_exchange_weak(tokens, next, std::memory_order_relaxed));
+	}
+	//! log thread only. take the count suppressed since the last report, or put back the count not reported.
+	inline unsigned long long takeSuppressed(){ return _suppressed.exchange(0, std::memory_order_relaxed); }
+	inline void putBackSuppressed(unsigned long long suppressed){ _suppressed.fetch_add(suppressed, std::memory_order_relaxed); }
+
+	inline const char * getFile() const { return _file; }
+	inline int getLine() const { return _line; }
+	inline Log4zLimitReport getReport() const { return _report; }
+	inline void * getContext() const { return _context; }
+	inline LoggerId getId() const { return _id; }
+	inline int getLevel() const { return _level; }
+private:
+	enum
+	{
+		LIMIT_NONE,
+		LIMIT_REGISTERING,
+		LIMIT_REGISTERED,
+	};
+	//! the first record fills the bucket and registers the site. while the log thread is not running the site is not limited.
+	inline bool registerSite(LoggerId id, int level, bool sample, unsigned int limit)
+	{
+		int state = LIMIT_NONE;
+		if (!_state.compare_exchange_strong(state, LIMIT_REGISTERING, std::memory_order_acquire))
+		{
+			if (state == LIMIT_REGISTERED)
+			{
+				return pass(id, level, sample, limit);
+			}
+			//another thread registers the site, the record is reported with the suppressed ones.
+			_suppressed.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+		_id = id;
+		_level = level;
+		_sample = sample;
+		_limit = limit > 0 ? limit : 1;
+		_tokens.store(sample ? 0 : (long long)_limit - 1, std::memory_order_relaxed);
+		_count.store(1, std::memory_order_relaxed);
+		_state.store(ILog4zManager::getPtr()->registerLimit(this) ? LIMIT_REGISTERED : LIMIT_NONE, std::memory_order_release);
+		return true;
+	}
+private:
+	const char * _file;
+	int _line;
+	Log4zLimitReport _report;
+	void * _context;
+	//! written once before the site is registered.
+	LoggerId _id;
+	int _level;
+	bool _sample;
+	unsigned int _limit;
+	//! the refill of the log thread below one token, in tokens per 1000.
+	unsigned long long _remainder;
+	std::atomic<int> _state;
+	std::atomic<long long> _tokens;
+	std::atomic<unsigned int> _count;
+	std::atomic<unsigned long long> _suppressed;
+};
+#endif
+
+
+#ifdef WIN32
+#pragma warning(pop)
+#endif
+
+_ZSUMMER_LOG4Z_END
+_ZSUMMER_END
+
+#endif
+
+
+
+
+
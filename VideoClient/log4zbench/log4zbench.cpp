@@ -0,0 +1,304 @@
+// log4zbench.cpp : caller latency and throughput of the logging paths, from 1 to 64 threads.
+// usage: log4zbench [fmt|stream|bin|boost] [records per thread] [max threads]
+// every run prints the caller latency percentiles, the end-to-end throughput,
+// the dropped records and the RSS growth. log4z writes to log/ next to the executable.
+// define LOG4Z_SYNCHRONOUS_OUTPUT to measure the synchronous output of log4z,
+// define LOG4ZBENCH_BOOST_LOG for the boost mode, the CHANNEL_LOG path of the video library.
+// linux: g++ -std=c++11 -O2 log4zbench.cpp ../log4z/log4z.cpp -pthread -o log4zbench
+//        add -DLOG4ZBENCH_BOOST_LOG -DBOOST_LOG_DYN_LINK -lboost_log_setup -lboost_log -lboost_thread for the boost mode.
+
+#include "../log4z/log4z.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+
+#ifdef WIN32
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#pragma warning(disable:4996)
+#else
+#include <unistd.h>
+#endif
+
+#ifdef LOG4ZBENCH_BOOST_LOG
+#include <boost/log/core.hpp>
+#include <boost/log/sources/channel_logger.hpp>
+#include <boost/log/sources/record_ostream.hpp>
+#include <boost/log/utility/setup/file.hpp>
+#endif
+
+using namespace zsummer::log4z;
+
+enum BenchMode
+{
+	BENCH_FMT,
+	BENCH_STREAM,
+	BENCH_BIN,
+	BENCH_BOOST,
+};
+
+static const char *const MODE_NAME[] =
+{
+	"fmt",
+	"stream",
+	"bin",
+	"boost",
+};
+
+//! the payloads of the records, most records are short like the decoder ones, some carry an url or a dump.
+static const int PAYLOAD_SIZES[] = { 16, 16, 48, 48, 48, 120, 120, 300, 900 };
+static const int PAYLOAD_COUNT = sizeof(PAYLOAD_SIZES) / sizeof(PAYLOAD_SIZES[0]);
+
+#ifdef LOG4ZBENCH_BOOST_LOG
+static boost::log::sources::channel_logger_mt<> g_boostLogger(boost::log::keywords::channel = "log4zbench");
+#endif
+
+static unsigned long long residentBytes()
+{
+#ifdef WIN32
+	PROCESS_MEMORY_COUNTERS counters;
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+	{
+		return counters.WorkingSetSize;
+	}
+	return 0;
+#elif defined(__linux__)
+	unsigned long long size = 0;
+	unsigned long long resident = 0;
+	FILE * statm = fopen("/proc/self/statm", "r");
+	if (statm == NULL)
+	{
+		return 0;
+	}
+	if (fscanf(statm, "%llu %llu", &size, &resident) != 2)
+	{
+		resident = 0;
+	}
+	fclose(statm);
+	return resident * (unsigned long long)sysconf(_SC_PAGESIZE);
+#else
+	return 0;
+#endif
+}
+
+static unsigned long long nowNanosecond()
+{
+	return (unsigned long long)std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static unsigned long long droppedCount()
+{
+	return ILog4zManager::getRef().getStatusTotalDropNewestCount() + ILog4zManager::getRef().getStatusTotalDropOldestCount();
+}
+
+static void logOne(BenchMode mode, LoggerId id, int thread, int index, const std::vector<std::string> & payloads)
+{
+	const std::string & payload = payloads[index % PAYLOAD_COUNT];
+	long long pts = (long long)index * 40;
+	switch (mode)
+	{
+	case BENCH_FMT:
+		LOGFMT_INFO(id, "thread=%d frame=%d pts=%lld %s", thread, index, pts, payload.c_str());
+		break;
+	case BENCH_STREAM:
+		LOG_INFO(id, "thread=" << thread << " frame=" << index << " pts=" << pts << " " << payload);
+		break;
+	case BENCH_BIN:
+#ifdef LOG4Z_BINARY_INPUT_ENABLE
+		LOGBIN_INFO(id, "thread=%d frame=%d pts=%lld %s", thread, index, pts, payload.c_str());
+#endif
+		break;
+	case BENCH_BOOST:
+#ifdef LOG4ZBENCH_BOOST_LOG
+		BOOST_LOG(g_boostLogger) << "thread=" << thread << " frame=" << index << " pts=" << pts << " " << payload;
+#endif
+		break;
+	}
+}
+
+static unsigned long long percentile(std::vector<unsigned int> & samples, double rate)
+{
+	if (samples.empty())
+	{
+		return 0;
+	}
+	size_t pos = (size_t)(rate * (samples.size() - 1));
+	std::nth_element(samples.begin(), samples.begin() + pos, samples.end());
+	return samples[pos];
+}
+
+//! one run, every thread writes its records as fast as it can after the start flag.
+static void runBench(BenchMode mode, LoggerId id, int threads, int records, const std::vector<std::string> & payloads)
+{
+	std::vector<std::vector<unsigned int> > latencies(threads);
+	for (int i = 0; i < threads; i++)
+	{
+		latencies[i].resize(records);
+	}
+
+	ILog4zManager & manager = ILog4zManager::getRef();
+	unsigned long long writeBefore = manager.getStatusTotalWriteCount();
+	unsigned long long dropBefore = droppedCount();
+	unsigned long long rssBefore = residentBytes();
+
+	std::atomic<bool> go(false);
+	std::atomic<int> ready(0);
+	std::vector<std::thread> workers;
+	for (int t = 0; t < threads; t++)
+	{
+		workers.push_back(std::thread([&, t]()
+		{
+			unsigned int * latency = &latencies[t][0];
+			ready++;
+			while (!go.load(std::memory_order_acquire))
+			{
+				std::this_thread::yield();
+			}
+			for (int i = 0; i < records; i++)
+			{
+				unsigned long long begin = nowNanosecond();
+				logOne(mode, id, t, i, payloads);
+				unsigned long long cost = nowNanosecond() - begin;
+				latency[i] = cost > 0xffffffffULL ? 0xffffffffU : (unsigned int)cost;
+			}
+		}));
+	}
+	while (ready.load() < threads)
+	{
+		std::this_thread::yield();
+	}
+
+	unsigned long long begin = nowNanosecond();
+	go.store(true, std::memory_order_release);
+	for (size_t t = 0; t < workers.size(); t++)
+	{
+		workers[t].join();
+	}
+	unsigned long long callerEnd = nowNanosecond();
+
+	//! wait for the log thread to write what was accepted, boost.log writes in the caller.
+	unsigned long long total = (unsigned long long)threads * records;
+	unsigned long long dropped = 0;
+	if (mode != BENCH_BOOST)
+	{
+		unsigned long long deadline = callerEnd + 60ULL * 1000 * 1000 * 1000;
+		while (true)
+		{
+			dropped = droppedCount() - dropBefore;
+			if (manager.getStatusTotalWriteCount() - writeBefore + dropped >= total || nowNanosecond() > deadline)
+			{
+				break;
+			}
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+	}
+	unsigned long long end = nowNanosecond();
+	unsigned long long rssAfter = residentBytes();
+
+	std::vector<unsigned int> samples;
+	samples.reserve((size_t)total);
+	for (int t = 0; t < threads; t++)
+	{
+		samples.insert(samples.end(), latencies[t].begin(), latencies[t].end());
+	}
+	unsigned long long p50 = percentile(samples, 0.50);
+	unsigned long long p99 = percentile(samples, 0.99);
+	unsigned long long p999 = percentile(samples, 0.999);
+	unsigned long long maxCost = *std::max_element(samples.begin(), samples.end());
+
+	double callerSecond = (callerEnd - begin) / 1e9;
+	double endSecond = (end - begin) / 1e9;
+	printf("%-6s %3d threads  p50 %6llu ns  p99 %7llu ns  p99.9 %8llu ns  max %9llu ns  caller %9.0f/s  end-to-end %9.0f/s  dropped %8llu  rss %+8lld KB\n",
+		MODE_NAME[mode], threads, p50, p99, p999, maxCost,
+		total / callerSecond, (total - dropped) / endSecond, dropped,
+		((long long)rssAfter - (long long)rssBefore) / 1024);
+	fflush(stdout);
+}
+
+int main(int argc, char* argv[])
+{
+	BenchMode mode = BENCH_FMT;
+	if (argc > 1)
+	{
+		int i = 0;
+		while (i < 4 && strcmp(argv[1], MODE_NAME[i]) != 0)
+		{
+			i++;
+		}
+		if (i == 4)
+		{
+			printf("usage: log4zbench [fmt|stream|bin|boost] [records per thread] [max threads]\n");
+			return 1;
+		}
+		mode = (BenchMode)i;
+	}
+	int records = argc > 2 ? atoi(argv[2]) : 20000;
+	int maxThreads = argc > 3 ? atoi(argv[3]) : 64;
+	if (records <= 0 || maxThreads <= 0)
+	{
+		printf("usage: log4zbench [fmt|stream|bin|boost] [records per thread] [max threads]\n");
+		return 1;
+	}
+
+#ifndef LOG4Z_BINARY_INPUT_ENABLE
+	if (mode == BENCH_BIN)
+	{
+		fprintf(stderr, "log4zbench: binary input is not enabled in log4z.h\n");
+		return 1;
+	}
+#endif
+#ifndef LOG4ZBENCH_BOOST_LOG
+	if (mode == BENCH_BOOST)
+	{
+		fprintf(stderr, "log4zbench: built without LOG4ZBENCH_BOOST_LOG\n");
+		return 1;
+	}
+#else
+	boost::log::add_file_log(boost::log::keywords::file_name = "./log/log4zbench_boost_%Y%m%d.log",
+		boost::log::keywords::open_mode = std::ios_base::app);
+#endif
+
+	ILog4zManager & manager = ILog4zManager::getRef();
+	manager.setLoggerDisplay(LOG4Z_MAIN_LOGGER_ID, false);
+	LoggerId id = manager.createLogger(MODE_NAME[mode]);
+	manager.setLoggerDisplay(id, false);
+	manager.setLoggerLevel(id, LOG_LEVEL_TRACE);
+	if (mode == BENCH_BIN)
+	{
+		manager.setLoggerBinary(id, true);
+	}
+	if (mode == BENCH_BOOST)
+	{
+		manager.enableLogger(id, false);
+	}
+	manager.start();
+
+	std::vector<std::string> payloads;
+	for (int i = 0; i < PAYLOAD_COUNT; i++)
+	{
+		std::string payload;
+		while ((int)payload.size() < PAYLOAD_SIZES[i])
+		{
+			payload += "rtsp://192.168.1.64:554/Streaming/Channels/101 ";
+		}
+		payload.resize(PAYLOAD_SIZES[i]);
+		payloads.push_back(payload);
+	}
+
+	printf("log4zbench %s, %s output, %d records per thread\n", MODE_NAME[mode],
+		mode == BENCH_BOOST ? "boost.log" : (LOG4Z_ALL_SYNCHRONOUS_OUTPUT ? "synchronous" : "asynchronous"), records);
+	for (int threads = 1; threads <= maxThreads; threads *= 2)
+	{
+		runBench(mode, id, threads, records, payloads);
+	}
+
+	manager.stop();
+	return 0;
+}
@@ -0,0 +1,182 @@
+// log4zdecoder.cpp : turn log4z binary log files (*.blog) back into text.
+// usage: log4zdecoder <input.blog> [output.log]
+// the output goes to the console when no output file is given.
+
+#include "../log4z/log4z.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <string>
+#include <vector>
+#include <map>
+
+#ifdef WIN32
+#pragma warning(disable:4996)
+#endif
+
+using namespace zsummer::log4z;
+
+static const char *const LOG_STRING[]=
+{
+	"TRACE",
+	"DEBUG",
+	"INFO ",
+	"WARN ",
+	"ERROR",
+	"ALARM",
+	"FATAL",
+};
+
+struct FormatInfo
+{
+	std::string _file;
+	std::string _format;
+	int _line;
+};
+
+static tm millisecondToTm(unsigned long long ms)
+{
+	time_t t = (time_t)(ms / 1000);
+	struct tm tt = { 0 };
+#ifdef WIN32
+	localtime_s(&tt, &t);
+#else
+	localtime_r(&t, &tt);
+#endif
+	return tt;
+}
+
+static const char * fileName(const char * file)
+{
+	const char * pNameBegin = file + strlen(file);
+	while (pNameBegin != file)
+	{
+		if (*(pNameBegin - 1) == '\\' || *(pNameBegin - 1) == '/')
+		{
+			break;
+		}
+		pNameBegin--;
+	}
+	return pNameBegin;
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc < 2)
+	{
+		printf("usage: log4zdecoder <input.blog> [output.log]\n");
+		return 1;
+	}
+	FILE * in = fopen(argv[1], "rb");
+	if (in == NULL)
+	{
+		fprintf(stderr, "log4zdecoder: can not open %s\n", argv[1]);
+		return 1;
+	}
+	FILE * out = stdout;
+	if (argc > 2)
+	{
+		out = fopen(argv[2], "wb");
+		if (out == NULL)
+		{
+			fprintf(stderr, "log4zdecoder: can not create %s\n", argv[2]);
+			fclose(in);
+			return 1;
+		}
+	}
+
+	unsigned long long frequency = 0;
+	unsigned long long baseTick = 0;
+	unsigned long long baseMillisecond = 0;
+	std::map<int, FormatInfo> formats;
+	std::vector<char> bytes;
+	char text[LOG4Z_LOG_BUF_SIZE];
+	unsigned long long records = 0;
+	int ret = 0;
+
+	Log4zBinaryRecord record;
+	while (fread(&record, sizeof(record), 1, in) == 1)
+	{
+		if (record._len >= 64 * 1024 * 1024)
+		{
+			fprintf(stderr, "log4zdecoder: bad record length %u after %llu records\n", record._len, records);
+			ret = 2;
+			break;
+		}
+		bytes.resize(record._len + 1);
+		if (record._len > 0 && fread(&bytes[0], 1, record._len, in) != record._len)
+		{
+			fprintf(stderr, "log4zdecoder: truncated record after %llu records\n", records);
+			ret = 2;
+			break;
+		}
+		bytes[record._len] = '\0';
+
+		if (record._type == LOG4Z_BINARY_RECORD_HEAD)
+		{
+			unsigned long long base[2] = { 0 };
+			if (record._len < sizeof(base))
+			{
+				fprintf(stderr, "log4zdecoder: bad head record after %llu records\n", records);
+				ret = 2;
+				break;
+			}
+			memcpy(base, &bytes[0], sizeof(base));
+			frequency = base[0];
+			baseMillisecond = base[1];
+			baseTick = record._tick;
+			formats.clear();
+		}
+		else if (record._type == LOG4Z_BINARY_RECORD_FORMAT)
+		{
+			FormatInfo info;
+			info._file = &bytes[0];
+			if (info._file.length() + 1 < record._len)
+			{
+				info._format = &bytes[info._file.length() + 1];
+			}
+			info._line = record._line;
+			formats[record._formatId] = info;
+		}
+		else if (record._type == LOG4Z_BINARY_RECORD_TEXT)
+		{
+			fwrite(&bytes[0], 1, record._len, out);
+			records++;
+		}
+		else if (record._type == LOG4Z_BINARY_RECORD_BINARY)
+		{
+			const char * level = record._level >= LOG_LEVEL_TRACE && record._level <= LOG_LEVEL_FATAL ? LOG_STRING[record._level] : "?????";
+			unsigned long long now = binaryTickToMillisecond(record._tick, baseTick, frequency, baseMillisecond);
+			tm tt = millisecondToTm(now);
+			std::map<int, FormatInfo>::iterator iter = formats.find(record._formatId);
+			if (iter == formats.end())
+			{
+				fprintf(out, "%d-%02d-%02d %02d:%02d:%02d.%03d %s <unknown format id %d, %u bytes> \r\n",
+					tt.tm_year + 1900, tt.tm_mon + 1, tt.tm_mday, tt.tm_hour, tt.tm_min, tt.tm_sec, (int)(now % 1000),
+					level, record._formatId, record._len);
+			}
+			else
+			{
+				formatBinaryArgs(text, LOG4Z_LOG_BUF_SIZE, iter->second._format.c_str(), &bytes[0], (int)record._len);
+				fprintf(out, "%d-%02d-%02d %02d:%02d:%02d.%03d %s %s (%s):%d \r\n",
+					tt.tm_year + 1900, tt.tm_mon + 1, tt.tm_mday, tt.tm_hour, tt.tm_min, tt.tm_sec, (int)(now % 1000),
+					level, text, fileName(iter->second._file.c_str()), iter->second._line);
+			}
+			records++;
+		}
+		else
+		{
+			fprintf(stderr, "log4zdecoder: unknown record type %u after %llu records\n", record._type, records);
+			ret = 2;
+			break;
+		}
+	}
+
+	fclose(in);
+	if (out != stdout)
+	{
+		fclose(out);
+	}
+	fprintf(stderr, "log4zdecoder: %llu records decoded\n", records);
+	return ret;
+}
@@ -0,0 +1,333 @@
+// skincompiler.cpp : compiles the xml skins of a skin directory for DuiLib and measures the gain.
+// usage: skincompiler <skin dir> <output dir> [rounds]
+//        skincompiler -tree <controls> <rounds>
+//        skincompiler -parse <controls> <rounds>
+// every *.xml below the skin directory is parsed once and written with the same relative name
+// below the output directory as a compiled skin, see CMarkup::SaveCompiledFile. CMarkup loads
+// a compiled skin wherever it loads the xml, so the output directory (or a zip of it) replaces
+// the skin directory in the package. the source xml stays the one that is edited.
+// a compiled skin also carries the class of every element and the DUIATTR_* id and numbers of
+// every attribute; a DuiLib with another compiled format refuses it, so compile again after updating.
+// with rounds, every skin is then loaded and built that many times from each directory and
+// the load time, the CDialogBuilder::Create time and the sizes are printed.
+// -tree builds a generated skin of that many controls with the usual attributes from the
+// parsed markup, it measures the SetAttribute dispatch without the parse.
+// -parse loads the generated skin as UTF-8 text with CMarkup::LoadFromMem, which tokenises it
+// in place, and as TCHAR text converted from UTF-8 first the way the loader used to, then reads
+// every attribute back. the CMarkup part runs without a window.
+
+#include "..\DuiLib\UIlib.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+using namespace DuiLib;
+
+static void findSkins(const std::string & root, const std::string & relative, std::vector<std::string> & skins)
+{
+	WIN32_FIND_DATAA data;
+	HANDLE hFind = ::FindFirstFileA((root + relative + "*").c_str(), &data);
+	if (hFind == INVALID_HANDLE_VALUE)
+	{
+		return;
+	}
+	do
+	{
+		std::string name = data.cFileName;
+		if (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+		{
+			if (name != "." && name != "..")
+			{
+				findSkins(root, relative + name + "\\", skins);
+			}
+		}
+		else if (name.size() > 4 && _stricmp(name.c_str() + name.size() - 4, ".xml") == 0)
+		{
+			skins.push_back(relative + name);
+		}
+	} while (::FindNextFileA(hFind, &data));
+	::FindClose(hFind);
+}
+
+static void createParentDirectory(const std::string & path)
+{
+	for (size_t pos = path.find('\\', 3); pos != std::string::npos; pos = path.find('\\', pos + 1))
+	{
+		::CreateDirectoryA(path.substr(0, pos).c_str(), NULL);
+	}
+}
+
+static unsigned long long fileSize(const std::string & path)
+{
+	WIN32_FILE_ATTRIBUTE_DATA data;
+	if (!::GetFileAttributesExA(path.c_str(), GetFileExInfoStandard, &data))
+	{
+		return 0;
+	}
+	return ((unsigned long long)data.nFileSizeHigh << 32) | data.nFileSizeLow;
+}
+
+static double nowMicrosecond()
+{
+	static LARGE_INTEGER frequency = { 0 };
+	if (frequency.QuadPart == 0)
+	{
+		::QueryPerformanceFrequency(&frequency);
+	}
+	LARGE_INTEGER counter;
+	::QueryPerformanceCounter(&counter);
+	return counter.QuadPart * 1e6 / frequency.QuadPart;
+}
+
+//! the average load and build time of one skin below the current resource path, in microsecond.
+static void measureSkin(const std::string & skin, int rounds, double & load, double & build)
+{
+	double begin = nowMicrosecond();
+	for (int i = 0; i < rounds; i++)
+	{
+		CMarkup markup;
+		markup.LoadFromFile(skin.c_str());
+	}
+	load = (nowMicrosecond() - begin) / rounds;
+
+	begin = nowMicrosecond();
+	for (int i = 0; i < rounds; i++)
+	{
+		CDialogBuilder builder;
+		CControlUI * pRoot = builder.Create(skin.c_str());
+		delete pRoot;
+		//! the builder keeps the parsed skin, every round has to parse it again.
+		CDialogBuilder::ClearTemplateCache();
+	}
+	build = (nowMicrosecond() - begin) / rounds;
+}
+
+//! a skin of rows of mixed controls, every control carries the attributes a real skin gives it.
+static std::string treeSkin(int controls)
+{
+	static const char *const CONTROLS[] =
+	{
+		"<Button name=\"btn%d\" width=\"80\" height=\"28\" text=\"button\" tooltip=\"tip\" textcolor=\"#FF333333\" hottextcolor=\"#FF000000\" normalimage=\"btn_normal.png\" hotimage=\"btn_hot.png\" pushedimage=\"btn_pushed.png\" padding=\"2,2,2,2\" />",
+		"<Label name=\"lbl%d\" width=\"120\" text=\"label\" textcolor=\"#FF666666\" align=\"left\" valign=\"vcenter\" endellipsis=\"true\" textpadding=\"4,0,4,0\" />",
+		"<Option name=\"opt%d\" width=\"60\" text=\"option\" group=\"group\" selected=\"false\" normalimage=\"opt_normal.png\" selectedimage=\"opt_selected.png\" selectedtextcolor=\"#FF0078D7\" />",
+		"<Edit name=\"edit%d\" width=\"160\" height=\"26\" text=\"edit\" maxchar=\"64\" bordersize=\"1\" bordercolor=\"#FFCCCCCC\" bkcolor=\"#FFFFFFFF\" textpadding=\"4,3,4,3\" />",
+		"<Text name=\"text%d\" width=\"200\" text=\"text\" textcolor=\"#FF999999\" multiline=\"true\" showhtml=\"false\" visible=\"true\" enabled=\"true\" />",
+	};
+	static const int CONTROL_COUNT = sizeof(CONTROLS) / sizeof(CONTROLS[0]);
+	static const int ROW_CONTROLS = 9;
+
+	std::string xml = "<?xml version=\"1.0\" encoding=\"utf-8\"?><VerticalLayout name=\"root\" bkcolor=\"#FFF0F0F0\" vscrollbar=\"true\">";
+	char control[512];
+	int count = 1;
+	while (count < controls)
+	{
+		xml += "<HorizontalLayout height=\"32\" childpadding=\"4\" inset=\"4,2,4,2\" bkcolor=\"#FFFFFFFF\">";
+		count++;
+		for (int i = 0; i < ROW_CONTROLS && count < controls; i++, count++)
+		{
+			sprintf_s(control, CONTROLS[count % CONTROL_COUNT], count);
+			xml += control;
+		}
+		xml += "</HorizontalLayout>";
+	}
+	xml += "</VerticalLayout>";
+	return xml;
+}
+
+//! builds the parsed tree skin again and again, only the control creation and SetAttribute are timed.
+static int measureTree(int controls, int rounds)
+{
+	std::string xml = treeSkin(controls);
+	CDialogBuilder builder;
+	CControlUI * pRoot = builder.Create(xml.c_str());
+	if (pRoot == NULL)
+	{
+		printf("skincompiler: the tree skin does not parse\n");
+		return 1;
+	}
+	delete pRoot;
+
+	double begin = nowMicrosecond();
+	for (int i = 0; i < rounds; i++)
+	{
+		delete builder.Create(NULL, NULL, NULL);
+	}
+	double build = (nowMicrosecond() - begin) / rounds;
+	printf("tree of %d controls: build %.1fus, %.1fns per control\n", controls, build, build * 1000 / controls);
+	return 0;
+}
+
+//! walks the whole markup and touches every name and value, as the builder does.
+static size_t readMarkup(CMarkupNode node)
+{
+	size_t total = 0;
+	for (; node.IsValid(); node = node.GetSibling())
+	{
+		total += _tcslen(node.GetName());
+		int count = node.GetAttributeCount();
+		for (int i = 0; i < count; i++)
+		{
+			total += _tcslen(node.GetAttributeName(i)) + _tcslen(node.GetAttributeValue(i));
+		}
+		total += readMarkup(node.GetChild());
+	}
+	return total;
+}
+
+static int measureParse(int controls, int rounds)
+{
+	std::string xml = treeSkin(controls);
+	double begin = 0, load = 0, read = 0, textLoad = 0, textRead = 0;
+	size_t checksum = 0, textChecksum = 0;
+	for (int i = 0; i < rounds; i++)
+	{
+		CMarkup markup;
+		begin = nowMicrosecond();
+		if (!markup.LoadFromMem((BYTE *)xml.data(), (DWORD)xml.size()))
+		{
+			printf("skincompiler: the generated skin does not parse\n");
+			return 1;
+		}
+		load += nowMicrosecond() - begin;
+		begin = nowMicrosecond();
+		checksum = readMarkup(markup.GetRoot());
+		read += nowMicrosecond() - begin;
+	}
+	for (int i = 0; i < rounds; i++)
+	{
+		CMarkup markup;
+		begin = nowMicrosecond();
+		int wide = ::MultiByteToWideChar(CP_UTF8, 0, xml.c_str(), -1, NULL, 0);
+		std::vector<WCHAR> wideText(wide);
+		::MultiByteToWideChar(CP_UTF8, 0, xml.c_str(), -1, &wideText[0], wide);
+#ifdef _UNICODE
+		bool loaded = markup.Load(&wideText[0]);
+#else
+		int ansi = ::WideCharToMultiByte(CP_ACP, 0, &wideText[0], wide, NULL, 0, NULL, NULL);
+		std::vector<char> ansiText(ansi);
+		::WideCharToMultiByte(CP_ACP, 0, &wideText[0], wide, &ansiText[0], ansi, NULL, NULL);
+		bool loaded = markup.Load(&ansiText[0]);
+#endif
+		textLoad += nowMicrosecond() - begin;
+		if (!loaded)
+		{
+			printf("skincompiler: the generated skin does not parse as text\n");
+			return 1;
+		}
+		begin = nowMicrosecond();
+		textChecksum = readMarkup(markup.GetRoot());
+		textRead += nowMicrosecond() - begin;
+	}
+	double megabytes = xml.size() / (1024.0 * 1024.0);
+	printf("skin of %d controls, %.2f MB%s\n", controls, megabytes, checksum == textChecksum ? "" : ", THE TWO PARSES DIFFER");
+	printf("utf-8 in place   load %9.1fus %8.1f MB/s  read %9.1fus\n", load / rounds, megabytes * rounds * 1e6 / load, read / rounds);
+	printf("converted text   load %9.1fus %8.1f MB/s  read %9.1fus\n", textLoad / rounds, megabytes * rounds * 1e6 / textLoad, textRead / rounds);
+	return checksum == textChecksum ? 0 : 1;
+}
+
+static std::string directoryPath(const char * path)
+{
+	char full[MAX_PATH] = { 0 };
+	::GetFullPathNameA(path, MAX_PATH, full, NULL);
+	std::string directory = full;
+	if (!directory.empty() && directory[directory.size() - 1] != '\\' && directory[directory.size() - 1] != '/')
+	{
+		directory += "\\";
+	}
+	return directory;
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc > 1 && strcmp(argv[1], "-tree") == 0)
+	{
+		int controls = argc > 2 ? atoi(argv[2]) : 5000;
+		int rounds = argc > 3 ? atoi(argv[3]) : 100;
+		if (controls <= 0 || rounds <= 0)
+		{
+			printf("usage: skincompiler -tree <controls> <rounds>\n");
+			return 1;
+		}
+		CPaintManagerUI::SetInstance(::GetModuleHandle(NULL));
+		return measureTree(controls, rounds);
+	}
+	if (argc > 1 && strcmp(argv[1], "-parse") == 0)
+	{
+		int controls = argc > 2 ? atoi(argv[2]) : 100000;
+		int rounds = argc > 3 ? atoi(argv[3]) : 20;
+		if (controls <= 0 || rounds <= 0)
+		{
+			printf("usage: skincompiler -parse <controls> <rounds>\n");
+			return 1;
+		}
+		return measureParse(controls, rounds);
+	}
+	if (argc < 3)
+	{
+		printf("usage: skincompiler <skin dir> <output dir> [rounds]\n       skincompiler -tree <controls> <rounds>\n       skincompiler -parse <controls> <rounds>\n");
+		return 1;
+	}
+	std::string skinDir = directoryPath(argv[1]);
+	std::string outDir = directoryPath(argv[2]);
+	int rounds = argc > 3 ? atoi(argv[3]) : 0;
+
+	CPaintManagerUI::SetInstance(::GetModuleHandle(NULL));
+	std::vector<std::string> skins;
+	findSkins(skinDir, "", skins);
+	if (skins.empty())
+	{
+		printf("skincompiler: no xml below %s\n", skinDir.c_str());
+		return 1;
+	}
+
+	int failed = 0;
+	CPaintManagerUI::SetResourcePath(skinDir.c_str());
+	for (size_t i = 0; i < skins.size(); i++)
+	{
+		TCHAR szMessage[100] = { 0 };
+		CMarkup markup;
+		std::string target = outDir + skins[i];
+		createParentDirectory(target);
+		if (!markup.LoadFromFile(skins[i].c_str()) || !markup.SaveCompiledFile(target.c_str()))
+		{
+			markup.GetLastErrorMessage(szMessage, lengthof(szMessage) - 1);
+			printf("%s: %s\n", skins[i].c_str(), szMessage);
+			failed++;
+		}
+	}
+	printf("compiled %d of %d skins into %s\n", (int)skins.size() - failed, (int)skins.size(), outDir.c_str());
+	if (failed != 0 || rounds <= 0)
+	{
+		return failed != 0 ? 1 : 0;
+	}
+
+	unsigned long long xmlTotal = 0;
+	unsigned long long compiledTotal = 0;
+	double xmlLoadTotal = 0, compiledLoadTotal = 0, xmlBuildTotal = 0, compiledBuildTotal = 0;
+	printf("%-40s %10s %10s %10s %10s %10s %10s\n", "skin", "xml B", "duib B", "xml load", "duib load", "xml build", "duib build");
+	for (size_t i = 0; i < skins.size(); i++)
+	{
+		double xmlLoad = 0, compiledLoad = 0, xmlBuild = 0, compiledBuild = 0;
+		CPaintManagerUI::SetResourcePath(skinDir.c_str());
+		measureSkin(skins[i], rounds, xmlLoad, xmlBuild);
+		CPaintManagerUI::SetResourcePath(outDir.c_str());
+		measureSkin(skins[i], rounds, compiledLoad, compiledBuild);
+
+		unsigned long long xmlSize = fileSize(skinDir + skins[i]);
+		unsigned long long compiledSize = fileSize(outDir + skins[i]);
+		printf("%-40s %10llu %10llu %8.1fus %8.1fus %8.1fus %8.1fus\n", skins[i].c_str(), xmlSize, compiledSize,
+			xmlLoad, compiledLoad, xmlBuild, compiledBuild);
+		xmlTotal += xmlSize;
+		compiledTotal += compiledSize;
+		xmlLoadTotal += xmlLoad;
+		compiledLoadTotal += compiledLoad;
+		xmlBuildTotal += xmlBuild;
+		compiledBuildTotal += compiledBuild;
+	}
+	printf("%-40s %10llu %10llu %8.1fus %8.1fus %8.1fus %8.1fus\n", "total", xmlTotal, compiledTotal,
+		xmlLoadTotal, compiledLoadTotal, xmlBuildTotal, compiledBuildTotal);
+	printf("load %.2fx faster, build %.2fx faster\n", xmlLoadTotal / compiledLoadTotal, xmlBuildTotal / compiledBuildTotal);
+	return 0;
+}
@@ -21,7 +21,7 @@ void FFmpegDecoder::displayRunnable()
         if (!m_videoFramesQueue.canPush() 
             && m_videoStartClock + current_frame.m_pts < GetHiResTime())
         {
-            CHANNEL_LOG(ffmpeg_threads) << __FUNCTION__ << " Framedrop";
+            CHANNEL_LOG_LIMIT(ffmpeg_threads, 1) << __FUNCTION__ << " Framedrop";
             finishedDisplayingFrame(m_generation);
             continue;
         }
@@ -1,6 +1,8 @@
 ﻿#include "ffmpegdecoder.h"
 #include <limits.h>
 #include <stdint.h>
+#include <stdarg.h>
+#include <stdio.h>
 
 #include "makeguard.h"
 #include "interlockedadd.h"
@@ -74,6 +76,28 @@ boost::log::sources::channel_logger_mt<>
     ffmpeg_threads(channel = "ffmpeg_threads"),
     ffmpeg_volume(channel = "ffmpeg_volume");
 
+void logFormat(boost::log::sources::channel_logger_mt<>& logger, int level, const char* fmt, ...)
+{
+    static const char* const levels[] = { "TRACE", "DEBUG", "INFO", "WARN", "ERROR", "ALARM", "FATAL" };
+    char text[1024];
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(text, sizeof(text), fmt, args);
+    va_end(args);
+    text[sizeof(text) - 1] = '\0';
+    const char* name = level >= LOG_LEVEL_TRACE && level <= LOG_LEVEL_FATAL ? levels[level] : "LOG";
+    BOOST_LOG(logger) << name << ' ' << text;
+}
+
+#ifdef LOG4Z_LIMIT_ENABLE
+void logSuppressed(const zsummer::log4z::Log4zLimit& site, unsigned long long suppressed)
+{
+    boost::log::sources::channel_logger_mt<>& logger =
+        *static_cast<boost::log::sources::channel_logger_mt<>*>(site.getContext());
+    BOOST_LOG(logger) << "suppressed " << suppressed << " records of " << site.getFile() << ':' << site.getLine();
+}
+#endif
+
 } // namespace channel_logger
 
 double GetHiResTime()
@@ -214,34 +238,22 @@ void FFmpegDecoder::IOContext::initAVFormatContext(AVFormatContext *pCtx)
 }
 
 //////////////////////////////////////////////////////////////////////////////
-void FFmpegDecoder::WriteErrorInfo(const char* format, ...)
+LoggerId FFmpegDecoder::GetLoggerId()
 {
-	//return;
-	const int INFOFILELEN = 5 * 1024 * 1024;
-	char   g_szLogFileName[260] = { 0 };
-	strcat(g_szLogFileName, "C:\\FFmpegDecoder.txt");
-	FILE *fp;
-	if ((fp = fopen(g_szLogFileName, "at")) == NULL)
-		return;
-
-	if (_filelength(_fileno(fp)) > INFOFILELEN)
+	// Created on first use unless the log4z config has it, rolled at 5 MB like the old text file.
+	static const LoggerId id = []()
 	{
-		fclose(fp);
-		if ((fp = fopen(g_szLogFileName, "wt")) == NULL) return;
-	}
-
-	char buf[200];
-	_strdate(buf);
-	fprintf(fp, "%s ", buf);            //写日期
-	_strtime(buf);
-	fprintf(fp, "%s ", buf);            //写时间
-	va_list pvar;
-	va_start(pvar, format);
-	vsprintf(buf, (char *)format, pvar);
-	fprintf(fp, "%s\n", buf);
-	va_end(pvar);
-
-	fclose(fp);
+		zsummer::log4z::ILog4zManager& manager = zsummer::log4z::ILog4zManager::getRef();
+		LoggerId logger = manager.findLogger("FFmpegDecoder");
+		if (logger == LOG4Z_INVALID_LOGGER_ID)
+		{
+			logger = manager.createLogger("FFmpegDecoder");
+			manager.setLoggerLimitsize(logger, 5);
+			manager.setLoggerDisplay(logger, false);
+		}
+		return logger;
+	}();
+	return id;
 }
 
 FFmpegDecoder::FFmpegDecoder()
@@ -392,7 +404,8 @@ void FFmpegDecoder::SetLoopEnable(bool bLoop)
 bool FFmpegDecoder::openDecoder(const PathType &file, const std::string& url, bool isFile, bool bCamera, bool bDesktop)
 {
 	m_bIsFile = isFile;
-	WriteErrorInfo("Start Open Video File(%s%s)", url.c_str(), file.c_str());
+	const char* source = isFile ? file.c_str() : url.c_str();
+	DECODER_LOG(LOG_LEVEL_INFO, ffmpeg_opening, source, 0, "Start open video");
     std::unique_ptr<IOContext> ioCtx;
     if (isFile)
     {
@@ -402,7 +415,7 @@ bool FFmpegDecoder::openDecoder(const PathType &file, const std::string& url, bo
         ioCtx.reset(new IOContext(file));
         if (!ioCtx->valid())
         {
-            BOOST_LOG_TRIVIAL(error) << "Couldn't open video/audio file";
+            DECODER_LOG(LOG_LEVEL_ERROR, ffmpeg_opening, source, 0, "Couldn't open video/audio file");
             return false;
         }
     }
@@ -432,7 +445,7 @@ bool FFmpegDecoder::openDecoder(const PathType &file, const std::string& url, bo
 			error = avformat_open_input(&m_formatContext, nullptr, ifmt, nullptr);
 		else
 		{
-			BOOST_LOG_TRIVIAL(error) << "Couldn't open camera error: " << error;
+			DECODER_LOG(LOG_LEVEL_ERROR, ffmpeg_opening, "vfwcap", error, "Couldn't open camera");
 			return false;
 		}
 	}
@@ -443,7 +456,7 @@ bool FFmpegDecoder::openDecoder(const PathType &file, const std::string& url, bo
 			error = avformat_open_input(&m_formatContext, "desktop", ifmt, nullptr);
 		else
 		{
-			BOOST_LOG_TRIVIAL(error) << "Couldn't open camera error: " << error;
+			DECODER_LOG(LOG_LEVEL_ERROR, ffmpeg_opening, "gdigrab", error, "Couldn't open desktop");
 			return false;
 		}
 	}
@@ -452,7 +465,7 @@ bool FFmpegDecoder::openDecoder(const PathType &file, const std::string& url, bo
 
 	if (error != 0)
 	{
-		BOOST_LOG_TRIVIAL(error) << "Couldn't open video/audio file error: " << error;
+		DECODER_LOG(LOG_LEVEL_ERROR, ffmpeg_opening, source, error, "Couldn't open video/audio file");
 		return false;
 	}
 	CHANNEL_LOG(ffmpeg_opening) << "Opening video/audio file...";
@@ -498,7 +511,7 @@ bool FFmpegDecoder::openDecoder(const PathType &file, const std::string& url, bo
         : ((m_formatContext->duration == AV_NOPTS_VALUE)? 0 
 			: int64_t((m_formatContext->duration / av_q2d(timeStream->time_base)) / 1000000LL));
 
-	WriteErrorInfo("Reset Video Processing");
+	DECODER_LOG(LOG_LEVEL_INFO, ffmpeg_opening, source, 0, "Reset video processing");
     if (!resetVideoProcessing())
     {
         return false;
@@ -513,7 +526,7 @@ bool FFmpegDecoder::openDecoder(const PathType &file, const std::string& url, bo
         m_decoderListener->fileLoaded();
         m_decoderListener->changedFramePosition(m_startTime, m_startTime, m_duration + m_startTime);
     }
-	WriteErrorInfo("Open Video Success%s", url.c_str());
+	DECODER_LOG(LOG_LEVEL_INFO, ffmpeg_opening, source, 0, "Open video success");
 
     return true;
 }
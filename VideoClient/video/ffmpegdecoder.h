@@ -19,6 +19,7 @@ extern "C" {
 
 #include <boost/log/sources/channel_logger.hpp>
 #include <boost/log/common.hpp>
+#include "../log4z/log4z.h"
 
 namespace channel_logger
 {
@@ -34,14 +35,52 @@ extern boost::log::sources::channel_logger_mt<>
     ffmpeg_threads, 
     ffmpeg_volume;
 
+// Writes a printf style record of a log4z level to a channel.
+void logFormat(boost::log::sources::channel_logger_mt<>& logger, int level, const char* fmt, ...);
+
+#ifdef LOG4Z_LIMIT_ENABLE
+// Writes the count a limited call site suppressed to its channel, the context of the site.
+// Called on the log4z thread tick.
+void logSuppressed(const zsummer::log4z::Log4zLimit& site, unsigned long long suppressed);
+#endif
+
 } // namespace channel_logger
 
 #define CHANNEL_LOG(channel) BOOST_LOG(::channel_logger::channel)
 
+// Limited channel logging for hot paths, the lambda gives every call site its own static state.
+// CHANNEL_LOG_LIMIT passes limit records per second with bursts of up to limit, CHANNEL_LOG_SAMPLE passes 1 of
+// every limit records. The buckets are refilled and the suppressed counts written by the log4z thread, so
+// the sites are not limited while it does not run.
+#ifdef LOG4Z_LIMIT_ENABLE
+#define CHANNEL_LOG_LIMITED(channel, sample, limit) \
+    for (bool channelLogOnce = []() -> zsummer::log4z::Log4zLimit& { \
+             static zsummer::log4z::Log4zLimit site(__FILE__, __LINE__, &::channel_logger::logSuppressed, \
+                                                    &::channel_logger::channel); \
+             return site; }().pass(LOG4Z_MAIN_LOGGER_ID, LOG_LEVEL_TRACE, sample, limit); \
+         channelLogOnce; channelLogOnce = false) \
+        CHANNEL_LOG(channel)
+#else
+#define CHANNEL_LOG_LIMITED(channel, sample, limit) CHANNEL_LOG(channel)
+#endif
+#define CHANNEL_LOG_LIMIT(channel, limit) CHANNEL_LOG_LIMITED(channel, false, limit)
+#define CHANNEL_LOG_SAMPLE(channel, limit) CHANNEL_LOG_LIMITED(channel, true, limit)
+
+// Decoder diagnostics through the log4z queue, tagged with the channel and the url and error code fields.
+// log4z drops records while its thread does not run, so until the application starts it they go to the
+// boost.log channel like CHANNEL_LOG.
+#define DECODER_LOG(level, channel, url, error, fmt, ...) \
+    do { \
+        if (zsummer::log4z::ILog4zManager::getRef().isRunning()) { \
+            LOG_FORMAT(FFmpegDecoder::GetLoggerId(), level, "[" #channel "] url=%s error=%d " fmt, (url), (error), ##__VA_ARGS__); \
+        } else { \
+            ::channel_logger::logFormat(::channel_logger::channel, level, "url=%s error=%d " fmt, (url), (error), ##__VA_ARGS__); \
+        } \
+    } while (0)
+
 #include "fqueue.h"
 #include "videoframe.h"
 #include "vqueue.h"
-#include <io.h>
 #include <time.h>
 
 double GetHiResTime();
@@ -57,7 +96,8 @@ class FFmpegDecoder : public IFrameDecoder
     FFmpegDecoder(const FFmpegDecoder&) = delete;
     FFmpegDecoder& operator=(const FFmpegDecoder&) = delete;
 
-	static void WriteErrorInfo(const char* format, ...);
+	// The "FFmpegDecoder" log4z logger shared by all decoders, see DECODER_LOG.
+	static LoggerId GetLoggerId();
 
     void SetFrameFormat(FrameFormat format, bool allowDirect3dData) override;
 
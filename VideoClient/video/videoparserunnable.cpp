@@ -145,7 +145,7 @@ bool FFmpegDecoder::handleVideoPacket(
                     InterlockedAdd(m_videoStartClock, 1.);
                 }
 
-                CHANNEL_LOG(ffmpeg_sync) << "Hard skip frame";
+                CHANNEL_LOG_LIMIT(ffmpeg_sync, 1) << "Hard skip frame";
 
                 // pause
                 if (m_isPaused && !m_isVideoSeekingWhilePaused)